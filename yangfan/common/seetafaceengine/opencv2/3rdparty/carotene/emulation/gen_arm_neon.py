@@ -0,0 +1,626 @@
+#!/usr/bin/env python
+#
+# Writes an arm_neon.h replacement that lets the carotene kernels build and
+# run on hosts without NEON (x86-64 CI machines), see CAROTENE_NEON_EMULATION
+# in CMakeLists.txt.
+#
+# Vector types are GCC/Clang vector extensions of the same size as the NEON
+# ones, so lane-parallel operations whose C semantics match NEON exactly
+# (wrapping add/sub/mul, bitwise logic, compares, min/max) are written as
+# plain vector expressions and get lowered to SSE/AVX2 by the compiler.
+# Everything else (saturation, rounding shifts, narrowing, permutes) is a
+# lane loop that follows the ARM ARM pseudocode, including the 8-bit
+# reciprocal and reciprocal square root estimates, so that kernels give the
+# same results as on the device.
+#
+# Only the intrinsics carotene uses are covered; a kernel that needs a new
+# one fails to compile on the host instead of silently diverging.
+#
+# usage: gen_arm_neon.py <output header>
+
+import re
+import sys
+
+# name: (element type, bits, signed, float)
+TYPES = {
+    's8':  ('int8_t',    8, True,  False), 'u8':  ('uint8_t',    8, False, False),
+    's16': ('int16_t',  16, True,  False), 'u16': ('uint16_t',  16, False, False),
+    's32': ('int32_t',  32, True,  False), 'u32': ('uint32_t',  32, False, False),
+    's64': ('int64_t',  64, True,  False), 'u64': ('uint64_t',  64, False, False),
+    'f32': ('float',    32, True,  True),  'f64': ('double',    64, True,  True),
+}
+
+INTS = ['s8', 'u8', 's16', 'u16', 's32', 'u32', 's64', 'u64']
+NARROW_INTS = ['s8', 'u8', 's16', 'u16', 's32', 'u32']
+ALL = INTS + ['f32', 'f64']
+
+
+def elem(t):
+    return TYPES[t][0]
+
+
+def bits(t):
+    return TYPES[t][1]
+
+
+def signed(t):
+    return TYPES[t][2]
+
+
+def isfloat(t):
+    return TYPES[t][3]
+
+
+def is64int(t):
+    return bits(t) == 64 and not isfloat(t)
+
+
+def vec(t, q):
+    kind = 'float' if isfloat(t) else ('int' if signed(t) else 'uint')
+    return '%s%dx%d_t' % (kind, bits(t), (128 if q else 64) // bits(t))
+
+
+def tup(t, q, n):
+    return vec(t, q).replace('_t', 'x%d_t' % n)
+
+
+def lanes(t, q):
+    return (128 if q else 64) // bits(t)
+
+
+def wide(t):
+    return t[0] + str(bits(t) * 2)
+
+
+def narrow(t):
+    return t[0] + str(bits(t) // 2)
+
+
+def unsigned_of(t):
+    return 'u' + t[1:]
+
+
+def signed_of(t):
+    return 's' + t[1:]
+
+
+def qs(q):
+    return 'q' if q else ''
+
+
+out = []
+
+
+def fn(ret, name, params, body):
+    # result temporaries start zeroed: bodies that fill them lane by lane or through memcpy
+    # would otherwise trip -Wmaybe-uninitialized in every translation unit
+    body = re.sub(r'\b(?!return\b)(\w+) r;', r'\1 r = \1();', body)
+    out.append('static inline %s %s(%s) { %s }' % (ret, name, ', '.join(params), body))
+
+
+def lane_loop(ret, n, stmt, init=''):
+    return '%s r; %sfor (int i = 0; i < %d; ++i) { %s } return r;' % (ret, init, n, stmt)
+
+
+HEADER = '''/*
+ * Generated by emulation/gen_arm_neon.py, do not edit.
+ *
+ * Portable implementation of the subset of <arm_neon.h> used by carotene.
+ */
+
+#ifndef CAROTENE_EMULATED_ARM_NEON_H
+#define CAROTENE_EMULATED_ARM_NEON_H
+
+#if defined __ARM_NEON__ || defined __ARM_NEON
+#error "the NEON emulation header must not be used on targets with NEON"
+#endif
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <limits>
+
+namespace carotene_neon_emulation {
+
+/* saturates an exact intermediate to the range of T */
+template <typename T> inline T sat(__int128 x)
+{
+    const __int128 lo = (__int128)std::numeric_limits<T>::min();
+    const __int128 hi = (__int128)std::numeric_limits<T>::max();
+    return (T)(x < lo ? lo : (x > hi ? hi : x));
+}
+
+/* rounding arithmetic shift right, n may be 0 */
+inline __int128 rshr(__int128 x, int n)
+{
+    return n <= 0 ? x : ((x + ((__int128)1 << (n - 1))) >> n);
+}
+
+/* NEON fmin/fmax: a NaN operand gives a NaN result */
+template <typename T> inline T fmin(T a, T b) { return a != a || b != b ? a + b : (a < b ? a : b); }
+template <typename T> inline T fmax(T a, T b) { return a != a || b != b ? a + b : (a > b ? a : b); }
+
+/* ARM ARM RecipEstimate(), a in [0.5, 1) */
+inline double recipEstimate(double a)
+{
+    int q = (int)(a * 512.0);
+    double r = 1.0 / (((double)q + 0.5) / 512.0);
+    int s = (int)(256.0 * r + 0.5);
+    return (double)s / 256.0;
+}
+
+/* ARM ARM RecipSqrtEstimate(), a in [0.25, 1) */
+inline double recipSqrtEstimate(double a)
+{
+    double r;
+    if (a < 0.5) {
+        int q0 = (int)(a * 512.0);
+        r = 1.0 / sqrt(((double)q0 + 0.5) / 512.0);
+    } else {
+        int q1 = (int)(a * 256.0);
+        r = 1.0 / sqrt(((double)q1 + 0.5) / 256.0);
+    }
+    int s = (int)(256.0 * r + 0.5);
+    return (double)s / 256.0;
+}
+
+/* VRECPE.F32 with flush-to-zero, as on ARMv7 NEON */
+inline float vrecpe(float x)
+{
+    if (x != x)
+        return x;
+    if (fabsf(x) < std::numeric_limits<float>::min())
+        return copysignf(INFINITY, x);
+    if (isinf(x))
+        return copysignf(0.0f, x);
+    int e;
+    double m = frexp(fabs((double)x), &e);
+    double r = ldexp(recipEstimate(m), -e);
+    if (r < std::numeric_limits<float>::min())
+        r = 0.0;
+    return copysignf((float)r, x);
+}
+
+/* VRSQRTE.F32 */
+inline float vrsqrte(float x)
+{
+    if (x != x)
+        return x;
+    if (fabsf(x) < std::numeric_limits<float>::min())
+        return copysignf(INFINITY, x);
+    if (x < 0.0f)
+        return std::numeric_limits<float>::quiet_NaN();
+    if (isinf(x))
+        return 0.0f;
+    int e;
+    double m = frexp((double)x, &e);
+    if (e & 1) {
+        m *= 0.5;
+        ++e;
+    }
+    return (float)ldexp(recipSqrtEstimate(m), -e / 2);
+}
+
+/* VRECPE.U32, input and result are unsigned 0.32 fixed point */
+inline uint32_t vrecpe(uint32_t x)
+{
+    if (x < 0x80000000u)
+        return 0xffffffffu;
+    double r = recipEstimate((double)(x >> 23) / 512.0);
+    return (uint32_t)(r * 256.0) << 23;
+}
+
+/* float to integer conversion with NEON saturation, NaN gives 0 */
+template <typename T> inline T cvt(double x)
+{
+    if (x != x)
+        return 0;
+    if (x <= (double)std::numeric_limits<T>::min())
+        return std::numeric_limits<T>::min();
+    if (x >= (double)std::numeric_limits<T>::max())
+        return std::numeric_limits<T>::max();
+    return (T)x;
+}
+
+}
+
+'''
+
+
+def emit_types():
+    for t in ALL:
+        for q in (0, 1):
+            out.append('typedef %s %s __attribute__((vector_size(%d)));' % (elem(t), vec(t, q), 16 if q else 8))
+        for q in (0, 1):
+            for n in (2, 3, 4):
+                out.append('typedef struct { %s val[%d]; } %s;' % (vec(t, q), n, tup(t, q, n)))
+    out.append('typedef uint8x8_t poly8x8_t;')
+    out.append('typedef uint8x16_t poly8x16_t;')
+    out.append('typedef uint16x4_t poly16x4_t;')
+    out.append('typedef uint16x8_t poly16x8_t;')
+    out.append('')
+
+
+def emit_memory(t, q):
+    v, e, n, s = vec(t, q), elem(t), lanes(t, q), qs(q)
+    fn(v, 'vdup%s_n_%s' % (s, t), ['%s x' % e], lane_loop(v, n, 'r[i] = x;'))
+    fn(v, 'vmov%s_n_%s' % (s, t), ['%s x' % e], 'return vdup%s_n_%s(x);' % (s, t))
+    fn(v, 'vld1%s_%s' % (s, t), ['const %s *p' % e], '%s r; memcpy(&r, p, sizeof(r)); return r;' % v)
+    fn('void', 'vst1%s_%s' % (s, t), ['%s *p' % e, '%s a' % v], 'memcpy(p, &a, sizeof(a));')
+    fn(v, 'vld1%s_dup_%s' % (s, t), ['const %s *p' % e], 'return vdup%s_n_%s(*p);' % (s, t))
+    fn(v, 'vld1%s_lane_%s' % (s, t), ['const %s *p' % e, '%s a' % v, 'int l'], 'a[l] = *p; return a;')
+    fn('void', 'vst1%s_lane_%s' % (s, t), ['%s *p' % e, '%s a' % v, 'int l'], '*p = a[l];')
+    fn(e, 'vget%s_lane_%s' % (s, t), ['%s a' % v, 'int l'], 'return a[l];')
+    fn(v, 'vset%s_lane_%s' % (s, t), ['%s x' % e, '%s a' % v, 'int l'], 'a[l] = x; return a;')
+    fn(v, 'vdup%s_lane_%s' % (s, t), ['%s a' % vec(t, 0), 'int l'], lane_loop(v, n, 'r[i] = a[l];'))
+    fn(v, 'vdup%s_laneq_%s' % (s, t), ['%s a' % vec(t, 1), 'int l'], lane_loop(v, n, 'r[i] = a[l];'))
+    for k in (2, 3, 4):
+        vx = tup(t, q, k)
+        fn(vx, 'vld%d%s_%s' % (k, s, t), ['const %s *p' % e],
+           '%s r; for (int i = 0; i < %d; ++i) for (int j = 0; j < %d; ++j) r.val[j][i] = p[i * %d + j]; return r;' % (vx, n, k, k))
+        fn('void', 'vst%d%s_%s' % (k, s, t), ['%s *p' % e, '%s a' % vx],
+           'for (int i = 0; i < %d; ++i) for (int j = 0; j < %d; ++j) p[i * %d + j] = a.val[j][i];' % (n, k, k))
+        fn(vx, 'vld%d%s_lane_%s' % (k, s, t), ['const %s *p' % e, '%s a' % vx, 'int l'],
+           'for (int j = 0; j < %d; ++j) a.val[j][l] = p[j]; return a;' % k)
+        fn('void', 'vst%d%s_lane_%s' % (k, s, t), ['%s *p' % e, '%s a' % vx, 'int l'],
+           'for (int j = 0; j < %d; ++j) p[j] = a.val[j][l];' % k)
+        fn(vx, 'vld%d%s_dup_%s' % (k, s, t), ['const %s *p' % e],
+           '%s r; for (int j = 0; j < %d; ++j) r.val[j] = vdup%s_n_%s(p[j]); return r;' % (vx, k, s, t))
+
+
+def emit_arithmetic(t, q):
+    v, e, n, s = vec(t, q), elem(t), lanes(t, q), qs(q)
+    uv = vec(unsigned_of(t), q)
+    ne = '' if isfloat(t) or not signed(t) else '(%s)' % uv
+    wrap = (lambda x: x) if not ne else (lambda x: '(%s)(%s)' % (v, x))
+
+    fn(v, 'vadd%s_%s' % (s, t), ['%s a' % v, '%s b' % v], 'return %s;' % wrap('%sa + %sb' % (ne, ne)))
+    fn(v, 'vsub%s_%s' % (s, t), ['%s a' % v, '%s b' % v], 'return %s;' % wrap('%sa - %sb' % (ne, ne)))
+    if not is64int(t):
+        fn(v, 'vmul%s_%s' % (s, t), ['%s a' % v, '%s b' % v], 'return %s;' % wrap('%sa * %sb' % (ne, ne)))
+        fn(v, 'vmul%s_n_%s' % (s, t), ['%s a' % v, '%s b' % e], 'return vmul%s_%s(a, vdup%s_n_%s(b));' % (s, t, s, t))
+        fn(v, 'vmul%s_lane_%s' % (s, t), ['%s a' % v, '%s b' % vec(t, 0), 'int l'], 'return vmul%s_n_%s(a, b[l]);' % (s, t))
+        fn(v, 'vmul%s_laneq_%s' % (s, t), ['%s a' % v, '%s b' % vec(t, 1), 'int l'], 'return vmul%s_n_%s(a, b[l]);' % (s, t))
+        # VMLA/VMLS are not fused, the product is rounded first
+        fn(v, 'vmla%s_%s' % (s, t), ['%s a' % v, '%s b' % v, '%s c' % v], 'return vadd%s_%s(a, vmul%s_%s(b, c));' % (s, t, s, t))
+        fn(v, 'vmls%s_%s' % (s, t), ['%s a' % v, '%s b' % v, '%s c' % v], 'return vsub%s_%s(a, vmul%s_%s(b, c));' % (s, t, s, t))
+        fn(v, 'vmla%s_n_%s' % (s, t), ['%s a' % v, '%s b' % v, '%s c' % e], 'return vmla%s_%s(a, b, vdup%s_n_%s(c));' % (s, t, s, t))
+        fn(v, 'vmls%s_n_%s' % (s, t), ['%s a' % v, '%s b' % v, '%s c' % e], 'return vmls%s_%s(a, b, vdup%s_n_%s(c));' % (s, t, s, t))
+        fn(v, 'vmla%s_lane_%s' % (s, t), ['%s a' % v, '%s b' % v, '%s c' % vec(t, 0), 'int l'], 'return vmla%s_n_%s(a, b, c[l]);' % (s, t))
+        fn(v, 'vmls%s_lane_%s' % (s, t), ['%s a' % v, '%s b' % v, '%s c' % vec(t, 0), 'int l'], 'return vmls%s_n_%s(a, b, c[l]);' % (s, t))
+
+    if isfloat(t):
+        fn(v, 'vfma%s_%s' % (s, t), ['%s a' % v, '%s b' % v, '%s c' % v], lane_loop(v, n, 'r[i] = fma(b[i], c[i], a[i]);'))
+        fn(v, 'vfma%s_n_%s' % (s, t), ['%s a' % v, '%s b' % v, '%s c' % e], 'return vfma%s_%s(a, b, vdup%s_n_%s(c));' % (s, t, s, t))
+        fn(v, 'vfms%s_%s' % (s, t), ['%s a' % v, '%s b' % v, '%s c' % v], lane_loop(v, n, 'r[i] = fma(-b[i], c[i], a[i]);'))
+        fn(v, 'vdiv%s_%s' % (s, t), ['%s a' % v, '%s b' % v], 'return a / b;')
+        fn(v, 'vsqrt%s_%s' % (s, t), ['%s a' % v], lane_loop(v, n, 'r[i] = sqrt(a[i]);'))
+        fn(v, 'vrndn%s_%s' % (s, t), ['%s a' % v], lane_loop(v, n, 'r[i] = nearbyint(a[i]);'))
+        fn(v, 'vrnd%s_%s' % (s, t), ['%s a' % v], lane_loop(v, n, 'r[i] = trunc(a[i]);'))
+        fn(v, 'vrndm%s_%s' % (s, t), ['%s a' % v], lane_loop(v, n, 'r[i] = floor(a[i]);'))
+        fn(v, 'vrndp%s_%s' % (s, t), ['%s a' % v], lane_loop(v, n, 'r[i] = ceil(a[i]);'))
+        fn(v, 'vabs%s_%s' % (s, t), ['%s a' % v], lane_loop(v, n, 'r[i] = fabs(a[i]);'))
+        fn(v, 'vneg%s_%s' % (s, t), ['%s a' % v], 'return -a;')
+        fn(v, 'vabd%s_%s' % (s, t), ['%s a' % v, '%s b' % v], 'return vabs%s_%s(a - b);' % (s, t))
+    if t == 'f32':
+        ns = 'carotene_neon_emulation::'
+        fn(v, 'vrecpe%s_f32' % s, ['%s a' % v], lane_loop(v, n, 'r[i] = %svrecpe(a[i]);' % ns))
+        fn(v, 'vrsqrte%s_f32' % s, ['%s a' % v], lane_loop(v, n, 'r[i] = %svrsqrte(a[i]);' % ns))
+        fn(v, 'vrecps%s_f32' % s, ['%s a' % v, '%s b' % v], 'return vdup%s_n_f32(2.0f) - a * b;' % s)
+        fn(v, 'vrsqrts%s_f32' % s, ['%s a' % v, '%s b' % v], 'return (vdup%s_n_f32(3.0f) - a * b) * 0.5f;' % s)
+    if t == 'u32':
+        fn(v, 'vrecpe%s_u32' % s, ['%s a' % v], lane_loop(v, n, 'r[i] = carotene_neon_emulation::vrecpe(a[i]);'))
+
+    if isfloat(t):
+        return
+
+    sat = 'carotene_neon_emulation::sat<%s>' % e
+    fn(v, 'vqadd%s_%s' % (s, t), ['%s a' % v, '%s b' % v], lane_loop(v, n, 'r[i] = %s((__int128)a[i] + b[i]);' % sat))
+    fn(v, 'vqsub%s_%s' % (s, t), ['%s a' % v, '%s b' % v], lane_loop(v, n, 'r[i] = %s((__int128)a[i] - b[i]);' % sat))
+    if not is64int(t):
+        fn(v, 'vhadd%s_%s' % (s, t), ['%s a' % v, '%s b' % v], lane_loop(v, n, 'r[i] = (%s)(((__int128)a[i] + b[i]) >> 1);' % e))
+        fn(v, 'vrhadd%s_%s' % (s, t), ['%s a' % v, '%s b' % v], lane_loop(v, n, 'r[i] = (%s)(((__int128)a[i] + b[i] + 1) >> 1);' % e))
+        fn(v, 'vhsub%s_%s' % (s, t), ['%s a' % v, '%s b' % v], lane_loop(v, n, 'r[i] = (%s)(((__int128)a[i] - b[i]) >> 1);' % e))
+    if signed(t):
+        fn(v, 'vabs%s_%s' % (s, t), ['%s a' % v], lane_loop(v, n, 'r[i] = (%s)(a[i] < 0 ? -(__int128)a[i] : a[i]);' % e))
+        fn(v, 'vqabs%s_%s' % (s, t), ['%s a' % v], lane_loop(v, n, 'r[i] = %s(a[i] < 0 ? -(__int128)a[i] : a[i]);' % sat))
+        fn(v, 'vneg%s_%s' % (s, t), ['%s a' % v], 'return (%s)(-(%s)a);' % (v, uv))
+        fn(v, 'vqneg%s_%s' % (s, t), ['%s a' % v], lane_loop(v, n, 'r[i] = %s(-(__int128)a[i]);' % sat))
+    if not is64int(t):
+        fn(v, 'vabd%s_%s' % (s, t), ['%s a' % v, '%s b' % v],
+           lane_loop(v, n, '__int128 d = (__int128)a[i] - b[i]; r[i] = (%s)(d < 0 ? -d : d);' % e))
+        fn(v, 'vaba%s_%s' % (s, t), ['%s c' % v, '%s a' % v, '%s b' % v], 'return vadd%s_%s(c, vabd%s_%s(a, b));' % (s, t, s, t))
+
+
+def emit_minmax(t, q):
+    if is64int(t):
+        fn(elem(t), 'vaddv%s_%s' % (qs(q), t), ['%s a' % vec(t, q)],
+           '%s r = 0; for (int i = 0; i < %d; ++i) r += a[i]; return r;' % (elem(t), lanes(t, q)))
+        return
+    v, e, n, s = vec(t, q), elem(t), lanes(t, q), qs(q)
+    h = n // 2
+    if isfloat(t):
+        mn, mx = 'carotene_neon_emulation::fmin', 'carotene_neon_emulation::fmax'
+        fn(v, 'vmax%s_%s' % (s, t), ['%s a' % v, '%s b' % v], lane_loop(v, n, 'r[i] = %s(a[i], b[i]);' % mx))
+        fn(v, 'vmin%s_%s' % (s, t), ['%s a' % v, '%s b' % v], lane_loop(v, n, 'r[i] = %s(a[i], b[i]);' % mn))
+    else:
+        mn, mx = 'std::min', 'std::max'
+        fn(v, 'vmax%s_%s' % (s, t), ['%s a' % v, '%s b' % v], 'return a > b ? a : b;')
+        fn(v, 'vmin%s_%s' % (s, t), ['%s a' % v, '%s b' % v], 'return a < b ? a : b;')
+    fn(v, 'vpmax%s_%s' % (s, t), ['%s a' % v, '%s b' % v],
+       lane_loop(v, h, 'r[i] = %s(a[2 * i], a[2 * i + 1]); r[i + %d] = %s(b[2 * i], b[2 * i + 1]);' % (mx, h, mx)))
+    fn(v, 'vpmin%s_%s' % (s, t), ['%s a' % v, '%s b' % v],
+       lane_loop(v, h, 'r[i] = %s(a[2 * i], a[2 * i + 1]); r[i + %d] = %s(b[2 * i], b[2 * i + 1]);' % (mn, h, mn)))
+    fn(v, 'vpadd%s_%s' % (s, t), ['%s a' % v, '%s b' % v],
+       lane_loop(v, h, 'r[i] = (%s)(a[2 * i] + a[2 * i + 1]); r[i + %d] = (%s)(b[2 * i] + b[2 * i + 1]);' % (e, h, e)))
+    fn(e, 'vaddv%s_%s' % (s, t), ['%s a' % v], '%s r = 0; for (int i = 0; i < %d; ++i) r = (%s)(r + a[i]); return r;' % (e, n, e))
+    fn(e, 'vmaxv%s_%s' % (s, t), ['%s a' % v], '%s r = a[0]; for (int i = 1; i < %d; ++i) r = %s(r, a[i]); return r;' % (e, n, mx))
+    fn(e, 'vminv%s_%s' % (s, t), ['%s a' % v], '%s r = a[0]; for (int i = 1; i < %d; ++i) r = %s(r, a[i]); return r;' % (e, n, mn))
+
+
+def emit_compare_logic(t, q):
+    v, e, n, s = vec(t, q), elem(t), lanes(t, q), qs(q)
+    uv = vec(unsigned_of(t), q)
+    # vector compares yield 0 / -1 lanes, which is exactly the NEON mask
+    for op, sym in (('ceq', '=='), ('cge', '>='), ('cgt', '>'), ('cle', '<='), ('clt', '<')):
+        fn(uv, 'v%s%s_%s' % (op, s, t), ['%s a' % v, '%s b' % v], 'return (%s)(a %s b);' % (uv, sym))
+        fn(uv, 'v%sz%s_%s' % (op, s, t), ['%s a' % v], 'return (%s)(a %s vdup%s_n_%s(0));' % (uv, sym, s, t))
+    if isfloat(t):
+        fn(uv, 'vcage%s_%s' % (s, t), ['%s a' % v, '%s b' % v], 'return vcge%s_%s(vabs%s_%s(a), vabs%s_%s(b));' % (s, t, s, t, s, t))
+        fn(uv, 'vcagt%s_%s' % (s, t), ['%s a' % v, '%s b' % v], 'return vcgt%s_%s(vabs%s_%s(a), vabs%s_%s(b));' % (s, t, s, t, s, t))
+    else:
+        fn(uv, 'vtst%s_%s' % (s, t), ['%s a' % v, '%s b' % v], 'return (%s)((a & b) != 0);' % uv)
+        for op, expr in (('and', 'a & b'), ('orr', 'a | b'), ('eor', 'a ^ b'), ('bic', 'a & ~b'), ('orn', 'a | ~b')):
+            fn(v, 'v%s%s_%s' % (op, s, t), ['%s a' % v, '%s b' % v], 'return %s;' % expr)
+        fn(v, 'vmvn%s_%s' % (s, t), ['%s a' % v], 'return ~a;')
+    fn(v, 'vbsl%s_%s' % (s, t), ['%s m' % uv, '%s a' % v, '%s b' % v],
+       '%s ua, ub; memcpy(&ua, &a, sizeof(a)); memcpy(&ub, &b, sizeof(b)); '
+       'ua = (m & ua) | (~m & ub); %s r; memcpy(&r, &ua, sizeof(r)); return r;' % (uv, v))
+
+
+def emit_shifts(t, q):
+    if isfloat(t):
+        return
+    v, e, n, s = vec(t, q), elem(t), lanes(t, q), qs(q)
+    ue = elem(unsigned_of(t))
+    sv = vec(signed_of(t), q)
+    sat = 'carotene_neon_emulation::sat<%s>' % e
+    rshr = 'carotene_neon_emulation::rshr'
+    # immediate shifts may equal the lane width, so they go through __int128
+    fn(v, 'vshl%s_n_%s' % (s, t), ['%s a' % v, 'int k'], lane_loop(v, n, 'r[i] = (%s)((%s)a[i] << k);' % (e, ue)))
+    fn(v, 'vqshl%s_n_%s' % (s, t), ['%s a' % v, 'int k'], lane_loop(v, n, 'r[i] = %s((__int128)a[i] * ((__int128)1 << k));' % sat))
+    if signed(t):
+        uv, usat = vec(unsigned_of(t), q), 'carotene_neon_emulation::sat<%s>' % ue
+        fn(uv, 'vqshlu%s_n_%s' % (s, t), ['%s a' % v, 'int k'], lane_loop(uv, n, 'r[i] = %s((__int128)a[i] * ((__int128)1 << k));' % usat))
+    fn(v, 'vshr%s_n_%s' % (s, t), ['%s a' % v, 'int k'], lane_loop(v, n, 'r[i] = (%s)((__int128)a[i] >> k);' % e))
+    fn(v, 'vrshr%s_n_%s' % (s, t), ['%s a' % v, 'int k'], lane_loop(v, n, 'r[i] = (%s)%s(a[i], k);' % (e, rshr)))
+    fn(v, 'vsra%s_n_%s' % (s, t), ['%s a' % v, '%s b' % v, 'int k'], 'return vadd%s_%s(a, vshr%s_n_%s(b, k));' % (s, t, s, t))
+    fn(v, 'vrsra%s_n_%s' % (s, t), ['%s a' % v, '%s b' % v, 'int k'], 'return vadd%s_%s(a, vrshr%s_n_%s(b, k));' % (s, t, s, t))
+    # register shifts take the signed low byte of each lane of b, negative shifts right
+    fn(v, 'vshl%s_%s' % (s, t), ['%s a' % v, '%s b' % sv],
+       lane_loop(v, n, 'int k = (int8_t)b[i]; r[i] = (%s)(k >= 0 ? ((__int128)a[i] << k) : ((__int128)a[i] >> -k));' % e))
+    fn(v, 'vrshl%s_%s' % (s, t), ['%s a' % v, '%s b' % sv],
+       lane_loop(v, n, 'int k = (int8_t)b[i]; r[i] = (%s)(k >= 0 ? ((__int128)a[i] << k) : %s(a[i], -k));' % (e, rshr)))
+    fn(v, 'vqshl%s_%s' % (s, t), ['%s a' % v, '%s b' % sv],
+       lane_loop(v, n, 'int k = (int8_t)b[i]; r[i] = k >= 0 ? %s((__int128)a[i] * ((__int128)1 << k)) : (%s)((__int128)a[i] >> -k);' % (sat, e)))
+    fn(v, 'vsli%s_n_%s' % (s, t), ['%s a' % v, '%s b' % v, 'int k'],
+       lane_loop(v, n, '%s m = (%s)(~(uint64_t)0 << k); r[i] = (%s)((((%s)b[i] << k) & m) | ((%s)a[i] & ~m));' % (ue, ue, e, ue, ue)))
+    fn(v, 'vsri%s_n_%s' % (s, t), ['%s a' % v, '%s b' % v, 'int k'],
+       lane_loop(v, n, '%s m = (%s)((%s)~(%s)0 >> k); r[i] = (%s)((((%s)b[i] >> k) & m) | ((%s)a[i] & ~m));' % (ue, ue, ue, ue, e, ue, ue)))
+    if bits(t) == 8:
+        fn(v, 'vcnt%s_%s' % (s, t), ['%s a' % v], lane_loop(v, n, 'r[i] = (%s)__builtin_popcount((%s)a[i]);' % (e, ue)))
+    if not is64int(t):
+        fn(v, 'vclz%s_%s' % (s, t), ['%s a' % v],
+           lane_loop(v, n, '%s x = (%s)a[i]; r[i] = (%s)(x ? __builtin_clz(x) - %d : %d);' % (ue, ue, e, 32 - bits(t), bits(t))))
+
+
+def emit_permute(t, q):
+    v, e, n, s = vec(t, q), elem(t), lanes(t, q), qs(q)
+    fn(v, 'vext%s_%s' % (s, t), ['%s a' % v, '%s b' % v, 'int k'], lane_loop(v, n, 'r[i] = i + k < %d ? a[i + k] : b[i + k - %d];' % (n, n)))
+    for rb in (16, 32, 64):
+        if bits(t) < rb:
+            g = rb // bits(t)
+            fn(v, 'vrev%d%s_%s' % (rb, s, t), ['%s a' % v], lane_loop(v, n, 'r[i] = a[(i / %d) * %d + (%d - 1 - i %% %d)];' % (g, g, g, g)))
+    x2 = tup(t, q, 2)
+    h = n // 2
+    fn(x2, 'vzip%s_%s' % (s, t), ['%s a' % v, '%s b' % v],
+       '%s r; for (int i = 0; i < %d; ++i) { r.val[0][2 * i] = a[i]; r.val[0][2 * i + 1] = b[i]; '
+       'r.val[1][2 * i] = a[i + %d]; r.val[1][2 * i + 1] = b[i + %d]; } return r;' % (x2, h, h, h))
+    fn(x2, 'vuzp%s_%s' % (s, t), ['%s a' % v, '%s b' % v],
+       '%s r; for (int i = 0; i < %d; ++i) { r.val[0][i] = a[2 * i]; r.val[0][i + %d] = b[2 * i]; '
+       'r.val[1][i] = a[2 * i + 1]; r.val[1][i + %d] = b[2 * i + 1]; } return r;' % (x2, h, h, h))
+    fn(x2, 'vtrn%s_%s' % (s, t), ['%s a' % v, '%s b' % v],
+       '%s r; for (int i = 0; i < %d; ++i) { r.val[0][2 * i] = a[2 * i]; r.val[0][2 * i + 1] = b[2 * i]; '
+       'r.val[1][2 * i] = a[2 * i + 1]; r.val[1][2 * i + 1] = b[2 * i + 1]; } return r;' % (x2, h))
+    for op in ('zip', 'uzp', 'trn'):
+        fn(v, 'v%s1%s_%s' % (op, s, t), ['%s a' % v, '%s b' % v], 'return v%s%s_%s(a, b).val[0];' % (op, s, t))
+        fn(v, 'v%s2%s_%s' % (op, s, t), ['%s a' % v, '%s b' % v], 'return v%s%s_%s(a, b).val[1];' % (op, s, t))
+
+
+def emit_halves(t):
+    d, qv = vec(t, 0), vec(t, 1)
+    fn(qv, 'vcombine_%s' % t, ['%s a' % d, '%s b' % d], '%s r; memcpy(&r, &a, 8); memcpy((char *)&r + 8, &b, 8); return r;' % qv)
+    fn(d, 'vget_low_%s' % t, ['%s a' % qv], '%s r; memcpy(&r, &a, 8); return r;' % d)
+    fn(d, 'vget_high_%s' % t, ['%s a' % qv], '%s r; memcpy(&r, (const char *)&a + 8, 8); return r;' % d)
+    fn(d, 'vcreate_%s' % t, ['uint64_t x'], '%s r; memcpy(&r, &x, 8); return r;' % d)
+
+
+def emit_reinterpret():
+    for a in ALL:
+        for b in ALL + ['p8']:
+            if a == b or (a == 'u8' and b == 'p8'):
+                continue
+            for q in (0, 1):
+                src = vec('u8' if b == 'p8' else b, q)
+                fn(vec(a, q), 'vreinterpret%s_%s_%s' % (qs(q), a, b), ['%s x' % src],
+                   '%s r; memcpy(&r, &x, sizeof(r)); return r;' % vec(a, q))
+
+
+def emit_widening(t):
+    wt = wide(t)
+    d, qv, wq, we, n = vec(t, 0), vec(t, 1), vec(wt, 1), elem(wt), lanes(t, 0)
+    fn(wq, 'vmovl_%s' % t, ['%s a' % d], lane_loop(wq, n, 'r[i] = a[i];'))
+    fn(wq, 'vaddl_%s' % t, ['%s a' % d, '%s b' % d], 'return vaddq_%s(vmovl_%s(a), vmovl_%s(b));' % (wt, t, t))
+    fn(wq, 'vsubl_%s' % t, ['%s a' % d, '%s b' % d], 'return vsubq_%s(vmovl_%s(a), vmovl_%s(b));' % (wt, t, t))
+    fn(wq, 'vaddw_%s' % t, ['%s a' % wq, '%s b' % d], 'return vaddq_%s(a, vmovl_%s(b));' % (wt, t))
+    fn(wq, 'vsubw_%s' % t, ['%s a' % wq, '%s b' % d], 'return vsubq_%s(a, vmovl_%s(b));' % (wt, t))
+    if bits(t) < 32:
+        fn(wq, 'vmull_%s' % t, ['%s a' % d, '%s b' % d], 'return vmulq_%s(vmovl_%s(a), vmovl_%s(b));' % (wt, t, t))
+    else:
+        fn(wq, 'vmull_%s' % t, ['%s a' % d, '%s b' % d], lane_loop(wq, n, 'r[i] = (%s)a[i] * b[i];' % we))
+    fn(wq, 'vmull_n_%s' % t, ['%s a' % d, '%s b' % elem(t)], 'return vmull_%s(a, vdup_n_%s(b));' % (t, t))
+    fn(wq, 'vmull_lane_%s' % t, ['%s a' % d, '%s b' % d, 'int l'], 'return vmull_n_%s(a, b[l]);' % t)
+    fn(wq, 'vmlal_%s' % t, ['%s c' % wq, '%s a' % d, '%s b' % d], 'return vaddq_%s(c, vmull_%s(a, b));' % (wt, t))
+    fn(wq, 'vmlsl_%s' % t, ['%s c' % wq, '%s a' % d, '%s b' % d], 'return vsubq_%s(c, vmull_%s(a, b));' % (wt, t))
+    fn(wq, 'vmlal_n_%s' % t, ['%s c' % wq, '%s a' % d, '%s b' % elem(t)], 'return vmlal_%s(c, a, vdup_n_%s(b));' % (t, t))
+    fn(wq, 'vmlsl_n_%s' % t, ['%s c' % wq, '%s a' % d, '%s b' % elem(t)], 'return vmlsl_%s(c, a, vdup_n_%s(b));' % (t, t))
+    fn(wq, 'vmlal_lane_%s' % t, ['%s c' % wq, '%s a' % d, '%s b' % d, 'int l'], 'return vmlal_n_%s(c, a, b[l]);' % t)
+    fn(wq, 'vmlsl_lane_%s' % t, ['%s c' % wq, '%s a' % d, '%s b' % d, 'int l'], 'return vmlsl_n_%s(c, a, b[l]);' % t)
+    fn(wq, 'vabdl_%s' % t, ['%s a' % d, '%s b' % d],
+       lane_loop(wq, n, '__int128 x = (__int128)a[i] - b[i]; r[i] = (%s)(x < 0 ? -x : x);' % we))
+    fn(wq, 'vabal_%s' % t, ['%s c' % wq, '%s a' % d, '%s b' % d], 'return vaddq_%s(c, vabdl_%s(a, b));' % (wt, t))
+    fn(wq, 'vshll_n_%s' % t, ['%s a' % d, 'int k'], lane_loop(wq, n, 'r[i] = (%s)((%s)a[i] << k);' % (we, elem(unsigned_of(wt)))))
+    for q in (0, 1):
+        v, nn, wv = vec(t, q), lanes(t, q), vec(wt, q)
+        fn(wv, 'vpaddl%s_%s' % (qs(q), t), ['%s a' % v], lane_loop(wv, nn // 2, 'r[i] = (%s)a[2 * i] + a[2 * i + 1];' % we))
+        fn(wv, 'vpadal%s_%s' % (qs(q), t), ['%s c' % wv, '%s a' % v], 'return vadd%s_%s(c, vpaddl%s_%s(a));' % (qs(q), wt, qs(q), t))
+        fn(we, 'vaddlv%s_%s' % (qs(q), t), ['%s a' % v], '%s r = 0; for (int i = 0; i < %d; ++i) r += a[i]; return r;' % (we, nn))
+    # AArch64 forms working on the high half of a q register
+    fn(wq, 'vmovl_high_%s' % t, ['%s a' % qv], 'return vmovl_%s(vget_high_%s(a));' % (t, t))
+    fn(wq, 'vmull_high_%s' % t, ['%s a' % qv, '%s b' % qv], 'return vmull_%s(vget_high_%s(a), vget_high_%s(b));' % (t, t, t))
+    fn(wq, 'vmlal_high_%s' % t, ['%s c' % wq, '%s a' % qv, '%s b' % qv], 'return vmlal_%s(c, vget_high_%s(a), vget_high_%s(b));' % (t, t, t))
+    fn(wq, 'vaddl_high_%s' % t, ['%s a' % qv, '%s b' % qv], 'return vaddl_%s(vget_high_%s(a), vget_high_%s(b));' % (t, t, t))
+    fn(wq, 'vsubl_high_%s' % t, ['%s a' % qv, '%s b' % qv], 'return vsubl_%s(vget_high_%s(a), vget_high_%s(b));' % (t, t, t))
+    fn(wq, 'vaddw_high_%s' % t, ['%s a' % wq, '%s b' % qv], 'return vaddw_%s(a, vget_high_%s(b));' % (t, t))
+    fn(wq, 'vabdl_high_%s' % t, ['%s a' % qv, '%s b' % qv], 'return vabdl_%s(vget_high_%s(a), vget_high_%s(b));' % (t, t, t))
+
+
+def emit_narrowing(t):
+    nt = narrow(t)
+    wq, nd, ne, n, nb = vec(t, 1), vec(nt, 0), elem(nt), lanes(t, 1), bits(nt)
+    sat = 'carotene_neon_emulation::sat<%s>' % ne
+    rshr = 'carotene_neon_emulation::rshr'
+    fn(nd, 'vmovn_%s' % t, ['%s a' % wq], lane_loop(nd, n, 'r[i] = (%s)a[i];' % ne))
+    fn(nd, 'vqmovn_%s' % t, ['%s a' % wq], lane_loop(nd, n, 'r[i] = %s(a[i]);' % sat))
+    fn(nd, 'vshrn_n_%s' % t, ['%s a' % wq, 'int k'], lane_loop(nd, n, 'r[i] = (%s)((__int128)a[i] >> k);' % ne))
+    fn(nd, 'vrshrn_n_%s' % t, ['%s a' % wq, 'int k'], lane_loop(nd, n, 'r[i] = (%s)%s(a[i], k);' % (ne, rshr)))
+    fn(nd, 'vqshrn_n_%s' % t, ['%s a' % wq, 'int k'], lane_loop(nd, n, 'r[i] = %s((__int128)a[i] >> k);' % sat))
+    fn(nd, 'vqrshrn_n_%s' % t, ['%s a' % wq, 'int k'], lane_loop(nd, n, 'r[i] = %s(%s(a[i], k));' % (sat, rshr)))
+    fn(nd, 'vaddhn_%s' % t, ['%s a' % wq, '%s b' % wq], lane_loop(nd, n, 'r[i] = (%s)(((__int128)a[i] + b[i]) >> %d);' % (ne, nb)))
+    fn(nd, 'vraddhn_%s' % t, ['%s a' % wq, '%s b' % wq], lane_loop(nd, n, 'r[i] = (%s)%s((__int128)a[i] + b[i], %d);' % (ne, rshr, nb)))
+    fn(nd, 'vsubhn_%s' % t, ['%s a' % wq, '%s b' % wq], lane_loop(nd, n, 'r[i] = (%s)(((__int128)a[i] - b[i]) >> %d);' % (ne, nb)))
+    nq = vec(nt, 1)
+    fn(nq, 'vmovn_high_%s' % t, ['%s lo' % nd, '%s a' % wq], 'return vcombine_%s(lo, vmovn_%s(a));' % (nt, t))
+    fn(nq, 'vqmovn_high_%s' % t, ['%s lo' % nd, '%s a' % wq], 'return vcombine_%s(lo, vqmovn_%s(a));' % (nt, t))
+    if signed(t):
+        un = unsigned_of(nt)
+        ud, usat = vec(un, 0), 'carotene_neon_emulation::sat<%s>' % elem(un)
+        fn(ud, 'vqmovun_%s' % t, ['%s a' % wq], lane_loop(ud, n, 'r[i] = %s(a[i]);' % usat))
+        fn(ud, 'vqshrun_n_%s' % t, ['%s a' % wq, 'int k'], lane_loop(ud, n, 'r[i] = %s((__int128)a[i] >> k);' % usat))
+        fn(ud, 'vqrshrun_n_%s' % t, ['%s a' % wq, 'int k'], lane_loop(ud, n, 'r[i] = %s(%s(a[i], k));' % (usat, rshr)))
+        fn(vec(un, 1), 'vqmovun_high_%s' % t, ['%s lo' % ud, '%s a' % wq], 'return vcombine_%s(lo, vqmovun_%s(a));' % (un, t))
+
+
+def emit_doubling():
+    for t in ('s16', 's32'):
+        e, b = elem(t), bits(t)
+        sat = 'carotene_neon_emulation::sat<%s>' % e
+        for q in (0, 1):
+            v, n, s = vec(t, q), lanes(t, q), qs(q)
+            fn(v, 'vqdmulh%s_%s' % (s, t), ['%s a' % v, '%s c' % v],
+               lane_loop(v, n, 'r[i] = %s(((__int128)2 * a[i] * c[i]) >> %d);' % (sat, b)))
+            fn(v, 'vqrdmulh%s_%s' % (s, t), ['%s a' % v, '%s c' % v],
+               lane_loop(v, n, 'r[i] = %s(carotene_neon_emulation::rshr((__int128)2 * a[i] * c[i], %d));' % (sat, b)))
+            fn(v, 'vqdmulh%s_n_%s' % (s, t), ['%s a' % v, '%s c' % e], 'return vqdmulh%s_%s(a, vdup%s_n_%s(c));' % (s, t, s, t))
+            fn(v, 'vqrdmulh%s_n_%s' % (s, t), ['%s a' % v, '%s c' % e], 'return vqrdmulh%s_%s(a, vdup%s_n_%s(c));' % (s, t, s, t))
+        wt = wide(t)
+        wq, d, n = vec(wt, 1), vec(t, 0), lanes(t, 0)
+        wsat = 'carotene_neon_emulation::sat<%s>' % elem(wt)
+        fn(wq, 'vqdmull_%s' % t, ['%s a' % d, '%s b' % d], lane_loop(wq, n, 'r[i] = %s((__int128)2 * a[i] * b[i]);' % wsat))
+        fn(wq, 'vqdmlal_%s' % t, ['%s c' % wq, '%s a' % d, '%s b' % d],
+           lane_loop(wq, n, 'r[i] = %s((__int128)c[i] + %s((__int128)2 * a[i] * b[i]));' % (wsat, wsat)))
+
+
+def emit_conversions():
+    cvt = 'carotene_neon_emulation::cvt'
+    for q in (0, 1):
+        s, n = qs(q), lanes('f32', q)
+        fv, sv, uv = vec('f32', q), vec('s32', q), vec('u32', q)
+        fn(fv, 'vcvt%s_f32_s32' % s, ['%s a' % sv], lane_loop(fv, n, 'r[i] = (float)a[i];'))
+        fn(fv, 'vcvt%s_f32_u32' % s, ['%s a' % uv], lane_loop(fv, n, 'r[i] = (float)a[i];'))
+        fn(sv, 'vcvt%s_s32_f32' % s, ['%s a' % fv], lane_loop(sv, n, 'r[i] = %s<int32_t>(a[i]);' % cvt))
+        fn(uv, 'vcvt%s_u32_f32' % s, ['%s a' % fv], lane_loop(uv, n, 'r[i] = %s<uint32_t>(a[i]);' % cvt))
+        fn(sv, 'vcvtn%s_s32_f32' % s, ['%s a' % fv], lane_loop(sv, n, 'r[i] = %s<int32_t>(nearbyintf(a[i]));' % cvt))
+        fn(sv, 'vcvta%s_s32_f32' % s, ['%s a' % fv], lane_loop(sv, n, 'r[i] = %s<int32_t>(roundf(a[i]));' % cvt))
+        fn(sv, 'vcvtm%s_s32_f32' % s, ['%s a' % fv], lane_loop(sv, n, 'r[i] = %s<int32_t>(floorf(a[i]));' % cvt))
+        fn(fv, 'vcvt%s_n_f32_s32' % s, ['%s a' % sv, 'int k'], lane_loop(fv, n, 'r[i] = (float)ldexp((double)a[i], -k);'))
+        fn(sv, 'vcvt%s_n_s32_f32' % s, ['%s a' % fv, 'int k'], lane_loop(sv, n, 'r[i] = %s<int32_t>(ldexp((double)a[i], k));' % cvt))
+    fn(vec('f64', 1), 'vcvt_f64_f32', ['%s a' % vec('f32', 0)], '%s r = { a[0], a[1] }; return r;' % vec('f64', 1))
+    fn(vec('f32', 0), 'vcvt_f32_f64', ['%s a' % vec('f64', 1)], '%s r = { (float)a[0], (float)a[1] }; return r;' % vec('f32', 0))
+
+
+def emit_tables():
+    for t in ('u8', 's8'):
+        d, e = vec(t, 0), elem(t)
+        idx = 'uint8x8_t idx' if t == 'u8' else '%s idx' % d
+        for k in (1, 2, 3, 4):
+            table = d if k == 1 else tup(t, 0, k)
+            load = 'memcpy(tb, &a, 8);' if k == 1 else ' '.join('memcpy(tb + %d, &a.val[%d], 8);' % (8 * j, j) for j in range(k))
+            fn(d, 'vtbl%d_%s' % (k, t), ['%s a' % table, idx],
+               '%s tb[%d]; %s %s r; for (int i = 0; i < 8; ++i) { uint8_t j = (uint8_t)idx[i]; r[i] = j < %d ? tb[j] : 0; } return r;'
+               % (e, 8 * k, load, d, 8 * k))
+            fn(d, 'vtbx%d_%s' % (k, t), ['%s r' % d, '%s a' % table, idx],
+               '%s tb[%d]; %s for (int i = 0; i < 8; ++i) { uint8_t j = (uint8_t)idx[i]; if (j < %d) r[i] = tb[j]; } return r;'
+               % (e, 8 * k, load, 8 * k))
+        qv = vec(t, 1)
+        # AArch64 lookups in 1 to 4 q registers; vqtbx keeps the lane for out of range indices
+        for k in (1, 2, 3, 4):
+            table = qv if k == 1 else tup(t, 1, k)
+            load = 'memcpy(tb, &a, 16);' if k == 1 else ' '.join('memcpy(tb + %d, &a.val[%d], 16);' % (16 * j, j) for j in range(k))
+            for rv, n, iv in ((d, 8, 'uint8x8_t'), (qv, 16, 'uint8x16_t')):
+                sfx = 'q' if n == 16 else ''
+                fn(rv, 'vqtbl%d%s_%s' % (k, sfx, t), ['%s a' % table, '%s idx' % iv],
+                   '%s tb[%d]; %s %s r; for (int i = 0; i < %d; ++i) { uint8_t j = (uint8_t)idx[i]; r[i] = j < %d ? tb[j] : 0; } return r;'
+                   % (e, 16 * k, load, rv, n, 16 * k))
+                fn(rv, 'vqtbx%d%s_%s' % (k, sfx, t), ['%s r' % rv, '%s a' % table, '%s idx' % iv],
+                   '%s tb[%d]; %s for (int i = 0; i < %d; ++i) { uint8_t j = (uint8_t)idx[i]; if (j < %d) r[i] = tb[j]; } return r;'
+                   % (e, 16 * k, load, n, 16 * k))
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.stderr.write('usage: %s <output header>\n' % sys.argv[0])
+        return 1
+
+    out.append(HEADER)
+    emit_types()
+    for t in ALL:
+        for q in (0, 1):
+            emit_memory(t, q)
+    for t in ALL:
+        emit_halves(t)
+    for t in ALL:
+        for q in (0, 1):
+            emit_arithmetic(t, q)
+            emit_minmax(t, q)
+            emit_compare_logic(t, q)
+            emit_shifts(t, q)
+            emit_permute(t, q)
+    emit_reinterpret()
+    for t in NARROW_INTS:
+        emit_widening(t)
+    for t in ['s16', 'u16', 's32', 'u32', 's64', 'u64']:
+        emit_narrowing(t)
+    emit_doubling()
+    emit_conversions()
+    emit_tables()
+    out.append('\n#endif')
+
+    with open(sys.argv[1], 'w') as f:
+        f.write('\n'.join(out) + '\n')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
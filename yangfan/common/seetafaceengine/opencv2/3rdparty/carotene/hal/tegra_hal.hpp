@@ -43,8 +43,10 @@
 #define CAROTENE_NS carotene_o4t
 
 #include "carotene/functions.hpp"
+#include <cmath>
 #include <cstddef>
 #include <cstring>
+#include <limits>
 #include <vector>
 #include <opencv2/core/base.hpp>
 
@@ -1059,11 +1061,81 @@ TegraRowOp_Invoker(magnitude, magnitude, 2, 1, 0, RANGE_DATA(ST, src1_data, size
 #undef cv_hal_magnitude32f
 #define cv_hal_magnitude32f TEGRA_MAGNITUDE
 
+TegraRowOp_Invoker(magnitudePhase, magnitudePhase, 2, 2, 1, RANGE_DATA(ST, src1_data, sizeof(CAROTENE_NS::f32)), range.end-range.start,
+                                                            RANGE_DATA(ST, src2_data, sizeof(CAROTENE_NS::f32)), range.end-range.start,
+                                                            RANGE_DATA(DT, dst1_data, sizeof(CAROTENE_NS::f32)), range.end-range.start,
+                                                            RANGE_DATA(DT, dst2_data, sizeof(CAROTENE_NS::f32)), range.end-range.start, val)
+#define TEGRA_CARTTOPOLAR(x, y, mag, angle, len, angleInDegrees) \
+( \
+    CAROTENE_NS::isSupportedConfiguration() ? \
+    parallel_for_(Range(0, len), \
+    TegraRowOp_magnitudePhase_Invoker<const CAROTENE_NS::f32, CAROTENE_NS::f32>(x, y, mag, angle, angleInDegrees ? 1.0f : M_PI/180), \
+    (len) / static_cast<double>(1<<16)), \
+    CV_HAL_ERROR_OK \
+    : CV_HAL_ERROR_NOT_IMPLEMENTED \
+)
+
+#undef cv_hal_cartToPolar32f
+#define cv_hal_cartToPolar32f TEGRA_CARTTOPOLAR
+
+// Single channel 8-bit tables only, the per channel tables of cv::LUT fall back to OpenCV
+inline int TEGRA_LUT(const uchar *src_data, size_t src_step, size_t src_type, const uchar *lut_data,
+                     size_t lut_channel_size, size_t lut_channels, uchar *dst_data, size_t dst_step,
+                     int width, int height)
+{
+    if(!CAROTENE_NS::isSupportedConfiguration() || CV_MAT_DEPTH(src_type) != CV_8U ||
+       lut_channel_size != 1 || lut_channels != 1)
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+    CAROTENE_NS::lut(CAROTENE_NS::Size2D(width * CV_MAT_CN(src_type), height),
+                     src_data, src_step, dst_data, dst_step, lut_data);
+    return CV_HAL_ERROR_OK;
+}
+
+#undef cv_hal_lut
+#define cv_hal_lut TEGRA_LUT
+
 
 #if defined OPENCV_IMGPROC_HAL_INTERFACE_H
 
 struct cvhalFilter2D;
 
+/*
+    Row stripes for the imgproc kernels. parallel_for_ hands the stripes to OpenCV's thread
+    pool, where idle workers pick up the next free stripe. A stripe is about 64K pixels, so
+    images below that stay on the calling thread, and at least 16 rows, so the halo rows a
+    neighborhood filter reads around a stripe stay a small part of its work.
+*/
+template <typename Kernel>
+class TegraRowStripe_Invoker : public cv::ParallelLoopBody
+{
+public:
+    explicit TegraRowStripe_Invoker(const Kernel &kernel_) : cv::ParallelLoopBody(), kernel(kernel_) {}
+    virtual void operator()(const cv::Range& range) const CV_OVERRIDE
+    {
+        kernel(range.start, range.end);
+    }
+private:
+    Kernel kernel;
+    const TegraRowStripe_Invoker& operator= (const TegraRowStripe_Invoker&);
+};
+
+template <typename Kernel>
+inline void TEGRA_PARALLEL_ROWS(int width, int height, const Kernel &kernel)
+{
+    double nstripes = std::min((width * (double)height) / (1 << 16), height / 16.0);
+    cv::parallel_for_(cv::Range(0, height), TegraRowStripe_Invoker<Kernel>(kernel), nstripes);
+}
+
+/*
+    Margin of the stripe [start, end) of an image with `margin` around it: the other stripes
+    are real rows to carotene, so the border is only extrapolated at the image edges and the
+    result does not depend on how the rows were split.
+*/
+inline CAROTENE_NS::Margin TEGRA_STRIPE_MARGIN(const CAROTENE_NS::Margin &margin, int height, int start, int end)
+{
+    return CAROTENE_NS::Margin(margin.left, margin.right, margin.top + start, margin.bottom + (height - end));
+}
+
 struct FilterCtx
 {
     CAROTENE_NS::Size2D ksize;
@@ -1265,19 +1337,25 @@ inline int TEGRA_SEPFILTERFREE(cvhalFilter2D *context)
         return CV_HAL_ERROR_UNKNOWN;
     }
 }
-#define TEGRA_SEPFILTERIMPL(context, src_data, src_step, dst_data, dst_step, width, height, full_width, full_height, offset_x, offset_y) \
-( \
-    context && CAROTENE_NS::isSeparableFilter3x3Supported(CAROTENE_NS::Size2D(width, height), ((SepFilterCtx*)context)->border, 3, 3, \
-                                               CAROTENE_NS::Margin(offset_x, full_width - width - offset_x, offset_y, full_height - height - offset_y)) ? \
-    CAROTENE_NS::SeparableFilter3x3(CAROTENE_NS::Size2D(width, height), \
-                                    src_data, src_step, \
-                                    (CAROTENE_NS::s16*)dst_data, dst_step, \
-                                    3, 3, ((SepFilterCtx*)context)->kernelx_data, ((SepFilterCtx*)context)->kernely_data, \
-                                    ((SepFilterCtx*)context)->border, 0, \
-                                    CAROTENE_NS::Margin(offset_x, full_width - width - offset_x, offset_y, full_height - height - offset_y)), \
-    CV_HAL_ERROR_OK \
-    : CV_HAL_ERROR_NOT_IMPLEMENTED \
-)
+inline int TEGRA_SEPFILTERIMPL(cvhalFilter2D *context, uchar *src_data, size_t src_step, uchar *dst_data, size_t dst_step,
+                               int width, int height, int full_width, int full_height, int offset_x, int offset_y)
+{
+    if(!context)
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+    const SepFilterCtx *ctx = (const SepFilterCtx*)context;
+    CAROTENE_NS::Margin margin(offset_x, full_width - width - offset_x, offset_y, full_height - height - offset_y);
+    if(!CAROTENE_NS::isSeparableFilter3x3Supported(CAROTENE_NS::Size2D(width, height), ctx->border, 3, 3, margin))
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+
+    TEGRA_PARALLEL_ROWS(width, height, [&](int start, int end) {
+        CAROTENE_NS::SeparableFilter3x3(CAROTENE_NS::Size2D(width, end - start),
+                                        src_data + start * src_step, src_step,
+                                        (CAROTENE_NS::s16*)(dst_data + start * dst_step), dst_step,
+                                        3, 3, ctx->kernelx_data, ctx->kernely_data,
+                                        ctx->border, 0, TEGRA_STRIPE_MARGIN(margin, height, start, end));
+    });
+    return CV_HAL_ERROR_OK;
+}
 
 #undef cv_hal_sepFilterInit
 #define cv_hal_sepFilterInit TEGRA_SEPFILTERINIT
@@ -1402,27 +1480,30 @@ inline int TEGRA_MORPHFREE(cvhalFilter2D *context)
         return CV_HAL_ERROR_UNKNOWN;
     }
 }
-#define TEGRA_MORPHIMPL(context, src_data, src_step, dst_data, dst_step, width, height, src_full_width, src_full_height, src_roi_x, src_roi_y, dst_full_width, dst_full_height, dst_roi_x, dst_roi_y) \
-( \
-    (void)dst_full_width, (void)dst_full_height, (void)dst_roi_x, (void)dst_roi_y, \
-    context && CAROTENE_NS::isSupportedConfiguration() ? \
-        ((MorphCtx*)context)->operation == CV_HAL_MORPH_ERODE ? \
-        CAROTENE_NS::erode(CAROTENE_NS::Size2D(width, height), ((MorphCtx*)context)->channels, \
-                           src_data, src_step, dst_data, dst_step, \
-                           ((MorphCtx*)context)->ksize, ((MorphCtx*)context)->anchor_x, ((MorphCtx*)context)->anchor_y, \
-                           ((MorphCtx*)context)->border, ((MorphCtx*)context)->border, ((MorphCtx*)context)->borderValues, \
-                           CAROTENE_NS::Margin(src_roi_x, src_full_width - width - src_roi_x, src_roi_y, src_full_height - height - src_roi_y)), \
-        CV_HAL_ERROR_OK : \
-        ((MorphCtx*)context)->operation == CV_HAL_MORPH_DILATE ? \
-        CAROTENE_NS::dilate(CAROTENE_NS::Size2D(width, height), ((MorphCtx*)context)->channels, \
-                            src_data, src_step, dst_data, dst_step, \
-                            ((MorphCtx*)context)->ksize, ((MorphCtx*)context)->anchor_x, ((MorphCtx*)context)->anchor_y, \
-                            ((MorphCtx*)context)->border, ((MorphCtx*)context)->border, ((MorphCtx*)context)->borderValues, \
-                            CAROTENE_NS::Margin(src_roi_x, src_full_width - width - src_roi_x, src_roi_y, src_full_height - height - src_roi_y)), \
-        CV_HAL_ERROR_OK : \
-        CV_HAL_ERROR_NOT_IMPLEMENTED \
-    : CV_HAL_ERROR_NOT_IMPLEMENTED \
-)
+inline int TEGRA_MORPHIMPL(cvhalFilter2D *context, uchar *src_data, size_t src_step, uchar *dst_data, size_t dst_step,
+                           int width, int height, int src_full_width, int src_full_height, int src_roi_x, int src_roi_y,
+                           int, int, int, int)
+{
+    if(!context || !CAROTENE_NS::isSupportedConfiguration())
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+    const MorphCtx *ctx = (const MorphCtx*)context;
+    if(ctx->operation != CV_HAL_MORPH_ERODE && ctx->operation != CV_HAL_MORPH_DILATE)
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+    CAROTENE_NS::Margin margin(src_roi_x, src_full_width - width - src_roi_x, src_roi_y, src_full_height - height - src_roi_y);
+
+    TEGRA_PARALLEL_ROWS(width * ctx->channels, height, [&](int start, int end) {
+        CAROTENE_NS::Size2D stripe(width, end - start);
+        if(ctx->operation == CV_HAL_MORPH_ERODE)
+            CAROTENE_NS::erode(stripe, ctx->channels, src_data + start * src_step, src_step, dst_data + start * dst_step, dst_step,
+                               ctx->ksize, ctx->anchor_x, ctx->anchor_y, ctx->border, ctx->border, ctx->borderValues,
+                               TEGRA_STRIPE_MARGIN(margin, height, start, end));
+        else
+            CAROTENE_NS::dilate(stripe, ctx->channels, src_data + start * src_step, src_step, dst_data + start * dst_step, dst_step,
+                                ctx->ksize, ctx->anchor_x, ctx->anchor_y, ctx->border, ctx->border, ctx->borderValues,
+                                TEGRA_STRIPE_MARGIN(margin, height, start, end));
+    });
+    return CV_HAL_ERROR_OK;
+}
 
 #undef cv_hal_morphInit
 #define cv_hal_morphInit TEGRA_MORPHINIT
@@ -1518,6 +1599,204 @@ inline int TEGRA_MORPHFREE(cvhalFilter2D *context)
     CV_HAL_ERROR_NOT_IMPLEMENTED \
 )
 
+// OpenCV already splits threshold into row stripes and calls the HAL once per stripe, so the
+// kernel runs directly on the rows it is given
+template <typename T>
+inline int TEGRA_THRESHOLDIMPL(const uchar *src_data, size_t src_step, uchar *dst_data, size_t dst_step,
+                               int width, int height, T thresh, T maxValue, int thresholdType)
+{
+    // the u8 overload with trueValue/falseValue defaults makes a plain thresholdBinary call ambiguous
+    void (*binary)(const CAROTENE_NS::Size2D &, const T *, ptrdiff_t, T *, ptrdiff_t, T, T) = CAROTENE_NS::thresholdBinary;
+    CAROTENE_NS::Size2D sz(width, height);
+    const T *src = reinterpret_cast<const T *>(src_data);
+    T *dst = reinterpret_cast<T *>(dst_data);
+    switch(thresholdType)
+    {
+    case cv::THRESH_BINARY:
+        binary(sz, src, src_step, dst, dst_step, thresh, maxValue);
+        break;
+    case cv::THRESH_BINARY_INV:
+        CAROTENE_NS::thresholdBinaryInv(sz, src, src_step, dst, dst_step, thresh, maxValue);
+        break;
+    case cv::THRESH_TRUNC:
+        CAROTENE_NS::thresholdTruncate(sz, src, src_step, dst, dst_step, thresh);
+        break;
+    case cv::THRESH_TOZERO:
+        CAROTENE_NS::thresholdToZero(sz, src, src_step, dst, dst_step, thresh);
+        break;
+    case cv::THRESH_TOZERO_INV:
+        CAROTENE_NS::thresholdToZeroInv(sz, src, src_step, dst, dst_step, thresh);
+        break;
+    default:
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+    }
+    return CV_HAL_ERROR_OK;
+}
+
+// Integer sources compare against the floor of the threshold. Thresholds that keep or clear
+// the whole image are left to OpenCV, which handles them without a pass over the pixels.
+template <typename T>
+inline int TEGRA_THRESHOLDINT(const uchar *src_data, size_t src_step, uchar *dst_data, size_t dst_step,
+                              int width, int height, double thresh, double maxValue, int thresholdType)
+{
+    double ithresh = std::floor(thresh);
+    if (ithresh < std::numeric_limits<T>::min() || ithresh >= std::numeric_limits<T>::max())
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+    return TEGRA_THRESHOLDIMPL<T>(src_data, src_step, dst_data, dst_step, width, height,
+                                  (T)ithresh, cv::saturate_cast<T>(maxValue), thresholdType);
+}
+
+inline int TEGRA_THRESHOLD(const uchar *src_data, size_t src_step, uchar *dst_data, size_t dst_step,
+                           int width, int height, int depth, int cn, double thresh, double maxValue, int thresholdType)
+{
+    if (!CAROTENE_NS::isSupportedConfiguration())
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+    width *= cn;
+    switch(depth)
+    {
+    case CV_8U:
+        return TEGRA_THRESHOLDINT<CAROTENE_NS::u8>(src_data, src_step, dst_data, dst_step, width, height, thresh, maxValue, thresholdType);
+    case CV_8S:
+        return TEGRA_THRESHOLDINT<CAROTENE_NS::s8>(src_data, src_step, dst_data, dst_step, width, height, thresh, maxValue, thresholdType);
+    case CV_16U:
+        return TEGRA_THRESHOLDINT<CAROTENE_NS::u16>(src_data, src_step, dst_data, dst_step, width, height, thresh, maxValue, thresholdType);
+    case CV_16S:
+        return TEGRA_THRESHOLDINT<CAROTENE_NS::s16>(src_data, src_step, dst_data, dst_step, width, height, thresh, maxValue, thresholdType);
+    case CV_32S:
+        return TEGRA_THRESHOLDINT<CAROTENE_NS::s32>(src_data, src_step, dst_data, dst_step, width, height, thresh, maxValue, thresholdType);
+    case CV_32F:
+        return TEGRA_THRESHOLDIMPL<CAROTENE_NS::f32>(src_data, src_step, dst_data, dst_step, width, height,
+                                                     (CAROTENE_NS::f32)thresh, (CAROTENE_NS::f32)maxValue, thresholdType);
+    default:
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+    }
+}
+
+#undef cv_hal_threshold
+#define cv_hal_threshold TEGRA_THRESHOLD
+
+// Binomial 5x5 only: with zero sigmas OpenCV uses the fixed [1 4 6 4 1]/16 kernel and rounds
+// the 8-bit result the same way carotene does
+inline int TEGRA_GAUSSIANBLUR(const uchar *src_data, size_t src_step, uchar *dst_data, size_t dst_step,
+                              int width, int height, int depth, int cn,
+                              size_t margin_left, size_t margin_top, size_t margin_right, size_t margin_bottom,
+                              size_t ksize_width, size_t ksize_height, double sigmaX, double sigmaY, int border_type)
+{
+    CAROTENE_NS::BORDER_MODE border;
+    switch(border_type)
+    {
+    case CV_HAL_BORDER_CONSTANT:
+        border = CAROTENE_NS::BORDER_MODE_CONSTANT;
+        break;
+    case CV_HAL_BORDER_REPLICATE:
+        border = CAROTENE_NS::BORDER_MODE_REPLICATE;
+        break;
+    case CV_HAL_BORDER_REFLECT:
+        border = CAROTENE_NS::BORDER_MODE_REFLECT;
+        break;
+    case CV_HAL_BORDER_REFLECT_101:
+        border = CAROTENE_NS::BORDER_MODE_REFLECT101;
+        break;
+    default:
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+    }
+    if(depth != CV_8U || ksize_width != 5 || ksize_height != 5 || sigmaX != 0 || sigmaY != 0 ||
+       src_data == dst_data || !CAROTENE_NS::isGaussianBlur5x5Supported(CAROTENE_NS::Size2D(width, height), cn, border))
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+    CAROTENE_NS::Margin margin(margin_left, margin_right, margin_top, margin_bottom);
+
+    TEGRA_PARALLEL_ROWS(width * cn, height, [&](int start, int end) {
+        CAROTENE_NS::gaussianBlur5x5(CAROTENE_NS::Size2D(width, end - start), cn,
+                                     src_data + start * src_step, src_step, dst_data + start * dst_step, dst_step,
+                                     border, 0, TEGRA_STRIPE_MARGIN(margin, height, start, end));
+    });
+    return CV_HAL_ERROR_OK;
+}
+
+#undef cv_hal_gaussianBlur
+#define cv_hal_gaussianBlur TEGRA_GAUSSIANBLUR
+
+// 5x5 and 7x7 only (16U up to 5x5, cv::medianBlur rejects larger 16U apertures), cv::medianBlur
+// replicates the border as carotene does. The kernel saves its source rows before overwriting
+// them, so the in-place case runs as one stripe
+template <typename T>
+inline void TEGRA_MEDIANBLUR_STRIPES(const T *src_data, size_t src_step, T *dst_data, size_t dst_step,
+                                     int width, int height, int cn, int ksize)
+{
+    const CAROTENE_NS::Margin margin;
+    auto stripe = [&](int start, int end) {
+        const T *src = (const T *)((const uchar *)src_data + start * src_step);
+        T *dst = (T *)((uchar *)dst_data + start * dst_step);
+        CAROTENE_NS::Size2D size(width, end - start);
+        if(ksize == 5)
+            CAROTENE_NS::medianFilter5x5(size, cn, src, src_step, TEGRA_STRIPE_MARGIN(margin, height, start, end), dst, dst_step);
+        else
+            CAROTENE_NS::medianFilter7x7(size, cn, src, src_step, TEGRA_STRIPE_MARGIN(margin, height, start, end), dst, dst_step);
+    };
+    if((const void *)src_data == (const void *)dst_data)
+        stripe(0, height);
+    else
+        TEGRA_PARALLEL_ROWS(width * cn, height, stripe);
+}
+
+inline int TEGRA_MEDIANBLUR(const uchar *src_data, size_t src_step, uchar *dst_data, size_t dst_step,
+                            int width, int height, int depth, int cn, int ksize)
+{
+    CAROTENE_NS::Size2D size(width, height);
+    if((ksize != 5 || !CAROTENE_NS::isMedianFilter5x5Supported(size, cn)) &&
+       (ksize != 7 || !CAROTENE_NS::isMedianFilter7x7Supported(size, cn)))
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+
+    switch(depth)
+    {
+    case CV_8U:
+        TEGRA_MEDIANBLUR_STRIPES(src_data, src_step, dst_data, dst_step, width, height, cn, ksize);
+        return CV_HAL_ERROR_OK;
+    case CV_16U:
+        if(ksize > 5)
+            return CV_HAL_ERROR_NOT_IMPLEMENTED;
+        TEGRA_MEDIANBLUR_STRIPES((const CAROTENE_NS::u16 *)src_data, src_step, (CAROTENE_NS::u16 *)dst_data, dst_step,
+                                 width, height, cn, ksize);
+        return CV_HAL_ERROR_OK;
+    default:
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+    }
+}
+
+#undef cv_hal_medianBlur
+#define cv_hal_medianBlur TEGRA_MEDIANBLUR
+
+// 256 bins over the full 8-bit range only, which is also what cv::equalizeHist and the
+// chessboard binarization of calib3d ask for
+inline int TEGRA_CALCHIST(const uchar *src_data, size_t src_step, int src_type, int width, int height,
+                          float *hist_data, int hist_size, const float **ranges, bool uniform, bool accumulate)
+{
+    if(!CAROTENE_NS::isSupportedConfiguration() || src_type != CV_8UC1 || hist_size != 256 || !uniform ||
+       ranges == NULL || ranges[0] == NULL || ranges[0][0] != 0.f || ranges[0][1] != 256.f)
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+
+    CAROTENE_NS::u32 hist[256];
+    CAROTENE_NS::calcHist(CAROTENE_NS::Size2D(width, height), src_data, src_step, hist);
+    for(int i = 0; i < 256; ++i)
+        hist_data[i] = accumulate ? hist_data[i] + hist[i] : (float)hist[i];
+    return CV_HAL_ERROR_OK;
+}
+
+#undef cv_hal_calcHist
+#define cv_hal_calcHist TEGRA_CALCHIST
+
+inline int TEGRA_EQUALIZEHIST(const uchar *src_data, size_t src_step, uchar *dst_data, size_t dst_step,
+                              int width, int height)
+{
+    if(!CAROTENE_NS::isSupportedConfiguration())
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+    CAROTENE_NS::equalizeHist(CAROTENE_NS::Size2D(width, height), src_data, src_step, dst_data, dst_step);
+    return CV_HAL_ERROR_OK;
+}
+
+#undef cv_hal_equalize_hist
+#define cv_hal_equalize_hist TEGRA_EQUALIZEHIST
+
 #undef cv_hal_resize
 #define cv_hal_resize TEGRA_RESIZE
 //warpAffine/warpPerspective disabled due to rounding accuracy issue
@@ -1833,6 +2112,72 @@ TegraCvtColor_Invoker(bgrx2hsvf, bgrx2hsv, src_data + static_cast<size_t>(range.
     : CV_HAL_ERROR_NOT_IMPLEMENTED \
 )
 
+TegraCvtColor_Invoker(yuyv2rgb, yuyv2rgb, CAROTENE_NS::COLOR_SPACE_BT601, CAROTENE_NS::YUV_RANGE_LIMITED, \
+                                          src_data + static_cast<size_t>(range.start) * src_step, src_step, \
+                                          dst_data + static_cast<size_t>(range.start) * dst_step, dst_step)
+TegraCvtColor_Invoker(yuyv2rgbx, yuyv2rgbx, CAROTENE_NS::COLOR_SPACE_BT601, CAROTENE_NS::YUV_RANGE_LIMITED, \
+                                            src_data + static_cast<size_t>(range.start) * src_step, src_step, \
+                                            dst_data + static_cast<size_t>(range.start) * dst_step, dst_step)
+TegraCvtColor_Invoker(yuyv2bgr, yuyv2bgr, CAROTENE_NS::COLOR_SPACE_BT601, CAROTENE_NS::YUV_RANGE_LIMITED, \
+                                          src_data + static_cast<size_t>(range.start) * src_step, src_step, \
+                                          dst_data + static_cast<size_t>(range.start) * dst_step, dst_step)
+TegraCvtColor_Invoker(yuyv2bgrx, yuyv2bgrx, CAROTENE_NS::COLOR_SPACE_BT601, CAROTENE_NS::YUV_RANGE_LIMITED, \
+                                            src_data + static_cast<size_t>(range.start) * src_step, src_step, \
+                                            dst_data + static_cast<size_t>(range.start) * dst_step, dst_step)
+TegraCvtColor_Invoker(uyvy2rgb, uyvy2rgb, CAROTENE_NS::COLOR_SPACE_BT601, CAROTENE_NS::YUV_RANGE_LIMITED, \
+                                          src_data + static_cast<size_t>(range.start) * src_step, src_step, \
+                                          dst_data + static_cast<size_t>(range.start) * dst_step, dst_step)
+TegraCvtColor_Invoker(uyvy2rgbx, uyvy2rgbx, CAROTENE_NS::COLOR_SPACE_BT601, CAROTENE_NS::YUV_RANGE_LIMITED, \
+                                            src_data + static_cast<size_t>(range.start) * src_step, src_step, \
+                                            dst_data + static_cast<size_t>(range.start) * dst_step, dst_step)
+TegraCvtColor_Invoker(uyvy2bgr, uyvy2bgr, CAROTENE_NS::COLOR_SPACE_BT601, CAROTENE_NS::YUV_RANGE_LIMITED, \
+                                          src_data + static_cast<size_t>(range.start) * src_step, src_step, \
+                                          dst_data + static_cast<size_t>(range.start) * dst_step, dst_step)
+TegraCvtColor_Invoker(uyvy2bgrx, uyvy2bgrx, CAROTENE_NS::COLOR_SPACE_BT601, CAROTENE_NS::YUV_RANGE_LIMITED, \
+                                            src_data + static_cast<size_t>(range.start) * src_step, src_step, \
+                                            dst_data + static_cast<size_t>(range.start) * dst_step, dst_step)
+// one plane YUV 4:2:2, ycn selects YUY2 (0) or UYVY (1); YVYU (uIdx 1) stays with OpenCV
+#define TEGRA_CVT1PYUVTOBGR(src_data, src_step, dst_data, dst_step, width, height, dcn, swapBlue, uIdx, ycn) \
+( \
+    CAROTENE_NS::isSupportedConfiguration() && uIdx == 0 ? \
+        dcn == 3 ? \
+            (ycn == 0 ? \
+                (swapBlue ? \
+                    parallel_for_(Range(0, height), \
+                    TegraCvtColor_yuyv2rgb_Invoker(src_data, src_step, dst_data, dst_step, width, height), \
+                    (width * height) / static_cast<double>(1<<16)) : \
+                    parallel_for_(Range(0, height), \
+                    TegraCvtColor_yuyv2bgr_Invoker(src_data, src_step, dst_data, dst_step, width, height), \
+                    (width * height) / static_cast<double>(1<<16))) : \
+                (swapBlue ? \
+                    parallel_for_(Range(0, height), \
+                    TegraCvtColor_uyvy2rgb_Invoker(src_data, src_step, dst_data, dst_step, width, height), \
+                    (width * height) / static_cast<double>(1<<16)) : \
+                    parallel_for_(Range(0, height), \
+                    TegraCvtColor_uyvy2bgr_Invoker(src_data, src_step, dst_data, dst_step, width, height), \
+                    (width * height) / static_cast<double>(1<<16)))), \
+            CV_HAL_ERROR_OK : \
+        dcn == 4 ? \
+            (ycn == 0 ? \
+                (swapBlue ? \
+                    parallel_for_(Range(0, height), \
+                    TegraCvtColor_yuyv2rgbx_Invoker(src_data, src_step, dst_data, dst_step, width, height), \
+                    (width * height) / static_cast<double>(1<<16)) : \
+                    parallel_for_(Range(0, height), \
+                    TegraCvtColor_yuyv2bgrx_Invoker(src_data, src_step, dst_data, dst_step, width, height), \
+                    (width * height) / static_cast<double>(1<<16))) : \
+                (swapBlue ? \
+                    parallel_for_(Range(0, height), \
+                    TegraCvtColor_uyvy2rgbx_Invoker(src_data, src_step, dst_data, dst_step, width, height), \
+                    (width * height) / static_cast<double>(1<<16)) : \
+                    parallel_for_(Range(0, height), \
+                    TegraCvtColor_uyvy2bgrx_Invoker(src_data, src_step, dst_data, dst_step, width, height), \
+                    (width * height) / static_cast<double>(1<<16)))), \
+            CV_HAL_ERROR_OK : \
+        CV_HAL_ERROR_NOT_IMPLEMENTED \
+    : CV_HAL_ERROR_NOT_IMPLEMENTED \
+)
+
 #undef cv_hal_cvtBGRtoBGR
 #define cv_hal_cvtBGRtoBGR TEGRA_CVTBGRTOBGR
 #undef cv_hal_cvtBGRtoBGR5x5
@@ -1847,6 +2192,8 @@ TegraCvtColor_Invoker(bgrx2hsvf, bgrx2hsv, src_data + static_cast<size_t>(range.
 #define cv_hal_cvtBGRtoHSV TEGRA_CVTBGRTOHSV
 #undef cv_hal_cvtTwoPlaneYUVtoBGR
 #define cv_hal_cvtTwoPlaneYUVtoBGR TEGRA_CVT2PYUVTOBGR
+#undef cv_hal_cvtOnePlaneYUVtoBGR
+#define cv_hal_cvtOnePlaneYUVtoBGR TEGRA_CVT1PYUVTOBGR
 
 #endif // OPENCV_IMGPROC_HAL_INTERFACE_H
 
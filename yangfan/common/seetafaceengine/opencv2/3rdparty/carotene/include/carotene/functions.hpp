@@ -471,6 +471,32 @@ namespace CAROTENE_NS {
                          const Margin &srcMargin,
                          u8 *dstBase, ptrdiff_t dstStride);
 
+    /*
+        For each point `p` within `size`, set `dst[p]` to the median of the
+        5x5 (7x7) neighborhood of `p` in the same channel. Up to 2 (3) pixels
+        of `srcMargin` are read on each side, beyond that the last available
+        row or column is replicated. `dst` may be the same buffer as `src`.
+    */
+    bool isMedianFilter5x5Supported(const Size2D &size, u32 numChannels);
+    void medianFilter5x5(const Size2D &size, u32 numChannels,
+                         const u8 *srcBase, ptrdiff_t srcStride,
+                         const Margin &srcMargin,
+                         u8 *dstBase, ptrdiff_t dstStride);
+    void medianFilter5x5(const Size2D &size, u32 numChannels,
+                         const u16 *srcBase, ptrdiff_t srcStride,
+                         const Margin &srcMargin,
+                         u16 *dstBase, ptrdiff_t dstStride);
+
+    bool isMedianFilter7x7Supported(const Size2D &size, u32 numChannels);
+    void medianFilter7x7(const Size2D &size, u32 numChannels,
+                         const u8 *srcBase, ptrdiff_t srcStride,
+                         const Margin &srcMargin,
+                         u8 *dstBase, ptrdiff_t dstStride);
+    void medianFilter7x7(const Size2D &size, u32 numChannels,
+                         const u16 *srcBase, ptrdiff_t srcStride,
+                         const Margin &srcMargin,
+                         u16 *dstBase, ptrdiff_t dstStride);
+
     /*
         Apply a half Gaussian filter + half Scale, as one level of a Gaussian
         pyramid. For all `p` within `dstSize`, set `dst[p]` to `f[2 * p]`, where
@@ -1105,7 +1131,9 @@ namespace CAROTENE_NS {
                             f32 alpha);
 
     /*
-        orient[p] = atan2(src0[p], src1[p])
+        orient[p] = atan2(src1[p], src0[p]) of the vector (src0[p], src1[p]), as cv::fastAtan2
+        does it: within 0.01 degrees of the exact angle in [0, 360). The u8 version gives
+        256 units per turn rounded to nearest, the f32 one degrees multiplied by `scale`.
     */
     void phase(const Size2D &size,
                const s16 * src0Base, ptrdiff_t src0Stride,
@@ -1118,6 +1146,24 @@ namespace CAROTENE_NS {
                f32 * orientBase, ptrdiff_t orientStride,
                f32 scale);
 
+    /*
+        magnitude and phase of (src0[p], src1[p]) in one pass, as cv::cartToPolar
+        orient is in degrees multiplied by `scale`, with the accuracy of phase
+    */
+    void magnitudePhase(const Size2D &size,
+                        const f32 * src0Base, ptrdiff_t src0Stride,
+                        const f32 * src1Base, ptrdiff_t src1Stride,
+                        f32 * magnitudeBase, ptrdiff_t magnitudeStride,
+                        f32 * orientBase, ptrdiff_t orientStride,
+                        f32 scale);
+
+    void magnitudePhase(const Size2D &size,
+                        const s16 * src0Base, ptrdiff_t src0Stride,
+                        const s16 * src1Base, ptrdiff_t src1Stride,
+                        f32 * magnitudeBase, ptrdiff_t magnitudeStride,
+                        f32 * orientBase, ptrdiff_t orientStride,
+                        f32 scale);
+
     /*
         Combine 2 planes to a single one
     */
@@ -1199,6 +1245,15 @@ namespace CAROTENE_NS {
                   const s64 * src3Base, ptrdiff_t src3Stride,
                   s64 * dstBase, ptrdiff_t dstStride);
 
+    /*
+        Combine 3 channel image and 1 channel image to a 4 channel one, the inverse
+        of the 3 + 1 split4
+    */
+    void combine4(const Size2D &size,
+                  const u8 * src3Base, ptrdiff_t src3Stride,
+                  const u8 * src1Base, ptrdiff_t src1Stride,
+                  u8 * dstBase, ptrdiff_t dstStride);
+
     /*
         Combine 3 planes to YUYV one
     */
@@ -1457,6 +1512,113 @@ namespace CAROTENE_NS {
                       const u8 * uvBase, ptrdiff_t uvStride,
                       u8 * dstBase, ptrdiff_t dstStride);
 
+    /*
+        Convert YUV420sp (V first in the chroma plane, NV21) or YUV420i (U first, NV12) image
+        to RGB, RGBX, BGR or BGRX with the given colorimetry. Unlike the overloads above the
+        rounding is exact, BT.601 limited range matches cv::cvtColor bit for bit. For odd
+        sizes the chroma plane holds (width + 1) / 2 pairs and (height + 1) / 2 rows
+    */
+    void yuv420sp2rgb(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,
+                      const u8 *  yBase, ptrdiff_t  yStride,
+                      const u8 * uvBase, ptrdiff_t uvStride,
+                      u8 * dstBase, ptrdiff_t dstStride);
+
+    void yuv420sp2rgbx(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,
+                       const u8 *  yBase, ptrdiff_t  yStride,
+                       const u8 * uvBase, ptrdiff_t uvStride,
+                       u8 * dstBase, ptrdiff_t dstStride);
+
+    void yuv420sp2bgr(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,
+                      const u8 *  yBase, ptrdiff_t  yStride,
+                      const u8 * uvBase, ptrdiff_t uvStride,
+                      u8 * dstBase, ptrdiff_t dstStride);
+
+    void yuv420sp2bgrx(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,
+                       const u8 *  yBase, ptrdiff_t  yStride,
+                       const u8 * uvBase, ptrdiff_t uvStride,
+                       u8 * dstBase, ptrdiff_t dstStride);
+
+    void yuv420i2rgb(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,
+                     const u8 *  yBase, ptrdiff_t  yStride,
+                     const u8 * uvBase, ptrdiff_t uvStride,
+                     u8 * dstBase, ptrdiff_t dstStride);
+
+    void yuv420i2rgbx(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,
+                      const u8 *  yBase, ptrdiff_t  yStride,
+                      const u8 * uvBase, ptrdiff_t uvStride,
+                      u8 * dstBase, ptrdiff_t dstStride);
+
+    void yuv420i2bgr(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,
+                     const u8 *  yBase, ptrdiff_t  yStride,
+                     const u8 * uvBase, ptrdiff_t uvStride,
+                     u8 * dstBase, ptrdiff_t dstStride);
+
+    void yuv420i2bgrx(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,
+                      const u8 *  yBase, ptrdiff_t  yStride,
+                      const u8 * uvBase, ptrdiff_t uvStride,
+                      u8 * dstBase, ptrdiff_t dstStride);
+
+    /*
+        Convert YUV420sp (NV21) or YUV420i (NV12) image to three f32 planes R, G and B,
+        each normalized as (v - mean[c]) / stdDev[c]. The decode matches the colorimetry
+        overloads above and the result is written in the planar float input layout of a
+        network, without an intermediate interleaved frame. For BGR order swap dst0 and
+        dst2 together with their mean and stdDev entries
+    */
+    void yuv420sp2rgbPlanarF32(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,
+                               const u8 *  yBase, ptrdiff_t  yStride,
+                               const u8 * uvBase, ptrdiff_t uvStride,
+                               f32 * dst0Base, ptrdiff_t dst0Stride,
+                               f32 * dst1Base, ptrdiff_t dst1Stride,
+                               f32 * dst2Base, ptrdiff_t dst2Stride,
+                               const f32 * mean, const f32 * stdDev);
+
+    void yuv420i2rgbPlanarF32(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,
+                              const u8 *  yBase, ptrdiff_t  yStride,
+                              const u8 * uvBase, ptrdiff_t uvStride,
+                              f32 * dst0Base, ptrdiff_t dst0Stride,
+                              f32 * dst1Base, ptrdiff_t dst1Stride,
+                              f32 * dst2Base, ptrdiff_t dst2Stride,
+                              const f32 * mean, const f32 * stdDev);
+
+    /*
+        Convert packed YUV 4:2:2 image to RGB, RGBX, BGR or BGRX. Every 4 byte macropixel
+        holds two pixels sharing one chroma pair: Y0 U Y1 V for YUYV (YUY2), U Y0 V Y1 for
+        UYVY. An odd width uses the first half of the last macropixel. BT.601 limited range
+        matches cv::cvtColor exactly
+    */
+    void yuyv2rgb(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,
+                  const u8 * srcBase, ptrdiff_t srcStride,
+                  u8 * dstBase, ptrdiff_t dstStride);
+
+    void yuyv2rgbx(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,
+                   const u8 * srcBase, ptrdiff_t srcStride,
+                   u8 * dstBase, ptrdiff_t dstStride);
+
+    void yuyv2bgr(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,
+                  const u8 * srcBase, ptrdiff_t srcStride,
+                  u8 * dstBase, ptrdiff_t dstStride);
+
+    void yuyv2bgrx(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,
+                   const u8 * srcBase, ptrdiff_t srcStride,
+                   u8 * dstBase, ptrdiff_t dstStride);
+
+    void uyvy2rgb(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,
+                  const u8 * srcBase, ptrdiff_t srcStride,
+                  u8 * dstBase, ptrdiff_t dstStride);
+
+    void uyvy2rgbx(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,
+                   const u8 * srcBase, ptrdiff_t srcStride,
+                   u8 * dstBase, ptrdiff_t dstStride);
+
+    void uyvy2bgr(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,
+                  const u8 * srcBase, ptrdiff_t srcStride,
+                  u8 * dstBase, ptrdiff_t dstStride);
+
+    void uyvy2bgrx(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,
+                   const u8 * srcBase, ptrdiff_t srcStride,
+                   u8 * dstBase, ptrdiff_t dstStride);
+
     /*
         For each point `p` within `size`, do:
         dst[p] = src[p] << shift
@@ -1584,10 +1746,31 @@ namespace CAROTENE_NS {
                    s32 dx, s32 dy,
                    BORDER_MODE borderType, u8 borderValue, Margin borderMargin = Margin());
 
+    /*
+        Interleaved Scharr (dx, dy) per element with reflect 101 borders,
+        the derivative image of cv::calcOpticalFlowPyrLK
+    */
     void ScharrDeriv(const Size2D &size, s32 cn,
                      const u8 * srcBase, ptrdiff_t srcStride,
                      s16 * dstBase, ptrdiff_t dstStride);
 
+    /*
+        Sobel and Scharr first derivatives in x and y in one pass,
+        written as interleaved (dx, dy) pairs
+        NOTE: the functions cannot operate inplace
+    */
+    bool isSobel3x3dXdYSupported(const Size2D &size, BORDER_MODE border, Margin borderMargin = Margin());
+    void Sobel3x3dXdY(const Size2D &size,
+                      const u8 * srcBase, ptrdiff_t srcStride,
+                      s16 * dstBase, ptrdiff_t dstStride,
+                      BORDER_MODE border, u8 borderValue, Margin borderMargin = Margin());
+
+    bool isScharr3x3dXdYSupported(const Size2D &size, BORDER_MODE border, Margin borderMargin = Margin());
+    void Scharr3x3dXdY(const Size2D &size,
+                       const u8 * srcBase, ptrdiff_t srcStride,
+                       s16 * dstBase, ptrdiff_t dstStride,
+                       BORDER_MODE border, u8 borderValue, Margin borderMargin = Margin());
+
     /*
         Calculation of generic separable filtering operator
         rowFilter/colFilter define filter weights
@@ -1716,6 +1899,16 @@ namespace CAROTENE_NS {
                 u8 * dst3Base, ptrdiff_t dst3Stride,
                 u8 * dst1Base, ptrdiff_t dst1Stride);
 
+    /*
+        Split RGBX/BGRX image to 3 planes in channel order, dropping the fourth channel.
+        Writes the planar u8 input layout of a network directly
+    */
+    void rgbx2planar(const Size2D &size,
+                     const u8 * srcBase, ptrdiff_t srcStride,
+                     u8 * dst0Base, ptrdiff_t dst0Stride,
+                     u8 * dst1Base, ptrdiff_t dst1Stride,
+                     u8 * dst2Base, ptrdiff_t dst2Stride);
+
     /*
         Flip image using specified flip mode
     */
@@ -1822,6 +2015,8 @@ namespace CAROTENE_NS {
         For each point `p` within `dstSize`, does convolution
         of tmpl points and size*size square of src points starting with `src[p]`.
         Src should be of size (dstSize+size-1)*(dstSize+size-1)
+        With `normalize` the result is divided by the L2 norms of tmpl and of the
+        src window, as OpenCV TM_CCORR_NORMED does
         NOTE: the function cannot operate inplace
     */
     bool isMatchTemplateSupported(const Size2D &tmplSize);
@@ -1832,6 +2027,17 @@ namespace CAROTENE_NS {
                        f32 * dstBase, ptrdiff_t dstStride,
                        bool normalize);
 
+    /*
+        Same as matchTemplate with the sum of squared differences of tmpl and the
+        src window instead of the convolution, OpenCV TM_SQDIFF and TM_SQDIFF_NORMED
+    */
+    void matchTemplateSqDiff(const Size2D &srcSize,
+                             const u8 * srcBase, ptrdiff_t srcStride,
+                             const Size2D &tmplSize,
+                             const u8 * tmplBase, ptrdiff_t tmplStride,
+                             f32 * dstBase, ptrdiff_t dstStride,
+                             bool normalize);
+
     /*
         Calculation of Laplacian operator
 
@@ -1915,6 +2121,19 @@ namespace CAROTENE_NS {
               KeypointStore *keypoints,
               u8 threshold, bool nonmax_suppression);
 
+    /*
+        FAST corners with the scores and 3x3 non-maximum suppression of FAST, keeping only the
+        maxPerCell strongest corners of every cellSize cell of the image (0 keeps all of them).
+        Ties within a cell go to the corner that comes first in raster order. Keypoints are
+        written in raster order, with the score FAST reports as response.
+    */
+    bool isFASTGridSupported(const Size2D &size, const Size2D &cellSize);
+    void FASTGrid(const Size2D &size,
+                  const u8 *srcBase, ptrdiff_t srcStride,
+                  u8 threshold, bool nonmax_suppression,
+                  const Size2D &cellSize, u32 maxPerCell,
+                  KeypointArrays *keypoints);
+
     /*
         Remap a source image using table and specified
         extrapolation method
@@ -1933,6 +2152,33 @@ namespace CAROTENE_NS {
                      u8 * dstBase, ptrdiff_t dstStride,
                      BORDER_MODE borderMode, u8 borderValue);
 
+    /*
+        Convert a table of (x, y) f32 pairs to fixed-point remap maps: s16 (x, y) pairs and,
+        when alphaBase is not NULL, a u16 fy * 32 + fx index of the 1/32 pixel fractions
+        (OpenCV CV_16SC2 + CV_16UC1 maps). Without alphaBase coordinates are rounded to the
+        nearest pixel. Converting once per calibration halves the map traffic of every frame.
+    */
+    void remapConvertMaps(const Size2D &size,
+                          const f32 * tableBase, ptrdiff_t tableStride,
+                          s16 * xyBase, ptrdiff_t xyStride,
+                          u16 * alphaBase, ptrdiff_t alphaStride);
+
+    /*
+        Remap a source image using fixed-point maps produced by remapConvertMaps
+    */
+    void remapNearestNeighbor(const Size2D &ssize, const Size2D &dsize,
+                              const u8 * srcBase, ptrdiff_t srcStride,
+                              const s16 * xyBase, ptrdiff_t xyStride,
+                              u8 * dstBase, ptrdiff_t dstStride,
+                              BORDER_MODE borderMode, u8 borderValue);
+
+    void remapLinear(const Size2D &ssize, const Size2D &dsize,
+                     const u8 * srcBase, ptrdiff_t srcStride,
+                     const s16 * xyBase, ptrdiff_t xyStride,
+                     const u16 * alphaBase, ptrdiff_t alphaStride,
+                     u8 * dstBase, ptrdiff_t dstStride,
+                     BORDER_MODE borderMode, u8 borderValue);
+
     /*
         Perform an affine transform on an input image
 
@@ -2286,6 +2532,7 @@ namespace CAROTENE_NS {
 
     /*
         Reduce matrix to a vector by calculatin given operation for each column
+        dst[j] = op(src[0][j], ..., src[size.height - 1][j]), sums of u8 are exact
     */
     void reduceColSum(const Size2D &size,
                       const u8 * srcBase, ptrdiff_t srcStride,
@@ -2391,6 +2638,8 @@ namespace CAROTENE_NS {
 
     /*
         Calculates norm
+        normL2 is the sum of squares, without the square root,
+        integer results saturate at the upper bound of s32
     */
     s32 normInf(const Size2D &_size,
                 const u8 * srcBase, ptrdiff_t srcStride);
@@ -2447,7 +2696,7 @@ namespace CAROTENE_NS {
                const f32 * srcBase, ptrdiff_t srcStride);
 
     /*
-        Calculates norm of per element difference
+        Calculates norm of per element difference, with the same conventions as above
     */
     s32 diffNormInf(const Size2D &_size,
                     const u8 * src0Base, ptrdiff_t src0Stride,
@@ -2473,8 +2722,50 @@ namespace CAROTENE_NS {
                    const f32 * src0Base, ptrdiff_t src0Stride,
                    const f32 * src1Base, ptrdiff_t src1Stride);
 
+    /*
+        Histogram of an 8 bit single channel image
+        hist receives 256 bin counts and is overwritten
+    */
+    void calcHist(const Size2D &size,
+                  const u8 * srcBase, ptrdiff_t srcStride,
+                  u32 * hist);
+
+    /*
+        Lookup table transform
+        dst[p] = lut[src[p]] with a 256 entry table
+    */
+    void lut(const Size2D &size,
+             const u8 * srcBase, ptrdiff_t srcStride,
+             u8 * dstBase, ptrdiff_t dstStride,
+             const u8 * lutBase);
+
+    /*
+        Histogram equalization
+        Matches cv::equalizeHist
+    */
+    void equalizeHist(const Size2D &size,
+                      const u8 * srcBase, ptrdiff_t srcStride,
+                      u8 * dstBase, ptrdiff_t dstStride);
+
+    /*
+        Contrast limited adaptive histogram equalization
+        Matches the 8 bit path of cv::CLAHE: tilesX x tilesY tiles over the image extended
+        by BORDER_REFLECT_101, clipLimit relative to the mean bin count (0 disables clipping),
+        bilinear blending of the four nearest tile tables.
+    */
+    bool isClaheSupported(const Size2D &size, u32 tilesX, u32 tilesY);
+    void clahe(const Size2D &size,
+               const u8 * srcBase, ptrdiff_t srcStride,
+               u8 * dstBase, ptrdiff_t dstStride,
+               u32 tilesX, u32 tilesY, f64 clipLimit);
+
     /*
      *        Pyramidal Lucas-Kanade Optical Flow level processing
+     *        Matches cv::calcOpticalFlowPyrLK for one pyramid level. Points are (x, y) pairs in
+     *        level 0 coordinates. Both images must stay readable winSize + 1 pixels around
+     *        `size`, as the bordered pyramids built by cv::buildOpticalFlowPyramid are.
+     *        prevDerivData holds interleaved Scharr (dx, dy) per element; when it is NULL the
+     *        derivatives are computed per tracking window from prevData.
      */
     void pyrLKOptFlowLevel(const Size2D &size, s32 cn,
                            const u8 *prevData, ptrdiff_t prevStride,
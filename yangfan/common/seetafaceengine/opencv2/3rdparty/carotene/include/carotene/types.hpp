@@ -91,7 +91,16 @@ namespace CAROTENE_NS {
     enum COLOR_SPACE
     {
         COLOR_SPACE_BT601,
-        COLOR_SPACE_BT709
+        COLOR_SPACE_BT709,
+        COLOR_SPACE_BT2020
+    };
+
+    // Quantization of YUV data: limited (video) range has luma in [16, 235] and
+    // chroma in [16, 240], full range uses all of [0, 255]
+    enum YUV_RANGE
+    {
+        YUV_RANGE_LIMITED,
+        YUV_RANGE_FULL
     };
 
     struct Size2D {
@@ -120,6 +129,20 @@ namespace CAROTENE_NS {
         virtual void push(f32 kpX, f32 kpY, f32 kpSize, f32 kpAngle=-1, f32 kpResponse=0, s32 kpOctave=0, s32 kpClass_id=-1) = 0;
         virtual ~KeypointStore() {};
     };
+
+    // Struct of arrays keypoint output, the arrays are owned by the caller
+    struct KeypointArrays {
+        KeypointArrays() : x(0), y(0), score(0), capacity(0), count(0) {}
+        KeypointArrays(u16 *x_, u16 *y_, u8 *score_, size_t capacity_)
+            : x(x_), y(y_), score(score_), capacity(capacity_), count(0) {}
+
+        u16 *x, *y;
+        u8 *score;
+        // entries available in each array
+        size_t capacity;
+        // keypoints found, only the first min(count, capacity) are written
+        size_t count;
+    };
 }
 
 #endif
@@ -0,0 +1,57 @@
+#!/usr/bin/env python
+#
+# Compares two carotene_perf --json runs case by case and flags regressions.
+# A case regresses when its median time grew by more than the threshold
+# (10% by default); per-frame noise on the board is a few percent, so use
+# the same budget for both runs and a quiet, clock-pinned device.
+#
+# Cases present in only one run are listed but do not fail the comparison.
+# Exits with 1 when any case regressed, so it can gate a CI step.
+#
+# usage: compare_perf.py <baseline.json> <current.json> [threshold %]
+
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        run = json.load(f)
+    return run, dict((c['name'], c) for c in run['cases'])
+
+
+def main():
+    if len(sys.argv) not in (3, 4):
+        sys.stderr.write('usage: %s <baseline.json> <current.json> [threshold %%]\n' % sys.argv[0])
+        return 2
+    threshold = float(sys.argv[3]) if len(sys.argv) == 4 else 10.0
+
+    base_run, base = load(sys.argv[1])
+    cur_run, cur = load(sys.argv[2])
+    if base_run.get('target') != cur_run.get('target'):
+        sys.stderr.write('warning: comparing %s against %s\n' % (base_run.get('target'), cur_run.get('target')))
+
+    regressed = []
+    print('%-56s %10s %10s %8s' % ('case', 'base ms', 'ms', 'change'))
+    for name in sorted(set(base) & set(cur)):
+        b, c = base[name]['ms'], cur[name]['ms']
+        if not b:
+            continue
+        change = (c - b) / b * 100.0
+        mark = ''
+        if change > threshold:
+            mark = '  REGRESSION'
+            regressed.append(name)
+        print('%-56s %10.3f %10.3f %+7.1f%%%s' % (name, b, c, change, mark))
+
+    for name in sorted(set(base) - set(cur)):
+        print('%-56s only in baseline' % name)
+    for name in sorted(set(cur) - set(base)):
+        print('%-56s new' % name)
+
+    print('%d of %d cases regressed by more than %.1f%%' % (len(regressed), len(set(base) & set(cur)), threshold))
+    return 1 if regressed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
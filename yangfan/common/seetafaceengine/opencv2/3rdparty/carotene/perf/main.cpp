@@ -0,0 +1,216 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+#include "perf_common.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace CAROTENE_NS;
+
+/*
+ * Usage: carotene_perf [filter] [budget ms] [--json file] [--cpu-mhz MHz]
+ *
+ * Runs every case whose name contains `filter`. Cycles per pixel come from the hardware
+ * cycle counter when the kernel grants it, otherwise from the clock given with --cpu-mhz
+ * (pin the governor to that frequency first), otherwise they are not reported. --json
+ * writes the results for perf/compare_perf.py, which flags regressions against a baseline
+ * run.
+ */
+
+namespace {
+
+const char * targetName()
+{
+#if defined(CAROTENE_NEON_EMULATION)
+    return "neon-emulation";
+#elif defined(__aarch64__)
+    return "aarch64";
+#elif defined(__arm__)
+    return "armv7";
+#else
+    return "unknown";
+#endif
+}
+
+struct Result
+{
+    std::string name;
+    size_t iterations;
+    f64 ms, mbps, mpixps, cyclesPerPixel;
+    std::string note;
+};
+
+std::string jsonString(const std::string & s)
+{
+    std::string out = "\"";
+    for (size_t i = 0; i < s.size(); ++i)
+    {
+        char c = s[i];
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += c;
+        }
+        else if ((unsigned char)c < 0x20)
+        {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        }
+        else
+            out += c;
+    }
+    return out + "\"";
+}
+
+// Non-finite and unmeasured values are written as null
+std::string jsonNumber(f64 v, bool valid)
+{
+    if (!valid || v != v)
+        return "null";
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.6g", v);
+    return buf;
+}
+
+bool writeJson(const char * path, const std::vector<Result> & results, f64 budgetMs, const char * cycleSource)
+{
+    FILE * f = std::fopen(path, "w");
+    if (!f)
+        return false;
+    std::fprintf(f, "{\n  \"target\": %s,\n  \"budget_ms\": %s,\n  \"cycles\": %s,\n  \"cases\": [",
+                 jsonString(targetName()).c_str(), jsonNumber(budgetMs, true).c_str(), jsonString(cycleSource).c_str());
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result & r = results[i];
+        std::fprintf(f, "%s\n    {\"name\": %s, \"iterations\": %zu, \"ms\": %s, \"mb_per_s\": %s, "
+                     "\"mpix_per_s\": %s, \"cycles_per_pixel\": %s, \"note\": %s}",
+                     i ? "," : "", jsonString(r.name).c_str(), r.iterations,
+                     jsonNumber(r.ms, true).c_str(), jsonNumber(r.mbps, r.mbps > 0).c_str(),
+                     jsonNumber(r.mpixps, r.mpixps > 0).c_str(), jsonNumber(r.cyclesPerPixel, r.cyclesPerPixel > 0).c_str(),
+                     jsonString(r.note).c_str());
+    }
+    std::fprintf(f, "\n  ]\n}\n");
+    return std::fclose(f) == 0;
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    const char * filter = "";
+    const char * jsonPath = NULL;
+    f64 budgetMs = 200.0, cpuMHz = 0;
+    for (int i = 1, positional = 0; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++i];
+        else if (std::strcmp(argv[i], "--cpu-mhz") == 0 && i + 1 < argc)
+            cpuMHz = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--all") == 0 && positional++ == 0)
+            filter = "";
+        else if (argv[i][0] == '-' && argv[i][1] == '-')
+        {
+            std::printf("usage: %s [filter | --all] [budget ms] [--json file] [--cpu-mhz MHz]\n", argv[0]);
+            return 1;
+        }
+        else if (positional++ == 0)
+            filter = argv[i];
+        else
+            budgetMs = std::atof(argv[i]);
+    }
+
+    if (!isSupportedConfiguration())
+    {
+        std::printf("carotene is built without NEON, nothing to measure\n");
+        return 0;
+    }
+
+    const bool pmu = perf::CycleCounter::instance().available();
+    const char * cycleSource = pmu ? "pmu" : cpuMHz > 0 ? "cpu-mhz" : "none";
+    std::printf("target %s, cycles from %s\n", targetName(), cycleSource);
+    std::printf("%-56s %10s %10s %10s %10s %10s\n", "case", "iters", "ms", "MB/s", "Mpix/s", "cyc/px");
+
+    std::vector<Result> results;
+    const std::vector<perf::PerfCase> & cases = perf::PerfRegistry::cases();
+    for (size_t i = 0; i < cases.size(); ++i)
+    {
+        if (std::strstr(cases[i].name.c_str(), filter) == NULL)
+            continue;
+
+        perf::State state(budgetMs, cases[i].size);
+        cases[i].func(state);
+
+        Result r;
+        r.name = cases[i].name;
+        r.iterations = state.iterations();
+        r.ms = state.medianMs();
+        r.mbps = r.ms > 0 ? state.bytesProcessed() / (r.ms * 1e3) : 0;
+        r.mpixps = r.ms > 0 ? state.itemsProcessed() / (r.ms * 1e3) : 0;
+        f64 cycles = pmu ? state.medianCycles() : r.ms * cpuMHz * 1e3;
+        r.cyclesPerPixel = state.itemsProcessed() > 0 ? cycles / state.itemsProcessed() : 0;
+        r.note = state.getNote();
+        results.push_back(r);
+
+        std::printf("%-56s %10zu %10.3f %10.1f", r.name.c_str(), r.iterations, r.ms, r.mbps);
+        if (r.mpixps > 0)
+            std::printf(" %10.2f", r.mpixps);
+        else
+            std::printf(" %10s", "-");
+        if (r.cyclesPerPixel > 0)
+            std::printf(" %10.2f", r.cyclesPerPixel);
+        else
+            std::printf(" %10s", "-");
+        std::printf("%s%s\n", r.note.empty() ? "" : "  ", r.note.c_str());
+    }
+
+    if (results.empty())
+    {
+        std::printf("no case matches \"%s\"\n", filter);
+        return 1;
+    }
+
+    if (jsonPath && !writeJson(jsonPath, results, budgetMs, cycleSource))
+    {
+        std::printf("cannot write %s\n", jsonPath);
+        return 1;
+    }
+    return 0;
+}
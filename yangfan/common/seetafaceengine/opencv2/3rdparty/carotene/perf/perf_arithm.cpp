@@ -0,0 +1,282 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+#include "perf_common.hpp"
+
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+/*
+    Element-wise arithmetic, logic, comparison and conversion kernels over the standard frame
+    sizes, so their throughput can be tracked per size and type
+*/
+
+namespace {
+
+// Pseudo random values in [0, 255], in range for every type
+template <typename T>
+std::vector<T> frame(const Size2D & size, u32 seed)
+{
+    std::vector<T> v(size.total());
+    for (size_t i = 0; i < v.size(); ++i)
+        v[i] = (T)((((u32)i + seed) * 2654435761u) >> 24);
+    return v;
+}
+
+template <typename S, typename D>
+void setProcessed(perf::State & state, size_t srcCount)
+{
+    state.setBytesProcessed(state.size().total() * (srcCount * sizeof(S) + sizeof(D)));
+    state.setItemsProcessed(state.size().total());
+}
+
+template <typename S, typename D,
+          void (*func)(const Size2D &, const S *, ptrdiff_t, const S *, ptrdiff_t, D *, ptrdiff_t)>
+void perfBinary(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<S> src0 = frame<S>(size, 1), src1 = frame<S>(size, 2);
+    std::vector<D> dst(size.total());
+    state.run([&]() {
+        func(size, &src0[0], size.width * sizeof(S), &src1[0], size.width * sizeof(S), &dst[0], size.width * sizeof(D));
+    });
+    setProcessed<S, D>(state, 2);
+}
+
+template <typename S, typename D,
+          void (*func)(const Size2D &, const S *, ptrdiff_t, const S *, ptrdiff_t, D *, ptrdiff_t, CONVERT_POLICY)>
+void perfBinarySaturate(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<S> src0 = frame<S>(size, 1), src1 = frame<S>(size, 2);
+    std::vector<D> dst(size.total());
+    state.run([&]() {
+        func(size, &src0[0], size.width * sizeof(S), &src1[0], size.width * sizeof(S), &dst[0], size.width * sizeof(D),
+             CONVERT_POLICY_SATURATE);
+    });
+    setProcessed<S, D>(state, 2);
+}
+
+template <typename T,
+          void (*func)(const Size2D &, const T *, ptrdiff_t, const T *, ptrdiff_t, T *, ptrdiff_t, f32, CONVERT_POLICY)>
+void perfBinaryScale(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<T> src0 = frame<T>(size, 1), src1 = frame<T>(size, 2), dst(size.total());
+    state.run([&]() {
+        func(size, &src0[0], size.width * sizeof(T), &src1[0], size.width * sizeof(T), &dst[0], size.width * sizeof(T),
+             0.5f, CONVERT_POLICY_SATURATE);
+    });
+    setProcessed<T, T>(state, 2);
+}
+
+template <void (*func)(const Size2D &, const f32 *, ptrdiff_t, const f32 *, ptrdiff_t, f32 *, ptrdiff_t, f32)>
+void perfBinaryScaleF32(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<f32> src0 = frame<f32>(size, 1), src1 = frame<f32>(size, 2), dst(size.total());
+    state.run([&]() {
+        func(size, &src0[0], size.width * sizeof(f32), &src1[0], size.width * sizeof(f32), &dst[0], size.width * sizeof(f32), 0.5f);
+    });
+    setProcessed<f32, f32>(state, 2);
+}
+
+template <typename T>
+void perfAddWeighted(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<T> src0 = frame<T>(size, 1), src1 = frame<T>(size, 2), dst(size.total());
+    state.run([&]() {
+        addWeighted(size, &src0[0], size.width * sizeof(T), &src1[0], size.width * sizeof(T), &dst[0], size.width * sizeof(T),
+                    0.3f, 0.7f, 1.0f);
+    });
+    setProcessed<T, T>(state, 2);
+}
+
+template <typename S, typename D>
+void perfConvertScale(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<S> src = frame<S>(size, 1);
+    std::vector<D> dst(size.total());
+    state.run([&]() {
+        convertScale(size, &src[0], size.width * sizeof(S), &dst[0], size.width * sizeof(D), 0.75, 3.0);
+    });
+    setProcessed<S, D>(state, 1);
+}
+
+template <typename T>
+void perfInRange(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<T> src = frame<T>(size, 1), lo(size.total(), (T)64), hi(size.total(), (T)192);
+    std::vector<u8> dst(size.total());
+    state.run([&]() {
+        inRange(size, &src[0], size.width * sizeof(T), &lo[0], size.width * sizeof(T), &hi[0], size.width * sizeof(T),
+                &dst[0], size.width);
+    });
+    setProcessed<T, u8>(state, 3);
+}
+
+template <typename T>
+void perfMinMaxLoc(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<T> src = frame<T>(size, 1);
+    T minVal, maxVal;
+    size_t minCol, minRow, maxCol, maxRow;
+    state.run([&]() {
+        minMaxLoc(size, &src[0], size.width * sizeof(T), minVal, minCol, minRow, maxVal, maxCol, maxRow);
+    });
+    state.setBytesProcessed(src.size() * sizeof(T));
+    state.setItemsProcessed(size.total());
+}
+
+void perfMinMaxVals(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<u8> src = frame<u8>(size, 1);
+    u8 minVal, maxVal;
+    state.run([&]() {
+        minMaxVals(size, &src[0], size.width, &minVal, &maxVal);
+    });
+    state.setBytesProcessed(src.size());
+    state.setItemsProcessed(size.total());
+}
+
+void perfBitwiseNot(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<u8> src = frame<u8>(size, 1), dst(size.total());
+    state.run([&]() {
+        bitwiseNot(size, &src[0], size.width, &dst[0], size.width);
+    });
+    setProcessed<u8, u8>(state, 1);
+}
+
+void perfLShift(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<u8> src = frame<u8>(size, 1);
+    std::vector<s16> dst(size.total());
+    state.run([&]() {
+        lshift(size, &src[0], size.width, &dst[0], size.width * sizeof(s16), 3);
+    });
+    setProcessed<u8, s16>(state, 1);
+}
+
+void perfRShift(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<s16> src = frame<s16>(size, 1);
+    std::vector<u8> dst(size.total());
+    state.run([&]() {
+        rshift(size, &src[0], size.width * sizeof(s16), &dst[0], size.width, 3, CONVERT_POLICY_SATURATE);
+    });
+    setProcessed<s16, u8>(state, 1);
+}
+
+void perfAccumulate(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<u8> src = frame<u8>(size, 1);
+    std::vector<s16> acc(size.total());
+    state.run([&]() {
+        accumulate(size, &src[0], size.width, &acc[0], size.width * sizeof(s16));
+    });
+    setProcessed<u8, s16>(state, 2);
+}
+
+void perfAccumulateWeighted(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<u8> src = frame<u8>(size, 1), acc = frame<u8>(size, 2);
+    state.run([&]() {
+        accumulateWeighted(size, &src[0], size.width, &acc[0], size.width, 0.25f);
+    });
+    setProcessed<u8, u8>(state, 2);
+}
+
+void perfReciprocal(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<f32> src = frame<f32>(size, 1), dst(size.total());
+    state.run([&]() {
+        reciprocal(size, &src[0], size.width * sizeof(f32), &dst[0], size.width * sizeof(f32), 1.0f);
+    });
+    setProcessed<f32, f32>(state, 1);
+}
+
+} // namespace
+
+CAROTENE_PERF_SIZES("add u8 saturate", (perfBinarySaturate<u8, u8, add>));
+CAROTENE_PERF_SIZES("add u8->s16", (perfBinarySaturate<u8, s16, add>));
+CAROTENE_PERF_SIZES("add s16 saturate", (perfBinarySaturate<s16, s16, add>));
+CAROTENE_PERF_SIZES("add f32", (perfBinary<f32, f32, add>));
+CAROTENE_PERF_SIZES("div u8 scale", (perfBinaryScale<u8, div>));
+CAROTENE_PERF_SIZES("div s16 scale", (perfBinaryScale<s16, div>));
+CAROTENE_PERF_SIZES("div f32 scale", perfBinaryScaleF32<div>);
+CAROTENE_PERF_SIZES("reciprocal f32", perfReciprocal);
+CAROTENE_PERF_SIZES("addWeighted u8", perfAddWeighted<u8>);
+CAROTENE_PERF_SIZES("addWeighted f32", perfAddWeighted<f32>);
+CAROTENE_PERF_SIZES("absDiff u8", (perfBinary<u8, u8, absDiff>));
+CAROTENE_PERF_SIZES("absDiff s16", (perfBinary<s16, s16, absDiff>));
+CAROTENE_PERF_SIZES("absDiff f32", (perfBinary<f32, f32, absDiff>));
+CAROTENE_PERF_SIZES("min u8", (perfBinary<u8, u8, min>));
+CAROTENE_PERF_SIZES("max f32", (perfBinary<f32, f32, max>));
+CAROTENE_PERF_SIZES("bitwiseAnd u8", (perfBinary<u8, u8, bitwiseAnd>));
+CAROTENE_PERF_SIZES("bitwiseXor u8", (perfBinary<u8, u8, bitwiseXor>));
+CAROTENE_PERF_SIZES("bitwiseNot u8", perfBitwiseNot);
+CAROTENE_PERF_SIZES("cmpEQ u8", (perfBinary<u8, u8, cmpEQ>));
+CAROTENE_PERF_SIZES("cmpGT u8", (perfBinary<u8, u8, cmpGT>));
+CAROTENE_PERF_SIZES("cmpGT s16", (perfBinary<s16, u8, cmpGT>));
+CAROTENE_PERF_SIZES("cmpGE f32", (perfBinary<f32, u8, cmpGE>));
+CAROTENE_PERF_SIZES("inRange u8", perfInRange<u8>);
+CAROTENE_PERF_SIZES("inRange f32", perfInRange<f32>);
+CAROTENE_PERF_SIZES("convertScale u8->u8", (perfConvertScale<u8, u8>));
+CAROTENE_PERF_SIZES("convertScale u8->f32", (perfConvertScale<u8, f32>));
+CAROTENE_PERF_SIZES("convertScale s16->u8", (perfConvertScale<s16, u8>));
+CAROTENE_PERF_SIZES("convertScale f32->u8", (perfConvertScale<f32, u8>));
+CAROTENE_PERF_SIZES("lshift u8->s16", perfLShift);
+CAROTENE_PERF_SIZES("rshift s16->u8", perfRShift);
+CAROTENE_PERF_SIZES("accumulate u8->s16", perfAccumulate);
+CAROTENE_PERF_SIZES("accumulateWeighted u8", perfAccumulateWeighted);
+CAROTENE_PERF_SIZES("minMaxVals u8", perfMinMaxVals);
+CAROTENE_PERF_SIZES("minMaxLoc u8", perfMinMaxLoc<u8>);
+CAROTENE_PERF_SIZES("minMaxLoc f32", perfMinMaxLoc<f32>);
@@ -0,0 +1,177 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+#include "perf_common.hpp"
+
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+/*
+    Color conversion, channel shuffling and flip over the standard frame sizes
+*/
+
+namespace {
+
+std::vector<u8> frame(const Size2D & size, size_t cn)
+{
+    std::vector<u8> v(size.total() * cn);
+    for (size_t i = 0; i < v.size(); ++i)
+        v[i] = (u8)(((u32)i * 2654435761u) >> 24);
+    return v;
+}
+
+typedef void (*ColorFunc)(const Size2D &, const u8 *, ptrdiff_t, u8 *, ptrdiff_t);
+
+template <size_t scn, size_t dcn, ColorFunc func>
+void perfColor(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<u8> src = frame(size, scn), dst(size.total() * dcn);
+    state.run([&]() {
+        func(size, &src[0], size.width * scn, &dst[0], size.width * dcn);
+    });
+    state.setBytesProcessed(src.size() + dst.size());
+    state.setItemsProcessed(size.total());
+}
+
+void rgb2grayBT601(const Size2D & size, const u8 * src, ptrdiff_t srcStride, u8 * dst, ptrdiff_t dstStride)
+{
+    rgb2gray(size, COLOR_SPACE_BT601, src, srcStride, dst, dstStride);
+}
+
+void rgbx2grayBT601(const Size2D & size, const u8 * src, ptrdiff_t srcStride, u8 * dst, ptrdiff_t dstStride)
+{
+    rgbx2gray(size, COLOR_SPACE_BT601, src, srcStride, dst, dstStride);
+}
+
+void rgb2hsv180(const Size2D & size, const u8 * src, ptrdiff_t srcStride, u8 * dst, ptrdiff_t dstStride)
+{
+    rgb2hsv(size, src, srcStride, dst, dstStride, 180);
+}
+
+void extract3Green(const Size2D & size, const u8 * src, ptrdiff_t srcStride, u8 * dst, ptrdiff_t dstStride)
+{
+    extract3(size, src, srcStride, dst, dstStride, 1);
+}
+
+void perfSplit3(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<u8> src = frame(size, 3), dst(size.total() * 3);
+    const size_t plane = size.total();
+    state.run([&]() {
+        split3(size, &src[0], size.width * 3, &dst[0], size.width, &dst[plane], size.width, &dst[2 * plane], size.width);
+    });
+    state.setBytesProcessed(src.size() + dst.size());
+    state.setItemsProcessed(size.total());
+}
+
+void perfCombine3(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<u8> src = frame(size, 3), dst(size.total() * 3);
+    const size_t plane = size.total();
+    state.run([&]() {
+        combine3(size, &src[0], size.width, &src[plane], size.width, &src[2 * plane], size.width, &dst[0], size.width * 3);
+    });
+    state.setBytesProcessed(src.size() + dst.size());
+    state.setItemsProcessed(size.total());
+}
+
+void perfCombine4Alpha(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<u8> rgb = frame(size, 3), alpha = frame(size, 1), dst(size.total() * 4);
+    state.run([&]() {
+        combine4(size, &rgb[0], size.width * 3, &alpha[0], size.width, &dst[0], size.width * 4);
+    });
+    state.setBytesProcessed(rgb.size() + alpha.size() + dst.size());
+    state.setItemsProcessed(size.total());
+}
+
+void perfRGBX2Planar(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<u8> src = frame(size, 4), dst(size.total() * 3);
+    const size_t plane = size.total();
+    state.run([&]() {
+        rgbx2planar(size, &src[0], size.width * 4, &dst[0], size.width, &dst[plane], size.width, &dst[2 * plane], size.width);
+    });
+    state.setBytesProcessed(src.size() + dst.size());
+    state.setItemsProcessed(size.total());
+}
+
+template <FLIP_MODE mode, u32 cn>
+void perfFlip(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<u8> src = frame(size, cn), dst(src.size());
+    if (!isFlipSupported(mode, cn))
+    {
+        state.setNote("unsupported");
+        return;
+    }
+    state.run([&]() {
+        flip(size, &src[0], size.width * cn, &dst[0], size.width * cn, mode, cn);
+    });
+    state.setBytesProcessed(src.size() + dst.size());
+    state.setItemsProcessed(size.total());
+}
+
+} // namespace
+
+CAROTENE_PERF_SIZES("rgb2gray BT601", (perfColor<3, 1, rgb2grayBT601>));
+CAROTENE_PERF_SIZES("rgbx2gray BT601", (perfColor<4, 1, rgbx2grayBT601>));
+CAROTENE_PERF_SIZES("gray2rgb", (perfColor<1, 3, gray2rgb>));
+CAROTENE_PERF_SIZES("gray2rgbx", (perfColor<1, 4, gray2rgbx>));
+CAROTENE_PERF_SIZES("rgb2bgr", (perfColor<3, 3, rgb2bgr>));
+CAROTENE_PERF_SIZES("rgbx2bgrx", (perfColor<4, 4, rgbx2bgrx>));
+CAROTENE_PERF_SIZES("rgb2rgbx", (perfColor<3, 4, rgb2rgbx>));
+CAROTENE_PERF_SIZES("rgbx2rgb", (perfColor<4, 3, rgbx2rgb>));
+CAROTENE_PERF_SIZES("rgb2hsv", (perfColor<3, 3, rgb2hsv180>));
+CAROTENE_PERF_SIZES("rgb2ycrcb", (perfColor<3, 3, rgb2ycrcb>));
+CAROTENE_PERF_SIZES("rgb2rgb565", (perfColor<3, 2, rgb2rgb565>));
+CAROTENE_PERF_SIZES("extract3", (perfColor<3, 1, extract3Green>));
+CAROTENE_PERF_SIZES("split3 u8", perfSplit3);
+CAROTENE_PERF_SIZES("combine3 u8", perfCombine3);
+CAROTENE_PERF_SIZES("combine4 rgb+alpha", perfCombine4Alpha);
+CAROTENE_PERF_SIZES("rgbx2planar", perfRGBX2Planar);
+CAROTENE_PERF_SIZES("flip horizontal u8", (perfFlip<FLIP_HORIZONTAL_MODE, 1>));
+CAROTENE_PERF_SIZES("flip vertical u8", (perfFlip<FLIP_VERTICAL_MODE, 1>));
+CAROTENE_PERF_SIZES("flip both u8c3", (perfFlip<FLIP_BOTH_MODE, 3>));
@@ -0,0 +1,251 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#ifndef CAROTENE_PERF_COMMON_HPP
+#define CAROTENE_PERF_COMMON_HPP
+
+#include <carotene/functions.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Minimal timing harness. Every case runs its body repeatedly for a fixed time budget and
+ * reports the median of the per-iteration times, so that a single preempted iteration on a
+ * busy board does not skew the result.
+ */
+
+namespace CAROTENE_NS { namespace perf {
+
+/*
+ * User space CPU cycles of the process through perf_event_open, threads started while
+ * counting included. Unavailable off Linux, in most containers and with a restrictive
+ * perf_event_paranoid; the runner then derives cycles from --cpu-mhz or leaves them out.
+ */
+class CycleCounter
+{
+public:
+    static CycleCounter & instance()
+    {
+        static CycleCounter counter;
+        return counter;
+    }
+
+    bool available() const { return fd >= 0; }
+
+    u64 read() const
+    {
+        u64 value = 0;
+#if defined(__linux__)
+        if (fd < 0 || ::read(fd, &value, sizeof(value)) != (ssize_t)sizeof(value))
+            return 0;
+#endif
+        return value;
+    }
+
+private:
+    CycleCounter() : fd(-1)
+    {
+#if defined(__linux__) && defined(__NR_perf_event_open)
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.inherit = 1;
+        fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+
+    ~CycleCounter()
+    {
+#if defined(__linux__)
+        if (fd >= 0)
+            close(fd);
+#endif
+    }
+
+    CycleCounter(const CycleCounter &);
+    CycleCounter & operator=(const CycleCounter &);
+
+    int fd;
+};
+
+class State
+{
+public:
+    explicit State(f64 budgetMs, const Size2D & frameSize = Size2D()) :
+        budget(budgetMs), frame(frameSize), bytes(0), items(0)
+    {
+    }
+
+    // Runs body() until the budget is spent, at least a few times
+    template <typename Body>
+    void run(Body body)
+    {
+        typedef std::chrono::steady_clock clock;
+        const CycleCounter & counter = CycleCounter::instance();
+        body(); // warm up caches and lazily allocated buffers
+        clock::time_point start = clock::now();
+        do
+        {
+            u64 c0 = counter.read();
+            clock::time_point t0 = clock::now();
+            body();
+            samples.push_back(std::chrono::duration<f64, std::milli>(clock::now() - t0).count());
+            if (counter.available())
+                cycleSamples.push_back((f64)(counter.read() - c0));
+        } while (samples.size() < 5 ||
+                 std::chrono::duration<f64, std::milli>(clock::now() - start).count() < budget);
+    }
+
+    // Frame size of a case registered with CAROTENE_PERF_SIZES, empty otherwise
+    const Size2D & size() const { return frame; }
+
+    void setBytesProcessed(size_t b) { bytes = b; }
+    size_t bytesProcessed() const { return bytes; }
+    // Pixels per iteration, or the unit of work of kernels whose cost is not per pixel,
+    // e.g. tracked points. Reported as Mpix/s and cycles per pixel
+    void setItemsProcessed(size_t n) { items = n; }
+    size_t itemsProcessed() const { return items; }
+    // Free text printed after the timings, e.g. properties of the output
+    void setNote(const std::string & text) { note = text; }
+    const std::string & getNote() const { return note; }
+    size_t iterations() const { return samples.size(); }
+
+    f64 medianMs() { return median(samples); }
+    // Median cycles per iteration, 0 without a cycle counter
+    f64 medianCycles() { return median(cycleSamples); }
+
+private:
+    static f64 median(std::vector<f64> & v)
+    {
+        if (v.empty())
+            return 0;
+        std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+        return v[v.size() / 2];
+    }
+
+    f64 budget;
+    Size2D frame;
+    size_t bytes;
+    size_t items;
+    std::string note;
+    std::vector<f64> samples;
+    std::vector<f64> cycleSamples;
+};
+
+typedef void (*PerfFunc)(State &);
+
+struct PerfCase
+{
+    std::string name;
+    PerfFunc func;
+    Size2D size;
+};
+
+struct PerfRegistry
+{
+    static std::vector<PerfCase> & cases()
+    {
+        static std::vector<PerfCase> list;
+        return list;
+    }
+};
+
+// VGA, 720p, 1080p and 4K, the frame sizes of the size sweeps
+inline std::vector<Size2D> standardSizes()
+{
+    std::vector<Size2D> sizes;
+    sizes.push_back(Size2D(640, 480));
+    sizes.push_back(Size2D(1280, 720));
+    sizes.push_back(Size2D(1920, 1080));
+    sizes.push_back(Size2D(3840, 2160));
+    return sizes;
+}
+
+struct PerfRegistrar
+{
+    PerfRegistrar(const std::string & name, PerfFunc func)
+    {
+        PerfCase c = { name, func, Size2D() };
+        PerfRegistry::cases().push_back(c);
+    }
+
+    // One case per standard size, named "name/WxH"
+    PerfRegistrar(const std::string & name, PerfFunc func, const std::vector<Size2D> & sizes)
+    {
+        for (size_t i = 0; i < sizes.size(); ++i)
+        {
+            char suffix[32];
+            std::snprintf(suffix, sizeof(suffix), "/%zux%zu", sizes[i].width, sizes[i].height);
+            PerfCase c = { name + suffix, func, sizes[i] };
+            PerfRegistry::cases().push_back(c);
+        }
+    }
+};
+
+#define CAROTENE_PERF_CONCAT_(a, b) a##b
+#define CAROTENE_PERF_CONCAT(a, b) CAROTENE_PERF_CONCAT_(a, b)
+
+// Registers `func` under `name`; a function can be registered with several parameter sets
+#define CAROTENE_PERF(name, func) \
+    static ::CAROTENE_NS::perf::PerfRegistrar CAROTENE_PERF_CONCAT(carotene_perf_, __LINE__)(name, func)
+
+// Registers `func` once per standard size, the body reads it from State::size()
+#define CAROTENE_PERF_SIZES(name, func) \
+    static ::CAROTENE_NS::perf::PerfRegistrar CAROTENE_PERF_CONCAT(carotene_perf_, __LINE__)(name, func, \
+        ::CAROTENE_NS::perf::standardSizes())
+
+}}
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "perf_common.hpp"
+
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+namespace {
+
+const Size2D size1080p(1920, 1080);
+
+template <typename T>
+std::vector<T> frame(size_t seed = 0)
+{
+    std::vector<T> src(size1080p.width * size1080p.height);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (T)((s32)(((i + seed) * 7 + (i >> 9)) & 0xFF) - 64);
+    return src;
+}
+
+template <typename T>
+void perfCountNonZero(perf::State & state)
+{
+    std::vector<T> src = frame<T>();
+    volatile s32 result = 0;
+    state.run([&]() { result = countNonZero(size1080p, &src[0], size1080p.width * sizeof(T)); });
+    (void)result;
+    state.setBytesProcessed(src.size() * sizeof(T));
+}
+
+template <typename T>
+void perfDotProduct(perf::State & state)
+{
+    std::vector<T> src0 = frame<T>(), src1 = frame<T>(3);
+    volatile f64 result = 0;
+    state.run([&]() {
+        result = dotProduct(size1080p, &src0[0], size1080p.width * sizeof(T), &src1[0], size1080p.width * sizeof(T));
+    });
+    (void)result;
+    state.setBytesProcessed(src0.size() * sizeof(T) * 2);
+}
+
+void perfMeanStdDev(perf::State & state)
+{
+    std::vector<u8> src = frame<u8>();
+    f32 mean = 0, stddev = 0;
+    state.run([&]() { meanStdDev(size1080p, &src[0], size1080p.width, &mean, &stddev); });
+    state.setBytesProcessed(src.size());
+}
+
+void perfIntegral(perf::State & state)
+{
+    std::vector<u8> src = frame<u8>();
+    std::vector<u32> dst(src.size());
+    state.run([&]() { integral(size1080p, &src[0], size1080p.width, &dst[0], size1080p.width * sizeof(u32)); });
+    state.setBytesProcessed(src.size());
+}
+
+void perfSqrIntegral(perf::State & state)
+{
+    std::vector<u8> src = frame<u8>();
+    std::vector<f64> dst(src.size());
+    state.run([&]() { sqrIntegral(size1080p, &src[0], size1080p.width, &dst[0], size1080p.width * sizeof(f64)); });
+    state.setBytesProcessed(src.size());
+}
+
+template <typename S, typename D>
+void perfConvert(perf::State & state)
+{
+    std::vector<S> src = frame<S>();
+    std::vector<D> dst(src.size());
+    state.run([&]() { convert(size1080p, &src[0], size1080p.width * sizeof(S), &dst[0], size1080p.width * sizeof(D)); });
+    state.setBytesProcessed(src.size() * (sizeof(S) + sizeof(D)));
+}
+
+} // namespace
+
+CAROTENE_PERF("countNonZero/u8/1920x1080", perfCountNonZero<u8>);
+CAROTENE_PERF("countNonZero/f32/1920x1080", perfCountNonZero<f32>);
+CAROTENE_PERF("dotProduct/u8/1920x1080", perfDotProduct<u8>);
+CAROTENE_PERF("dotProduct/f32/1920x1080", perfDotProduct<f32>);
+CAROTENE_PERF("meanStdDev/u8/1920x1080", perfMeanStdDev);
+CAROTENE_PERF("integral/u8/1920x1080", perfIntegral);
+CAROTENE_PERF("sqrIntegral/u8/1920x1080", perfSqrIntegral);
+CAROTENE_PERF("convert/u8 to f32/1920x1080", (perfConvert<u8, f32>));
+CAROTENE_PERF("convert/f32 to u8/1920x1080", (perfConvert<f32, u8>));
+CAROTENE_PERF("convert/f32 to s16/1920x1080", (perfConvert<f32, s16>));
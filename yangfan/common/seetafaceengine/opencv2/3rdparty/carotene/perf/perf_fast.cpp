@@ -0,0 +1,204 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "perf_common.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+namespace {
+
+const Size2D frameSize(1280, 720);
+const u8 threshold = 20;
+
+/*
+    Clutter of small blobs whose density falls off from left to right, a frame where an
+    uncapped detector spends most keypoints on one side. The vectors live for the whole run,
+    so that every case sees the same frame.
+*/
+const std::vector<u8> & scene()
+{
+    static std::vector<u8> src;
+    if (!src.empty())
+        return src;
+    src.resize(frameSize.total());
+    u32 state = 0x2545F491u;
+    for (size_t i = 0; i < src.size(); ++i)
+    {
+        state = state * 1664525u + 1013904223u;
+        src[i] = (u8)(96 + (state >> 28));
+    }
+    for (size_t n = 0; n < frameSize.total() / 24; ++n)
+    {
+        state = state * 1664525u + 1013904223u;
+        size_t x = (state >> 8) % frameSize.width;
+        state = state * 1664525u + 1013904223u;
+        // density proportional to the distance from the right border
+        if ((state >> 8) % frameSize.width < x)
+            continue;
+        size_t y = (state >> 16) % frameSize.height;
+        u8 v = (u8)(state >> 24);
+        for (size_t dy = 0; dy < 3 && y + dy < frameSize.height; ++dy)
+            for (size_t dx = 0; dx < 3 && x + dx < frameSize.width; ++dx)
+                src[(y + dy) * frameSize.width + x + dx] = v;
+    }
+    return src;
+}
+
+// Cells of 64x64 that got a keypoint and the most any cell got
+void describeSpread(perf::State & state, const u16 * xs, const u16 * ys, size_t count)
+{
+    const size_t cellsX = (frameSize.width + 63) / 64, cellsY = (frameSize.height + 63) / 64;
+    std::vector<size_t> perCell(cellsX * cellsY, 0);
+    for (size_t k = 0; k < count; ++k)
+        ++perCell[(ys[k] / 64) * cellsX + xs[k] / 64];
+    size_t covered = perCell.size() - std::count(perCell.begin(), perCell.end(), (size_t)0);
+    char note[128];
+    std::snprintf(note, sizeof(note), "%zu kp, 64x64 cells covered %zu/%zu, max %zu per cell",
+                  count, covered, perCell.size(), *std::max_element(perCell.begin(), perCell.end()));
+    state.setNote(note);
+}
+
+struct VectorStore : public KeypointStore
+{
+    std::vector<u16> x, y;
+    virtual void push(f32 kpX, f32 kpY, f32, f32, f32, s32, s32)
+    {
+        x.push_back((u16)kpX);
+        y.push_back((u16)kpY);
+    }
+};
+
+void perfFAST(perf::State & state)
+{
+    const std::vector<u8> & src = scene();
+    VectorStore store;
+    state.run([&]() {
+        store.x.clear();
+        store.y.clear();
+        FAST(frameSize, const_cast<u8 *>(&src[0]), frameSize.width, &store, threshold, true);
+    });
+    state.setBytesProcessed(src.size());
+    state.setItemsProcessed(store.x.size());
+    describeSpread(state, &store.x[0], &store.y[0], store.x.size());
+}
+
+template <u32 cell, u32 maxPerCell>
+void perfFASTGrid(perf::State & state)
+{
+    const std::vector<u8> & src = scene();
+    const size_t capacity = 1 << 16;
+    std::vector<u16> xs(capacity), ys(capacity);
+    std::vector<u8> scores(capacity);
+    KeypointArrays kp(&xs[0], &ys[0], &scores[0], capacity);
+    state.run([&]() {
+        FASTGrid(frameSize, &src[0], frameSize.width, threshold, true, Size2D(cell, cell), maxPerCell, &kp);
+    });
+    state.setBytesProcessed(src.size());
+    state.setItemsProcessed(kp.count);
+    describeSpread(state, &xs[0], &ys[0], std::min(kp.count, capacity));
+}
+
+/*
+    Baseline: FAST as a plain loop, the test on the compass pixels, the score of every corner
+    from its 16 arcs, and the 3x3 suppression over the score map, one pixel at a time
+*/
+void perfFASTNaive(perf::State & state)
+{
+    const std::vector<u8> & src = scene();
+    const s32 w = (s32)frameSize.width, h = (s32)frameSize.height;
+    const s32 circle[16] = { 3 * w, 3 * w + 1, 2 * w + 2, w + 3, 3, -w + 3, -2 * w + 2, -3 * w + 1,
+                             -3 * w, -3 * w - 1, -2 * w - 2, -w - 3, -3, w - 3, 2 * w - 2, 3 * w - 1 };
+    std::vector<s32> strength(src.size());
+    std::vector<u16> xs, ys;
+    state.run([&]() {
+        std::fill(strength.begin(), strength.end(), 0);
+        for (s32 y = 3; y < h - 3; ++y)
+            for (s32 x = 3; x < w - 3; ++x)
+            {
+                const u8 * p = &src[y * w + x];
+                s32 v = p[0], t = threshold;
+                s32 n = (p[circle[0]] > v + t) + (p[circle[4]] > v + t) + (p[circle[8]] > v + t) + (p[circle[12]] > v + t);
+                s32 m = (p[circle[0]] < v - t) + (p[circle[4]] < v - t) + (p[circle[8]] < v - t) + (p[circle[12]] < v - t);
+                if (n < 2 && m < 2)
+                    continue;
+                s32 q = 0;
+                for (s32 k = 0; k < 16; ++k)
+                {
+                    s32 darker = 255, brighter = 255;
+                    for (s32 l = 0; l < 9; ++l)
+                    {
+                        s32 d = v - p[circle[(k + l) & 15]];
+                        darker = std::min(darker, d);
+                        brighter = std::min(brighter, -d);
+                    }
+                    q = std::max(q, std::max(darker, brighter));
+                }
+                strength[y * w + x] = q > t ? q : 0;
+            }
+
+        xs.clear();
+        ys.clear();
+        for (s32 y = 3; y < h - 3; ++y)
+            for (s32 x = 3; x < w - 3; ++x)
+            {
+                const s32 * s = &strength[y * w + x];
+                if (s[0] > 1 && s[0] > s[-1] && s[0] > s[1] && s[0] > s[-w - 1] && s[0] > s[-w] &&
+                    s[0] > s[-w + 1] && s[0] > s[w - 1] && s[0] > s[w] && s[0] > s[w + 1])
+                {
+                    xs.push_back((u16)x);
+                    ys.push_back((u16)y);
+                }
+            }
+    });
+    state.setBytesProcessed(src.size());
+    state.setItemsProcessed(xs.size());
+    describeSpread(state, &xs[0], &ys[0], xs.size());
+}
+
+} // namespace
+
+CAROTENE_PERF("FAST nonmax/u8/1280x720", perfFAST);
+CAROTENE_PERF("naive FAST nonmax/u8/1280x720", perfFASTNaive);
+CAROTENE_PERF("FASTGrid nonmax uncapped/u8/1280x720", (perfFASTGrid<64, 0>));
+CAROTENE_PERF("FASTGrid nonmax 64x64 cells top 8/u8/1280x720", (perfFASTGrid<64, 8>));
+CAROTENE_PERF("FASTGrid nonmax 32x32 cells top 2/u8/1280x720", (perfFASTGrid<32, 2>));
@@ -0,0 +1,217 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+#include "perf_common.hpp"
+
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+/*
+    Small neighbourhood filters, edges and area resize over the standard frame sizes. Every
+    case checks the kernel's isXSupported and only leaves a note when it would not run
+*/
+
+namespace {
+
+// Smooth gradients with noise, a natural image as far as the filters care
+std::vector<u8> frame(const Size2D & size)
+{
+    std::vector<u8> v(size.total());
+    for (size_t y = 0; y < size.height; ++y)
+        for (size_t x = 0; x < size.width; ++x)
+            v[y * size.width + x] = (u8)(((x * 3 + y * 5) >> 2) + ((((u32)(y * size.width + x)) * 2654435761u) >> 28));
+    return v;
+}
+
+void setProcessed(perf::State & state, size_t bytesPerPixel)
+{
+    state.setBytesProcessed(state.size().total() * bytesPerPixel);
+    state.setItemsProcessed(state.size().total());
+}
+
+typedef bool (*SupportFunc)(const Size2D &, BORDER_MODE);
+typedef void (*Filter3x3Func)(const Size2D &, const u8 *, ptrdiff_t, u8 *, ptrdiff_t, BORDER_MODE, u8);
+
+template <SupportFunc supported, Filter3x3Func func>
+void perfFilter3x3(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<u8> src = frame(size), dst(size.total());
+    if (!supported(size, BORDER_MODE_REPLICATE))
+    {
+        state.setNote("unsupported");
+        return;
+    }
+    state.run([&]() {
+        func(size, &src[0], size.width, &dst[0], size.width, BORDER_MODE_REPLICATE, 0);
+    });
+    setProcessed(state, 2);
+}
+
+void perfBlur5x5(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<u8> src = frame(size), dst(size.total());
+    if (!isBlurU8Supported(size, 1, BORDER_MODE_REPLICATE))
+    {
+        state.setNote("unsupported");
+        return;
+    }
+    state.run([&]() {
+        blur5x5(size, 1, &src[0], size.width, &dst[0], size.width, BORDER_MODE_REPLICATE, 0);
+    });
+    setProcessed(state, 2);
+}
+
+void perfGaussianBlur5x5(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<u8> src = frame(size), dst(size.total());
+    if (!isGaussianBlur5x5Supported(size, 1, BORDER_MODE_REFLECT101))
+    {
+        state.setNote("unsupported");
+        return;
+    }
+    state.run([&]() {
+        gaussianBlur5x5(size, 1, &src[0], size.width, &dst[0], size.width, BORDER_MODE_REFLECT101, 0, Margin());
+    });
+    setProcessed(state, 2);
+}
+
+void perfLaplacian3OpenCV(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<u8> src = frame(size);
+    std::vector<s16> dst(size.total());
+    if (!isLaplacianOpenCVSupported(size, BORDER_MODE_REFLECT101))
+    {
+        state.setNote("unsupported");
+        return;
+    }
+    state.run([&]() {
+        Laplacian3OpenCV(size, &src[0], size.width, &dst[0], size.width * sizeof(s16), BORDER_MODE_REFLECT101, 0);
+    });
+    setProcessed(state, 3);
+}
+
+template <bool l2>
+void perfCanny(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<u8> src = frame(size), dst(size.total());
+    if (!isCanny3x3Supported(size))
+    {
+        state.setNote("unsupported");
+        return;
+    }
+    state.run([&]() {
+        if (l2)
+            Canny3x3L2(size, &src[0], size.width, &dst[0], size.width, 50.0, 150.0, Margin());
+        else
+            Canny3x3L1(size, &src[0], size.width, &dst[0], size.width, 50.0, 150.0, Margin());
+    });
+    setProcessed(state, 2);
+}
+
+// the generic convolution only takes 3x3 kernels
+void perfConvolution3x3(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<u8> src = frame(size), dst(size.total());
+    const Size2D ksize(3, 3);
+    s16 kernel[9] = { 1, 2, 1, 2, 4, 2, 1, 2, 1 };
+    if (!isConvolutionSupported(size, ksize, BORDER_MODE_REPLICATE))
+    {
+        state.setNote("unsupported");
+        return;
+    }
+    state.run([&]() {
+        convolution(size, &src[0], size.width, &dst[0], size.width, BORDER_MODE_REPLICATE, 0, ksize, kernel, 4);
+    });
+    setProcessed(state, 2);
+}
+
+void perfMedian3x3(perf::State & state)
+{
+    const Size2D & size = state.size();
+    std::vector<u8> src = frame(size), dst(size.total());
+    if (!isMedianFilter3x3Supported(size, 1))
+    {
+        state.setNote("unsupported");
+        return;
+    }
+    state.run([&]() {
+        medianFilter3x3(size, 1, &src[0], size.width, Margin(), &dst[0], size.width);
+    });
+    setProcessed(state, 2);
+}
+
+// Halves the frame, the area resize is the decimation step ahead of detection
+void perfResizeAreaHalf(perf::State & state)
+{
+    const Size2D & size = state.size();
+    const Size2D dsize(size.width / 2, size.height / 2);
+    std::vector<u8> src = frame(size), dst(dsize.total());
+    if (!isResizeAreaSupported(2.0f, 2.0f, 1))
+    {
+        state.setNote("unsupported");
+        return;
+    }
+    state.run([&]() {
+        resizeArea(size, dsize, &src[0], size.width, &dst[0], dsize.width, 2.0f, 2.0f, 1);
+    });
+    state.setBytesProcessed(src.size() + dst.size());
+    state.setItemsProcessed(size.total());
+}
+
+} // namespace
+
+CAROTENE_PERF_SIZES("blur3x3 u8", (perfFilter3x3<isBlur3x3Supported, blur3x3>));
+CAROTENE_PERF_SIZES("blur5x5 u8", perfBlur5x5);
+CAROTENE_PERF_SIZES("gaussianBlur3x3 u8", (perfFilter3x3<isGaussianBlur3x3Supported, gaussianBlur3x3>));
+CAROTENE_PERF_SIZES("gaussianBlur5x5 u8", perfGaussianBlur5x5);
+CAROTENE_PERF_SIZES("Laplacian3x3 u8", (perfFilter3x3<isLaplacian3x3Supported, Laplacian3x3>));
+CAROTENE_PERF_SIZES("Laplacian3OpenCV u8->s16", perfLaplacian3OpenCV);
+CAROTENE_PERF_SIZES("erode3x3 u8", (perfFilter3x3<isMorph3x3Supported, erode3x3>));
+CAROTENE_PERF_SIZES("dilate3x3 u8", (perfFilter3x3<isMorph3x3Supported, dilate3x3>));
+CAROTENE_PERF_SIZES("medianFilter3x3 u8", perfMedian3x3);
+CAROTENE_PERF_SIZES("convolution3x3 u8", perfConvolution3x3);
+CAROTENE_PERF_SIZES("Canny3x3L1", perfCanny<false>);
+CAROTENE_PERF_SIZES("Canny3x3L2", perfCanny<true>);
+CAROTENE_PERF_SIZES("resizeArea u8 1/2", perfResizeAreaHalf);
@@ -0,0 +1,141 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "perf_common.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+namespace {
+
+const Size2D frameSize(1920, 1080);
+
+// Dark frame with large flat areas, long runs of equal pixels are the worst case for a
+// single histogram
+std::vector<u8> frame()
+{
+    std::vector<u8> src(frameSize.width * frameSize.height);
+    for (size_t y = 0; y < frameSize.height; ++y)
+        for (size_t x = 0; x < frameSize.width; ++x)
+        {
+            size_t i = y * frameSize.width + x;
+            src[i] = (u8)(((x / 64 + y / 32) & 7) * 4 + (((i * 2654435761u) >> 28) & 3));
+        }
+    return src;
+}
+
+void perfCalcHist(perf::State & state)
+{
+    std::vector<u8> src = frame();
+    u32 hist[256];
+    state.run([&]() { calcHist(frameSize, &src[0], frameSize.width, hist); });
+    state.setBytesProcessed(src.size());
+    state.setItemsProcessed(src.size());
+}
+
+// Baseline: the single histogram loop of icvGetIntensityHistogram256 in calib3d
+void perfCalcHistNaive(perf::State & state)
+{
+    std::vector<u8> src = frame();
+    u32 hist[256];
+    state.run([&]() {
+        std::fill(hist, hist + 256, 0u);
+        for (size_t y = 0; y < frameSize.height; ++y)
+        {
+            const u8 * row = &src[y * frameSize.width];
+            for (size_t x = 0; x < frameSize.width; ++x)
+                ++hist[row[x]];
+        }
+    });
+    state.setBytesProcessed(src.size());
+    state.setItemsProcessed(src.size());
+}
+
+void perfLut(perf::State & state)
+{
+    std::vector<u8> src = frame(), dst(src.size());
+    u8 table[256];
+    for (size_t i = 0; i < 256; ++i)
+        table[i] = (u8)(255 - i);
+    state.run([&]() { lut(frameSize, &src[0], frameSize.width, &dst[0], frameSize.width, table); });
+    state.setBytesProcessed(src.size());
+    state.setItemsProcessed(src.size());
+}
+
+void perfLutNaive(perf::State & state)
+{
+    std::vector<u8> src = frame(), dst(src.size());
+    u8 table[256];
+    for (size_t i = 0; i < 256; ++i)
+        table[i] = (u8)(255 - i);
+    state.run([&]() {
+        for (size_t i = 0; i < src.size(); ++i)
+            dst[i] = table[src[i]];
+    });
+    state.setBytesProcessed(src.size());
+    state.setItemsProcessed(src.size());
+}
+
+void perfEqualizeHist(perf::State & state)
+{
+    std::vector<u8> src = frame(), dst(src.size());
+    state.run([&]() { equalizeHist(frameSize, &src[0], frameSize.width, &dst[0], frameSize.width); });
+    state.setBytesProcessed(src.size());
+    state.setItemsProcessed(src.size());
+}
+
+// The defaults of cv::createCLAHE
+void perfClahe(perf::State & state)
+{
+    std::vector<u8> src = frame(), dst(src.size());
+    state.run([&]() { clahe(frameSize, &src[0], frameSize.width, &dst[0], frameSize.width, 8, 8, 40.0); });
+    state.setBytesProcessed(src.size());
+    state.setItemsProcessed(src.size());
+}
+
+} // namespace
+
+CAROTENE_PERF("calcHist/u8/1920x1080", perfCalcHist);
+CAROTENE_PERF("naive calcHist/u8/1920x1080", perfCalcHistNaive);
+CAROTENE_PERF("lut/u8/1920x1080", perfLut);
+CAROTENE_PERF("naive lut/u8/1920x1080", perfLutNaive);
+CAROTENE_PERF("equalizeHist/u8/1920x1080", perfEqualizeHist);
+CAROTENE_PERF("clahe 8x8 clip 40/u8/1920x1080", perfClahe);
@@ -0,0 +1,115 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "perf_common.hpp"
+
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+namespace {
+
+// 720p search window, the result shrinks by the template size
+const Size2D size720p(1280, 720);
+
+std::vector<u8> frame(const Size2D & size, size_t seed)
+{
+    std::vector<u8> src(size.width * size.height);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (u8)(((i + seed) * 7 + (i >> 9)) & 0xFF);
+    return src;
+}
+
+template <size_t tmplSide, bool sqdiff, bool normalize>
+void perfMatchTemplate(perf::State & state)
+{
+    const Size2D tmplSize(tmplSide, tmplSide);
+    const Size2D dstSize(size720p.width - tmplSide + 1, size720p.height - tmplSide + 1);
+    std::vector<u8> src = frame(size720p, 0), tmpl = frame(tmplSize, 3);
+    std::vector<f32> dst(dstSize.width * dstSize.height);
+
+    state.run([&]() {
+        if (sqdiff)
+            matchTemplateSqDiff(size720p, &src[0], size720p.width, tmplSize, &tmpl[0], tmplSize.width,
+                                &dst[0], dstSize.width * sizeof(f32), normalize);
+        else
+            matchTemplate(size720p, &src[0], size720p.width, tmplSize, &tmpl[0], tmplSize.width,
+                          &dst[0], dstSize.width * sizeof(f32), normalize);
+    });
+    state.setBytesProcessed(src.size());
+}
+
+// direct per-window sum, what the fiducial tracker did before
+void perfMatchTemplateNaive(perf::State & state)
+{
+    const size_t tmplSide = 16;
+    const Size2D dstSize(size720p.width - tmplSide + 1, size720p.height - tmplSide + 1);
+    std::vector<u8> src = frame(size720p, 0), tmpl = frame(Size2D(tmplSide, tmplSide), 3);
+    std::vector<f32> dst(dstSize.width * dstSize.height);
+
+    state.run([&]() {
+        for (size_t y = 0; y < dstSize.height; ++y)
+            for (size_t x = 0; x < dstSize.width; ++x)
+            {
+                u32 sum = 0;
+                for (size_t ty = 0; ty < tmplSide; ++ty)
+                    for (size_t tx = 0; tx < tmplSide; ++tx)
+                    {
+                        s32 d = (s32)src[(y + ty) * size720p.width + x + tx] - tmpl[ty * tmplSide + tx];
+                        sum += (u32)(d * d);
+                    }
+                dst[y * dstSize.width + x] = (f32)sum;
+            }
+    });
+    state.setBytesProcessed(src.size());
+}
+
+} // namespace
+
+CAROTENE_PERF("matchTemplate/8x8/1280x720", (perfMatchTemplate<8, false, false>));
+CAROTENE_PERF("matchTemplate/16x16/1280x720", (perfMatchTemplate<16, false, false>));
+CAROTENE_PERF("matchTemplate/32x32/1280x720", (perfMatchTemplate<32, false, false>));
+CAROTENE_PERF("matchTemplate/64x64/1280x720", (perfMatchTemplate<64, false, false>));
+CAROTENE_PERF("matchTemplate normed/16x16/1280x720", (perfMatchTemplate<16, false, true>));
+CAROTENE_PERF("matchTemplate normed/32x32/1280x720", (perfMatchTemplate<32, false, true>));
+CAROTENE_PERF("matchTemplateSqDiff/8x8/1280x720", (perfMatchTemplate<8, true, false>));
+CAROTENE_PERF("matchTemplateSqDiff/16x16/1280x720", (perfMatchTemplate<16, true, false>));
+CAROTENE_PERF("matchTemplateSqDiff/32x32/1280x720", (perfMatchTemplate<32, true, false>));
+CAROTENE_PERF("matchTemplateSqDiff normed/32x32/1280x720", (perfMatchTemplate<32, true, true>));
+CAROTENE_PERF("naive matchTemplateSqDiff/16x16/1280x720", perfMatchTemplateNaive);
@@ -0,0 +1,161 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "perf_common.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+namespace {
+
+const Size2D frameSize(1920, 1080);
+const Size2D depthSize(640, 480);
+
+// Noisy gradient, close to the depth and thermal frames the filter cleans up
+template <typename T>
+std::vector<T> frame(const Size2D & size, u32 shift)
+{
+    std::vector<T> src(size.width * size.height);
+    for (size_t y = 0; y < size.height; ++y)
+        for (size_t x = 0; x < size.width; ++x)
+        {
+            size_t i = y * size.width + x;
+            src[i] = (T)((((x + y) << shift) + (((i * 2654435761u) >> 24) << (shift + 1))) >> 1);
+        }
+    return src;
+}
+
+template <int k, typename T>
+void perfMedian(perf::State & state, const Size2D & size, u32 shift)
+{
+    std::vector<T> src = frame<T>(size, shift), dst(src.size());
+    state.run([&]() {
+        if (k == 5)
+            medianFilter5x5(size, 1, &src[0], size.width * sizeof(T), Margin(), &dst[0], size.width * sizeof(T));
+        else
+            medianFilter7x7(size, 1, &src[0], size.width * sizeof(T), Margin(), &dst[0], size.width * sizeof(T));
+    });
+    state.setBytesProcessed(src.size() * sizeof(T));
+    state.setItemsProcessed(src.size());
+}
+
+template <int k> void perfMedianU8(perf::State & state) { perfMedian<k, u8>(state, frameSize, 0); }
+template <int k> void perfMedianU16(perf::State & state) { perfMedian<k, u16>(state, depthSize, 4); }
+
+/*
+    Baseline for u8: Huang's running histogram, what cv::medianBlur falls back to for large
+    apertures. Each step right removes one column from the histogram and adds one, then moves
+    the median from its last position. Borders are left out, which only favours it.
+*/
+template <int k>
+void perfMedianHistogram(perf::State & state)
+{
+    std::vector<u8> src = frame<u8>(frameSize, 0), dst(src.size());
+    const size_t width = frameSize.width, height = frameSize.height, half = k * k / 2;
+    state.run([&]() {
+        for (size_t y = 0; y + k <= height; ++y)
+        {
+            u32 hist[256] = { 0 };
+            for (int dy = 0; dy < k; ++dy)
+                for (int dx = 0; dx < k; ++dx)
+                    ++hist[src[(y + dy) * width + dx]];
+
+            size_t med = 0, below = 0;
+            for (; below + hist[med] <= half; ++med)
+                below += hist[med];
+
+            u8 * d = &dst[(y + k / 2) * width + k / 2];
+            for (size_t x = 0; ; ++x)
+            {
+                d[x] = (u8)med;
+                if (x + k >= width)
+                    break;
+                for (int dy = 0; dy < k; ++dy)
+                {
+                    u8 out = src[(y + dy) * width + x], in = src[(y + dy) * width + x + k];
+                    --hist[out];
+                    ++hist[in];
+                    below -= out < med;
+                    below += in < med;
+                }
+                while (below > half)
+                    below -= hist[--med];
+                while (below + hist[med] <= half)
+                    below += hist[med++];
+            }
+        }
+    });
+    state.setBytesProcessed(src.size());
+    state.setItemsProcessed(src.size());
+}
+
+// Baseline for u16, where OpenCV has no 7x7 path: a partial sort of every window
+template <int k>
+void perfMedianNthElement(perf::State & state)
+{
+    std::vector<u16> src = frame<u16>(depthSize, 4), dst(src.size());
+    const size_t width = depthSize.width, height = depthSize.height;
+    state.run([&]() {
+        u16 window[k * k];
+        for (size_t y = 0; y + k <= height; ++y)
+            for (size_t x = 0; x + k <= width; ++x)
+            {
+                for (int dy = 0; dy < k; ++dy)
+                    for (int dx = 0; dx < k; ++dx)
+                        window[dy * k + dx] = src[(y + dy) * width + x + dx];
+                std::nth_element(window, window + k * k / 2, window + k * k);
+                dst[(y + k / 2) * width + x + k / 2] = window[k * k / 2];
+            }
+    });
+    state.setBytesProcessed(src.size() * sizeof(u16));
+    state.setItemsProcessed(src.size());
+}
+
+} // namespace
+
+CAROTENE_PERF("medianFilter5x5/u8/1920x1080", perfMedianU8<5>);
+CAROTENE_PERF("naive histogram median 5x5/u8/1920x1080", perfMedianHistogram<5>);
+CAROTENE_PERF("medianFilter7x7/u8/1920x1080", perfMedianU8<7>);
+CAROTENE_PERF("naive histogram median 7x7/u8/1920x1080", perfMedianHistogram<7>);
+CAROTENE_PERF("medianFilter5x5/u16/640x480", perfMedianU16<5>);
+CAROTENE_PERF("naive nth_element median 5x5/u16/640x480", perfMedianNthElement<5>);
+CAROTENE_PERF("medianFilter7x7/u16/640x480", perfMedianU16<7>);
+CAROTENE_PERF("naive nth_element median 7x7/u16/640x480", perfMedianNthElement<7>);
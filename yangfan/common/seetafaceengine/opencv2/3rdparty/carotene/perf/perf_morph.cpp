@@ -0,0 +1,139 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "perf_common.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+namespace {
+
+const Size2D frameSize(1920, 1080);
+
+// Binary-ish motion mask, the input morphology runs on in the camera pipeline
+std::vector<u8> mask()
+{
+    std::vector<u8> src(frameSize.width * frameSize.height);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = ((i * 2654435761u) >> 28) < 3 ? 255 : 0;
+    return src;
+}
+
+template <size_t k>
+void perfErode(perf::State & state)
+{
+    std::vector<u8> src = mask(), dst(src.size());
+    const u8 value = 255;
+    state.run([&]() {
+        erode(frameSize, 1, &src[0], frameSize.width, &dst[0], frameSize.width, Size2D(k, k), k / 2, k / 2,
+              BORDER_MODE_CONSTANT, BORDER_MODE_CONSTANT, &value, Margin());
+    });
+    state.setBytesProcessed(src.size());
+}
+
+/*
+    Baseline: separable erosion taking the minimum of all k rows and then all k columns for every
+    pixel, k - 1 operations per element and pass, in plain loops left to the auto-vectorizer.
+    Borders are left out, which only favours it.
+*/
+template <size_t k>
+void perfErodeNaive(perf::State & state)
+{
+    std::vector<u8> src = mask(), dst(src.size()), tmp(frameSize.width);
+    const size_t width = frameSize.width, height = frameSize.height;
+    state.run([&]() {
+        for (size_t y = 0; y + k <= height; ++y)
+        {
+            const u8 * s = &src[y * width];
+            u8 * t = &tmp[0];
+            for (size_t x = 0; x < width; ++x)
+                t[x] = s[x];
+            for (size_t j = 1; j < k; ++j)
+                for (size_t x = 0; x < width; ++x)
+                    t[x] = std::min(t[x], s[j * width + x]);
+
+            u8 * d = &dst[y * width];
+            for (size_t x = 0; x + k <= width; ++x)
+                d[x] = t[x];
+            for (size_t i = 1; i < k; ++i)
+                for (size_t x = 0; x + k <= width; ++x)
+                    d[x] = std::min(d[x], t[x + i]);
+        }
+    });
+    state.setBytesProcessed(src.size());
+}
+
+void perfDilate3x3(perf::State & state)
+{
+    std::vector<u8> src = mask(), dst(src.size());
+    state.run([&]() {
+        dilate3x3(frameSize, &src[0], frameSize.width, &dst[0], frameSize.width, BORDER_MODE_REPLICATE, 0);
+    });
+    state.setBytesProcessed(src.size());
+}
+
+void perfErodeC3(perf::State & state)
+{
+    std::vector<u8> src(frameSize.width * frameSize.height * 3), dst(src.size());
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (u8)((i * 7 + (i >> 9)) & 0xFF);
+    const u8 values[3] = { 255, 255, 255 };
+    state.run([&]() {
+        erode(frameSize, 3, &src[0], frameSize.width * 3, &dst[0], frameSize.width * 3, Size2D(9, 9), 4, 4,
+              BORDER_MODE_CONSTANT, BORDER_MODE_CONSTANT, values, Margin());
+    });
+    state.setBytesProcessed(src.size());
+}
+
+} // namespace
+
+CAROTENE_PERF("dilate3x3/1920x1080", perfDilate3x3);
+CAROTENE_PERF("erode/3x3/1920x1080", perfErode<3>);
+CAROTENE_PERF("erode/5x5/1920x1080", perfErode<5>);
+CAROTENE_PERF("erode/9x9/1920x1080", perfErode<9>);
+CAROTENE_PERF("erode/15x15/1920x1080", perfErode<15>);
+CAROTENE_PERF("erode/21x21/1920x1080", perfErode<21>);
+CAROTENE_PERF("erode/9x9/C3/1920x1080", perfErodeC3);
+CAROTENE_PERF("naive erode/3x3/1920x1080", perfErodeNaive<3>);
+CAROTENE_PERF("naive erode/5x5/1920x1080", perfErodeNaive<5>);
+CAROTENE_PERF("naive erode/9x9/1920x1080", perfErodeNaive<9>);
+CAROTENE_PERF("naive erode/15x15/1920x1080", perfErodeNaive<15>);
+CAROTENE_PERF("naive erode/21x21/1920x1080", perfErodeNaive<21>);
@@ -0,0 +1,192 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "perf_common.hpp"
+
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+namespace {
+
+const Size2D size1080p(1920, 1080), size4K(3840, 2160);
+
+template <typename T>
+std::vector<T> frame(const Size2D & size, size_t cn = 1, size_t seed = 0)
+{
+    std::vector<T> src(size.width * size.height * cn);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (T)((s32)(((i + seed) * 7 + (i >> 9)) & 0xFF) - 64);
+    return src;
+}
+
+const Size2D & frameSize(bool uhd)
+{
+    return uhd ? size4K : size1080p;
+}
+
+template <bool uhd>
+void perfNormL1(perf::State & state)
+{
+    std::vector<u8> src = frame<u8>(frameSize(uhd));
+    volatile s32 result = 0;
+    state.run([&]() { result = normL1(frameSize(uhd), &src[0], frameSize(uhd).width); });
+    (void)result;
+    state.setBytesProcessed(src.size());
+}
+
+template <bool uhd>
+void perfNormL2(perf::State & state)
+{
+    std::vector<u8> src = frame<u8>(frameSize(uhd));
+    volatile s32 result = 0;
+    state.run([&]() { result = normL2(frameSize(uhd), &src[0], frameSize(uhd).width); });
+    (void)result;
+    state.setBytesProcessed(src.size());
+}
+
+void perfNormInf(perf::State & state)
+{
+    std::vector<u8> src = frame<u8>(size1080p);
+    volatile s32 result = 0;
+    state.run([&]() { result = normInf(size1080p, &src[0], size1080p.width); });
+    (void)result;
+    state.setBytesProcessed(src.size());
+}
+
+void perfNormL2s16(perf::State & state)
+{
+    std::vector<s16> src = frame<s16>(size1080p);
+    volatile f64 result = 0;
+    state.run([&]() { result = normL2(size1080p, &src[0], size1080p.width * sizeof(s16)); });
+    (void)result;
+    state.setBytesProcessed(src.size() * sizeof(s16));
+}
+
+void perfNormL2f32(perf::State & state)
+{
+    std::vector<f32> src = frame<f32>(size1080p);
+    volatile f64 result = 0;
+    state.run([&]() { result = normL2(size1080p, &src[0], size1080p.width * sizeof(f32)); });
+    (void)result;
+    state.setBytesProcessed(src.size() * sizeof(f32));
+}
+
+template <bool uhd>
+void perfDiffNormL1(perf::State & state)
+{
+    std::vector<u8> src0 = frame<u8>(frameSize(uhd)), src1 = frame<u8>(frameSize(uhd), 1, 3);
+    volatile s32 result = 0;
+    state.run([&]() {
+        result = diffNormL1(frameSize(uhd), &src0[0], frameSize(uhd).width, &src1[0], frameSize(uhd).width);
+    });
+    (void)result;
+    state.setBytesProcessed(src0.size() * 2);
+}
+
+// Plain loop frame difference, the baseline of the motion detector
+void perfDiffNormL1Naive(perf::State & state)
+{
+    std::vector<u8> src0 = frame<u8>(size1080p), src1 = frame<u8>(size1080p, 1, 3);
+    volatile u64 result = 0;
+    state.run([&]() {
+        u64 acc = 0;
+        for (size_t i = 0; i < src0.size(); ++i)
+            acc += src0[i] > src1[i] ? src0[i] - src1[i] : src1[i] - src0[i];
+        result = acc;
+    });
+    (void)result;
+    state.setBytesProcessed(src0.size() * 2);
+}
+
+void perfDiffNormL2f32(perf::State & state)
+{
+    std::vector<f32> src0 = frame<f32>(size1080p), src1 = frame<f32>(size1080p, 1, 3);
+    volatile f64 result = 0;
+    state.run([&]() {
+        result = diffNormL2(size1080p, &src0[0], size1080p.width * sizeof(f32), &src1[0], size1080p.width * sizeof(f32));
+    });
+    (void)result;
+    state.setBytesProcessed(src0.size() * sizeof(f32) * 2);
+}
+
+template <u32 cn>
+void perfSum(perf::State & state)
+{
+    std::vector<u8> src = frame<u8>(size1080p, cn);
+    u32 sums[4];
+    state.run([&]() { sum(size1080p, &src[0], size1080p.width * cn, sums, cn); });
+    state.setBytesProcessed(src.size());
+}
+
+void perfSumf32(perf::State & state)
+{
+    std::vector<f32> src = frame<f32>(size1080p);
+    f64 sums[1];
+    state.run([&]() { sum(size1080p, &src[0], size1080p.width * sizeof(f32), sums, 1); });
+    state.setBytesProcessed(src.size() * sizeof(f32));
+}
+
+template <u32 cn>
+void perfSqsum(perf::State & state)
+{
+    std::vector<u8> src = frame<u8>(size1080p, cn);
+    f64 sums[4], sqsums[4];
+    state.run([&]() { sqsum(size1080p, &src[0], size1080p.width * cn, sums, sqsums, cn); });
+    state.setBytesProcessed(src.size());
+}
+
+} // namespace
+
+CAROTENE_PERF("normInf/u8/1920x1080", perfNormInf);
+CAROTENE_PERF("normL1/u8/1920x1080", perfNormL1<false>);
+CAROTENE_PERF("normL1/u8/3840x2160", perfNormL1<true>);
+CAROTENE_PERF("normL2/u8/1920x1080", perfNormL2<false>);
+CAROTENE_PERF("normL2/u8/3840x2160", perfNormL2<true>);
+CAROTENE_PERF("normL2/s16/1920x1080", perfNormL2s16);
+CAROTENE_PERF("normL2/f32/1920x1080", perfNormL2f32);
+CAROTENE_PERF("diffNormL1/u8/1920x1080", perfDiffNormL1<false>);
+CAROTENE_PERF("diffNormL1/u8/3840x2160", perfDiffNormL1<true>);
+CAROTENE_PERF("naive diffNormL1/u8/1920x1080", perfDiffNormL1Naive);
+CAROTENE_PERF("diffNormL2/f32/1920x1080", perfDiffNormL2f32);
+CAROTENE_PERF("sum/u8 C1/1920x1080", perfSum<1>);
+CAROTENE_PERF("sum/u8 C3/1920x1080", perfSum<3>);
+CAROTENE_PERF("sum/f32 C1/1920x1080", perfSumf32);
+CAROTENE_PERF("sqsum/u8 C1/1920x1080", perfSqsum<1>);
+CAROTENE_PERF("sqsum/u8 C3/1920x1080", perfSqsum<3>);
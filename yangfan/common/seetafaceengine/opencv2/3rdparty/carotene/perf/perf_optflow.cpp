@@ -0,0 +1,99 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "perf_common.hpp"
+
+#include <cmath>
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+namespace {
+
+/*
+    One level of LK tracking of 500 points between two 640x480 frames shifted by (1.5, -0.75),
+    the usual per-frame load of a feature tracker. Reported as points per millisecond.
+*/
+template <u32 win, bool derivImage>
+void perfLK(perf::State & state)
+{
+    const Size2D size(640, 480), winSize(win, win);
+    const size_t border = win + 2, bw = size.width + 2 * border, bh = size.height + 2 * border;
+    std::vector<u8> prev(bw * bh), next(bw * bh);
+    for (size_t y = 0; y < bh; ++y)
+        for (size_t x = 0; x < bw; ++x)
+        {
+            prev[y * bw + x] = (u8)(128 + 60 * std::sin(x * 0.19) * std::cos(y * 0.23) + 40 * std::sin((x + y) * 0.07));
+            next[y * bw + x] = (u8)(128 + 60 * std::sin((x - 1.5) * 0.19) * std::cos((y + 0.75) * 0.23) +
+                                    40 * std::sin((x + y - 0.75) * 0.07));
+        }
+
+    std::vector<s16> deriv(bw * bh * 2);
+    for (size_t y = 1; y + 1 < bh; ++y)
+        for (size_t x = 1; x + 1 < bw; ++x)
+        {
+            const u8 * p = &prev[y * bw + x];
+            deriv[(y * bw + x) * 2] = (s16)(3 * (p[1 - bw] + p[1 + bw]) + 10 * p[1] - 3 * (p[-1 - bw] + p[-1 + bw]) - 10 * p[-1]);
+            deriv[(y * bw + x) * 2 + 1] = (s16)(3 * (p[bw - 1] + p[bw + 1]) + 10 * p[bw] - 3 * (p[-1 - bw] + p[1 - bw]) - 10 * p[-bw]);
+        }
+
+    const u32 count = 500;
+    std::vector<f32> prevPts(count * 2), nextPts(count * 2), err(count);
+    std::vector<u8> status(count);
+    for (u32 i = 0; i < count; ++i)
+    {
+        prevPts[i * 2] = 20.f + (i * 37 % 600) + 0.25f;
+        prevPts[i * 2 + 1] = 20.f + (i * 53 % 440) + 0.5f;
+    }
+
+    const size_t offset = border * bw + border;
+    state.run([&]() {
+        std::fill(status.begin(), status.end(), 1);
+        pyrLKOptFlowLevel(size, 1, &prev[offset], bw, derivImage ? &deriv[offset * 2] : NULL, bw * 2 * sizeof(s16),
+                          &next[offset], bw, count, &prevPts[0], &nextPts[0], &status[0], &err[0],
+                          winSize, 30, 0.0001, 0, 0, false, false, 1e-4f);
+    });
+    state.setItemsProcessed(count);
+}
+
+} // namespace
+
+CAROTENE_PERF("pyrLKOptFlowLevel/500 points/21x21/deriv image", (perfLK<21, true>));
+CAROTENE_PERF("pyrLKOptFlowLevel/500 points/21x21/window deriv", (perfLK<21, false>));
+CAROTENE_PERF("pyrLKOptFlowLevel/500 points/11x11/deriv image", (perfLK<11, true>));
@@ -0,0 +1,235 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "perf_common.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+/*
+ * Thread scaling of the row stripes the tegra HAL hands to OpenCV's parallel_for_. The pool
+ * below stands in for OpenCV's: its threads live across iterations and take the next free
+ * stripe from a shared counter, and the stripes are cut the same way, about 64K pixels and
+ * at least 16 rows each.
+ */
+
+namespace {
+
+class StripePool
+{
+public:
+    explicit StripePool(size_t threads) : generation(0), pending(0), stop(false)
+    {
+        for (size_t i = 1; i < threads; ++i)
+            workers.push_back(std::thread(&StripePool::work, this));
+    }
+
+    ~StripePool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (size_t i = 0; i < workers.size(); ++i)
+            workers[i].join();
+    }
+
+    // Calls body(start, end) for every stripe of [0, height), the calling thread helps
+    void run(size_t width, size_t height, const std::function<void(size_t, size_t)> & body)
+    {
+        stripes = std::max<size_t>(1, std::min(width * height >> 16, height / 16));
+        rows = height;
+        job = &body;
+        next = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending = workers.size();
+            ++generation;
+        }
+        wake.notify_all();
+        drain();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return pending == 0; });
+    }
+
+private:
+    void drain()
+    {
+        for (size_t s = next++; s < stripes; s = next++)
+            (*job)(rows * s / stripes, rows * (s + 1) / stripes);
+    }
+
+    void work()
+    {
+        size_t seen = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&]() { return stop || generation != seen; });
+                if (stop)
+                    return;
+                seen = generation;
+            }
+            drain();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --pending;
+            }
+            done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    size_t generation, pending;
+    bool stop;
+
+    const std::function<void(size_t, size_t)> * job;
+    size_t stripes, rows;
+    std::atomic<size_t> next;
+};
+
+const Size2D size1080p(1920, 1080);
+
+std::vector<u8> frame(const Size2D & size, size_t cn)
+{
+    std::vector<u8> src(size.width * size.height * cn);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (u8)((i * 7 + (i >> 9)) & 0xFF);
+    return src;
+}
+
+Margin stripeMargin(size_t height, size_t start, size_t end)
+{
+    return Margin(0, 0, start, height - end);
+}
+
+template <size_t threads>
+void perfSobel(perf::State & state)
+{
+    std::vector<u8> src = frame(size1080p, 1);
+    std::vector<s16> dst(src.size());
+    const size_t w = size1080p.width, h = size1080p.height;
+    StripePool pool(threads);
+    std::function<void(size_t, size_t)> body = [&](size_t start, size_t end) {
+        Sobel3x3(Size2D(w, end - start), &src[start * w], w, &dst[start * w], w * sizeof(s16),
+                 1, 0, BORDER_MODE_REFLECT101, 0, stripeMargin(h, start, end));
+    };
+    state.run([&]() { pool.run(w, h, body); });
+    state.setBytesProcessed(src.size());
+}
+
+template <size_t threads>
+void perfErode(perf::State & state)
+{
+    std::vector<u8> src = frame(size1080p, 1), dst(src.size());
+    const size_t w = size1080p.width, h = size1080p.height;
+    const u8 borderValue = 255;
+    StripePool pool(threads);
+    std::function<void(size_t, size_t)> body = [&](size_t start, size_t end) {
+        erode(Size2D(w, end - start), 1, &src[start * w], w, &dst[start * w], w, Size2D(5, 5), 2, 2,
+              BORDER_MODE_CONSTANT, BORDER_MODE_CONSTANT, &borderValue, stripeMargin(h, start, end));
+    };
+    state.run([&]() { pool.run(w, h, body); });
+    state.setBytesProcessed(src.size());
+}
+
+template <size_t threads>
+void perfGaussian(perf::State & state)
+{
+    std::vector<u8> src = frame(size1080p, 3), dst(src.size());
+    const size_t w = size1080p.width, h = size1080p.height, stride = w * 3;
+    StripePool pool(threads);
+    std::function<void(size_t, size_t)> body = [&](size_t start, size_t end) {
+        gaussianBlur5x5(Size2D(w, end - start), 3, &src[start * stride], stride, &dst[start * stride], stride,
+                        BORDER_MODE_REFLECT101, 0, stripeMargin(h, start, end));
+    };
+    state.run([&]() { pool.run(w * 3, h, body); });
+    state.setBytesProcessed(src.size());
+}
+
+template <size_t threads>
+void perfThreshold(perf::State & state)
+{
+    std::vector<u8> src = frame(size1080p, 1), dst(src.size());
+    const size_t w = size1080p.width, h = size1080p.height;
+    StripePool pool(threads);
+    std::function<void(size_t, size_t)> body = [&](size_t start, size_t end) {
+        thresholdBinary(Size2D(w, end - start), &src[start * w], w, &dst[start * w], w, (u8)100, (u8)255, (u8)0);
+    };
+    state.run([&]() { pool.run(w, h, body); });
+    state.setBytesProcessed(src.size());
+}
+
+} // namespace
+
+CAROTENE_PERF("stripes Sobel3x3 dx/1 thread/1920x1080", perfSobel<1>);
+CAROTENE_PERF("stripes Sobel3x3 dx/2 threads/1920x1080", perfSobel<2>);
+CAROTENE_PERF("stripes Sobel3x3 dx/3 threads/1920x1080", perfSobel<3>);
+CAROTENE_PERF("stripes Sobel3x3 dx/4 threads/1920x1080", perfSobel<4>);
+CAROTENE_PERF("stripes Sobel3x3 dx/5 threads/1920x1080", perfSobel<5>);
+CAROTENE_PERF("stripes Sobel3x3 dx/6 threads/1920x1080", perfSobel<6>);
+CAROTENE_PERF("stripes erode 5x5/1 thread/1920x1080", perfErode<1>);
+CAROTENE_PERF("stripes erode 5x5/2 threads/1920x1080", perfErode<2>);
+CAROTENE_PERF("stripes erode 5x5/3 threads/1920x1080", perfErode<3>);
+CAROTENE_PERF("stripes erode 5x5/4 threads/1920x1080", perfErode<4>);
+CAROTENE_PERF("stripes erode 5x5/5 threads/1920x1080", perfErode<5>);
+CAROTENE_PERF("stripes erode 5x5/6 threads/1920x1080", perfErode<6>);
+CAROTENE_PERF("stripes gaussianBlur5x5 C3/1 thread/1920x1080", perfGaussian<1>);
+CAROTENE_PERF("stripes gaussianBlur5x5 C3/2 threads/1920x1080", perfGaussian<2>);
+CAROTENE_PERF("stripes gaussianBlur5x5 C3/3 threads/1920x1080", perfGaussian<3>);
+CAROTENE_PERF("stripes gaussianBlur5x5 C3/4 threads/1920x1080", perfGaussian<4>);
+CAROTENE_PERF("stripes gaussianBlur5x5 C3/5 threads/1920x1080", perfGaussian<5>);
+CAROTENE_PERF("stripes gaussianBlur5x5 C3/6 threads/1920x1080", perfGaussian<6>);
+CAROTENE_PERF("stripes thresholdBinary/1 thread/1920x1080", perfThreshold<1>);
+CAROTENE_PERF("stripes thresholdBinary/2 threads/1920x1080", perfThreshold<2>);
+CAROTENE_PERF("stripes thresholdBinary/3 threads/1920x1080", perfThreshold<3>);
+CAROTENE_PERF("stripes thresholdBinary/4 threads/1920x1080", perfThreshold<4>);
+CAROTENE_PERF("stripes thresholdBinary/5 threads/1920x1080", perfThreshold<5>);
+CAROTENE_PERF("stripes thresholdBinary/6 threads/1920x1080", perfThreshold<6>);
@@ -0,0 +1,126 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "perf_common.hpp"
+
+#include <cmath>
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+namespace {
+
+const Size2D frameSize(1280, 720);
+
+// Gradients of a smooth pattern, what a Sobel pass hands to an orientation histogram
+template <typename T>
+void gradients(std::vector<T> & dx, std::vector<T> & dy)
+{
+    dx.resize(frameSize.total());
+    dy.resize(frameSize.total());
+    for (size_t i = 0; i < frameSize.height; ++i)
+        for (size_t j = 0; j < frameSize.width; ++j)
+        {
+            dx[i * frameSize.width + j] = (T)(400 * std::cos(j * 0.05 + i * 0.01));
+            dy[i * frameSize.width + j] = (T)(400 * std::sin(i * 0.03 - j * 0.02));
+        }
+}
+
+void perfPhase(perf::State & state)
+{
+    std::vector<f32> dx, dy, angle(frameSize.total());
+    gradients(dx, dy);
+    const ptrdiff_t stride = frameSize.width * sizeof(f32);
+    state.run([&]() { phase(frameSize, &dx[0], stride, &dy[0], stride, &angle[0], stride, 1.0f); });
+    state.setBytesProcessed(frameSize.total() * 3 * sizeof(f32));
+    state.setItemsProcessed(frameSize.total());
+}
+
+// Baseline: the C library
+void perfPhaseNaive(perf::State & state)
+{
+    std::vector<f32> dx, dy, angle(frameSize.total());
+    gradients(dx, dy);
+    state.run([&]() {
+        for (size_t i = 0; i < angle.size(); ++i)
+        {
+            f32 a = std::atan2(dy[i], dx[i]) * (f32)(180.0 / M_PI);
+            angle[i] = a < 0 ? a + 360.f : a;
+        }
+    });
+    state.setBytesProcessed(frameSize.total() * 3 * sizeof(f32));
+    state.setItemsProcessed(frameSize.total());
+}
+
+template <typename T>
+void perfMagnitudePhase(perf::State & state)
+{
+    std::vector<T> dx, dy;
+    std::vector<f32> mag(frameSize.total()), angle(frameSize.total());
+    gradients(dx, dy);
+    state.run([&]() {
+        magnitudePhase(frameSize, &dx[0], frameSize.width * sizeof(T), &dy[0], frameSize.width * sizeof(T),
+                       &mag[0], frameSize.width * sizeof(f32), &angle[0], frameSize.width * sizeof(f32), 1.0f);
+    });
+    state.setBytesProcessed(frameSize.total() * 2 * (sizeof(T) + sizeof(f32)));
+    state.setItemsProcessed(frameSize.total());
+}
+
+// Baseline for the fused kernel: phase, then the magnitude in a second pass over the inputs
+void perfMagnitudeThenPhase(perf::State & state)
+{
+    std::vector<f32> dx, dy, mag(frameSize.total()), angle(frameSize.total());
+    gradients(dx, dy);
+    const ptrdiff_t stride = frameSize.width * sizeof(f32);
+    state.run([&]() {
+        for (size_t i = 0; i < mag.size(); ++i)
+            mag[i] = std::sqrt(dx[i] * dx[i] + dy[i] * dy[i]);
+        phase(frameSize, &dx[0], stride, &dy[0], stride, &angle[0], stride, 1.0f);
+    });
+    state.setBytesProcessed(frameSize.total() * 4 * sizeof(f32));
+    state.setItemsProcessed(frameSize.total());
+}
+
+} // namespace
+
+CAROTENE_PERF("phase/f32/1280x720", perfPhase);
+CAROTENE_PERF("naive atan2/f32/1280x720", perfPhaseNaive);
+CAROTENE_PERF("magnitudePhase/f32/1280x720", perfMagnitudePhase<f32>);
+CAROTENE_PERF("magnitudePhase/s16/1280x720", perfMagnitudePhase<s16>);
+CAROTENE_PERF("sqrt loop + phase/f32/1280x720", perfMagnitudeThenPhase);
@@ -0,0 +1,132 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+#include "perf_common.hpp"
+
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+/*
+    Network input preparation end to end, the ms column is the time per frame. The two pass
+    variants are what the inference path ran before the fused kernels: decode to an
+    interleaved frame, then split and normalize it in a second pass over the whole frame
+*/
+
+namespace {
+
+const Size2D size1080p(1920, 1080);
+const f32 mean[3] = { 123.675f, 116.28f, 103.53f }, stdDev[3] = { 58.395f, 57.12f, 57.375f };
+
+std::vector<u8> nv21Frame()
+{
+    std::vector<u8> src(size1080p.width * size1080p.height * 3 / 2);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (u8)(i * 7 + (i >> 9));
+    return src;
+}
+
+void perfNV21PlanarTwoPass(perf::State & state)
+{
+    const size_t w = size1080p.width, h = size1080p.height;
+    std::vector<u8> src = nv21Frame(), rgb(w * h * 3), planes(w * h * 3);
+    std::vector<f32> dst(w * h * 3);
+    f32 scale[3], bias[3];
+    for (size_t c = 0; c < 3; ++c)
+    {
+        scale[c] = 1.0f / stdDev[c];
+        bias[c] = -mean[c] * scale[c];
+    }
+    state.run([&]() {
+        yuv420sp2rgb(size1080p, COLOR_SPACE_BT601, YUV_RANGE_LIMITED, &src[0], w, &src[w * h], w, &rgb[0], w * 3);
+        split3(size1080p, &rgb[0], w * 3, &planes[0], w, &planes[w * h], w, &planes[2 * w * h], w);
+        for (size_t c = 0; c < 3; ++c)
+            for (size_t i = 0; i < w * h; ++i)
+                dst[c * w * h + i] = planes[c * w * h + i] * scale[c] + bias[c];
+    });
+    state.setBytesProcessed(src.size() + dst.size() * sizeof(f32));
+    state.setItemsProcessed(w * h);
+}
+
+void perfNV21PlanarFused(perf::State & state)
+{
+    const size_t w = size1080p.width, h = size1080p.height;
+    std::vector<u8> src = nv21Frame();
+    std::vector<f32> dst(w * h * 3);
+    const ptrdiff_t stride = w * sizeof(f32);
+    state.run([&]() {
+        yuv420sp2rgbPlanarF32(size1080p, COLOR_SPACE_BT601, YUV_RANGE_LIMITED, &src[0], w, &src[w * h], w,
+                              &dst[0], stride, &dst[w * h], stride, &dst[2 * w * h], stride, mean, stdDev);
+    });
+    state.setBytesProcessed(src.size() + dst.size() * sizeof(f32));
+    state.setItemsProcessed(w * h);
+}
+
+// split4 to four planes with the fourth one thrown away
+void perfRGBXPlanarSplit4(perf::State & state)
+{
+    const size_t w = size1080p.width, h = size1080p.height;
+    std::vector<u8> src(w * h * 4), dst(w * h * 4);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (u8)(i * 13 + (i >> 11));
+    state.run([&]() {
+        split4(size1080p, &src[0], w * 4, &dst[0], w, &dst[w * h], w, &dst[2 * w * h], w, &dst[3 * w * h], w);
+    });
+    state.setBytesProcessed(src.size() + w * h * 3);
+    state.setItemsProcessed(w * h);
+}
+
+void perfRGBXPlanar(perf::State & state)
+{
+    const size_t w = size1080p.width, h = size1080p.height;
+    std::vector<u8> src(w * h * 4), dst(w * h * 3);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (u8)(i * 13 + (i >> 11));
+    state.run([&]() {
+        rgbx2planar(size1080p, &src[0], w * 4, &dst[0], w, &dst[w * h], w, &dst[2 * w * h], w);
+    });
+    state.setBytesProcessed(src.size() + dst.size());
+    state.setItemsProcessed(w * h);
+}
+
+} // namespace
+
+CAROTENE_PERF("preprocess nv21->planar f32/two pass/1920x1080", perfNV21PlanarTwoPass);
+CAROTENE_PERF("preprocess nv21->planar f32/fused/1920x1080", perfNV21PlanarFused);
+CAROTENE_PERF("preprocess rgbx->planar u8/split4/1920x1080", perfRGBXPlanarSplit4);
+CAROTENE_PERF("preprocess rgbx->planar u8/rgbx2planar/1920x1080", perfRGBXPlanar);
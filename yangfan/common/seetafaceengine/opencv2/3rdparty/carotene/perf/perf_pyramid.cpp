@@ -0,0 +1,92 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "perf_common.hpp"
+
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+namespace {
+
+// Five levels below a 1080p frame, 1920x1080 -> 60x34, as built for multi-scale detection and LK
+template <typename T, u8 cn>
+void perfPyramid5(perf::State & state)
+{
+    const size_t levels = 5;
+    std::vector<Size2D> sizes(1, Size2D(1920, 1080));
+    for (size_t l = 0; l < levels; ++l)
+        sizes.push_back(Size2D((sizes[l].width + 1) / 2, (sizes[l].height + 1) / 2));
+
+    std::vector<std::vector<T> > images(levels + 1);
+    for (size_t l = 0; l <= levels; ++l)
+        images[l].resize(sizes[l].width * sizes[l].height * cn);
+    for (size_t i = 0; i < images[0].size(); ++i)
+        images[0][i] = (T)((i * 7 + (i >> 9)) & 0xFF);
+
+    state.run([&]() {
+        for (size_t l = 0; l < levels; ++l)
+            gaussianPyramidDown(sizes[l], &images[l][0], sizes[l].width * cn * sizeof(T),
+                                sizes[l + 1], &images[l + 1][0], sizes[l + 1].width * cn * sizeof(T), cn);
+    });
+    state.setBytesProcessed(images[0].size() * sizeof(T));
+}
+
+template <typename T>
+void perfPyramidUp(perf::State & state)
+{
+    Size2D ssize(960, 540), dsize(1920, 1080);
+    std::vector<T> src(ssize.width * ssize.height), dst(dsize.width * dsize.height);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (T)((i * 7 + (i >> 9)) & 0xFF);
+
+    state.run([&]() {
+        gaussianPyramidUp(ssize, &src[0], ssize.width * sizeof(T), dsize, &dst[0], dsize.width * sizeof(T), 1);
+    });
+    state.setBytesProcessed(dst.size() * sizeof(T));
+}
+
+} // namespace
+
+CAROTENE_PERF("gaussianPyramidDown/5 levels/u8 C1/1920x1080", (perfPyramid5<u8, 1>));
+CAROTENE_PERF("gaussianPyramidDown/5 levels/u8 C3/1920x1080", (perfPyramid5<u8, 3>));
+CAROTENE_PERF("gaussianPyramidDown/5 levels/s16 C1/1920x1080", (perfPyramid5<s16, 1>));
+CAROTENE_PERF("gaussianPyramidDown/5 levels/f32 C1/1920x1080", (perfPyramid5<f32, 1>));
+CAROTENE_PERF("gaussianPyramidUp/u8 C1/960x540->1920x1080", perfPyramidUp<u8>);
+CAROTENE_PERF("gaussianPyramidUp/s16 C1/960x540->1920x1080", perfPyramidUp<s16>);
@@ -0,0 +1,101 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "perf_common.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+namespace {
+
+const Size2D frameSize(1920, 1080);
+
+template <typename T>
+std::vector<T> frame()
+{
+    std::vector<T> src(frameSize.total());
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (T)((i * 2654435761u) >> 24);
+    return src;
+}
+
+void perfReduceColSumU8(perf::State & state)
+{
+    std::vector<u8> src = frame<u8>();
+    std::vector<s32> dst(frameSize.width);
+    state.run([&]() { reduceColSum(frameSize, &src[0], frameSize.width, &dst[0]); });
+    state.setBytesProcessed(src.size());
+}
+
+// Baseline: s32 running sums, one row at a time
+void perfReduceColSumU8Naive(perf::State & state)
+{
+    std::vector<u8> src = frame<u8>();
+    std::vector<s32> dst(frameSize.width);
+    state.run([&]() {
+        std::fill(dst.begin(), dst.end(), 0);
+        for (size_t i = 0; i < frameSize.height; ++i)
+            for (size_t j = 0; j < frameSize.width; ++j)
+                dst[j] += src[i * frameSize.width + j];
+    });
+    state.setBytesProcessed(src.size());
+}
+
+void perfReduceColMaxU8(perf::State & state)
+{
+    std::vector<u8> src = frame<u8>(), dst(frameSize.width);
+    state.run([&]() { reduceColMax(frameSize, &src[0], frameSize.width, &dst[0]); });
+    state.setBytesProcessed(src.size());
+}
+
+void perfReduceColSumF32(perf::State & state)
+{
+    std::vector<f32> src = frame<f32>(), dst(frameSize.width);
+    state.run([&]() { reduceColSum(frameSize, &src[0], frameSize.width * sizeof(f32), &dst[0]); });
+    state.setBytesProcessed(src.size() * sizeof(f32));
+}
+
+} // namespace
+
+CAROTENE_PERF("reduceColSum/u8/1920x1080", perfReduceColSumU8);
+CAROTENE_PERF("naive reduceColSum/u8/1920x1080", perfReduceColSumU8Naive);
+CAROTENE_PERF("reduceColMax/u8/1920x1080", perfReduceColMaxU8);
+CAROTENE_PERF("reduceColSum/f32/1920x1080", perfReduceColSumF32);
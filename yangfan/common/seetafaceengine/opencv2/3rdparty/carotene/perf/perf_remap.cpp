@@ -0,0 +1,116 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "perf_common.hpp"
+
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+namespace {
+
+enum MapKind
+{
+    MAP_FLOAT,
+    MAP_FIXED
+};
+
+// Full frame 1080p undistortion, the reported ms is per frame
+template <MapKind kind, bool linear>
+void perfUndistort(perf::State & state)
+{
+    const size_t w = 1920, h = 1080;
+    std::vector<u8> src(w * h), dst(w * h);
+    std::vector<f32> table(w * h * 2);
+    std::vector<s16> xy(w * h * 2);
+    std::vector<u16> alpha(w * h);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (u8)(i * 7 + (i >> 9));
+
+    f64 cx = w / 2.0, cy = h / 2.0, f = w * 0.8;
+    for (size_t y = 0; y < h; ++y)
+        for (size_t x = 0; x < w; ++x)
+        {
+            f64 u = (x - cx) / f, v = (y - cy) / f, r2 = u * u + v * v;
+            f64 k = 1 - 0.25 * r2 + 0.05 * r2 * r2;
+            table[(y * w + x) * 2] = (f32)(cx + u * k * f);
+            table[(y * w + x) * 2 + 1] = (f32)(cy + v * k * f);
+        }
+    // once per calibration, outside of the measured loop
+    remapConvertMaps(Size2D(w, h), &table[0], w * 2 * sizeof(f32), &xy[0], w * 2 * sizeof(s16),
+                     linear ? &alpha[0] : NULL, w * sizeof(u16));
+
+    Size2D size(w, h);
+    state.run([&]() {
+        if (kind == MAP_FLOAT && linear)
+            remapLinear(size, size, &src[0], w, &table[0], w * 2 * sizeof(f32), &dst[0], w, BORDER_MODE_CONSTANT, 0);
+        else if (kind == MAP_FLOAT)
+            remapNearestNeighbor(size, size, &src[0], w, &table[0], w * 2 * sizeof(f32), &dst[0], w, BORDER_MODE_CONSTANT, 0);
+        else if (linear)
+            remapLinear(size, size, &src[0], w, &xy[0], w * 2 * sizeof(s16), &alpha[0], w * sizeof(u16),
+                        &dst[0], w, BORDER_MODE_CONSTANT, 0);
+        else
+            remapNearestNeighbor(size, size, &src[0], w, &xy[0], w * 2 * sizeof(s16), &dst[0], w, BORDER_MODE_CONSTANT, 0);
+    });
+    state.setBytesProcessed(dst.size());
+}
+
+void perfConvertMaps(perf::State & state)
+{
+    const size_t w = 1920, h = 1080;
+    std::vector<f32> table(w * h * 2);
+    std::vector<s16> xy(w * h * 2);
+    std::vector<u16> alpha(w * h);
+    for (size_t i = 0; i < table.size(); ++i)
+        table[i] = (f32)(i % 1900) + 0.3f;
+
+    state.run([&]() {
+        remapConvertMaps(Size2D(w, h), &table[0], w * 2 * sizeof(f32), &xy[0], w * 2 * sizeof(s16),
+                         &alpha[0], w * sizeof(u16));
+    });
+    state.setBytesProcessed(table.size() * sizeof(f32));
+}
+
+} // namespace
+
+CAROTENE_PERF("remapNearestNeighbor/undistort/f32 map/1920x1080", (perfUndistort<MAP_FLOAT, false>));
+CAROTENE_PERF("remapNearestNeighbor/undistort/s16 map/1920x1080", (perfUndistort<MAP_FIXED, false>));
+CAROTENE_PERF("remapLinear/undistort/f32 map/1920x1080", (perfUndistort<MAP_FLOAT, true>));
+CAROTENE_PERF("remapLinear/undistort/s16 + u16 maps/1920x1080", (perfUndistort<MAP_FIXED, true>));
+CAROTENE_PERF("remapConvertMaps/1920x1080", perfConvertMaps);
@@ -0,0 +1,101 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "perf_common.hpp"
+
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+namespace {
+
+enum ResizeKind
+{
+    RESIZE_NEAREST,
+    RESIZE_AREA,
+    RESIZE_LINEAR_OPENCV,
+    RESIZE_LINEAR
+};
+
+// Camera preview downscales of a 1080p frame
+template <ResizeKind kind, u32 cn, size_t dw, size_t dh>
+void perfResize(perf::State & state)
+{
+    const size_t sw = 1920, sh = 1080;
+    std::vector<u8> src(sw * sh * cn), dst(dw * dh * cn);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (u8)(i * 7 + (i >> 9));
+
+    Size2D ssize(sw, sh), dsize(dw, dh);
+    f32 wr = (f32)sw / dw, hr = (f32)sh / dh;
+    state.run([&]() {
+        switch (kind)
+        {
+        case RESIZE_NEAREST:
+            resizeNearestNeighbor(ssize, dsize, &src[0], sw * cn, &dst[0], dw * cn, wr, hr, cn);
+            break;
+        case RESIZE_AREA:
+            resizeAreaOpenCV(ssize, dsize, &src[0], sw * cn, &dst[0], dw * cn, wr, hr, cn);
+            break;
+        case RESIZE_LINEAR_OPENCV:
+            resizeLinearOpenCV(ssize, dsize, &src[0], sw * cn, &dst[0], dw * cn, wr, hr, cn);
+            break;
+        case RESIZE_LINEAR:
+            resizeLinear(ssize, dsize, &src[0], sw * cn, &dst[0], dw * cn, wr, hr, cn);
+            break;
+        }
+    });
+    state.setBytesProcessed(src.size());
+}
+
+} // namespace
+
+CAROTENE_PERF("resizeNearestNeighbor/C1/1920x1080->960x540", (perfResize<RESIZE_NEAREST, 1, 960, 540>));
+CAROTENE_PERF("resizeNearestNeighbor/C4/1920x1080->1280x720", (perfResize<RESIZE_NEAREST, 4, 1280, 720>));
+CAROTENE_PERF("resizeNearestNeighbor/C4/1920x1080->480x270", (perfResize<RESIZE_NEAREST, 4, 480, 270>));
+CAROTENE_PERF("resizeAreaOpenCV/C1/1920x1080->960x540", (perfResize<RESIZE_AREA, 1, 960, 540>));
+CAROTENE_PERF("resizeAreaOpenCV/C3/1920x1080->960x540", (perfResize<RESIZE_AREA, 3, 960, 540>));
+CAROTENE_PERF("resizeAreaOpenCV/C4/1920x1080->480x270", (perfResize<RESIZE_AREA, 4, 480, 270>));
+CAROTENE_PERF("resizeLinearOpenCV/C1/1920x1080->1280x720", (perfResize<RESIZE_LINEAR_OPENCV, 1, 1280, 720>));
+CAROTENE_PERF("resizeLinearOpenCV/C3/1920x1080->1280x720", (perfResize<RESIZE_LINEAR_OPENCV, 3, 1280, 720>));
+CAROTENE_PERF("resizeLinearOpenCV/C4/1920x1080->960x540", (perfResize<RESIZE_LINEAR_OPENCV, 4, 960, 540>));
+CAROTENE_PERF("resizeLinearOpenCV/C4/1920x1080->640x360", (perfResize<RESIZE_LINEAR_OPENCV, 4, 640, 360>));
+CAROTENE_PERF("resizeLinear/C1/1920x1080->1280x720", (perfResize<RESIZE_LINEAR, 1, 1280, 720>));
+CAROTENE_PERF("resizeLinear/C4/1920x1080->960x540", (perfResize<RESIZE_LINEAR, 4, 960, 540>));
+CAROTENE_PERF("resizeLinear/C4/1920x1080->640x360", (perfResize<RESIZE_LINEAR, 4, 640, 360>));
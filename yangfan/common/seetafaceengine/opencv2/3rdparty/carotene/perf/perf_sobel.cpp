@@ -0,0 +1,159 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "perf_common.hpp"
+
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+namespace {
+
+const Size2D frameSize(1920, 1080);
+
+std::vector<u8> frame(size_t cn = 1)
+{
+    std::vector<u8> src(frameSize.width * frameSize.height * cn);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (u8)((i * 7 + (i >> 9)) & 0xFF);
+    return src;
+}
+
+template <s32 dx, s32 dy>
+void perfSobel(perf::State & state)
+{
+    std::vector<u8> src = frame();
+    std::vector<s16> dst(src.size());
+    state.run([&]() {
+        Sobel3x3(frameSize, &src[0], frameSize.width, &dst[0], frameSize.width * sizeof(s16),
+                 dx, dy, BORDER_MODE_REFLECT101, 0);
+    });
+    state.setBytesProcessed(src.size());
+}
+
+// Both gradients as two separate passes, the baseline of the fused variants
+void perfSobelTwoPass(perf::State & state)
+{
+    std::vector<u8> src = frame();
+    std::vector<s16> dx(src.size()), dy(src.size());
+    state.run([&]() {
+        Sobel3x3(frameSize, &src[0], frameSize.width, &dx[0], frameSize.width * sizeof(s16),
+                 1, 0, BORDER_MODE_REFLECT101, 0);
+        Sobel3x3(frameSize, &src[0], frameSize.width, &dy[0], frameSize.width * sizeof(s16),
+                 0, 1, BORDER_MODE_REFLECT101, 0);
+    });
+    state.setBytesProcessed(src.size());
+}
+
+template <bool scharr>
+void perfDxDy(perf::State & state)
+{
+    std::vector<u8> src = frame();
+    std::vector<s16> dst(src.size() * 2);
+    state.run([&]() {
+        if (scharr)
+            Scharr3x3dXdY(frameSize, &src[0], frameSize.width, &dst[0], frameSize.width * 2 * sizeof(s16),
+                          BORDER_MODE_REFLECT101, 0);
+        else
+            Sobel3x3dXdY(frameSize, &src[0], frameSize.width, &dst[0], frameSize.width * 2 * sizeof(s16),
+                         BORDER_MODE_REFLECT101, 0);
+    });
+    state.setBytesProcessed(src.size());
+}
+
+void perfScharr(perf::State & state)
+{
+    std::vector<u8> src = frame();
+    std::vector<s16> dst(src.size());
+    state.run([&]() {
+        Scharr3x3(frameSize, &src[0], frameSize.width, &dst[0], frameSize.width * sizeof(s16),
+                  1, 0, BORDER_MODE_REFLECT101, 0);
+    });
+    state.setBytesProcessed(src.size());
+}
+
+void perfScharrDeriv(perf::State & state)
+{
+    std::vector<u8> src = frame();
+    std::vector<s16> dst(src.size() * 2);
+    state.run([&]() {
+        ScharrDeriv(frameSize, 1, &src[0], frameSize.width, &dst[0], frameSize.width * 2 * sizeof(s16));
+    });
+    state.setBytesProcessed(src.size());
+}
+
+template <bool large>
+void perfSeparable(perf::State & state)
+{
+    // the large kernel no longer fits s16 intermediates and takes the s32 path
+    const s16 small[3] = { 1, 4, 1 }, big[3] = { -300, 1000, 200 };
+    std::vector<u8> src = frame();
+    std::vector<s16> dst(src.size());
+    state.run([&]() {
+        SeparableFilter3x3(frameSize, &src[0], frameSize.width, &dst[0], frameSize.width * sizeof(s16),
+                           3, 3, large ? big : small, small, BORDER_MODE_REFLECT101, 0);
+    });
+    state.setBytesProcessed(src.size());
+}
+
+void perfSobelF32(perf::State & state)
+{
+    std::vector<f32> src(frameSize.width * frameSize.height), dst(src.size());
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (f32)((i * 7 + (i >> 9)) & 0xFF);
+    state.run([&]() {
+        Sobel3x3(frameSize, &src[0], frameSize.width * sizeof(f32), &dst[0], frameSize.width * sizeof(f32),
+                 1, 0, BORDER_MODE_REPLICATE, 0.f);
+    });
+    state.setBytesProcessed(src.size() * sizeof(f32));
+}
+
+} // namespace
+
+CAROTENE_PERF("Sobel3x3/dx/u8->s16/1920x1080", (perfSobel<1, 0>));
+CAROTENE_PERF("Sobel3x3/dy/u8->s16/1920x1080", (perfSobel<0, 1>));
+CAROTENE_PERF("Sobel3x3/dxx/u8->s16/1920x1080", (perfSobel<2, 0>));
+CAROTENE_PERF("Sobel3x3/dx+dy two passes/u8->s16/1920x1080", perfSobelTwoPass);
+CAROTENE_PERF("Sobel3x3dXdY/u8->s16x2/1920x1080", perfDxDy<false>);
+CAROTENE_PERF("Scharr3x3/dx/u8->s16/1920x1080", perfScharr);
+CAROTENE_PERF("Scharr3x3dXdY/u8->s16x2/1920x1080", perfDxDy<true>);
+CAROTENE_PERF("ScharrDeriv/C1/1920x1080", perfScharrDeriv);
+CAROTENE_PERF("SeparableFilter3x3/custom s16/1920x1080", perfSeparable<false>);
+CAROTENE_PERF("SeparableFilter3x3/custom s32/1920x1080", perfSeparable<true>);
+CAROTENE_PERF("Sobel3x3/dx/f32/1920x1080", perfSobelF32);
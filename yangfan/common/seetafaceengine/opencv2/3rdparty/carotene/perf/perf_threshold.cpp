@@ -0,0 +1,134 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "perf_common.hpp"
+
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+namespace {
+
+const Size2D frameSize(1920, 1080);
+
+template <typename T>
+std::vector<T> frame()
+{
+    std::vector<T> src(frameSize.width * frameSize.height);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (T)((s32)((i * 7 + (i >> 9)) & 0xFF) - 64);
+    return src;
+}
+
+template <typename T>
+void perfBinary(perf::State & state)
+{
+    void (*binary)(const Size2D &, const T *, ptrdiff_t, T *, ptrdiff_t, T, T) = thresholdBinary;
+    std::vector<T> src = frame<T>(), dst(src.size());
+    state.run([&]() {
+        binary(frameSize, &src[0], frameSize.width * sizeof(T), &dst[0], frameSize.width * sizeof(T),
+               (T)100, (T)120);
+    });
+    state.setBytesProcessed(src.size() * sizeof(T));
+}
+
+template <typename T>
+void perfTruncate(perf::State & state)
+{
+    std::vector<T> src = frame<T>(), dst(src.size());
+    state.run([&]() {
+        thresholdTruncate(frameSize, &src[0], frameSize.width * sizeof(T), &dst[0], frameSize.width * sizeof(T),
+                          (T)100);
+    });
+    state.setBytesProcessed(src.size() * sizeof(T));
+}
+
+template <typename T>
+void perfToZero(perf::State & state)
+{
+    std::vector<T> src = frame<T>(), dst(src.size());
+    state.run([&]() {
+        thresholdToZero(frameSize, &src[0], frameSize.width * sizeof(T), &dst[0], frameSize.width * sizeof(T),
+                        (T)100);
+    });
+    state.setBytesProcessed(src.size() * sizeof(T));
+}
+
+void perfRange(perf::State & state)
+{
+    std::vector<u8> src = frame<u8>(), dst(src.size());
+    state.run([&]() {
+        thresholdRange(frameSize, &src[0], frameSize.width, &dst[0], frameSize.width, 50, 150);
+    });
+    state.setBytesProcessed(src.size());
+}
+
+template <typename T>
+void perfCmpGT(perf::State & state)
+{
+    std::vector<T> src0 = frame<T>(), src1(src0.rbegin(), src0.rend());
+    std::vector<u8> dst(src0.size());
+    state.run([&]() {
+        cmpGT(frameSize, &src0[0], frameSize.width * sizeof(T), &src1[0], frameSize.width * sizeof(T),
+              &dst[0], frameSize.width);
+    });
+    state.setBytesProcessed(src0.size() * sizeof(T) * 2);
+}
+
+} // namespace
+
+CAROTENE_PERF("thresholdBinary/u8/1920x1080", perfBinary<u8>);
+CAROTENE_PERF("thresholdBinary/s8/1920x1080", perfBinary<s8>);
+CAROTENE_PERF("thresholdBinary/u16/1920x1080", perfBinary<u16>);
+CAROTENE_PERF("thresholdBinary/s16/1920x1080", perfBinary<s16>);
+CAROTENE_PERF("thresholdBinary/s32/1920x1080", perfBinary<s32>);
+CAROTENE_PERF("thresholdBinary/f32/1920x1080", perfBinary<f32>);
+CAROTENE_PERF("thresholdTruncate/u8/1920x1080", perfTruncate<u8>);
+CAROTENE_PERF("thresholdTruncate/s16/1920x1080", perfTruncate<s16>);
+CAROTENE_PERF("thresholdTruncate/f32/1920x1080", perfTruncate<f32>);
+CAROTENE_PERF("thresholdToZero/u8/1920x1080", perfToZero<u8>);
+CAROTENE_PERF("thresholdToZero/s16/1920x1080", perfToZero<s16>);
+CAROTENE_PERF("thresholdToZero/f32/1920x1080", perfToZero<f32>);
+CAROTENE_PERF("thresholdRange/u8/1920x1080", perfRange);
+CAROTENE_PERF("cmpGT/u8/1920x1080", perfCmpGT<u8>);
+CAROTENE_PERF("cmpGT/s8/1920x1080", perfCmpGT<s8>);
+CAROTENE_PERF("cmpGT/u16/1920x1080", perfCmpGT<u16>);
+CAROTENE_PERF("cmpGT/s16/1920x1080", perfCmpGT<s16>);
+CAROTENE_PERF("cmpGT/s32/1920x1080", perfCmpGT<s32>);
+CAROTENE_PERF("cmpGT/f32/1920x1080", perfCmpGT<f32>);
@@ -0,0 +1,84 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "perf_common.hpp"
+
+#include <cmath>
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+namespace {
+
+// Grayscale 1080p source; the reported MB/s of a u8 destination is megapixels per second
+template <bool perspective, bool linear, size_t dw, size_t dh>
+void perfWarp(perf::State & state)
+{
+    const size_t sw = 1920, sh = 1080;
+    std::vector<u8> src(sw * sh), dst(dw * dh);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (u8)(i * 7 + (i >> 9));
+
+    // face alignment style similarity (rotate + scale into a crop), or a document rectification homography
+    f32 c = (f32)(std::cos(0.3) * 1.5), s = (f32)(std::sin(0.3) * 1.5);
+    f32 affine[6] = { c, s, -s, c, 800.0f, 300.0f };
+    f32 homography[9] = { 0.9f, 0.05f, 0.0001f, -0.08f, 0.95f, 0.00005f, 40.0f, 20.0f, 1.0f };
+
+    Size2D ssize(sw, sh), dsize(dw, dh);
+    state.run([&]() {
+        if (perspective && linear)
+            warpPerspectiveLinear(ssize, dsize, &src[0], sw, homography, &dst[0], dw, BORDER_MODE_CONSTANT, 0);
+        else if (perspective)
+            warpPerspectiveNearestNeighbor(ssize, dsize, &src[0], sw, homography, &dst[0], dw, BORDER_MODE_CONSTANT, 0);
+        else if (linear)
+            warpAffineLinear(ssize, dsize, &src[0], sw, affine, &dst[0], dw, BORDER_MODE_REPLICATE, 0);
+        else
+            warpAffineNearestNeighbor(ssize, dsize, &src[0], sw, affine, &dst[0], dw, BORDER_MODE_REPLICATE, 0);
+    });
+    state.setBytesProcessed(dst.size());
+}
+
+} // namespace
+
+CAROTENE_PERF("warpAffineNearestNeighbor/1920x1080->256x256", (perfWarp<false, false, 256, 256>));
+CAROTENE_PERF("warpAffineLinear/1920x1080->256x256", (perfWarp<false, true, 256, 256>));
+CAROTENE_PERF("warpAffineNearestNeighbor/1920x1080->1920x1080", (perfWarp<false, false, 1920, 1080>));
+CAROTENE_PERF("warpAffineLinear/1920x1080->1920x1080", (perfWarp<false, true, 1920, 1080>));
+CAROTENE_PERF("warpPerspectiveNearestNeighbor/1920x1080->1920x1080", (perfWarp<true, false, 1920, 1080>));
+CAROTENE_PERF("warpPerspectiveLinear/1920x1080->1920x1080", (perfWarp<true, true, 1920, 1080>));
@@ -0,0 +1,150 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "perf_common.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace CAROTENE_NS;
+
+namespace {
+
+const Size2D size1080p(1920, 1080);
+
+std::vector<u8> yuv422Frame()
+{
+    std::vector<u8> src(size1080p.width * size1080p.height * 2);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = (u8)(i * 7 + (i >> 9));
+    return src;
+}
+
+typedef void (*YUV422Func)(const Size2D &, COLOR_SPACE, YUV_RANGE, const u8 *, ptrdiff_t, u8 *, ptrdiff_t);
+
+template <YUV422Func func, size_t dcn, COLOR_SPACE space, YUV_RANGE range>
+void perfYUV422(perf::State & state)
+{
+    std::vector<u8> src = yuv422Frame();
+    std::vector<u8> dst(size1080p.width * size1080p.height * dcn);
+    state.run([&]() {
+        func(size1080p, space, range, &src[0], size1080p.width * 2, &dst[0], size1080p.width * dcn);
+    });
+    state.setBytesProcessed(src.size() + dst.size());
+    state.setItemsProcessed(size1080p.width * size1080p.height);
+}
+
+// OpenCV's scalar YUY2 -> BGR loop, what cvtColor runs without the HAL
+void perfYUV422Naive(perf::State & state)
+{
+    std::vector<u8> src = yuv422Frame();
+    std::vector<u8> dst(size1080p.width * size1080p.height * 3);
+    const s32 CY = 1220542, CUB = 2116026, CUG = -409993, CVG = -852492, CVR = 1673527, SHIFT = 20;
+    state.run([&]() {
+        for (size_t y = 0; y < size1080p.height; ++y)
+        {
+            const u8 * s = &src[y * size1080p.width * 2];
+            u8 * d = &dst[y * size1080p.width * 3];
+            for (size_t x = 0; x < size1080p.width; x += 2, s += 4, d += 6)
+            {
+                s32 u = s[1] - 128, v = s[3] - 128;
+                s32 ruv = (1 << (SHIFT - 1)) + CVR * v;
+                s32 guv = (1 << (SHIFT - 1)) + CVG * v + CUG * u;
+                s32 buv = (1 << (SHIFT - 1)) + CUB * u;
+                for (int k = 0; k < 2; ++k)
+                {
+                    s32 yy = std::max(0, s[2 * k] - 16) * CY;
+                    d[3 * k + 2] = (u8)std::min(std::max((yy + ruv) >> SHIFT, 0), 255);
+                    d[3 * k + 1] = (u8)std::min(std::max((yy + guv) >> SHIFT, 0), 255);
+                    d[3 * k + 0] = (u8)std::min(std::max((yy + buv) >> SHIFT, 0), 255);
+                }
+            }
+        }
+    });
+    state.setBytesProcessed(src.size() + dst.size());
+    state.setItemsProcessed(size1080p.width * size1080p.height);
+}
+
+typedef void (*YUV420Func)(const Size2D &, COLOR_SPACE, YUV_RANGE,
+                           const u8 *, ptrdiff_t, const u8 *, ptrdiff_t, u8 *, ptrdiff_t);
+
+template <YUV420Func func, size_t dcn, COLOR_SPACE space, YUV_RANGE range>
+void perfYUV420(perf::State & state)
+{
+    std::vector<u8> src = yuv422Frame();
+    std::vector<u8> dst(size1080p.width * size1080p.height * dcn);
+    const u8 * uv = &src[size1080p.width * size1080p.height];
+    state.run([&]() {
+        func(size1080p, space, range, &src[0], size1080p.width, uv, size1080p.width, &dst[0], size1080p.width * dcn);
+    });
+    state.setBytesProcessed(size1080p.width * size1080p.height * 3 / 2 + dst.size());
+    state.setItemsProcessed(size1080p.width * size1080p.height);
+}
+
+// the fixed BT.601 decoder with 16 bit approximate arithmetic
+void perfYUV420Legacy(perf::State & state)
+{
+    std::vector<u8> src = yuv422Frame();
+    std::vector<u8> dst(size1080p.width * size1080p.height * 3);
+    const u8 * uv = &src[size1080p.width * size1080p.height];
+    state.run([&]() {
+        yuv420sp2rgb(size1080p, &src[0], size1080p.width, uv, size1080p.width, &dst[0], size1080p.width * 3);
+    });
+    state.setBytesProcessed(size1080p.width * size1080p.height * 3 / 2 + dst.size());
+    state.setItemsProcessed(size1080p.width * size1080p.height);
+}
+
+} // namespace
+
+CAROTENE_PERF("yuyv2bgr/BT601 limited/1920x1080", (perfYUV422<yuyv2bgr, 3, COLOR_SPACE_BT601, YUV_RANGE_LIMITED>));
+CAROTENE_PERF("naive yuyv2bgr/BT601 limited/1920x1080", perfYUV422Naive);
+CAROTENE_PERF("yuyv2bgrx/BT601 limited/1920x1080", (perfYUV422<yuyv2bgrx, 4, COLOR_SPACE_BT601, YUV_RANGE_LIMITED>));
+CAROTENE_PERF("yuyv2rgb/BT709 limited/1920x1080", (perfYUV422<yuyv2rgb, 3, COLOR_SPACE_BT709, YUV_RANGE_LIMITED>));
+CAROTENE_PERF("yuyv2rgb/BT709 full/1920x1080", (perfYUV422<yuyv2rgb, 3, COLOR_SPACE_BT709, YUV_RANGE_FULL>));
+CAROTENE_PERF("uyvy2bgr/BT601 limited/1920x1080", (perfYUV422<uyvy2bgr, 3, COLOR_SPACE_BT601, YUV_RANGE_LIMITED>));
+CAROTENE_PERF("uyvy2rgbx/BT601 full/1920x1080", (perfYUV422<uyvy2rgbx, 4, COLOR_SPACE_BT601, YUV_RANGE_FULL>));
+CAROTENE_PERF("legacy yuv420sp2rgb/1920x1080", perfYUV420Legacy);
+CAROTENE_PERF("yuv420sp2rgb/BT601 limited/1920x1080", (perfYUV420<yuv420sp2rgb, 3, COLOR_SPACE_BT601, YUV_RANGE_LIMITED>));
+CAROTENE_PERF("yuv420sp2rgb/BT601 full/1920x1080", (perfYUV420<yuv420sp2rgb, 3, COLOR_SPACE_BT601, YUV_RANGE_FULL>));
+CAROTENE_PERF("yuv420sp2rgb/BT709 limited/1920x1080", (perfYUV420<yuv420sp2rgb, 3, COLOR_SPACE_BT709, YUV_RANGE_LIMITED>));
+CAROTENE_PERF("yuv420sp2rgb/BT709 full/1920x1080", (perfYUV420<yuv420sp2rgb, 3, COLOR_SPACE_BT709, YUV_RANGE_FULL>));
+CAROTENE_PERF("yuv420sp2rgb/BT2020 limited/1920x1080", (perfYUV420<yuv420sp2rgb, 3, COLOR_SPACE_BT2020, YUV_RANGE_LIMITED>));
+CAROTENE_PERF("yuv420sp2rgb/BT2020 full/1920x1080", (perfYUV420<yuv420sp2rgb, 3, COLOR_SPACE_BT2020, YUV_RANGE_FULL>));
+CAROTENE_PERF("yuv420i2bgrx/BT709 limited/1920x1080", (perfYUV420<yuv420i2bgrx, 4, COLOR_SPACE_BT709, YUV_RANGE_LIMITED>));
+CAROTENE_PERF("yuv420i2rgb/BT2020 limited/1920x1080", (perfYUV420<yuv420i2rgb, 3, COLOR_SPACE_BT2020, YUV_RANGE_LIMITED>));
@@ -97,7 +97,7 @@ void blur3x3(const Size2D &size,
                 ptrdiff_t x4 = border == BORDER_MODE_CONSTANT ? x3 - 1 : std::max<ptrdiff_t>(x3 - 1, 0);
 
                 if (border == BORDER_MODE_CONSTANT && x4 < 0)
-                    prevx = borderValue;
+                    prevx = borderValue * 3;
                 else
                     prevx = (srow2 ? srow2[x4] : borderValue) + srow1[x4] + (srow0 ? srow0[x4] : borderValue);
 
@@ -188,6 +188,29 @@ bool isBlurU8Supported(const Size2D &size, s32 cn, BORDER_MODE border)
             border == BORDER_MODE_REPLICATE);
 }
 
+#ifdef CAROTENE_NEON
+namespace {
+
+// Vertical sum of element x of a row with colsn elements, x may lie one pixel outside the row
+inline s16 blurColumnSum(const u8 * srow0, const u8 * srow1, const u8 * srow2,
+                         ptrdiff_t x, ptrdiff_t colsn, s32 cn,
+                         BORDER_MODE borderType, u8 borderValue)
+{
+    if (x < 0 || x >= colsn)
+    {
+        if (borderType == BORDER_MODE_CONSTANT)
+            return borderValue * 3;
+        if (borderType == BORDER_MODE_REFLECT101)
+            x = x < 0 ? x + 2 * cn : x - 2 * cn;
+        else // BORDER_MODE_REFLECT || BORDER_MODE_REPLICATE
+            x = x < 0 ? x + cn : x - cn;
+    }
+    return srow0[x] + srow1[x] + srow2[x];
+}
+
+} // namespace
+#endif
+
 void blur3x3(const Size2D &size, s32 cn,
              const u8 * srcBase, ptrdiff_t srcStride,
              u8 * dstBase, ptrdiff_t dstStride,
@@ -209,7 +232,8 @@ void blur3x3(const Size2D &size, s32 cn,
     u8 *tmp = 0;
     if (borderType == BORDER_MODE_CONSTANT)
     {
-        _tmp.assign(colsn + 2*cn, borderValue);
+        // the vector loop reads up to 8 elements past the row end
+        _tmp.assign(colsn + 2*cn + 8, borderValue);
         tmp = &_tmp[cn];
     }
 
@@ -259,7 +283,7 @@ void blur3x3(const Size2D &size, s32 cn,
                     // make border
                         if (borderType == BORDER_MODE_CONSTANT)
                         {
-                            tcurr = vsetq_lane_u16(borderValue, tcurr, 7);
+                            tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 7);
                         }
                         else if (borderType == BORDER_MODE_REFLECT101)
                         {
@@ -298,25 +322,13 @@ void blur3x3(const Size2D &size, s32 cn,
             if(x == colsn){
                 x--;
             }
+            // narrow rows leave the whole last rows to this loop, starting at the left border
             s16 prevx, rowx, nextx;
-            prevx = srow2[x-1] + srow1[x-1] + srow0[x-1];
+            prevx = blurColumnSum(srow0, srow1, srow2, (ptrdiff_t)x - 1, colsn, 1, borderType, borderValue);
             rowx = srow2[x] + srow1[x] + srow0[x];
             for( ; x < colsn; x++ )
             {
-                if(x+1 >= colsn) {
-                    // make border
-                    if (borderType == BORDER_MODE_CONSTANT)
-                    {
-                        nextx = borderValue;
-                    } else if (borderType == BORDER_MODE_REFLECT101)
-                    {
-                        nextx = srow2[x-1] + srow1[x-1] + srow0[x-1];
-                    } else {
-                        nextx = srow2[x] + srow1[x] + srow0[x];
-                    }
-                } else {
-                    nextx = srow2[x+1] + srow1[x+1] + srow0[x+1];
-                }
+                nextx = blurColumnSum(srow0, srow1, srow2, (ptrdiff_t)x + 1, colsn, 1, borderType, borderValue);
                 *(drow+x) = internal::saturate_cast<u8>((prevx + rowx + nextx)*(1/9.));
                 prevx = rowx;
                 rowx = nextx;
@@ -368,13 +380,13 @@ void blur3x3(const Size2D &size, s32 cn,
                     case 2:
                         if (borderType == BORDER_MODE_CONSTANT)
                         {
-                            tcurr = vsetq_lane_u16(borderValue, tcurr, 6);
-                            tcurr = vsetq_lane_u16(borderValue, tcurr, 7);
+                            tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 6);
+                            tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 7);
                         }
                         else if (borderType == BORDER_MODE_REFLECT101)
                         {
                             tcurr = vsetq_lane_u16(vgetq_lane_u16(tcurr, 2),tcurr, 6);
-                            tcurr = vsetq_lane_u16(vgetq_lane_u16(tcurr, 3),tcurr, 6);
+                            tcurr = vsetq_lane_u16(vgetq_lane_u16(tcurr, 3),tcurr, 7);
                         }
                         else
                         {
@@ -385,15 +397,16 @@ void blur3x3(const Size2D &size, s32 cn,
                     case 3:
                         if (borderType == BORDER_MODE_CONSTANT)
                         {
-                            tcurr = vsetq_lane_u16(borderValue, tcurr, 5);
-                            tcurr = vsetq_lane_u16(borderValue, tcurr, 6);
-                            tcurr = vsetq_lane_u16(borderValue, tcurr, 7);
+                            tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 5);
+                            tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 6);
+                            tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 7);
                         }
                         else if (borderType == BORDER_MODE_REFLECT101)
                         {
-                            tcurr = vsetq_lane_u16(vgetq_lane_u16(tcurr, 3),tcurr, 5);
-                            tcurr = vsetq_lane_u16(vgetq_lane_u16(tcurr, 4),tcurr, 6);
+                            // lane 5 is both a source and a destination, fill from the top
                             tcurr = vsetq_lane_u16(vgetq_lane_u16(tcurr, 5),tcurr, 7);
+                            tcurr = vsetq_lane_u16(vgetq_lane_u16(tcurr, 4),tcurr, 6);
+                            tcurr = vsetq_lane_u16(vgetq_lane_u16(tcurr, 3),tcurr, 5);
                         }
                         else
                         {
@@ -405,10 +418,10 @@ void blur3x3(const Size2D &size, s32 cn,
                     case 4:
                         if (borderType == BORDER_MODE_CONSTANT)
                         {
-                            tcurr = vsetq_lane_u16(borderValue, tcurr, 4);
-                            tcurr = vsetq_lane_u16(borderValue, tcurr, 5);
-                            tcurr = vsetq_lane_u16(borderValue, tcurr, 6);
-                            tcurr = vsetq_lane_u16(borderValue, tcurr, 7);
+                            tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 4);
+                            tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 5);
+                            tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 6);
+                            tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 7);
                         }
                         else if (borderType != BORDER_MODE_REFLECT101)
                         {
@@ -457,32 +470,22 @@ void blur3x3(const Size2D &size, s32 cn,
             }
 
             x -= 8;
-            if(x == colsn){
-                x -= cn;
+            // the last block took its right neighbours from past the row end
+            if(x + cn > colsn){
+                x = colsn - cn;
             }
             s16 prevx[4], rowx[4], nextx[4];
             for( s32 k = 0; k < cn; k++ )
             {
-                prevx[(k + x%cn)%cn] = srow2[x+k-cn] + srow1[x+k-cn] + srow0[x+k-cn];
+                prevx[(k + x%cn)%cn] = blurColumnSum(srow0, srow1, srow2, (ptrdiff_t)(x + k) - cn, colsn, cn,
+                                                     borderType, borderValue);
                 rowx[(k + x%cn)%cn] = srow2[x+k] + srow1[x+k] + srow0[x+k];
             }
             for( ; x < colsn; x++ )
             {
                 size_t xx = x%cn;
-                if(x+cn >= colsn) {
-                    // make border
-                    if (borderType == BORDER_MODE_CONSTANT)
-                    {
-                        nextx[xx] = borderValue;
-                    } else if (borderType == BORDER_MODE_REFLECT101)
-                    {
-                        nextx[xx] = srow2[x-cn] + srow1[x-cn] + srow0[x-cn];
-                    } else {
-                        nextx[xx] = srow2[x] + srow1[x] + srow0[x];
-                    }
-                } else {
-                    nextx[xx] = srow2[x+cn] + srow1[x+cn] + srow0[x+cn];
-                }
+                nextx[xx] = blurColumnSum(srow0, srow1, srow2, (ptrdiff_t)(x + cn), colsn, cn,
+                                          borderType, borderValue);
                 *(drow+x) = internal::saturate_cast<u8>((prevx[xx] + rowx[xx] + nextx[xx])*(1/9.));
                 prevx[xx] = rowx[xx];
                 rowx[xx] = nextx[xx];
@@ -590,8 +593,8 @@ void blur5x5(const Size2D &size, s32 cn,
                 case 1:
                     if (borderType == BORDER_MODE_CONSTANT)
                     {
-                        tcurr = vsetq_lane_u16(borderValue, tcurr, 6);
-                        tcurr = vsetq_lane_u16(borderValue, tcurr, 7);
+                        tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 6);
+                        tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 7);
                     }
                     else if (borderType == BORDER_MODE_REFLECT101)
                     {
@@ -612,10 +615,10 @@ void blur5x5(const Size2D &size, s32 cn,
                 case 2:
                     if (borderType == BORDER_MODE_CONSTANT)
                     {
-                        tcurr = vsetq_lane_u16(borderValue, tcurr, 4);
-                        tcurr = vsetq_lane_u16(borderValue, tcurr, 5);
-                        tcurr = vsetq_lane_u16(borderValue, tcurr, 6);
-                        tcurr = vsetq_lane_u16(borderValue, tcurr, 7);
+                        tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 4);
+                        tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 5);
+                        tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 6);
+                        tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 7);
                     }
                     else if (borderType == BORDER_MODE_REFLECT101)
                     {
@@ -642,10 +645,10 @@ void blur5x5(const Size2D &size, s32 cn,
                     {
                         tcurr = vsetq_lane_u16(borderValue, tcurr, 2);
                         tcurr = vsetq_lane_u16(borderValue, tcurr, 3);
-                        tcurr = vsetq_lane_u16(borderValue, tcurr, 4);
-                        tcurr = vsetq_lane_u16(borderValue, tcurr, 5);
-                        tcurr = vsetq_lane_u16(borderValue, tcurr, 6);
-                        tcurr = vsetq_lane_u16(borderValue, tcurr, 7);
+                        tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 4);
+                        tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 5);
+                        tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 6);
+                        tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 7);
                     }
                     else if (borderType == BORDER_MODE_REFLECT101)
                     {
@@ -683,10 +686,10 @@ void blur5x5(const Size2D &size, s32 cn,
                         tcurr = vsetq_lane_u16(borderValue, tcurr, 1);
                         tcurr = vsetq_lane_u16(borderValue, tcurr, 2);
                         tcurr = vsetq_lane_u16(borderValue, tcurr, 3);
-                        tcurr = vsetq_lane_u16(borderValue, tcurr, 4);
-                        tcurr = vsetq_lane_u16(borderValue, tcurr, 5);
-                        tcurr = vsetq_lane_u16(borderValue, tcurr, 6);
-                        tcurr = vsetq_lane_u16(borderValue, tcurr, 7);
+                        tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 4);
+                        tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 5);
+                        tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 6);
+                        tcurr = vsetq_lane_u16(borderValue * 3, tcurr, 7);
                     }
                     else if (borderType == BORDER_MODE_REFLECT101)
                     {
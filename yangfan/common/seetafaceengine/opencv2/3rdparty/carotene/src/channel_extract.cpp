@@ -483,4 +483,72 @@ SPLIT64(s, 4)
 
 SPLIT4ALPHA(u,8)
 
+void rgbx2planar(const Size2D &_size,
+                 const u8 * srcBase, ptrdiff_t srcStride,
+                 u8 * dst0Base, ptrdiff_t dst0Stride,
+                 u8 * dst1Base, ptrdiff_t dst1Stride,
+                 u8 * dst2Base, ptrdiff_t dst2Stride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    Size2D size(_size);
+    if (srcStride == (ptrdiff_t)(size.width * 4) &&
+        dst0Stride == (ptrdiff_t)(size.width) &&
+        dst1Stride == (ptrdiff_t)(size.width) &&
+        dst2Stride == (ptrdiff_t)(size.width))
+    {
+        size.width *= size.height;
+        size.height = 1;
+    }
+    size_t roiw16 = size.width >= 15 ? size.width - 15 : 0;
+    size_t roiw8 = size.width >= 7 ? size.width - 7 : 0;
+
+    for (size_t i = 0u; i < size.height; ++i)
+    {
+        const u8 * src = internal::getRowPtr(srcBase, srcStride, i);
+        u8 * dst0 = internal::getRowPtr(dst0Base, dst0Stride, i);
+        u8 * dst1 = internal::getRowPtr(dst1Base, dst1Stride, i);
+        u8 * dst2 = internal::getRowPtr(dst2Base, dst2Stride, i);
+        size_t sj = 0u, dj = 0u;
+
+        // the fourth channel is loaded with the rest and dropped
+        for (; dj < roiw16; sj += 64, dj += 16)
+        {
+            internal::prefetch(src + sj);
+            uint8x16x4_t v_src = vld4q_u8(src + sj);
+            vst1q_u8(dst0 + dj, v_src.val[0]);
+            vst1q_u8(dst1 + dj, v_src.val[1]);
+            vst1q_u8(dst2 + dj, v_src.val[2]);
+        }
+
+        if (dj < roiw8)
+        {
+            uint8x8x4_t v_src = vld4_u8(src + sj);
+            vst1_u8(dst0 + dj, v_src.val[0]);
+            vst1_u8(dst1 + dj, v_src.val[1]);
+            vst1_u8(dst2 + dj, v_src.val[2]);
+            sj += 32;
+            dj += 8;
+        }
+
+        for (; dj < size.width; sj += 4, ++dj)
+        {
+            dst0[dj] = src[sj + 0];
+            dst1[dj] = src[sj + 1];
+            dst2[dj] = src[sj + 2];
+        }
+    }
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+    (void)dst0Base;
+    (void)dst0Stride;
+    (void)dst1Base;
+    (void)dst1Stride;
+    (void)dst2Base;
+    (void)dst2Stride;
+#endif
+}
+
 } // namespace CAROTENE_NS
@@ -386,4 +386,76 @@ void combineUYVY(const Size2D &size,
 #endif
 }
 
+void combine4(const Size2D &_size,
+              const u8 * src3Base, ptrdiff_t src3Stride,
+              const u8 * src1Base, ptrdiff_t src1Stride,
+              u8 * dstBase, ptrdiff_t dstStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    Size2D size(_size);
+    if (src3Stride == (ptrdiff_t)(size.width * 3) &&
+        src1Stride == (ptrdiff_t)(size.width) &&
+        dstStride == (ptrdiff_t)(size.width * 4))
+    {
+        size.width *= size.height;
+        size.height = 1;
+    }
+    size_t roiw16 = size.width >= 15 ? size.width - 15 : 0;
+    size_t roiw8 = size.width >= 7 ? size.width - 7 : 0;
+
+    for (size_t i = 0u; i < size.height; ++i)
+    {
+        const u8 * src3 = internal::getRowPtr(src3Base, src3Stride, i);
+        const u8 * src1 = internal::getRowPtr(src1Base, src1Stride, i);
+        u8 * dst = internal::getRowPtr(dstBase, dstStride, i);
+        size_t s3j = 0u, sj = 0u, dj = 0u;
+
+        for (; sj < roiw16; s3j += 48, sj += 16, dj += 64)
+        {
+            internal::prefetch(src3 + s3j);
+            internal::prefetch(src1 + sj);
+
+            uint8x16x3_t v_src3 = vld3q_u8(src3 + s3j);
+            uint8x16x4_t v_dst;
+            v_dst.val[0] = v_src3.val[0];
+            v_dst.val[1] = v_src3.val[1];
+            v_dst.val[2] = v_src3.val[2];
+            v_dst.val[3] = vld1q_u8(src1 + sj);
+            vst4q_u8(dst + dj, v_dst);
+        }
+
+        if (sj < roiw8)
+        {
+            uint8x8x3_t v_src3 = vld3_u8(src3 + s3j);
+            uint8x8x4_t v_dst;
+            v_dst.val[0] = v_src3.val[0];
+            v_dst.val[1] = v_src3.val[1];
+            v_dst.val[2] = v_src3.val[2];
+            v_dst.val[3] = vld1_u8(src1 + sj);
+            vst4_u8(dst + dj, v_dst);
+            s3j += 24;
+            sj += 8;
+            dj += 32;
+        }
+
+        for (; sj < size.width; s3j += 3, ++sj, dj += 4)
+        {
+            dst[dj + 0] = src3[s3j + 0];
+            dst[dj + 1] = src3[s3j + 1];
+            dst[dj + 2] = src3[s3j + 2];
+            dst[dj + 3] = src1[sj];
+        }
+    }
+#else
+    (void)_size;
+    (void)src3Base;
+    (void)src3Stride;
+    (void)src1Base;
+    (void)src1Stride;
+    (void)dstBase;
+    (void)dstStride;
+#endif
+}
+
 } // namespace CAROTENE_NS
@@ -59,6 +59,10 @@ enum
     R2Y_BT709   = 3483,
     G2Y_BT709   = 11718,
     B2Y_BT709   = 1183,
+
+    R2Y_BT2020  = 4304,
+    G2Y_BT2020  = 11108,
+    B2Y_BT2020  = 972,
 };
 
 inline uint8x8_t convertToGray(const uint16x8_t & v_r,
@@ -93,9 +97,12 @@ void rgb2gray(const Size2D &size, COLOR_SPACE color_space,
 {
     internal::assertSupportedConfiguration();
 #ifdef CAROTENE_NEON
-    const u32 R2Y = color_space == COLOR_SPACE_BT601 ? R2Y_BT601 : R2Y_BT709;
-    const u32 G2Y = color_space == COLOR_SPACE_BT601 ? G2Y_BT601 : G2Y_BT709;
-    const u32 B2Y = color_space == COLOR_SPACE_BT601 ? B2Y_BT601 : B2Y_BT709;
+    const u32 R2Y = color_space == COLOR_SPACE_BT601 ? R2Y_BT601 :
+                      color_space == COLOR_SPACE_BT709 ? R2Y_BT709 : R2Y_BT2020;
+    const u32 G2Y = color_space == COLOR_SPACE_BT601 ? G2Y_BT601 :
+                      color_space == COLOR_SPACE_BT709 ? G2Y_BT709 : G2Y_BT2020;
+    const u32 B2Y = color_space == COLOR_SPACE_BT601 ? B2Y_BT601 :
+                      color_space == COLOR_SPACE_BT709 ? B2Y_BT709 : B2Y_BT2020;
 
 #if !defined(__aarch64__) && defined(__GNUC__) && __GNUC__ == 4 &&  __GNUC_MINOR__ < 7 && !defined(__clang__)
     register int16x4_t v_r2y asm ("d31") = vmov_n_s16(R2Y);
@@ -194,9 +201,12 @@ void rgbx2gray(const Size2D &size, COLOR_SPACE color_space,
 {
     internal::assertSupportedConfiguration();
 #ifdef CAROTENE_NEON
-    const u32 R2Y = color_space == COLOR_SPACE_BT601 ? R2Y_BT601 : R2Y_BT709;
-    const u32 G2Y = color_space == COLOR_SPACE_BT601 ? G2Y_BT601 : G2Y_BT709;
-    const u32 B2Y = color_space == COLOR_SPACE_BT601 ? B2Y_BT601 : B2Y_BT709;
+    const u32 R2Y = color_space == COLOR_SPACE_BT601 ? R2Y_BT601 :
+                      color_space == COLOR_SPACE_BT709 ? R2Y_BT709 : R2Y_BT2020;
+    const u32 G2Y = color_space == COLOR_SPACE_BT601 ? G2Y_BT601 :
+                      color_space == COLOR_SPACE_BT709 ? G2Y_BT709 : G2Y_BT2020;
+    const u32 B2Y = color_space == COLOR_SPACE_BT601 ? B2Y_BT601 :
+                      color_space == COLOR_SPACE_BT709 ? B2Y_BT709 : B2Y_BT2020;
 
 #if !defined(__aarch64__) && defined(__GNUC__) && __GNUC__ == 4 &&  __GNUC_MINOR__ < 7 && !defined(__clang__)
     register int16x4_t v_r2y asm ("d31") = vmov_n_s16(R2Y);
@@ -296,9 +306,12 @@ void bgr2gray(const Size2D &size, COLOR_SPACE color_space,
 {
     internal::assertSupportedConfiguration();
 #ifdef CAROTENE_NEON
-    const u32 R2Y = color_space == COLOR_SPACE_BT601 ? R2Y_BT601 : R2Y_BT709;
-    const u32 G2Y = color_space == COLOR_SPACE_BT601 ? G2Y_BT601 : G2Y_BT709;
-    const u32 B2Y = color_space == COLOR_SPACE_BT601 ? B2Y_BT601 : B2Y_BT709;
+    const u32 R2Y = color_space == COLOR_SPACE_BT601 ? R2Y_BT601 :
+                      color_space == COLOR_SPACE_BT709 ? R2Y_BT709 : R2Y_BT2020;
+    const u32 G2Y = color_space == COLOR_SPACE_BT601 ? G2Y_BT601 :
+                      color_space == COLOR_SPACE_BT709 ? G2Y_BT709 : G2Y_BT2020;
+    const u32 B2Y = color_space == COLOR_SPACE_BT601 ? B2Y_BT601 :
+                      color_space == COLOR_SPACE_BT709 ? B2Y_BT709 : B2Y_BT2020;
 
 #if !defined(__aarch64__) && defined(__GNUC__) && __GNUC__ == 4 &&  __GNUC_MINOR__ < 7 && !defined(__clang__)
     register int16x4_t v_r2y asm ("d31") = vmov_n_s16(R2Y);
@@ -398,9 +411,12 @@ void bgrx2gray(const Size2D &size, COLOR_SPACE color_space,
 {
     internal::assertSupportedConfiguration();
 #ifdef CAROTENE_NEON
-    const u32 R2Y = color_space == COLOR_SPACE_BT601 ? R2Y_BT601 : R2Y_BT709;
-    const u32 G2Y = color_space == COLOR_SPACE_BT601 ? G2Y_BT601 : G2Y_BT709;
-    const u32 B2Y = color_space == COLOR_SPACE_BT601 ? B2Y_BT601 : B2Y_BT709;
+    const u32 R2Y = color_space == COLOR_SPACE_BT601 ? R2Y_BT601 :
+                      color_space == COLOR_SPACE_BT709 ? R2Y_BT709 : R2Y_BT2020;
+    const u32 G2Y = color_space == COLOR_SPACE_BT601 ? G2Y_BT601 :
+                      color_space == COLOR_SPACE_BT709 ? G2Y_BT709 : G2Y_BT2020;
+    const u32 B2Y = color_space == COLOR_SPACE_BT601 ? B2Y_BT601 :
+                      color_space == COLOR_SPACE_BT709 ? B2Y_BT709 : B2Y_BT2020;
 
 #if !defined(__aarch64__) && defined(__GNUC__) && __GNUC__ == 4 &&  __GNUC_MINOR__ < 7 && !defined(__clang__)
     register int16x4_t v_r2y asm ("d31") = vmov_n_s16(R2Y);
@@ -44,7 +44,9 @@
 #include <cstdlib>
 #include <algorithm>
 
-#if defined WITH_NEON && (defined __ARM_NEON__ || defined __ARM_NEON)
+// CAROTENE_NEON_EMULATION builds the NEON paths on other hosts against the
+// generated header from emulation/gen_arm_neon.py, for testing only
+#if defined WITH_NEON && (defined __ARM_NEON__ || defined __ARM_NEON || defined CAROTENE_NEON_EMULATION)
 #define CAROTENE_NEON
 #endif
 
@@ -43,6 +43,18 @@ namespace CAROTENE_NS {
 
 #ifdef CAROTENE_NEON
 
+namespace {
+
+// Adds 0.5 with the sign of v, so that the truncating conversion rounds halves away from
+// zero for negative values too, as saturate_cast does in the scalar tail
+inline float32x4_t vaddSignedHalf(float32x4_t v, float32x4_t vhalf)
+{
+    uint32x4_t vsign = vandq_u32(vreinterpretq_u32_f32(v), vdupq_n_u32(0x80000000u));
+    return vaddq_f32(v, vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(vhalf), vsign)));
+}
+
+} // namespace
+
 #define CVT_FUNC(T1, T2, SIMD_SIZE, CVTINIT, CVTROW)                            \
     void convert(const Size2D &_size,                                           \
                  const T1 * srcBase, ptrdiff_t srcStride,                       \
@@ -1138,8 +1150,8 @@ CVT_FUNC(f32, s8, 8,
          float32x4_t vline1_f32 = vld1q_f32(_src + i);
          float32x4_t vline2_f32 = vld1q_f32(_src + i + 4);
 
-         vline1_f32 = vaddq_f32(vline1_f32, vhalf);
-         vline2_f32 = vaddq_f32(vline2_f32, vhalf);
+         vline1_f32 = vaddSignedHalf(vline1_f32, vhalf);
+         vline2_f32 = vaddSignedHalf(vline2_f32, vhalf);
 
          int32x4_t vline1_s32 = vcvtq_s32_f32(vline1_f32);
          int32x4_t vline2_s32 = vcvtq_s32_f32(vline2_f32);
@@ -1254,7 +1266,7 @@ CVT_FUNC(f32, s16, 8,
          internal::prefetch(_src + i);
          float32x4_t vline_f32 = vld1q_f32(_src + i);
 
-         vline_f32 = vaddq_f32(vline_f32, vhalf);
+         vline_f32 = vaddSignedHalf(vline_f32, vhalf);
          int32x4_t vline_s32 = vcvtq_s32_f32(vline_f32);
          int16x4_t vline_s16 = vqmovn_s32(vline_s32);
 
@@ -1262,7 +1274,7 @@ CVT_FUNC(f32, s16, 8,
 
          vline_f32 = vld1q_f32(_src + i + 4);
 
-         vline_f32 = vaddq_f32(vline_f32, vhalf);
+         vline_f32 = vaddSignedHalf(vline_f32, vhalf);
          vline_s32 = vcvtq_s32_f32(vline_f32);
          vline_s16 = vqmovn_s32(vline_s32);
 
@@ -1306,14 +1318,14 @@ CVT_FUNC(f32, s32, 8,
          internal::prefetch(_src + i);
          float32x4_t vline_f32 = vld1q_f32(_src + i);
 
-         vline_f32 = vaddq_f32(vline_f32, vhalf);
+         vline_f32 = vaddSignedHalf(vline_f32, vhalf);
          int32x4_t vline_s32 = vcvtq_s32_f32(vline_f32);
 
          vst1q_s32(_dst + i, vline_s32);
 
          vline_f32 = vld1q_f32(_src + i + 4);
 
-         vline_f32 = vaddq_f32(vline_f32, vhalf);
+         vline_f32 = vaddSignedHalf(vline_f32, vhalf);
          vline_s32 = vcvtq_s32_f32(vline_f32);
 
          vst1q_s32(_dst + i + 4, vline_s32);
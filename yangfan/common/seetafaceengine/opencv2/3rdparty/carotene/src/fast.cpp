@@ -83,6 +83,7 @@ The references are:
 
 #include "common.hpp"
 
+#include <algorithm>
 #include <vector>
 #include <cstring>
 
@@ -112,102 +113,224 @@ void makeOffsets(ptrdiff_t pixel[], ptrdiff_t row_stride)
     pixel[15] = -1 + row_stride * 3;
 }
 
-u8 cornerScore(const u8* ptr, const ptrdiff_t pixel[])
+/*
+    Arc strength of 16 pixels at once: the largest, over the 16 arcs of 9 contiguous circle
+    pixels, of the smallest difference between the arc and the center, in the brighter or
+    the darker direction. A pixel is a corner iff its arc strength exceeds the threshold,
+    and the FAST score of a corner is its arc strength minus one. The minimum over 9
+    contiguous elements is built from minimums over 2, 4 and 8 of them, which takes 64
+    vector operations per direction instead of 144.
+*/
+uint8x16_t arcStrength(const u8 * ptr, const ptrdiff_t pixel[])
+{
+    uint8x16_t v = vld1q_u8(ptr);
+    uint8x16_t brighter[16], darker[16];
+    for (size_t k = 0; k < 16; ++k)
+    {
+        uint8x16_t x = vld1q_u8(ptr + pixel[k]);
+        darker[k] = vqsubq_u8(v, x);
+        brighter[k] = vqsubq_u8(x, v);
+    }
+
+    uint8x16_t m2d[16], m2b[16];
+    for (size_t k = 0; k < 16; ++k)
+    {
+        m2d[k] = vminq_u8(darker[k], darker[(k + 1) & 15]);
+        m2b[k] = vminq_u8(brighter[k], brighter[(k + 1) & 15]);
+    }
+    uint8x16_t m4d[16], m4b[16];
+    for (size_t k = 0; k < 16; ++k)
+    {
+        m4d[k] = vminq_u8(m2d[k], m2d[(k + 2) & 15]);
+        m4b[k] = vminq_u8(m2b[k], m2b[(k + 2) & 15]);
+    }
+
+    uint8x16_t q = vdupq_n_u8(0);
+    for (size_t k = 0; k < 16; ++k)
+    {
+        uint8x16_t m9d = vminq_u8(vminq_u8(m4d[k], m4d[(k + 4) & 15]), darker[(k + 8) & 15]);
+        uint8x16_t m9b = vminq_u8(vminq_u8(m4b[k], m4b[(k + 4) & 15]), brighter[(k + 8) & 15]);
+        q = vmaxq_u8(q, vmaxq_u8(m9d, m9b));
+    }
+    return q;
+}
+
+u8 arcStrength(const u8 * ptr, const ptrdiff_t pixel[], ptrdiff_t j)
+{
+    s32 v = ptr[j], q = 0;
+    for (size_t k = 0; k < 16; ++k)
+    {
+        s32 minDarker = 255, minBrighter = 255;
+        for (size_t l = 0; l < 9; ++l)
+        {
+            s32 x = ptr[j + pixel[(k + l) & 15]];
+            minDarker = std::min(minDarker, v - x);
+            minBrighter = std::min(minBrighter, x - v);
+        }
+        q = std::max(q, std::max(minDarker, minBrighter));
+    }
+    return (u8)q;
+}
+
+/*
+    Arc strengths of the corners of row i, 0 for the other pixels. Blocks of 16 pixels go
+    through the test of OpenCV on the four compass pixels first, a corner needs two adjacent
+    ones past the threshold, so that flat blocks skip the full computation.
+*/
+void cornerRow(const Size2D &size, const u8 * srcBase, ptrdiff_t srcStride, const ptrdiff_t pixel[],
+               u8 threshold, size_t i, u8 * strength)
+{
+    std::memset(strength, 0, size.width);
+    const u8 * row = internal::getRowPtr(srcBase, srcStride, i);
+    const uint8x16_t delta = vdupq_n_u8(128), t = vdupq_n_u8(threshold);
+
+    size_t j = 3;
+    if (size.width >= 16 + 6)
+    {
+        for (;;)
+        {
+            const u8 * ptr = row + j;
+            internal::prefetch(ptr);
+            internal::prefetch(ptr + pixel[0]);
+            internal::prefetch(ptr + pixel[8]);
+
+            uint8x16_t v0 = vld1q_u8(ptr);
+            int8x16_t v1 = vreinterpretq_s8_u8(veorq_u8(vqsubq_u8(v0, t), delta));
+            int8x16_t v2 = vreinterpretq_s8_u8(veorq_u8(vqaddq_u8(v0, t), delta));
+
+            int8x16_t x0 = vreinterpretq_s8_u8(veorq_u8(vld1q_u8(ptr + pixel[0]), delta));
+            int8x16_t x1 = vreinterpretq_s8_u8(veorq_u8(vld1q_u8(ptr + pixel[4]), delta));
+            int8x16_t x2 = vreinterpretq_s8_u8(veorq_u8(vld1q_u8(ptr + pixel[8]), delta));
+            int8x16_t x3 = vreinterpretq_s8_u8(veorq_u8(vld1q_u8(ptr + pixel[12]), delta));
+
+            uint8x16_t m0 =   vandq_u8(vcgtq_s8(x0, v2), vcgtq_s8(x1, v2));
+            uint8x16_t m1 =   vandq_u8(vcgtq_s8(v1, x0), vcgtq_s8(v1, x1));
+            m0 = vorrq_u8(m0, vandq_u8(vcgtq_s8(x1, v2), vcgtq_s8(x2, v2)));
+            m1 = vorrq_u8(m1, vandq_u8(vcgtq_s8(v1, x1), vcgtq_s8(v1, x2)));
+            m0 = vorrq_u8(m0, vandq_u8(vcgtq_s8(x2, v2), vcgtq_s8(x3, v2)));
+            m1 = vorrq_u8(m1, vandq_u8(vcgtq_s8(v1, x2), vcgtq_s8(v1, x3)));
+            m0 = vorrq_u8(m0, vandq_u8(vcgtq_s8(x3, v2), vcgtq_s8(x0, v2)));
+            m1 = vorrq_u8(m1, vandq_u8(vcgtq_s8(v1, x3), vcgtq_s8(v1, x0)));
+            m0 = vorrq_u8(m0, m1);
+
+            uint64x2_t m64 = vreinterpretq_u64_u8(m0);
+            if ((vgetq_lane_u64(m64, 0) | vgetq_lane_u64(m64, 1)) != 0)
+            {
+                uint8x16_t q = arcStrength(ptr, pixel);
+                vst1q_u8(strength + j, vandq_u8(q, vcgtq_u8(q, t)));
+            }
+
+            if (j + 16 == size.width - 3)
+                break;
+            // the last block overlaps the previous one instead of leaving a scalar tail
+            j = std::min(j + 16, size.width - 3 - 16);
+        }
+        return;
+    }
+
+    for (; j + 3 < size.width; ++j)
+    {
+        u8 q = arcStrength(row, pixel, j);
+        strength[j] = q > threshold ? q : 0;
+    }
+}
+
+/*
+    Strict 3x3 maximums of row `curr` among its neighbours in prev and next. Rows hold arc
+    strengths, that is the FAST score plus one for corners and 0 elsewhere, so a corner
+    with score 0 never survives, as in FAST. Surviving columns are appended to `columns`.
+*/
+void suppressRow(size_t width, const u8 * prev, const u8 * curr, const u8 * next, bool nonmax,
+                 std::vector<u16> & columns)
+{
+    const uint8x16_t v1 = vdupq_n_u8(nonmax ? 1 : 0);
+    size_t j = 3;
+    for (; j + 16 + 3 <= width; j += 16)
+    {
+        uint8x16_t c = vld1q_u8(curr + j);
+        uint8x16_t m = vcgtq_u8(c, v1);
+        if (nonmax)
+        {
+            uint8x16_t n = vmaxq_u8(vld1q_u8(curr + j - 1), vld1q_u8(curr + j + 1));
+            n = vmaxq_u8(n, vmaxq_u8(vld1q_u8(prev + j - 1), vld1q_u8(prev + j)));
+            n = vmaxq_u8(n, vmaxq_u8(vld1q_u8(prev + j + 1), vld1q_u8(next + j - 1)));
+            n = vmaxq_u8(n, vmaxq_u8(vld1q_u8(next + j), vld1q_u8(next + j + 1)));
+            m = vandq_u8(m, vcgtq_u8(c, n));
+        }
+
+        uint64x2_t m64 = vreinterpretq_u64_u8(m);
+        if ((vgetq_lane_u64(m64, 0) | vgetq_lane_u64(m64, 1)) == 0)
+            continue;
+        u8 mask[16];
+        vst1q_u8(mask, m);
+        for (size_t k = 0; k < 16; ++k)
+            if (mask[k])
+                columns.push_back((u16)(j + k));
+    }
+
+    for (; j + 3 < width; ++j)
+    {
+        u8 c = curr[j];
+        if (c > (nonmax ? 1 : 0) &&
+            (!nonmax || (c > curr[j - 1] && c > curr[j + 1] &&
+                         c > prev[j - 1] && c > prev[j] && c > prev[j + 1] &&
+                         c > next[j - 1] && c > next[j] && c > next[j + 1])))
+            columns.push_back((u16)j);
+    }
+}
+
+struct Corners
+{
+    std::vector<u16> x, y;
+    std::vector<u8> score;
+};
+
+// Higher score first, then raster order
+struct StrongerCorner
+{
+    explicit StrongerCorner(const u8 * score_) : score(score_) {}
+    bool operator()(u32 a, u32 b) const
+    {
+        return score[a] > score[b] || (score[a] == score[b] && a < b);
+    }
+    const u8 * score;
+};
+
+// All corners of FAST in raster order, with their scores when nonmax is set and 0 otherwise
+void detect(const Size2D &size, const u8 * srcBase, ptrdiff_t srcStride,
+            u8 threshold, bool nonmax, Corners & corners)
 {
-    const s32 K = 8, N = 16 + K + 1;
-    s32 k, v = ptr[0];
-    s16 d[(N + 7) & ~7];
-    for( k = 0; k < N; k++ )
-        d[k] = (s16)(v - ptr[pixel[k]]);
-
-    int16x8_t q0 = vdupq_n_s16((s16)(-1000));
-    int16x8_t q1 = vdupq_n_s16((s16)(1000));
-
-    int16x8_t d0_7   = vld1q_s16(d +  0);
-    int16x8_t d8_15  = vld1q_s16(d +  8);
-    int16x8_t d16_23 = vld1q_s16(d + 16);
-    int16x8_t d24    = vld1q_s16(d + 24);
-
-    //k == 0
-    int16x8_t v0k0 = vextq_s16(d0_7, d8_15, 1);
-    int16x8_t v1k0 = vextq_s16(d0_7, d8_15, 2);
-    int16x8_t ak0 = vminq_s16(v0k0, v1k0);
-    int16x8_t bk0 = vmaxq_s16(v0k0, v1k0);
-
-    v0k0 = vextq_s16(d0_7, d8_15, 3);
-    ak0 = vminq_s16(ak0, v0k0);
-    bk0 = vmaxq_s16(bk0, v0k0);
-
-    v1k0 = vextq_s16(d0_7, d8_15, 4);
-    ak0 = vminq_s16(ak0, v1k0);
-    bk0 = vmaxq_s16(bk0, v1k0);
-
-    v0k0 = vextq_s16(d0_7, d8_15, 5);
-    ak0 = vminq_s16(ak0, v0k0);
-    bk0 = vmaxq_s16(bk0, v0k0);
-
-    v1k0 = vextq_s16(d0_7, d8_15, 6);
-    ak0 = vminq_s16(ak0, v1k0);
-    bk0 = vmaxq_s16(bk0, v1k0);
-
-    v0k0 = vextq_s16(d0_7, d8_15, 7);
-    ak0 = vminq_s16(ak0, v0k0);
-    bk0 = vmaxq_s16(bk0, v0k0);
-
-    ak0 = vminq_s16(ak0, d8_15);
-    bk0 = vmaxq_s16(bk0, d8_15);
-
-    q0 = vmaxq_s16(q0, vminq_s16(ak0, d0_7));
-    q1 = vminq_s16(q1, vmaxq_s16(bk0, d0_7));
-
-    v1k0 = vextq_s16(d8_15, d16_23, 1);
-    q0 = vmaxq_s16(q0, vminq_s16(ak0, v1k0));
-    q1 = vminq_s16(q1, vmaxq_s16(bk0, v1k0));
-
-    //k == 8
-    int16x8_t v0k8 = v1k0;
-    int16x8_t v1k8 = vextq_s16(d8_15, d16_23, 2);
-    int16x8_t ak8 = vminq_s16(v0k8, v1k8);
-    int16x8_t bk8 = vmaxq_s16(v0k8, v1k8);
-
-    v0k8 = vextq_s16(d8_15, d16_23, 3);
-    ak8 = vminq_s16(ak8, v0k8);
-    bk8 = vmaxq_s16(bk8, v0k8);
-
-    v1k8 = vextq_s16(d8_15, d16_23, 4);
-    ak8 = vminq_s16(ak8, v1k8);
-    bk8 = vmaxq_s16(bk8, v1k8);
-
-    v0k8 = vextq_s16(d8_15, d16_23, 5);
-    ak8 = vminq_s16(ak8, v0k8);
-    bk8 = vmaxq_s16(bk8, v0k8);
-
-    v1k8 = vextq_s16(d8_15, d16_23, 6);
-    ak8 = vminq_s16(ak8, v1k8);
-    bk8 = vmaxq_s16(bk8, v1k8);
-
-    v0k8 = vextq_s16(d8_15, d16_23, 7);
-    ak8 = vminq_s16(ak8, v0k8);
-    bk8 = vmaxq_s16(bk8, v0k8);
-
-    ak8 = vminq_s16(ak8, d16_23);
-    bk8 = vmaxq_s16(bk8, d16_23);
-
-    q0 = vmaxq_s16(q0, vminq_s16(ak8, d8_15));
-    q1 = vminq_s16(q1, vmaxq_s16(bk8, d8_15));
-
-    v1k8 = vextq_s16(d16_23, d24, 1);
-    q0 = vmaxq_s16(q0, vminq_s16(ak8, v1k8));
-    q1 = vminq_s16(q1, vmaxq_s16(bk8, v1k8));
-
-    //fin
-    int16x8_t q = vmaxq_s16(q0, vsubq_s16(vmovq_n_s16(0), q1));
-    int16x4_t q2 = vmax_s16(vget_low_s16(q), vget_high_s16(q));
-    int32x4_t q2w = vmovl_s16(q2);
-    int32x2_t q4 = vmax_s32(vget_low_s32(q2w), vget_high_s32(q2w));
-    int32x2_t q8 = vmax_s32(q4, vreinterpret_s32_s64(vshr_n_s64(vreinterpret_s64_s32(q4), 32)));
-
-    return (u8)(vget_lane_s32(q8, 0) - 1);
+    if (size.width < 7 || size.height < 7)
+        return;
+
+    ptrdiff_t pixel[16];
+    makeOffsets(pixel, srcStride);
+
+    // strength rows i - 2, i - 1 and i, the rows of the 3 pixel border stay 0
+    std::vector<u8> _buf(size.width * 3, 0);
+    u8 * rows[3] = { &_buf[0], &_buf[size.width], &_buf[size.width * 2] };
+    std::vector<u16> columns;
+
+    for (size_t i = 3; i <= size.height - 3; ++i)
+    {
+        u8 * curr = rows[i % 3];
+        if (i < size.height - 3)
+            cornerRow(size, srcBase, srcStride, pixel, threshold, i, curr);
+        else
+            std::memset(curr, 0, size.width);
+        if (i == 3)
+            continue;
+
+        columns.clear();
+        const u8 * mid = rows[(i - 1) % 3];
+        suppressRow(size.width, rows[(i - 2) % 3], mid, curr, nonmax, columns);
+        for (size_t k = 0; k < columns.size(); ++k)
+        {
+            corners.x.push_back(columns[k]);
+            corners.y.push_back((u16)(i - 1));
+            corners.score.push_back(nonmax ? (u8)(mid[columns[k]] - 1) : 0);
+        }
+    }
 }
 
 } //namespace
@@ -220,208 +343,91 @@ void FAST(const Size2D &size,
 {
     internal::assertSupportedConfiguration();
 #ifdef CAROTENE_NEON
-    //keypoints.clear();
-
-    const s32 K = 8, N = 16 + K + 1;
-    ptrdiff_t i, j, k, pixel[N];
-    makeOffsets(pixel, srcStride);
-    for(k = 16; k < N; k++)
-        pixel[k] = pixel[k - 16];
-
-    uint8x16_t delta = vdupq_n_u8(128);
-    uint8x16_t t = vdupq_n_u8(threshold);
-    uint8x16_t K16 = vdupq_n_u8((u8)K);
-
-    u8 threshold_tab[512];
-    for( i = -255; i <= 255; i++ )
-        threshold_tab[i+255] = (u8)(i < -threshold ? 1 : i > threshold ? 2 : 0);
-
-    std::vector<u8> _buf((size.width+16)*3*(sizeof(ptrdiff_t) + sizeof(u8)) + 128);
-    u8* buf[3];
-    buf[0] = &_buf[0]; buf[1] = buf[0] + size.width; buf[2] = buf[1] + size.width;
-    ptrdiff_t* cpbuf[3];
-    cpbuf[0] = (ptrdiff_t*)internal::alignPtr(buf[2] + size.width, sizeof(ptrdiff_t)) + 1;
-    cpbuf[1] = cpbuf[0] + size.width + 1;
-    cpbuf[2] = cpbuf[1] + size.width + 1;
-    memset(buf[0], 0, size.width*3);
-
-    for(i = 3; i < (ptrdiff_t)size.height-2; i++)
-    {
-        const u8* ptr = internal::getRowPtr(srcBase, srcStride, i) + 3;
-        u8* curr = buf[(i - 3)%3];
-        ptrdiff_t* cornerpos = cpbuf[(i - 3)%3];
-        memset(curr, 0, size.width);
-        ptrdiff_t ncorners = 0;
+    Corners corners;
+    detect(size, srcBase, srcStride, threshold, nonmax_suppression, corners);
+    for (size_t k = 0; k < corners.x.size(); ++k)
+        keypoints->push((f32)corners.x[k], (f32)corners.y[k], 7.f, -1, (f32)corners.score[k]);
+#else
+    (void)size;
+    (void)srcBase;
+    (void)srcStride;
+    (void)keypoints;
+    (void)threshold;
+    (void)nonmax_suppression;
+#endif
+}
 
-        if( i < (ptrdiff_t)size.height - 3 )
-        {
-            j = 3;
+bool isFASTGridSupported(const Size2D &size, const Size2D &cellSize)
+{
+    return isSupportedConfiguration() && size.width <= 0xFFFF && size.height <= 0xFFFF &&
+           cellSize.width > 0 && cellSize.height > 0;
+}
 
-            for(; j < (ptrdiff_t)size.width - 16 - 3; j += 16, ptr += 16)
-            {
-                internal::prefetch(ptr);
-                internal::prefetch(ptr + pixel[0]);
-                internal::prefetch(ptr + pixel[2]);
-
-                uint8x16_t v0 = vld1q_u8(ptr);
-                int8x16_t v1 = vreinterpretq_s8_u8(veorq_u8(vqsubq_u8(v0, t), delta));
-                int8x16_t v2 = vreinterpretq_s8_u8(veorq_u8(vqaddq_u8(v0, t), delta));
-
-                int8x16_t x0 = vreinterpretq_s8_u8(vsubq_u8(vld1q_u8(ptr + pixel[0]), delta));
-                int8x16_t x1 = vreinterpretq_s8_u8(vsubq_u8(vld1q_u8(ptr + pixel[4]), delta));
-                int8x16_t x2 = vreinterpretq_s8_u8(vsubq_u8(vld1q_u8(ptr + pixel[8]), delta));
-                int8x16_t x3 = vreinterpretq_s8_u8(vsubq_u8(vld1q_u8(ptr + pixel[12]), delta));
-
-                uint8x16_t m0 =   vandq_u8(vcgtq_s8(x0, v2), vcgtq_s8(x1, v2));
-                uint8x16_t m1 =   vandq_u8(vcgtq_s8(v1, x0), vcgtq_s8(v1, x1));
-                m0 = vorrq_u8(m0, vandq_u8(vcgtq_s8(x1, v2), vcgtq_s8(x2, v2)));
-                m1 = vorrq_u8(m1, vandq_u8(vcgtq_s8(v1, x1), vcgtq_s8(v1, x2)));
-                m0 = vorrq_u8(m0, vandq_u8(vcgtq_s8(x2, v2), vcgtq_s8(x3, v2)));
-                m1 = vorrq_u8(m1, vandq_u8(vcgtq_s8(v1, x2), vcgtq_s8(v1, x3)));
-                m0 = vorrq_u8(m0, vandq_u8(vcgtq_s8(x3, v2), vcgtq_s8(x0, v2)));
-                m1 = vorrq_u8(m1, vandq_u8(vcgtq_s8(v1, x3), vcgtq_s8(v1, x0)));
-                m0 = vorrq_u8(m0, m1);
-
-                u64 mask[2];
-                vst1q_u64(mask, vreinterpretq_u64_u8(m0));
-
-                if( mask[0] == 0 )
-                {
-                    if (mask[1] != 0)
-                    {
-                        j -= 8;
-                        ptr -= 8;
-                    }
-                    continue;
-                }
-
-                uint8x16_t c0 = vmovq_n_u8(0);
-                uint8x16_t c1 = vmovq_n_u8(0);
-                uint8x16_t max0 = vmovq_n_u8(0);
-                uint8x16_t max1 = vmovq_n_u8(0);
-                for( k = 0; k < N; k++ )
-                {
-                    int8x16_t x = vreinterpretq_s8_u8(veorq_u8(vld1q_u8(ptr + pixel[k]), delta));
-                    m0 = vcgtq_s8(x, v2);
-                    m1 = vcgtq_s8(v1, x);
-
-                    c0 = vandq_u8(vsubq_u8(c0, m0), m0);
-                    c1 = vandq_u8(vsubq_u8(c1, m1), m1);
-
-                    max0 = vmaxq_u8(max0, c0);
-                    max1 = vmaxq_u8(max1, c1);
-                }
-
-                max0 = vmaxq_u8(max0, max1);
-                u8 m[16];
-                vst1q_u8(m, vcgtq_u8(max0, K16));
-
-                for( k = 0; k < 16; ++k )
-                    if(m[k])
-                    {
-                        cornerpos[ncorners++] = j+k;
-                        if(nonmax_suppression)
-                            curr[j+k] = cornerScore(ptr+k, pixel);
-                    }
-            }
+void FASTGrid(const Size2D &size,
+              const u8 *srcBase, ptrdiff_t srcStride,
+              u8 threshold, bool nonmax_suppression,
+              const Size2D &cellSize, u32 maxPerCell,
+              KeypointArrays *keypoints)
+{
+    internal::assertSupportedConfiguration(isFASTGridSupported(size, cellSize));
+#ifdef CAROTENE_NEON
+    Corners corners;
+    detect(size, srcBase, srcStride, threshold, nonmax_suppression, corners);
+    const size_t total = corners.x.size();
+    std::vector<u8> keep(total, 1);
 
-            for( ; j < (s32)size.width - 3; j++, ptr++ )
-            {
-                s32 v = ptr[0];
-                const u8* tab = &threshold_tab[0] - v + 255;
-                s32 d = tab[ptr[pixel[0]]] | tab[ptr[pixel[8]]];
-
-                if( d == 0 )
-                    continue;
-
-                d &= tab[ptr[pixel[2]]] | tab[ptr[pixel[10]]];
-                d &= tab[ptr[pixel[4]]] | tab[ptr[pixel[12]]];
-                d &= tab[ptr[pixel[6]]] | tab[ptr[pixel[14]]];
-
-                if( d == 0 )
-                    continue;
-
-                d &= tab[ptr[pixel[1]]] | tab[ptr[pixel[9]]];
-                d &= tab[ptr[pixel[3]]] | tab[ptr[pixel[11]]];
-                d &= tab[ptr[pixel[5]]] | tab[ptr[pixel[13]]];
-                d &= tab[ptr[pixel[7]]] | tab[ptr[pixel[15]]];
-
-                if( d & 1 )
-                {
-                    s32 vt = v - threshold, count = 0;
-
-                    for( k = 0; k < N; k++ )
-                    {
-                        s32 x = ptr[pixel[k]];
-                        if(x < vt)
-                        {
-                            if( ++count > K )
-                            {
-                                cornerpos[ncorners++] = j;
-                                if(nonmax_suppression)
-                                    curr[j] = cornerScore(ptr, pixel);
-                                break;
-                            }
-                        }
-                        else
-                            count = 0;
-                    }
-                }
-
-                if( d & 2 )
-                {
-                    s32 vt = v + threshold, count = 0;
-
-                    for( k = 0; k < N; k++ )
-                    {
-                        s32 x = ptr[pixel[k]];
-                        if(x > vt)
-                        {
-                            if( ++count > K )
-                            {
-                                cornerpos[ncorners++] = j;
-                                if(nonmax_suppression)
-                                    curr[j] = cornerScore(ptr, pixel);
-                                break;
-                            }
-                        }
-                        else
-                            count = 0;
-                    }
-                }
-            }
+    if (maxPerCell > 0 && total > 0)
+    {
+        // counting sort of the corner indices by cell, each cell stays in raster order
+        const size_t cellsX = (size.width + cellSize.width - 1) / cellSize.width;
+        const size_t cellsY = (size.height + cellSize.height - 1) / cellSize.height;
+        std::vector<u32> cellOf(total), start(cellsX * cellsY + 1, 0), order(total);
+        for (size_t k = 0; k < total; ++k)
+        {
+            cellOf[k] = (u32)((corners.y[k] / cellSize.height) * cellsX + corners.x[k] / cellSize.width);
+            ++start[cellOf[k] + 1];
         }
+        for (size_t c = 0; c < cellsX * cellsY; ++c)
+            start[c + 1] += start[c];
+        std::vector<u32> fill(start.begin(), start.end() - 1);
+        for (size_t k = 0; k < total; ++k)
+            order[fill[cellOf[k]]++] = (u32)k;
+
+        const u8 * score = &corners.score[0];
+        for (size_t c = 0; c < cellsX * cellsY; ++c)
+        {
+            if (start[c + 1] - start[c] <= maxPerCell)
+                continue;
+            u32 * first = &order[start[c]], * last = &order[0] + start[c + 1];
+            std::nth_element(first, first + maxPerCell, last, StrongerCorner(score));
+            for (u32 * p = first + maxPerCell; p != last; ++p)
+                keep[*p] = 0;
+        }
+    }
 
-        cornerpos[-1] = ncorners;
-
-        if( i == 3 )
+    size_t count = 0;
+    for (size_t k = 0; k < total; ++k)
+    {
+        if (!keep[k])
             continue;
-
-        const u8* prev = buf[(i - 4 + 3)%3];
-        const u8* pprev = buf[(i - 5 + 3)%3];
-        cornerpos = cpbuf[(i - 4 + 3)%3];
-        ncorners = cornerpos[-1];
-
-        for( k = 0; k < ncorners; k++ )
+        if (count < keypoints->capacity)
         {
-            j = cornerpos[k];
-            s32 score = prev[j];
-            if( !nonmax_suppression ||
-                    (score > prev[j+1] && score > prev[j-1] &&
-                     score > pprev[j-1] && score > pprev[j] && score > pprev[j+1] &&
-                     score > curr[j-1] && score > curr[j] && score > curr[j+1]) )
-            {
-                keypoints->push((f32)j, (f32)(i-1), 7.f, -1, (f32)score);
-            }
+            keypoints->x[count] = corners.x[k];
+            keypoints->y[count] = corners.y[k];
+            keypoints->score[count] = corners.score[k];
         }
+        ++count;
     }
+    keypoints->count = count;
 #else
     (void)size;
     (void)srcBase;
     (void)srcStride;
-    (void)keypoints;
     (void)threshold;
     (void)nonmax_suppression;
+    (void)cellSize;
+    (void)maxPerCell;
+    (void)keypoints;
 #endif
 }
 
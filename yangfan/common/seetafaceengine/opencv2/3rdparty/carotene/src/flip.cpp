@@ -92,8 +92,9 @@ void flip(const Size2D & size,
             vst1(dst + jd - step_tail, vrev64(v_src));
         }
 
+        // 8UC2 and 8UC4 rows are only byte aligned, copy the wide elements bytewise
         for (--jd; js < size.width; ++js, --jd)
-            dst[jd] = src[js];
+            std::memcpy(dst + jd, src + js, sizeof(T));
     }
 }
 
@@ -41,6 +41,8 @@
 #include "saturate_cast.hpp"
 #include "separable_filter.hpp"
 
+#include <vector>
+
 namespace CAROTENE_NS {
 
 bool isGaussianBlur3x3Supported(const Size2D &size, BORDER_MODE border)
@@ -182,9 +184,48 @@ void gaussianBlur3x3Margin(const Size2D &size,
 {
     internal::assertSupportedConfiguration(isGaussianBlur3x3MarginSupported(size, border, borderMargin));
 #ifdef CAROTENE_NEON
-    internal::sepFilter3x3<internal::RowFilter3x3S16_121, internal::ColFilter3x3U8_121>::process(
-                           size, srcBase, srcStride, dstBase, dstStride,
-                           0, 0, border, borderValue, borderMargin);
+    internal::Border3x3 borderMap(size, border, borderMargin);
+    // leftAt/rightAt read one element past a constant row when the margin has real columns
+    std::vector<u8> _constRow(size.width + 2, borderValue);
+    const u8 * constRow = &_constRow[1];
+
+    // column sums r0 + 2 * r1 + r2 of a row with one element on either side
+    std::vector<u16> _sums(size.width + 2);
+    u16 * sums = &_sums[1];
+
+    for (size_t y = 0; y < size.height; ++y)
+    {
+        const u8 * r[3];
+        borderMap.rows(srcBase, srcStride, y, constRow, r);
+
+        size_t x = 0;
+        for (; x + 8 <= size.width; x += 8)
+        {
+            internal::prefetch(r[0] + x);
+            internal::prefetch(r[1] + x);
+            internal::prefetch(r[2] + x);
+
+            uint16x8_t v_sum = vaddl_u8(vld1_u8(r[0] + x), vld1_u8(r[2] + x));
+            vst1q_u16(sums + x, vaddq_u16(v_sum, vshll_n_u8(vld1_u8(r[1] + x), 1)));
+        }
+        for (; x < size.width; ++x)
+            sums[x] = (u16)(r[0][x] + 2 * r[1][x] + r[2][x]);
+
+        sums[-1] = (u16)(borderMap.leftAt(r[0], 1, 0, borderValue) + 2 * borderMap.leftAt(r[1], 1, 0, borderValue) +
+                         borderMap.leftAt(r[2], 1, 0, borderValue));
+        sums[size.width] = (u16)(borderMap.rightAt(r[0], 1, 0, borderValue) + 2 * borderMap.rightAt(r[1], 1, 0, borderValue) +
+                                 borderMap.rightAt(r[2], 1, 0, borderValue));
+
+        u8 * dst = internal::getRowPtr(dstBase, dstStride, y);
+        for (x = 0; x + 8 <= size.width; x += 8)
+        {
+            uint16x8_t v_sum = vaddq_u16(vld1q_u16(sums + x - 1), vld1q_u16(sums + x + 1));
+            v_sum = vaddq_u16(v_sum, vshlq_n_u16(vld1q_u16(sums + x), 1));
+            vst1_u8(dst + x, vrshrn_n_u16(v_sum, 4));
+        }
+        for (; x < size.width; ++x)
+            dst[x] = (u8)((sums[x - 1] + 2 * sums[x] + sums[x + 1] + 8) >> 4);
+    }
 #else
     (void)srcBase;
     (void)srcStride;
@@ -194,6 +235,22 @@ void gaussianBlur3x3Margin(const Size2D &size,
 #endif
 }
 
+#ifdef CAROTENE_NEON
+namespace {
+
+// Vertical [1 4 6 4 1] sum of the border element x, which is a constant one when it lies
+// before start and a real one of the margin or of the roi otherwise
+inline u16 gaussianBorderColumn5x5(const u8 * ln0, const u8 * ln1, const u8 * ln2, const u8 * ln3, const u8 * ln4,
+                                   ptrdiff_t x, ptrdiff_t start, u8 borderValue)
+{
+    if (x < start)
+        return u16(16) * borderValue;
+    return ln0[x] + ln4[x] + u16(4) * (ln1[x] + ln3[x]) + u16(6) * ln2[x];
+}
+
+} // namespace
+#endif
+
 bool isGaussianBlur5x5Supported(const Size2D &size, s32 cn, BORDER_MODE border)
 {
     return isSupportedConfiguration() &&
@@ -231,15 +288,8 @@ void gaussianBlur5x5(const Size2D &size, s32 cn,
     //1-line buffer
     std::vector<u16> _buf(cn * (size.width + 4) + 32 / sizeof(u16));
     u16* lane = internal::alignPtr(&_buf[cn << 1], 32);
-
-    if (borderType == BORDER_MODE_CONSTANT)
-        for (s32 k = 0; k < cn; ++k)
-        {
-            lane[-cn+k] = borderValue;
-            lane[-cn-cn+k] = borderValue;
-            lane[colsn+k] = borderValue;
-            lane[colsn+cn+k] = borderValue;
-        }
+    // border indices below this one are constant, the others are in the roi or the margin
+    ptrdiff_t constantBefore = -(ptrdiff_t)borderMargin.left * cn;
 
     uint8x8_t vc6u8 = vmov_n_u8(6);
     uint16x8_t vc6u16 = vmovq_n_u16(6);
@@ -281,16 +331,15 @@ void gaussianBlur5x5(const Size2D &size, s32 cn,
         for (; x < colsn; ++x)
             lane[x] = ln0[x] + ln4[x] + u16(4) * (ln1[x] + ln3[x]) + u16(6) * ln2[x];
 
-        //left&right borders
-        if (borderType != BORDER_MODE_CONSTANT)
-            for (s32 k = 0; k < cn; ++k)
-            {
-                lane[-cn+k] = lane[idx_l1 + k];
-                lane[-cn-cn+k] = lane[idx_l2 + k];
+        //left&right borders, the lane only holds the roi columns
+        for (s32 k = 0; k < cn; ++k)
+        {
+            lane[-cn+k] = gaussianBorderColumn5x5(ln0, ln1, ln2, ln3, ln4, idx_l1 + k, constantBefore, borderValue);
+            lane[-cn-cn+k] = gaussianBorderColumn5x5(ln0, ln1, ln2, ln3, ln4, idx_l2 + k, constantBefore, borderValue);
 
-                lane[colsn+k] = lane[idx_r1 + k];
-                lane[colsn+cn+k] = lane[idx_r2 + k];
-            }
+            lane[colsn+k] = gaussianBorderColumn5x5(ln0, ln1, ln2, ln3, ln4, idx_r1 + k, constantBefore, borderValue);
+            lane[colsn+cn+k] = gaussianBorderColumn5x5(ln0, ln1, ln2, ln3, ln4, idx_r2 + k, constantBefore, borderValue);
+        }
 
         //horizontal convolution
         x = 0;
@@ -0,0 +1,438 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "common.hpp"
+
+namespace CAROTENE_NS {
+
+#ifdef CAROTENE_NEON
+
+namespace {
+
+/*
+    Histogram of u8 data. There is no scatter in NEON, so the gain over a plain loop comes
+    from breaking the store to load chain on runs of equal pixels: consecutive pixels go to
+    four sub-histograms, which are summed with vector adds at the end.
+*/
+struct SubHistograms
+{
+    u32 bins[4][256];
+
+    SubHistograms() { std::memset(bins, 0, sizeof(bins)); }
+
+    void addRow(const u8 * src, size_t n)
+    {
+        size_t j = 0;
+        for (; j + 16 <= n; j += 16)
+        {
+            internal::prefetch(src + j);
+            uint64x2_t v = vreinterpretq_u64_u8(vld1q_u8(src + j));
+            addBytes(vgetq_lane_u64(v, 0));
+            addBytes(vgetq_lane_u64(v, 1));
+        }
+        for (; j < n; ++j)
+            ++bins[j & 3][src[j]];
+    }
+
+    inline void addBytes(u64 b)
+    {
+        ++bins[0][b & 0xFF];
+        ++bins[1][(b >> 8) & 0xFF];
+        ++bins[2][(b >> 16) & 0xFF];
+        ++bins[3][(b >> 24) & 0xFF];
+        ++bins[0][(b >> 32) & 0xFF];
+        ++bins[1][(b >> 40) & 0xFF];
+        ++bins[2][(b >> 48) & 0xFF];
+        ++bins[3][b >> 56];
+    }
+
+    void merge(u32 * hist) const
+    {
+        for (size_t i = 0; i < 256; i += 4)
+        {
+            uint32x4_t v = vaddq_u32(vld1q_u32(bins[0] + i), vld1q_u32(bins[1] + i));
+            v = vaddq_u32(v, vaddq_u32(vld1q_u32(bins[2] + i), vld1q_u32(bins[3] + i)));
+            vst1q_u32(hist + i, v);
+        }
+    }
+};
+
+// 256 entry table lookup of 16 bytes
+#if defined(__aarch64__)
+struct LutTable
+{
+    uint8x16x4_t t[4];
+
+    explicit LutTable(const u8 * lut)
+    {
+        for (size_t k = 0; k < 4; ++k)
+            t[k] = loadTable(lut + 64 * k);
+    }
+
+    static uint8x16x4_t loadTable(const u8 * p)
+    {
+        uint8x16x4_t v;
+        v.val[0] = vld1q_u8(p);
+        v.val[1] = vld1q_u8(p + 16);
+        v.val[2] = vld1q_u8(p + 32);
+        v.val[3] = vld1q_u8(p + 48);
+        return v;
+    }
+
+    inline uint8x16_t operator()(uint8x16_t idx) const
+    {
+        const uint8x16_t v64 = vdupq_n_u8(64);
+        uint8x16_t r = vqtbl4q_u8(t[0], idx);
+        idx = vsubq_u8(idx, v64);
+        r = vqtbx4q_u8(r, t[1], idx);
+        idx = vsubq_u8(idx, v64);
+        r = vqtbx4q_u8(r, t[2], idx);
+        idx = vsubq_u8(idx, v64);
+        return vqtbx4q_u8(r, t[3], idx);
+    }
+};
+#else
+struct LutTable
+{
+    uint8x8x4_t t[8];
+
+    explicit LutTable(const u8 * lut)
+    {
+        for (size_t k = 0; k < 8; ++k)
+            for (size_t j = 0; j < 4; ++j)
+                t[k].val[j] = vld1_u8(lut + 32 * k + 8 * j);
+    }
+
+    inline uint8x8_t lookup(uint8x8_t idx) const
+    {
+        const uint8x8_t v32 = vdup_n_u8(32);
+        uint8x8_t r = vtbl4_u8(t[0], idx);
+        for (size_t k = 1; k < 8; ++k)
+        {
+            idx = vsub_u8(idx, v32);
+            r = vtbx4_u8(r, t[k], idx);
+        }
+        return r;
+    }
+
+    inline uint8x16_t operator()(uint8x16_t idx) const
+    {
+        return vcombine_u8(lookup(vget_low_u8(idx)), lookup(vget_high_u8(idx)));
+    }
+};
+#endif
+
+// cvRound of a non-negative float below 2^22: adding 1.5 * 2^23 leaves no fraction bits,
+// so the addition itself rounds half to even
+inline s32 roundHalfEven(f32 v)
+{
+    volatile f32 t = v + 12582912.0f;
+    return (s32)(t - 12582912.0f);
+}
+
+inline int32x4_t vroundHalfEvenq(float32x4_t v)
+{
+    const float32x4_t vmagic = vdupq_n_f32(12582912.0f);
+    return vcvtq_s32_f32(vsubq_f32(vaddq_f32(v, vmagic), vmagic));
+}
+
+// OpenCV borderInterpolate for BORDER_REFLECT_101
+inline size_t reflect101(ptrdiff_t p, ptrdiff_t len)
+{
+    if (len == 1)
+        return 0;
+    while (p < 0 || p >= len)
+        p = p < 0 ? -p : 2 * len - 2 - p;
+    return (size_t)p;
+}
+
+} // namespace
+
+#endif
+
+void calcHist(const Size2D &size,
+              const u8 * srcBase, ptrdiff_t srcStride,
+              u32 * hist)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    SubHistograms sub;
+    if (srcStride == (ptrdiff_t)size.width)
+        sub.addRow(srcBase, size.width * size.height);
+    else
+        for (size_t i = 0; i < size.height; ++i)
+            sub.addRow(internal::getRowPtr(srcBase, srcStride, i), size.width);
+    sub.merge(hist);
+#else
+    (void)size;
+    (void)srcBase;
+    (void)srcStride;
+    (void)hist;
+#endif
+}
+
+void lut(const Size2D &size,
+         const u8 * srcBase, ptrdiff_t srcStride,
+         u8 * dstBase, ptrdiff_t dstStride,
+         const u8 * lutBase)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    const LutTable table(lutBase);
+    Size2D sz = size;
+    if (srcStride == dstStride && srcStride == (ptrdiff_t)size.width)
+    {
+        sz.width *= sz.height;
+        sz.height = 1;
+    }
+
+    for (size_t i = 0; i < sz.height; ++i)
+    {
+        const u8 * src = internal::getRowPtr(srcBase, srcStride, i);
+        u8 * dst = internal::getRowPtr(dstBase, dstStride, i);
+        size_t j = 0;
+        for (; j + 16 <= sz.width; j += 16)
+        {
+            internal::prefetch(src + j);
+            vst1q_u8(dst + j, table(vld1q_u8(src + j)));
+        }
+        for (; j < sz.width; ++j)
+            dst[j] = lutBase[src[j]];
+    }
+#else
+    (void)size;
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+    (void)lutBase;
+#endif
+}
+
+void equalizeHist(const Size2D &size,
+                  const u8 * srcBase, ptrdiff_t srcStride,
+                  u8 * dstBase, ptrdiff_t dstStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    u32 hist[256];
+    calcHist(size, srcBase, srcStride, hist);
+
+    // the table of cv::equalizeHist: the lowest occupied value maps to 0 and the
+    // cumulative count is scaled so that the highest one maps to 255
+    u8 table[256] = { 0 };
+    size_t i = 0;
+    while (i < 256 && !hist[i])
+        ++i;
+    const u32 total = (u32)(size.width * size.height);
+    if (i < 256 && hist[i] == total)
+        std::fill(table, table + 256, (u8)i);
+    else if (i < 256)
+    {
+        f32 scale = 255.f / (total - hist[i]);
+        u32 sum = 0;
+        for (table[i++] = 0; i < 256; ++i)
+        {
+            sum += hist[i];
+            table[i] = (u8)std::min(roundHalfEven(sum * scale), 255);
+        }
+    }
+
+    lut(size, srcBase, srcStride, dstBase, dstStride, table);
+#else
+    (void)size;
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+#endif
+}
+
+bool isClaheSupported(const Size2D &size, u32 tilesX, u32 tilesY)
+{
+    return isSupportedConfiguration() && tilesX > 0 && tilesY > 0 &&
+           size.width >= tilesX && size.height >= tilesY;
+}
+
+void clahe(const Size2D &size,
+           const u8 * srcBase, ptrdiff_t srcStride,
+           u8 * dstBase, ptrdiff_t dstStride,
+           u32 tilesX, u32 tilesY, f64 clipLimit)
+{
+    internal::assertSupportedConfiguration(isClaheSupported(size, tilesX, tilesY));
+#ifdef CAROTENE_NEON
+    // like cv::CLAHE, the image is extended by reflection to a multiple of the tile count
+    const size_t tileW = (size.width + tilesX - 1) / tilesX, tileH = (size.height + tilesY - 1) / tilesY;
+    const size_t tileArea = tileW * tileH;
+    s32 clip = 0;
+    if (clipLimit > 0.0)
+        clip = std::max((s32)(clipLimit * tileArea / 256), 1);
+    const f32 lutScale = 255.f / tileArea;
+
+    std::vector<u8> luts(tilesX * tilesY * 256);
+    std::vector<u8> extRow(tileW);
+    for (size_t ty = 0; ty < tilesY; ++ty)
+        for (size_t tx = 0; tx < tilesX; ++tx)
+        {
+            SubHistograms sub;
+            const size_t x0 = tx * tileW, inside = x0 < size.width ? std::min(tileW, size.width - x0) : 0;
+            for (size_t y = ty * tileH; y < (ty + 1) * tileH; ++y)
+            {
+                const u8 * src = internal::getRowPtr(srcBase, srcStride, reflect101(y, size.height));
+                sub.addRow(src + x0, inside);
+                if (inside < tileW)
+                {
+                    for (size_t x = inside; x < tileW; ++x)
+                        extRow[x - inside] = src[reflect101(x0 + x, size.width)];
+                    sub.addRow(&extRow[0], tileW - inside);
+                }
+            }
+
+            s32 hist[256];
+            sub.merge(reinterpret_cast<u32 *>(hist));
+
+            if (clip > 0)
+            {
+                s32 clipped = 0;
+                for (size_t i = 0; i < 256; ++i)
+                    if (hist[i] > clip)
+                    {
+                        clipped += hist[i] - clip;
+                        hist[i] = clip;
+                    }
+
+                s32 batch = clipped / 256, residual = clipped - batch * 256;
+                for (size_t i = 0; i < 256; ++i)
+                    hist[i] += batch;
+                if (residual != 0)
+                {
+                    s32 residualStep = std::max(256 / residual, 1);
+                    for (s32 i = 0; i < 256 && residual > 0; i += residualStep, --residual)
+                        ++hist[i];
+                }
+            }
+
+            u8 * table = &luts[(ty * tilesX + tx) * 256];
+            s32 sum = 0;
+            for (size_t i = 0; i < 256; ++i)
+            {
+                sum += hist[i];
+                table[i] = (u8)std::min(roundHalfEven(sum * lutScale), 255);
+            }
+        }
+
+    // bilinear blend of the tables of the four nearest tile centers, in the float order of
+    // cv::CLAHE; the per column part is shared by all rows
+    std::vector<u32> ind1(size.width), ind2(size.width);
+    std::vector<f32> xa(size.width), xa1(size.width);
+    const f32 invTileW = 1.0f / tileW, invTileH = 1.0f / tileH;
+    for (size_t x = 0; x < size.width; ++x)
+    {
+        f32 txf = x * invTileW - 0.5f;
+        s32 tx1 = (s32)std::floor(txf);
+        xa[x] = txf - tx1;
+        xa1[x] = 1.0f - xa[x];
+        ind1[x] = std::max(tx1, 0) * 256;
+        ind2[x] = std::min(tx1 + 1, (s32)tilesX - 1) * 256;
+    }
+
+    for (size_t y = 0; y < size.height; ++y)
+    {
+        f32 tyf = y * invTileH - 0.5f;
+        s32 ty1 = (s32)std::floor(tyf);
+        f32 ya = tyf - ty1, ya1 = 1.0f - ya;
+        const u8 * lut1 = &luts[std::max(ty1, 0) * tilesX * 256];
+        const u8 * lut2 = &luts[std::min(ty1 + 1, (s32)tilesY - 1) * tilesX * 256];
+
+        const u8 * src = internal::getRowPtr(srcBase, srcStride, y);
+        u8 * dst = internal::getRowPtr(dstBase, dstStride, y);
+        size_t x = 0;
+        for (; x + 8 <= size.width; x += 8)
+        {
+            u8 a[8], b[8], c[8], d[8];
+            for (size_t k = 0; k < 8; ++k)
+            {
+                u32 v = src[x + k], i1 = ind1[x + k] + v, i2 = ind2[x + k] + v;
+                a[k] = lut1[i1];
+                b[k] = lut1[i2];
+                c[k] = lut2[i1];
+                d[k] = lut2[i2];
+            }
+            uint16x8_t va = vmovl_u8(vld1_u8(a)), vb = vmovl_u8(vld1_u8(b));
+            uint16x8_t vc = vmovl_u8(vld1_u8(c)), vd = vmovl_u8(vld1_u8(d));
+
+            int32x4_t r[2];
+            for (size_t h = 0; h < 2; ++h)
+            {
+                float32x4_t vxa = vld1q_f32(&xa[x + 4 * h]), vxa1 = vld1q_f32(&xa1[x + 4 * h]);
+                float32x4_t fa = vcvtq_f32_u32(vmovl_u16(h ? vget_high_u16(va) : vget_low_u16(va)));
+                float32x4_t fb = vcvtq_f32_u32(vmovl_u16(h ? vget_high_u16(vb) : vget_low_u16(vb)));
+                float32x4_t fc = vcvtq_f32_u32(vmovl_u16(h ? vget_high_u16(vc) : vget_low_u16(vc)));
+                float32x4_t fd = vcvtq_f32_u32(vmovl_u16(h ? vget_high_u16(vd) : vget_low_u16(vd)));
+                float32x4_t top = vmlaq_f32(vmulq_f32(fa, vxa1), fb, vxa);
+                float32x4_t bottom = vmlaq_f32(vmulq_f32(fc, vxa1), fd, vxa);
+                r[h] = vroundHalfEvenq(vmlaq_n_f32(vmulq_n_f32(top, ya1), bottom, ya));
+            }
+            uint16x8_t r16 = vcombine_u16(vqmovun_s32(r[0]), vqmovun_s32(r[1]));
+            vst1_u8(dst + x, vqmovn_u16(r16));
+        }
+        for (; x < size.width; ++x)
+        {
+            u32 v = src[x], i1 = ind1[x] + v, i2 = ind2[x] + v;
+            f32 res = (lut1[i1] * xa1[x] + lut1[i2] * xa[x]) * ya1 + (lut2[i1] * xa1[x] + lut2[i2] * xa[x]) * ya;
+            dst[x] = (u8)std::min(roundHalfEven(res), 255);
+        }
+    }
+#else
+    (void)size;
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+    (void)tilesX;
+    (void)tilesY;
+    (void)clipLimit;
+#endif
+}
+
+} // namespace CAROTENE_NS
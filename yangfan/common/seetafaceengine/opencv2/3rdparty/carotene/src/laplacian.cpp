@@ -97,7 +97,7 @@ void Laplacian3x3(const Size2D &size,
                 ptrdiff_t x4 = border == BORDER_MODE_CONSTANT ? x3 - 1 : std::max<ptrdiff_t>(x3 - 1, 0);
 
                 if (border == BORDER_MODE_CONSTANT && x4 < 0)
-                    prevx = borderValue;
+                    prevx = borderValue * 3;
                 else
                     prevx = (srow2 ? srow2[x4] : borderValue) + srow1[x4] + (srow0 ? srow0[x4] : borderValue);
 
@@ -0,0 +1,247 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "common.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+namespace CAROTENE_NS {
+
+bool isMatchTemplateSupported(const Size2D &tmplSize)
+{
+    // the correlation is accumulated in u32 lanes, 65536 products of 255*255 still fit
+    return isSupportedConfiguration() &&
+           tmplSize.width >= 1 && tmplSize.height >= 1 &&
+           tmplSize.width * tmplSize.height <= (1u << 16);
+}
+
+#ifdef CAROTENE_NEON
+
+namespace {
+
+enum MatchMethod
+{
+    MATCH_CCORR,
+    MATCH_SQDIFF
+};
+
+/*
+ * Correlation of one output row. The template is walked element by element and every
+ * element is multiplied, as a broadcast scalar, with 16 consecutive source pixels, so the
+ * 16 outputs of a block stay in registers for the whole template and no horizontal
+ * reduction is needed.
+ */
+void correlateRow(const u8 * const * srcRows, const Size2D &tmplSize,
+                  const u8 * tmplBase, ptrdiff_t tmplStride,
+                  size_t dstWidth, u32 * acc)
+{
+    size_t x = 0;
+
+    for (; x + 16 <= dstWidth; x += 16)
+    {
+        uint32x4_t v_acc0 = vdupq_n_u32(0), v_acc1 = v_acc0, v_acc2 = v_acc0, v_acc3 = v_acc0;
+
+        for (size_t ty = 0; ty < tmplSize.height; ++ty)
+        {
+            const u8 * src = srcRows[ty] + x;
+            const u8 * tmpl = internal::getRowPtr(tmplBase, tmplStride, ty);
+            internal::prefetch(src + 64);
+
+            for (size_t tx = 0; tx < tmplSize.width; ++tx)
+            {
+                uint8x16_t v_src = vld1q_u8(src + tx);
+                uint8x8_t v_tmpl = vld1_dup_u8(tmpl + tx);
+                uint16x8_t v_lo = vmull_u8(vget_low_u8(v_src), v_tmpl);
+                uint16x8_t v_hi = vmull_u8(vget_high_u8(v_src), v_tmpl);
+                v_acc0 = vaddw_u16(v_acc0, vget_low_u16(v_lo));
+                v_acc1 = vaddw_u16(v_acc1, vget_high_u16(v_lo));
+                v_acc2 = vaddw_u16(v_acc2, vget_low_u16(v_hi));
+                v_acc3 = vaddw_u16(v_acc3, vget_high_u16(v_hi));
+            }
+        }
+
+        vst1q_u32(acc + x, v_acc0);
+        vst1q_u32(acc + x + 4, v_acc1);
+        vst1q_u32(acc + x + 8, v_acc2);
+        vst1q_u32(acc + x + 12, v_acc3);
+    }
+
+    for (; x < dstWidth; ++x)
+    {
+        u32 sum = 0;
+        for (size_t ty = 0; ty < tmplSize.height; ++ty)
+        {
+            const u8 * src = srcRows[ty] + x;
+            const u8 * tmpl = internal::getRowPtr(tmplBase, tmplStride, ty);
+            for (size_t tx = 0; tx < tmplSize.width; ++tx)
+                sum += (u32)src[tx] * tmpl[tx];
+        }
+        acc[x] = sum;
+    }
+}
+
+// OpenCV's normalization, with the same guards against rounding noise on flat windows
+inline f32 normalizeScore(f64 num, f64 wndSqsum, f64 tmplNorm, MatchMethod method)
+{
+    f64 t = wndSqsum <= std::min(0.5, 10 * FLT_EPSILON * wndSqsum) ? 0 : std::sqrt(wndSqsum) * tmplNorm;
+    if (std::fabs(num) < t)
+        return (f32)(num / t);
+    if (std::fabs(num) < t * 1.125)
+        return num > 0 ? 1.f : -1.f;
+    return method == MATCH_SQDIFF ? 1.f : 0.f;
+}
+
+/*
+ * Output rows are independent: every band of rows only reads its own source rows and the
+ * matching rows of the square integral, so callers are free to split the work by rows.
+ */
+void matchTemplateRows(const Size2D &srcSize,
+                       const u8 * srcBase, ptrdiff_t srcStride,
+                       const Size2D &tmplSize,
+                       const u8 * tmplBase, ptrdiff_t tmplStride,
+                       f32 * dstBase, ptrdiff_t dstStride,
+                       bool normalize, MatchMethod method)
+{
+    const size_t dstWidth = srcSize.width - tmplSize.width + 1;
+    const size_t dstHeight = srcSize.height - tmplSize.height + 1;
+
+    std::vector<u32> acc(dstWidth);
+    std::vector<const u8 *> srcRows(tmplSize.height);
+
+    // window sums of squares from a square integral with a zero top row and left column
+    const bool needSqsum = normalize || method == MATCH_SQDIFF;
+    const size_t sqsumWidth = srcSize.width + 1;
+    std::vector<f64> sqsum;
+    f64 tmplSqsum = 0, tmplSum = 0;
+    if (needSqsum)
+    {
+        sqsum.assign(sqsumWidth * (srcSize.height + 1), 0.);
+        sqrIntegral(srcSize, srcBase, srcStride, &sqsum[sqsumWidth + 1], sqsumWidth * sizeof(f64));
+        CAROTENE_NS::sqsum(tmplSize, tmplBase, tmplStride, &tmplSum, &tmplSqsum, 1);
+    }
+    const f64 tmplNorm = std::sqrt(tmplSqsum);
+
+    for (size_t y = 0; y < dstHeight; ++y)
+    {
+        for (size_t ty = 0; ty < tmplSize.height; ++ty)
+            srcRows[ty] = internal::getRowPtr(srcBase, srcStride, y + ty);
+        correlateRow(&srcRows[0], tmplSize, tmplBase, tmplStride, dstWidth, &acc[0]);
+
+        f32 * dst = internal::getRowPtr(dstBase, dstStride, y);
+        if (!needSqsum)
+        {
+            size_t x = 0;
+            for (; x + 4 <= dstWidth; x += 4)
+                vst1q_f32(dst + x, vcvtq_f32_u32(vld1q_u32(&acc[x])));
+            for (; x < dstWidth; ++x)
+                dst[x] = (f32)acc[x];
+            continue;
+        }
+
+        const f64 * sqTop = &sqsum[y * sqsumWidth];
+        const f64 * sqBottom = &sqsum[(y + tmplSize.height) * sqsumWidth];
+        for (size_t x = 0; x < dstWidth; ++x)
+        {
+            f64 wndSqsum = sqBottom[x + tmplSize.width] - sqBottom[x] - sqTop[x + tmplSize.width] + sqTop[x];
+            f64 num = method == MATCH_SQDIFF ? wndSqsum - 2. * acc[x] + tmplSqsum : (f64)acc[x];
+            dst[x] = normalize ? normalizeScore(num, wndSqsum, tmplNorm, method) : (f32)num;
+        }
+    }
+}
+
+} // namespace
+
+#endif
+
+void matchTemplate(const Size2D &srcSize,
+                   const u8 * srcBase, ptrdiff_t srcStride,
+                   const Size2D &tmplSize,
+                   const u8 * tmplBase, ptrdiff_t tmplStride,
+                   f32 * dstBase, ptrdiff_t dstStride,
+                   bool normalize)
+{
+    internal::assertSupportedConfiguration(isMatchTemplateSupported(tmplSize) &&
+                                           srcSize.width >= tmplSize.width &&
+                                           srcSize.height >= tmplSize.height);
+#ifdef CAROTENE_NEON
+    matchTemplateRows(srcSize, srcBase, srcStride, tmplSize, tmplBase, tmplStride,
+                      dstBase, dstStride, normalize, MATCH_CCORR);
+#else
+    (void)srcSize;
+    (void)srcBase;
+    (void)srcStride;
+    (void)tmplSize;
+    (void)tmplBase;
+    (void)tmplStride;
+    (void)dstBase;
+    (void)dstStride;
+    (void)normalize;
+#endif
+}
+
+void matchTemplateSqDiff(const Size2D &srcSize,
+                         const u8 * srcBase, ptrdiff_t srcStride,
+                         const Size2D &tmplSize,
+                         const u8 * tmplBase, ptrdiff_t tmplStride,
+                         f32 * dstBase, ptrdiff_t dstStride,
+                         bool normalize)
+{
+    internal::assertSupportedConfiguration(isMatchTemplateSupported(tmplSize) &&
+                                           srcSize.width >= tmplSize.width &&
+                                           srcSize.height >= tmplSize.height);
+#ifdef CAROTENE_NEON
+    matchTemplateRows(srcSize, srcBase, srcStride, tmplSize, tmplBase, tmplStride,
+                      dstBase, dstStride, normalize, MATCH_SQDIFF);
+#else
+    (void)srcSize;
+    (void)srcBase;
+    (void)srcStride;
+    (void)tmplSize;
+    (void)tmplBase;
+    (void)tmplStride;
+    (void)dstBase;
+    (void)dstStride;
+    (void)normalize;
+#endif
+}
+
+} // namespace CAROTENE_NS
@@ -37,7 +37,11 @@
  * the use of this software, even if advised of the possibility of such damage.
  */
 
+#include <algorithm>
+#include <vector>
+
 #include "common.hpp"
+#include "vtransform.hpp"
 
 /*
  * The code here is based on the code in
@@ -224,4 +228,254 @@ medianBlur3x3_tailBody:
 #endif
 }
 
+#ifdef CAROTENE_NEON
+namespace {
+
+/*
+    Larger apertures sort every column of the window first. A sorted column is shared by the
+    k windows that contain it, so each output only pays for picking the median out of k
+    sorted columns: Batcher's odd-even merge of the columns, with the comparators that
+    cannot reach the middle rank removed. Both selection networks were checked exhaustively
+    on 0-1 inputs, which by the 0-1 principle covers all inputs with sorted columns.
+    v[c * k + r] is rank r of column c, MEDIAN_SORT leaves the minimum in the first slot.
+*/
+
+#define MEDIAN_SORT(a, b) { vec128 t = internal::vminq(v[a], v[b]); v[b] = internal::vmaxq(v[a], v[b]); v[a] = t; }
+#define MEDIAN_MIN(a, b) v[a] = internal::vminq(v[a], v[b])
+#define MEDIAN_MAX(a, b) v[b] = internal::vmaxq(v[a], v[b])
+
+#define MEDIAN_COLSORT5 \
+    MEDIAN_SORT(0, 1); MEDIAN_SORT(3, 4); MEDIAN_SORT(2, 4); MEDIAN_SORT(2, 3); MEDIAN_SORT(0, 3); \
+    MEDIAN_SORT(0, 2); MEDIAN_SORT(1, 4); MEDIAN_SORT(1, 3); MEDIAN_SORT(1, 2)
+
+#define MEDIAN_COLSORT7 \
+    MEDIAN_SORT(0, 6); MEDIAN_SORT(2, 3); MEDIAN_SORT(4, 5); MEDIAN_SORT(0, 2); MEDIAN_SORT(1, 4); \
+    MEDIAN_SORT(3, 6); MEDIAN_SORT(0, 1); MEDIAN_SORT(2, 5); MEDIAN_SORT(3, 4); MEDIAN_SORT(1, 2); \
+    MEDIAN_SORT(4, 6); MEDIAN_SORT(2, 3); MEDIAN_SORT(4, 5); MEDIAN_SORT(1, 2); MEDIAN_SORT(3, 4); \
+    MEDIAN_SORT(5, 6)
+
+#define MEDIAN_SELECT25                                                                 \
+    MEDIAN_SORT(0, 5); MEDIAN_SORT(4, 9); MEDIAN_SORT(4, 5); MEDIAN_SORT(2, 7);         \
+    MEDIAN_SORT(2, 4); MEDIAN_SORT(7, 5); MEDIAN_SORT(1, 6); MEDIAN_SORT(3, 8);         \
+    MEDIAN_SORT(3, 6); MEDIAN_SORT(1, 2); MEDIAN_SORT(3, 4); MEDIAN_SORT(6, 7);         \
+    MEDIAN_SORT(8, 5); MEDIAN_SORT(10, 15); MEDIAN_SORT(14, 19); MEDIAN_SORT(14, 15);   \
+    MEDIAN_SORT(12, 17); MEDIAN_SORT(12, 14); MEDIAN_SORT(17, 15); MEDIAN_SORT(11, 16); \
+    MEDIAN_SORT(13, 18); MEDIAN_SORT(13, 16); MEDIAN_SORT(11, 12); MEDIAN_SORT(13, 14); \
+    MEDIAN_SORT(16, 17); MEDIAN_SORT(18, 15); MEDIAN_SORT(0, 10); MEDIAN_SORT(5, 15);   \
+    MEDIAN_SORT(5, 10); MEDIAN_SORT(4, 14); MEDIAN_SORT(4, 5); MEDIAN_SORT(14, 10);     \
+    MEDIAN_SORT(2, 12); MEDIAN_SORT(7, 17); MEDIAN_SORT(7, 12); MEDIAN_SORT(2, 4);      \
+    MEDIAN_SORT(7, 5); MEDIAN_SORT(12, 14); MEDIAN_SORT(17, 10); MEDIAN_SORT(1, 11);    \
+    MEDIAN_SORT(9, 19); MEDIAN_SORT(9, 11); MEDIAN_SORT(6, 16); MEDIAN_SORT(6, 9);      \
+    MEDIAN_SORT(16, 11); MEDIAN_SORT(3, 13); MEDIAN_SORT(8, 18); MEDIAN_SORT(8, 13);    \
+    MEDIAN_SORT(3, 6); MEDIAN_SORT(8, 9); MEDIAN_SORT(13, 16); MEDIAN_SORT(18, 11);     \
+    MEDIAN_SORT(1, 2); MEDIAN_SORT(3, 4); MEDIAN_MAX(6, 7); MEDIAN_SORT(8, 5);          \
+    MEDIAN_SORT(9, 12); MEDIAN_SORT(13, 14); MEDIAN_MIN(16, 17); MEDIAN_MAX(18, 10);    \
+    MEDIAN_SORT(11, 15); MEDIAN_SORT(22, 24); MEDIAN_SORT(21, 22); MEDIAN_SORT(23, 24); \
+    MEDIAN_SORT(22, 24); MEDIAN_SORT(21, 22); MEDIAN_SORT(23, 24); MEDIAN_MAX(0, 20);   \
+    MEDIAN_MIN(10, 20); MEDIAN_MAX(5, 10); MEDIAN_MAX(4, 24); MEDIAN_MIN(14, 24);       \
+    MEDIAN_MIN(14, 10); MEDIAN_MAX(2, 22); MEDIAN_MIN(15, 22); MEDIAN_MIN(12, 15);      \
+    MEDIAN_MAX(7, 12); MEDIAN_MAX(12, 14); MEDIAN_MAX(1, 21); MEDIAN_MIN(11, 21);       \
+    MEDIAN_MAX(9, 11); MEDIAN_MIN(16, 11); MEDIAN_MAX(3, 23); MEDIAN_MIN(19, 23);       \
+    MEDIAN_MIN(13, 19); MEDIAN_MAX(8, 13); MEDIAN_MIN(13, 16); MEDIAN_MAX(13, 14);
+
+#define MEDIAN_SELECT49                                                                 \
+    MEDIAN_SORT(0, 7); MEDIAN_SORT(4, 11); MEDIAN_SORT(4, 7); MEDIAN_SORT(2, 9);        \
+    MEDIAN_SORT(6, 13); MEDIAN_SORT(6, 9); MEDIAN_SORT(2, 4); MEDIAN_SORT(6, 7);        \
+    MEDIAN_SORT(9, 11); MEDIAN_SORT(1, 8); MEDIAN_SORT(5, 12); MEDIAN_SORT(5, 8);       \
+    MEDIAN_SORT(3, 10); MEDIAN_SORT(3, 5); MEDIAN_SORT(10, 8); MEDIAN_SORT(1, 2);       \
+    MEDIAN_SORT(3, 4); MEDIAN_SORT(5, 6); MEDIAN_SORT(10, 7); MEDIAN_SORT(8, 9);        \
+    MEDIAN_SORT(12, 11); MEDIAN_SORT(14, 21); MEDIAN_SORT(18, 25); MEDIAN_SORT(18, 21); \
+    MEDIAN_SORT(16, 23); MEDIAN_SORT(20, 27); MEDIAN_SORT(20, 23); MEDIAN_SORT(16, 18); \
+    MEDIAN_SORT(20, 21); MEDIAN_SORT(23, 25); MEDIAN_SORT(15, 22); MEDIAN_SORT(19, 26); \
+    MEDIAN_SORT(19, 22); MEDIAN_SORT(17, 24); MEDIAN_SORT(17, 19); MEDIAN_SORT(24, 22); \
+    MEDIAN_SORT(15, 16); MEDIAN_SORT(17, 18); MEDIAN_SORT(19, 20); MEDIAN_SORT(24, 21); \
+    MEDIAN_SORT(22, 23); MEDIAN_SORT(26, 25); MEDIAN_SORT(0, 14); MEDIAN_SORT(7, 21);   \
+    MEDIAN_SORT(7, 14); MEDIAN_SORT(4, 18); MEDIAN_SORT(11, 25); MEDIAN_SORT(11, 18);   \
+    MEDIAN_SORT(4, 7); MEDIAN_SORT(11, 14); MEDIAN_SORT(18, 21); MEDIAN_SORT(2, 16);    \
+    MEDIAN_SORT(9, 23); MEDIAN_SORT(9, 16); MEDIAN_SORT(6, 20); MEDIAN_SORT(6, 9);      \
+    MEDIAN_SORT(20, 16); MEDIAN_SORT(2, 4); MEDIAN_SORT(6, 7); MEDIAN_SORT(9, 11);      \
+    MEDIAN_SORT(20, 14); MEDIAN_SORT(16, 18); MEDIAN_SORT(23, 21); MEDIAN_SORT(1, 15);  \
+    MEDIAN_SORT(8, 22); MEDIAN_SORT(8, 15); MEDIAN_SORT(5, 19); MEDIAN_SORT(13, 27);    \
+    MEDIAN_SORT(13, 19); MEDIAN_SORT(5, 8); MEDIAN_SORT(13, 15); MEDIAN_SORT(19, 22);   \
+    MEDIAN_SORT(3, 17); MEDIAN_SORT(12, 26); MEDIAN_SORT(12, 17); MEDIAN_SORT(10, 24);  \
+    MEDIAN_SORT(10, 12); MEDIAN_SORT(24, 17); MEDIAN_SORT(3, 5); MEDIAN_SORT(10, 8);    \
+    MEDIAN_SORT(12, 13); MEDIAN_SORT(24, 15); MEDIAN_SORT(17, 19); MEDIAN_SORT(26, 22); \
+    MEDIAN_SORT(1, 2); MEDIAN_SORT(3, 4); MEDIAN_SORT(5, 6); MEDIAN_SORT(10, 7);        \
+    MEDIAN_SORT(8, 9); MEDIAN_SORT(12, 11); MEDIAN_SORT(13, 20); MEDIAN_SORT(24, 14);   \
+    MEDIAN_SORT(15, 16); MEDIAN_SORT(17, 18); MEDIAN_SORT(19, 23); MEDIAN_SORT(26, 21); \
+    MEDIAN_SORT(22, 25); MEDIAN_SORT(28, 35); MEDIAN_SORT(32, 39); MEDIAN_SORT(32, 35); \
+    MEDIAN_SORT(30, 37); MEDIAN_SORT(34, 41); MEDIAN_SORT(34, 37); MEDIAN_SORT(30, 32); \
+    MEDIAN_SORT(34, 35); MEDIAN_SORT(37, 39); MEDIAN_SORT(29, 36); MEDIAN_SORT(33, 40); \
+    MEDIAN_SORT(33, 36); MEDIAN_SORT(31, 38); MEDIAN_SORT(31, 33); MEDIAN_SORT(38, 36); \
+    MEDIAN_SORT(29, 30); MEDIAN_SORT(31, 32); MEDIAN_SORT(33, 34); MEDIAN_SORT(38, 35); \
+    MEDIAN_SORT(36, 37); MEDIAN_SORT(40, 39); MEDIAN_SORT(44, 46); MEDIAN_SORT(45, 47); \
+    MEDIAN_SORT(43, 44); MEDIAN_SORT(45, 46); MEDIAN_SORT(47, 48); MEDIAN_SORT(28, 42); \
+    MEDIAN_SORT(35, 42); MEDIAN_SORT(32, 46); MEDIAN_SORT(39, 46); MEDIAN_SORT(32, 35); \
+    MEDIAN_SORT(39, 42); MEDIAN_SORT(30, 44); MEDIAN_SORT(37, 44); MEDIAN_SORT(34, 48); \
+    MEDIAN_SORT(34, 37); MEDIAN_SORT(48, 44); MEDIAN_SORT(30, 32); MEDIAN_SORT(34, 35); \
+    MEDIAN_SORT(37, 39); MEDIAN_SORT(48, 42); MEDIAN_SORT(44, 46); MEDIAN_SORT(29, 43); \
+    MEDIAN_SORT(36, 43); MEDIAN_SORT(33, 47); MEDIAN_SORT(41, 47); MEDIAN_SORT(33, 36); \
+    MEDIAN_SORT(41, 43); MEDIAN_SORT(31, 45); MEDIAN_SORT(40, 45); MEDIAN_SORT(38, 40); \
+    MEDIAN_SORT(31, 33); MEDIAN_SORT(38, 36); MEDIAN_SORT(40, 41); MEDIAN_SORT(45, 43); \
+    MEDIAN_SORT(29, 30); MEDIAN_SORT(31, 32); MEDIAN_SORT(33, 34); MEDIAN_SORT(38, 35); \
+    MEDIAN_SORT(36, 37); MEDIAN_SORT(40, 39); MEDIAN_SORT(41, 48); MEDIAN_SORT(45, 42); \
+    MEDIAN_SORT(43, 44); MEDIAN_SORT(47, 46); MEDIAN_MAX(0, 28); MEDIAN_MIN(14, 42);    \
+    MEDIAN_MAX(14, 28); MEDIAN_MAX(7, 35); MEDIAN_MIN(21, 35); MEDIAN_MIN(21, 28);      \
+    MEDIAN_MAX(4, 32); MEDIAN_MIN(18, 46); MEDIAN_MIN(18, 32); MEDIAN_MIN(11, 39);      \
+    MEDIAN_MAX(11, 18); MEDIAN_MAX(18, 21); MEDIAN_MAX(2, 30); MEDIAN_MIN(16, 44);      \
+    MEDIAN_MAX(16, 30); MEDIAN_MAX(9, 37); MEDIAN_MIN(25, 37); MEDIAN_MIN(25, 30);      \
+    MEDIAN_MAX(6, 34); MEDIAN_MIN(23, 34); MEDIAN_MIN(20, 48); MEDIAN_MAX(20, 23);      \
+    MEDIAN_MIN(23, 25); MEDIAN_MAX(23, 21); MEDIAN_MAX(1, 29); MEDIAN_MIN(15, 43);      \
+    MEDIAN_MAX(15, 29); MEDIAN_MAX(8, 36); MEDIAN_MIN(22, 36); MEDIAN_MIN(22, 29);      \
+    MEDIAN_MAX(5, 33); MEDIAN_MIN(19, 33); MEDIAN_MIN(13, 41); MEDIAN_MAX(13, 19);      \
+    MEDIAN_MAX(19, 22); MEDIAN_MAX(3, 31); MEDIAN_MIN(17, 47); MEDIAN_MAX(17, 31);      \
+    MEDIAN_MAX(12, 40); MEDIAN_MIN(27, 40); MEDIAN_MIN(27, 31); MEDIAN_MAX(10, 38);     \
+    MEDIAN_MIN(26, 38); MEDIAN_MIN(24, 45); MEDIAN_MAX(24, 26); MEDIAN_MIN(26, 27);     \
+    MEDIAN_MIN(26, 22); MEDIAN_MAX(26, 21);
+
+template <int k> struct MedianNetwork;
+
+template <> struct MedianNetwork<5>
+{
+    template <typename vec128>
+    static inline void sortColumn(vec128 * v) { MEDIAN_COLSORT5; }
+
+    template <typename vec128>
+    static inline vec128 select(vec128 * v) { MEDIAN_SELECT25; return v[14]; }
+};
+
+template <> struct MedianNetwork<7>
+{
+    template <typename vec128>
+    static inline void sortColumn(vec128 * v) { MEDIAN_COLSORT7; }
+
+    template <typename vec128>
+    static inline vec128 select(vec128 * v) { MEDIAN_SELECT49; return v[21]; }
+};
+
+#undef MEDIAN_SORT
+#undef MEDIAN_MIN
+#undef MEDIAN_MAX
+
+// Copies source row `y` with k / 2 border pixels on both sides. Rows and columns past the
+// margin replicate the last available one
+template <typename T>
+void medianPadRow(const Size2D &size, u32 cn, size_t r,
+                  const T * srcBase, ptrdiff_t srcStride, const Margin &srcMargin,
+                  ptrdiff_t y, T * dst)
+{
+    y = std::max(y, -(ptrdiff_t)srcMargin.top);
+    y = std::min(y, (ptrdiff_t)(size.height + srcMargin.bottom) - 1);
+    const T * src = reinterpret_cast<const T *>(reinterpret_cast<const u8 *>(srcBase) + y * srcStride);
+
+    ptrdiff_t left = (ptrdiff_t)std::min<size_t>(srcMargin.left, r);
+    ptrdiff_t right = (ptrdiff_t)(size.width + std::min<size_t>(srcMargin.right, r)) - 1;
+    for (ptrdiff_t x = -(ptrdiff_t)r; x < (ptrdiff_t)(size.width + r); ++x)
+    {
+        ptrdiff_t sx = std::min(std::max(x, -left), right);
+        for (u32 c = 0; c < cn; ++c)
+            dst[(x + r) * cn + c] = src[sx * cn + c];
+    }
+}
+
+template <int k, typename T>
+void medianFilterKxK(const Size2D &size, u32 cn,
+                     const T * srcBase, ptrdiff_t srcStride, const Margin &srcMargin,
+                     T * dstBase, ptrdiff_t dstStride)
+{
+    typedef typename internal::VecTraits<T>::vec128 vec128;
+    const size_t r = k / 2, step = sizeof(vec128) / sizeof(T);
+    const size_t colsn = size.width * cn;
+    // every row is long enough for the loads of the last, partial output vector
+    const size_t rown = ((colsn + step - 1) / step * step + 2 * r * cn + step - 1) / step * step;
+
+    // k padded source rows, row y lives in slot y mod k; and the k ranks of every column
+    std::vector<T> rows(k * rown), ranks(k * rown);
+    T tail[sizeof(vec128) / sizeof(T)];
+
+    for (ptrdiff_t y = -(ptrdiff_t)r; y < (ptrdiff_t)r; ++y)
+        medianPadRow(size, cn, r, srcBase, srcStride, srcMargin, y, &rows[((y + k) % k) * rown]);
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        // rows above i were saved before they could be overwritten, so dst may alias src
+        medianPadRow(size, cn, r, srcBase, srcStride, srcMargin, (ptrdiff_t)(i + r), &rows[((i + r) % k) * rown]);
+
+        const T * row[k];
+        for (size_t m = 0; m < (size_t)k; ++m)
+            row[m] = &rows[((i + m + k - r) % k) * rown];
+
+        for (size_t x = 0; x < rown; x += step)
+        {
+            vec128 v[k];
+            for (size_t m = 0; m < (size_t)k; ++m)
+                v[m] = internal::vld1q(row[m] + x);
+            MedianNetwork<k>::sortColumn(v);
+            for (size_t m = 0; m < (size_t)k; ++m)
+                internal::vst1q(&ranks[m * rown + x], v[m]);
+        }
+
+        T * dst = internal::getRowPtr(dstBase, dstStride, i);
+        for (size_t j = 0; j < colsn; j += step)
+        {
+            vec128 v[k * k];
+            for (size_t c = 0; c < (size_t)k; ++c)
+                for (size_t m = 0; m < (size_t)k; ++m)
+                    v[c * k + m] = internal::vld1q(&ranks[m * rown + j + c * cn]);
+            vec128 med = MedianNetwork<k>::select(v);
+
+            if (j + step <= colsn)
+                internal::vst1q(dst + j, med);
+            else
+            {
+                internal::vst1q(tail, med);
+                std::copy(tail, tail + (colsn - j), dst + j);
+            }
+        }
+    }
+}
+
+} // namespace
+#endif
+
+bool isMedianFilter5x5Supported(const Size2D &size, u32 numChannels)
+{
+    return isSupportedConfiguration() && size.width > 0 && numChannels >= 1 && numChannels <= 4;
+}
+
+bool isMedianFilter7x7Supported(const Size2D &size, u32 numChannels)
+{
+    return isSupportedConfiguration() && size.width > 0 && numChannels >= 1 && numChannels <= 4;
+}
+
+#ifdef CAROTENE_NEON
+
+#define MEDIAN_FUNC(k, T)                                                                \
+void medianFilter##k##x##k(const Size2D &size, u32 numChannels,                        \
+                           const T *srcBase, ptrdiff_t srcStride,                      \
+                           const Margin &srcMargin,                                    \
+                           T *dstBase, ptrdiff_t dstStride)                            \
+{                                                                                      \
+    internal::assertSupportedConfiguration(isMedianFilter##k##x##k##Supported(size, numChannels)); \
+    medianFilterKxK<k>(size, numChannels, srcBase, srcStride, srcMargin, dstBase, dstStride); \
+}
+
+#else
+
+#define MEDIAN_FUNC(k, T)                                                                \
+void medianFilter##k##x##k(const Size2D &size, u32 numChannels,                        \
+                           const T *, ptrdiff_t,                                       \
+                           const Margin &,                                             \
+                           T *, ptrdiff_t)                                             \
+{                                                                                      \
+    internal::assertSupportedConfiguration(isMedianFilter##k##x##k##Supported(size, numChannels)); \
+}
+
+#endif
+
+MEDIAN_FUNC(5, u8)
+MEDIAN_FUNC(5, u16)
+MEDIAN_FUNC(7, u8)
+MEDIAN_FUNC(7, u16)
+
 } // namespace CAROTENE_NS
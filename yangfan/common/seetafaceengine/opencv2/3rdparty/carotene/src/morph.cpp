@@ -0,0 +1,469 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "common.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace CAROTENE_NS {
+
+namespace {
+
+bool isMorphBorder(BORDER_MODE border)
+{
+    return border == BORDER_MODE_UNDEFINED ||
+           border == BORDER_MODE_CONSTANT ||
+           border == BORDER_MODE_REPLICATE ||
+           border == BORDER_MODE_REFLECT ||
+           border == BORDER_MODE_REFLECT101 ||
+           border == BORDER_MODE_WRAP;
+}
+
+bool isMorphSupported(const Size2D &ssize, u32 cn, const Size2D &ksize, size_t anchorX, size_t anchorY,
+                      BORDER_MODE rowBorderType, BORDER_MODE columnBorderType)
+{
+    return isSupportedConfiguration() &&
+           ssize.width >= 1 && ssize.height >= 1 && cn >= 1 && cn <= 4 &&
+           anchorX < ksize.width && anchorY < ksize.height &&
+           isMorphBorder(rowBorderType) && isMorphBorder(columnBorderType);
+}
+
+#ifdef CAROTENE_NEON
+
+enum
+{
+    // rows of one horizontal van Herk/Gil-Werman band: a q register holds one column of it
+    BAND_ROWS = 16,
+    // kernel sides up to this size take the plain min/max, larger ones van Herk/Gil-Werman
+    DIRECT_KSIZE = 3
+};
+
+struct MinOp
+{
+    static uint8x16_t vec(uint8x16_t a, uint8x16_t b) { return vminq_u8(a, b); }
+    static u8 scalar(u8 a, u8 b) { return std::min(a, b); }
+};
+
+struct MaxOp
+{
+    static uint8x16_t vec(uint8x16_t a, uint8x16_t b) { return vmaxq_u8(a, b); }
+    static u8 scalar(u8 a, u8 b) { return std::max(a, b); }
+};
+
+template <typename Op>
+void combineRows(u8 * dst, const u8 * a, const u8 * b, size_t n)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        internal::prefetch(a + i);
+        internal::prefetch(b + i);
+        vst1q_u8(dst + i, Op::vec(vld1q_u8(a + i), vld1q_u8(b + i)));
+    }
+    for (; i < n; ++i)
+        dst[i] = Op::scalar(a[i], b[i]);
+}
+
+void transpose16x16(const u8 * src, ptrdiff_t srcStride, u8 * dst, ptrdiff_t dstStride)
+{
+    uint8x16_t r[16];
+    for (size_t i = 0; i < 16; ++i)
+        r[i] = vld1q_u8(src + i * srcStride);
+
+    for (size_t i = 0; i < 16; i += 2)
+    {
+        uint8x16x2_t t = vtrnq_u8(r[i], r[i + 1]);
+        r[i] = t.val[0];
+        r[i + 1] = t.val[1];
+    }
+    for (size_t i = 0; i < 16; i += 4)
+        for (size_t j = 0; j < 2; ++j)
+        {
+            uint16x8x2_t t = vtrnq_u16(vreinterpretq_u16_u8(r[i + j]), vreinterpretq_u16_u8(r[i + j + 2]));
+            r[i + j] = vreinterpretq_u8_u16(t.val[0]);
+            r[i + j + 2] = vreinterpretq_u8_u16(t.val[1]);
+        }
+    for (size_t i = 0; i < 16; i += 8)
+        for (size_t j = 0; j < 4; ++j)
+        {
+            uint32x4x2_t t = vtrnq_u32(vreinterpretq_u32_u8(r[i + j]), vreinterpretq_u32_u8(r[i + j + 4]));
+            r[i + j] = vreinterpretq_u8_u32(t.val[0]);
+            r[i + j + 4] = vreinterpretq_u8_u32(t.val[1]);
+        }
+    for (size_t j = 0; j < 8; ++j)
+    {
+        uint8x16_t a = r[j], b = r[j + 8];
+        r[j] = vcombine_u8(vget_low_u8(a), vget_low_u8(b));
+        r[j + 8] = vcombine_u8(vget_high_u8(a), vget_high_u8(b));
+    }
+
+    for (size_t i = 0; i < 16; ++i)
+        vst1q_u8(dst + i * dstStride, r[i]);
+}
+
+/*
+    Erosion or dilation by a rectangle, separated into a column pass and a row pass.
+
+    Source rows are first extended horizontally by the kernel with the row border applied, so
+    both passes see plain arrays. Sides larger than DIRECT_KSIZE use van Herk/Gil-Werman: the
+    input is cut into blocks of k, and every window is the combination of a suffix of one block
+    and a prefix of the next one, three operations per element for any k. The column pass keeps
+    the suffixes of the current block and the running prefix of the next one. The row pass runs
+    on bands of BAND_ROWS rows transposed so that the sequential scans are vertical in registers.
+*/
+template <typename Op>
+class Morphology
+{
+public:
+    Morphology(const Size2D &ssize, u32 cn_, const u8 * srcBase_, ptrdiff_t srcStride_,
+               const Size2D &ksize, size_t anchorX, size_t anchorY,
+               BORDER_MODE rowBorderType, BORDER_MODE columnBorderType,
+               const u8 * borderValues, const Margin &margin_) :
+        width(ssize.width), height(ssize.height), cn(cn_), kw(ksize.width), kh(ksize.height),
+        ax(anchorX), ay(anchorY), srcBase(srcBase_), srcStride(srcStride_), margin(margin_),
+        columnBorder(columnBorderType == BORDER_MODE_UNDEFINED ? BORDER_MODE_REPLICATE : columnBorderType),
+        block(-1)
+    {
+        BORDER_MODE rowBorder = rowBorderType == BORDER_MODE_UNDEFINED ? BORDER_MODE_REPLICATE : rowBorderType;
+        extPixels = width + kw - 1;
+        n = width * cn;
+        extN = extPixels * cn;
+        extNPad = (extN + 15) & ~(size_t)15;
+
+        // extended pixel i is source pixel i - ax; record where the real data ends and the border starts
+        realBegin = (size_t)std::max<ptrdiff_t>(0, (ptrdiff_t)ax - (ptrdiff_t)margin.left);
+        realEnd = std::min(extPixels, width + margin.right + ax);
+        colMap.resize(extPixels);
+        colConst.resize(extPixels);
+        for (size_t i = 0; i < extPixels; ++i)
+        {
+            ptrdiff_t p = (ptrdiff_t)i - (ptrdiff_t)ax;
+            colConst[i] = (i < realBegin || i >= realEnd) && rowBorder == BORDER_MODE_CONSTANT;
+            colMap[i] = colConst[i] ? 0 : internal::borderInterpolate(p, width, rowBorder, margin.left, margin.right);
+        }
+
+        values.resize(cn);
+        for (size_t c = 0; c < cn; ++c)
+            values[c] = borderValues ? borderValues[c] : 0;
+        constRow.resize(extN);
+        for (size_t i = 0; i < extN; ++i)
+            constRow[i] = values[i % cn];
+        rowBuf.resize(extNPad);
+    }
+
+    void run(u8 * dstBase, ptrdiff_t dstStride)
+    {
+        std::vector<u8> _vrow(extNPad);
+        if (kh > DIRECT_KSIZE)
+        {
+            suffix.resize(kh * extN);
+            prefix.resize(extN);
+        }
+
+        if (kw <= DIRECT_KSIZE)
+        {
+            for (size_t y = 0; y < height; ++y)
+            {
+                vertical(y, &_vrow[0]);
+                horizontalDirect(&_vrow[0], internal::getRowPtr(dstBase, dstStride, y));
+            }
+            return;
+        }
+
+        std::vector<u8> band(BAND_ROWS * extNPad), bandT(extNPad * BAND_ROWS), scan(extNPad * BAND_ROWS);
+        for (size_t y0 = 0; y0 < height; y0 += BAND_ROWS)
+        {
+            size_t rows = std::min<size_t>(BAND_ROWS, height - y0);
+            for (size_t r = 0; r < rows; ++r)
+                vertical(y0 + r, &band[r * extNPad]);
+            horizontalBand(&band[0], &bandT[0], &scan[0]);
+            for (size_t r = 0; r < rows; ++r)
+                std::memcpy(internal::getRowPtr(dstBase, dstStride, y0 + r), &band[r * extNPad], n);
+        }
+    }
+
+private:
+    // Source row of the window row q (output row q - ay + kernel row), extended horizontally
+    const u8 * sourceRow(size_t q)
+    {
+        ptrdiff_t r = (ptrdiff_t)q - (ptrdiff_t)ay;
+        if (r < -(ptrdiff_t)margin.top || r >= (ptrdiff_t)(height + margin.bottom))
+        {
+            if (columnBorder == BORDER_MODE_CONSTANT)
+                return &constRow[0];
+            r = internal::borderInterpolate(r, height, columnBorder, margin.top, margin.bottom);
+        }
+        const u8 * row = srcBase + r * srcStride;
+        if (realBegin == 0 && realEnd == extPixels)
+            return row - (ptrdiff_t)(ax * cn);
+
+        u8 * buf = &rowBuf[0];
+        if (realEnd > realBegin)
+            std::memcpy(buf + realBegin * cn, row + ((ptrdiff_t)realBegin - (ptrdiff_t)ax) * (ptrdiff_t)cn,
+                        (realEnd - realBegin) * cn);
+        for (size_t i = 0; i < extPixels; ++i)
+        {
+            if (i == realBegin && realEnd > realBegin)
+                i = realEnd;
+            if (i >= extPixels)
+                break;
+            for (size_t c = 0; c < cn; ++c)
+                buf[i * cn + c] = colConst[i] ? values[c] : row[colMap[i] * (ptrdiff_t)cn + (ptrdiff_t)c];
+        }
+        return buf;
+    }
+
+    // Column pass for output row y over the extended width; rows must come in order
+    void vertical(size_t y, u8 * out)
+    {
+        if (kh <= DIRECT_KSIZE)
+        {
+            std::memcpy(out, sourceRow(y), extN);
+            for (size_t j = 1; j < kh; ++j)
+                combineRows<Op>(out, out, sourceRow(y + j), extN);
+            return;
+        }
+
+        size_t b = y / kh, i = y % kh;
+        if ((ptrdiff_t)b != block)
+        {
+            for (size_t j = kh; j-- > 0; )
+            {
+                const u8 * row = sourceRow(b * kh + j);
+                u8 * s = &suffix[j * extN];
+                if (j + 1 == kh)
+                    std::memcpy(s, row, extN);
+                else
+                    combineRows<Op>(s, row, s + extN, extN);
+            }
+            block = (ptrdiff_t)b;
+        }
+
+        if (i == 0)
+        {
+            std::memcpy(out, &suffix[0], extN);
+            return;
+        }
+        const u8 * row = sourceRow(y + kh - 1);
+        if (i == 1)
+            std::memcpy(&prefix[0], row, extN);
+        else
+            combineRows<Op>(&prefix[0], &prefix[0], row, extN);
+        combineRows<Op>(out, &suffix[i * extN], &prefix[0], extN);
+    }
+
+    void horizontalDirect(const u8 * v, u8 * drow) const
+    {
+        const size_t step = cn;
+        size_t x = 0;
+        for (; x + 16 <= n; x += 16)
+        {
+            uint8x16_t acc = vld1q_u8(v + x);
+            for (size_t k = 1; k < kw; ++k)
+                acc = Op::vec(acc, vld1q_u8(v + x + k * step));
+            vst1q_u8(drow + x, acc);
+        }
+        for (; x < n; ++x)
+        {
+            u8 acc = v[x];
+            for (size_t k = 1; k < kw; ++k)
+                acc = Op::scalar(acc, v[x + k * step]);
+            drow[x] = acc;
+        }
+    }
+
+    // Row pass of a band, in place: column e of the band becomes the q register at bandT + e * 16
+    void horizontalBand(u8 * band, u8 * bandT, u8 * scan) const
+    {
+        for (size_t e = 0; e < extNPad; e += 16)
+            transpose16x16(band + e, extNPad, bandT + e * 16, 16);
+
+        // suffixes within blocks of kw pixels
+        for (size_t p = extPixels; p-- > 0; )
+            for (size_t c = 0; c < cn; ++c)
+            {
+                size_t e = p * cn + c;
+                uint8x16_t v = vld1q_u8(bandT + e * 16);
+                if (p % kw != kw - 1 && p + 1 < extPixels)
+                    v = Op::vec(v, vld1q_u8(scan + (e + cn) * 16));
+                vst1q_u8(scan + e * 16, v);
+            }
+
+        // prefixes, combined with the suffixes as soon as a window is complete
+        uint8x16_t g[4];
+        for (size_t p = 0; p < extPixels; ++p)
+            for (size_t c = 0; c < cn; ++c)
+            {
+                size_t e = p * cn + c;
+                uint8x16_t v = vld1q_u8(bandT + e * 16);
+                g[c] = p % kw == 0 ? v : Op::vec(g[c], v);
+                if (p + 1 >= kw)
+                {
+                    size_t o = (p + 1 - kw) * cn + c;
+                    vst1q_u8(bandT + o * 16, Op::vec(g[c], vld1q_u8(scan + o * 16)));
+                }
+            }
+
+        for (size_t e = 0; e < n; e += 16)
+            transpose16x16(bandT + e * 16, 16, band + e, extNPad);
+    }
+
+    size_t width, height, cn, kw, kh, ax, ay;
+    size_t n, extPixels, extN, extNPad;
+    const u8 * srcBase;
+    ptrdiff_t srcStride;
+    Margin margin;
+    BORDER_MODE columnBorder;
+
+    size_t realBegin, realEnd;
+    std::vector<ptrdiff_t> colMap;
+    std::vector<bool> colConst;
+    std::vector<u8> values, constRow, rowBuf;
+
+    ptrdiff_t block;
+    std::vector<u8> suffix, prefix;
+};
+
+template <typename Op>
+void morphology(const Size2D &ssize, u32 cn,
+                const u8 * srcBase, ptrdiff_t srcStride,
+                u8 * dstBase, ptrdiff_t dstStride,
+                const Size2D &ksize, size_t anchorX, size_t anchorY,
+                BORDER_MODE rowBorderType, BORDER_MODE columnBorderType,
+                const u8 * borderValues, const Margin &borderMargin)
+{
+    Morphology<Op> morph(ssize, cn, srcBase, srcStride, ksize, anchorX, anchorY,
+                         rowBorderType, columnBorderType, borderValues, borderMargin);
+    morph.run(dstBase, dstStride);
+}
+
+#endif
+
+} // namespace
+
+bool isMorph3x3Supported(const Size2D &size, BORDER_MODE border)
+{
+    return isMorphSupported(size, 1, Size2D(3, 3), 1, 1, border, border);
+}
+
+void erode3x3(const Size2D &size,
+              const u8 * srcBase, ptrdiff_t srcStride,
+              u8 * dstBase, ptrdiff_t dstStride,
+              BORDER_MODE border, u8 borderValue)
+{
+    internal::assertSupportedConfiguration(isMorph3x3Supported(size, border));
+#ifdef CAROTENE_NEON
+    morphology<MinOp>(size, 1, srcBase, srcStride, dstBase, dstStride, Size2D(3, 3), 1, 1,
+                      border, border, &borderValue, Margin());
+#else
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+    (void)borderValue;
+#endif
+}
+
+void dilate3x3(const Size2D &size,
+               const u8 * srcBase, ptrdiff_t srcStride,
+               u8 * dstBase, ptrdiff_t dstStride,
+               BORDER_MODE border, u8 borderValue)
+{
+    internal::assertSupportedConfiguration(isMorph3x3Supported(size, border));
+#ifdef CAROTENE_NEON
+    morphology<MaxOp>(size, 1, srcBase, srcStride, dstBase, dstStride, Size2D(3, 3), 1, 1,
+                      border, border, &borderValue, Margin());
+#else
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+    (void)borderValue;
+#endif
+}
+
+void erode(const Size2D &ssize, u32 cn,
+           const u8 * srcBase, ptrdiff_t srcStride,
+           u8 * dstBase, ptrdiff_t dstStride,
+           const Size2D &ksize,
+           size_t anchorX, size_t anchorY,
+           BORDER_MODE rowBorderType, BORDER_MODE columnBorderType,
+           const u8 * borderValues, Margin borderMargin)
+{
+    internal::assertSupportedConfiguration(isMorphSupported(ssize, cn, ksize, anchorX, anchorY,
+                                                            rowBorderType, columnBorderType));
+#ifdef CAROTENE_NEON
+    morphology<MinOp>(ssize, cn, srcBase, srcStride, dstBase, dstStride, ksize, anchorX, anchorY,
+                      rowBorderType, columnBorderType, borderValues, borderMargin);
+#else
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+    (void)borderValues;
+    (void)borderMargin;
+#endif
+}
+
+void dilate(const Size2D &ssize, u32 cn,
+            const u8 * srcBase, ptrdiff_t srcStride,
+            u8 * dstBase, ptrdiff_t dstStride,
+            const Size2D &ksize,
+            size_t anchorX, size_t anchorY,
+            BORDER_MODE rowBorderType, BORDER_MODE columnBorderType,
+            const u8 * borderValues, Margin borderMargin)
+{
+    internal::assertSupportedConfiguration(isMorphSupported(ssize, cn, ksize, anchorX, anchorY,
+                                                            rowBorderType, columnBorderType));
+#ifdef CAROTENE_NEON
+    morphology<MaxOp>(ssize, cn, srcBase, srcStride, dstBase, dstStride, ksize, anchorX, anchorY,
+                      rowBorderType, columnBorderType, borderValues, borderMargin);
+#else
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+    (void)borderValues;
+    (void)borderMargin;
+#endif
+}
+
+} // namespace CAROTENE_NS
@@ -0,0 +1,901 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "common.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace CAROTENE_NS {
+
+#ifdef CAROTENE_NEON
+
+namespace {
+
+/*
+ * The kernels are written for two sources so that norms and difference norms share them,
+ * single source norms pass the same image twice and their ops only read the first one.
+ * Every op maps a vector of source elements to their magnitudes, as unsigned lanes of the
+ * same width, and the kernels reduce those: max for Inf, sum for L1, sum of squares for L2.
+ * Sums are kept in narrow lanes for a block of iterations that cannot overflow them and
+ * are then widened into 64 bit accumulators, so there is no overflow whatever the image size.
+ */
+
+// u16 lanes take two bytes per vpadal, so 128 rounds of 32 bytes stay below 65535
+const size_t BYTE_BLOCK_SIZE = 128 * 32;
+// u32 lanes take two words per vpadal, 4096 rounds of 16 words stay below 2^32
+const size_t WORD_BLOCK_SIZE = 4096 * 16;
+// f32 partial sums are flushed into f64 every 128 rounds of 8 floats to bound the rounding error
+const size_t FLOAT_BLOCK_SIZE = 128 * 8;
+
+const s32 S32_MAX = 0x7fFFffFF;
+
+// Images stored without row padding are processed as a single long row
+inline Size2D mergeRows(const Size2D &size, ptrdiff_t src0Stride, ptrdiff_t src1Stride, size_t elemSize)
+{
+    Size2D merged(size);
+    if (src0Stride == src1Stride && src0Stride == (ptrdiff_t)(size.width * elemSize))
+    {
+        merged.width *= merged.height;
+        merged.height = 1;
+    }
+    return merged;
+}
+
+inline s32 saturateS32(u64 value)
+{
+    return value > (u64)S32_MAX ? S32_MAX : (s32)value;
+}
+
+inline u64 sumLanes(uint64x2_t v)
+{
+    return vgetq_lane_u64(v, 0) + vgetq_lane_u64(v, 1);
+}
+
+inline f64 sumLanes(float32x4_t v)
+{
+    f32 lanes[4];
+    vst1q_f32(lanes, v);
+    return (f64)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+struct AbsU8
+{
+    typedef u8 type;
+    uint8x16_t operator() (const u8 * src0, const u8 *) const { return vld1q_u8(src0); }
+    u32 operator() (u8 src0, u8) const { return src0; }
+};
+
+struct AbsS8
+{
+    typedef s8 type;
+    // vabsq keeps -128 as 0x80, which is exactly 128 once read as unsigned
+    uint8x16_t operator() (const s8 * src0, const s8 *) const { return vreinterpretq_u8_s8(vabsq_s8(vld1q_s8(src0))); }
+    u32 operator() (s8 src0, s8) const { return src0 < 0 ? -(s32)src0 : src0; }
+};
+
+struct AbsDiffU8
+{
+    typedef u8 type;
+    uint8x16_t operator() (const u8 * src0, const u8 * src1) const { return vabdq_u8(vld1q_u8(src0), vld1q_u8(src1)); }
+    u32 operator() (u8 src0, u8 src1) const { return src0 > src1 ? src0 - src1 : src1 - src0; }
+};
+
+struct AbsU16
+{
+    typedef u16 type;
+    uint16x8_t operator() (const u16 * src0, const u16 *) const { return vld1q_u16(src0); }
+    u32 operator() (u16 src0, u16) const { return src0; }
+};
+
+struct AbsS16
+{
+    typedef s16 type;
+    uint16x8_t operator() (const s16 * src0, const s16 *) const { return vreinterpretq_u16_s16(vabsq_s16(vld1q_s16(src0))); }
+    u32 operator() (s16 src0, s16) const { return src0 < 0 ? -(s32)src0 : src0; }
+};
+
+struct AbsF32
+{
+    typedef f32 type;
+    float32x4_t operator() (const f32 * src0, const f32 *) const { return vabsq_f32(vld1q_f32(src0)); }
+    f32 operator() (f32 src0, f32) const { return std::abs(src0); }
+};
+
+struct AbsDiffF32
+{
+    typedef f32 type;
+    float32x4_t operator() (const f32 * src0, const f32 * src1) const { return vabdq_f32(vld1q_f32(src0), vld1q_f32(src1)); }
+    f32 operator() (f32 src0, f32 src1) const { return std::abs(src0 - src1); }
+};
+
+template <typename Op>
+u32 normInfBytes(const Size2D &_size,
+                 const typename Op::type * src0Base, ptrdiff_t src0Stride,
+                 const typename Op::type * src1Base, ptrdiff_t src1Stride,
+                 const Op & op)
+{
+    Size2D size = mergeRows(_size, src0Stride, src1Stride, sizeof(typename Op::type));
+    size_t roiw32 = size.width >= 31 ? size.width - 31 : 0;
+    uint8x16_t v_max0 = vdupq_n_u8(0), v_max1 = v_max0;
+    u32 result = 0;
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        const typename Op::type * src0 = internal::getRowPtr(src0Base, src0Stride, i);
+        const typename Op::type * src1 = internal::getRowPtr(src1Base, src1Stride, i);
+        size_t j = 0;
+
+        for (; j < roiw32; j += 32)
+        {
+            internal::prefetch(src0 + j);
+            internal::prefetch(src1 + j);
+            v_max0 = vmaxq_u8(v_max0, op(src0 + j, src1 + j));
+            v_max1 = vmaxq_u8(v_max1, op(src0 + j + 16, src1 + j + 16));
+        }
+        for (; j < size.width; ++j)
+            result = std::max(result, op(src0[j], src1[j]));
+    }
+
+    u8 lanes[16];
+    vst1q_u8(lanes, vmaxq_u8(v_max0, v_max1));
+    return std::max<u32>(result, *std::max_element(lanes, lanes + 16));
+}
+
+template <typename Op>
+u64 normL1Bytes(const Size2D &_size,
+                const typename Op::type * src0Base, ptrdiff_t src0Stride,
+                const typename Op::type * src1Base, ptrdiff_t src1Stride,
+                const Op & op)
+{
+    Size2D size = mergeRows(_size, src0Stride, src1Stride, sizeof(typename Op::type));
+    size_t roiw32 = size.width >= 31 ? size.width - 31 : 0;
+    uint64x2_t v_sum = vdupq_n_u64(0);
+    u64 result = 0;
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        const typename Op::type * src0 = internal::getRowPtr(src0Base, src0Stride, i);
+        const typename Op::type * src1 = internal::getRowPtr(src1Base, src1Stride, i);
+        size_t j = 0;
+
+        while (j < roiw32)
+        {
+            size_t blockEnd = std::min(j + BYTE_BLOCK_SIZE, roiw32);
+            uint16x8_t v_sum0 = vdupq_n_u16(0), v_sum1 = v_sum0;
+
+            for (; j < blockEnd; j += 32)
+            {
+                internal::prefetch(src0 + j);
+                internal::prefetch(src1 + j);
+                v_sum0 = vpadalq_u8(v_sum0, op(src0 + j, src1 + j));
+                v_sum1 = vpadalq_u8(v_sum1, op(src0 + j + 16, src1 + j + 16));
+            }
+
+            v_sum = vpadalq_u32(v_sum, vpadalq_u16(vpaddlq_u16(v_sum0), v_sum1));
+        }
+        for (; j < size.width; ++j)
+            result += op(src0[j], src1[j]);
+    }
+
+    return result + sumLanes(v_sum);
+}
+
+template <typename Op>
+u64 normL2Bytes(const Size2D &_size,
+                const typename Op::type * src0Base, ptrdiff_t src0Stride,
+                const typename Op::type * src1Base, ptrdiff_t src1Stride,
+                const Op & op)
+{
+    Size2D size = mergeRows(_size, src0Stride, src1Stride, sizeof(typename Op::type));
+    size_t roiw32 = size.width >= 31 ? size.width - 31 : 0;
+    uint64x2_t v_sum = vdupq_n_u64(0);
+    u64 result = 0;
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        const typename Op::type * src0 = internal::getRowPtr(src0Base, src0Stride, i);
+        const typename Op::type * src1 = internal::getRowPtr(src1Base, src1Stride, i);
+        size_t j = 0;
+
+        while (j < roiw32)
+        {
+            size_t blockEnd = std::min(j + BYTE_BLOCK_SIZE, roiw32);
+            uint32x4_t v_sum0 = vdupq_n_u32(0), v_sum1 = v_sum0, v_sum2 = v_sum0, v_sum3 = v_sum0;
+
+            for (; j < blockEnd; j += 32)
+            {
+                internal::prefetch(src0 + j);
+                internal::prefetch(src1 + j);
+                uint8x16_t v_abs0 = op(src0 + j, src1 + j), v_abs1 = op(src0 + j + 16, src1 + j + 16);
+                v_sum0 = vpadalq_u16(v_sum0, vmull_u8(vget_low_u8(v_abs0), vget_low_u8(v_abs0)));
+                v_sum1 = vpadalq_u16(v_sum1, vmull_u8(vget_high_u8(v_abs0), vget_high_u8(v_abs0)));
+                v_sum2 = vpadalq_u16(v_sum2, vmull_u8(vget_low_u8(v_abs1), vget_low_u8(v_abs1)));
+                v_sum3 = vpadalq_u16(v_sum3, vmull_u8(vget_high_u8(v_abs1), vget_high_u8(v_abs1)));
+            }
+
+            v_sum = vpadalq_u32(v_sum, vaddq_u32(vaddq_u32(v_sum0, v_sum1), vaddq_u32(v_sum2, v_sum3)));
+        }
+        for (; j < size.width; ++j)
+        {
+            u32 v = op(src0[j], src1[j]);
+            result += v * v;
+        }
+    }
+
+    return result + sumLanes(v_sum);
+}
+
+template <typename Op>
+u32 normInfWords(const Size2D &_size,
+                 const typename Op::type * srcBase, ptrdiff_t srcStride,
+                 const Op & op)
+{
+    Size2D size = mergeRows(_size, srcStride, srcStride, sizeof(typename Op::type));
+    size_t roiw16 = size.width >= 15 ? size.width - 15 : 0;
+    uint16x8_t v_max0 = vdupq_n_u16(0), v_max1 = v_max0;
+    u32 result = 0;
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        const typename Op::type * src = internal::getRowPtr(srcBase, srcStride, i);
+        size_t j = 0;
+
+        for (; j < roiw16; j += 16)
+        {
+            internal::prefetch(src + j);
+            v_max0 = vmaxq_u16(v_max0, op(src + j, src + j));
+            v_max1 = vmaxq_u16(v_max1, op(src + j + 8, src + j + 8));
+        }
+        for (; j < size.width; ++j)
+            result = std::max(result, op(src[j], src[j]));
+    }
+
+    u16 lanes[8];
+    vst1q_u16(lanes, vmaxq_u16(v_max0, v_max1));
+    return std::max<u32>(result, *std::max_element(lanes, lanes + 8));
+}
+
+template <typename Op>
+u64 normL1Words(const Size2D &_size,
+                const typename Op::type * srcBase, ptrdiff_t srcStride,
+                const Op & op)
+{
+    Size2D size = mergeRows(_size, srcStride, srcStride, sizeof(typename Op::type));
+    size_t roiw16 = size.width >= 15 ? size.width - 15 : 0;
+    uint64x2_t v_sum = vdupq_n_u64(0);
+    u64 result = 0;
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        const typename Op::type * src = internal::getRowPtr(srcBase, srcStride, i);
+        size_t j = 0;
+
+        while (j < roiw16)
+        {
+            size_t blockEnd = std::min(j + WORD_BLOCK_SIZE, roiw16);
+            uint32x4_t v_sum0 = vdupq_n_u32(0), v_sum1 = v_sum0;
+
+            for (; j < blockEnd; j += 16)
+            {
+                internal::prefetch(src + j);
+                v_sum0 = vpadalq_u16(v_sum0, op(src + j, src + j));
+                v_sum1 = vpadalq_u16(v_sum1, op(src + j + 8, src + j + 8));
+            }
+
+            v_sum = vpadalq_u32(vpadalq_u32(v_sum, v_sum0), v_sum1);
+        }
+        for (; j < size.width; ++j)
+            result += op(src[j], src[j]);
+    }
+
+    return result + sumLanes(v_sum);
+}
+
+// A squared word fills a whole u32 lane, so the products go straight into u64 lanes
+template <typename Op>
+u64 normL2Words(const Size2D &_size,
+                const typename Op::type * srcBase, ptrdiff_t srcStride,
+                const Op & op)
+{
+    Size2D size = mergeRows(_size, srcStride, srcStride, sizeof(typename Op::type));
+    size_t roiw16 = size.width >= 15 ? size.width - 15 : 0;
+    uint64x2_t v_sum0 = vdupq_n_u64(0), v_sum1 = v_sum0, v_sum2 = v_sum0, v_sum3 = v_sum0;
+    u64 result = 0;
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        const typename Op::type * src = internal::getRowPtr(srcBase, srcStride, i);
+        size_t j = 0;
+
+        for (; j < roiw16; j += 16)
+        {
+            internal::prefetch(src + j);
+            uint16x8_t v_abs0 = op(src + j, src + j), v_abs1 = op(src + j + 8, src + j + 8);
+            v_sum0 = vpadalq_u32(v_sum0, vmull_u16(vget_low_u16(v_abs0), vget_low_u16(v_abs0)));
+            v_sum1 = vpadalq_u32(v_sum1, vmull_u16(vget_high_u16(v_abs0), vget_high_u16(v_abs0)));
+            v_sum2 = vpadalq_u32(v_sum2, vmull_u16(vget_low_u16(v_abs1), vget_low_u16(v_abs1)));
+            v_sum3 = vpadalq_u32(v_sum3, vmull_u16(vget_high_u16(v_abs1), vget_high_u16(v_abs1)));
+        }
+        for (; j < size.width; ++j)
+        {
+            u64 v = op(src[j], src[j]);
+            result += v * v;
+        }
+    }
+
+    return result + sumLanes(vaddq_u64(vaddq_u64(v_sum0, v_sum1), vaddq_u64(v_sum2, v_sum3)));
+}
+
+template <typename Op>
+f32 normInfFloats(const Size2D &_size,
+                  const f32 * src0Base, ptrdiff_t src0Stride,
+                  const f32 * src1Base, ptrdiff_t src1Stride,
+                  const Op & op)
+{
+    Size2D size = mergeRows(_size, src0Stride, src1Stride, sizeof(f32));
+    size_t roiw8 = size.width >= 7 ? size.width - 7 : 0;
+    float32x4_t v_max0 = vdupq_n_f32(0), v_max1 = v_max0;
+    f32 result = 0;
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        const f32 * src0 = internal::getRowPtr(src0Base, src0Stride, i);
+        const f32 * src1 = internal::getRowPtr(src1Base, src1Stride, i);
+        size_t j = 0;
+
+        for (; j < roiw8; j += 8)
+        {
+            internal::prefetch(src0 + j);
+            internal::prefetch(src1 + j);
+            v_max0 = vmaxq_f32(v_max0, op(src0 + j, src1 + j));
+            v_max1 = vmaxq_f32(v_max1, op(src0 + j + 4, src1 + j + 4));
+        }
+        for (; j < size.width; ++j)
+            result = std::max(result, op(src0[j], src1[j]));
+    }
+
+    f32 lanes[4];
+    vst1q_f32(lanes, vmaxq_f32(v_max0, v_max1));
+    return std::max(result, *std::max_element(lanes, lanes + 4));
+}
+
+template <typename Op, bool squares>
+f64 normSumFloats(const Size2D &_size,
+                  const f32 * src0Base, ptrdiff_t src0Stride,
+                  const f32 * src1Base, ptrdiff_t src1Stride,
+                  const Op & op)
+{
+    Size2D size = mergeRows(_size, src0Stride, src1Stride, sizeof(f32));
+    size_t roiw8 = size.width >= 7 ? size.width - 7 : 0;
+    f64 result = 0;
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        const f32 * src0 = internal::getRowPtr(src0Base, src0Stride, i);
+        const f32 * src1 = internal::getRowPtr(src1Base, src1Stride, i);
+        size_t j = 0;
+
+        while (j < roiw8)
+        {
+            size_t blockEnd = std::min(j + FLOAT_BLOCK_SIZE, roiw8);
+            float32x4_t v_sum0 = vdupq_n_f32(0), v_sum1 = v_sum0;
+
+            for (; j < blockEnd; j += 8)
+            {
+                internal::prefetch(src0 + j);
+                internal::prefetch(src1 + j);
+                float32x4_t v_abs0 = op(src0 + j, src1 + j), v_abs1 = op(src0 + j + 4, src1 + j + 4);
+                if (squares)
+                {
+                    v_sum0 = vmlaq_f32(v_sum0, v_abs0, v_abs0);
+                    v_sum1 = vmlaq_f32(v_sum1, v_abs1, v_abs1);
+                }
+                else
+                {
+                    v_sum0 = vaddq_f32(v_sum0, v_abs0);
+                    v_sum1 = vaddq_f32(v_sum1, v_abs1);
+                }
+            }
+
+            result += sumLanes(vaddq_f32(v_sum0, v_sum1));
+        }
+        for (; j < size.width; ++j)
+        {
+            f64 v = op(src0[j], src1[j]);
+            result += squares ? v * v : v;
+        }
+    }
+
+    return result;
+}
+
+} // namespace
+
+#endif
+
+s32 normInf(const Size2D &_size,
+            const u8 * srcBase, ptrdiff_t srcStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return normInfBytes(_size, srcBase, srcStride, srcBase, srcStride, AbsU8());
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+
+    return 0;
+#endif
+}
+
+s32 normInf(const Size2D &_size,
+            const s8 * srcBase, ptrdiff_t srcStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return normInfBytes(_size, srcBase, srcStride, srcBase, srcStride, AbsS8());
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+
+    return 0;
+#endif
+}
+
+s32 normInf(const Size2D &_size,
+            const u16 * srcBase, ptrdiff_t srcStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return normInfWords(_size, srcBase, srcStride, AbsU16());
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+
+    return 0;
+#endif
+}
+
+s32 normInf(const Size2D &_size,
+            const s16 * srcBase, ptrdiff_t srcStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return normInfWords(_size, srcBase, srcStride, AbsS16());
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+
+    return 0;
+#endif
+}
+
+s32 normInf(const Size2D &_size,
+            const s32 * srcBase, ptrdiff_t srcStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    Size2D size = mergeRows(_size, srcStride, srcStride, sizeof(s32));
+    size_t roiw8 = size.width >= 7 ? size.width - 7 : 0;
+    uint32x4_t v_max0 = vdupq_n_u32(0), v_max1 = v_max0;
+    u32 result = 0;
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        const s32 * src = internal::getRowPtr(srcBase, srcStride, i);
+        size_t j = 0;
+
+        for (; j < roiw8; j += 8)
+        {
+            internal::prefetch(src + j);
+            v_max0 = vmaxq_u32(v_max0, vreinterpretq_u32_s32(vabsq_s32(vld1q_s32(src + j))));
+            v_max1 = vmaxq_u32(v_max1, vreinterpretq_u32_s32(vabsq_s32(vld1q_s32(src + j + 4))));
+        }
+        for (; j < size.width; ++j)
+            result = std::max(result, src[j] < 0 ? 0u - (u32)src[j] : (u32)src[j]);
+    }
+
+    u32 lanes[4];
+    vst1q_u32(lanes, vmaxq_u32(v_max0, v_max1));
+    // |INT_MIN| does not fit the result and saturates
+    return saturateS32(std::max(result, *std::max_element(lanes, lanes + 4)));
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+
+    return 0;
+#endif
+}
+
+f32 normInf(const Size2D &_size,
+            const f32 * srcBase, ptrdiff_t srcStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return normInfFloats(_size, srcBase, srcStride, srcBase, srcStride, AbsF32());
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+
+    return 0.;
+#endif
+}
+
+s32 normL1(const Size2D &_size,
+           const u8 * srcBase, ptrdiff_t srcStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return saturateS32(normL1Bytes(_size, srcBase, srcStride, srcBase, srcStride, AbsU8()));
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+
+    return 0;
+#endif
+}
+
+s32 normL1(const Size2D &_size,
+           const s8 * srcBase, ptrdiff_t srcStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return saturateS32(normL1Bytes(_size, srcBase, srcStride, srcBase, srcStride, AbsS8()));
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+
+    return 0;
+#endif
+}
+
+s32 normL1(const Size2D &_size,
+           const u16 * srcBase, ptrdiff_t srcStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return saturateS32(normL1Words(_size, srcBase, srcStride, AbsU16()));
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+
+    return 0;
+#endif
+}
+
+s32 normL1(const Size2D &_size,
+           const s16 * srcBase, ptrdiff_t srcStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return saturateS32(normL1Words(_size, srcBase, srcStride, AbsS16()));
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+
+    return 0;
+#endif
+}
+
+f64 normL1(const Size2D &_size,
+           const s32 * srcBase, ptrdiff_t srcStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    Size2D size = mergeRows(_size, srcStride, srcStride, sizeof(s32));
+    size_t roiw8 = size.width >= 7 ? size.width - 7 : 0;
+    uint64x2_t v_sum0 = vdupq_n_u64(0), v_sum1 = v_sum0;
+    u64 result = 0;
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        const s32 * src = internal::getRowPtr(srcBase, srcStride, i);
+        size_t j = 0;
+
+        for (; j < roiw8; j += 8)
+        {
+            internal::prefetch(src + j);
+            v_sum0 = vpadalq_u32(v_sum0, vreinterpretq_u32_s32(vabsq_s32(vld1q_s32(src + j))));
+            v_sum1 = vpadalq_u32(v_sum1, vreinterpretq_u32_s32(vabsq_s32(vld1q_s32(src + j + 4))));
+        }
+        for (; j < size.width; ++j)
+            result += src[j] < 0 ? 0u - (u32)src[j] : (u32)src[j];
+    }
+
+    return (f64)(result + sumLanes(vaddq_u64(v_sum0, v_sum1)));
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+
+    return 0.;
+#endif
+}
+
+f64 normL1(const Size2D &_size,
+           const f32 * srcBase, ptrdiff_t srcStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return normSumFloats<AbsF32, false>(_size, srcBase, srcStride, srcBase, srcStride, AbsF32());
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+
+    return 0.;
+#endif
+}
+
+s32 normL2(const Size2D &_size,
+           const u8 * srcBase, ptrdiff_t srcStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return saturateS32(normL2Bytes(_size, srcBase, srcStride, srcBase, srcStride, AbsU8()));
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+
+    return 0;
+#endif
+}
+
+s32 normL2(const Size2D &_size,
+           const s8 * srcBase, ptrdiff_t srcStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return saturateS32(normL2Bytes(_size, srcBase, srcStride, srcBase, srcStride, AbsS8()));
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+
+    return 0;
+#endif
+}
+
+f64 normL2(const Size2D &_size,
+           const u16 * srcBase, ptrdiff_t srcStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return (f64)normL2Words(_size, srcBase, srcStride, AbsU16());
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+
+    return 0.;
+#endif
+}
+
+f64 normL2(const Size2D &_size,
+           const s16 * srcBase, ptrdiff_t srcStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return (f64)normL2Words(_size, srcBase, srcStride, AbsS16());
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+
+    return 0.;
+#endif
+}
+
+f64 normL2(const Size2D &_size,
+           const s32 * srcBase, ptrdiff_t srcStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    // s32 squares overflow any integer accumulator and NEON has no f64 lanes on ARMv7,
+    // so this one is left to scalar f64 with independent partial sums
+    Size2D size = mergeRows(_size, srcStride, srcStride, sizeof(s32));
+    size_t roiw4 = size.width >= 3 ? size.width - 3 : 0;
+    f64 sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        const s32 * src = internal::getRowPtr(srcBase, srcStride, i);
+        size_t j = 0;
+
+        for (; j < roiw4; j += 4)
+        {
+            internal::prefetch(src + j);
+            f64 v0 = src[j], v1 = src[j + 1], v2 = src[j + 2], v3 = src[j + 3];
+            sum0 += v0 * v0;
+            sum1 += v1 * v1;
+            sum2 += v2 * v2;
+            sum3 += v3 * v3;
+        }
+        for (; j < size.width; ++j)
+        {
+            f64 v = src[j];
+            sum0 += v * v;
+        }
+    }
+
+    return (sum0 + sum1) + (sum2 + sum3);
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+
+    return 0.;
+#endif
+}
+
+f64 normL2(const Size2D &_size,
+           const f32 * srcBase, ptrdiff_t srcStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return normSumFloats<AbsF32, true>(_size, srcBase, srcStride, srcBase, srcStride, AbsF32());
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+
+    return 0.;
+#endif
+}
+
+s32 diffNormInf(const Size2D &_size,
+                const u8 * src0Base, ptrdiff_t src0Stride,
+                const u8 * src1Base, ptrdiff_t src1Stride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return normInfBytes(_size, src0Base, src0Stride, src1Base, src1Stride, AbsDiffU8());
+#else
+    (void)_size;
+    (void)src0Base;
+    (void)src0Stride;
+    (void)src1Base;
+    (void)src1Stride;
+
+    return 0;
+#endif
+}
+
+f32 diffNormInf(const Size2D &_size,
+                const f32 * src0Base, ptrdiff_t src0Stride,
+                const f32 * src1Base, ptrdiff_t src1Stride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return normInfFloats(_size, src0Base, src0Stride, src1Base, src1Stride, AbsDiffF32());
+#else
+    (void)_size;
+    (void)src0Base;
+    (void)src0Stride;
+    (void)src1Base;
+    (void)src1Stride;
+
+    return 0.;
+#endif
+}
+
+s32 diffNormL1(const Size2D &_size,
+               const u8 * src0Base, ptrdiff_t src0Stride,
+               const u8 * src1Base, ptrdiff_t src1Stride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return saturateS32(normL1Bytes(_size, src0Base, src0Stride, src1Base, src1Stride, AbsDiffU8()));
+#else
+    (void)_size;
+    (void)src0Base;
+    (void)src0Stride;
+    (void)src1Base;
+    (void)src1Stride;
+
+    return 0;
+#endif
+}
+
+f64 diffNormL1(const Size2D &_size,
+               const f32 * src0Base, ptrdiff_t src0Stride,
+               const f32 * src1Base, ptrdiff_t src1Stride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return normSumFloats<AbsDiffF32, false>(_size, src0Base, src0Stride, src1Base, src1Stride, AbsDiffF32());
+#else
+    (void)_size;
+    (void)src0Base;
+    (void)src0Stride;
+    (void)src1Base;
+    (void)src1Stride;
+
+    return 0.;
+#endif
+}
+
+s32 diffNormL2(const Size2D &_size,
+               const u8 * src0Base, ptrdiff_t src0Stride,
+               const u8 * src1Base, ptrdiff_t src1Stride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return saturateS32(normL2Bytes(_size, src0Base, src0Stride, src1Base, src1Stride, AbsDiffU8()));
+#else
+    (void)_size;
+    (void)src0Base;
+    (void)src0Stride;
+    (void)src1Base;
+    (void)src1Stride;
+
+    return 0;
+#endif
+}
+
+f64 diffNormL2(const Size2D &_size,
+               const f32 * src0Base, ptrdiff_t src0Stride,
+               const f32 * src1Base, ptrdiff_t src1Stride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    return normSumFloats<AbsDiffF32, true>(_size, src0Base, src0Stride, src1Base, src1Stride, AbsDiffF32());
+#else
+    (void)_size;
+    (void)src0Base;
+    (void)src0Stride;
+    (void)src1Base;
+    (void)src1Stride;
+
+    return 0.;
+#endif
+}
+
+} // namespace CAROTENE_NS
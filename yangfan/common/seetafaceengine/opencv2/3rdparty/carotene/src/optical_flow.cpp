@@ -0,0 +1,410 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "separable_filter.hpp"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace CAROTENE_NS {
+
+#ifdef CAROTENE_NEON
+
+namespace {
+
+enum
+{
+    // bilinear weights are Q14, patch intensities keep 5 fractional bits as in cv::calcOpticalFlowPyrLK
+    W_BITS = 14,
+    I_BITS = 5,
+    // s32 lane sums are moved to s64 before they can overflow
+    FLUSH_COUNT = 16
+};
+
+const f32 FLT_SCALE = 1.f / (1 << 20);
+
+struct Weights
+{
+    s16 w00, w01, w10, w11;
+
+    Weights(f32 a, f32 b)
+    {
+        w00 = (s16)std::lrint((1.f - a) * (1.f - b) * (1 << W_BITS));
+        w01 = (s16)std::lrint(a * (1.f - b) * (1 << W_BITS));
+        w10 = (s16)std::lrint((1.f - a) * b * (1 << W_BITS));
+        w11 = (s16)((1 << W_BITS) - w00 - w01 - w10);
+    }
+};
+
+inline s32 descale(s32 v, s32 n)
+{
+    return (v + (1 << (n - 1))) >> n;
+}
+
+// Four u8 values widened to s16, without reading past them
+inline int16x4_t load4(const u8 * p)
+{
+    u32 v;
+    std::memcpy(&v, p, sizeof(v));
+    return vget_low_s16(vreinterpretq_s16_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(v)))));
+}
+
+// Bilinear Q5 sample of four consecutive elements, `next` is the element offset of the right neighbour
+inline int16x4_t sample4(const u8 * s0, const u8 * s1, s32 next, const Weights & w)
+{
+    int32x4_t v = vmull_n_s16(load4(s0), w.w00);
+    v = vmlal_n_s16(v, load4(s0 + next), w.w01);
+    v = vmlal_n_s16(v, load4(s1), w.w10);
+    v = vmlal_n_s16(v, load4(s1 + next), w.w11);
+    return vrshrn_n_s32(v, W_BITS - I_BITS);
+}
+
+inline s32 sample1(const u8 * s0, const u8 * s1, s32 next, const Weights & w)
+{
+    return descale(s0[0] * w.w00 + s0[next] * w.w01 + s1[0] * w.w10 + s1[next] * w.w11, W_BITS - I_BITS);
+}
+
+inline s64 horizontalSum(int64x2_t v)
+{
+    return vgetq_lane_s64(v, 0) + vgetq_lane_s64(v, 1);
+}
+
+/*
+    Samples the previous image patch (Q5) and its derivatives at the point's subpixel position
+    and accumulates the spatial gradient matrix [A11 A12; A12 A22] exactly in s64.
+*/
+void extractPatch(const u8 * I, ptrdiff_t stepI, const s16 * dI, ptrdiff_t stepD,
+                  s32 cn, const Size2D &winSize, const Weights & w,
+                  s16 * Iwin, s16 * dIwin, s64 & A11, s64 & A12, s64 & A22)
+{
+    const size_t n = winSize.width * cn;
+    const s32 cn2 = cn * 2;
+    int64x2_t v_A11 = vdupq_n_s64(0), v_A12 = v_A11, v_A22 = v_A11;
+
+    for (size_t y = 0; y < winSize.height; ++y)
+    {
+        const u8 * s0 = internal::getRowPtr(I, stepI, y), * s1 = internal::getRowPtr(s0, stepI, 1);
+        const s16 * d0 = internal::getRowPtr(dI, stepD, y), * d1 = internal::getRowPtr(d0, stepD, 1);
+        s16 * Ip = Iwin + y * n, * dIp = dIwin + y * n * 2;
+
+        size_t x = 0;
+        while (x + 4 <= n)
+        {
+            int32x4_t v_a11 = vdupq_n_s32(0), v_a12 = v_a11, v_a22 = v_a11;
+            for (size_t k = 0; k < FLUSH_COUNT && x + 4 <= n; ++k, x += 4)
+            {
+                vst1_s16(Ip + x, sample4(s0 + x, s1 + x, cn, w));
+
+                int16x4x2_t v_00 = vld2_s16(d0 + x * 2), v_01 = vld2_s16(d0 + x * 2 + cn2);
+                int16x4x2_t v_10 = vld2_s16(d1 + x * 2), v_11 = vld2_s16(d1 + x * 2 + cn2);
+                int16x4x2_t v_d;
+                for (int c = 0; c < 2; ++c)
+                {
+                    int32x4_t v = vmull_n_s16(v_00.val[c], w.w00);
+                    v = vmlal_n_s16(v, v_01.val[c], w.w01);
+                    v = vmlal_n_s16(v, v_10.val[c], w.w10);
+                    v = vmlal_n_s16(v, v_11.val[c], w.w11);
+                    v_d.val[c] = vrshrn_n_s32(v, W_BITS);
+                }
+                vst2_s16(dIp + x * 2, v_d);
+
+                v_a11 = vmlal_s16(v_a11, v_d.val[0], v_d.val[0]);
+                v_a12 = vmlal_s16(v_a12, v_d.val[0], v_d.val[1]);
+                v_a22 = vmlal_s16(v_a22, v_d.val[1], v_d.val[1]);
+            }
+            v_A11 = vpadalq_s32(v_A11, v_a11);
+            v_A12 = vpadalq_s32(v_A12, v_a12);
+            v_A22 = vpadalq_s32(v_A22, v_a22);
+        }
+        for (; x < n; ++x)
+        {
+            Ip[x] = (s16)sample1(s0 + x, s1 + x, cn, w);
+            s32 ix = descale(d0[x * 2] * w.w00 + d0[x * 2 + cn2] * w.w01 +
+                             d1[x * 2] * w.w10 + d1[x * 2 + cn2] * w.w11, W_BITS);
+            s32 iy = descale(d0[x * 2 + 1] * w.w00 + d0[x * 2 + cn2 + 1] * w.w01 +
+                             d1[x * 2 + 1] * w.w10 + d1[x * 2 + cn2 + 1] * w.w11, W_BITS);
+            dIp[x * 2] = (s16)ix;
+            dIp[x * 2 + 1] = (s16)iy;
+            A11 += ix * ix;
+            A12 += ix * iy;
+            A22 += iy * iy;
+        }
+    }
+    A11 += horizontalSum(v_A11);
+    A12 += horizontalSum(v_A12);
+    A22 += horizontalSum(v_A22);
+}
+
+// Mismatch vector b = sum((J - I) * dI) of the next image patch at the current estimate
+void mismatch(const u8 * J, ptrdiff_t stepJ, s32 cn, const Size2D &winSize, const Weights & w,
+              const s16 * Iwin, const s16 * dIwin, s64 & b1, s64 & b2)
+{
+    const size_t n = winSize.width * cn;
+    int64x2_t v_b1 = vdupq_n_s64(0), v_b2 = v_b1;
+
+    for (size_t y = 0; y < winSize.height; ++y)
+    {
+        const u8 * s0 = internal::getRowPtr(J, stepJ, y), * s1 = internal::getRowPtr(s0, stepJ, 1);
+        const s16 * Ip = Iwin + y * n, * dIp = dIwin + y * n * 2;
+
+        size_t x = 0;
+        while (x + 4 <= n)
+        {
+            int32x4_t v_s1 = vdupq_n_s32(0), v_s2 = v_s1;
+            for (size_t k = 0; k < FLUSH_COUNT && x + 4 <= n; ++k, x += 4)
+            {
+                int16x4_t v_diff = vsub_s16(sample4(s0 + x, s1 + x, cn, w), vld1_s16(Ip + x));
+                int16x4x2_t v_d = vld2_s16(dIp + x * 2);
+                v_s1 = vmlal_s16(v_s1, v_diff, v_d.val[0]);
+                v_s2 = vmlal_s16(v_s2, v_diff, v_d.val[1]);
+            }
+            v_b1 = vpadalq_s32(v_b1, v_s1);
+            v_b2 = vpadalq_s32(v_b2, v_s2);
+        }
+        for (; x < n; ++x)
+        {
+            s32 diff = sample1(s0 + x, s1 + x, cn, w) - Ip[x];
+            b1 += diff * dIp[x * 2];
+            b2 += diff * dIp[x * 2 + 1];
+        }
+    }
+    b1 += horizontalSum(v_b1);
+    b2 += horizontalSum(v_b2);
+}
+
+// Sum of |J - I| over the patch, in Q5
+f32 patchError(const u8 * J, ptrdiff_t stepJ, s32 cn, const Size2D &winSize, const Weights & w, const s16 * Iwin)
+{
+    const size_t n = winSize.width * cn;
+    f32 errval = 0.f;
+    for (size_t y = 0; y < winSize.height; ++y)
+    {
+        const u8 * s0 = internal::getRowPtr(J, stepJ, y), * s1 = internal::getRowPtr(s0, stepJ, 1);
+        const s16 * Ip = Iwin + y * n;
+
+        size_t x = 0;
+        uint32x4_t v_sum = vdupq_n_u32(0);
+        for (; x + 4 <= n; x += 4)
+            v_sum = vaddw_u16(v_sum, vreinterpret_u16_s16(vabd_s16(sample4(s0 + x, s1 + x, cn, w), vld1_s16(Ip + x))));
+        u32 rowSum = vgetq_lane_u32(v_sum, 0) + vgetq_lane_u32(v_sum, 1) + vgetq_lane_u32(v_sum, 2) + vgetq_lane_u32(v_sum, 3);
+        for (; x < n; ++x)
+            rowSum += std::abs(sample1(s0 + x, s1 + x, cn, w) - Ip[x]);
+        errval += (f32)rowSum;
+    }
+    return errval;
+}
+
+inline bool outside(s32 x, s32 y, const Size2D &size, const Size2D &winSize)
+{
+    return x < -(s32)winSize.width || x >= (s32)size.width || y < -(s32)winSize.height || y >= (s32)size.height;
+}
+
+} // namespace
+
+#endif
+
+void pyrLKOptFlowLevel(const Size2D &size, s32 cn,
+                       const u8 *prevData, ptrdiff_t prevStride,
+                       const s16 *prevDerivData, ptrdiff_t prevDerivStride,
+                       const u8 *nextData, ptrdiff_t nextStride,
+                       u32 ptCount,
+                       const f32 *prevPts, f32 *nextPts,
+                       u8 *status, f32 *err,
+                       const Size2D &winSize,
+                       u32 terminationCount, f64 terminationEpsilon,
+                       u32 level, u32 maxLevel, bool useInitialFlow, bool getMinEigenVals,
+                       f32 minEigThreshold)
+{
+    internal::assertSupportedConfiguration(cn > 0 && winSize.width > 0 && winSize.height > 0);
+#ifdef CAROTENE_NEON
+    const f32 halfWinX = (winSize.width - 1) * 0.5f, halfWinY = (winSize.height - 1) * 0.5f;
+    const size_t n = winSize.width * cn;
+    std::vector<s16> Iwin(n * winSize.height), dIwin(n * winSize.height * 2);
+
+    // without a derivative image the window (plus the bilinear neighbour) is differentiated per point
+    Size2D patchSize(winSize.width + 1, winSize.height + 1);
+    ptrdiff_t patchStride = patchSize.width * cn * 2 * sizeof(s16);
+    std::vector<s16> patch(prevDerivData ? 0 : patchSize.width * cn * 2 * patchSize.height);
+
+    f32 levelScale = 1.f / (1 << level);
+    for (u32 ptidx = 0; ptidx < ptCount; ++ptidx)
+    {
+        f32 prevX = prevPts[ptidx * 2] * levelScale, prevY = prevPts[ptidx * 2 + 1] * levelScale;
+        f32 nextX, nextY;
+        if (level == maxLevel)
+        {
+            nextX = useInitialFlow ? nextPts[ptidx * 2] * levelScale : prevX;
+            nextY = useInitialFlow ? nextPts[ptidx * 2 + 1] * levelScale : prevY;
+        }
+        else
+        {
+            nextX = nextPts[ptidx * 2] * 2.f;
+            nextY = nextPts[ptidx * 2 + 1] * 2.f;
+        }
+        nextPts[ptidx * 2] = nextX;
+        nextPts[ptidx * 2 + 1] = nextY;
+
+        prevX -= halfWinX;
+        prevY -= halfWinY;
+        s32 ix = (s32)std::floor(prevX), iy = (s32)std::floor(prevY);
+        if (outside(ix, iy, size, winSize))
+        {
+            if (level == 0)
+            {
+                if (status)
+                    status[ptidx] = 0;
+                if (err)
+                    err[ptidx] = 0;
+            }
+            continue;
+        }
+
+        const u8 * I = internal::getRowPtr(prevData, prevStride, iy) + ix * cn;
+        const s16 * dI;
+        ptrdiff_t stepD;
+        if (prevDerivData)
+        {
+            dI = internal::getRowPtr(prevDerivData, prevDerivStride, iy) + ix * cn * 2;
+            stepD = prevDerivStride;
+        }
+        else
+        {
+            // the window plus one pixel around it is always readable, see functions.hpp
+            internal::derivatives3x3(patchSize, cn, I, prevStride, &patch[0], patchStride, 3, 10,
+                                     BORDER_MODE_REPLICATE, 0, Margin(1, 1, 1, 1));
+            dI = &patch[0];
+            stepD = patchStride;
+        }
+
+        s64 iA11 = 0, iA12 = 0, iA22 = 0;
+        extractPatch(I, prevStride, dI, stepD, cn, winSize, Weights(prevX - ix, prevY - iy),
+                     &Iwin[0], &dIwin[0], iA11, iA12, iA22);
+
+        f32 A11 = iA11 * FLT_SCALE, A12 = iA12 * FLT_SCALE, A22 = iA22 * FLT_SCALE;
+        f32 D = A11 * A22 - A12 * A12;
+        f32 minEig = (A22 + A11 - std::sqrt((A11 - A22) * (A11 - A22) + 4.f * A12 * A12)) /
+                     (2 * winSize.width * winSize.height);
+        if (err && getMinEigenVals)
+            err[ptidx] = minEig;
+        if (minEig < minEigThreshold || D < FLT_EPSILON)
+        {
+            if (level == 0 && status)
+                status[ptidx] = 0;
+            continue;
+        }
+        D = 1.f / D;
+
+        nextX -= halfWinX;
+        nextY -= halfWinY;
+        f32 prevDeltaX = 0.f, prevDeltaY = 0.f;
+        for (u32 j = 0; j < terminationCount; ++j)
+        {
+            s32 jx = (s32)std::floor(nextX), jy = (s32)std::floor(nextY);
+            if (outside(jx, jy, size, winSize))
+            {
+                if (level == 0 && status)
+                    status[ptidx] = 0;
+                break;
+            }
+
+            s64 ib1 = 0, ib2 = 0;
+            mismatch(internal::getRowPtr(nextData, nextStride, jy) + jx * cn, nextStride, cn, winSize,
+                     Weights(nextX - jx, nextY - jy), &Iwin[0], &dIwin[0], ib1, ib2);
+            f32 b1 = ib1 * FLT_SCALE, b2 = ib2 * FLT_SCALE;
+
+            f32 deltaX = (A12 * b2 - A22 * b1) * D, deltaY = (A12 * b1 - A11 * b2) * D;
+            nextX += deltaX;
+            nextY += deltaY;
+            nextPts[ptidx * 2] = nextX + halfWinX;
+            nextPts[ptidx * 2 + 1] = nextY + halfWinY;
+
+            if ((f64)deltaX * deltaX + (f64)deltaY * deltaY <= terminationEpsilon)
+                break;
+            // oscillating between two positions, settle in the middle
+            if (j > 0 && std::fabs(deltaX + prevDeltaX) < 0.01f && std::fabs(deltaY + prevDeltaY) < 0.01f)
+            {
+                nextPts[ptidx * 2] -= deltaX * 0.5f;
+                nextPts[ptidx * 2 + 1] -= deltaY * 0.5f;
+                break;
+            }
+            prevDeltaX = deltaX;
+            prevDeltaY = deltaY;
+        }
+
+        if ((!status || status[ptidx]) && err && level == 0 && !getMinEigenVals)
+        {
+            f32 x = nextPts[ptidx * 2] - halfWinX, y = nextPts[ptidx * 2 + 1] - halfWinY;
+            s32 jx = (s32)std::floor(x), jy = (s32)std::floor(y);
+            if (outside(jx, jy, size, winSize))
+            {
+                if (status)
+                    status[ptidx] = 0;
+                continue;
+            }
+            f32 errval = patchError(internal::getRowPtr(nextData, nextStride, jy) + jx * cn, nextStride, cn, winSize,
+                                    Weights(x - jx, y - jy), &Iwin[0]);
+            err[ptidx] = errval / (32 * winSize.width * cn * winSize.height);
+        }
+    }
+#else
+    (void)size;
+    (void)prevData;
+    (void)prevStride;
+    (void)prevDerivData;
+    (void)prevDerivStride;
+    (void)nextData;
+    (void)nextStride;
+    (void)ptCount;
+    (void)prevPts;
+    (void)nextPts;
+    (void)status;
+    (void)err;
+    (void)terminationCount;
+    (void)terminationEpsilon;
+    (void)level;
+    (void)maxLevel;
+    (void)useInitialFlow;
+    (void)getMinEigenVals;
+    (void)minEigThreshold;
+#endif
+}
+
+} // namespace CAROTENE_NS
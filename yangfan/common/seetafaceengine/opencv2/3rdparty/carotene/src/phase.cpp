@@ -0,0 +1,310 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "common.hpp"
+
+#include <cfloat>
+#include <cmath>
+
+namespace CAROTENE_NS {
+
+#ifdef CAROTENE_NEON
+
+namespace {
+
+/*
+    atan2 of cv::fastAtan2: a 7th order odd polynomial of min(|x|, |y|) / max(|x|, |y|) on
+    [0, 1], folded to the octant of the vector. The polynomial is within 0.0096 degrees of
+    atan on [0, 1], worst at 45 degrees, and the division is a reciprocal estimate refined
+    by two Newton steps, so the result is within 0.01 degrees (0.0002 rad) of the exact
+    angle, in [0, 360) degrees times `scale`.
+*/
+struct FastAtan2
+{
+    explicit FastAtan2(f32 scale) :
+        p1((f32)( 0.9997878412794807  * (180.0 / M_PI) * scale)),
+        p3((f32)(-0.3258083974640975  * (180.0 / M_PI) * scale)),
+        p5((f32)( 0.1555786518463281  * (180.0 / M_PI) * scale)),
+        p7((f32)(-0.04432655554792128 * (180.0 / M_PI) * scale)),
+        a90(90.f * scale), a180(180.f * scale), a360(360.f * scale)
+    {
+    }
+
+    inline float32x4_t operator()(float32x4_t v_y, float32x4_t v_x) const
+    {
+        float32x4_t ax = vabsq_f32(v_x), ay = vabsq_f32(v_y);
+        float32x4_t tmin = vminq_f32(ax, ay), tmax = vmaxq_f32(ax, ay);
+        float32x4_t c = vmulq_f32(tmin, internal::vrecpq_f32(vaddq_f32(tmax, vdupq_n_f32((f32)DBL_EPSILON))));
+        float32x4_t c2 = vmulq_f32(c, c);
+
+        float32x4_t a = vmulq_f32(c2, vdupq_n_f32(p7));
+        a = vmulq_f32(vaddq_f32(a, vdupq_n_f32(p5)), c2);
+        a = vmulq_f32(vaddq_f32(a, vdupq_n_f32(p3)), c2);
+        a = vmulq_f32(vaddq_f32(a, vdupq_n_f32(p1)), c);
+
+        const float32x4_t v_0 = vdupq_n_f32(0.0f);
+        a = vbslq_f32(vcgeq_f32(ax, ay), a, vsubq_f32(vdupq_n_f32(a90), a));
+        a = vbslq_f32(vcltq_f32(v_x, v_0), vsubq_f32(vdupq_n_f32(a180), a), a);
+        a = vbslq_f32(vcltq_f32(v_y, v_0), vsubq_f32(vdupq_n_f32(a360), a), a);
+        return a;
+    }
+
+    // the same operations one lane wide, so that row tails match the vector body
+    inline f32 operator()(f32 y, f32 x) const
+    {
+        float32x4_t a = (*this)(vdupq_n_f32(y), vdupq_n_f32(x));
+        return vgetq_lane_f32(a, 0);
+    }
+
+    f32 p1, p3, p5, p7, a90, a180, a360;
+};
+
+inline float32x4_t vcvt_lo_f32(int16x8_t v) { return vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))); }
+inline float32x4_t vcvt_hi_f32(int16x8_t v) { return vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))); }
+
+// the square root estimate of magnitude(), also for row tails
+inline float32x4_t vmagnitudeq_f32(float32x4_t v_x, float32x4_t v_y)
+{
+    return internal::vsqrtq_f32(vaddq_f32(vmulq_f32(v_x, v_x), vmulq_f32(v_y, v_y)));
+}
+
+inline f32 magnitudeScalar(f32 x, f32 y)
+{
+    return vgetq_lane_f32(vmagnitudeq_f32(vdupq_n_f32(x), vdupq_n_f32(y)), 0);
+}
+
+} // namespace
+
+#endif
+
+void phase(const Size2D &size,
+           const s16 * src0Base, ptrdiff_t src0Stride,
+           const s16 * src1Base, ptrdiff_t src1Stride,
+           u8 * orientBase, ptrdiff_t orientStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    // 256 units per turn, the angle rounds to the nearest one and a full turn wraps to 0
+    const FastAtan2 fastAtan2(256.0f / 360.0f);
+    const float32x4_t v_05 = vdupq_n_f32(0.5f);
+    const size_t roiw16 = size.width >= 15 ? size.width - 15 : 0;
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        const s16 * src0 = internal::getRowPtr(src0Base, src0Stride, i);
+        const s16 * src1 = internal::getRowPtr(src1Base, src1Stride, i);
+        u8 * orient = internal::getRowPtr(orientBase, orientStride, i);
+        size_t j = 0;
+
+        for (; j < roiw16; j += 16)
+        {
+            internal::prefetch(src0 + j);
+            internal::prefetch(src1 + j);
+            int16x8_t v_x0 = vld1q_s16(src0 + j), v_x1 = vld1q_s16(src0 + j + 8);
+            int16x8_t v_y0 = vld1q_s16(src1 + j), v_y1 = vld1q_s16(src1 + j + 8);
+
+            uint32x4_t v_a0 = vcvtq_u32_f32(vaddq_f32(fastAtan2(vcvt_lo_f32(v_y0), vcvt_lo_f32(v_x0)), v_05));
+            uint32x4_t v_a1 = vcvtq_u32_f32(vaddq_f32(fastAtan2(vcvt_hi_f32(v_y0), vcvt_hi_f32(v_x0)), v_05));
+            uint32x4_t v_a2 = vcvtq_u32_f32(vaddq_f32(fastAtan2(vcvt_lo_f32(v_y1), vcvt_lo_f32(v_x1)), v_05));
+            uint32x4_t v_a3 = vcvtq_u32_f32(vaddq_f32(fastAtan2(vcvt_hi_f32(v_y1), vcvt_hi_f32(v_x1)), v_05));
+
+            uint16x8_t v_a01 = vcombine_u16(vmovn_u32(v_a0), vmovn_u32(v_a1));
+            uint16x8_t v_a23 = vcombine_u16(vmovn_u32(v_a2), vmovn_u32(v_a3));
+            vst1q_u8(orient + j, vcombine_u8(vmovn_u16(v_a01), vmovn_u16(v_a23)));
+        }
+
+        for (; j < size.width; ++j)
+            orient[j] = (u8)(u32)(fastAtan2((f32)src1[j], (f32)src0[j]) + 0.5f);
+    }
+#else
+    (void)size;
+    (void)src0Base;
+    (void)src0Stride;
+    (void)src1Base;
+    (void)src1Stride;
+    (void)orientBase;
+    (void)orientStride;
+#endif
+}
+
+void phase(const Size2D &size,
+           const f32 * src0Base, ptrdiff_t src0Stride,
+           const f32 * src1Base, ptrdiff_t src1Stride,
+           f32 * orientBase, ptrdiff_t orientStride,
+           f32 scale)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    const FastAtan2 fastAtan2(scale);
+    const size_t roiw8 = size.width >= 7 ? size.width - 7 : 0;
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        const f32 * src0 = internal::getRowPtr(src0Base, src0Stride, i);
+        const f32 * src1 = internal::getRowPtr(src1Base, src1Stride, i);
+        f32 * orient = internal::getRowPtr(orientBase, orientStride, i);
+        size_t j = 0;
+
+        for (; j < roiw8; j += 8)
+        {
+            internal::prefetch(src0 + j);
+            internal::prefetch(src1 + j);
+            vst1q_f32(orient + j, fastAtan2(vld1q_f32(src1 + j), vld1q_f32(src0 + j)));
+            vst1q_f32(orient + j + 4, fastAtan2(vld1q_f32(src1 + j + 4), vld1q_f32(src0 + j + 4)));
+        }
+
+        for (; j < size.width; ++j)
+            orient[j] = fastAtan2(src1[j], src0[j]);
+    }
+#else
+    (void)size;
+    (void)src0Base;
+    (void)src0Stride;
+    (void)src1Base;
+    (void)src1Stride;
+    (void)orientBase;
+    (void)orientStride;
+    (void)scale;
+#endif
+}
+
+void magnitudePhase(const Size2D &size,
+                    const f32 * src0Base, ptrdiff_t src0Stride,
+                    const f32 * src1Base, ptrdiff_t src1Stride,
+                    f32 * magnitudeBase, ptrdiff_t magnitudeStride,
+                    f32 * orientBase, ptrdiff_t orientStride,
+                    f32 scale)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    const FastAtan2 fastAtan2(scale);
+    const size_t roiw4 = size.width >= 3 ? size.width - 3 : 0;
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        const f32 * src0 = internal::getRowPtr(src0Base, src0Stride, i);
+        const f32 * src1 = internal::getRowPtr(src1Base, src1Stride, i);
+        f32 * magnitude = internal::getRowPtr(magnitudeBase, magnitudeStride, i);
+        f32 * orient = internal::getRowPtr(orientBase, orientStride, i);
+        size_t j = 0;
+
+        for (; j < roiw4; j += 4)
+        {
+            internal::prefetch(src0 + j);
+            internal::prefetch(src1 + j);
+            float32x4_t v_x = vld1q_f32(src0 + j), v_y = vld1q_f32(src1 + j);
+            vst1q_f32(magnitude + j, vmagnitudeq_f32(v_x, v_y));
+            vst1q_f32(orient + j, fastAtan2(v_y, v_x));
+        }
+
+        for (; j < size.width; ++j)
+        {
+            magnitude[j] = magnitudeScalar(src0[j], src1[j]);
+            orient[j] = fastAtan2(src1[j], src0[j]);
+        }
+    }
+#else
+    (void)size;
+    (void)src0Base;
+    (void)src0Stride;
+    (void)src1Base;
+    (void)src1Stride;
+    (void)magnitudeBase;
+    (void)magnitudeStride;
+    (void)orientBase;
+    (void)orientStride;
+    (void)scale;
+#endif
+}
+
+void magnitudePhase(const Size2D &size,
+                    const s16 * src0Base, ptrdiff_t src0Stride,
+                    const s16 * src1Base, ptrdiff_t src1Stride,
+                    f32 * magnitudeBase, ptrdiff_t magnitudeStride,
+                    f32 * orientBase, ptrdiff_t orientStride,
+                    f32 scale)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    const FastAtan2 fastAtan2(scale);
+    const size_t roiw8 = size.width >= 7 ? size.width - 7 : 0;
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        const s16 * src0 = internal::getRowPtr(src0Base, src0Stride, i);
+        const s16 * src1 = internal::getRowPtr(src1Base, src1Stride, i);
+        f32 * magnitude = internal::getRowPtr(magnitudeBase, magnitudeStride, i);
+        f32 * orient = internal::getRowPtr(orientBase, orientStride, i);
+        size_t j = 0;
+
+        for (; j < roiw8; j += 8)
+        {
+            internal::prefetch(src0 + j);
+            internal::prefetch(src1 + j);
+            int16x8_t v_x = vld1q_s16(src0 + j), v_y = vld1q_s16(src1 + j);
+
+            float32x4_t v_x0 = vcvt_lo_f32(v_x), v_y0 = vcvt_lo_f32(v_y);
+            float32x4_t v_x1 = vcvt_hi_f32(v_x), v_y1 = vcvt_hi_f32(v_y);
+            vst1q_f32(magnitude + j, vmagnitudeq_f32(v_x0, v_y0));
+            vst1q_f32(magnitude + j + 4, vmagnitudeq_f32(v_x1, v_y1));
+            vst1q_f32(orient + j, fastAtan2(v_y0, v_x0));
+            vst1q_f32(orient + j + 4, fastAtan2(v_y1, v_x1));
+        }
+
+        for (; j < size.width; ++j)
+        {
+            magnitude[j] = magnitudeScalar(src0[j], src1[j]);
+            orient[j] = fastAtan2((f32)src1[j], (f32)src0[j]);
+        }
+    }
+#else
+    (void)size;
+    (void)src0Base;
+    (void)src0Stride;
+    (void)src1Base;
+    (void)src1Stride;
+    (void)magnitudeBase;
+    (void)magnitudeStride;
+    (void)orientBase;
+    (void)orientStride;
+    (void)scale;
+#endif
+}
+
+} // namespace CAROTENE_NS
@@ -0,0 +1,645 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "common.hpp"
+
+#include <vector>
+
+namespace CAROTENE_NS {
+
+namespace {
+
+// pyrDown accepts |2 * dst - src| <= 2, as cv::pyrDown does
+inline bool isPyrDownSize(const Size2D &srcSize, const Size2D &dstSize)
+{
+    return (dstSize.width > 0) && (dstSize.height > 0) &&
+           (dstSize.width * 2 <= srcSize.width + 2) && (srcSize.width <= dstSize.width * 2 + 2) &&
+           (dstSize.height * 2 <= srcSize.height + 2) && (srcSize.height <= dstSize.height * 2 + 2);
+}
+
+inline bool isPyrChannels(u8 cn)
+{
+    return (cn == 1) || (cn == 3) || (cn == 4);
+}
+
+} // namespace
+
+bool isGaussianPyramidDownRTZSupported(const Size2D &srcSize, const Size2D &dstSize, BORDER_MODE border)
+{
+    return isSupportedConfiguration() && isPyrDownSize(srcSize, dstSize) &&
+           (border != BORDER_MODE_UNDEFINED);
+}
+
+bool isGaussianPyramidDownU8Supported(const Size2D &srcSize, const Size2D &dstSize, u8 cn)
+{
+    return isSupportedConfiguration() && isPyrDownSize(srcSize, dstSize) && isPyrChannels(cn);
+}
+
+bool isGaussianPyramidDownS16Supported(const Size2D &srcSize, const Size2D &dstSize, u8 cn)
+{
+    return isSupportedConfiguration() && isPyrDownSize(srcSize, dstSize) && isPyrChannels(cn);
+}
+
+bool isGaussianPyramidDownF32Supported(const Size2D &srcSize, const Size2D &dstSize, u8 cn)
+{
+    return isSupportedConfiguration() && isPyrDownSize(srcSize, dstSize) && isPyrChannels(cn);
+}
+
+bool isGaussianPyramidUpU8Supported(const Size2D &srcSize, const Size2D &dstSize, u8 cn)
+{
+    return isSupportedConfiguration() && isPyrChannels(cn) && (srcSize.width > 0) && (srcSize.height > 0) &&
+           (dstSize.width == srcSize.width * 2) && (dstSize.height == srcSize.height * 2);
+}
+
+bool isGaussianPyramidUpS16Supported(const Size2D &srcSize, const Size2D &dstSize, u8 cn)
+{
+    return isSupportedConfiguration() && isPyrChannels(cn) && (srcSize.width > 0) && (srcSize.height > 0) &&
+           (dstSize.width == srcSize.width * 2) && (dstSize.height == srcSize.height * 2);
+}
+
+#ifdef CAROTENE_NEON
+
+namespace {
+
+/*
+ * Horizontal passes. The vector parts cover the columns whose taps are all inside the row
+ * and return the first column they did not process; edges go through the scalar pass.
+ */
+
+// Even and odd pixels of 16 consecutive pixels, one u8 plane per channel
+template <int cn> struct PixelPairs;
+
+template <> struct PixelPairs<1>
+{
+    uint8x8_t even[1], odd[1];
+    inline void load(const u8 * p) { uint8x8x2_t v = vld2_u8(p); even[0] = v.val[0]; odd[0] = v.val[1]; }
+};
+
+template <> struct PixelPairs<3>
+{
+    uint8x8_t even[3], odd[3];
+    inline void load(const u8 * p)
+    {
+        uint8x8x3_t a = vld3_u8(p), b = vld3_u8(p + 24);
+        for (int c = 0; c < 3; ++c)
+        {
+            uint8x8x2_t z = vuzp_u8(a.val[c], b.val[c]);
+            even[c] = z.val[0];
+            odd[c] = z.val[1];
+        }
+    }
+};
+
+template <> struct PixelPairs<4>
+{
+    uint8x8_t even[4], odd[4];
+    inline void load(const u8 * p)
+    {
+        uint8x8x4_t a = vld4_u8(p), b = vld4_u8(p + 32);
+        for (int c = 0; c < 4; ++c)
+        {
+            uint8x8x2_t z = vuzp_u8(a.val[c], b.val[c]);
+            even[c] = z.val[0];
+            odd[c] = z.val[1];
+        }
+    }
+};
+
+// Interleaving store of one u16 plane per channel
+template <int cn> inline void storePlanes(u16 * p, const uint16x8_t * v);
+
+template <> inline void storePlanes<1>(u16 * p, const uint16x8_t * v)
+{
+    vst1q_u16(p, v[0]);
+}
+
+template <> inline void storePlanes<3>(u16 * p, const uint16x8_t * v)
+{
+    uint16x8x3_t s;
+    s.val[0] = v[0]; s.val[1] = v[1]; s.val[2] = v[2];
+    vst3q_u16(p, s);
+}
+
+template <> inline void storePlanes<4>(u16 * p, const uint16x8_t * v)
+{
+    uint16x8x4_t s;
+    s.val[0] = v[0]; s.val[1] = v[1]; s.val[2] = v[2]; s.val[3] = v[3];
+    vst4q_u16(p, s);
+}
+
+// row[dx] = s[2dx - 2] + 4 s[2dx - 1] + 6 s[2dx] + 4 s[2dx + 1] + s[2dx + 2], fits u16 for u8
+template <int cn>
+size_t pyrDownHVec(const u8 * src, size_t swidth, u16 * row, size_t dwidth)
+{
+    const uint8x8_t v_6 = vdup_n_u8(6);
+    size_t dx = 1;
+    // the last load of a block reads source pixels up to 2 * dx + 17
+    for (; dx + 8 <= dwidth && dx * 2 + 18 <= swidth; dx += 8)
+    {
+        const u8 * s = src + (dx * 2 - 2) * cn;
+        internal::prefetch(s);
+        PixelPairs<cn> l, m, r;
+        l.load(s);
+        m.load(s + 2 * cn);
+        r.load(s + 4 * cn);
+        uint16x8_t v[cn];
+        for (int c = 0; c < cn; ++c)
+        {
+            uint16x8_t v_sum = vmlal_u8(vaddl_u8(l.even[c], r.even[c]), m.even[c], v_6);
+            v[c] = vaddq_u16(v_sum, vshlq_n_u16(vaddl_u8(l.odd[c], m.odd[c]), 2));
+        }
+        storePlanes<cn>(row + dx * cn, v);
+    }
+    return dx;
+}
+
+template <int cn>
+size_t pyrDownHVec(const s16 * src, size_t swidth, s32 * row, size_t dwidth)
+{
+    if (cn != 1)
+        return 1;
+    size_t dx = 1;
+    for (; dx + 4 <= dwidth && dx * 2 + 10 <= swidth; dx += 4)
+    {
+        const s16 * s = src + dx * 2 - 2;
+        int16x4x2_t l = vld2_s16(s), m = vld2_s16(s + 2), r = vld2_s16(s + 4);
+        int32x4_t v_sum = vmlal_n_s16(vaddl_s16(l.val[0], r.val[0]), m.val[0], 6);
+        vst1q_s32(row + dx, vaddq_s32(v_sum, vshlq_n_s32(vaddl_s16(l.val[1], m.val[1]), 2)));
+    }
+    return dx;
+}
+
+template <int cn>
+size_t pyrDownHVec(const f32 * src, size_t swidth, f32 * row, size_t dwidth)
+{
+    if (cn != 1)
+        return 1;
+    size_t dx = 1;
+    for (; dx + 4 <= dwidth && dx * 2 + 10 <= swidth; dx += 4)
+    {
+        const f32 * s = src + dx * 2 - 2;
+        float32x4x2_t l = vld2q_f32(s), m = vld2q_f32(s + 2), r = vld2q_f32(s + 4);
+        // same operation order as the scalar pass, so that both agree to the bit
+        float32x4_t v_sum = vmlaq_n_f32(vmulq_n_f32(m.val[0], 6.0f), vaddq_f32(l.val[1], m.val[1]), 4.0f);
+        vst1q_f32(row + dx, vaddq_f32(vaddq_f32(v_sum, l.val[0]), r.val[0]));
+    }
+    return dx;
+}
+
+// Source index of a pyramid tap, -1 for a constant border pixel
+inline ptrdiff_t pyrIndex(ptrdiff_t p, size_t len, BORDER_MODE border)
+{
+    return (size_t)p < len ? p : internal::borderInterpolate(p, len, border);
+}
+
+template <typename T, typename WT>
+void pyrDownHScalar(const T * src, size_t swidth, WT * row, size_t dx0, size_t dx1, u32 cn,
+                    BORDER_MODE border, T borderValue)
+{
+    for (size_t dx = dx0; dx < dx1; ++dx)
+    {
+        ptrdiff_t x[5];
+        for (ptrdiff_t k = 0; k < 5; ++k)
+            x[k] = pyrIndex((ptrdiff_t)dx * 2 + k - 2, swidth, border);
+        for (u32 c = 0; c < cn; ++c)
+        {
+            WT s[5];
+            for (int k = 0; k < 5; ++k)
+                s[k] = x[k] < 0 ? (WT)borderValue : (WT)src[x[k] * cn + c];
+            row[dx * cn + c] = s[2] * 6 + (s[1] + s[3]) * 4 + s[0] + s[4];
+        }
+    }
+}
+
+/*
+ * Vertical passes, r[0..4] are the filtered rows 2dy - 2 .. 2dy + 2
+ */
+
+void pyrDownV(const u16 * const * r, u8 * dst, size_t width, bool rtz)
+{
+    const uint16x8_t v_4 = vdupq_n_u16(4), v_6 = vdupq_n_u16(6);
+    size_t x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        // at most 16 * 16 * 255, still u16
+        uint16x8_t v_sum = vaddq_u16(vld1q_u16(r[0] + x), vld1q_u16(r[4] + x));
+        v_sum = vmlaq_u16(v_sum, vaddq_u16(vld1q_u16(r[1] + x), vld1q_u16(r[3] + x)), v_4);
+        v_sum = vmlaq_u16(v_sum, vld1q_u16(r[2] + x), v_6);
+        vst1_u8(dst + x, rtz ? vshrn_n_u16(v_sum, 8) : vrshrn_n_u16(v_sum, 8));
+    }
+    for (; x < width; ++x)
+    {
+        u32 sum = r[0][x] + r[4][x] + (r[1][x] + r[3][x]) * 4 + r[2][x] * 6;
+        dst[x] = (u8)((sum + (rtz ? 0 : 128)) >> 8);
+    }
+}
+
+void pyrDownV(const s32 * const * r, s16 * dst, size_t width, bool)
+{
+    size_t x = 0;
+    for (; x + 4 <= width; x += 4)
+    {
+        int32x4_t v_sum = vaddq_s32(vld1q_s32(r[0] + x), vld1q_s32(r[4] + x));
+        v_sum = vaddq_s32(v_sum, vshlq_n_s32(vaddq_s32(vld1q_s32(r[1] + x), vld1q_s32(r[3] + x)), 2));
+        v_sum = vmlaq_n_s32(v_sum, vld1q_s32(r[2] + x), 6);
+        vst1_s16(dst + x, vqrshrn_n_s32(v_sum, 8));
+    }
+    for (; x < width; ++x)
+    {
+        s32 sum = r[0][x] + r[4][x] + (r[1][x] + r[3][x]) * 4 + r[2][x] * 6;
+        dst[x] = internal::saturate_cast<s16>((sum + 128) >> 8);
+    }
+}
+
+void pyrDownV(const f32 * const * r, f32 * dst, size_t width, bool)
+{
+    const f32 scale = 1.0f / 256;
+    size_t x = 0;
+    for (; x + 4 <= width; x += 4)
+    {
+        float32x4_t v_sum = vaddq_f32(vld1q_f32(r[0] + x), vld1q_f32(r[4] + x));
+        v_sum = vmlaq_n_f32(v_sum, vaddq_f32(vld1q_f32(r[1] + x), vld1q_f32(r[3] + x)), 4.0f);
+        v_sum = vmlaq_n_f32(v_sum, vld1q_f32(r[2] + x), 6.0f);
+        vst1q_f32(dst + x, vmulq_n_f32(v_sum, scale));
+    }
+    for (; x < width; ++x)
+        dst[x] = ((r[0][x] + r[4][x]) + (r[1][x] + r[3][x]) * 4 + r[2][x] * 6) * scale;
+}
+
+/*
+    Both passes are fused through a ring of five filtered rows keyed by source row, so every
+    source row is filtered horizontally once and no intermediate image is allocated.
+*/
+template <typename T, typename WT, int cn>
+void pyrDown(const Size2D &srcSize, const T * srcBase, ptrdiff_t srcStride,
+             const Size2D &dstSize, T * dstBase, ptrdiff_t dstStride,
+             BORDER_MODE border, T borderValue, bool rtz)
+{
+    const size_t rowLen = dstSize.width * cn;
+    // 5 ring rows, 5 spare rows for border modes whose taps alias in the ring, one constant row
+    std::vector<WT> _buf(rowLen * 11);
+    WT * ring[5], * spare[5];
+    ptrdiff_t ringRow[5];
+    for (int k = 0; k < 5; ++k)
+    {
+        ring[k] = &_buf[rowLen * k];
+        spare[k] = &_buf[rowLen * (k + 5)];
+        ringRow[k] = -1;
+    }
+    WT * constRow = &_buf[rowLen * 10];
+    std::fill(constRow, constRow + rowLen, (WT)borderValue * 16);
+
+    for (size_t dy = 0; dy < dstSize.height; ++dy)
+    {
+        const WT * rows[5];
+        for (ptrdiff_t k = 0; k < 5; ++k)
+        {
+            ptrdiff_t y = pyrIndex((ptrdiff_t)dy * 2 + k - 2, srcSize.height, border);
+            if (y < 0)
+            {
+                rows[k] = constRow;
+                continue;
+            }
+
+            size_t slot = (size_t)y % 5;
+            WT * row = ring[slot];
+            if (ringRow[slot] != y)
+            {
+                bool inUse = false;
+                for (ptrdiff_t j = 0; j < k; ++j)
+                    inUse = inUse || rows[j] == row;
+                if (inUse)
+                    row = spare[k];
+                else
+                    ringRow[slot] = y;
+
+                const T * src = internal::getRowPtr(srcBase, srcStride, y);
+                size_t end = pyrDownHVec<cn>(src, srcSize.width, row, dstSize.width);
+                pyrDownHScalar(src, srcSize.width, row, 0, std::min<size_t>(1, dstSize.width), cn, border, borderValue);
+                pyrDownHScalar(src, srcSize.width, row, end, dstSize.width, cn, border, borderValue);
+            }
+            rows[k] = row;
+        }
+        pyrDownV(rows, internal::getRowPtr(dstBase, dstStride, dy), rowLen, rtz);
+    }
+}
+
+/*
+ * pyrUp: every source pixel x produces s[x - 1] + 6 s[x] + s[x + 1] and 4 (s[x] + s[x + 1]),
+ * mirrored (reflect 101) on the left and top, replicated on the right and bottom as OpenCV does.
+ */
+
+template <int cn> struct Planes8;
+
+template <> struct Planes8<1>
+{
+    uint8x8_t val[1];
+    inline void load(const u8 * p) { val[0] = vld1_u8(p); }
+};
+
+template <> struct Planes8<3>
+{
+    uint8x8_t val[3];
+    inline void load(const u8 * p) { uint8x8x3_t v = vld3_u8(p); val[0] = v.val[0]; val[1] = v.val[1]; val[2] = v.val[2]; }
+};
+
+template <> struct Planes8<4>
+{
+    uint8x8_t val[4];
+    inline void load(const u8 * p) { uint8x8x4_t v = vld4_u8(p); for (int c = 0; c < 4; ++c) val[c] = v.val[c]; }
+};
+
+template <int cn>
+size_t pyrUpHVec(const u8 * src, size_t swidth, u16 * row)
+{
+    const uint8x8_t v_6 = vdup_n_u8(6);
+    size_t x = 1;
+    for (; x + 9 <= swidth; x += 8)
+    {
+        Planes8<cn> l, m, r;
+        l.load(src + (x - 1) * cn);
+        m.load(src + x * cn);
+        r.load(src + (x + 1) * cn);
+        uint16x8_t lo[cn], hi[cn];
+        for (int c = 0; c < cn; ++c)
+        {
+            uint16x8_t v_even = vmlal_u8(vaddl_u8(l.val[c], r.val[c]), m.val[c], v_6);
+            uint16x8_t v_odd = vshlq_n_u16(vaddl_u8(m.val[c], r.val[c]), 2);
+            uint16x8x2_t z = vzipq_u16(v_even, v_odd);
+            lo[c] = z.val[0];
+            hi[c] = z.val[1];
+        }
+        storePlanes<cn>(row + x * 2 * cn, lo);
+        storePlanes<cn>(row + (x * 2 + 8) * cn, hi);
+    }
+    return x;
+}
+
+template <int cn>
+size_t pyrUpHVec(const s16 * src, size_t swidth, s32 * row)
+{
+    if (cn != 1)
+        return 1;
+    size_t x = 1;
+    for (; x + 5 <= swidth; x += 4)
+    {
+        int16x4_t l = vld1_s16(src + x - 1), m = vld1_s16(src + x), r = vld1_s16(src + x + 1);
+        int32x4_t v_even = vmlal_n_s16(vaddl_s16(l, r), m, 6);
+        int32x4_t v_odd = vshlq_n_s32(vaddl_s16(m, r), 2);
+        int32x4x2_t z = vzipq_s32(v_even, v_odd);
+        vst1q_s32(row + x * 2, z.val[0]);
+        vst1q_s32(row + x * 2 + 4, z.val[1]);
+    }
+    return x;
+}
+
+template <typename T, typename WT>
+void pyrUpHScalar(const T * src, size_t swidth, WT * row, size_t x0, size_t x1, u32 cn)
+{
+    for (size_t x = x0; x < x1; ++x)
+    {
+        size_t xl = x > 0 ? x - 1 : std::min<size_t>(1, swidth - 1);
+        size_t xr = std::min(x + 1, swidth - 1);
+        for (u32 c = 0; c < cn; ++c)
+        {
+            WT l = src[xl * cn + c], m = src[x * cn + c], r = src[xr * cn + c];
+            row[x * 2 * cn + c] = l + m * 6 + r;
+            row[(x * 2 + 1) * cn + c] = (m + r) * 4;
+        }
+    }
+}
+
+void pyrUpV(const u16 * r0, const u16 * r1, const u16 * r2, u8 * dst0, u8 * dst1, size_t width)
+{
+    const uint16x8_t v_6 = vdupq_n_u16(6);
+    size_t x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        uint16x8_t v_r1 = vld1q_u16(r1 + x), v_r2 = vld1q_u16(r2 + x);
+        uint16x8_t v_even = vmlaq_u16(vaddq_u16(vld1q_u16(r0 + x), v_r2), v_r1, v_6);
+        uint16x8_t v_odd = vshlq_n_u16(vaddq_u16(v_r1, v_r2), 2);
+        vst1_u8(dst0 + x, vrshrn_n_u16(v_even, 6));
+        vst1_u8(dst1 + x, vrshrn_n_u16(v_odd, 6));
+    }
+    for (; x < width; ++x)
+    {
+        dst0[x] = (u8)((r0[x] + r1[x] * 6 + r2[x] + 32) >> 6);
+        dst1[x] = (u8)(((r1[x] + r2[x]) * 4 + 32) >> 6);
+    }
+}
+
+void pyrUpV(const s32 * r0, const s32 * r1, const s32 * r2, s16 * dst0, s16 * dst1, size_t width)
+{
+    size_t x = 0;
+    for (; x + 4 <= width; x += 4)
+    {
+        int32x4_t v_r1 = vld1q_s32(r1 + x), v_r2 = vld1q_s32(r2 + x);
+        int32x4_t v_even = vmlaq_n_s32(vaddq_s32(vld1q_s32(r0 + x), v_r2), v_r1, 6);
+        int32x4_t v_odd = vshlq_n_s32(vaddq_s32(v_r1, v_r2), 2);
+        vst1_s16(dst0 + x, vqrshrn_n_s32(v_even, 6));
+        vst1_s16(dst1 + x, vqrshrn_n_s32(v_odd, 6));
+    }
+    for (; x < width; ++x)
+    {
+        dst0[x] = internal::saturate_cast<s16>((r0[x] + r1[x] * 6 + r2[x] + 32) >> 6);
+        dst1[x] = internal::saturate_cast<s16>(((r1[x] + r2[x]) * 4 + 32) >> 6);
+    }
+}
+
+// Same ring scheme as pyrDown with three rows: every source row y yields destination rows 2y and 2y + 1
+template <typename T, typename WT, int cn>
+void pyrUp(const Size2D &srcSize, const T * srcBase, ptrdiff_t srcStride,
+           T * dstBase, ptrdiff_t dstStride)
+{
+    const size_t rowLen = srcSize.width * 2 * cn;
+    std::vector<WT> _buf(rowLen * 3);
+    ptrdiff_t ringRow[3] = { -1, -1, -1 };
+
+    for (size_t y = 0; y < srcSize.height; ++y)
+    {
+        const WT * rows[3];
+        for (ptrdiff_t k = 0; k < 3; ++k)
+        {
+            ptrdiff_t sy = internal::borderInterpolate(((ptrdiff_t)y + k - 1) * 2, srcSize.height * 2,
+                                                       BORDER_MODE_REFLECT101) / 2;
+            WT * row = &_buf[rowLen * (sy % 3)];
+            if (ringRow[sy % 3] != sy)
+            {
+                const T * src = internal::getRowPtr(srcBase, srcStride, sy);
+                size_t end = pyrUpHVec<cn>(src, srcSize.width, row);
+                pyrUpHScalar(src, srcSize.width, row, 0, 1, cn);
+                pyrUpHScalar(src, srcSize.width, row, end, srcSize.width, cn);
+                ringRow[sy % 3] = sy;
+            }
+            rows[k] = row;
+        }
+        pyrUpV(rows[0], rows[1], rows[2],
+               internal::getRowPtr(dstBase, dstStride, y * 2),
+               internal::getRowPtr(dstBase, dstStride, y * 2 + 1), rowLen);
+    }
+}
+
+} // namespace
+
+#endif
+
+void gaussianPyramidDownRTZ(const Size2D &srcSize,
+                            const u8 *srcBase, ptrdiff_t srcStride,
+                            const Size2D &dstSize,
+                            u8 *dstBase, ptrdiff_t dstStride,
+                            BORDER_MODE border, u8 borderValue)
+{
+    internal::assertSupportedConfiguration(isGaussianPyramidDownRTZSupported(srcSize, dstSize, border));
+#ifdef CAROTENE_NEON
+    pyrDown<u8, u16, 1>(srcSize, srcBase, srcStride, dstSize, dstBase, dstStride, border, borderValue, true);
+#else
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+    (void)borderValue;
+#endif
+}
+
+void gaussianPyramidDown(const Size2D &srcSize,
+                         const u8 *srcBase, ptrdiff_t srcStride,
+                         const Size2D &dstSize,
+                         u8 *dstBase, ptrdiff_t dstStride, u8 cn)
+{
+    internal::assertSupportedConfiguration(isGaussianPyramidDownU8Supported(srcSize, dstSize, cn));
+#ifdef CAROTENE_NEON
+    if (cn == 1)
+        pyrDown<u8, u16, 1>(srcSize, srcBase, srcStride, dstSize, dstBase, dstStride, BORDER_MODE_REFLECT101, 0, false);
+    else if (cn == 3)
+        pyrDown<u8, u16, 3>(srcSize, srcBase, srcStride, dstSize, dstBase, dstStride, BORDER_MODE_REFLECT101, 0, false);
+    else
+        pyrDown<u8, u16, 4>(srcSize, srcBase, srcStride, dstSize, dstBase, dstStride, BORDER_MODE_REFLECT101, 0, false);
+#else
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+#endif
+}
+
+void gaussianPyramidDown(const Size2D &srcSize,
+                         const s16 *srcBase, ptrdiff_t srcStride,
+                         const Size2D &dstSize,
+                         s16 *dstBase, ptrdiff_t dstStride, u8 cn)
+{
+    internal::assertSupportedConfiguration(isGaussianPyramidDownS16Supported(srcSize, dstSize, cn));
+#ifdef CAROTENE_NEON
+    if (cn == 1)
+        pyrDown<s16, s32, 1>(srcSize, srcBase, srcStride, dstSize, dstBase, dstStride, BORDER_MODE_REFLECT101, 0, false);
+    else if (cn == 3)
+        pyrDown<s16, s32, 3>(srcSize, srcBase, srcStride, dstSize, dstBase, dstStride, BORDER_MODE_REFLECT101, 0, false);
+    else
+        pyrDown<s16, s32, 4>(srcSize, srcBase, srcStride, dstSize, dstBase, dstStride, BORDER_MODE_REFLECT101, 0, false);
+#else
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+#endif
+}
+
+void gaussianPyramidDown(const Size2D &srcSize,
+                         const f32 *srcBase, ptrdiff_t srcStride,
+                         const Size2D &dstSize,
+                         f32 *dstBase, ptrdiff_t dstStride, u8 cn)
+{
+    internal::assertSupportedConfiguration(isGaussianPyramidDownF32Supported(srcSize, dstSize, cn));
+#ifdef CAROTENE_NEON
+    if (cn == 1)
+        pyrDown<f32, f32, 1>(srcSize, srcBase, srcStride, dstSize, dstBase, dstStride, BORDER_MODE_REFLECT101, 0, false);
+    else if (cn == 3)
+        pyrDown<f32, f32, 3>(srcSize, srcBase, srcStride, dstSize, dstBase, dstStride, BORDER_MODE_REFLECT101, 0, false);
+    else
+        pyrDown<f32, f32, 4>(srcSize, srcBase, srcStride, dstSize, dstBase, dstStride, BORDER_MODE_REFLECT101, 0, false);
+#else
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+#endif
+}
+
+void gaussianPyramidUp(const Size2D &srcSize,
+                       const u8 *srcBase, ptrdiff_t srcStride,
+                       const Size2D &dstSize,
+                       u8 *dstBase, ptrdiff_t dstStride, u8 cn)
+{
+    internal::assertSupportedConfiguration(isGaussianPyramidUpU8Supported(srcSize, dstSize, cn));
+#ifdef CAROTENE_NEON
+    if (cn == 1)
+        pyrUp<u8, u16, 1>(srcSize, srcBase, srcStride, dstBase, dstStride);
+    else if (cn == 3)
+        pyrUp<u8, u16, 3>(srcSize, srcBase, srcStride, dstBase, dstStride);
+    else
+        pyrUp<u8, u16, 4>(srcSize, srcBase, srcStride, dstBase, dstStride);
+#else
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+#endif
+}
+
+void gaussianPyramidUp(const Size2D &srcSize,
+                       const s16 *srcBase, ptrdiff_t srcStride,
+                       const Size2D &dstSize,
+                       s16 *dstBase, ptrdiff_t dstStride, u8 cn)
+{
+    internal::assertSupportedConfiguration(isGaussianPyramidUpS16Supported(srcSize, dstSize, cn));
+#ifdef CAROTENE_NEON
+    if (cn == 1)
+        pyrUp<s16, s32, 1>(srcSize, srcBase, srcStride, dstBase, dstStride);
+    else if (cn == 3)
+        pyrUp<s16, s32, 3>(srcSize, srcBase, srcStride, dstBase, dstStride);
+    else
+        pyrUp<s16, s32, 4>(srcSize, srcBase, srcStride, dstBase, dstStride);
+#else
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+#endif
+}
+
+} // namespace CAROTENE_NS
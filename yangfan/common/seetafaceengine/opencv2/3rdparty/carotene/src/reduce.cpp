@@ -0,0 +1,231 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "common.hpp"
+#include "vtransform.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace CAROTENE_NS {
+
+/*
+    The reductions walk the image row by row, which reads it as one stream, and keep one
+    running value per column. Sums of u8 run in u16 lanes for up to 257 rows at a time,
+    257 * 255 fits in u16, and are then widened into the s32 result.
+*/
+
+void reduceColSum(const Size2D &size,
+                  const u8 * srcBase, ptrdiff_t srcStride,
+                  s32 * dstBase)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    std::memset(dstBase, 0, size.width * sizeof(s32));
+    std::vector<u16> _partial(size.width);
+    u16 * partial = &_partial[0];
+    const size_t roiw16 = size.width >= 15 ? size.width - 15 : 0;
+
+    for (size_t i0 = 0; i0 < size.height; i0 += 257)
+    {
+        const size_t rows = std::min<size_t>(257, size.height - i0);
+        std::memset(partial, 0, size.width * sizeof(u16));
+
+        for (size_t i = i0; i < i0 + rows; ++i)
+        {
+            const u8 * src = internal::getRowPtr(srcBase, srcStride, i);
+            size_t j = 0;
+            for (; j < roiw16; j += 16)
+            {
+                internal::prefetch(src + j);
+                uint8x16_t v_src = vld1q_u8(src + j);
+                vst1q_u16(partial + j, vaddw_u8(vld1q_u16(partial + j), vget_low_u8(v_src)));
+                vst1q_u16(partial + j + 8, vaddw_u8(vld1q_u16(partial + j + 8), vget_high_u8(v_src)));
+            }
+            for (; j < size.width; ++j)
+                partial[j] += src[j];
+        }
+
+        size_t j = 0;
+        for (; j < roiw16; j += 16)
+            for (size_t k = 0; k < 16; k += 4)
+                vst1q_s32(dstBase + j + k, vreinterpretq_s32_u32(vaddw_u16(vreinterpretq_u32_s32(vld1q_s32(dstBase + j + k)),
+                                                                           vld1_u16(partial + j + k))));
+        for (; j < size.width; ++j)
+            dstBase[j] += partial[j];
+    }
+#else
+    (void)size;
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+#endif
+}
+
+#ifdef CAROTENE_NEON
+
+namespace {
+
+template <typename T, typename Op>
+void reduceColumns(const Size2D &size, const T * srcBase, ptrdiff_t srcStride, T * dstBase, const Op & op)
+{
+    typedef typename internal::VecTraits<T>::vec128 vec128;
+    const size_t step = 16 / sizeof(T);
+    const size_t roiw = size.width >= step - 1 ? size.width - (step - 1) : 0;
+
+    std::memcpy(dstBase, srcBase, size.width * sizeof(T));
+    for (size_t i = 1; i < size.height; ++i)
+    {
+        const T * src = internal::getRowPtr(srcBase, srcStride, i);
+        size_t j = 0;
+        for (; j < roiw; j += step)
+        {
+            internal::prefetch(src + j);
+            vec128 v_dst = internal::vld1q(dstBase + j);
+            internal::vst1q(dstBase + j, op(v_dst, internal::vld1q(src + j)));
+        }
+        for (; j < size.width; ++j)
+            dstBase[j] = op(dstBase[j], src[j]);
+    }
+}
+
+struct ColMax
+{
+    template <typename V>
+    V operator()(const V & a, const V & b) const { return internal::vmaxq(a, b); }
+    u8 operator()(u8 a, u8 b) const { return std::max(a, b); }
+    f32 operator()(f32 a, f32 b) const { return std::max(a, b); }
+};
+
+struct ColMin
+{
+    template <typename V>
+    V operator()(const V & a, const V & b) const { return internal::vminq(a, b); }
+    u8 operator()(u8 a, u8 b) const { return std::min(a, b); }
+    f32 operator()(f32 a, f32 b) const { return std::min(a, b); }
+};
+
+struct ColSum
+{
+    float32x4_t operator()(const float32x4_t & a, const float32x4_t & b) const { return vaddq_f32(a, b); }
+    f32 operator()(f32 a, f32 b) const { return a + b; }
+};
+
+} // namespace
+
+#endif
+
+void reduceColMax(const Size2D &size,
+                  const u8 * srcBase, ptrdiff_t srcStride,
+                  u8 * dstBase)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    reduceColumns(size, srcBase, srcStride, dstBase, ColMax());
+#else
+    (void)size;
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+#endif
+}
+
+void reduceColMin(const Size2D &size,
+                  const u8 * srcBase, ptrdiff_t srcStride,
+                  u8 * dstBase)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    reduceColumns(size, srcBase, srcStride, dstBase, ColMin());
+#else
+    (void)size;
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+#endif
+}
+
+void reduceColSum(const Size2D &size,
+                  const f32 * srcBase, ptrdiff_t srcStride,
+                  f32 * dstBase)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    // f32 running sums in row order, as cv::reduce accumulates CV_32F into CV_32F
+    reduceColumns(size, srcBase, srcStride, dstBase, ColSum());
+#else
+    (void)size;
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+#endif
+}
+
+void reduceColMax(const Size2D &size,
+                  const f32 * srcBase, ptrdiff_t srcStride,
+                  f32 * dstBase)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    reduceColumns(size, srcBase, srcStride, dstBase, ColMax());
+#else
+    (void)size;
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+#endif
+}
+
+void reduceColMin(const Size2D &size,
+                  const f32 * srcBase, ptrdiff_t srcStride,
+                  f32 * dstBase)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    reduceColumns(size, srcBase, srcStride, dstBase, ColMin());
+#else
+    (void)size;
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+#endif
+}
+
+} // namespace CAROTENE_NS
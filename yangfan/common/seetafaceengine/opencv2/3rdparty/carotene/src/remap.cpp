@@ -0,0 +1,434 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "remap.hpp"
+
+#include <climits>
+
+namespace CAROTENE_NS {
+
+bool isRemapNearestNeighborSupported(const Size2D &ssize)
+{
+    // coordinates are gathered through s16 maps
+    return isSupportedConfiguration() &&
+           (ssize.width < SHRT_MAX) && (ssize.height < SHRT_MAX);
+}
+
+bool isRemapLinearSupported(const Size2D &ssize)
+{
+    return isSupportedConfiguration() &&
+           (ssize.width < SHRT_MAX) && (ssize.height < SHRT_MAX);
+}
+
+#ifdef CAROTENE_NEON
+
+namespace internal {
+
+namespace {
+
+// Lanes whose coordinates lie in [0, xlimit) x [0, ylimit); negative values wrap to large unsigned ones
+inline bool allInside(int16x8x2_t v, u16 xlimit, u16 ylimit)
+{
+    uint16x8_t inX = vcltq_u16(vreinterpretq_u16_s16(v.val[0]), vdupq_n_u16(xlimit));
+    uint16x8_t inY = vcltq_u16(vreinterpretq_u16_s16(v.val[1]), vdupq_n_u16(ylimit));
+    uint8x8_t in = vmovn_u16(vandq_u16(inX, inY));
+    return vget_lane_u64(vreinterpret_u64_u8(in), 0) == ~(u64)0;
+}
+
+// Pixel at (x, y) for any coordinate, with the extrapolation of borderMode
+inline u8 borderPixel(const Size2D &ssize, const u8 * srcBase, ptrdiff_t srcStride,
+                      ptrdiff_t x, ptrdiff_t y, BORDER_MODE borderMode, u8 borderValue)
+{
+    if ((size_t)x < ssize.width && (size_t)y < ssize.height)
+        return internal::getRowPtr(srcBase, srcStride, y)[x];
+    if (borderMode == BORDER_MODE_CONSTANT)
+        return borderValue;
+    x = borderInterpolate(x, ssize.width, borderMode);
+    y = borderInterpolate(y, ssize.height, borderMode);
+    return internal::getRowPtr(srcBase, srcStride, y)[x];
+}
+
+} // namespace
+
+void remapNearestNeighborTile(const Size2D &ssize, const Size2D &size,
+                              const u8 * srcBase, ptrdiff_t srcStride,
+                              const s16 * xy, ptrdiff_t xyStride,
+                              u8 * dstBase, ptrdiff_t dstStride,
+                              BORDER_MODE borderMode, u8 borderValue)
+{
+    if (borderMode == BORDER_MODE_UNDEFINED)
+        borderMode = BORDER_MODE_REPLICATE;
+
+    for (size_t y = 0; y < size.height; ++y)
+    {
+        const s16 * map = internal::getRowPtr(xy, xyStride, y);
+        u8 * dst = internal::getRowPtr(dstBase, dstStride, y);
+
+        size_t x = 0;
+        for (; x + 8 <= size.width; x += 8)
+        {
+            // NEON has no gather, so only the range test is vectorised
+            if (allInside(vld2q_s16(map + x * 2), (u16)ssize.width, (u16)ssize.height))
+            {
+                for (size_t i = x; i < x + 8; ++i)
+                    dst[i] = internal::getRowPtr(srcBase, srcStride, map[i * 2 + 1])[map[i * 2]];
+            }
+            else
+            {
+                for (size_t i = x; i < x + 8; ++i)
+                    dst[i] = borderPixel(ssize, srcBase, srcStride, map[i * 2], map[i * 2 + 1], borderMode, borderValue);
+            }
+        }
+        for (; x < size.width; ++x)
+            dst[x] = borderPixel(ssize, srcBase, srcStride, map[x * 2], map[x * 2 + 1], borderMode, borderValue);
+    }
+}
+
+void remapLinearTile(const Size2D &ssize, const Size2D &size,
+                     const u8 * srcBase, ptrdiff_t srcStride,
+                     const s16 * xy, ptrdiff_t xyStride,
+                     const u16 * alpha, ptrdiff_t alphaStride,
+                     u8 * dstBase, ptrdiff_t dstStride,
+                     BORDER_MODE borderMode, u8 borderValue)
+{
+    if (borderMode == BORDER_MODE_UNDEFINED)
+        borderMode = BORDER_MODE_REPLICATE;
+
+    const u16 one = INTER_TAB_SIZE;
+    const uint16x8_t v_mask = vdupq_n_u16(INTER_TAB_SIZE - 1), v_one = vdupq_n_u16(one);
+    // both taps of a lane are inside when x < width - 1 and y < height - 1
+    u16 xlimit = (u16)(ssize.width - 1), ylimit = (u16)(ssize.height - 1);
+
+    for (size_t y = 0; y < size.height; ++y)
+    {
+        const s16 * map = internal::getRowPtr(xy, xyStride, y);
+        const u16 * a = internal::getRowPtr(alpha, alphaStride, y);
+        u8 * dst = internal::getRowPtr(dstBase, dstStride, y);
+
+        size_t x = 0;
+        for (; x + 8 <= size.width; x += 8)
+        {
+            u8 p00[8], p01[8], p10[8], p11[8];
+            if (allInside(vld2q_s16(map + x * 2), xlimit, ylimit))
+            {
+                for (size_t i = 0; i < 8; ++i)
+                {
+                    const u8 * s = internal::getRowPtr(srcBase, srcStride, map[(x + i) * 2 + 1]) + map[(x + i) * 2];
+                    const u8 * s1 = internal::getRowPtr(s, srcStride, 1);
+                    p00[i] = s[0];
+                    p01[i] = s[1];
+                    p10[i] = s1[0];
+                    p11[i] = s1[1];
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < 8; ++i)
+                {
+                    ptrdiff_t sx = map[(x + i) * 2], sy = map[(x + i) * 2 + 1];
+                    p00[i] = borderPixel(ssize, srcBase, srcStride, sx, sy, borderMode, borderValue);
+                    p01[i] = borderPixel(ssize, srcBase, srcStride, sx + 1, sy, borderMode, borderValue);
+                    p10[i] = borderPixel(ssize, srcBase, srcStride, sx, sy + 1, borderMode, borderValue);
+                    p11[i] = borderPixel(ssize, srcBase, srcStride, sx + 1, sy + 1, borderMode, borderValue);
+                }
+            }
+
+            // Q5 x Q5 weights, (sum + 2^9) >> 10 equals OpenCV's Q15 tables for these fractions
+            uint16x8_t v_a = vld1q_u16(a + x);
+            uint16x8_t v_fx = vandq_u16(v_a, v_mask), v_fy = vshrq_n_u16(v_a, INTER_BITS);
+            uint16x8_t v_gx = vsubq_u16(v_one, v_fx), v_gy = vsubq_u16(v_one, v_fy);
+            uint16x8_t v_t0 = vmlaq_u16(vmulq_u16(vmovl_u8(vld1_u8(p00)), v_gx), vmovl_u8(vld1_u8(p01)), v_fx);
+            uint16x8_t v_t1 = vmlaq_u16(vmulq_u16(vmovl_u8(vld1_u8(p10)), v_gx), vmovl_u8(vld1_u8(p11)), v_fx);
+            uint32x4_t v_lo = vmlal_u16(vmull_u16(vget_low_u16(v_t0), vget_low_u16(v_gy)), vget_low_u16(v_t1), vget_low_u16(v_fy));
+            uint32x4_t v_hi = vmlal_u16(vmull_u16(vget_high_u16(v_t0), vget_high_u16(v_gy)), vget_high_u16(v_t1), vget_high_u16(v_fy));
+            uint16x8_t v_r = vcombine_u16(vrshrn_n_u32(v_lo, INTER_BITS * 2), vrshrn_n_u32(v_hi, INTER_BITS * 2));
+            vst1_u8(dst + x, vmovn_u16(v_r));
+        }
+        for (; x < size.width; ++x)
+        {
+            ptrdiff_t sx = map[x * 2], sy = map[x * 2 + 1];
+            u32 fx = a[x] & (INTER_TAB_SIZE - 1), fy = a[x] >> INTER_BITS;
+            u32 t0 = borderPixel(ssize, srcBase, srcStride, sx, sy, borderMode, borderValue) * (one - fx) +
+                     borderPixel(ssize, srcBase, srcStride, sx + 1, sy, borderMode, borderValue) * fx;
+            u32 t1 = borderPixel(ssize, srcBase, srcStride, sx, sy + 1, borderMode, borderValue) * (one - fx) +
+                     borderPixel(ssize, srcBase, srcStride, sx + 1, sy + 1, borderMode, borderValue) * fx;
+            dst[x] = (u8)((t0 * (one - fy) + t1 * fy + (1 << (INTER_BITS * 2 - 1))) >> (INTER_BITS * 2));
+        }
+    }
+}
+
+} // namespace internal
+
+namespace {
+
+// Scalar counterpart of internal::vroundq_s32_f32
+inline s32 roundHalfAway(f32 v)
+{
+    v = std::min(std::max(v, -(f32)(1 << 30)), (f32)(1 << 30));
+    return (s32)(v + (v < 0 ? -0.5f : 0.5f));
+}
+
+// One row of remapConvertMaps, alpha is NULL for nearest neighbor maps
+void convertMapsRow(const f32 * table, s16 * xy, u16 * alpha, size_t width)
+{
+    size_t x = 0;
+    if (alpha)
+    {
+        const float32x4_t v_scale = vdupq_n_f32((f32)internal::INTER_TAB_SIZE);
+        const int32x4_t v_mask = vdupq_n_s32(internal::INTER_TAB_SIZE - 1);
+        for (; x + 4 <= width; x += 4)
+        {
+            float32x4x2_t v_table = vld2q_f32(table + x * 2);
+            int32x4_t v_X = internal::vroundq_s32_f32(vmulq_f32(v_table.val[0], v_scale));
+            int32x4_t v_Y = internal::vroundq_s32_f32(vmulq_f32(v_table.val[1], v_scale));
+            int16x4x2_t v_xy;
+            v_xy.val[0] = vqmovn_s32(vshrq_n_s32(v_X, internal::INTER_BITS));
+            v_xy.val[1] = vqmovn_s32(vshrq_n_s32(v_Y, internal::INTER_BITS));
+            vst2_s16(xy + x * 2, v_xy);
+            int32x4_t v_a = vorrq_s32(vshlq_n_s32(vandq_s32(v_Y, v_mask), internal::INTER_BITS),
+                                      vandq_s32(v_X, v_mask));
+            vst1_u16(alpha + x, vmovn_u32(vreinterpretq_u32_s32(v_a)));
+        }
+    }
+    else
+    {
+        for (; x + 4 <= width; x += 4)
+        {
+            float32x4x2_t v_table = vld2q_f32(table + x * 2);
+            int16x4x2_t v_xy;
+            v_xy.val[0] = vqmovn_s32(internal::vroundq_s32_f32(v_table.val[0]));
+            v_xy.val[1] = vqmovn_s32(internal::vroundq_s32_f32(v_table.val[1]));
+            vst2_s16(xy + x * 2, v_xy);
+        }
+    }
+
+    f32 scale = alpha ? (f32)internal::INTER_TAB_SIZE : 1.0f;
+    for (; x < width; ++x)
+    {
+        s32 X = roundHalfAway(table[x * 2] * scale);
+        s32 Y = roundHalfAway(table[x * 2 + 1] * scale);
+        if (alpha)
+        {
+            xy[x * 2] = internal::saturate_cast<s16>(X >> internal::INTER_BITS);
+            xy[x * 2 + 1] = internal::saturate_cast<s16>(Y >> internal::INTER_BITS);
+            alpha[x] = (u16)(((Y & (internal::INTER_TAB_SIZE - 1)) << internal::INTER_BITS) |
+                             (X & (internal::INTER_TAB_SIZE - 1)));
+        }
+        else
+        {
+            xy[x * 2] = internal::saturate_cast<s16>(X);
+            xy[x * 2 + 1] = internal::saturate_cast<s16>(Y);
+        }
+    }
+}
+
+} // namespace
+
+#endif
+
+void remapConvertMaps(const Size2D &size,
+                      const f32 * tableBase, ptrdiff_t tableStride,
+                      s16 * xyBase, ptrdiff_t xyStride,
+                      u16 * alphaBase, ptrdiff_t alphaStride)
+{
+    internal::assertSupportedConfiguration();
+#ifdef CAROTENE_NEON
+    for (size_t y = 0; y < size.height; ++y)
+        convertMapsRow(internal::getRowPtr(tableBase, tableStride, y),
+                       internal::getRowPtr(xyBase, xyStride, y),
+                       alphaBase ? internal::getRowPtr(alphaBase, alphaStride, y) : NULL,
+                       size.width);
+#else
+    (void)size;
+    (void)tableBase;
+    (void)tableStride;
+    (void)xyBase;
+    (void)xyStride;
+    (void)alphaBase;
+    (void)alphaStride;
+#endif
+}
+
+void remapNearestNeighbor(const Size2D &ssize, const Size2D &dsize,
+                          const u8 * srcBase, ptrdiff_t srcStride,
+                          const f32 * tableBase, ptrdiff_t tableStride,
+                          u8 * dstBase, ptrdiff_t dstStride,
+                          BORDER_MODE borderMode, u8 borderValue)
+{
+    internal::assertSupportedConfiguration(isRemapNearestNeighborSupported(ssize));
+#ifdef CAROTENE_NEON
+    // float tables are converted a tile at a time, right before the gather that consumes them
+    const size_t block = internal::REMAP_BLOCK_SIZE;
+    s16 xy[block * block * 2];
+
+    for (size_t by = 0; by < dsize.height; by += block)
+    {
+        size_t bh = std::min(block, dsize.height - by);
+        for (size_t bx = 0; bx < dsize.width; bx += block)
+        {
+            Size2D tile(std::min(block, dsize.width - bx), bh);
+            for (size_t y = 0; y < bh; ++y)
+                convertMapsRow(internal::getRowPtr(tableBase, tableStride, by + y) + bx * 2,
+                               xy + y * block * 2, NULL, tile.width);
+            internal::remapNearestNeighborTile(ssize, tile, srcBase, srcStride, xy, sizeof(xy) / block,
+                                               internal::getRowPtr(dstBase, dstStride, by) + bx, dstStride,
+                                               borderMode, borderValue);
+        }
+    }
+#else
+    (void)dsize;
+    (void)srcBase;
+    (void)srcStride;
+    (void)tableBase;
+    (void)tableStride;
+    (void)dstBase;
+    (void)dstStride;
+    (void)borderMode;
+    (void)borderValue;
+#endif
+}
+
+void remapLinear(const Size2D &ssize, const Size2D &dsize,
+                 const u8 * srcBase, ptrdiff_t srcStride,
+                 const f32 * tableBase, ptrdiff_t tableStride,
+                 u8 * dstBase, ptrdiff_t dstStride,
+                 BORDER_MODE borderMode, u8 borderValue)
+{
+    internal::assertSupportedConfiguration(isRemapLinearSupported(ssize));
+#ifdef CAROTENE_NEON
+    const size_t block = internal::REMAP_BLOCK_SIZE;
+    s16 xy[block * block * 2];
+    u16 alpha[block * block];
+
+    for (size_t by = 0; by < dsize.height; by += block)
+    {
+        size_t bh = std::min(block, dsize.height - by);
+        for (size_t bx = 0; bx < dsize.width; bx += block)
+        {
+            Size2D tile(std::min(block, dsize.width - bx), bh);
+            for (size_t y = 0; y < bh; ++y)
+                convertMapsRow(internal::getRowPtr(tableBase, tableStride, by + y) + bx * 2,
+                               xy + y * block * 2, alpha + y * block, tile.width);
+            internal::remapLinearTile(ssize, tile, srcBase, srcStride,
+                                      xy, sizeof(xy) / block, alpha, sizeof(alpha) / block,
+                                      internal::getRowPtr(dstBase, dstStride, by) + bx, dstStride,
+                                      borderMode, borderValue);
+        }
+    }
+#else
+    (void)dsize;
+    (void)srcBase;
+    (void)srcStride;
+    (void)tableBase;
+    (void)tableStride;
+    (void)dstBase;
+    (void)dstStride;
+    (void)borderMode;
+    (void)borderValue;
+#endif
+}
+
+void remapNearestNeighbor(const Size2D &ssize, const Size2D &dsize,
+                          const u8 * srcBase, ptrdiff_t srcStride,
+                          const s16 * xyBase, ptrdiff_t xyStride,
+                          u8 * dstBase, ptrdiff_t dstStride,
+                          BORDER_MODE borderMode, u8 borderValue)
+{
+    internal::assertSupportedConfiguration(isRemapNearestNeighborSupported(ssize));
+#ifdef CAROTENE_NEON
+    // tiles keep the source rows touched by neighbouring destination rows in cache
+    const size_t block = internal::REMAP_BLOCK_SIZE;
+    for (size_t by = 0; by < dsize.height; by += block)
+        for (size_t bx = 0; bx < dsize.width; bx += block)
+        {
+            Size2D tile(std::min(block, dsize.width - bx), std::min(block, dsize.height - by));
+            internal::remapNearestNeighborTile(ssize, tile, srcBase, srcStride,
+                                               internal::getRowPtr(xyBase, xyStride, by) + bx * 2, xyStride,
+                                               internal::getRowPtr(dstBase, dstStride, by) + bx, dstStride,
+                                               borderMode, borderValue);
+        }
+#else
+    (void)dsize;
+    (void)srcBase;
+    (void)srcStride;
+    (void)xyBase;
+    (void)xyStride;
+    (void)dstBase;
+    (void)dstStride;
+    (void)borderMode;
+    (void)borderValue;
+#endif
+}
+
+void remapLinear(const Size2D &ssize, const Size2D &dsize,
+                 const u8 * srcBase, ptrdiff_t srcStride,
+                 const s16 * xyBase, ptrdiff_t xyStride,
+                 const u16 * alphaBase, ptrdiff_t alphaStride,
+                 u8 * dstBase, ptrdiff_t dstStride,
+                 BORDER_MODE borderMode, u8 borderValue)
+{
+    internal::assertSupportedConfiguration(isRemapLinearSupported(ssize));
+#ifdef CAROTENE_NEON
+    const size_t block = internal::REMAP_BLOCK_SIZE;
+    for (size_t by = 0; by < dsize.height; by += block)
+        for (size_t bx = 0; bx < dsize.width; bx += block)
+        {
+            Size2D tile(std::min(block, dsize.width - bx), std::min(block, dsize.height - by));
+            internal::remapLinearTile(ssize, tile, srcBase, srcStride,
+                                      internal::getRowPtr(xyBase, xyStride, by) + bx * 2, xyStride,
+                                      internal::getRowPtr(alphaBase, alphaStride, by) + bx, alphaStride,
+                                      internal::getRowPtr(dstBase, dstStride, by) + bx, dstStride,
+                                      borderMode, borderValue);
+        }
+#else
+    (void)dsize;
+    (void)srcBase;
+    (void)srcStride;
+    (void)xyBase;
+    (void)xyStride;
+    (void)alphaBase;
+    (void)alphaStride;
+    (void)dstBase;
+    (void)dstStride;
+    (void)borderMode;
+    (void)borderValue;
+#endif
+}
+
+} // namespace CAROTENE_NS
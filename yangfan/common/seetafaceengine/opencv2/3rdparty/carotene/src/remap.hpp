@@ -0,0 +1,93 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#ifndef CAROTENE_SRC_REMAP_HPP
+#define CAROTENE_SRC_REMAP_HPP
+
+#include "common.hpp"
+
+#ifdef CAROTENE_NEON
+
+namespace CAROTENE_NS { namespace internal {
+
+enum
+{
+    // destination tiles are mapped and gathered while the coordinate maps stay in L1
+    REMAP_BLOCK_SIZE = 16,
+    // bilinear fractions are quantized to 1 / INTER_TAB_SIZE as in OpenCV
+    INTER_BITS = 5,
+    INTER_TAB_SIZE = 1 << INTER_BITS
+};
+
+// Round half away from zero, after clamping to a range the conversion can represent
+inline int32x4_t vroundq_s32_f32(float32x4_t v)
+{
+    const float32x4_t v_limit = vdupq_n_f32((f32)(1 << 30));
+    v = vminq_f32(vmaxq_f32(v, vnegq_f32(v_limit)), v_limit);
+    uint32x4_t v_sign = vandq_u32(vreinterpretq_u32_f32(v), vdupq_n_u32(0x80000000u));
+    float32x4_t v_half = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(vdupq_n_f32(0.5f)), v_sign));
+    return vcvtq_s32_f32(vaddq_f32(v, v_half));
+}
+
+/*
+    Gathers `size` destination pixels from the source image by the (x, y) pairs of `xy`,
+    the layout of OpenCV CV_16SC2 maps.
+*/
+void remapNearestNeighborTile(const Size2D &ssize, const Size2D &size,
+                              const u8 * srcBase, ptrdiff_t srcStride,
+                              const s16 * xy, ptrdiff_t xyStride,
+                              u8 * dstBase, ptrdiff_t dstStride,
+                              BORDER_MODE borderMode, u8 borderValue);
+
+/*
+    Same as above with bilinear interpolation: `alpha` holds fy * INTER_TAB_SIZE + fx for
+    the fractional part of every coordinate, the layout of OpenCV CV_16UC1 maps.
+*/
+void remapLinearTile(const Size2D &ssize, const Size2D &size,
+                     const u8 * srcBase, ptrdiff_t srcStride,
+                     const s16 * xy, ptrdiff_t xyStride,
+                     const u16 * alpha, ptrdiff_t alphaStride,
+                     u8 * dstBase, ptrdiff_t dstStride,
+                     BORDER_MODE borderMode, u8 borderValue);
+
+}}
+
+#endif
+
+#endif
@@ -0,0 +1,981 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "common.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace CAROTENE_NS {
+
+bool isResizeNearestNeighborSupported(const Size2D &ssize, u32 elemSize)
+{
+    (void)ssize;
+    bool supportedElemSize = (elemSize == 1) || (elemSize == 3) || (elemSize == 4);
+    return isSupportedConfiguration() && supportedElemSize;
+}
+
+bool isResizeAreaSupported(f32 wr, f32 hr, u32 channels)
+{
+    bool supportedRatio = (hr == wr) && ((wr == 2.0f) || (wr == 4.0f) || (wr == 0.5f));
+    bool supportedChannels = (channels == 1) || (channels == 3) || (channels == 4);
+    return isSupportedConfiguration() && supportedRatio && supportedChannels;
+}
+
+bool isResizeLinearOpenCVSupported(const Size2D &ssize, const Size2D &dsize, u32 channels)
+{
+    bool supportedChannels = (channels == 1) || (channels == 3) || (channels == 4);
+    return isSupportedConfiguration() && supportedChannels &&
+           (ssize.width >= 8) && (ssize.height >= 8) &&
+           (dsize.width > 0) && (dsize.height > 0);
+}
+
+bool isResizeLinearSupported(const Size2D &ssize, const Size2D &dsize,
+                             f32 wr, f32 hr, u32 channels)
+{
+    bool supportedChannels = (channels == 1) || (channels == 3) || (channels == 4);
+    return isSupportedConfiguration() && supportedChannels &&
+           (wr > 0.0f) && (hr > 0.0f) &&
+           (ssize.width >= 2) && (ssize.height >= 2) &&
+           (dsize.width > 0) && (dsize.height > 0);
+}
+
+#ifdef CAROTENE_NEON
+
+namespace {
+
+// Deinterleaving loads/stores of 16 (or 8) pixels, one u8 plane per channel, so that
+// the per-channel arithmetic below is shared by C1, C3 and C4 images.
+template <int cn> struct Planes;
+
+template <> struct Planes<1>
+{
+    uint8x16_t val[1];
+    inline void load(const u8 * p) { val[0] = vld1q_u8(p); }
+    inline void store(u8 * p) const { vst1q_u8(p, val[0]); }
+};
+
+template <> struct Planes<3>
+{
+    uint8x16_t val[3];
+    inline void load(const u8 * p) { uint8x16x3_t v = vld3q_u8(p); val[0] = v.val[0]; val[1] = v.val[1]; val[2] = v.val[2]; }
+    inline void store(u8 * p) const { uint8x16x3_t v; v.val[0] = val[0]; v.val[1] = val[1]; v.val[2] = val[2]; vst3q_u8(p, v); }
+};
+
+template <> struct Planes<4>
+{
+    uint8x16_t val[4];
+    inline void load(const u8 * p) { uint8x16x4_t v = vld4q_u8(p); for (int c = 0; c < 4; ++c) val[c] = v.val[c]; }
+    inline void store(u8 * p) const { uint8x16x4_t v; for (int c = 0; c < 4; ++c) v.val[c] = val[c]; vst4q_u8(p, v); }
+};
+
+template <int cn> struct HalfPlanes;
+
+template <> struct HalfPlanes<1>
+{
+    uint8x8_t val[1];
+    inline void store(u8 * p) const { vst1_u8(p, val[0]); }
+};
+
+template <> struct HalfPlanes<3>
+{
+    uint8x8_t val[3];
+    inline void store(u8 * p) const { uint8x8x3_t v; v.val[0] = val[0]; v.val[1] = val[1]; v.val[2] = val[2]; vst3_u8(p, v); }
+};
+
+template <> struct HalfPlanes<4>
+{
+    uint8x8_t val[4];
+    inline void store(u8 * p) const { uint8x8x4_t v; for (int c = 0; c < 4; ++c) v.val[c] = val[c]; vst4_u8(p, v); }
+};
+
+inline uint8x16_t evenLanes(uint8x16_t a, uint8x16_t b)
+{
+    return vuzpq_u8(a, b).val[0];
+}
+
+/*
+ * Nearest neighbor
+ */
+
+template <int cn>
+void nearestRow2x(const u8 * src, u8 * dst, size_t dwidth)
+{
+    size_t dx = 0;
+    if (cn == 4)
+    {
+        // rows are only byte aligned, so whole pixels are picked from byte loads
+        for (; dx + 4 <= dwidth; dx += 4)
+        {
+            uint32x4_t a = vreinterpretq_u32_u8(vld1q_u8(src + dx * 8));
+            uint32x4_t b = vreinterpretq_u32_u8(vld1q_u8(src + dx * 8 + 16));
+            vst1q_u8(dst + dx * 4, vreinterpretq_u8_u32(vuzpq_u32(a, b).val[0]));
+        }
+    }
+    else
+    {
+        for (; dx + 16 <= dwidth; dx += 16)
+        {
+            internal::prefetch(src + dx * 2 * cn);
+            Planes<cn> a, b, r;
+            a.load(src + dx * 2 * cn);
+            b.load(src + dx * 2 * cn + 16 * cn);
+            for (int c = 0; c < cn; ++c)
+                r.val[c] = evenLanes(a.val[c], b.val[c]);
+            r.store(dst + dx * cn);
+        }
+    }
+    for (; dx < dwidth; ++dx)
+        for (int c = 0; c < cn; ++c)
+            dst[dx * cn + c] = src[dx * 2 * cn + c];
+}
+
+template <int cn>
+void nearestRow4x(const u8 * src, u8 * dst, size_t dwidth)
+{
+    size_t dx = 0;
+    if (cn == 1)
+    {
+        for (; dx + 16 <= dwidth; dx += 16)
+        {
+            internal::prefetch(src + dx * 4);
+            vst1q_u8(dst + dx, vld4q_u8(src + dx * 4).val[0]);
+        }
+    }
+    else if (cn == 4)
+    {
+        for (; dx + 4 <= dwidth; dx += 4)
+        {
+            const u8 * s = src + dx * 16;
+            uint32x4_t ab = vuzpq_u32(vreinterpretq_u32_u8(vld1q_u8(s)), vreinterpretq_u32_u8(vld1q_u8(s + 16))).val[0];
+            uint32x4_t cd = vuzpq_u32(vreinterpretq_u32_u8(vld1q_u8(s + 32)), vreinterpretq_u32_u8(vld1q_u8(s + 48))).val[0];
+            vst1q_u8(dst + dx * 4, vreinterpretq_u8_u32(vuzpq_u32(ab, cd).val[0]));
+        }
+    }
+    for (; dx < dwidth; ++dx)
+        for (int c = 0; c < cn; ++c)
+            dst[dx * cn + c] = src[dx * 4 * cn + c];
+}
+
+template <int cn>
+void nearestRow(const u8 * src, u8 * dst, const u32 * xofs, size_t dwidth)
+{
+    size_t dx = 0;
+    if (cn == 1)
+    {
+        for (; dx + 8 <= dwidth; dx += 8)
+        {
+            dst[dx + 0] = src[xofs[dx + 0]];
+            dst[dx + 1] = src[xofs[dx + 1]];
+            dst[dx + 2] = src[xofs[dx + 2]];
+            dst[dx + 3] = src[xofs[dx + 3]];
+            dst[dx + 4] = src[xofs[dx + 4]];
+            dst[dx + 5] = src[xofs[dx + 5]];
+            dst[dx + 6] = src[xofs[dx + 6]];
+            dst[dx + 7] = src[xofs[dx + 7]];
+        }
+    }
+    else if (cn == 4)
+    {
+        for (; dx < dwidth; ++dx)
+        {
+            u32 v;
+            std::memcpy(&v, src + xofs[dx], sizeof(v));
+            std::memcpy(dst + dx * 4, &v, sizeof(v));
+        }
+    }
+    for (; dx < dwidth; ++dx)
+        for (int c = 0; c < cn; ++c)
+            dst[dx * cn + c] = src[xofs[dx] + c];
+}
+
+template <int cn>
+void resizeNearestNeighborImpl(const Size2D &ssize, const Size2D &dsize,
+                               const u8 * srcBase, ptrdiff_t srcStride,
+                               u8 * dstBase, ptrdiff_t dstStride,
+                               f32 wr, f32 hr)
+{
+    // integer ratios with the whole source covered pick every 2nd/4th pixel
+    u32 fast = 0;
+    if (wr == 2.0f && dsize.width * 2 <= ssize.width)
+        fast = 2;
+    else if (wr == 4.0f && dsize.width * 4 <= ssize.width)
+        fast = 4;
+
+    std::vector<u32> _xofs(fast ? 0 : dsize.width);
+    if (!fast)
+    {
+        for (size_t dx = 0; dx < dsize.width; ++dx)
+        {
+            size_t sx = (size_t)std::floor(dx * (f64)wr);
+            _xofs[dx] = (u32)(std::min(sx, ssize.width - 1) * cn);
+        }
+    }
+
+    ptrdiff_t prevSy = -1;
+    for (size_t dy = 0; dy < dsize.height; ++dy)
+    {
+        ptrdiff_t sy = (ptrdiff_t)std::min((size_t)std::floor(dy * (f64)hr), ssize.height - 1);
+        u8 * dst = internal::getRowPtr(dstBase, dstStride, dy);
+
+        // upscaled rows repeat the previous destination row
+        if (sy == prevSy)
+        {
+            std::memcpy(dst, internal::getRowPtr(dstBase, dstStride, dy - 1), dsize.width * cn);
+            continue;
+        }
+        prevSy = sy;
+
+        const u8 * src = internal::getRowPtr(srcBase, srcStride, sy);
+        if (fast == 2)
+            nearestRow2x<cn>(src, dst, dsize.width);
+        else if (fast == 4)
+            nearestRow4x<cn>(src, dst, dsize.width);
+        else
+            nearestRow<cn>(src, dst, &_xofs[0], dsize.width);
+    }
+}
+
+/*
+ * Area
+ */
+
+// 2x2 block average, (a + b + c + d + 2) >> 2 as OpenCV's ResizeAreaFastVec
+template <int cn>
+void areaRow2xExact(const u8 * src0, const u8 * src1, u8 * dst, size_t dwidth)
+{
+    size_t dx = 0;
+    for (; dx + 8 <= dwidth; dx += 8)
+    {
+        internal::prefetch(src0 + dx * 2 * cn);
+        internal::prefetch(src1 + dx * 2 * cn);
+        Planes<cn> a, b;
+        HalfPlanes<cn> r;
+        a.load(src0 + dx * 2 * cn);
+        b.load(src1 + dx * 2 * cn);
+        for (int c = 0; c < cn; ++c)
+            r.val[c] = vrshrn_n_u16(vpadalq_u8(vpaddlq_u8(a.val[c]), b.val[c]), 2);
+        r.store(dst + dx * cn);
+    }
+    for (; dx < dwidth; ++dx)
+        for (int c = 0; c < cn; ++c)
+        {
+            size_t i = dx * 2 * cn + c;
+            dst[dx * cn + c] = (u8)((src0[i] + src0[i + cn] + src1[i] + src1[i + cn] + 2) >> 2);
+        }
+}
+
+// 2x2 block average as two rounding halving adds, one rounding step more than the exact form
+template <int cn>
+void areaRow2xFast(const u8 * src0, const u8 * src1, u8 * dst, size_t dwidth)
+{
+    size_t dx = 0;
+    for (; dx + 16 <= dwidth; dx += 16)
+    {
+        internal::prefetch(src0 + dx * 2 * cn);
+        internal::prefetch(src1 + dx * 2 * cn);
+        Planes<cn> a0, a1, b0, b1, r;
+        a0.load(src0 + dx * 2 * cn);
+        a1.load(src0 + dx * 2 * cn + 16 * cn);
+        b0.load(src1 + dx * 2 * cn);
+        b1.load(src1 + dx * 2 * cn + 16 * cn);
+        for (int c = 0; c < cn; ++c)
+        {
+            uint8x16_t v0 = vrhaddq_u8(a0.val[c], b0.val[c]);
+            uint8x16_t v1 = vrhaddq_u8(a1.val[c], b1.val[c]);
+            uint8x16x2_t p = vuzpq_u8(v0, v1);
+            r.val[c] = vrhaddq_u8(p.val[0], p.val[1]);
+        }
+        r.store(dst + dx * cn);
+    }
+    for (; dx < dwidth; ++dx)
+        for (int c = 0; c < cn; ++c)
+        {
+            size_t i = dx * 2 * cn + c;
+            u32 l = (src0[i] + src1[i] + 1) >> 1;
+            u32 r = (src0[i + cn] + src1[i + cn] + 1) >> 1;
+            dst[dx * cn + c] = (u8)((l + r + 1) >> 1);
+        }
+}
+
+// OpenCV averages larger blocks as cvRound(sum * (1.f / area)), i.e. round half to even
+inline u8 roundHalfEven16(u32 sum)
+{
+    return (u8)((sum + 7 + ((sum >> 4) & 1)) >> 4);
+}
+
+template <int cn>
+void areaRow4x(const u8 * const * src, u8 * dst, size_t dwidth, bool exact)
+{
+    size_t dx = 0;
+    for (; dx + 8 <= dwidth; dx += 8)
+    {
+        // every channel plane yields 8 pair sums per 16 pixels; two loads give 8 quad sums
+        uint16x8_t acc0[cn], acc1[cn];
+        for (int c = 0; c < cn; ++c)
+        {
+            acc0[c] = vdupq_n_u16(0);
+            acc1[c] = vdupq_n_u16(0);
+        }
+        for (int k = 0; k < 4; ++k)
+        {
+            internal::prefetch(src[k] + dx * 4 * cn);
+            Planes<cn> a, b;
+            a.load(src[k] + dx * 4 * cn);
+            b.load(src[k] + dx * 4 * cn + 16 * cn);
+            for (int c = 0; c < cn; ++c)
+            {
+                acc0[c] = vpadalq_u8(acc0[c], a.val[c]);
+                acc1[c] = vpadalq_u8(acc1[c], b.val[c]);
+            }
+        }
+        HalfPlanes<cn> r;
+        for (int c = 0; c < cn; ++c)
+        {
+            uint16x8_t sum = vcombine_u16(vpadd_u16(vget_low_u16(acc0[c]), vget_high_u16(acc0[c])),
+                                          vpadd_u16(vget_low_u16(acc1[c]), vget_high_u16(acc1[c])));
+            if (exact)
+            {
+                uint16x8_t odd = vandq_u16(vshrq_n_u16(sum, 4), vdupq_n_u16(1));
+                r.val[c] = vshrn_n_u16(vaddq_u16(vaddq_u16(sum, vdupq_n_u16(7)), odd), 4);
+            }
+            else
+            {
+                r.val[c] = vrshrn_n_u16(sum, 4);
+            }
+        }
+        r.store(dst + dx * cn);
+    }
+    for (; dx < dwidth; ++dx)
+        for (int c = 0; c < cn; ++c)
+        {
+            u32 sum = 0;
+            for (int k = 0; k < 4; ++k)
+                for (int i = 0; i < 4; ++i)
+                    sum += src[k][(dx * 4 + i) * cn + c];
+            dst[dx * cn + c] = exact ? roundHalfEven16(sum) : (u8)((sum + 8) >> 4);
+        }
+}
+
+template <int cn>
+void areaRowUp2x(const u8 * src, u8 * dst, size_t swidth, size_t dwidth)
+{
+    size_t sx = 0;
+    if (cn == 4)
+    {
+        for (; sx + 4 <= swidth && (sx + 4) * 2 <= dwidth; sx += 4)
+        {
+            uint32x4_t v = vreinterpretq_u32_u8(vld1q_u8(src + sx * 4));
+            uint32x4x2_t z = vzipq_u32(v, v);
+            vst1q_u8(dst + sx * 8, vreinterpretq_u8_u32(z.val[0]));
+            vst1q_u8(dst + sx * 8 + 16, vreinterpretq_u8_u32(z.val[1]));
+        }
+    }
+    else
+    {
+        for (; sx + 16 <= swidth && (sx + 16) * 2 <= dwidth; sx += 16)
+        {
+            Planes<cn> v, lo, hi;
+            v.load(src + sx * cn);
+            for (int c = 0; c < cn; ++c)
+            {
+                uint8x16x2_t z = vzipq_u8(v.val[c], v.val[c]);
+                lo.val[c] = z.val[0];
+                hi.val[c] = z.val[1];
+            }
+            lo.store(dst + sx * 2 * cn);
+            hi.store(dst + sx * 2 * cn + 16 * cn);
+        }
+    }
+    for (size_t dx = sx * 2; dx < dwidth; ++dx)
+    {
+        size_t s = std::min(dx >> 1, swidth - 1);
+        for (int c = 0; c < cn; ++c)
+            dst[dx * cn + c] = src[s * cn + c];
+    }
+}
+
+// Blocks cut by the right or bottom border average the pixels they cover, as OpenCV does
+template <int cn>
+void areaBorderPixel(const Size2D &ssize, const u8 * srcBase, ptrdiff_t srcStride,
+                     u8 * dst, size_t dx, size_t dy, u32 scale, bool exact)
+{
+    size_t x1 = std::min<size_t>((dx + 1) * scale, ssize.width);
+    size_t y1 = std::min<size_t>((dy + 1) * scale, ssize.height);
+    size_t area = (x1 - dx * scale) * (y1 - dy * scale);
+    for (int c = 0; c < cn; ++c)
+    {
+        u32 sum = 0;
+        for (size_t y = dy * scale; y < y1; ++y)
+        {
+            const u8 * src = internal::getRowPtr(srcBase, srcStride, y);
+            for (size_t x = dx * scale; x < x1; ++x)
+                sum += src[x * cn + c];
+        }
+        f32 avg = (f32)sum / (f32)area;
+        dst[dx * cn + c] = exact ? (u8)std::lrint(avg) : (u8)(avg + 0.5f);
+    }
+}
+
+template <int cn>
+void resizeAreaImpl(const Size2D &ssize, const Size2D &dsize,
+                    const u8 * srcBase, ptrdiff_t srcStride,
+                    u8 * dstBase, ptrdiff_t dstStride,
+                    f32 wr, bool exact)
+{
+    if (wr == 0.5f)
+    {
+        for (size_t dy = 0; dy < dsize.height; ++dy)
+        {
+            u8 * dst = internal::getRowPtr(dstBase, dstStride, dy);
+            if ((dy & 1) && ((dy >> 1) < ssize.height))
+            {
+                std::memcpy(dst, internal::getRowPtr(dstBase, dstStride, dy - 1), dsize.width * cn);
+                continue;
+            }
+            const u8 * src = internal::getRowPtr(srcBase, srcStride, std::min(dy >> 1, ssize.height - 1));
+            areaRowUp2x<cn>(src, dst, ssize.width, dsize.width);
+        }
+        return;
+    }
+
+    u32 scale = wr == 2.0f ? 2 : 4;
+    size_t fullW = std::min(dsize.width, ssize.width / scale);
+    size_t fullH = std::min(dsize.height, ssize.height / scale);
+
+    for (size_t dy = 0; dy < dsize.height; ++dy)
+    {
+        u8 * dst = internal::getRowPtr(dstBase, dstStride, dy);
+        if (dy < fullH)
+        {
+            const u8 * src[4];
+            for (u32 k = 0; k < scale; ++k)
+                src[k] = internal::getRowPtr(srcBase, srcStride, dy * scale + k);
+
+            if (scale == 2)
+            {
+                if (exact)
+                    areaRow2xExact<cn>(src[0], src[1], dst, fullW);
+                else
+                    areaRow2xFast<cn>(src[0], src[1], dst, fullW);
+            }
+            else
+            {
+                areaRow4x<cn>(src, dst, fullW, exact);
+            }
+        }
+        for (size_t dx = dy < fullH ? fullW : 0; dx < dsize.width; ++dx)
+            areaBorderPixel<cn>(ssize, srcBase, srcStride, dst, dx, dy, scale, exact);
+    }
+}
+
+/*
+ * Linear, OpenCV compatible
+ */
+
+enum
+{
+    INTER_RESIZE_COEF_BITS = 11,
+    INTER_RESIZE_COEF_SCALE = 1 << INTER_RESIZE_COEF_BITS
+};
+
+inline s16 resizeCoef(f32 v)
+{
+    return (s16)std::lrint(v * INTER_RESIZE_COEF_SCALE);
+}
+
+// Per-column taps of cv::resize INTER_LINEAR: ofs[] is the left tap in elements, columns from
+// xmax on read a single pixel scaled by INTER_RESIZE_COEF_SCALE.
+struct LinearTable
+{
+    std::vector<s32> ofs;
+    std::vector<s16> alpha;
+    size_t xmax;
+};
+
+void buildLinearTable(size_t swidth, size_t dwidth, f32 wr, u32 cn, LinearTable &table)
+{
+    table.ofs.resize(dwidth);
+    table.alpha.resize(dwidth * 2);
+    table.xmax = dwidth;
+    f64 scale = wr;
+    for (size_t dx = 0; dx < dwidth; ++dx)
+    {
+        f32 fx = (f32)((dx + 0.5) * scale - 0.5);
+        ptrdiff_t sx = (ptrdiff_t)std::floor(fx);
+        fx -= sx;
+        if (sx < 0)
+        {
+            fx = 0.f;
+            sx = 0;
+        }
+        if (sx + 1 >= (ptrdiff_t)swidth)
+        {
+            table.xmax = std::min(table.xmax, dx);
+            if (sx >= (ptrdiff_t)swidth - 1)
+            {
+                fx = 0.f;
+                sx = (ptrdiff_t)swidth - 1;
+            }
+        }
+        table.ofs[dx] = (s32)(sx * cn);
+        table.alpha[dx * 2] = resizeCoef(1.f - fx);
+        table.alpha[dx * 2 + 1] = resizeCoef(fx);
+    }
+}
+
+template <int cn>
+void linearHResize(const u8 * src, s32 * dst, const LinearTable &table, size_t dwidth, bool pairs)
+{
+    size_t dx = 0;
+    if (pairs)
+    {
+        // 2:1 columns have alpha (1024, 1024) and adjacent taps
+        for (; dx + 8 <= table.xmax; dx += 8)
+        {
+            Planes<cn> v;
+            v.load(src + dx * 2 * cn);
+            uint32x4_t lo[cn], hi[cn];
+            for (int c = 0; c < cn; ++c)
+            {
+                uint16x8_t s = vpaddlq_u8(v.val[c]);
+                lo[c] = vshll_n_u16(vget_low_u16(s), INTER_RESIZE_COEF_BITS - 1);
+                hi[c] = vshll_n_u16(vget_high_u16(s), INTER_RESIZE_COEF_BITS - 1);
+            }
+            if (cn == 1)
+            {
+                vst1q_u32((u32 *)dst + dx, lo[0]);
+                vst1q_u32((u32 *)dst + dx + 4, hi[0]);
+            }
+            else if (cn == 3)
+            {
+                uint32x4x3_t l, h;
+                for (int c = 0; c < 3; ++c)
+                {
+                    l.val[c] = lo[c];
+                    h.val[c] = hi[c];
+                }
+                vst3q_u32((u32 *)dst + dx * 3, l);
+                vst3q_u32((u32 *)dst + dx * 3 + 12, h);
+            }
+            else
+            {
+                uint32x4x4_t l, h;
+                for (int c = 0; c < 4; ++c)
+                {
+                    l.val[c] = lo[c];
+                    h.val[c] = hi[c];
+                }
+                vst4q_u32((u32 *)dst + dx * 4, l);
+                vst4q_u32((u32 *)dst + dx * 4 + 16, h);
+            }
+        }
+    }
+    for (; dx < table.xmax; ++dx)
+    {
+        const u8 * s = src + table.ofs[dx];
+        s32 a0 = table.alpha[dx * 2], a1 = table.alpha[dx * 2 + 1];
+        for (int c = 0; c < cn; ++c)
+            dst[dx * cn + c] = s[c] * a0 + s[c + cn] * a1;
+    }
+    for (; dx < dwidth; ++dx)
+    {
+        const u8 * s = src + table.ofs[dx];
+        for (int c = 0; c < cn; ++c)
+            dst[dx * cn + c] = s[c] * INTER_RESIZE_COEF_SCALE;
+    }
+}
+
+inline int16x8_t linearVTerm(const s32 * s, int16x4_t b)
+{
+    int16x8_t v = vcombine_s16(vqmovn_s32(vshrq_n_s32(vld1q_s32(s), 4)),
+                               vqmovn_s32(vshrq_n_s32(vld1q_s32(s + 4), 4)));
+    return vcombine_s16(vshrn_n_s32(vmull_s16(vget_low_s16(v), b), 16),
+                        vshrn_n_s32(vmull_s16(vget_high_s16(v), b), 16));
+}
+
+// Mirrors OpenCV's VResizeLinearVec_32s8u: 16 and 8 lane blocks use ((S >> 4) * b) >> 16 with a
+// final rounding shift by 2, the remaining columns the scalar (S0 * b0 + S1 * b1 + 2^21) >> 22.
+void linearVResize(const s32 * S0, const s32 * S1, u8 * dst, s16 beta0, s16 beta1, size_t width)
+{
+    int16x4_t b0 = vdup_n_s16(beta0), b1 = vdup_n_s16(beta1);
+    size_t x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+        int16x8_t t0 = vqaddq_s16(linearVTerm(S0 + x, b0), linearVTerm(S1 + x, b1));
+        int16x8_t t1 = vqaddq_s16(linearVTerm(S0 + x + 8, b0), linearVTerm(S1 + x + 8, b1));
+        vst1q_u8(dst + x, vcombine_u8(vqrshrun_n_s16(t0, 2), vqrshrun_n_s16(t1, 2)));
+    }
+    for (; x + 8 < width; x += 8)
+    {
+        int16x8_t t = vqaddq_s16(linearVTerm(S0 + x, b0), linearVTerm(S1 + x, b1));
+        vst1_u8(dst + x, vqrshrun_n_s16(t, 2));
+    }
+    for (; x < width; ++x)
+    {
+        s32 v = (S0[x] * beta0 + S1[x] * beta1 + (1 << (INTER_RESIZE_COEF_BITS * 2 - 1))) >> (INTER_RESIZE_COEF_BITS * 2);
+        dst[x] = (u8)std::min(std::max(v, 0), 255);
+    }
+}
+
+template <int cn>
+void resizeLinearOpenCVImpl(const Size2D &ssize, const Size2D &dsize,
+                            const u8 * srcBase, ptrdiff_t srcStride,
+                            u8 * dstBase, ptrdiff_t dstStride,
+                            f32 wr, f32 hr)
+{
+    LinearTable table;
+    buildLinearTable(ssize.width, dsize.width, wr, cn, table);
+    bool pairs = (wr == 2.0f) && (ssize.width == dsize.width * 2);
+
+    size_t rowLen = dsize.width * cn;
+    std::vector<s32> _rows(rowLen * 2);
+    s32 * rows[2] = { &_rows[0], &_rows[rowLen] };
+    ptrdiff_t rowIdx[2] = { -1, -1 };
+
+    f64 scale = hr;
+    for (size_t dy = 0; dy < dsize.height; ++dy)
+    {
+        f32 fy = (f32)((dy + 0.5) * scale - 0.5);
+        ptrdiff_t sy = (ptrdiff_t)std::floor(fy);
+        fy -= sy;
+        s16 beta0 = resizeCoef(1.f - fy), beta1 = resizeCoef(fy);
+
+        // horizontal passes are cached, so upscaling computes each source row once
+        ptrdiff_t y[2];
+        for (int k = 0; k < 2; ++k)
+            y[k] = std::min(std::max<ptrdiff_t>(sy + k, 0), (ptrdiff_t)ssize.height - 1);
+
+        const s32 * S[2];
+        for (int k = 0; k < 2; ++k)
+        {
+            int slot = rowIdx[0] == y[k] ? 0 : rowIdx[1] == y[k] ? 1 : -1;
+            if (slot < 0)
+            {
+                // keep the row the other tap needs
+                slot = rowIdx[0] == y[1 - k] ? 1 : 0;
+                linearHResize<cn>(internal::getRowPtr(srcBase, srcStride, y[k]), rows[slot], table, dsize.width, pairs);
+                rowIdx[slot] = y[k];
+            }
+            S[k] = rows[slot];
+        }
+        linearVResize(S[0], S[1], internal::getRowPtr(dstBase, dstStride, dy), beta0, beta1, rowLen);
+    }
+}
+
+/*
+ * Linear, Q8 weights
+ */
+
+enum
+{
+    LINEAR_BITS = 8,
+    LINEAR_ONE = 1 << LINEAR_BITS
+};
+
+// Blends two source rows with Q8 weights into a Q8 row
+void linearVBlend(const u8 * s0, const u8 * s1, u16 * dst, u16 w1, size_t width)
+{
+    uint8x8_t b0 = vdup_n_u8((u8)(LINEAR_ONE - w1)), b1 = vdup_n_u8((u8)w1);
+    size_t x = 0;
+    if (w1 == 0)
+    {
+        for (; x + 16 <= width; x += 16)
+        {
+            uint8x16_t v = vld1q_u8(s0 + x);
+            vst1q_u16(dst + x, vshll_n_u8(vget_low_u8(v), LINEAR_BITS));
+            vst1q_u16(dst + x + 8, vshll_n_u8(vget_high_u8(v), LINEAR_BITS));
+        }
+        for (; x < width; ++x)
+            dst[x] = (u16)(s0[x] << LINEAR_BITS);
+        return;
+    }
+    for (; x + 16 <= width; x += 16)
+    {
+        internal::prefetch(s0 + x);
+        internal::prefetch(s1 + x);
+        uint8x16_t v0 = vld1q_u8(s0 + x), v1 = vld1q_u8(s1 + x);
+        vst1q_u16(dst + x, vmlal_u8(vmull_u8(vget_low_u8(v0), b0), vget_low_u8(v1), b1));
+        vst1q_u16(dst + x + 8, vmlal_u8(vmull_u8(vget_high_u8(v0), b0), vget_high_u8(v1), b1));
+    }
+    for (; x < width; ++x)
+        dst[x] = (u16)(s0[x] * (LINEAR_ONE - w1) + s1[x] * w1);
+}
+
+template <int cn>
+void resizeLinearImpl(const Size2D &ssize, const Size2D &dsize,
+                      const u8 * srcBase, ptrdiff_t srcStride,
+                      u8 * dstBase, ptrdiff_t dstStride,
+                      f32 wr, f32 hr)
+{
+    // 2:1 samples sit between two source pixels and 4:1 between the middle two of four,
+    // so both reduce to averaging a 2x2 block
+    if (wr == hr && (wr == 2.0f || wr == 4.0f) &&
+        ssize.width >= dsize.width * (size_t)wr && ssize.height >= dsize.height * (size_t)wr)
+    {
+        size_t step = (size_t)wr;
+        size_t first = step / 2 - 1;
+        for (size_t dy = 0; dy < dsize.height; ++dy)
+        {
+            const u8 * s0 = internal::getRowPtr(srcBase, srcStride, dy * step + first);
+            const u8 * s1 = internal::getRowPtr(srcBase, srcStride, dy * step + first + 1);
+            u8 * dst = internal::getRowPtr(dstBase, dstStride, dy);
+            if (step == 2)
+            {
+                areaRow2xFast<cn>(s0, s1, dst, dsize.width);
+                continue;
+            }
+            size_t dx = 0;
+            for (; dx + 16 <= dsize.width; dx += 16)
+            {
+                Planes<cn> a0, a1, b0, b1, r;
+                a0.load(s0 + dx * 4 * cn);
+                a1.load(s0 + dx * 4 * cn + 16 * cn);
+                b0.load(s0 + dx * 4 * cn + 32 * cn);
+                b1.load(s0 + dx * 4 * cn + 48 * cn);
+                Planes<cn> c0, c1, d0, d1;
+                c0.load(s1 + dx * 4 * cn);
+                c1.load(s1 + dx * 4 * cn + 16 * cn);
+                d0.load(s1 + dx * 4 * cn + 32 * cn);
+                d1.load(s1 + dx * 4 * cn + 48 * cn);
+                for (int c = 0; c < cn; ++c)
+                {
+                    // even/odd split twice leaves lanes 1 and 2 of every group of four
+                    uint8x16x2_t p0 = vuzpq_u8(vrhaddq_u8(a0.val[c], c0.val[c]), vrhaddq_u8(a1.val[c], c1.val[c]));
+                    uint8x16x2_t p1 = vuzpq_u8(vrhaddq_u8(b0.val[c], d0.val[c]), vrhaddq_u8(b1.val[c], d1.val[c]));
+                    uint8x16_t lane1 = vuzpq_u8(p0.val[1], p1.val[1]).val[0];
+                    uint8x16_t lane2 = vuzpq_u8(p0.val[0], p1.val[0]).val[1];
+                    r.val[c] = vrhaddq_u8(lane1, lane2);
+                }
+                r.store(dst + dx * cn);
+            }
+            for (; dx < dsize.width; ++dx)
+                for (int c = 0; c < cn; ++c)
+                {
+                    size_t i = (dx * 4 + 1) * cn + c;
+                    u32 l = (s0[i] + s1[i] + 1) >> 1;
+                    u32 r = (s0[i + cn] + s1[i + cn] + 1) >> 1;
+                    dst[dx * cn + c] = (u8)((l + r + 1) >> 1);
+                }
+        }
+        return;
+    }
+
+    std::vector<u32> xofs(dsize.width);
+    std::vector<u16> xw(dsize.width);
+    for (size_t dx = 0; dx < dsize.width; ++dx)
+    {
+        f32 fx = (f32)((dx + 0.5) * (f64)wr - 0.5);
+        ptrdiff_t sx = (ptrdiff_t)std::floor(fx);
+        fx -= sx;
+        if (sx < 0)
+        {
+            sx = 0;
+            fx = 0.f;
+        }
+        if (sx >= (ptrdiff_t)ssize.width - 1)
+        {
+            sx = (ptrdiff_t)ssize.width - 2;
+            fx = 1.f;
+        }
+        xofs[dx] = (u32)(sx * cn);
+        xw[dx] = (u16)std::min<s32>((s32)(fx * LINEAR_ONE + 0.5f), LINEAR_ONE);
+    }
+
+    std::vector<u16> row(ssize.width * cn);
+    for (size_t dy = 0; dy < dsize.height; ++dy)
+    {
+        f32 fy = (f32)((dy + 0.5) * (f64)hr - 0.5);
+        ptrdiff_t sy = (ptrdiff_t)std::floor(fy);
+        fy -= sy;
+        if (sy < 0)
+        {
+            sy = 0;
+            fy = 0.f;
+        }
+        if (sy >= (ptrdiff_t)ssize.height - 1)
+        {
+            sy = (ptrdiff_t)ssize.height - 2;
+            fy = 1.f;
+        }
+        u16 w1 = (u16)std::min<s32>((s32)(fy * LINEAR_ONE + 0.5f), LINEAR_ONE);
+        const u8 * s0 = internal::getRowPtr(srcBase, srcStride, sy);
+        const u8 * s1 = internal::getRowPtr(srcBase, srcStride, sy + 1);
+        if (w1 == LINEAR_ONE)
+        {
+            s0 = s1;
+            w1 = 0;
+        }
+        linearVBlend(s0, s1, &row[0], w1, ssize.width * cn);
+
+        u8 * dst = internal::getRowPtr(dstBase, dstStride, dy);
+        for (size_t dx = 0; dx < dsize.width; ++dx)
+        {
+            const u16 * t = &row[xofs[dx]];
+            u32 a1 = xw[dx], a0 = LINEAR_ONE - a1;
+            for (int c = 0; c < cn; ++c)
+                dst[dx * cn + c] = (u8)((t[c] * a0 + t[c + cn] * a1 + (1 << 15)) >> 16);
+        }
+    }
+}
+
+} // namespace
+
+#endif
+
+void resizeNearestNeighbor(const Size2D &ssize, const Size2D &dsize,
+                           const void * srcBase, ptrdiff_t srcStride,
+                           void * dstBase, ptrdiff_t dstStride,
+                           f32 wr, f32 hr, u32 elemSize)
+{
+    internal::assertSupportedConfiguration(wr > 0 && hr > 0 &&
+                                           (dsize.width - 0.5) * wr < ssize.width &&
+                                           (dsize.height - 0.5) * hr < ssize.height &&  // Ensure we have enough source data
+                                           (dsize.width + 0.5) * wr >= ssize.width &&
+                                           (dsize.height + 0.5) * hr >= ssize.height && // Ensure source isn't too big
+                                           isResizeNearestNeighborSupported(ssize, elemSize));
+#ifdef CAROTENE_NEON
+    const u8 * src = (const u8 *)srcBase;
+    u8 * dst = (u8 *)dstBase;
+    if (elemSize == 1)
+        resizeNearestNeighborImpl<1>(ssize, dsize, src, srcStride, dst, dstStride, wr, hr);
+    else if (elemSize == 3)
+        resizeNearestNeighborImpl<3>(ssize, dsize, src, srcStride, dst, dstStride, wr, hr);
+    else
+        resizeNearestNeighborImpl<4>(ssize, dsize, src, srcStride, dst, dstStride, wr, hr);
+#else
+    (void)dsize;
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+#endif
+}
+
+void resizeAreaOpenCV(const Size2D &ssize, const Size2D &dsize,
+                      const u8 * srcBase, ptrdiff_t srcStride,
+                      u8 * dstBase, ptrdiff_t dstStride,
+                      f32 wr, f32 hr, u32 channels)
+{
+    internal::assertSupportedConfiguration(isResizeAreaSupported(wr, hr, channels) &&
+                                           std::abs(dsize.width * wr - ssize.width) < 0.1 &&
+                                           std::abs(dsize.height * hr - ssize.height) < 0.1);
+#ifdef CAROTENE_NEON
+    if (channels == 1)
+        resizeAreaImpl<1>(ssize, dsize, srcBase, srcStride, dstBase, dstStride, wr, true);
+    else if (channels == 3)
+        resizeAreaImpl<3>(ssize, dsize, srcBase, srcStride, dstBase, dstStride, wr, true);
+    else
+        resizeAreaImpl<4>(ssize, dsize, srcBase, srcStride, dstBase, dstStride, wr, true);
+#else
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+#endif
+}
+
+void resizeArea(const Size2D &ssize, const Size2D &dsize,
+                const u8 * srcBase, ptrdiff_t srcStride,
+                u8 * dstBase, ptrdiff_t dstStride,
+                f32 wr, f32 hr, u32 channels)
+{
+    internal::assertSupportedConfiguration(isResizeAreaSupported(wr, hr, channels) &&
+                                           std::abs(dsize.width * wr - ssize.width) < 0.1 &&
+                                           std::abs(dsize.height * hr - ssize.height) < 0.1);
+#ifdef CAROTENE_NEON
+    if (channels == 1)
+        resizeAreaImpl<1>(ssize, dsize, srcBase, srcStride, dstBase, dstStride, wr, false);
+    else if (channels == 3)
+        resizeAreaImpl<3>(ssize, dsize, srcBase, srcStride, dstBase, dstStride, wr, false);
+    else
+        resizeAreaImpl<4>(ssize, dsize, srcBase, srcStride, dstBase, dstStride, wr, false);
+#else
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+#endif
+}
+
+void resizeLinearOpenCV(const Size2D &ssize, const Size2D &dsize,
+                        const u8 * srcBase, ptrdiff_t srcStride,
+                        u8 * dstBase, ptrdiff_t dstStride,
+                        f32 wr, f32 hr, u32 channels)
+{
+    internal::assertSupportedConfiguration(wr > 0 && hr > 0 &&
+                                           isResizeLinearOpenCVSupported(ssize, dsize, channels));
+#ifdef CAROTENE_NEON
+    if (channels == 1)
+        resizeLinearOpenCVImpl<1>(ssize, dsize, srcBase, srcStride, dstBase, dstStride, wr, hr);
+    else if (channels == 3)
+        resizeLinearOpenCVImpl<3>(ssize, dsize, srcBase, srcStride, dstBase, dstStride, wr, hr);
+    else
+        resizeLinearOpenCVImpl<4>(ssize, dsize, srcBase, srcStride, dstBase, dstStride, wr, hr);
+#else
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+#endif
+}
+
+void resizeLinear(const Size2D &ssize, const Size2D &dsize,
+                  const u8 * srcBase, ptrdiff_t srcStride,
+                  u8 * dstBase, ptrdiff_t dstStride,
+                  f32 wr, f32 hr, u32 channels)
+{
+    internal::assertSupportedConfiguration(isResizeLinearSupported(ssize, dsize, wr, hr, channels));
+#ifdef CAROTENE_NEON
+    if (channels == 1)
+        resizeLinearImpl<1>(ssize, dsize, srcBase, srcStride, dstBase, dstStride, wr, hr);
+    else if (channels == 3)
+        resizeLinearImpl<3>(ssize, dsize, srcBase, srcStride, dstBase, dstStride, wr, hr);
+    else
+        resizeLinearImpl<4>(ssize, dsize, srcBase, srcStride, dstBase, dstStride, wr, hr);
+#else
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+#endif
+}
+
+} // namespace CAROTENE_NS
@@ -0,0 +1,108 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#ifndef CAROTENE_SATURATE_CAST_HPP
+#define CAROTENE_SATURATE_CAST_HPP
+
+#include <cmath>
+#include <limits>
+
+#include <carotene/definitions.hpp>
+#include <carotene/types.hpp>
+
+namespace CAROTENE_NS { namespace internal {
+
+// Scalar conversions of the kernel tails: integers are clamped to the range of the
+// destination type, floating point values are rounded to nearest-even first (as cvRound).
+
+template <bool dst_integer, bool src_integer>
+struct SaturateCast
+{
+    // floating point destination
+    template <typename D, typename S>
+    static D cast(S v) { return (D)v; }
+};
+
+template <>
+struct SaturateCast<true, true>
+{
+    template <typename D, typename S>
+    static D cast(S v)
+    {
+        // compare in the wider of both types, signed and unsigned operands are
+        // checked against zero separately so that no implicit conversion wraps
+        if (std::numeric_limits<S>::is_signed && v < 0)
+        {
+            if (!std::numeric_limits<D>::is_signed)
+                return 0;
+            if ((s64)v < (s64)std::numeric_limits<D>::min())
+                return std::numeric_limits<D>::min();
+            return (D)v;
+        }
+        if ((u64)v > (u64)std::numeric_limits<D>::max())
+            return std::numeric_limits<D>::max();
+        return (D)v;
+    }
+};
+
+template <>
+struct SaturateCast<true, false>
+{
+    template <typename D, typename S>
+    static D cast(S v)
+    {
+        f64 r = std::nearbyint((f64)v);
+        if (!(r >= (f64)std::numeric_limits<D>::min()))
+            return r != r ? D(0) : std::numeric_limits<D>::min();
+        if (r >= (f64)std::numeric_limits<D>::max())
+            return std::numeric_limits<D>::max();
+        return (D)r;
+    }
+};
+
+template <typename D, typename S>
+inline D saturate_cast(S v)
+{
+    return SaturateCast<std::numeric_limits<D>::is_integer,
+                        std::numeric_limits<S>::is_integer>::template cast<D>(v);
+}
+
+} }
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "separable_filter.hpp"
+
+namespace CAROTENE_NS {
+
+bool isScharr3x3Supported(const Size2D &size, BORDER_MODE border, s32 dx, s32 dy, Margin borderMargin)
+{
+    return ((dx == 1 && dy == 0) || (dx == 0 && dy == 1)) &&
+           isSeparableFilter3x3Supported(size, border, 3, 3, borderMargin);
+}
+
+void Scharr3x3(const Size2D &size,
+               const u8 * srcBase, ptrdiff_t srcStride,
+               s16 * dstBase, ptrdiff_t dstStride,
+               s32 dx, s32 dy,
+               BORDER_MODE borderType, u8 borderValue, Margin borderMargin)
+{
+    internal::assertSupportedConfiguration(isScharr3x3Supported(size, borderType, dx, dy, borderMargin));
+    // [-1 0 1] along the derivative is the predefined kernel 1, [3 10 3] across it is custom
+    static const s16 smooth[3] = { 3, 10, 3 };
+    SeparableFilter3x3(size, srcBase, srcStride, dstBase, dstStride,
+                       dx ? 1 : 3, dx ? 3 : 1, smooth, smooth,
+                       borderType, borderValue, borderMargin);
+}
+
+void ScharrDeriv(const Size2D &size, s32 cn,
+                 const u8 * srcBase, ptrdiff_t srcStride,
+                 s16 * dstBase, ptrdiff_t dstStride)
+{
+    internal::assertSupportedConfiguration(isSupportedConfiguration() && cn > 0);
+#ifdef CAROTENE_NEON
+    // the derivative image of cv::calcOpticalFlowPyrLK, reflected at the image border
+    internal::derivatives3x3(size, cn, srcBase, srcStride, dstBase, dstStride, 3, 10,
+                             BORDER_MODE_REFLECT101, 0, Margin());
+#else
+    (void)size;
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+#endif
+}
+
+bool isScharr3x3dXdYSupported(const Size2D &size, BORDER_MODE border, Margin borderMargin)
+{
+    return isSobel3x3dXdYSupported(size, border, borderMargin);
+}
+
+void Scharr3x3dXdY(const Size2D &size,
+                   const u8 * srcBase, ptrdiff_t srcStride,
+                   s16 * dstBase, ptrdiff_t dstStride,
+                   BORDER_MODE border, u8 borderValue, Margin borderMargin)
+{
+    internal::assertSupportedConfiguration(isScharr3x3dXdYSupported(size, border, borderMargin));
+#ifdef CAROTENE_NEON
+    internal::derivatives3x3(size, 1, srcBase, srcStride, dstBase, dstStride, 3, 10, border, borderValue, borderMargin);
+#else
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+    (void)borderValue;
+#endif
+}
+
+} // namespace CAROTENE_NS
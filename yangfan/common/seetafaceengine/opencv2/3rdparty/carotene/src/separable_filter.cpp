@@ -0,0 +1,387 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "separable_filter.hpp"
+#include "saturate_cast.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+namespace CAROTENE_NS {
+
+bool isSeparableFilter3x3Supported(const Size2D &size, BORDER_MODE border, s32 dx, s32 dy, Margin borderMargin)
+{
+    (void)borderMargin;
+    return isSupportedConfiguration() &&
+           size.width >= 1 && size.height >= 1 &&
+           dx >= 0 && dx < 4 && dy >= 0 && dy < 4 &&
+           internal::isSeparable3x3Border(border);
+}
+
+#ifdef CAROTENE_NEON
+
+namespace {
+
+enum
+{
+    KERNEL_SMOOTH = 0, //  1  2  1
+    KERNEL_DIFF = 1,   // -1  0  1
+    KERNEL_DIFF2 = 2,  //  1 -2  1
+    KERNEL_CUSTOM = 3
+};
+
+void kernelWeights(u8 type, const s16 * custom, s16 w[3])
+{
+    static const s16 predefined[3][3] = { { 1, 2, 1 }, { -1, 0, 1 }, { 1, -2, 1 } };
+    const s16 * k = type == KERNEL_CUSTOM ? custom : predefined[type];
+    w[0] = k[0];
+    w[1] = k[1];
+    w[2] = k[2];
+}
+
+s32 absSum(const s16 w[3])
+{
+    return std::abs((s32)w[0]) + std::abs((s32)w[1]) + std::abs((s32)w[2]);
+}
+
+inline int16x8_t vld1q_u8_s16(const u8 * p)
+{
+    return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(p)));
+}
+
+// a * w0 + b * w1 + c * w2 in wrapping s16 arithmetic, exact whenever the result fits
+template <int type>
+inline int16x8_t combine(int16x8_t a, int16x8_t b, int16x8_t c, const int16x8_t * w);
+
+template <>
+inline int16x8_t combine<KERNEL_SMOOTH>(int16x8_t a, int16x8_t b, int16x8_t c, const int16x8_t *)
+{
+    return vaddq_s16(vaddq_s16(a, c), vshlq_n_s16(b, 1));
+}
+
+template <>
+inline int16x8_t combine<KERNEL_DIFF>(int16x8_t a, int16x8_t, int16x8_t c, const int16x8_t *)
+{
+    return vsubq_s16(c, a);
+}
+
+template <>
+inline int16x8_t combine<KERNEL_DIFF2>(int16x8_t a, int16x8_t b, int16x8_t c, const int16x8_t *)
+{
+    return vsubq_s16(vaddq_s16(a, c), vshlq_n_s16(b, 1));
+}
+
+template <>
+inline int16x8_t combine<KERNEL_CUSTOM>(int16x8_t a, int16x8_t b, int16x8_t c, const int16x8_t * w)
+{
+    return vmlaq_s16(vmlaq_s16(vmulq_s16(a, w[0]), b, w[1]), c, w[2]);
+}
+
+inline s32 combine1(s32 a, s32 b, s32 c, const s16 * w)
+{
+    return a * w[0] + b * w[1] + c * w[2];
+}
+
+struct FilterArgs
+{
+    Size2D size;
+    const u8 * srcBase;
+    ptrdiff_t srcStride;
+    s16 * dstBase;
+    ptrdiff_t dstStride;
+    s16 xw[3], yw[3];
+    u8 borderValue;
+};
+
+/*
+    Vertical pass into a row buffer extended by one element on both sides, then the horizontal
+    pass from it. Used when |result| <= 32767 is guaranteed, so s16 wraparound is harmless.
+*/
+template <int rowType, int colType>
+void filter16(const FilterArgs & a, const internal::Border3x3 & border)
+{
+    const size_t width = a.size.width;
+    std::vector<s16> _vrow(width + 2);
+    std::vector<u8> _constRow(width + 2, a.borderValue);
+    s16 * vrow = &_vrow[1];
+    const u8 * constRow = &_constRow[1];
+
+    int16x8_t v_xw[3], v_yw[3];
+    for (size_t k = 0; k < 3; ++k)
+    {
+        v_xw[k] = vdupq_n_s16(a.xw[k]);
+        v_yw[k] = vdupq_n_s16(a.yw[k]);
+    }
+
+    for (size_t y = 0; y < a.size.height; ++y)
+    {
+        const u8 * r[3];
+        border.rows(a.srcBase, a.srcStride, y, constRow, r);
+
+        size_t x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            internal::prefetch(r[0] + x);
+            internal::prefetch(r[1] + x);
+            internal::prefetch(r[2] + x);
+            vst1q_s16(vrow + x, combine<colType>(vld1q_u8_s16(r[0] + x), vld1q_u8_s16(r[1] + x),
+                                                 vld1q_u8_s16(r[2] + x), v_yw));
+        }
+        for (; x < width; ++x)
+            vrow[x] = (s16)combine1(r[0][x], r[1][x], r[2][x], a.yw);
+        vrow[-1] = (s16)combine1(border.leftAt(r[0], 1, 0, a.borderValue), border.leftAt(r[1], 1, 0, a.borderValue),
+                                 border.leftAt(r[2], 1, 0, a.borderValue), a.yw);
+        vrow[width] = (s16)combine1(border.rightAt(r[0], 1, 0, a.borderValue), border.rightAt(r[1], 1, 0, a.borderValue),
+                                    border.rightAt(r[2], 1, 0, a.borderValue), a.yw);
+
+        s16 * drow = internal::getRowPtr(a.dstBase, a.dstStride, y);
+        for (x = 0; x + 8 <= width; x += 8)
+            vst1q_s16(drow + x, combine<rowType>(vld1q_s16(vrow + x - 1), vld1q_s16(vrow + x),
+                                                 vld1q_s16(vrow + x + 1), v_xw));
+        for (; x < width; ++x)
+            drow[x] = (s16)combine1(vrow[x - 1], vrow[x], vrow[x + 1], a.xw);
+    }
+}
+
+/*
+    Large custom weights: both passes in s32 and the result saturated, as cv::sepFilter2D
+    does with integer kernels. s32 wraparound gives the same result in either pass order.
+*/
+void filter32(const FilterArgs & a, const internal::Border3x3 & border)
+{
+    const size_t width = a.size.width;
+    std::vector<s32> _vrow(width + 2);
+    std::vector<u8> _constRow(width + 2, a.borderValue);
+    s32 * vrow = &_vrow[1];
+    const u8 * constRow = &_constRow[1];
+
+    for (size_t y = 0; y < a.size.height; ++y)
+    {
+        const u8 * r[3];
+        border.rows(a.srcBase, a.srcStride, y, constRow, r);
+
+        size_t x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            int16x8_t v_0 = vld1q_u8_s16(r[0] + x), v_1 = vld1q_u8_s16(r[1] + x), v_2 = vld1q_u8_s16(r[2] + x);
+            int32x4_t v_lo = vmull_n_s16(vget_low_s16(v_0), a.yw[0]);
+            int32x4_t v_hi = vmull_n_s16(vget_high_s16(v_0), a.yw[0]);
+            v_lo = vmlal_n_s16(v_lo, vget_low_s16(v_1), a.yw[1]);
+            v_hi = vmlal_n_s16(v_hi, vget_high_s16(v_1), a.yw[1]);
+            vst1q_s32(vrow + x, vmlal_n_s16(v_lo, vget_low_s16(v_2), a.yw[2]));
+            vst1q_s32(vrow + x + 4, vmlal_n_s16(v_hi, vget_high_s16(v_2), a.yw[2]));
+        }
+        for (; x < width; ++x)
+            vrow[x] = combine1(r[0][x], r[1][x], r[2][x], a.yw);
+        vrow[-1] = combine1(border.leftAt(r[0], 1, 0, a.borderValue), border.leftAt(r[1], 1, 0, a.borderValue),
+                            border.leftAt(r[2], 1, 0, a.borderValue), a.yw);
+        vrow[width] = combine1(border.rightAt(r[0], 1, 0, a.borderValue), border.rightAt(r[1], 1, 0, a.borderValue),
+                               border.rightAt(r[2], 1, 0, a.borderValue), a.yw);
+
+        s16 * drow = internal::getRowPtr(a.dstBase, a.dstStride, y);
+        for (x = 0; x + 8 <= width; x += 8)
+        {
+            int32x4_t v_lo = vmulq_n_s32(vld1q_s32(vrow + x - 1), a.xw[0]);
+            int32x4_t v_hi = vmulq_n_s32(vld1q_s32(vrow + x + 3), a.xw[0]);
+            v_lo = vmlaq_n_s32(v_lo, vld1q_s32(vrow + x), a.xw[1]);
+            v_hi = vmlaq_n_s32(v_hi, vld1q_s32(vrow + x + 4), a.xw[1]);
+            v_lo = vmlaq_n_s32(v_lo, vld1q_s32(vrow + x + 1), a.xw[2]);
+            v_hi = vmlaq_n_s32(v_hi, vld1q_s32(vrow + x + 5), a.xw[2]);
+            vst1q_s16(drow + x, vcombine_s16(vqmovn_s32(v_lo), vqmovn_s32(v_hi)));
+        }
+        for (; x < width; ++x)
+        {
+            u32 sum = (u32)vrow[x - 1] * (u32)(s32)a.xw[0] + (u32)vrow[x] * (u32)(s32)a.xw[1] +
+                      (u32)vrow[x + 1] * (u32)(s32)a.xw[2];
+            drow[x] = internal::saturate_cast<s16>((s32)sum);
+        }
+    }
+}
+
+typedef void (*Filter16Func)(const FilterArgs &, const internal::Border3x3 &);
+
+template <int colType>
+Filter16Func filter16Func(u8 rowType)
+{
+    switch (rowType)
+    {
+    case KERNEL_SMOOTH:
+        return filter16<KERNEL_SMOOTH, colType>;
+    case KERNEL_DIFF:
+        return filter16<KERNEL_DIFF, colType>;
+    case KERNEL_DIFF2:
+        return filter16<KERNEL_DIFF2, colType>;
+    default:
+        return filter16<KERNEL_CUSTOM, colType>;
+    }
+}
+
+} // namespace
+
+namespace internal {
+
+void derivatives3x3(const Size2D &size, size_t cn,
+                    const u8 * srcBase, ptrdiff_t srcStride,
+                    s16 * dstBase, ptrdiff_t dstStride,
+                    s16 edge, s16 mid,
+                    BORDER_MODE borderType, u8 borderValue, const Margin &borderMargin)
+{
+    Border3x3 border(size, borderType, borderMargin);
+    const size_t n = size.width * cn;
+    const ptrdiff_t off = (ptrdiff_t)cn;
+
+    // vertical smoothing and difference, extended by one pixel on both sides
+    std::vector<s16> _smooth(n + 2 * cn), _diff(n + 2 * cn);
+    std::vector<u8> _constRow(n + 2 * cn, borderValue);
+    s16 * smooth = &_smooth[cn], * diff = &_diff[cn];
+    const u8 * constRow = &_constRow[cn];
+    const int16x8_t v_edge = vdupq_n_s16(edge), v_mid = vdupq_n_s16(mid);
+
+    for (size_t y = 0; y < size.height; ++y)
+    {
+        const u8 * r[3];
+        border.rows(srcBase, srcStride, y, constRow, r);
+
+        size_t x = 0;
+        for (; x + 8 <= n; x += 8)
+        {
+            internal::prefetch(r[0] + x);
+            internal::prefetch(r[1] + x);
+            internal::prefetch(r[2] + x);
+            int16x8_t v_0 = vld1q_u8_s16(r[0] + x), v_2 = vld1q_u8_s16(r[2] + x);
+            vst1q_s16(smooth + x, vmlaq_s16(vmulq_s16(vaddq_s16(v_0, v_2), v_edge), vld1q_u8_s16(r[1] + x), v_mid));
+            vst1q_s16(diff + x, vsubq_s16(v_2, v_0));
+        }
+        for (; x < n; ++x)
+        {
+            smooth[x] = (s16)((r[0][x] + r[2][x]) * edge + r[1][x] * mid);
+            diff[x] = (s16)(r[2][x] - r[0][x]);
+        }
+        for (size_t c = 0; c < cn; ++c)
+        {
+            s32 l0 = border.leftAt(r[0], cn, c, borderValue), l1 = border.leftAt(r[1], cn, c, borderValue),
+                l2 = border.leftAt(r[2], cn, c, borderValue);
+            s32 q0 = border.rightAt(r[0], cn, c, borderValue), q1 = border.rightAt(r[1], cn, c, borderValue),
+                q2 = border.rightAt(r[2], cn, c, borderValue);
+            smooth[(ptrdiff_t)c - off] = (s16)((l0 + l2) * edge + l1 * mid);
+            diff[(ptrdiff_t)c - off] = (s16)(l2 - l0);
+            smooth[n + c] = (s16)((q0 + q2) * edge + q1 * mid);
+            diff[n + c] = (s16)(q2 - q0);
+        }
+
+        s16 * drow = internal::getRowPtr(dstBase, dstStride, y);
+        for (x = 0; x + 8 <= n; x += 8)
+        {
+            int16x8x2_t v_d;
+            v_d.val[0] = vsubq_s16(vld1q_s16(smooth + x + off), vld1q_s16(smooth + x - off));
+            v_d.val[1] = vmlaq_s16(vmulq_s16(vaddq_s16(vld1q_s16(diff + x - off), vld1q_s16(diff + x + off)), v_edge),
+                                   vld1q_s16(diff + x), v_mid);
+            vst2q_s16(drow + x * 2, v_d);
+        }
+        for (; x < n; ++x)
+        {
+            drow[x * 2] = (s16)(smooth[x + off] - smooth[x - off]);
+            drow[x * 2 + 1] = (s16)((diff[x - off] + diff[x + off]) * edge + diff[x] * mid);
+        }
+    }
+}
+
+} // namespace internal
+
+#endif
+
+void SeparableFilter3x3(const Size2D &size,
+                        const u8 * srcBase, ptrdiff_t srcStride,
+                        s16 * dstBase, ptrdiff_t dstStride,
+                        const u8 rowFilter, const u8 colFilter, const s16 *xw, const s16 *yw,
+                        BORDER_MODE border, u8 borderValue, Margin borderMargin)
+{
+    internal::assertSupportedConfiguration(isSeparableFilter3x3Supported(size, border, rowFilter, colFilter, borderMargin));
+#ifdef CAROTENE_NEON
+    FilterArgs args;
+    args.size = size;
+    args.srcBase = srcBase;
+    args.srcStride = srcStride;
+    args.dstBase = dstBase;
+    args.dstStride = dstStride;
+    args.borderValue = borderValue;
+    kernelWeights(rowFilter, xw, args.xw);
+    kernelWeights(colFilter, yw, args.yw);
+
+    internal::Border3x3 borderMap(size, border, borderMargin);
+    if (255 * absSum(args.xw) * absSum(args.yw) > 32767)
+    {
+        filter32(args, borderMap);
+        return;
+    }
+
+    Filter16Func func;
+    switch (colFilter)
+    {
+    case KERNEL_SMOOTH:
+        func = filter16Func<KERNEL_SMOOTH>(rowFilter);
+        break;
+    case KERNEL_DIFF:
+        func = filter16Func<KERNEL_DIFF>(rowFilter);
+        break;
+    case KERNEL_DIFF2:
+        func = filter16Func<KERNEL_DIFF2>(rowFilter);
+        break;
+    default:
+        func = filter16Func<KERNEL_CUSTOM>(rowFilter);
+        break;
+    }
+    func(args, borderMap);
+#else
+    (void)size;
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+    (void)rowFilter;
+    (void)colFilter;
+    (void)xw;
+    (void)yw;
+    (void)border;
+    (void)borderValue;
+    (void)borderMargin;
+#endif
+}
+
+} // namespace CAROTENE_NS
@@ -0,0 +1,134 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#ifndef CAROTENE_SRC_SEPARABLE_FILTER_HPP
+#define CAROTENE_SRC_SEPARABLE_FILTER_HPP
+
+#include "common.hpp"
+
+namespace CAROTENE_NS { namespace internal {
+
+inline bool isSeparable3x3Border(BORDER_MODE border)
+{
+    return border == BORDER_MODE_UNDEFINED ||
+           border == BORDER_MODE_CONSTANT ||
+           border == BORDER_MODE_REPLICATE ||
+           border == BORDER_MODE_REFLECT ||
+           border == BORDER_MODE_REFLECT101 ||
+           border == BORDER_MODE_WRAP;
+}
+
+/*
+    Rows and columns just outside the ROI of a 3x3 filter. `margin` elements of real data
+    exist around the ROI, as with internal::borderInterpolate, and the border mode applies
+    beyond them. BORDER_MODE_UNDEFINED is served as replicate.
+*/
+class Border3x3
+{
+public:
+    Border3x3(const Size2D &size, BORDER_MODE border, const Margin &margin)
+    {
+        BORDER_MODE mode = border == BORDER_MODE_UNDEFINED ? BORDER_MODE_REPLICATE : border;
+        constTop = map(-1, size.height, mode, margin.top, margin.bottom, top);
+        constBottom = map((ptrdiff_t)size.height, size.height, mode, margin.top, margin.bottom, bottom);
+        constLeft = map(-1, size.width, mode, margin.left, margin.right, left);
+        constRight = map((ptrdiff_t)size.width, size.width, mode, margin.left, margin.right, right);
+        height = size.height;
+    }
+
+    // Rows y - 1, y, y + 1; a row of the constant border is `constRow`
+    template <typename T>
+    void rows(const T * base, ptrdiff_t stride, size_t y, const T * constRow, const T * r[3]) const
+    {
+        r[0] = y > 0 ? row(base, stride, (ptrdiff_t)y - 1) : constTop ? constRow : row(base, stride, top);
+        r[1] = row(base, stride, (ptrdiff_t)y);
+        r[2] = y + 1 < height ? row(base, stride, (ptrdiff_t)y + 1) : constBottom ? constRow : row(base, stride, bottom);
+    }
+
+    // Element `c` (0 <= c < cn) of the pixel left of the ROI, `value` for the constant border
+    template <typename T>
+    T leftAt(const T * r, size_t cn, size_t c, T value) const
+    {
+        return constLeft ? value : r[left * (ptrdiff_t)cn + (ptrdiff_t)c];
+    }
+
+    template <typename T>
+    T rightAt(const T * r, size_t cn, size_t c, T value) const
+    {
+        return constRight ? value : r[right * (ptrdiff_t)cn + (ptrdiff_t)c];
+    }
+
+    ptrdiff_t top, bottom, left, right;
+    bool constTop, constBottom, constLeft, constRight;
+
+private:
+    static bool map(ptrdiff_t p, size_t len, BORDER_MODE mode, size_t startMargin, size_t endMargin, ptrdiff_t & idx)
+    {
+        bool inside = (size_t)(p + (ptrdiff_t)startMargin) < len + startMargin + endMargin;
+        idx = borderInterpolate(p, len, mode, startMargin, endMargin);
+        return !inside && mode == BORDER_MODE_CONSTANT;
+    }
+
+    template <typename T>
+    static const T * row(const T * base, ptrdiff_t stride, ptrdiff_t y)
+    {
+        return reinterpret_cast<const T *>(reinterpret_cast<const u8 *>(base) + y * stride);
+    }
+
+    size_t height;
+};
+
+#ifdef CAROTENE_NEON
+
+/*
+    First derivatives in x and y of a cn-channel u8 image in one pass, written as interleaved
+    (dx, dy) s16 pairs per element. The kernels are [-1 0 1] along the derivative and
+    [edge mid edge] across it: 1, 2 for Sobel and 3, 10 for Scharr.
+*/
+void derivatives3x3(const Size2D &size, size_t cn,
+                    const u8 * srcBase, ptrdiff_t srcStride,
+                    s16 * dstBase, ptrdiff_t dstStride,
+                    s16 edge, s16 mid,
+                    BORDER_MODE border, u8 borderValue, const Margin &borderMargin);
+
+#endif
+
+}}
+
+#endif
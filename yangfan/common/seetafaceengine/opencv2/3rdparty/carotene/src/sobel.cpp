@@ -0,0 +1,178 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "separable_filter.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace CAROTENE_NS {
+
+bool isSobel3x3Supported(const Size2D &size, BORDER_MODE border, s32 dx, s32 dy, Margin borderMargin)
+{
+    return dx >= 0 && dx < 3 && dy >= 0 && dy < 3 && dx + dy > 0 &&
+           isSeparableFilter3x3Supported(size, border, dx, dy, borderMargin);
+}
+
+void Sobel3x3(const Size2D &size,
+              const u8 * srcBase, ptrdiff_t srcStride,
+              s16 * dstBase, ptrdiff_t dstStride,
+              s32 dx, s32 dy,
+              BORDER_MODE border, u8 borderValue, Margin borderMargin)
+{
+    internal::assertSupportedConfiguration(isSobel3x3Supported(size, border, dx, dy, borderMargin));
+    // the predefined kernels of SeparableFilter3x3 are the Sobel kernels of order 0, 1 and 2
+    SeparableFilter3x3(size, srcBase, srcStride, dstBase, dstStride, (u8)dx, (u8)dy, NULL, NULL,
+                       border, borderValue, borderMargin);
+}
+
+bool isSobel3x3f32Supported(const Size2D &size, BORDER_MODE border, s32 dx, s32 dy)
+{
+    return isSupportedConfiguration() &&
+           dx >= 0 && dx < 3 && dy >= 0 && dy < 3 && dx + dy > 0 &&
+           size.width >= 1 && size.height >= 1 &&
+           internal::isSeparable3x3Border(border);
+}
+
+void Sobel3x3(const Size2D &size,
+              const f32 * srcBase, ptrdiff_t srcStride,
+              f32 * dstBase, ptrdiff_t dstStride,
+              s32 dx, s32 dy,
+              BORDER_MODE borderType, f32 borderValue)
+{
+    internal::assertSupportedConfiguration(isSobel3x3f32Supported(size, borderType, dx, dy));
+#ifdef CAROTENE_NEON
+    static const f32 kernels[3][3] = { { 1, 2, 1 }, { -1, 0, 1 }, { 1, -2, 1 } };
+    const f32 * xw = kernels[dx], * yw = kernels[dy];
+    const size_t width = size.width, height = size.height;
+    internal::Border3x3 border(size, borderType, Margin());
+
+    /*
+        The destination may alias the source, so source rows that are still needed once their
+        destination row is written are kept: the previous row, and the border rows read for the
+        first and last output rows.
+    */
+    std::vector<f32> _buf((width + 2) * 6, borderValue);
+    f32 * vrow = &_buf[1], * prevRow = vrow + width + 2, * rowCopy = prevRow + width + 2;
+    f32 * topRow = rowCopy + width + 2, * bottomRow = topRow + width + 2;
+    const f32 * constRow = bottomRow + width + 2;
+    {
+        const f32 * r[3];
+        border.rows(srcBase, srcStride, 0, constRow, r);
+        std::copy(r[0], r[0] + width, topRow);
+        border.rows(srcBase, srcStride, height - 1, constRow, r);
+        std::copy(r[2], r[2] + width, bottomRow);
+    }
+    const float32x4_t v_y0 = vdupq_n_f32(yw[0]), v_y1 = vdupq_n_f32(yw[1]), v_y2 = vdupq_n_f32(yw[2]);
+
+    for (size_t y = 0; y < height; ++y)
+    {
+        const f32 * r[3];
+        border.rows(srcBase, srcStride, y, constRow, r);
+        r[0] = y == 0 ? topRow : prevRow;
+        if (y + 1 == height)
+            r[2] = bottomRow;
+
+        size_t x = 0;
+        for (; x + 4 <= width; x += 4)
+        {
+            float32x4_t v = vmulq_f32(vld1q_f32(r[0] + x), v_y0);
+            v = vmlaq_f32(v, vld1q_f32(r[1] + x), v_y1);
+            vst1q_f32(vrow + x, vmlaq_f32(v, vld1q_f32(r[2] + x), v_y2));
+        }
+        for (; x < width; ++x)
+            vrow[x] = r[0][x] * yw[0] + r[1][x] * yw[1] + r[2][x] * yw[2];
+        vrow[-1] = border.leftAt(r[0], 1, 0, borderValue) * yw[0] + border.leftAt(r[1], 1, 0, borderValue) * yw[1] +
+                   border.leftAt(r[2], 1, 0, borderValue) * yw[2];
+        vrow[width] = border.rightAt(r[0], 1, 0, borderValue) * yw[0] + border.rightAt(r[1], 1, 0, borderValue) * yw[1] +
+                      border.rightAt(r[2], 1, 0, borderValue) * yw[2];
+
+        // row y is the previous row of the next output row
+        std::copy(r[1], r[1] + width, rowCopy);
+        std::swap(prevRow, rowCopy);
+
+        f32 * drow = internal::getRowPtr(dstBase, dstStride, y);
+        for (x = 0; x + 4 <= width; x += 4)
+        {
+            float32x4_t v = vmulq_n_f32(vld1q_f32(vrow + x - 1), xw[0]);
+            v = vmlaq_n_f32(v, vld1q_f32(vrow + x), xw[1]);
+            vst1q_f32(drow + x, vmlaq_n_f32(v, vld1q_f32(vrow + x + 1), xw[2]));
+        }
+        for (; x < width; ++x)
+            drow[x] = vrow[x - 1] * xw[0] + vrow[x] * xw[1] + vrow[x + 1] * xw[2];
+    }
+#else
+    (void)size;
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+    (void)dx;
+    (void)dy;
+    (void)borderType;
+    (void)borderValue;
+#endif
+}
+
+bool isSobel3x3dXdYSupported(const Size2D &size, BORDER_MODE border, Margin borderMargin)
+{
+    (void)borderMargin;
+    return isSupportedConfiguration() &&
+           size.width >= 1 && size.height >= 1 &&
+           internal::isSeparable3x3Border(border);
+}
+
+void Sobel3x3dXdY(const Size2D &size,
+                  const u8 * srcBase, ptrdiff_t srcStride,
+                  s16 * dstBase, ptrdiff_t dstStride,
+                  BORDER_MODE border, u8 borderValue, Margin borderMargin)
+{
+    internal::assertSupportedConfiguration(isSobel3x3dXdYSupported(size, border, borderMargin));
+#ifdef CAROTENE_NEON
+    internal::derivatives3x3(size, 1, srcBase, srcStride, dstBase, dstStride, 1, 2, border, borderValue, borderMargin);
+#else
+    (void)srcBase;
+    (void)srcStride;
+    (void)dstBase;
+    (void)dstStride;
+    (void)borderValue;
+#endif
+}
+
+} // namespace CAROTENE_NS
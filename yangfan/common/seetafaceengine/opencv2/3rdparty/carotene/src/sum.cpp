@@ -0,0 +1,349 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "common.hpp"
+
+#include <algorithm>
+
+namespace CAROTENE_NS {
+
+bool isSumSupported(u32 channels)
+{
+    return isSupportedConfiguration() && channels >= 1 && channels <= 4;
+}
+
+bool isSqsumSupported(u32 channels)
+{
+    return isSupportedConfiguration() && channels >= 1 && channels <= 4;
+}
+
+#ifdef CAROTENE_NEON
+
+namespace {
+
+// u16 lanes take two bytes per vpadal, so 128 rounds stay below 65535
+const size_t BYTE_BLOCK_ROUNDS = 128;
+// f32 partial sums are flushed into f64 every 256 rounds to bound the rounding error
+const size_t FLOAT_BLOCK_ROUNDS = 256;
+
+// Loads 16 pixels of cn interleaved u8 channels, or 4 of f32, as one vector per channel
+template <int cn> struct Deinterleave;
+
+template <> struct Deinterleave<1>
+{
+    static void load(const u8 * src, uint8x16_t * v) { v[0] = vld1q_u8(src); }
+    static void load(const f32 * src, float32x4_t * v) { v[0] = vld1q_f32(src); }
+};
+
+template <> struct Deinterleave<2>
+{
+    static void load(const u8 * src, uint8x16_t * v)
+    {
+        uint8x16x2_t v_src = vld2q_u8(src);
+        v[0] = v_src.val[0];
+        v[1] = v_src.val[1];
+    }
+    static void load(const f32 * src, float32x4_t * v)
+    {
+        float32x4x2_t v_src = vld2q_f32(src);
+        v[0] = v_src.val[0];
+        v[1] = v_src.val[1];
+    }
+};
+
+template <> struct Deinterleave<3>
+{
+    static void load(const u8 * src, uint8x16_t * v)
+    {
+        uint8x16x3_t v_src = vld3q_u8(src);
+        v[0] = v_src.val[0];
+        v[1] = v_src.val[1];
+        v[2] = v_src.val[2];
+    }
+    static void load(const f32 * src, float32x4_t * v)
+    {
+        float32x4x3_t v_src = vld3q_f32(src);
+        v[0] = v_src.val[0];
+        v[1] = v_src.val[1];
+        v[2] = v_src.val[2];
+    }
+};
+
+template <> struct Deinterleave<4>
+{
+    static void load(const u8 * src, uint8x16_t * v)
+    {
+        uint8x16x4_t v_src = vld4q_u8(src);
+        v[0] = v_src.val[0];
+        v[1] = v_src.val[1];
+        v[2] = v_src.val[2];
+        v[3] = v_src.val[3];
+    }
+    static void load(const f32 * src, float32x4_t * v)
+    {
+        float32x4x4_t v_src = vld4q_f32(src);
+        v[0] = v_src.val[0];
+        v[1] = v_src.val[1];
+        v[2] = v_src.val[2];
+        v[3] = v_src.val[3];
+    }
+};
+
+inline Size2D mergeRows(const Size2D &size, ptrdiff_t stride, size_t pixelSize)
+{
+    Size2D merged(size);
+    if (stride == (ptrdiff_t)(size.width * pixelSize))
+    {
+        merged.width *= merged.height;
+        merged.height = 1;
+    }
+    return merged;
+}
+
+/*
+ * Per channel sums, and sums of squares when asked, of a u8 image. Two groups of 16 pixels
+ * go to independent accumulators each round. Sums live in u16 lanes and squares in u32 lanes
+ * for a block of rounds, then both are widened into u64 lanes, so nothing overflows at any
+ * image size.
+ */
+template <int cn, bool squares>
+void sumBytes(const Size2D &_size,
+              const u8 * srcBase, ptrdiff_t srcStride,
+              u64 * sums, u64 * sqsums)
+{
+    Size2D size = mergeRows(_size, srcStride, cn);
+    size_t roiw32 = size.width >= 31 ? size.width - 31 : 0;
+
+    uint64x2_t v_sum[cn], v_sqsum[cn];
+    for (int c = 0; c < cn; ++c)
+    {
+        v_sum[c] = v_sqsum[c] = vdupq_n_u64(0);
+        sums[c] = sqsums[c] = 0;
+    }
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        const u8 * src = internal::getRowPtr(srcBase, srcStride, i);
+        size_t j = 0;
+
+        while (j < roiw32)
+        {
+            size_t blockEnd = std::min(j + BYTE_BLOCK_ROUNDS * 32, roiw32);
+            uint16x8_t v_sum16[2][cn];
+            uint32x4_t v_sqsum32[2][cn];
+            for (int c = 0; c < cn; ++c)
+            {
+                v_sum16[0][c] = v_sum16[1][c] = vdupq_n_u16(0);
+                v_sqsum32[0][c] = v_sqsum32[1][c] = vdupq_n_u32(0);
+            }
+
+            for (; j < blockEnd; j += 32)
+            {
+                internal::prefetch(src + j * cn);
+                uint8x16_t v_src[2][cn];
+                Deinterleave<cn>::load(src + j * cn, v_src[0]);
+                Deinterleave<cn>::load(src + (j + 16) * cn, v_src[1]);
+
+                for (int k = 0; k < 2; ++k)
+                    for (int c = 0; c < cn; ++c)
+                    {
+                        v_sum16[k][c] = vpadalq_u8(v_sum16[k][c], v_src[k][c]);
+                        if (squares)
+                        {
+                            uint8x8_t v_lo = vget_low_u8(v_src[k][c]), v_hi = vget_high_u8(v_src[k][c]);
+                            v_sqsum32[k][c] = vpadalq_u16(v_sqsum32[k][c], vmull_u8(v_lo, v_lo));
+                            v_sqsum32[k][c] = vpadalq_u16(v_sqsum32[k][c], vmull_u8(v_hi, v_hi));
+                        }
+                    }
+            }
+
+            for (int c = 0; c < cn; ++c)
+            {
+                v_sum[c] = vpadalq_u32(v_sum[c], vpadalq_u16(vpaddlq_u16(v_sum16[0][c]), v_sum16[1][c]));
+                if (squares)
+                    v_sqsum[c] = vpadalq_u32(v_sqsum[c], vaddq_u32(v_sqsum32[0][c], v_sqsum32[1][c]));
+            }
+        }
+
+        for (; j < size.width; ++j)
+            for (int c = 0; c < cn; ++c)
+            {
+                u32 v = src[j * cn + c];
+                sums[c] += v;
+                if (squares)
+                    sqsums[c] += v * v;
+            }
+    }
+
+    for (int c = 0; c < cn; ++c)
+    {
+        sums[c] += vgetq_lane_u64(v_sum[c], 0) + vgetq_lane_u64(v_sum[c], 1);
+        sqsums[c] += vgetq_lane_u64(v_sqsum[c], 0) + vgetq_lane_u64(v_sqsum[c], 1);
+    }
+}
+
+template <int cn>
+void sumFloats(const Size2D &_size,
+               const f32 * srcBase, ptrdiff_t srcStride,
+               f64 * sums)
+{
+    Size2D size = mergeRows(_size, srcStride, cn * sizeof(f32));
+    size_t roiw8 = size.width >= 7 ? size.width - 7 : 0;
+
+    for (int c = 0; c < cn; ++c)
+        sums[c] = 0;
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        const f32 * src = internal::getRowPtr(srcBase, srcStride, i);
+        size_t j = 0;
+
+        while (j < roiw8)
+        {
+            size_t blockEnd = std::min(j + FLOAT_BLOCK_ROUNDS * 8, roiw8);
+            float32x4_t v_sum[2][cn];
+            for (int c = 0; c < cn; ++c)
+                v_sum[0][c] = v_sum[1][c] = vdupq_n_f32(0);
+
+            for (; j < blockEnd; j += 8)
+            {
+                internal::prefetch(src + j * cn);
+                float32x4_t v_src[2][cn];
+                Deinterleave<cn>::load(src + j * cn, v_src[0]);
+                Deinterleave<cn>::load(src + (j + 4) * cn, v_src[1]);
+
+                for (int k = 0; k < 2; ++k)
+                    for (int c = 0; c < cn; ++c)
+                        v_sum[k][c] = vaddq_f32(v_sum[k][c], v_src[k][c]);
+            }
+
+            for (int c = 0; c < cn; ++c)
+            {
+                f32 lanes[4];
+                vst1q_f32(lanes, vaddq_f32(v_sum[0][c], v_sum[1][c]));
+                sums[c] += (f64)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+            }
+        }
+
+        for (; j < size.width; ++j)
+            for (int c = 0; c < cn; ++c)
+                sums[c] += src[j * cn + c];
+    }
+}
+
+template <bool squares>
+void sumBytes(const Size2D &size,
+              const u8 * srcBase, ptrdiff_t srcStride,
+              u64 * sums, u64 * sqsums, u32 channels)
+{
+    switch (channels)
+    {
+    case 1: sumBytes<1, squares>(size, srcBase, srcStride, sums, sqsums); break;
+    case 2: sumBytes<2, squares>(size, srcBase, srcStride, sums, sqsums); break;
+    case 3: sumBytes<3, squares>(size, srcBase, srcStride, sums, sqsums); break;
+    default: sumBytes<4, squares>(size, srcBase, srcStride, sums, sqsums); break;
+    }
+}
+
+} // namespace
+
+#endif
+
+void sum(const Size2D &_size,
+         const u8 * srcBase, ptrdiff_t srcStride,
+         u32 * sumdst, u32 channels)
+{
+    internal::assertSupportedConfiguration(isSumSupported(channels));
+#ifdef CAROTENE_NEON
+    u64 sums[4], sqsums[4];
+    sumBytes<false>(_size, srcBase, srcStride, sums, sqsums, channels);
+    for (u32 c = 0; c < channels; ++c)
+        sumdst[c] = (u32)sums[c];
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+    (void)sumdst;
+#endif
+}
+
+void sum(const Size2D &_size,
+         const f32 * srcBase, ptrdiff_t srcStride,
+         f64 * sumdst, u32 channels)
+{
+    internal::assertSupportedConfiguration(isSumSupported(channels));
+#ifdef CAROTENE_NEON
+    switch (channels)
+    {
+    case 1: sumFloats<1>(_size, srcBase, srcStride, sumdst); break;
+    case 2: sumFloats<2>(_size, srcBase, srcStride, sumdst); break;
+    case 3: sumFloats<3>(_size, srcBase, srcStride, sumdst); break;
+    default: sumFloats<4>(_size, srcBase, srcStride, sumdst); break;
+    }
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+    (void)sumdst;
+#endif
+}
+
+void sqsum(const Size2D &_size,
+           const u8 * srcBase, ptrdiff_t srcStride,
+           f64 * sumdst, f64 * sqsumdst, u32 channels)
+{
+    internal::assertSupportedConfiguration(isSqsumSupported(channels));
+#ifdef CAROTENE_NEON
+    u64 sums[4], sqsums[4];
+    sumBytes<true>(_size, srcBase, srcStride, sums, sqsums, channels);
+    for (u32 c = 0; c < channels; ++c)
+    {
+        sumdst[c] = (f64)sums[c];
+        sqsumdst[c] = (f64)sqsums[c];
+    }
+#else
+    (void)_size;
+    (void)srcBase;
+    (void)srcStride;
+    (void)sumdst;
+    (void)sqsumdst;
+#endif
+}
+
+} // namespace CAROTENE_NS
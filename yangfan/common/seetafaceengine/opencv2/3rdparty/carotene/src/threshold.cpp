@@ -0,0 +1,378 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "common.hpp"
+
+namespace CAROTENE_NS {
+
+#ifdef CAROTENE_NEON
+
+namespace {
+
+template <typename T> struct ThresholdVec;
+
+#define THRESHOLD_VEC(T, vec, mask, sfx)                                        \
+template <> struct ThresholdVec<T>                                              \
+{                                                                               \
+    typedef vec type;                                                           \
+    typedef mask mask_type;                                                     \
+                                                                                \
+    static type load(const T * ptr) { return vld1q_##sfx(ptr); }                \
+    static void store(T * ptr, type v) { vst1q_##sfx(ptr, v); }                 \
+    static type dup(T value) { return vdupq_n_##sfx(value); }                   \
+    static mask_type greater(type a, type b) { return vcgtq_##sfx(a, b); }      \
+    static type min(type a, type b) { return vminq_##sfx(a, b); }               \
+    static type select(mask_type m, type a, type b)                             \
+    {                                                                           \
+        return vbslq_##sfx(m, a, b);                                            \
+    }                                                                           \
+};
+
+THRESHOLD_VEC(u8,  uint8x16_t,  uint8x16_t, u8)
+THRESHOLD_VEC(s8,  int8x16_t,   uint8x16_t, s8)
+THRESHOLD_VEC(u16, uint16x8_t,  uint16x8_t, u16)
+THRESHOLD_VEC(s16, int16x8_t,   uint16x8_t, s16)
+THRESHOLD_VEC(s32, int32x4_t,   uint32x4_t, s32)
+
+#undef THRESHOLD_VEC
+
+template <> struct ThresholdVec<f32>
+{
+    typedef float32x4_t type;
+    typedef uint32x4_t mask_type;
+
+    static type load(const f32 * ptr) { return vld1q_f32(ptr); }
+    static void store(f32 * ptr, type v) { vst1q_f32(ptr, v); }
+    static type dup(f32 value) { return vdupq_n_f32(value); }
+    static mask_type greater(type a, type b) { return vcgtq_f32(a, b); }
+    // NaN has to pass through truncation as it does in the scalar code, so no vminq here
+    static type min(type a, type b) { return vbslq_f32(vcgtq_f32(a, b), b, a); }
+    static type select(mask_type m, type a, type b) { return vbslq_f32(m, a, b); }
+};
+
+// dst = src > threshold ? trueValue : falseValue
+template <typename T>
+struct ThresholdSelect
+{
+    typedef T type;
+    typedef ThresholdVec<T> V;
+
+    ThresholdSelect(T threshold_, T trueValue_, T falseValue_) :
+        threshold(threshold_), trueValue(trueValue_), falseValue(falseValue_),
+        v_threshold(V::dup(threshold_)), v_true(V::dup(trueValue_)), v_false(V::dup(falseValue_))
+    {
+    }
+
+    typename V::type operator() (const typename V::type & v_src) const
+    {
+        return V::select(V::greater(v_src, v_threshold), v_true, v_false);
+    }
+
+    T operator() (T src) const
+    {
+        return src > threshold ? trueValue : falseValue;
+    }
+
+    T threshold, trueValue, falseValue;
+    typename V::type v_threshold, v_true, v_false;
+};
+
+// dst = src > threshold ? threshold : src
+template <typename T>
+struct ThresholdTruncate
+{
+    typedef T type;
+    typedef ThresholdVec<T> V;
+
+    explicit ThresholdTruncate(T threshold_) :
+        threshold(threshold_), v_threshold(V::dup(threshold_))
+    {
+    }
+
+    typename V::type operator() (const typename V::type & v_src) const
+    {
+        return V::min(v_src, v_threshold);
+    }
+
+    T operator() (T src) const
+    {
+        return src > threshold ? threshold : src;
+    }
+
+    T threshold;
+    typename V::type v_threshold;
+};
+
+// dst = src > threshold ? src : 0, or the other way round when inverse
+template <typename T, bool inverse>
+struct ThresholdToZero
+{
+    typedef T type;
+    typedef ThresholdVec<T> V;
+
+    explicit ThresholdToZero(T threshold_) :
+        threshold(threshold_), v_threshold(V::dup(threshold_)), v_zero(V::dup(0))
+    {
+    }
+
+    typename V::type operator() (const typename V::type & v_src) const
+    {
+        typename V::mask_type v_mask = V::greater(v_src, v_threshold);
+        return inverse ? V::select(v_mask, v_zero, v_src) : V::select(v_mask, v_src, v_zero);
+    }
+
+    T operator() (T src) const
+    {
+        return (src > threshold) != inverse ? src : 0;
+    }
+
+    T threshold;
+    typename V::type v_threshold, v_zero;
+};
+
+// dst = lower <= src && src <= upper ? trueValue : falseValue
+struct ThresholdRange
+{
+    typedef u8 type;
+    typedef ThresholdVec<u8> V;
+
+    ThresholdRange(u8 lower_, u8 upper_, u8 trueValue_, u8 falseValue_) :
+        lower(lower_), upper(upper_), trueValue(trueValue_), falseValue(falseValue_),
+        v_lower(vdupq_n_u8(lower_)), v_upper(vdupq_n_u8(upper_)),
+        v_true(vdupq_n_u8(trueValue_)), v_false(vdupq_n_u8(falseValue_))
+    {
+    }
+
+    uint8x16_t operator() (const uint8x16_t & v_src) const
+    {
+        uint8x16_t v_mask = vandq_u8(vcgeq_u8(v_src, v_lower), vcleq_u8(v_src, v_upper));
+        return vbslq_u8(v_mask, v_true, v_false);
+    }
+
+    u8 operator() (u8 src) const
+    {
+        return lower <= src && src <= upper ? trueValue : falseValue;
+    }
+
+    u8 lower, upper, trueValue, falseValue;
+    uint8x16_t v_lower, v_upper, v_true, v_false;
+};
+
+template <typename Op>
+void thresholdRows(const Size2D &size,
+                   const typename Op::type * srcBase, ptrdiff_t srcStride,
+                   typename Op::type * dstBase, ptrdiff_t dstStride,
+                   const Op & op)
+{
+    typedef typename Op::type T;
+    typedef typename Op::V V;
+
+    const size_t step = 16 / sizeof(T);
+    size_t roiw2 = size.width >= 2 * step - 1 ? size.width - (2 * step - 1) : 0;
+    size_t roiw1 = size.width >= step - 1 ? size.width - (step - 1) : 0;
+
+    for (size_t i = 0; i < size.height; ++i)
+    {
+        const T * src = internal::getRowPtr(srcBase, srcStride, i);
+        T * dst = internal::getRowPtr(dstBase, dstStride, i);
+        size_t j = 0;
+
+        for (; j < roiw2; j += 2 * step)
+        {
+            internal::prefetch(src + j);
+            typename V::type v_dst0 = op(V::load(src + j));
+            typename V::type v_dst1 = op(V::load(src + j + step));
+            V::store(dst + j, v_dst0);
+            V::store(dst + j + step, v_dst1);
+        }
+        for (; j < roiw1; j += step)
+        {
+            V::store(dst + j, op(V::load(src + j)));
+        }
+        for (; j < size.width; ++j)
+        {
+            dst[j] = op(src[j]);
+        }
+    }
+}
+
+} // namespace
+
+void thresholdBinary(const Size2D &size,
+                     const u8 *srcBase, ptrdiff_t srcStride,
+                     u8 *dstBase, ptrdiff_t dstStride,
+                     u8 threshold, u8 trueValue, u8 falseValue)
+{
+    internal::assertSupportedConfiguration();
+    thresholdRows(size, srcBase, srcStride, dstBase, dstStride,
+                  ThresholdSelect<u8>(threshold, trueValue, falseValue));
+}
+
+void thresholdRange(const Size2D &size,
+                    const u8 *srcBase, ptrdiff_t srcStride,
+                    u8 *dstBase, ptrdiff_t dstStride,
+                    u8 lowerThreshold, u8 upperThreshold,
+                    u8 trueValue, u8 falseValue)
+{
+    internal::assertSupportedConfiguration();
+    thresholdRows(size, srcBase, srcStride, dstBase, dstStride,
+                  ThresholdRange(lowerThreshold, upperThreshold, trueValue, falseValue));
+}
+
+#define IMPL_THRESHOLD(type)                                                    \
+void thresholdBinary(const Size2D &size,                                        \
+                     const type *srcBase, ptrdiff_t srcStride,                  \
+                     type *dstBase, ptrdiff_t dstStride,                        \
+                     type threshold, type value)                                \
+{                                                                               \
+    internal::assertSupportedConfiguration();                                   \
+    thresholdRows(size, srcBase, srcStride, dstBase, dstStride,                 \
+                  ThresholdSelect<type>(threshold, value, 0));                  \
+}                                                                               \
+                                                                                \
+void thresholdBinaryInv(const Size2D &size,                                     \
+                        const type *srcBase, ptrdiff_t srcStride,               \
+                        type *dstBase, ptrdiff_t dstStride,                     \
+                        type threshold, type value)                             \
+{                                                                               \
+    internal::assertSupportedConfiguration();                                   \
+    thresholdRows(size, srcBase, srcStride, dstBase, dstStride,                 \
+                  ThresholdSelect<type>(threshold, 0, value));                  \
+}                                                                               \
+                                                                                \
+void thresholdTruncate(const Size2D &size,                                      \
+                       const type *srcBase, ptrdiff_t srcStride,                \
+                       type *dstBase, ptrdiff_t dstStride,                      \
+                       type threshold)                                          \
+{                                                                               \
+    internal::assertSupportedConfiguration();                                   \
+    thresholdRows(size, srcBase, srcStride, dstBase, dstStride,                 \
+                  ThresholdTruncate<type>(threshold));                          \
+}                                                                               \
+                                                                                \
+void thresholdToZero(const Size2D &size,                                        \
+                     const type *srcBase, ptrdiff_t srcStride,                  \
+                     type *dstBase, ptrdiff_t dstStride,                        \
+                     type threshold)                                            \
+{                                                                               \
+    internal::assertSupportedConfiguration();                                   \
+    thresholdRows(size, srcBase, srcStride, dstBase, dstStride,                 \
+                  ThresholdToZero<type, false>(threshold));                     \
+}                                                                               \
+                                                                                \
+void thresholdToZeroInv(const Size2D &size,                                     \
+                        const type *srcBase, ptrdiff_t srcStride,               \
+                        type *dstBase, ptrdiff_t dstStride,                     \
+                        type threshold)                                         \
+{                                                                               \
+    internal::assertSupportedConfiguration();                                   \
+    thresholdRows(size, srcBase, srcStride, dstBase, dstStride,                 \
+                  ThresholdToZero<type, true>(threshold));                      \
+}
+
+#else
+
+void thresholdBinary(const Size2D &,
+                     const u8 *, ptrdiff_t,
+                     u8 *, ptrdiff_t,
+                     u8, u8, u8)
+{
+    internal::assertSupportedConfiguration();
+}
+
+void thresholdRange(const Size2D &,
+                    const u8 *, ptrdiff_t,
+                    u8 *, ptrdiff_t,
+                    u8, u8,
+                    u8, u8)
+{
+    internal::assertSupportedConfiguration();
+}
+
+#define IMPL_THRESHOLD(type)                                                    \
+void thresholdBinary(const Size2D &,                                            \
+                     const type *, ptrdiff_t,                                   \
+                     type *, ptrdiff_t,                                         \
+                     type, type)                                                \
+{                                                                               \
+    internal::assertSupportedConfiguration();                                   \
+}                                                                               \
+                                                                                \
+void thresholdBinaryInv(const Size2D &,                                         \
+                        const type *, ptrdiff_t,                                \
+                        type *, ptrdiff_t,                                      \
+                        type, type)                                             \
+{                                                                               \
+    internal::assertSupportedConfiguration();                                   \
+}                                                                               \
+                                                                                \
+void thresholdTruncate(const Size2D &,                                          \
+                       const type *, ptrdiff_t,                                 \
+                       type *, ptrdiff_t,                                       \
+                       type)                                                    \
+{                                                                               \
+    internal::assertSupportedConfiguration();                                   \
+}                                                                               \
+                                                                                \
+void thresholdToZero(const Size2D &,                                            \
+                     const type *, ptrdiff_t,                                   \
+                     type *, ptrdiff_t,                                         \
+                     type)                                                      \
+{                                                                               \
+    internal::assertSupportedConfiguration();                                   \
+}                                                                               \
+                                                                                \
+void thresholdToZeroInv(const Size2D &,                                         \
+                        const type *, ptrdiff_t,                                \
+                        type *, ptrdiff_t,                                      \
+                        type)                                                   \
+{                                                                               \
+    internal::assertSupportedConfiguration();                                   \
+}
+
+#endif
+
+IMPL_THRESHOLD(u8)
+IMPL_THRESHOLD(s8)
+IMPL_THRESHOLD(u16)
+IMPL_THRESHOLD(s16)
+IMPL_THRESHOLD(s32)
+IMPL_THRESHOLD(f32)
+
+} // namespace CAROTENE_NS
@@ -0,0 +1,296 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#ifndef CAROTENE_SRC_VTRANSFORM_HPP
+#define CAROTENE_SRC_VTRANSFORM_HPP
+
+#include "common.hpp"
+
+#include <carotene/types.hpp>
+
+#ifdef CAROTENE_NEON
+
+namespace CAROTENE_NS { namespace internal {
+
+////////////////////////////// Type Traits ///////////////////////
+
+template <typename T, int cn = 1>
+struct VecTraits;
+
+template <> struct VecTraits<   u8, 1> { typedef   uint8x16_t vec128; typedef   uint8x8_t vec64; typedef VecTraits<   u8, 1> unsign; };
+template <> struct VecTraits<   s8, 1> { typedef    int8x16_t vec128; typedef    int8x8_t vec64; typedef VecTraits<   u8, 1> unsign; };
+template <> struct VecTraits<  u16, 1> { typedef   uint16x8_t vec128; typedef  uint16x4_t vec64; typedef VecTraits<  u16, 1> unsign; };
+template <> struct VecTraits<  s16, 1> { typedef    int16x8_t vec128; typedef   int16x4_t vec64; typedef VecTraits<  u16, 1> unsign; };
+template <> struct VecTraits<  u32, 1> { typedef   uint32x4_t vec128; typedef  uint32x2_t vec64; typedef VecTraits<  u32, 1> unsign; };
+template <> struct VecTraits<  s32, 1> { typedef    int32x4_t vec128; typedef   int32x2_t vec64; typedef VecTraits<  u32, 1> unsign; };
+template <> struct VecTraits<  u64, 1> { typedef   uint64x2_t vec128; typedef  uint64x1_t vec64; typedef VecTraits<  u64, 1> unsign; };
+template <> struct VecTraits<  s64, 1> { typedef    int64x2_t vec128; typedef   int64x1_t vec64; typedef VecTraits<  u64, 1> unsign; };
+template <> struct VecTraits<  f32, 1> { typedef  float32x4_t vec128; typedef float32x2_t vec64; typedef VecTraits<  u32, 1> unsign; };
+
+#define DEFINE_VEC_TRAITS_N(type, vec128_, vec64_, n)                                       \
+    template <> struct VecTraits<type, n> { typedef vec128_##x##n##_t vec128;                \
+                                            typedef vec64_##x##n##_t vec64; };
+
+#define DEFINE_VEC_TRAITS(type, vec128_, vec64_)      \
+    DEFINE_VEC_TRAITS_N(type, vec128_, vec64_, 2)     \
+    DEFINE_VEC_TRAITS_N(type, vec128_, vec64_, 3)     \
+    DEFINE_VEC_TRAITS_N(type, vec128_, vec64_, 4)
+
+DEFINE_VEC_TRAITS(  u8,  uint8x16,   uint8x8)
+DEFINE_VEC_TRAITS(  s8,   int8x16,    int8x8)
+DEFINE_VEC_TRAITS( u16,  uint16x8,  uint16x4)
+DEFINE_VEC_TRAITS( s16,   int16x8,   int16x4)
+DEFINE_VEC_TRAITS( u32,  uint32x4,  uint32x2)
+DEFINE_VEC_TRAITS( s32,   int32x4,   int32x2)
+DEFINE_VEC_TRAITS( u64,  uint64x2,  uint64x1)
+DEFINE_VEC_TRAITS( s64,   int64x2,   int64x1)
+DEFINE_VEC_TRAITS( f32, float32x4, float32x2)
+
+#undef DEFINE_VEC_TRAITS
+#undef DEFINE_VEC_TRAITS_N
+
+////////////////////////////// Overloaded intrinsics ///////////////////////
+
+// Type-generic spellings of the NEON intrinsics, so that the kernels can be written
+// once for all element types: internal::vaddq(a, b) instead of vaddq_u8(a, b).
+
+#define DEFINE_LOAD_STORE(type, sfx)                                                                           \
+    inline VecTraits<type>::vec128 vld1q(const type * ptr) { return vld1q_##sfx(ptr); }                        \
+    inline VecTraits<type>::vec64 vld1(const type * ptr) { return vld1_##sfx(ptr); }                           \
+    inline VecTraits<type, 2>::vec128 vld2q(const type * ptr) { return vld2q_##sfx(ptr); }                     \
+    inline VecTraits<type, 2>::vec64 vld2(const type * ptr) { return vld2_##sfx(ptr); }                        \
+    inline VecTraits<type, 3>::vec128 vld3q(const type * ptr) { return vld3q_##sfx(ptr); }                     \
+    inline VecTraits<type, 3>::vec64 vld3(const type * ptr) { return vld3_##sfx(ptr); }                        \
+    inline VecTraits<type, 4>::vec128 vld4q(const type * ptr) { return vld4q_##sfx(ptr); }                     \
+    inline VecTraits<type, 4>::vec64 vld4(const type * ptr) { return vld4_##sfx(ptr); }                        \
+    inline void vst1q(type * ptr, const VecTraits<type>::vec128 & v) { vst1q_##sfx(ptr, v); }                  \
+    inline void vst1(type * ptr, const VecTraits<type>::vec64 & v) { vst1_##sfx(ptr, v); }                     \
+    inline void vst2q(type * ptr, const VecTraits<type, 2>::vec128 & v) { vst2q_##sfx(ptr, v); }               \
+    inline void vst2(type * ptr, const VecTraits<type, 2>::vec64 & v) { vst2_##sfx(ptr, v); }                  \
+    inline void vst3q(type * ptr, const VecTraits<type, 3>::vec128 & v) { vst3q_##sfx(ptr, v); }               \
+    inline void vst3(type * ptr, const VecTraits<type, 3>::vec64 & v) { vst3_##sfx(ptr, v); }                  \
+    inline void vst4q(type * ptr, const VecTraits<type, 4>::vec128 & v) { vst4q_##sfx(ptr, v); }               \
+    inline void vst4(type * ptr, const VecTraits<type, 4>::vec64 & v) { vst4_##sfx(ptr, v); }                  \
+    inline VecTraits<type>::vec128 vdupq_n(type value) { return vdupq_n_##sfx(value); }                      \
+    inline VecTraits<type>::vec64 vdup_n(type value) { return vdup_n_##sfx(value); }                          \
+    inline VecTraits<type>::vec128 vrev64q(const VecTraits<type>::vec128 & v) { return vrev64q_##sfx(v); }     \
+    inline VecTraits<type>::vec64 vrev64(const VecTraits<type>::vec64 & v) { return vrev64_##sfx(v); }        \
+    inline VecTraits<type>::vec64 vget_low(const VecTraits<type>::vec128 & v) { return vget_low_##sfx(v); }    \
+    inline VecTraits<type>::vec64 vget_high(const VecTraits<type>::vec128 & v) { return vget_high_##sfx(v); }  \
+    inline VecTraits<type>::vec128 vcombine(const VecTraits<type>::vec64 & v0,                                  \
+                                            const VecTraits<type>::vec64 & v1) { return vcombine_##sfx(v0, v1); }
+
+DEFINE_LOAD_STORE(  u8,  u8)
+DEFINE_LOAD_STORE(  s8,  s8)
+DEFINE_LOAD_STORE( u16, u16)
+DEFINE_LOAD_STORE( s16, s16)
+DEFINE_LOAD_STORE( u32, u32)
+DEFINE_LOAD_STORE( s32, s32)
+DEFINE_LOAD_STORE( f32, f32)
+
+#undef DEFINE_LOAD_STORE
+
+// loads and stores of 64-bit lanes (no vld3/vld4 forms for them on ARMv7)
+inline VecTraits<u64>::vec128 vld1q(const u64 * ptr) { return vld1q_u64(ptr); }
+inline VecTraits<u64>::vec64 vld1(const u64 * ptr) { return vld1_u64(ptr); }
+inline VecTraits<s64>::vec128 vld1q(const s64 * ptr) { return vld1q_s64(ptr); }
+inline VecTraits<s64>::vec64 vld1(const s64 * ptr) { return vld1_s64(ptr); }
+inline void vst1q(u64 * ptr, const VecTraits<u64>::vec128 & v) { vst1q_u64(ptr, v); }
+inline void vst1(u64 * ptr, const VecTraits<u64>::vec64 & v) { vst1_u64(ptr, v); }
+inline void vst1q(s64 * ptr, const VecTraits<s64>::vec128 & v) { vst1q_s64(ptr, v); }
+inline void vst1(s64 * ptr, const VecTraits<s64>::vec64 & v) { vst1_s64(ptr, v); }
+
+#define DEFINE_BINARY_OP(op, vec, res, sfx)                                       \
+    inline res op(const vec & v0, const vec & v1) { return op##_##sfx(v0, v1); }
+
+#define DEFINE_ARITHM(type, usfx, sfx)                                                                               \
+    DEFINE_BINARY_OP(vaddq, VecTraits<type>::vec128, VecTraits<type>::vec128, sfx)                                  \
+    DEFINE_BINARY_OP(vadd, VecTraits<type>::vec64, VecTraits<type>::vec64, sfx)                                     \
+    DEFINE_BINARY_OP(vsubq, VecTraits<type>::vec128, VecTraits<type>::vec128, sfx)                                  \
+    DEFINE_BINARY_OP(vsub, VecTraits<type>::vec64, VecTraits<type>::vec64, sfx)                                     \
+    DEFINE_BINARY_OP(vabdq, VecTraits<type>::vec128, VecTraits<type>::vec128, sfx)                                  \
+    DEFINE_BINARY_OP(vabd, VecTraits<type>::vec64, VecTraits<type>::vec64, sfx)                                     \
+    DEFINE_BINARY_OP(vminq, VecTraits<type>::vec128, VecTraits<type>::vec128, sfx)                                  \
+    DEFINE_BINARY_OP(vmin, VecTraits<type>::vec64, VecTraits<type>::vec64, sfx)                                     \
+    DEFINE_BINARY_OP(vmaxq, VecTraits<type>::vec128, VecTraits<type>::vec128, sfx)                                  \
+    DEFINE_BINARY_OP(vmax, VecTraits<type>::vec64, VecTraits<type>::vec64, sfx)                                     \
+    DEFINE_BINARY_OP(vceqq, VecTraits<type>::vec128, VecTraits<type>::unsign::vec128, sfx)                          \
+    DEFINE_BINARY_OP(vceq, VecTraits<type>::vec64, VecTraits<type>::unsign::vec64, sfx)                             \
+    DEFINE_BINARY_OP(vcgeq, VecTraits<type>::vec128, VecTraits<type>::unsign::vec128, sfx)                          \
+    DEFINE_BINARY_OP(vcge, VecTraits<type>::vec64, VecTraits<type>::unsign::vec64, sfx)                             \
+    DEFINE_BINARY_OP(vcgtq, VecTraits<type>::vec128, VecTraits<type>::unsign::vec128, sfx)                          \
+    DEFINE_BINARY_OP(vcgt, VecTraits<type>::vec64, VecTraits<type>::unsign::vec64, sfx)
+
+DEFINE_ARITHM(  u8,  u8,  u8)
+DEFINE_ARITHM(  s8,  u8,  s8)
+DEFINE_ARITHM( u16, u16, u16)
+DEFINE_ARITHM( s16, u16, s16)
+DEFINE_ARITHM( u32, u32, u32)
+DEFINE_ARITHM( s32, u32, s32)
+DEFINE_ARITHM( f32, u32, f32)
+
+#define DEFINE_INTEGER_OP(type, sfx)                                                                                 \
+    DEFINE_BINARY_OP(vqaddq, VecTraits<type>::vec128, VecTraits<type>::vec128, sfx)                                 \
+    DEFINE_BINARY_OP(vqadd, VecTraits<type>::vec64, VecTraits<type>::vec64, sfx)                                    \
+    DEFINE_BINARY_OP(vqsubq, VecTraits<type>::vec128, VecTraits<type>::vec128, sfx)                                 \
+    DEFINE_BINARY_OP(vqsub, VecTraits<type>::vec64, VecTraits<type>::vec64, sfx)                                    \
+    DEFINE_BINARY_OP(vandq, VecTraits<type>::vec128, VecTraits<type>::vec128, sfx)                                  \
+    DEFINE_BINARY_OP(vand, VecTraits<type>::vec64, VecTraits<type>::vec64, sfx)                                     \
+    DEFINE_BINARY_OP(vorrq, VecTraits<type>::vec128, VecTraits<type>::vec128, sfx)                                  \
+    DEFINE_BINARY_OP(vorr, VecTraits<type>::vec64, VecTraits<type>::vec64, sfx)                                     \
+    DEFINE_BINARY_OP(veorq, VecTraits<type>::vec128, VecTraits<type>::vec128, sfx)                                  \
+    DEFINE_BINARY_OP(veor, VecTraits<type>::vec64, VecTraits<type>::vec64, sfx)                                     \
+    inline VecTraits<type>::vec128 vmvnq(const VecTraits<type>::vec128 & v) { return vmvnq_##sfx(v); }              \
+    inline VecTraits<type>::vec64 vmvn(const VecTraits<type>::vec64 & v) { return vmvn_##sfx(v); }
+
+DEFINE_INTEGER_OP(  u8,  u8)
+DEFINE_INTEGER_OP(  s8,  s8)
+DEFINE_INTEGER_OP( u16, u16)
+DEFINE_INTEGER_OP( s16, s16)
+DEFINE_INTEGER_OP( u32, u32)
+DEFINE_INTEGER_OP( s32, s32)
+
+// 64-bit lanes only take the wrapping and saturating additions
+DEFINE_BINARY_OP(vaddq, VecTraits<u64>::vec128, VecTraits<u64>::vec128, u64)
+DEFINE_BINARY_OP(vadd, VecTraits<u64>::vec64, VecTraits<u64>::vec64, u64)
+DEFINE_BINARY_OP(vaddq, VecTraits<s64>::vec128, VecTraits<s64>::vec128, s64)
+DEFINE_BINARY_OP(vadd, VecTraits<s64>::vec64, VecTraits<s64>::vec64, s64)
+DEFINE_BINARY_OP(vqaddq, VecTraits<u64>::vec128, VecTraits<u64>::vec128, u64)
+DEFINE_BINARY_OP(vqadd, VecTraits<u64>::vec64, VecTraits<u64>::vec64, u64)
+DEFINE_BINARY_OP(vqaddq, VecTraits<s64>::vec128, VecTraits<s64>::vec128, s64)
+DEFINE_BINARY_OP(vqadd, VecTraits<s64>::vec64, VecTraits<s64>::vec64, s64)
+
+#undef DEFINE_INTEGER_OP
+#undef DEFINE_ARITHM
+#undef DEFINE_BINARY_OP
+
+// widening and narrowing moves
+inline uint16x8_t vmovl(const uint8x8_t & v) { return vmovl_u8(v); }
+inline int16x8_t vmovl(const int8x8_t & v) { return vmovl_s8(v); }
+inline uint32x4_t vmovl(const uint16x4_t & v) { return vmovl_u16(v); }
+inline int32x4_t vmovl(const int16x4_t & v) { return vmovl_s16(v); }
+inline uint64x2_t vmovl(const uint32x2_t & v) { return vmovl_u32(v); }
+inline int64x2_t vmovl(const int32x2_t & v) { return vmovl_s32(v); }
+
+inline uint8x8_t vmovn(const uint16x8_t & v) { return vmovn_u16(v); }
+inline int8x8_t vmovn(const int16x8_t & v) { return vmovn_s16(v); }
+inline uint16x4_t vmovn(const uint32x4_t & v) { return vmovn_u32(v); }
+inline int16x4_t vmovn(const int32x4_t & v) { return vmovn_s32(v); }
+inline uint32x2_t vmovn(const uint64x2_t & v) { return vmovn_u64(v); }
+inline int32x2_t vmovn(const int64x2_t & v) { return vmovn_s64(v); }
+
+inline uint8x8_t vqmovn(const uint16x8_t & v) { return vqmovn_u16(v); }
+inline int8x8_t vqmovn(const int16x8_t & v) { return vqmovn_s16(v); }
+inline uint16x4_t vqmovn(const uint32x4_t & v) { return vqmovn_u32(v); }
+inline int16x4_t vqmovn(const int32x4_t & v) { return vqmovn_s32(v); }
+inline uint32x2_t vqmovn(const uint64x2_t & v) { return vqmovn_u64(v); }
+inline int32x2_t vqmovn(const int64x2_t & v) { return vqmovn_s64(v); }
+
+////////////////////////////// vtransform ///////////////////////
+
+// Applies a binary element-wise Op to two images of Op::type. The Op provides the 128-bit,
+// the 64-bit and the scalar form of the operation: rows are processed 32 bytes at a time,
+// then 8 bytes at a time and the rest element by element. Continuous images are walked as
+// a single row.
+template <typename Op>
+void vtransform(Size2D size,
+                const typename Op::type * src0Base, ptrdiff_t src0Stride,
+                const typename Op::type * src1Base, ptrdiff_t src1Stride,
+                typename Op::type * dstBase, ptrdiff_t dstStride, const Op & op)
+{
+    typedef typename Op::type type;
+    typedef typename VecTraits<type>::vec128 vec128;
+    typedef typename VecTraits<type>::vec64 vec64;
+
+    if (src0Stride == src1Stride && src0Stride == dstStride &&
+        src0Stride == (ptrdiff_t)(size.width * sizeof(type)))
+    {
+        size.width *= size.height;
+        size.height = 1;
+    }
+
+    const size_t step_base = 32 / sizeof(type);
+    size_t roiw_base = size.width >= (step_base - 1) ? size.width - step_base + 1 : 0;
+    const size_t step_tail = 8 / sizeof(type);
+    size_t roiw_tail = size.width >= (step_tail - 1) ? size.width - step_tail + 1 : 0;
+
+    for (size_t y = 0; y < size.height; ++y)
+    {
+        const type * src0 = getRowPtr(src0Base, src0Stride, y);
+        const type * src1 = getRowPtr(src1Base, src1Stride, y);
+        type * dst = getRowPtr(dstBase, dstStride, y);
+        size_t x = 0;
+
+        for( ; x < roiw_base; x += step_base )
+        {
+            prefetch(src0 + x);
+            prefetch(src1 + x);
+
+            vec128 v_src00 = vld1q(src0 + x), v_src01 = vld1q(src0 + x + 16 / sizeof(type));
+            vec128 v_src10 = vld1q(src1 + x), v_src11 = vld1q(src1 + x + 16 / sizeof(type));
+            vec128 v_dst;
+
+            op(v_src00, v_src10, v_dst);
+            vst1q(dst + x, v_dst);
+
+            op(v_src01, v_src11, v_dst);
+            vst1q(dst + x + 16 / sizeof(type), v_dst);
+        }
+        for( ; x < roiw_tail; x += step_tail )
+        {
+            vec64 v_src0 = vld1(src0 + x);
+            vec64 v_src1 = vld1(src1 + x);
+            vec64 v_dst;
+
+            op(v_src0, v_src1, v_dst);
+            vst1(dst + x, v_dst);
+        }
+
+        for (; x < size.width; ++x)
+        {
+            op(src0 + x, src1 + x, dst + x);
+        }
+    }
+}
+
+} }
+
+#endif // CAROTENE_NEON
+
+#endif
@@ -0,0 +1,204 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "remap.hpp"
+
+#include <climits>
+#include <cmath>
+#include <vector>
+
+namespace CAROTENE_NS {
+
+bool isWarpAffineNearestNeighborSupported(const Size2D &ssize)
+{
+    // coordinates are gathered through s16 maps
+    return isSupportedConfiguration() &&
+           (ssize.width < SHRT_MAX) && (ssize.height < SHRT_MAX);
+}
+
+bool isWarpAffineLinearSupported(const Size2D &ssize)
+{
+    return isSupportedConfiguration() &&
+           (ssize.width < SHRT_MAX) && (ssize.height < SHRT_MAX);
+}
+
+#ifdef CAROTENE_NEON
+
+namespace {
+
+enum
+{
+    AB_BITS = 10,
+    AB_SCALE = 1 << AB_BITS
+};
+
+inline s32 roundToS32(f64 v)
+{
+    return (s32)std::lrint(std::min<f64>(std::max<f64>(v, INT_MIN), INT_MAX));
+}
+
+/*
+    Coordinates follow cv::warpAffine: the per column terms m[0] * x, m[1] * x are rounded
+    once into AB_BITS fixed point, every tile row adds its own rounded offset and shifts down
+    to integer pixels (nearest) or to INTER_BITS fractions (linear), so the maps are bit-exact
+    with OpenCV for the same matrix.
+*/
+template <bool linear>
+void warpAffine(const Size2D &ssize, const Size2D &dsize,
+                const u8 * srcBase, ptrdiff_t srcStride,
+                const f32 * m,
+                u8 * dstBase, ptrdiff_t dstStride,
+                BORDER_MODE borderMode, u8 borderValue)
+{
+    const s32 roundDelta = linear ? AB_SCALE / internal::INTER_TAB_SIZE / 2 : AB_SCALE / 2;
+    const size_t block = internal::REMAP_BLOCK_SIZE;
+
+    // padded to whole 4 lane groups, the extra lanes land in unused map entries
+    size_t columns = (dsize.width + 3) & ~(size_t)3;
+    std::vector<s32> _adelta(columns), _bdelta(columns);
+    for (size_t x = 0; x < columns; ++x)
+    {
+        _adelta[x] = roundToS32((f64)m[0] * x * AB_SCALE);
+        _bdelta[x] = roundToS32((f64)m[1] * x * AB_SCALE);
+    }
+
+    s16 xy[block * block * 2];
+    u16 alpha[block * block];
+    const int32x4_t v_mask = vdupq_n_s32(internal::INTER_TAB_SIZE - 1);
+
+    for (size_t by = 0; by < dsize.height; by += block)
+    {
+        size_t bh = std::min(block, dsize.height - by);
+        for (size_t bx = 0; bx < dsize.width; bx += block)
+        {
+            size_t bw = std::min(block, dsize.width - bx);
+            // columns is a multiple of 4, so the last group of a partial tile stays inside it
+            size_t groups = std::min(block, columns - bx);
+
+            for (size_t y = 0; y < bh; ++y)
+            {
+                int32x4_t v_X0 = vdupq_n_s32(roundToS32(((f64)m[2] * (by + y) + m[4]) * AB_SCALE) + roundDelta);
+                int32x4_t v_Y0 = vdupq_n_s32(roundToS32(((f64)m[3] * (by + y) + m[5]) * AB_SCALE) + roundDelta);
+                s16 * map = xy + y * block * 2;
+                u16 * a = alpha + y * block;
+
+                for (size_t x = 0; x < groups; x += 4)
+                {
+                    int32x4_t v_X = vaddq_s32(v_X0, vld1q_s32(&_adelta[bx + x]));
+                    int32x4_t v_Y = vaddq_s32(v_Y0, vld1q_s32(&_bdelta[bx + x]));
+                    int16x4x2_t v_xy;
+                    if (linear)
+                    {
+                        v_X = vshrq_n_s32(v_X, AB_BITS - internal::INTER_BITS);
+                        v_Y = vshrq_n_s32(v_Y, AB_BITS - internal::INTER_BITS);
+                        v_xy.val[0] = vqmovn_s32(vshrq_n_s32(v_X, internal::INTER_BITS));
+                        v_xy.val[1] = vqmovn_s32(vshrq_n_s32(v_Y, internal::INTER_BITS));
+                        int32x4_t v_a = vorrq_s32(vshlq_n_s32(vandq_s32(v_Y, v_mask), internal::INTER_BITS),
+                                                  vandq_s32(v_X, v_mask));
+                        vst1_u16(a + x, vmovn_u32(vreinterpretq_u32_s32(v_a)));
+                    }
+                    else
+                    {
+                        v_xy.val[0] = vqmovn_s32(vshrq_n_s32(v_X, AB_BITS));
+                        v_xy.val[1] = vqmovn_s32(vshrq_n_s32(v_Y, AB_BITS));
+                    }
+                    vst2_s16(map + x * 2, v_xy);
+                }
+            }
+
+            Size2D tile(bw, bh);
+            u8 * dst = internal::getRowPtr(dstBase, dstStride, by) + bx;
+            if (linear)
+                internal::remapLinearTile(ssize, tile, srcBase, srcStride,
+                                          xy, sizeof(xy) / block, alpha, sizeof(alpha) / block,
+                                          dst, dstStride, borderMode, borderValue);
+            else
+                internal::remapNearestNeighborTile(ssize, tile, srcBase, srcStride, xy, sizeof(xy) / block,
+                                                   dst, dstStride, borderMode, borderValue);
+        }
+    }
+}
+
+} // namespace
+
+#endif
+
+void warpAffineNearestNeighbor(const Size2D &ssize, const Size2D &dsize,
+                               const u8 * srcBase, ptrdiff_t srcStride,
+                               const f32 * m,
+                               u8 * dstBase, ptrdiff_t dstStride,
+                               BORDER_MODE borderMode, u8 borderValue)
+{
+    internal::assertSupportedConfiguration(isWarpAffineNearestNeighborSupported(ssize));
+#ifdef CAROTENE_NEON
+    warpAffine<false>(ssize, dsize, srcBase, srcStride, m, dstBase, dstStride, borderMode, borderValue);
+#else
+    (void)dsize;
+    (void)srcBase;
+    (void)srcStride;
+    (void)m;
+    (void)dstBase;
+    (void)dstStride;
+    (void)borderMode;
+    (void)borderValue;
+#endif
+}
+
+void warpAffineLinear(const Size2D &ssize, const Size2D &dsize,
+                      const u8 * srcBase, ptrdiff_t srcStride,
+                      const f32 * m,
+                      u8 * dstBase, ptrdiff_t dstStride,
+                      BORDER_MODE borderMode, u8 borderValue)
+{
+    internal::assertSupportedConfiguration(isWarpAffineLinearSupported(ssize));
+#ifdef CAROTENE_NEON
+    warpAffine<true>(ssize, dsize, srcBase, srcStride, m, dstBase, dstStride, borderMode, borderValue);
+#else
+    (void)dsize;
+    (void)srcBase;
+    (void)srcStride;
+    (void)m;
+    (void)dstBase;
+    (void)dstStride;
+    (void)borderMode;
+    (void)borderValue;
+#endif
+}
+
+} // namespace CAROTENE_NS
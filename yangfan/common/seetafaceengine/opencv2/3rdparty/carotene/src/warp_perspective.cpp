@@ -0,0 +1,189 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "remap.hpp"
+
+#include <climits>
+
+namespace CAROTENE_NS {
+
+bool isWarpPerspectiveNearestNeighborSupported(const Size2D &ssize)
+{
+    // coordinates are gathered through s16 maps
+    return isSupportedConfiguration() &&
+           (ssize.width < SHRT_MAX) && (ssize.height < SHRT_MAX);
+}
+
+bool isWarpPerspectiveLinearSupported(const Size2D &ssize)
+{
+    return isSupportedConfiguration() &&
+           (ssize.width < SHRT_MAX) && (ssize.height < SHRT_MAX);
+}
+
+#ifdef CAROTENE_NEON
+
+namespace {
+
+/*
+    Coordinates are computed in f32 with a Newton refined reciprocal of w, so they may differ
+    from cv::warpPerspective (which divides in f64) by one unit in the last place: one pixel
+    for coordinates that fall on a rounding boundary with nearest, 1 / INTER_TAB_SIZE with linear.
+*/
+template <bool linear>
+void warpPerspective(const Size2D &ssize, const Size2D &dsize,
+                     const u8 * srcBase, ptrdiff_t srcStride,
+                     const f32 * m,
+                     u8 * dstBase, ptrdiff_t dstStride,
+                     BORDER_MODE borderMode, u8 borderValue)
+{
+    const size_t block = internal::REMAP_BLOCK_SIZE;
+
+    s16 xy[block * block * 2];
+    u16 alpha[block * block];
+    const float32x4_t v_m0 = vdupq_n_f32(m[0]), v_m1 = vdupq_n_f32(m[1]), v_m2 = vdupq_n_f32(m[2]);
+    const float32x4_t v_scale = vdupq_n_f32(linear ? (f32)internal::INTER_TAB_SIZE : 1.0f);
+    const float32x4_t v_zero = vdupq_n_f32(0.0f), v_4 = vdupq_n_f32(4.0f);
+    const int32x4_t v_mask = vdupq_n_s32(internal::INTER_TAB_SIZE - 1);
+    const f32 lanes[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+
+    for (size_t by = 0; by < dsize.height; by += block)
+    {
+        size_t bh = std::min(block, dsize.height - by);
+        for (size_t bx = 0; bx < dsize.width; bx += block)
+        {
+            size_t bw = std::min(block, dsize.width - bx);
+
+            for (size_t y = 0; y < bh; ++y)
+            {
+                f32 fy = (f32)(by + y);
+                float32x4_t v_X0 = vdupq_n_f32(m[3] * fy + m[6]);
+                float32x4_t v_Y0 = vdupq_n_f32(m[4] * fy + m[7]);
+                float32x4_t v_W0 = vdupq_n_f32(m[5] * fy + m[8]);
+                float32x4_t v_x = vaddq_f32(vdupq_n_f32((f32)bx), vld1q_f32(lanes));
+                s16 * map = xy + y * block * 2;
+                u16 * a = alpha + y * block;
+
+                // partial tiles compute up to three extra lanes into unused map entries
+                for (size_t x = 0; x < bw; x += 4, v_x = vaddq_f32(v_x, v_4))
+                {
+                    float32x4_t v_W = vmlaq_f32(v_W0, v_m2, v_x);
+                    uint32x4_t v_nonzero = vmvnq_u32(vceqq_f32(v_W, v_zero));
+                    float32x4_t v_iW = vmulq_f32(internal::vrecpq_f32(v_W), v_scale);
+                    v_iW = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(v_iW), v_nonzero));
+
+                    int32x4_t v_X = internal::vroundq_s32_f32(vmulq_f32(vmlaq_f32(v_X0, v_m0, v_x), v_iW));
+                    int32x4_t v_Y = internal::vroundq_s32_f32(vmulq_f32(vmlaq_f32(v_Y0, v_m1, v_x), v_iW));
+                    int16x4x2_t v_xy;
+                    if (linear)
+                    {
+                        v_xy.val[0] = vqmovn_s32(vshrq_n_s32(v_X, internal::INTER_BITS));
+                        v_xy.val[1] = vqmovn_s32(vshrq_n_s32(v_Y, internal::INTER_BITS));
+                        int32x4_t v_a = vorrq_s32(vshlq_n_s32(vandq_s32(v_Y, v_mask), internal::INTER_BITS),
+                                                  vandq_s32(v_X, v_mask));
+                        vst1_u16(a + x, vmovn_u32(vreinterpretq_u32_s32(v_a)));
+                    }
+                    else
+                    {
+                        v_xy.val[0] = vqmovn_s32(v_X);
+                        v_xy.val[1] = vqmovn_s32(v_Y);
+                    }
+                    vst2_s16(map + x * 2, v_xy);
+                }
+            }
+
+            Size2D tile(bw, bh);
+            u8 * dst = internal::getRowPtr(dstBase, dstStride, by) + bx;
+            if (linear)
+                internal::remapLinearTile(ssize, tile, srcBase, srcStride,
+                                          xy, sizeof(xy) / block, alpha, sizeof(alpha) / block,
+                                          dst, dstStride, borderMode, borderValue);
+            else
+                internal::remapNearestNeighborTile(ssize, tile, srcBase, srcStride, xy, sizeof(xy) / block,
+                                                   dst, dstStride, borderMode, borderValue);
+        }
+    }
+}
+
+} // namespace
+
+#endif
+
+void warpPerspectiveNearestNeighbor(const Size2D &ssize, const Size2D &dsize,
+                                    const u8 * srcBase, ptrdiff_t srcStride,
+                                    const f32 * m,
+                                    u8 * dstBase, ptrdiff_t dstStride,
+                                    BORDER_MODE borderMode, u8 borderValue)
+{
+    internal::assertSupportedConfiguration(isWarpPerspectiveNearestNeighborSupported(ssize));
+#ifdef CAROTENE_NEON
+    warpPerspective<false>(ssize, dsize, srcBase, srcStride, m, dstBase, dstStride, borderMode, borderValue);
+#else
+    (void)dsize;
+    (void)srcBase;
+    (void)srcStride;
+    (void)m;
+    (void)dstBase;
+    (void)dstStride;
+    (void)borderMode;
+    (void)borderValue;
+#endif
+}
+
+void warpPerspectiveLinear(const Size2D &ssize, const Size2D &dsize,
+                           const u8 * srcBase, ptrdiff_t srcStride,
+                           const f32 * m,
+                           u8 * dstBase, ptrdiff_t dstStride,
+                           BORDER_MODE borderMode, u8 borderValue)
+{
+    internal::assertSupportedConfiguration(isWarpPerspectiveLinearSupported(ssize));
+#ifdef CAROTENE_NEON
+    warpPerspective<true>(ssize, dsize, srcBase, srcStride, m, dstBase, dstStride, borderMode, borderValue);
+#else
+    (void)dsize;
+    (void)srcBase;
+    (void)srcStride;
+    (void)m;
+    (void)dstBase;
+    (void)dstStride;
+    (void)borderMode;
+    (void)borderValue;
+#endif
+}
+
+} // namespace CAROTENE_NS
@@ -0,0 +1,238 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#ifndef CAROTENE_SRC_YUV2RGB_HPP
+#define CAROTENE_SRC_YUV2RGB_HPP
+
+#include "common.hpp"
+
+#ifdef CAROTENE_NEON
+
+namespace CAROTENE_NS { namespace internal {
+
+/*
+    Fixed point YUV to RGB coefficients with YUV2RGB_SHIFT fraction bits:
+        R = Y' + RV * V'
+        G = Y' + GU * U' + GV * V'
+        B = Y' + BU * U'
+    where Y' = Y * max(y - YOFFSET, 0) and U', V' are the chroma samples minus 128.
+    BT.601 limited range uses the constants of OpenCV's cvtColor so that the HAL stays bit
+    exact, the other sets follow from Kr, Kb and the range scale (255/219 luma, 255/224 chroma).
+*/
+enum { YUV2RGB_SHIFT = 20 };
+
+template <COLOR_SPACE space, YUV_RANGE range> struct YUV2RGBCoeffs;
+
+template <> struct YUV2RGBCoeffs<COLOR_SPACE_BT601, YUV_RANGE_LIMITED>
+{
+    enum { Y = 1220542, RV = 1673527, GU = -409993, GV = -852492, BU = 2116026, YOFFSET = 16 };
+};
+
+template <> struct YUV2RGBCoeffs<COLOR_SPACE_BT601, YUV_RANGE_FULL>
+{
+    enum { Y = 1048576, RV = 1470104, GU = -360853, GV = -748826, BU = 1858077, YOFFSET = 0 };
+};
+
+template <> struct YUV2RGBCoeffs<COLOR_SPACE_BT709, YUV_RANGE_LIMITED>
+{
+    enum { Y = 1220945, RV = 1879825, GU = -223607, GV = -558796, BU = 2215014, YOFFSET = 16 };
+};
+
+template <> struct YUV2RGBCoeffs<COLOR_SPACE_BT709, YUV_RANGE_FULL>
+{
+    enum { Y = 1048576, RV = 1651297, GU = -196424, GV = -490864, BU = 1945738, YOFFSET = 0 };
+};
+
+template <> struct YUV2RGBCoeffs<COLOR_SPACE_BT2020, YUV_RANGE_LIMITED>
+{
+    enum { Y = 1220945, RV = 1760217, GU = -196426, GV = -682019, BU = 2245811, YOFFSET = 16 };
+};
+
+template <> struct YUV2RGBCoeffs<COLOR_SPACE_BT2020, YUV_RANGE_FULL>
+{
+    enum { Y = 1048576, RV = 1546230, GU = -172546, GV = -599107, BU = 1972791, YOFFSET = 0 };
+};
+
+// Picks the coefficient set at run time and calls k.run<C>(), so that every colorimetry
+// gets a kernel of its own with the constants folded in
+template <typename Kernel>
+inline void yuv2rgbDispatch(COLOR_SPACE space, YUV_RANGE range, const Kernel & k)
+{
+    bool limited = range == YUV_RANGE_LIMITED;
+    if (space == COLOR_SPACE_BT601)
+    {
+        if (limited)
+            k.template run<YUV2RGBCoeffs<COLOR_SPACE_BT601, YUV_RANGE_LIMITED> >();
+        else
+            k.template run<YUV2RGBCoeffs<COLOR_SPACE_BT601, YUV_RANGE_FULL> >();
+    }
+    else if (space == COLOR_SPACE_BT709)
+    {
+        if (limited)
+            k.template run<YUV2RGBCoeffs<COLOR_SPACE_BT709, YUV_RANGE_LIMITED> >();
+        else
+            k.template run<YUV2RGBCoeffs<COLOR_SPACE_BT709, YUV_RANGE_FULL> >();
+    }
+    else
+    {
+        if (limited)
+            k.template run<YUV2RGBCoeffs<COLOR_SPACE_BT2020, YUV_RANGE_LIMITED> >();
+        else
+            k.template run<YUV2RGBCoeffs<COLOR_SPACE_BT2020, YUV_RANGE_FULL> >();
+    }
+}
+
+template <typename C>
+inline void yuv2rgbPixel(s32 y, s32 u, s32 v, u8 & r, u8 & g, u8 & b)
+{
+    s32 yy = std::max(y - (s32)C::YOFFSET, 0) * C::Y + (1 << (YUV2RGB_SHIFT - 1));
+    u -= 128;
+    v -= 128;
+    r = saturate_cast<u8>((yy + C::RV * v) >> YUV2RGB_SHIFT);
+    g = saturate_cast<u8>((yy + C::GU * u + C::GV * v) >> YUV2RGB_SHIFT);
+    b = saturate_cast<u8>((yy + C::BU * u) >> YUV2RGB_SHIFT);
+}
+
+// Chroma terms of 8 chroma pairs, each shared by two horizontally neighbouring pixels
+struct YUV2RGBChroma
+{
+    int32x4_t r[2], g[2], b[2];
+};
+
+template <typename C>
+inline YUV2RGBChroma yuv2rgbChroma(uint8x8_t u8, uint8x8_t v8)
+{
+    const int32x4_t vround = vdupq_n_s32(1 << (YUV2RGB_SHIFT - 1));
+    int16x8_t u16 = vreinterpretq_s16_u16(vsubl_u8(u8, vdup_n_u8(128)));
+    int16x8_t v16 = vreinterpretq_s16_u16(vsubl_u8(v8, vdup_n_u8(128)));
+
+    YUV2RGBChroma c;
+    int32x4_t u = vmovl_s16(vget_low_s16(u16)), v = vmovl_s16(vget_low_s16(v16));
+    c.r[0] = vmlaq_n_s32(vround, v, C::RV);
+    c.g[0] = vmlaq_n_s32(vmlaq_n_s32(vround, u, C::GU), v, C::GV);
+    c.b[0] = vmlaq_n_s32(vround, u, C::BU);
+    u = vmovl_s16(vget_high_s16(u16));
+    v = vmovl_s16(vget_high_s16(v16));
+    c.r[1] = vmlaq_n_s32(vround, v, C::RV);
+    c.g[1] = vmlaq_n_s32(vmlaq_n_s32(vround, u, C::GU), v, C::GV);
+    c.b[1] = vmlaq_n_s32(vround, u, C::BU);
+    return c;
+}
+
+template <typename C>
+inline void yuv2rgbLuma(uint8x8_t y, int32x4_t & lo, int32x4_t & hi)
+{
+    uint16x8_t y16 = vmovl_u8(C::YOFFSET != 0 ? vqsub_u8(y, vdup_n_u8(C::YOFFSET)) : y);
+    lo = vmulq_n_s32(vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(y16))), C::Y);
+    hi = vmulq_n_s32(vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(y16))), C::Y);
+}
+
+// (Y' + chroma term) >> YUV2RGB_SHIFT saturated to u8. The sums stay below 2^30 in
+// magnitude, so the narrowing >> 16 is exact and the saturating shift does the rest
+inline uint8x8_t yuv2rgbNarrow(int32x4_t ylo, int32x4_t yhi, int32x4_t clo, int32x4_t chi)
+{
+    int16x8_t v = vcombine_s16(vshrn_n_s32(vaddq_s32(ylo, clo), 16), vshrn_n_s32(vaddq_s32(yhi, chi), 16));
+    return vqshrun_n_s16(v, YUV2RGB_SHIFT - 16);
+}
+
+// 8 even and 8 odd pixels of a row sharing the chroma pairs of `c`, as 16 consecutive pixels
+template <typename C>
+inline void yuv2rgbPixels(const YUV2RGBChroma & c, uint8x8_t yEven, uint8x8_t yOdd,
+                          uint8x16_t & r, uint8x16_t & g, uint8x16_t & b)
+{
+    int32x4_t e0, e1, o0, o1;
+    yuv2rgbLuma<C>(yEven, e0, e1);
+    yuv2rgbLuma<C>(yOdd, o0, o1);
+
+    uint8x8x2_t v = vzip_u8(yuv2rgbNarrow(e0, e1, c.r[0], c.r[1]), yuv2rgbNarrow(o0, o1, c.r[0], c.r[1]));
+    r = vcombine_u8(v.val[0], v.val[1]);
+    v = vzip_u8(yuv2rgbNarrow(e0, e1, c.g[0], c.g[1]), yuv2rgbNarrow(o0, o1, c.g[0], c.g[1]));
+    g = vcombine_u8(v.val[0], v.val[1]);
+    v = vzip_u8(yuv2rgbNarrow(e0, e1, c.b[0], c.b[1]), yuv2rgbNarrow(o0, o1, c.b[0], c.b[1]));
+    b = vcombine_u8(v.val[0], v.val[1]);
+}
+
+// Stores pixels as RGB / BGR (dcn 3) or RGBX / BGRX (dcn 4), blue at channel bIdx
+template <int dcn, int bIdx> struct YUV2RGBStore;
+
+template <int bIdx> struct YUV2RGBStore<3, bIdx>
+{
+    static inline void store16(u8 * dst, uint8x16_t r, uint8x16_t g, uint8x16_t b)
+    {
+        uint8x16x3_t v;
+        v.val[2 - bIdx] = r;
+        v.val[1] = g;
+        v.val[bIdx] = b;
+        vst3q_u8(dst, v);
+    }
+
+    static inline void store1(u8 * dst, u8 r, u8 g, u8 b)
+    {
+        dst[2 - bIdx] = r;
+        dst[1] = g;
+        dst[bIdx] = b;
+    }
+};
+
+template <int bIdx> struct YUV2RGBStore<4, bIdx>
+{
+    static inline void store16(u8 * dst, uint8x16_t r, uint8x16_t g, uint8x16_t b)
+    {
+        uint8x16x4_t v;
+        v.val[2 - bIdx] = r;
+        v.val[1] = g;
+        v.val[bIdx] = b;
+        v.val[3] = vdupq_n_u8(255);
+        vst4q_u8(dst, v);
+    }
+
+    static inline void store1(u8 * dst, u8 r, u8 g, u8 b)
+    {
+        dst[2 - bIdx] = r;
+        dst[1] = g;
+        dst[bIdx] = b;
+        dst[3] = 255;
+    }
+};
+
+}}
+
+#endif
+
+#endif
@@ -0,0 +1,326 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "common.hpp"
+#include "yuv2rgb.hpp"
+
+namespace CAROTENE_NS {
+
+#ifdef CAROTENE_NEON
+
+namespace {
+
+/*
+    Destination of one output row. The decoder hands it 16 or 1 pixels at column x, the
+    interleaved store writes them as RGB/RGBX/BGR/BGRX u8 and the planar one as normalized
+    f32 planes.
+*/
+template <int dcn, int bIdx>
+struct InterleavedRow
+{
+    u8 * dst;
+
+    explicit InterleavedRow(u8 * dst_) : dst(dst_) {}
+
+    inline void store16(size_t x, uint8x16_t r, uint8x16_t g, uint8x16_t b) const
+    {
+        internal::YUV2RGBStore<dcn, bIdx>::store16(dst + dcn * x, r, g, b);
+    }
+
+    inline void store1(size_t x, u8 r, u8 g, u8 b) const
+    {
+        internal::YUV2RGBStore<dcn, bIdx>::store1(dst + dcn * x, r, g, b);
+    }
+};
+
+// (v - mean) / std of every channel, as v * scale + bias
+struct Normalization
+{
+    f32 scale[3], bias[3];
+
+    Normalization(const f32 * mean, const f32 * stdDev)
+    {
+        for (size_t c = 0; c < 3; ++c)
+        {
+            scale[c] = 1.0f / stdDev[c];
+            bias[c] = -mean[c] * scale[c];
+        }
+    }
+};
+
+struct PlanarF32Row
+{
+    f32 * dst[3];
+    const Normalization & n;
+
+    PlanarF32Row(f32 * dst0, f32 * dst1, f32 * dst2, const Normalization & n_) : n(n_)
+    {
+        dst[0] = dst0;
+        dst[1] = dst1;
+        dst[2] = dst2;
+    }
+
+    static inline void storePlane(f32 * dst, uint8x16_t v, f32 scale, f32 bias)
+    {
+        const float32x4_t v_scale = vdupq_n_f32(scale), v_bias = vdupq_n_f32(bias);
+        uint16x8_t lo = vmovl_u8(vget_low_u8(v)), hi = vmovl_u8(vget_high_u8(v));
+        vst1q_f32(dst,      vmlaq_f32(v_bias, vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), v_scale));
+        vst1q_f32(dst + 4,  vmlaq_f32(v_bias, vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))), v_scale));
+        vst1q_f32(dst + 8,  vmlaq_f32(v_bias, vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), v_scale));
+        vst1q_f32(dst + 12, vmlaq_f32(v_bias, vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))), v_scale));
+    }
+
+    inline void store16(size_t x, uint8x16_t r, uint8x16_t g, uint8x16_t b) const
+    {
+        storePlane(dst[0] + x, r, n.scale[0], n.bias[0]);
+        storePlane(dst[1] + x, g, n.scale[1], n.bias[1]);
+        storePlane(dst[2] + x, b, n.scale[2], n.bias[2]);
+    }
+
+    inline void store1(size_t x, u8 r, u8 g, u8 b) const
+    {
+        dst[0][x] = r * n.scale[0] + n.bias[0];
+        dst[1][x] = g * n.scale[1] + n.bias[1];
+        dst[2][x] = b * n.scale[2] + n.bias[2];
+    }
+};
+
+// 16 pixels of two rows sharing 8 chroma pairs, vIdx is the position of V in a pair
+template <typename C, int vIdx, typename Row>
+inline void yuv420Block(const u8 * y1, const u8 * y2, const u8 * uv, const Row & row1, const Row & row2, size_t x)
+{
+    uint8x8x2_t c8 = vld2_u8(uv + x);
+    internal::YUV2RGBChroma c = internal::yuv2rgbChroma<C>(c8.val[1 - vIdx], c8.val[vIdx]);
+
+    uint8x16_t r, g, b;
+    uint8x8x2_t y = vld2_u8(y1 + x);
+    internal::yuv2rgbPixels<C>(c, y.val[0], y.val[1], r, g, b);
+    row1.store16(x, r, g, b);
+
+    y = vld2_u8(y2 + x);
+    internal::yuv2rgbPixels<C>(c, y.val[0], y.val[1], r, g, b);
+    row2.store16(x, r, g, b);
+}
+
+template <typename C, int vIdx, typename Row>
+void yuv420Rows(const u8 * y1, const u8 * y2, const u8 * uv, const Row & row1, const Row & row2, size_t width)
+{
+    size_t pairs = width & ~(size_t)1, x = 0;
+    if (pairs >= 16)
+    {
+        for (; x + 16 <= pairs; x += 16)
+        {
+            internal::prefetch(uv + x);
+            internal::prefetch(y1 + x);
+            internal::prefetch(y2 + x);
+            yuv420Block<C, vIdx>(y1, y2, uv, row1, row2, x);
+        }
+        // the last partial block overlaps the previous one, see yuv422Row
+        if (x < pairs)
+        {
+            yuv420Block<C, vIdx>(y1, y2, uv, row1, row2, pairs - 16);
+            x = pairs;
+        }
+    }
+
+    for (; x < width; ++x)
+    {
+        const u8 * c = uv + (x & ~(size_t)1);
+        u8 r, g, b;
+        internal::yuv2rgbPixel<C>(y1[x], c[1 - vIdx], c[vIdx], r, g, b);
+        row1.store1(x, r, g, b);
+        internal::yuv2rgbPixel<C>(y2[x], c[1 - vIdx], c[vIdx], r, g, b);
+        row2.store1(x, r, g, b);
+    }
+}
+
+template <int vIdx, int dcn, int bIdx>
+struct YUV420Kernel
+{
+    const Size2D & size;
+    const u8 * yBase;
+    ptrdiff_t yStride;
+    const u8 * uvBase;
+    ptrdiff_t uvStride;
+    u8 * dstBase;
+    ptrdiff_t dstStride;
+
+    YUV420Kernel(const Size2D & size_, const u8 * yBase_, ptrdiff_t yStride_,
+                 const u8 * uvBase_, ptrdiff_t uvStride_, u8 * dstBase_, ptrdiff_t dstStride_) :
+        size(size_), yBase(yBase_), yStride(yStride_), uvBase(uvBase_), uvStride(uvStride_),
+        dstBase(dstBase_), dstStride(dstStride_)
+    {
+    }
+
+    template <typename C>
+    void run() const
+    {
+        typedef InterleavedRow<dcn, bIdx> Row;
+        // the last row of an odd height is paired with itself
+        for (size_t i = 0; i < size.height; i += 2)
+        {
+            size_t i2 = std::min(i + 1, size.height - 1);
+            yuv420Rows<C, vIdx>(internal::getRowPtr(yBase, yStride, i),
+                                internal::getRowPtr(yBase, yStride, i2),
+                                internal::getRowPtr(uvBase, uvStride, i >> 1),
+                                Row(internal::getRowPtr(dstBase, dstStride, i)),
+                                Row(internal::getRowPtr(dstBase, dstStride, i2)),
+                                size.width);
+        }
+    }
+};
+
+template <int vIdx>
+struct YUV420PlanarF32Kernel
+{
+    const Size2D & size;
+    const u8 * yBase;
+    ptrdiff_t yStride;
+    const u8 * uvBase;
+    ptrdiff_t uvStride;
+    f32 * dstBase[3];
+    ptrdiff_t dstStride[3];
+    Normalization n;
+
+    YUV420PlanarF32Kernel(const Size2D & size_, const u8 * yBase_, ptrdiff_t yStride_,
+                          const u8 * uvBase_, ptrdiff_t uvStride_,
+                          f32 * dst0Base, ptrdiff_t dst0Stride,
+                          f32 * dst1Base, ptrdiff_t dst1Stride,
+                          f32 * dst2Base, ptrdiff_t dst2Stride,
+                          const f32 * mean, const f32 * stdDev) :
+        size(size_), yBase(yBase_), yStride(yStride_), uvBase(uvBase_), uvStride(uvStride_),
+        n(mean, stdDev)
+    {
+        dstBase[0] = dst0Base;
+        dstBase[1] = dst1Base;
+        dstBase[2] = dst2Base;
+        dstStride[0] = dst0Stride;
+        dstStride[1] = dst1Stride;
+        dstStride[2] = dst2Stride;
+    }
+
+    PlanarF32Row row(size_t i) const
+    {
+        return PlanarF32Row(internal::getRowPtr(dstBase[0], dstStride[0], i),
+                            internal::getRowPtr(dstBase[1], dstStride[1], i),
+                            internal::getRowPtr(dstBase[2], dstStride[2], i), n);
+    }
+
+    template <typename C>
+    void run() const
+    {
+        for (size_t i = 0; i < size.height; i += 2)
+        {
+            size_t i2 = std::min(i + 1, size.height - 1);
+            yuv420Rows<C, vIdx>(internal::getRowPtr(yBase, yStride, i),
+                                internal::getRowPtr(yBase, yStride, i2),
+                                internal::getRowPtr(uvBase, uvStride, i >> 1),
+                                row(i), row(i2), size.width);
+        }
+    }
+};
+
+} // namespace
+
+#define YUV420_FUNC(name, vIdx, dcn, bIdx)                                                \
+    void name(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,              \
+              const u8 *  yBase, ptrdiff_t  yStride,                                     \
+              const u8 * uvBase, ptrdiff_t uvStride,                                     \
+              u8 * dstBase, ptrdiff_t dstStride)                                         \
+    {                                                                                    \
+        internal::assertSupportedConfiguration();                                        \
+        internal::yuv2rgbDispatch(color_space, range,                                    \
+            YUV420Kernel<vIdx, dcn, bIdx>(size, yBase, yStride, uvBase, uvStride,        \
+                                          dstBase, dstStride));                          \
+    }
+
+#define YUV420_PLANAR_FUNC(name, vIdx)                                                    \
+    void name(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,              \
+              const u8 *  yBase, ptrdiff_t  yStride,                                     \
+              const u8 * uvBase, ptrdiff_t uvStride,                                     \
+              f32 * dst0Base, ptrdiff_t dst0Stride,                                      \
+              f32 * dst1Base, ptrdiff_t dst1Stride,                                      \
+              f32 * dst2Base, ptrdiff_t dst2Stride,                                      \
+              const f32 * mean, const f32 * stdDev)                                      \
+    {                                                                                    \
+        internal::assertSupportedConfiguration();                                        \
+        internal::yuv2rgbDispatch(color_space, range,                                    \
+            YUV420PlanarF32Kernel<vIdx>(size, yBase, yStride, uvBase, uvStride,          \
+                                        dst0Base, dst0Stride, dst1Base, dst1Stride,      \
+                                        dst2Base, dst2Stride, mean, stdDev));            \
+    }
+
+#else
+
+#define YUV420_FUNC(name, vIdx, dcn, bIdx)                                                \
+    void name(const Size2D &, COLOR_SPACE, YUV_RANGE,                                    \
+              const u8 *, ptrdiff_t,                                                     \
+              const u8 *, ptrdiff_t,                                                     \
+              u8 *, ptrdiff_t)                                                           \
+    {                                                                                    \
+        internal::assertSupportedConfiguration();                                        \
+    }
+
+#define YUV420_PLANAR_FUNC(name, vIdx)                                                    \
+    void name(const Size2D &, COLOR_SPACE, YUV_RANGE,                                    \
+              const u8 *, ptrdiff_t,                                                     \
+              const u8 *, ptrdiff_t,                                                     \
+              f32 *, ptrdiff_t,                                                          \
+              f32 *, ptrdiff_t,                                                          \
+              f32 *, ptrdiff_t,                                                          \
+              const f32 *, const f32 *)                                                  \
+    {                                                                                    \
+        internal::assertSupportedConfiguration();                                        \
+    }
+
+#endif
+
+YUV420_FUNC(yuv420sp2rgb, 0, 3, 2)
+YUV420_FUNC(yuv420sp2rgbx, 0, 4, 2)
+YUV420_FUNC(yuv420sp2bgr, 0, 3, 0)
+YUV420_FUNC(yuv420sp2bgrx, 0, 4, 0)
+YUV420_FUNC(yuv420i2rgb, 1, 3, 2)
+YUV420_FUNC(yuv420i2rgbx, 1, 4, 2)
+YUV420_FUNC(yuv420i2bgr, 1, 3, 0)
+YUV420_FUNC(yuv420i2bgrx, 1, 4, 0)
+
+YUV420_PLANAR_FUNC(yuv420sp2rgbPlanarF32, 0)
+YUV420_PLANAR_FUNC(yuv420i2rgbPlanarF32, 1)
+
+} // namespace CAROTENE_NS
@@ -0,0 +1,164 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "common.hpp"
+#include "yuv2rgb.hpp"
+
+namespace CAROTENE_NS {
+
+#ifdef CAROTENE_NEON
+
+namespace {
+
+// Byte offsets of the samples inside a 4 byte macropixel
+template <int y0, int u, int v>
+struct YUV422Layout
+{
+    enum { Y0 = y0, Y1 = y0 + 2, U = u, V = v };
+};
+
+typedef YUV422Layout<0, 1, 3> LayoutYUYV;
+typedef YUV422Layout<1, 0, 2> LayoutUYVY;
+
+// 16 pixels out of 8 macropixels, vld4 splits them into Y0, Y1, U and V lanes
+template <typename C, typename L, int dcn, int bIdx>
+inline void yuv422Block(const u8 * src, u8 * dst)
+{
+    uint8x8x4_t mp = vld4_u8(src);
+    internal::YUV2RGBChroma c = internal::yuv2rgbChroma<C>(mp.val[L::U], mp.val[L::V]);
+    uint8x16_t r, g, b;
+    internal::yuv2rgbPixels<C>(c, mp.val[L::Y0], mp.val[L::Y1], r, g, b);
+    internal::YUV2RGBStore<dcn, bIdx>::store16(dst, r, g, b);
+}
+
+template <typename C, typename L, int dcn, int bIdx>
+void yuv422Row(const u8 * src, u8 * dst, size_t width)
+{
+    size_t pairs = width & ~(size_t)1, x = 0;
+    if (pairs >= 16)
+    {
+        for (; x + 16 <= pairs; x += 16)
+        {
+            internal::prefetch(src + 2 * x);
+            yuv422Block<C, L, dcn, bIdx>(src + 2 * x, dst + dcn * x);
+        }
+        // the last partial block overlaps the previous one and rewrites the same values,
+        // which is cheaper than finishing the row pixel by pixel
+        if (x < pairs)
+        {
+            yuv422Block<C, L, dcn, bIdx>(src + 2 * (pairs - 16), dst + dcn * (pairs - 16));
+            x = pairs;
+        }
+    }
+
+    for (; x < width; ++x)
+    {
+        const u8 * mp = src + 2 * (x & ~(size_t)1);
+        u8 r, g, b;
+        internal::yuv2rgbPixel<C>(mp[(x & 1) ? L::Y1 : L::Y0], mp[L::U], mp[L::V], r, g, b);
+        internal::YUV2RGBStore<dcn, bIdx>::store1(dst + dcn * x, r, g, b);
+    }
+}
+
+template <typename C, typename L, int dcn, int bIdx>
+void yuv422ToRGB(const Size2D & size,
+                 const u8 * srcBase, ptrdiff_t srcStride,
+                 u8 * dstBase, ptrdiff_t dstStride)
+{
+    for (size_t i = 0; i < size.height; ++i)
+        yuv422Row<C, L, dcn, bIdx>(internal::getRowPtr(srcBase, srcStride, i),
+                                   internal::getRowPtr(dstBase, dstStride, i), size.width);
+}
+
+template <typename L, int dcn, int bIdx>
+struct YUV422Kernel
+{
+    const Size2D & size;
+    const u8 * srcBase;
+    ptrdiff_t srcStride;
+    u8 * dstBase;
+    ptrdiff_t dstStride;
+
+    YUV422Kernel(const Size2D & size_, const u8 * srcBase_, ptrdiff_t srcStride_,
+                 u8 * dstBase_, ptrdiff_t dstStride_) :
+        size(size_), srcBase(srcBase_), srcStride(srcStride_), dstBase(dstBase_), dstStride(dstStride_)
+    {
+    }
+
+    template <typename C>
+    void run() const
+    {
+        yuv422ToRGB<C, L, dcn, bIdx>(size, srcBase, srcStride, dstBase, dstStride);
+    }
+};
+
+} // namespace
+
+#define YUV422_FUNC(name, layout, dcn, bIdx)                                              \
+    void name(const Size2D &size, COLOR_SPACE color_space, YUV_RANGE range,              \
+              const u8 * srcBase, ptrdiff_t srcStride,                                   \
+              u8 * dstBase, ptrdiff_t dstStride)                                         \
+    {                                                                                    \
+        internal::assertSupportedConfiguration();                                        \
+        internal::yuv2rgbDispatch(color_space, range,                                    \
+            YUV422Kernel<layout, dcn, bIdx>(size, srcBase, srcStride, dstBase, dstStride)); \
+    }
+
+#else
+
+#define YUV422_FUNC(name, layout, dcn, bIdx)                                              \
+    void name(const Size2D &, COLOR_SPACE, YUV_RANGE,                                    \
+              const u8 *, ptrdiff_t,                                                     \
+              u8 *, ptrdiff_t)                                                           \
+    {                                                                                    \
+        internal::assertSupportedConfiguration();                                        \
+    }
+
+#endif
+
+YUV422_FUNC(yuyv2rgb, LayoutYUYV, 3, 2)
+YUV422_FUNC(yuyv2rgbx, LayoutYUYV, 4, 2)
+YUV422_FUNC(yuyv2bgr, LayoutYUYV, 3, 0)
+YUV422_FUNC(yuyv2bgrx, LayoutYUYV, 4, 0)
+YUV422_FUNC(uyvy2rgb, LayoutUYVY, 3, 2)
+YUV422_FUNC(uyvy2rgbx, LayoutUYVY, 4, 2)
+YUV422_FUNC(uyvy2bgr, LayoutUYVY, 3, 0)
+YUV422_FUNC(uyvy2bgrx, LayoutUYVY, 4, 0)
+
+} // namespace CAROTENE_NS
@@ -0,0 +1,73 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <cstring>
+
+using namespace CAROTENE_NS;
+
+int main(int argc, char ** argv)
+{
+    const char * filter = argc > 1 ? argv[1] : "";
+
+    if (!isSupportedConfiguration())
+    {
+        std::cout << "carotene is built without NEON, nothing to test" << std::endl;
+        return 0;
+    }
+
+    size_t run = 0, failed = 0;
+    std::vector<std::pair<std::string, test::TestFunc> > & tests = test::TestRegistry::tests();
+    for (size_t i = 0; i < tests.size(); ++i)
+    {
+        if (std::strstr(tests[i].first.c_str(), filter) == NULL)
+            continue;
+
+        size_t before = test::TestRegistry::failures();
+        tests[i].second();
+        bool ok = test::TestRegistry::failures() == before;
+        std::cout << (ok ? "[       OK ] " : "[  FAILED  ] ") << tests[i].first << std::endl;
+        ++run;
+        failed += ok ? 0 : 1;
+    }
+
+    std::cout << run - failed << "/" << run << " tests passed" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
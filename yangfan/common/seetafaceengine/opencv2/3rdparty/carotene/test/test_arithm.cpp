@@ -0,0 +1,324 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <cmath>
+#include <limits>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+/*
+ * Element-wise arithmetic and logic, flip, minMaxLoc and inRange against scalar references.
+ * Sizes cover the 32 byte vector body, the 8 byte tail, the scalar tail and single pixels.
+ */
+
+namespace {
+
+const size_t arithmSizes[][2] = { { 1, 1 }, { 7, 3 }, { 8, 2 }, { 33, 5 }, { 61, 4 }, { 640, 7 } };
+const size_t arithmSizeCount = sizeof(arithmSizes) / sizeof(arithmSizes[0]);
+
+template <typename T>
+T refClamp(s64 v)
+{
+    return (T)std::min<s64>(std::max<s64>(v, (s64)std::numeric_limits<T>::min()), (s64)std::numeric_limits<T>::max());
+}
+
+// Two's complement wrap-around, as the WRAP policy does
+template <typename T>
+T refWrap(s64 v)
+{
+    return (T)(u64)v;
+}
+
+template <typename T>
+void randomFull(Image<T> & img, Rng & rng)
+{
+    img.randomize(rng, (f64)std::numeric_limits<T>::min(), (f64)std::numeric_limits<T>::max());
+}
+
+template <typename S0, typename S1, typename D>
+void checkAdd(Rng & rng)
+{
+    const CONVERT_POLICY policies[] = { CONVERT_POLICY_WRAP, CONVERT_POLICY_SATURATE };
+    for (size_t si = 0; si < arithmSizeCount; ++si)
+        for (size_t pi = 0; pi < 2; ++pi)
+        {
+            size_t w = arithmSizes[si][0], h = arithmSizes[si][1];
+            Image<S0> a(w, h);
+            Image<S1> b(w, h);
+            Image<D> dst(w, h), ref(w, h);
+            randomFull(a, rng);
+            randomFull(b, rng);
+
+            add(a.size(), a.row(0), a.stride, b.row(0), b.stride, dst.row(0), dst.stride, policies[pi]);
+            for (size_t y = 0; y < h; ++y)
+                for (size_t x = 0; x < w; ++x)
+                {
+                    s64 r = (s64)a.at(x, y) + (s64)b.at(x, y);
+                    ref.at(x, y) = policies[pi] == CONVERT_POLICY_SATURATE ? refClamp<D>(r) : refWrap<D>(r);
+                }
+            CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+        }
+}
+
+template <typename T>
+void checkAbsDiff(Rng & rng)
+{
+    for (size_t si = 0; si < arithmSizeCount; ++si)
+    {
+        size_t w = arithmSizes[si][0], h = arithmSizes[si][1];
+        Image<T> a(w, h), b(w, h), dst(w, h), ref(w, h);
+        randomFull(a, rng);
+        randomFull(b, rng);
+
+        absDiff(a.size(), a.row(0), a.stride, b.row(0), b.stride, dst.row(0), dst.stride);
+        for (size_t y = 0; y < h; ++y)
+            for (size_t x = 0; x < w; ++x)
+            {
+                s64 d = (s64)a.at(x, y) - (s64)b.at(x, y);
+                ref.at(x, y) = refClamp<T>(d < 0 ? -d : d);
+            }
+        CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+    }
+}
+
+template <typename T>
+void checkInRange(Rng & rng)
+{
+    for (size_t si = 0; si < arithmSizeCount; ++si)
+    {
+        size_t w = arithmSizes[si][0], h = arithmSizes[si][1];
+        Image<T> src(w, h), lo(w, h), hi(w, h);
+        Image<u8> dst(w, h), ref(w, h);
+        randomFull(src, rng);
+        randomFull(lo, rng);
+        randomFull(hi, rng);
+        // make a third of the pixels hit a bound exactly
+        for (size_t i = 0; i < src.data.size(); ++i)
+        {
+            u32 r = rng.next() % 3;
+            if (r == 0)
+                src.data[i] = lo.data[i];
+            else if (r == 1)
+                src.data[i] = hi.data[i];
+        }
+
+        inRange(src.size(), src.row(0), src.stride, lo.row(0), lo.stride, hi.row(0), hi.stride,
+                dst.row(0), dst.stride);
+        for (size_t y = 0; y < h; ++y)
+            for (size_t x = 0; x < w; ++x)
+                ref.at(x, y) = lo.at(x, y) <= src.at(x, y) && src.at(x, y) <= hi.at(x, y) ? 255 : 0;
+        CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+    }
+}
+
+// First occurrence in row-major order wins ties, as OpenCV's minMaxLoc does
+template <typename T>
+void checkMinMaxLoc(Rng & rng, f64 lo, f64 hi)
+{
+    for (size_t si = 0; si < arithmSizeCount; ++si)
+    {
+        size_t w = arithmSizes[si][0], h = arithmSizes[si][1];
+        Image<T> src(w, h);
+        src.randomize(rng, lo, hi);
+
+        T minVal = 0, maxVal = 0;
+        size_t minCol = w, minRow = h, maxCol = w, maxRow = h;
+        minMaxLoc(src.size(), src.row(0), src.stride, minVal, minCol, minRow, maxVal, maxCol, maxRow);
+
+        size_t refMinCol = 0, refMinRow = 0, refMaxCol = 0, refMaxRow = 0;
+        for (size_t y = 0; y < h; ++y)
+            for (size_t x = 0; x < w; ++x)
+            {
+                if (src.at(x, y) < src.at(refMinCol, refMinRow))
+                    refMinCol = x, refMinRow = y;
+                if (src.at(x, y) > src.at(refMaxCol, refMaxRow))
+                    refMaxCol = x, refMaxRow = y;
+            }
+        CAROTENE_CHECK(minVal == src.at(refMinCol, refMinRow) && maxVal == src.at(refMaxCol, refMaxRow));
+        CAROTENE_CHECK(minCol == refMinCol && minRow == refMinRow);
+        CAROTENE_CHECK(maxCol == refMaxCol && maxRow == refMaxRow);
+    }
+}
+
+} // namespace
+
+CAROTENE_TEST(add)
+{
+    Rng rng(101);
+    checkAdd<u8, u8, u8>(rng);
+    checkAdd<u8, u8, s16>(rng);
+    checkAdd<u8, s16, s16>(rng);
+    checkAdd<s8, s8, s8>(rng);
+    checkAdd<s16, s16, s16>(rng);
+    checkAdd<u16, u16, u16>(rng);
+    checkAdd<s32, s32, s32>(rng);
+    checkAdd<u32, u32, u32>(rng);
+
+    for (size_t si = 0; si < arithmSizeCount; ++si)
+    {
+        size_t w = arithmSizes[si][0], h = arithmSizes[si][1];
+        Image<f32> a(w, h), b(w, h), dst(w, h), ref(w, h);
+        a.randomize(rng, -1000, 1000);
+        b.randomize(rng, -1000, 1000);
+        add(a.size(), a.row(0), a.stride, b.row(0), b.stride, dst.row(0), dst.stride);
+        for (size_t y = 0; y < h; ++y)
+            for (size_t x = 0; x < w; ++x)
+                ref.at(x, y) = a.at(x, y) + b.at(x, y);
+        CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+    }
+}
+
+CAROTENE_TEST(absDiff)
+{
+    Rng rng(102);
+    checkAbsDiff<u8>(rng);
+    checkAbsDiff<u16>(rng);
+    checkAbsDiff<s8>(rng);
+    checkAbsDiff<s16>(rng);
+    checkAbsDiff<s32>(rng);
+
+    for (size_t si = 0; si < arithmSizeCount; ++si)
+    {
+        size_t w = arithmSizes[si][0], h = arithmSizes[si][1];
+        Image<f32> a(w, h), b(w, h), dst(w, h), ref(w, h);
+        a.randomize(rng, -1000, 1000);
+        b.randomize(rng, -1000, 1000);
+        absDiff(a.size(), a.row(0), a.stride, b.row(0), b.stride, dst.row(0), dst.stride);
+        for (size_t y = 0; y < h; ++y)
+            for (size_t x = 0; x < w; ++x)
+                ref.at(x, y) = std::fabs(a.at(x, y) - b.at(x, y));
+        CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+    }
+}
+
+CAROTENE_TEST(bitwise)
+{
+    Rng rng(103);
+    for (size_t si = 0; si < arithmSizeCount; ++si)
+    {
+        size_t w = arithmSizes[si][0], h = arithmSizes[si][1];
+        Image<u8> a(w, h), b(w, h), dst(w, h), ref(w, h);
+        a.randomize(rng);
+        b.randomize(rng);
+
+        bitwiseNot(a.size(), a.row(0), a.stride, dst.row(0), dst.stride);
+        for (size_t y = 0; y < h; ++y)
+            for (size_t x = 0; x < w; ++x)
+                ref.at(x, y) = (u8)~a.at(x, y);
+        CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+
+        bitwiseAnd(a.size(), a.row(0), a.stride, b.row(0), b.stride, dst.row(0), dst.stride);
+        for (size_t y = 0; y < h; ++y)
+            for (size_t x = 0; x < w; ++x)
+                ref.at(x, y) = a.at(x, y) & b.at(x, y);
+        CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+
+        bitwiseOr(a.size(), a.row(0), a.stride, b.row(0), b.stride, dst.row(0), dst.stride);
+        for (size_t y = 0; y < h; ++y)
+            for (size_t x = 0; x < w; ++x)
+                ref.at(x, y) = a.at(x, y) | b.at(x, y);
+        CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+
+        bitwiseXor(a.size(), a.row(0), a.stride, b.row(0), b.stride, dst.row(0), dst.stride);
+        for (size_t y = 0; y < h; ++y)
+            for (size_t x = 0; x < w; ++x)
+                ref.at(x, y) = a.at(x, y) ^ b.at(x, y);
+        CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+    }
+}
+
+CAROTENE_TEST(flip)
+{
+    Rng rng(104);
+    const FLIP_MODE modes[] = { FLIP_HORIZONTAL_MODE, FLIP_VERTICAL_MODE, FLIP_BOTH_MODE };
+    for (u32 elemSize = 1; elemSize <= 4; ++elemSize)
+        for (size_t mi = 0; mi < 3; ++mi)
+            for (size_t si = 0; si < arithmSizeCount; ++si)
+            {
+                if (!isFlipSupported(modes[mi], elemSize))
+                    continue;
+                size_t w = arithmSizes[si][0], h = arithmSizes[si][1];
+                Image<u8> src(w, h, elemSize), dst(w, h, elemSize), ref(w, h, elemSize);
+                src.randomize(rng);
+
+                flip(src.size(), src.row(0), src.stride, dst.row(0), dst.stride, modes[mi], elemSize);
+                for (size_t y = 0; y < h; ++y)
+                    for (size_t x = 0; x < w; ++x)
+                    {
+                        size_t sx = modes[mi] & FLIP_HORIZONTAL_MODE ? w - 1 - x : x;
+                        size_t sy = modes[mi] & FLIP_VERTICAL_MODE ? h - 1 - y : y;
+                        for (size_t c = 0; c < elemSize; ++c)
+                            ref.at(x, y, c) = src.at(sx, sy, c);
+                    }
+                CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+            }
+}
+
+CAROTENE_TEST(minMaxLoc)
+{
+    Rng rng(105);
+    checkMinMaxLoc<u8>(rng, 0, 255);
+    checkMinMaxLoc<s8>(rng, -128, 127);
+    checkMinMaxLoc<u16>(rng, 0, 65535);
+    checkMinMaxLoc<s16>(rng, -32768, 32767);
+    checkMinMaxLoc<s32>(rng, -1e9, 1e9);
+    checkMinMaxLoc<f32>(rng, -1e3, 1e3);
+
+    // narrow ranges to make the extremes repeat across lanes and rows
+    checkMinMaxLoc<u8>(rng, 10, 13);
+    checkMinMaxLoc<s8>(rng, -2, 2);
+    checkMinMaxLoc<u16>(rng, 7, 9);
+    checkMinMaxLoc<s16>(rng, -3, 1);
+    checkMinMaxLoc<s32>(rng, -2, 2);
+    checkMinMaxLoc<f32>(rng, -2, 2);
+}
+
+CAROTENE_TEST(inRange)
+{
+    Rng rng(106);
+    checkInRange<u8>(rng);
+    checkInRange<s8>(rng);
+    checkInRange<u16>(rng);
+    checkInRange<s16>(rng);
+    checkInRange<s32>(rng);
+    checkInRange<f32>(rng);
+}
@@ -0,0 +1,89 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+/*
+ * RGB(X)/BGR(X) to gray against the Q14 fixed point weights of each color space
+ */
+
+namespace {
+
+typedef void (*GrayFunc)(const Size2D &, COLOR_SPACE, const u8 *, ptrdiff_t, u8 *, ptrdiff_t);
+
+const size_t colorSizes[][2] = { { 1, 1 }, { 7, 3 }, { 8, 2 }, { 16, 4 }, { 33, 5 }, { 320, 6 } };
+
+// { R, G, B } weights, Q14
+const s32 grayWeights[][3] = { { 4899, 9617, 1868 }, { 3483, 11718, 1183 }, { 4304, 11108, 972 } };
+
+void checkGray(Rng & rng, GrayFunc func, size_t cn, bool bgr)
+{
+    const COLOR_SPACE spaces[] = { COLOR_SPACE_BT601, COLOR_SPACE_BT709, COLOR_SPACE_BT2020 };
+    for (size_t ci = 0; ci < 3; ++ci)
+        for (size_t si = 0; si < sizeof(colorSizes) / sizeof(colorSizes[0]); ++si)
+        {
+            size_t w = colorSizes[si][0], h = colorSizes[si][1];
+            Image<u8> src(w, h, cn), dst(w, h), ref(w, h);
+            src.randomize(rng);
+
+            func(src.size(), spaces[ci], src.row(0), src.stride, dst.row(0), dst.stride);
+            for (size_t y = 0; y < h; ++y)
+                for (size_t x = 0; x < w; ++x)
+                {
+                    s32 r = src.at(x, y, bgr ? 2 : 0), g = src.at(x, y, 1), b = src.at(x, y, bgr ? 0 : 2);
+                    ref.at(x, y) = (u8)((r * grayWeights[ci][0] + g * grayWeights[ci][1] +
+                                         b * grayWeights[ci][2] + (1 << 13)) >> 14);
+                }
+            CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+        }
+}
+
+} // namespace
+
+CAROTENE_TEST(rgb2gray)
+{
+    Rng rng(301);
+    checkGray(rng, rgb2gray, 3, false);
+    checkGray(rng, rgbx2gray, 4, false);
+    checkGray(rng, bgr2gray, 3, true);
+    checkGray(rng, bgrx2gray, 4, true);
+}
@@ -0,0 +1,215 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#ifndef CAROTENE_TEST_COMMON_HPP
+#define CAROTENE_TEST_COMMON_HPP
+
+#include <carotene/functions.hpp>
+
+#include <climits>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+ * Minimal differential test harness: every kernel is compared against a straightforward
+ * scalar reference written in the test file. Carotene has no dependency to pull a test
+ * framework from, so the runner is self-contained.
+ */
+
+namespace CAROTENE_NS { namespace test {
+
+typedef void (*TestFunc)();
+
+struct TestRegistry
+{
+    static std::vector<std::pair<std::string, TestFunc> > & tests()
+    {
+        static std::vector<std::pair<std::string, TestFunc> > list;
+        return list;
+    }
+
+    static size_t & failures()
+    {
+        static size_t count = 0;
+        return count;
+    }
+};
+
+struct TestRegistrar
+{
+    TestRegistrar(const char * name, TestFunc func)
+    {
+        TestRegistry::tests().push_back(std::make_pair(std::string(name), func));
+    }
+};
+
+#define CAROTENE_TEST(name) \
+    static void carotene_test_##name(); \
+    static ::CAROTENE_NS::test::TestRegistrar carotene_registrar_##name(#name, carotene_test_##name); \
+    static void carotene_test_##name()
+
+#define CAROTENE_CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #cond << std::endl; \
+            ++::CAROTENE_NS::test::TestRegistry::failures(); \
+            return; \
+        } \
+    } while (0)
+
+// Deterministic pseudo random fill, independent of the C library
+class Rng
+{
+public:
+    explicit Rng(u32 seed = 0x12345678u) : state(seed ? seed : 1u) {}
+
+    u32 next()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    f32 uniform(f32 a, f32 b)
+    {
+        return a + (b - a) * (f32)(next() & 0xFFFFFF) / (f32)0x1000000;
+    }
+
+private:
+    u32 state;
+};
+
+// Image with padded rows so that kernels honouring the stride are caught reading past the width
+template <typename T>
+struct Image
+{
+    Image(size_t w, size_t h, size_t cn = 1, size_t pad = 7) :
+        width(w), height(h), channels(cn), stride((w * cn + pad) * sizeof(T)), data((w * cn + pad) * h + 1)
+    {
+    }
+
+    T * row(size_t y) { return &data[y * (stride / sizeof(T))]; }
+    const T * row(size_t y) const { return &data[y * (stride / sizeof(T))]; }
+    T & at(size_t x, size_t y, size_t c = 0) { return row(y)[x * channels + c]; }
+    const T & at(size_t x, size_t y, size_t c = 0) const { return row(y)[x * channels + c]; }
+    Size2D size() const { return Size2D(width, height); }
+
+    void randomize(Rng & rng, f64 lo = 0, f64 hi = 255)
+    {
+        for (size_t i = 0; i < data.size(); ++i)
+            data[i] = (T)(lo + (hi - lo) * (f64)(rng.next() & 0xFFFF) / 65535.0);
+    }
+
+    size_t width, height, channels;
+    ptrdiff_t stride;
+    std::vector<T> data;
+};
+
+// Largest absolute difference over the image area, padding excluded
+template <typename T>
+f64 maxDiff(const Image<T> & a, const Image<T> & b)
+{
+    f64 diff = 0;
+    for (size_t y = 0; y < a.height; ++y)
+        for (size_t x = 0; x < a.width * a.channels; ++x)
+        {
+            f64 d = (f64)a.row(y)[x] - (f64)b.row(y)[x];
+            diff = std::max(diff, d < 0 ? -d : d);
+        }
+    return diff;
+}
+
+/*
+ * Reference samplers of the warp and remap tests
+ */
+
+static const BORDER_MODE borderModes[] = {
+    BORDER_MODE_CONSTANT, BORDER_MODE_REPLICATE, BORDER_MODE_REFLECT, BORDER_MODE_REFLECT101, BORDER_MODE_WRAP
+};
+
+// OpenCV borderInterpolate, written out independently of carotene's
+inline s32 refBorder(s32 p, s32 len, BORDER_MODE mode)
+{
+    if (p >= 0 && p < len)
+        return p;
+    if (mode == BORDER_MODE_REPLICATE)
+        return p < 0 ? 0 : len - 1;
+    if (mode == BORDER_MODE_WRAP)
+        return ((p % len) + len) % len;
+    if (len == 1)
+        return 0;
+    s32 delta = mode == BORDER_MODE_REFLECT101 ? 1 : 0;
+    while (p < 0 || p >= len)
+        p = p < 0 ? -p - 1 + delta : 2 * len - 1 - p - delta;
+    return p;
+}
+
+inline u8 refPixel(const Image<u8> & src, s32 x, s32 y, BORDER_MODE mode, u8 value)
+{
+    if (x >= 0 && y >= 0 && x < (s32)src.width && y < (s32)src.height)
+        return src.at(x, y);
+    if (mode == BORDER_MODE_CONSTANT)
+        return value;
+    return src.at(refBorder(x, (s32)src.width, mode), refBorder(y, (s32)src.height, mode));
+}
+
+inline s16 sat16(s64 v)
+{
+    return (s16)std::min<s64>(std::max<s64>(v, SHRT_MIN), SHRT_MAX);
+}
+
+// Samples a C1 source at Q5 coordinates (X, Y), or at the nearest integer ones
+inline u8 refSample(const Image<u8> & src, s32 X, s32 Y, bool linear, BORDER_MODE mode, u8 value)
+{
+    if (!linear)
+        return refPixel(src, sat16(X), sat16(Y), mode, value);
+
+    s32 x = sat16(X >> 5), y = sat16(Y >> 5), fx = X & 31, fy = Y & 31;
+    s32 t0 = refPixel(src, x, y, mode, value) * (32 - fx) + refPixel(src, x + 1, y, mode, value) * fx;
+    s32 t1 = refPixel(src, x, y + 1, mode, value) * (32 - fx) + refPixel(src, x + 1, y + 1, mode, value) * fx;
+    return (u8)((t0 * (32 - fy) + t1 * fy + 512) >> 10);
+}
+
+}}
+
+#endif
@@ -0,0 +1,308 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <cmath>
+#include <limits>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+/*
+ * Kernels outside the imgproc HAL that had no coverage: reductions, integral images and depth
+ * conversions. Sizes cover the vector body, the scalar tail and single pixel images.
+ */
+
+namespace {
+
+const size_t coreSizes[][2] = { { 1, 1 }, { 7, 3 }, { 16, 2 }, { 33, 5 }, { 257, 4 }, { 640, 11 } };
+
+template <typename T>
+s32 refCountNonZero(const Image<T> & src)
+{
+    s32 count = 0;
+    for (size_t y = 0; y < src.height; ++y)
+        for (size_t x = 0; x < src.width; ++x)
+            count += src.at(x, y) != 0;
+    return count;
+}
+
+// randomize() leaves few zeros, clear about half of the pixels
+template <typename T>
+void sprinkleZeros(Image<T> & img, Rng & rng)
+{
+    for (size_t i = 0; i < img.data.size(); ++i)
+        if (rng.next() & 1)
+            img.data[i] = 0;
+}
+
+template <typename T>
+f64 refDot(const Image<T> & a, const Image<T> & b)
+{
+    f64 sum = 0;
+    for (size_t y = 0; y < a.height; ++y)
+        for (size_t x = 0; x < a.width; ++x)
+            sum += (f64)a.at(x, y) * (f64)b.at(x, y);
+    return sum;
+}
+
+template <typename T>
+T refSaturate(f64 r)
+{
+    if (r < (f64)std::numeric_limits<T>::min())
+        return std::numeric_limits<T>::min();
+    if (r > (f64)std::numeric_limits<T>::max())
+        return std::numeric_limits<T>::max();
+    return (T)r;
+}
+
+// Vector lanes round halves away from zero while the scalar tail follows the platform
+// rounding mode, so only exact halves may go either way
+template <typename T>
+bool roundedFrom(T got, f32 v)
+{
+    return got == refSaturate<T>(std::floor((f64)v + 0.5)) || got == refSaturate<T>(std::ceil((f64)v - 0.5));
+}
+
+} // namespace
+
+CAROTENE_TEST(countNonZero)
+{
+    Rng rng(11);
+    for (size_t si = 0; si < sizeof(coreSizes) / sizeof(coreSizes[0]); ++si)
+    {
+        size_t w = coreSizes[si][0], h = coreSizes[si][1];
+
+        Image<u8> src8(w, h);
+        src8.randomize(rng);
+        sprinkleZeros(src8, rng);
+        CAROTENE_CHECK(countNonZero(src8.size(), src8.row(0), src8.stride) == refCountNonZero(src8));
+
+        Image<u16> src16(w, h);
+        src16.randomize(rng, 0, 65535);
+        sprinkleZeros(src16, rng);
+        CAROTENE_CHECK(countNonZero(src16.size(), src16.row(0), src16.stride) == refCountNonZero(src16));
+
+        // negative zero counts as zero
+        Image<f32> src32(w, h);
+        src32.randomize(rng, -10, 10);
+        sprinkleZeros(src32, rng);
+        src32.at(w - 1, h - 1) = -0.0f;
+        CAROTENE_CHECK(countNonZero(src32.size(), src32.row(0), src32.stride) == refCountNonZero(src32));
+    }
+}
+
+CAROTENE_TEST(dotProduct)
+{
+    Rng rng(12);
+    for (size_t si = 0; si < sizeof(coreSizes) / sizeof(coreSizes[0]); ++si)
+    {
+        size_t w = coreSizes[si][0], h = coreSizes[si][1];
+
+        Image<u8> a8(w, h), b8(w, h);
+        a8.randomize(rng);
+        b8.randomize(rng);
+        CAROTENE_CHECK(dotProduct(a8.size(), a8.row(0), a8.stride, b8.row(0), b8.stride) == refDot(a8, b8));
+
+        Image<s8> as8(w, h), bs8(w, h);
+        as8.randomize(rng, -128, 127);
+        bs8.randomize(rng, -128, 127);
+        CAROTENE_CHECK(dotProduct(as8.size(), as8.row(0), as8.stride, bs8.row(0), bs8.stride) == refDot(as8, bs8));
+
+        // f32 is accumulated in float lanes, compare relative to the magnitude of the terms
+        Image<f32> af(w, h), bf(w, h);
+        af.randomize(rng, -1, 1);
+        bf.randomize(rng, -1, 1);
+        f64 ref = refDot(af, bf);
+        f64 got = dotProduct(af.size(), af.row(0), af.stride, bf.row(0), bf.stride);
+        CAROTENE_CHECK(std::abs(got - ref) <= 1e-5 * (f64)(w * h));
+    }
+}
+
+CAROTENE_TEST(integral)
+{
+    Rng rng(13);
+    for (size_t si = 0; si < sizeof(coreSizes) / sizeof(coreSizes[0]); ++si)
+    {
+        size_t w = coreSizes[si][0], h = coreSizes[si][1];
+        Image<u8> src(w, h);
+        src.randomize(rng);
+
+        Image<u32> sum(w, h);
+        Image<f64> sqsum(w, h);
+        integral(src.size(), src.row(0), src.stride, sum.row(0), sum.stride);
+        sqrIntegral(src.size(), src.row(0), src.stride, sqsum.row(0), sqsum.stride);
+
+        // inclusive sums, there is no zero border in carotene's layout
+        std::vector<u64> colSum(w, 0), colSq(w, 0);
+        for (size_t y = 0; y < h; ++y)
+        {
+            u64 rowSum = 0, rowSq = 0;
+            for (size_t x = 0; x < w; ++x)
+            {
+                u64 v = src.at(x, y);
+                rowSum += v;
+                rowSq += v * v;
+                colSum[x] += rowSum;
+                colSq[x] += rowSq;
+                CAROTENE_CHECK(sum.at(x, y) == (u32)colSum[x]);
+                CAROTENE_CHECK(sqsum.at(x, y) == (f64)colSq[x]);
+            }
+        }
+    }
+}
+
+CAROTENE_TEST(meanStdDev)
+{
+    Rng rng(14);
+    for (size_t si = 0; si < sizeof(coreSizes) / sizeof(coreSizes[0]); ++si)
+    {
+        size_t w = coreSizes[si][0], h = coreSizes[si][1];
+        Image<u8> src(w, h);
+        src.randomize(rng);
+
+        f64 s = 0, sq = 0;
+        for (size_t y = 0; y < h; ++y)
+            for (size_t x = 0; x < w; ++x)
+            {
+                s += src.at(x, y);
+                sq += (f64)src.at(x, y) * src.at(x, y);
+            }
+        f64 mean = s / (f64)(w * h);
+        f64 stddev = std::sqrt(std::max(sq / (f64)(w * h) - mean * mean, 0.0));
+
+        f32 gotMean = 0, gotStdDev = 0;
+        meanStdDev(src.size(), src.row(0), src.stride, &gotMean, &gotStdDev);
+        CAROTENE_CHECK(std::abs(gotMean - mean) <= 1e-3);
+        CAROTENE_CHECK(std::abs(gotStdDev - stddev) <= 1e-2);
+    }
+}
+
+CAROTENE_TEST(convert_f32)
+{
+    Rng rng(15);
+    for (size_t si = 0; si < sizeof(coreSizes) / sizeof(coreSizes[0]); ++si)
+    {
+        size_t w = coreSizes[si][0], h = coreSizes[si][1];
+
+        // out of range values and exact halves exercise saturation and rounding
+        Image<f32> src(w, h);
+        src.randomize(rng, -40000, 40000);
+        for (size_t x = 0; x < w; x += 3)
+            src.at(x, 0) = (f32)((s32)(rng.next() % 600) - 200) + 0.5f;
+
+        Image<u8> dst8(w, h);
+        Image<s16> dst16(w, h);
+        Image<s32> dst32(w, h);
+        convert(src.size(), src.row(0), src.stride, dst8.row(0), dst8.stride);
+        convert(src.size(), src.row(0), src.stride, dst16.row(0), dst16.stride);
+        convert(src.size(), src.row(0), src.stride, dst32.row(0), dst32.stride);
+
+        for (size_t y = 0; y < h; ++y)
+            for (size_t x = 0; x < w; ++x)
+            {
+                f32 v = src.at(x, y);
+                CAROTENE_CHECK(roundedFrom(dst8.at(x, y), v));
+                CAROTENE_CHECK(roundedFrom(dst16.at(x, y), v));
+                CAROTENE_CHECK(roundedFrom(dst32.at(x, y), v));
+            }
+    }
+}
+
+CAROTENE_TEST(convert_u8)
+{
+    Rng rng(16);
+    for (size_t si = 0; si < sizeof(coreSizes) / sizeof(coreSizes[0]); ++si)
+    {
+        size_t w = coreSizes[si][0], h = coreSizes[si][1];
+        Image<u8> src(w, h);
+        src.randomize(rng);
+
+        Image<s16> dst16(w, h);
+        Image<f32> dstf(w, h);
+        convert(src.size(), src.row(0), src.stride, dst16.row(0), dst16.stride);
+        convert(src.size(), src.row(0), src.stride, dstf.row(0), dstf.stride);
+
+        for (size_t y = 0; y < h; ++y)
+            for (size_t x = 0; x < w; ++x)
+            {
+                CAROTENE_CHECK(dst16.at(x, y) == (s16)src.at(x, y));
+                CAROTENE_CHECK(dstf.at(x, y) == (f32)src.at(x, y));
+            }
+    }
+}
+
+CAROTENE_TEST(rgbx2planar)
+{
+    const size_t widths[] = { 1, 7, 8, 15, 16, 17, 33, 100 };
+
+    Rng rng(29);
+    for (size_t wi = 0; wi < sizeof(widths) / sizeof(widths[0]); ++wi)
+    {
+        Image<u8> src(widths[wi], 5, 4);
+        src.randomize(rng);
+        Image<u8> dst[3] = { Image<u8>(widths[wi], 5), Image<u8>(widths[wi], 5), Image<u8>(widths[wi], 5) };
+        rgbx2planar(src.size(), src.row(0), src.stride,
+                    dst[0].row(0), dst[0].stride, dst[1].row(0), dst[1].stride, dst[2].row(0), dst[2].stride);
+
+        bool ok = true;
+        for (size_t y = 0; y < src.height; ++y)
+            for (size_t x = 0; x < src.width; ++x)
+                for (size_t c = 0; c < 3; ++c)
+                    ok = ok && dst[c].at(x, y) == src.at(x, y, c);
+        CAROTENE_CHECK(ok);
+    }
+}
+
+CAROTENE_TEST(combine4_alpha)
+{
+    const size_t widths[] = { 1, 7, 8, 15, 16, 17, 33, 100 };
+
+    Rng rng(30);
+    for (size_t wi = 0; wi < sizeof(widths) / sizeof(widths[0]); ++wi)
+    {
+        Image<u8> src(widths[wi], 5, 4);
+        src.randomize(rng);
+        Image<u8> rgb(widths[wi], 5, 3), alpha(widths[wi], 5), dst(widths[wi], 5, 4);
+        split4(src.size(), src.row(0), src.stride, rgb.row(0), rgb.stride, alpha.row(0), alpha.stride);
+        combine4(src.size(), rgb.row(0), rgb.stride, alpha.row(0), alpha.stride, dst.row(0), dst.stride);
+        CAROTENE_CHECK(maxDiff(src, dst) == 0);
+    }
+}
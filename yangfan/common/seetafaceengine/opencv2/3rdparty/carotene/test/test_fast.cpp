@@ -0,0 +1,204 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+namespace {
+
+struct Keypoint
+{
+    u16 x, y;
+    u8 score;
+    bool operator==(const Keypoint & o) const { return x == o.x && y == o.y && score == o.score; }
+};
+
+struct VectorStore : public KeypointStore
+{
+    std::vector<Keypoint> points;
+    virtual void push(f32 kpX, f32 kpY, f32, f32, f32 kpResponse, s32, s32)
+    {
+        Keypoint p = { (u16)kpX, (u16)kpY, (u8)kpResponse };
+        points.push_back(p);
+    }
+};
+
+const s32 circle[16][2] = {
+    { 0, 3 }, { 1, 3 }, { 2, 2 }, { 3, 1 }, { 3, 0 }, { 3, -1 }, { 2, -2 }, { 1, -3 },
+    { 0, -3 }, { -1, -3 }, { -2, -2 }, { -3, -1 }, { -3, 0 }, { -3, 1 }, { -2, 2 }, { -1, 3 }
+};
+
+// Straight from the definitions: a corner has 9 contiguous circle pixels all brighter or all
+// darker than the center by more than the threshold, its score is the largest threshold
+// for which it still is one. Returns score + 1 for corners and 0 elsewhere.
+s32 refStrength(const Image<u8> & src, s32 x, s32 y, s32 threshold)
+{
+    if (x < 3 || y < 3 || x + 3 >= (s32)src.width || y + 3 >= (s32)src.height)
+        return 0;
+    s32 v = src.at(x, y), best = -1000;
+    for (s32 k = 0; k < 16; ++k)
+    {
+        s32 darker = 1000, brighter = 1000;
+        for (s32 l = 0; l < 9; ++l)
+        {
+            s32 p = src.at(x + circle[(k + l) & 15][0], y + circle[(k + l) & 15][1]);
+            darker = std::min(darker, v - p);
+            brighter = std::min(brighter, p - v);
+        }
+        best = std::max(best, std::max(darker, brighter));
+    }
+    return best > threshold ? best : 0;
+}
+
+std::vector<Keypoint> refFAST(const Image<u8> & src, s32 threshold, bool nonmax)
+{
+    std::vector<Keypoint> points;
+    for (s32 y = 0; y < (s32)src.height; ++y)
+        for (s32 x = 0; x < (s32)src.width; ++x)
+        {
+            s32 s = refStrength(src, x, y, threshold);
+            if (!s)
+                continue;
+            bool keep = true;
+            if (nonmax)
+                for (s32 dy = -1; dy <= 1; ++dy)
+                    for (s32 dx = -1; dx <= 1; ++dx)
+                        if ((dx || dy) && std::max(refStrength(src, x + dx, y + dy, threshold) - 1, 0) >= s - 1)
+                            keep = false;
+            Keypoint p = { (u16)x, (u16)y, (u8)(nonmax ? s - 1 : 0) };
+            if (keep)
+                points.push_back(p);
+        }
+    return points;
+}
+
+// Blobs and steps over noise, so that there are corners of all strengths and plateaus of
+// equal scores
+void makeScene(Image<u8> & img, Rng & rng)
+{
+    img.randomize(rng, 0, 40);
+    for (size_t n = 0; n < img.width * img.height / 40; ++n)
+    {
+        size_t x = rng.next() % img.width, y = rng.next() % img.height;
+        u8 v = (u8)(rng.next() % 256);
+        for (size_t dy = 0; dy < 3 && y + dy < img.height; ++dy)
+            for (size_t dx = 0; dx < 3 && x + dx < img.width; ++dx)
+                img.at(x + dx, y + dy) = v;
+    }
+}
+
+std::vector<Keypoint> runGrid(const Image<u8> & src, u8 threshold, bool nonmax, const Size2D & cell, u32 maxPerCell)
+{
+    std::vector<u16> xs(1), ys(1);
+    std::vector<u8> scores(1);
+    KeypointArrays kp(&xs[0], &ys[0], &scores[0], 1);
+    FASTGrid(src.size(), src.row(0), src.stride, threshold, nonmax, cell, maxPerCell, &kp);
+    // second call with room for all of them
+    xs.resize(kp.count + 1);
+    ys.resize(kp.count + 1);
+    scores.resize(kp.count + 1);
+    kp = KeypointArrays(&xs[0], &ys[0], &scores[0], xs.size());
+    FASTGrid(src.size(), src.row(0), src.stride, threshold, nonmax, cell, maxPerCell, &kp);
+
+    std::vector<Keypoint> points(kp.count);
+    for (size_t k = 0; k < kp.count; ++k)
+    {
+        points[k].x = xs[k];
+        points[k].y = ys[k];
+        points[k].score = scores[k];
+    }
+    return points;
+}
+
+} // namespace
+
+CAROTENE_TEST(FAST_reference)
+{
+    Rng rng(71);
+    const size_t sizes[][2] = { { 7, 7 }, { 21, 9 }, { 22, 12 }, { 23, 17 }, { 64, 31 }, { 101, 40 } };
+    const u8 thresholds[] = { 0, 10, 20, 60 };
+    for (size_t si = 0; si < 6; ++si)
+        for (size_t ti = 0; ti < 4; ++ti)
+            for (int nonmax = 0; nonmax < 2; ++nonmax)
+            {
+                Image<u8> src(sizes[si][0], sizes[si][1]);
+                makeScene(src, rng);
+                VectorStore store;
+                FAST(src.size(), src.row(0), src.stride, &store, thresholds[ti], nonmax != 0);
+                CAROTENE_CHECK(store.points == refFAST(src, thresholds[ti], nonmax != 0));
+                CAROTENE_CHECK(runGrid(src, thresholds[ti], nonmax != 0, Size2D(8, 8), 0) == store.points);
+            }
+}
+
+CAROTENE_TEST(FASTGrid_cells)
+{
+    Rng rng(72);
+    Image<u8> src(160, 96);
+    makeScene(src, rng);
+    std::vector<Keypoint> all = refFAST(src, 10, true);
+
+    const size_t cells[][2] = { { 32, 32 }, { 40, 24 }, { 17, 13 } };
+    const u32 caps[] = { 1, 3, 1000 };
+    for (size_t ci = 0; ci < 3; ++ci)
+        for (size_t ki = 0; ki < 3; ++ki)
+        {
+            Size2D cell(cells[ci][0], cells[ci][1]);
+            std::vector<Keypoint> points = runGrid(src, 10, true, cell, caps[ki]);
+
+            // per cell, the strongest corners with ties to raster order, in raster order
+            std::vector<Keypoint> expected;
+            for (size_t k = 0; k < all.size(); ++k)
+            {
+                size_t stronger = 0;
+                for (size_t l = 0; l < all.size(); ++l)
+                    if (all[l].x / cell.width == all[k].x / cell.width &&
+                        all[l].y / cell.height == all[k].y / cell.height &&
+                        (all[l].score > all[k].score || (all[l].score == all[k].score && l < k)))
+                        ++stronger;
+                if (stronger < caps[ki])
+                    expected.push_back(all[k]);
+            }
+            CAROTENE_CHECK(points == expected);
+        }
+}
@@ -0,0 +1,352 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+/*
+ * Box and binomial blurs, Laplacian and Canny against scalar references
+ */
+
+namespace {
+
+const size_t filterSizes[][2] = { { 2, 2 }, { 3, 3 }, { 5, 2 }, { 8, 2 }, { 9, 2 }, { 12, 3 }, { 16, 3 }, { 23, 7 }, { 64, 5 }, { 131, 9 } };
+const size_t filterSizeCount = sizeof(filterSizes) / sizeof(filterSizes[0]);
+
+u8 refPixelCn(const Image<u8> & src, s32 x, s32 y, s32 c, BORDER_MODE mode, u8 value)
+{
+    if (x >= 0 && y >= 0 && x < (s32)src.width && y < (s32)src.height)
+        return src.at(x, y, c);
+    if (mode == BORDER_MODE_CONSTANT)
+        return value;
+    return src.at(refBorder(x, (s32)src.width, mode), refBorder(y, (s32)src.height, mode), c);
+}
+
+void refBlur3x3(const Image<u8> & src, Image<u8> & dst, BORDER_MODE border, u8 borderValue)
+{
+    for (size_t y = 0; y < src.height; ++y)
+        for (size_t x = 0; x < src.width; ++x)
+            for (size_t c = 0; c < src.channels; ++c)
+            {
+                s32 sum = 0;
+                for (s32 dy = -1; dy <= 1; ++dy)
+                    for (s32 dx = -1; dx <= 1; ++dx)
+                        sum += refPixelCn(src, (s32)x + dx, (s32)y + dy, (s32)c, border, borderValue);
+                dst.at(x, y, c) = (u8)((sum + 4) / 9);
+            }
+}
+
+void refSobel3x3(const Image<u8> & src, Image<s16> & dx, Image<s16> & dy)
+{
+    for (s32 y = 0; y < (s32)src.height; ++y)
+        for (s32 x = 0; x < (s32)src.width; ++x)
+        {
+            s32 p[3][3];
+            for (s32 i = -1; i <= 1; ++i)
+                for (s32 j = -1; j <= 1; ++j)
+                    p[i + 1][j + 1] = refPixel(src, x + j, y + i, BORDER_MODE_REPLICATE, 0);
+            dx.at(x, y) = (s16)((p[0][2] + 2 * p[1][2] + p[2][2]) - (p[0][0] + 2 * p[1][0] + p[2][0]));
+            dy.at(x, y) = (s16)((p[2][0] + 2 * p[2][1] + p[2][2]) - (p[0][0] + 2 * p[0][1] + p[0][2]));
+        }
+}
+
+/*
+ * Textbook Canny on precomputed derivatives: the channel with the largest norm is used,
+ * magnitudes outside the image are zero, non-maximum suppression uses the same fixed point
+ * sector test as the kernel and hysteresis follows 8-connected paths of candidate pixels.
+ */
+void refCanny(size_t width, size_t height, size_t cn, const Image<s16> & dx, const Image<s16> & dy,
+              Image<u8> & dst, s32 low, s32 high, bool L2)
+{
+    ptrdiff_t w = (ptrdiff_t)width, h = (ptrdiff_t)height;
+    std::vector<s32> mag((w + 2) * (h + 2), 0), gx(w * h), gy(w * h);
+    for (ptrdiff_t y = 0; y < h; ++y)
+        for (ptrdiff_t x = 0; x < w; ++x)
+        {
+            s32 best = -1;
+            for (size_t c = 0; c < cn; ++c)
+            {
+                s32 vx = dx.at(x, y, c), vy = dy.at(x, y, c);
+                s32 n = L2 ? vx * vx + vy * vy : std::abs(vx) + std::abs(vy);
+                if (n > best)
+                {
+                    best = n;
+                    gx[y * w + x] = vx;
+                    gy[y * w + x] = vy;
+                }
+            }
+            mag[(y + 1) * (w + 2) + x + 1] = best;
+        }
+
+    const s32 TG22 = (s32)(0.4142135623730950488016887242097 * (1 << 15) + 0.5);
+    std::vector<u8> state(w * h, 0); // 0 - not an edge, 1 - candidate, 2 - edge
+    std::vector<ptrdiff_t> stack;
+    for (ptrdiff_t y = 0; y < h; ++y)
+        for (ptrdiff_t x = 0; x < w; ++x)
+        {
+            const s32 * m = &mag[(y + 1) * (w + 2) + x + 1];
+            const ptrdiff_t up = -(w + 2), down = w + 2;
+            if (m[0] <= low)
+                continue;
+            s32 xs = gx[y * w + x], ys = gy[y * w + x];
+            s32 ax = std::abs(xs), ay = std::abs(ys) << 15;
+            s32 tg22x = ax * TG22, tg67x = tg22x + (ax << 16);
+            bool peak;
+            if (ay < tg22x)
+                peak = m[0] > m[-1] && m[0] >= m[1];
+            else if (ay > tg67x)
+                peak = m[0] > m[up] && m[0] >= m[down];
+            else
+            {
+                ptrdiff_t s = (xs ^ ys) < 0 ? -1 : 1;
+                peak = m[0] > m[up - s] && m[0] > m[down + s];
+            }
+            if (!peak)
+                continue;
+            state[y * w + x] = 1;
+            if (m[0] > high)
+            {
+                state[y * w + x] = 2;
+                stack.push_back(y * w + x);
+            }
+        }
+
+    while (!stack.empty())
+    {
+        ptrdiff_t p = stack.back();
+        stack.pop_back();
+        ptrdiff_t py = p / w, px = p % w;
+        for (ptrdiff_t ny = py - 1; ny <= py + 1; ++ny)
+            for (ptrdiff_t nx = px - 1; nx <= px + 1; ++nx)
+                if (ny >= 0 && nx >= 0 && ny < h && nx < w && state[ny * w + nx] == 1)
+                {
+                    state[ny * w + nx] = 2;
+                    stack.push_back(ny * w + nx);
+                }
+    }
+
+    for (ptrdiff_t y = 0; y < h; ++y)
+        for (ptrdiff_t x = 0; x < w; ++x)
+            dst.at(x, y) = state[y * w + x] == 2 ? 255 : 0;
+}
+
+/*
+ * Binomial blur of the roi at (ox, oy) of full with the given size: pixels outside the roi
+ * come from full, the border is only extrapolated at the edges of full.
+ */
+void refGaussian(const Image<u8> & full, size_t ox, size_t oy, Image<u8> & dst, s32 ksize,
+                 BORDER_MODE border, u8 borderValue)
+{
+    static const s32 k3[] = { 1, 2, 1 }, k5[] = { 1, 4, 6, 4, 1 };
+    const s32 * k = ksize == 3 ? k3 : k5;
+    s32 r = ksize / 2, shift = ksize == 3 ? 4 : 8;
+    for (size_t y = 0; y < dst.height; ++y)
+        for (size_t x = 0; x < dst.width; ++x)
+            for (size_t c = 0; c < dst.channels; ++c)
+            {
+                s32 sum = 0;
+                for (s32 i = -r; i <= r; ++i)
+                    for (s32 j = -r; j <= r; ++j)
+                        sum += k[i + r] * k[j + r] *
+                               refPixelCn(full, (s32)(ox + x) + j, (s32)(oy + y) + i, (s32)c, border, borderValue);
+                dst.at(x, y, c) = (u8)((sum + (1 << (shift - 1))) >> shift);
+            }
+}
+
+// Blurred random blobs give long connected edges with weak and strong parts
+void randomBlobs(Image<u8> & img, Rng & rng)
+{
+    Image<u8> tmp(img.width, img.height, img.channels);
+    tmp.randomize(rng);
+    for (size_t i = 0; i < tmp.data.size(); ++i)
+        tmp.data[i] = tmp.data[i] < 128 ? 40 : 200;
+    refBlur3x3(tmp, img, BORDER_MODE_REPLICATE, 0);
+}
+
+} // namespace
+
+CAROTENE_TEST(blur3x3)
+{
+    Rng rng(201);
+    const BORDER_MODE modes[] = { BORDER_MODE_CONSTANT, BORDER_MODE_REPLICATE, BORDER_MODE_REFLECT, BORDER_MODE_REFLECT101 };
+    for (size_t si = 0; si < filterSizeCount; ++si)
+        for (size_t mi = 0; mi < 4; ++mi)
+        {
+            size_t w = filterSizes[si][0], h = filterSizes[si][1];
+            u8 borderValue = (u8)(rng.next() & 0xFF);
+
+            if (isBlur3x3Supported(Size2D(w, h), modes[mi]))
+            {
+                Image<u8> src(w, h), dst(w, h), ref(w, h);
+                src.randomize(rng);
+                blur3x3(src.size(), src.row(0), src.stride, dst.row(0), dst.stride, modes[mi], borderValue);
+                refBlur3x3(src, ref, modes[mi], borderValue);
+                // the vector body rounds through vqrdmulh by 1/9
+                CAROTENE_CHECK(maxDiff(dst, ref) <= 1);
+            }
+
+            for (s32 cn = 1; cn <= 4; ++cn)
+            {
+                if (!isBlurU8Supported(Size2D(w, h), cn, modes[mi]))
+                    continue;
+                Image<u8> src(w, h, cn), dst(w, h, cn), ref(w, h, cn);
+                src.randomize(rng);
+                blur3x3(src.size(), cn, src.row(0), src.stride, dst.row(0), dst.stride, modes[mi], borderValue);
+                refBlur3x3(src, ref, modes[mi], borderValue);
+                CAROTENE_CHECK(maxDiff(dst, ref) <= 1);
+            }
+        }
+}
+
+CAROTENE_TEST(gaussianBlur)
+{
+    Rng rng(204);
+    // { left, right, top, bottom } pixels of real image around the roi
+    const size_t margins[][4] = { { 0, 0, 0, 0 }, { 2, 3, 1, 4 }, { 1, 0, 2, 0 }, { 0, 5, 0, 1 }, { 0, 0, 3, 0 } };
+    for (size_t si = 0; si < filterSizeCount; ++si)
+        for (size_t bi = 0; bi < sizeof(borderModes) / sizeof(borderModes[0]); ++bi)
+            for (size_t mi = 0; mi < sizeof(margins) / sizeof(margins[0]); ++mi)
+            {
+                size_t w = filterSizes[si][0], h = filterSizes[si][1];
+                const size_t * m = margins[mi];
+                Margin margin(m[0], m[1], m[2], m[3]);
+                BORDER_MODE border = borderModes[bi];
+                u8 borderValue = (u8)(rng.next() & 0xFF);
+
+                for (s32 cn = 1; cn <= 4; ++cn)
+                {
+                    if (!isGaussianBlur5x5Supported(Size2D(w, h), cn, border))
+                        continue;
+                    Image<u8> full(w + m[0] + m[1], h + m[2] + m[3], cn), dst(w, h, cn), ref(w, h, cn);
+                    full.randomize(rng);
+                    gaussianBlur5x5(Size2D(w, h), cn, &full.at(m[0], m[2]), full.stride, dst.row(0), dst.stride,
+                                    border, borderValue, margin);
+                    refGaussian(full, m[0], m[2], ref, 5, border, borderValue);
+                    CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+                }
+
+                if (isGaussianBlur3x3MarginSupported(Size2D(w, h), border, margin))
+                {
+                    Image<u8> full(w + m[0] + m[1], h + m[2] + m[3]), dst(w, h), ref(w, h);
+                    full.randomize(rng);
+                    gaussianBlur3x3Margin(Size2D(w, h), &full.at(m[0], m[2]), full.stride, dst.row(0), dst.stride,
+                                          border, borderValue, margin);
+                    refGaussian(full, m[0], m[2], ref, 3, border, borderValue);
+                    CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+                }
+            }
+}
+
+CAROTENE_TEST(Laplacian3x3)
+{
+    Rng rng(202);
+    const BORDER_MODE modes[] = { BORDER_MODE_CONSTANT, BORDER_MODE_REPLICATE };
+    for (size_t si = 0; si < filterSizeCount; ++si)
+        for (size_t mi = 0; mi < 2; ++mi)
+        {
+            size_t w = filterSizes[si][0], h = filterSizes[si][1];
+            if (!isLaplacian3x3Supported(Size2D(w, h), modes[mi]))
+                continue;
+            u8 borderValue = (u8)(rng.next() & 0xFF);
+            Image<u8> src(w, h), dst(w, h), ref(w, h);
+            randomBlobs(src, rng);
+
+            Laplacian3x3(src.size(), src.row(0), src.stride, dst.row(0), dst.stride, modes[mi], borderValue);
+            for (s32 y = 0; y < (s32)h; ++y)
+                for (s32 x = 0; x < (s32)w; ++x)
+                {
+                    s32 sum = 0;
+                    for (s32 dy = -1; dy <= 1; ++dy)
+                        for (s32 dx = -1; dx <= 1; ++dx)
+                            sum += refPixel(src, x + dx, y + dy, modes[mi], borderValue);
+                    sum -= 9 * src.at(x, y);
+                    ref.at(x, y) = (u8)std::min(std::max(sum, 0), 255);
+                }
+            CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+        }
+}
+
+CAROTENE_TEST(Canny3x3)
+{
+    Rng rng(203);
+    for (size_t si = 0; si < filterSizeCount; ++si)
+        for (s32 L2 = 0; L2 <= 1; ++L2)
+        {
+            size_t w = filterSizes[si][0], h = filterSizes[si][1];
+            if (!isCanny3x3Supported(Size2D(w, h)))
+                continue;
+            const s32 low = 60, high = 180;
+            const s32 refLow = L2 ? low * low : low, refHigh = L2 ? high * high : high;
+
+            // Sobel inside the kernel, replicated borders
+            Image<u8> src(w, h), dst(w, h), ref(w, h);
+            Image<s16> dx(w, h), dy(w, h);
+            randomBlobs(src, rng);
+            refSobel3x3(src, dx, dy);
+            refCanny(w, h, 1, dx, dy, ref, refLow, refHigh, L2 != 0);
+            // swapped thresholds are accepted as well
+            if (L2)
+                Canny3x3L2(src.size(), src.row(0), src.stride, dst.row(0), dst.stride, high, low, Margin());
+            else
+                Canny3x3L1(src.size(), src.row(0), src.stride, dst.row(0), dst.stride, high, low, Margin());
+            CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+
+            // precomputed derivatives, the strongest channel is used
+            for (s32 cn = 1; cn <= 3; cn += 2)
+            {
+                Image<s16> mdx(w, h, cn), mdy(w, h, cn);
+                mdx.randomize(rng, -400, 400);
+                mdy.randomize(rng, -400, 400);
+                Image<s16> cdx = mdx, cdy = mdy; // the kernel may reuse its inputs as scratch
+                refCanny(w, h, cn, mdx, mdy, ref, refLow, refHigh, L2 != 0);
+                if (L2)
+                    Canny3x3L2(cdx.size(), cn, cdx.row(0), cdx.stride, cdy.row(0), cdy.stride,
+                               dst.row(0), dst.stride, low, high);
+                else
+                    Canny3x3L1(cdx.size(), cn, cdx.row(0), cdx.stride, cdy.row(0), cdy.stride,
+                               dst.row(0), dst.stride, low, high);
+                CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+            }
+        }
+}
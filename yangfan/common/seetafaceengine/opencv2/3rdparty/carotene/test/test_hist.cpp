@@ -0,0 +1,247 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+namespace {
+
+const size_t widths[] = { 1, 7, 15, 16, 17, 33, 64, 101 };
+
+std::vector<u32> refHist(const Image<u8> & src)
+{
+    std::vector<u32> hist(256, 0);
+    for (size_t y = 0; y < src.height; ++y)
+        for (size_t x = 0; x < src.width; ++x)
+            ++hist[src.at(x, y)];
+    return hist;
+}
+
+s32 cvRound(f32 v)
+{
+    return (s32)std::nearbyint(v);
+}
+
+// cv::equalizeHist
+void refEqualizeHist(const Image<u8> & src, Image<u8> & dst)
+{
+    std::vector<u32> hist = refHist(src);
+    u8 table[256] = { 0 };
+    size_t i = 0;
+    while (!hist[i])
+        ++i;
+    u32 total = (u32)(src.width * src.height);
+    if (hist[i] == total)
+        std::fill(table, table + 256, (u8)i);
+    else
+    {
+        f32 scale = 255.f / (total - hist[i]);
+        u32 sum = 0;
+        for (table[i++] = 0; i < 256; ++i)
+        {
+            sum += hist[i];
+            table[i] = (u8)std::min(std::max(cvRound(sum * scale), 0), 255);
+        }
+    }
+    for (size_t y = 0; y < src.height; ++y)
+        for (size_t x = 0; x < src.width; ++x)
+            dst.at(x, y) = table[src.at(x, y)];
+}
+
+s32 reflect101(s32 p, s32 len)
+{
+    if (len == 1)
+        return 0;
+    while (p < 0 || p >= len)
+        p = p < 0 ? -p : 2 * len - 2 - p;
+    return p;
+}
+
+// CLAHE_Impl::apply of OpenCV for CV_8UC1, written out without the parallel bodies
+void refClahe(const Image<u8> & src, Image<u8> & dst, s32 tilesX, s32 tilesY, f64 clipLimit)
+{
+    s32 w = (s32)src.width, h = (s32)src.height;
+    s32 tileW = (w + tilesX - 1) / tilesX, tileH = (h + tilesY - 1) / tilesY;
+    s32 tileArea = tileW * tileH;
+    s32 clip = clipLimit > 0.0 ? std::max((s32)(clipLimit * tileArea / 256), 1) : 0;
+    f32 lutScale = 255.f / tileArea;
+
+    std::vector<u8> luts(tilesX * tilesY * 256);
+    for (s32 ty = 0; ty < tilesY; ++ty)
+        for (s32 tx = 0; tx < tilesX; ++tx)
+        {
+            s32 hist[256] = { 0 };
+            for (s32 y = ty * tileH; y < (ty + 1) * tileH; ++y)
+                for (s32 x = tx * tileW; x < (tx + 1) * tileW; ++x)
+                    ++hist[src.at(reflect101(x, w), reflect101(y, h))];
+
+            if (clip > 0)
+            {
+                s32 clipped = 0;
+                for (s32 i = 0; i < 256; ++i)
+                    if (hist[i] > clip)
+                    {
+                        clipped += hist[i] - clip;
+                        hist[i] = clip;
+                    }
+                s32 redistBatch = clipped / 256, residual = clipped - redistBatch * 256;
+                for (s32 i = 0; i < 256; ++i)
+                    hist[i] += redistBatch;
+                if (residual != 0)
+                {
+                    s32 residualStep = std::max(256 / residual, 1);
+                    for (s32 i = 0; i < 256 && residual > 0; i += residualStep, residual--)
+                        hist[i]++;
+                }
+            }
+
+            s32 sum = 0;
+            for (s32 i = 0; i < 256; ++i)
+            {
+                sum += hist[i];
+                luts[(ty * tilesX + tx) * 256 + i] = (u8)std::min(std::max(cvRound(sum * lutScale), 0), 255);
+            }
+        }
+
+    f32 inv_tw = 1.0f / tileW, inv_th = 1.0f / tileH;
+    for (s32 y = 0; y < h; ++y)
+    {
+        f32 tyf = y * inv_th - 0.5f;
+        s32 ty1 = (s32)std::floor(tyf), ty2 = ty1 + 1;
+        f32 ya = tyf - ty1, ya1 = 1.0f - ya;
+        ty1 = std::max(ty1, 0);
+        ty2 = std::min(ty2, tilesY - 1);
+        for (s32 x = 0; x < w; ++x)
+        {
+            f32 txf = x * inv_tw - 0.5f;
+            s32 tx1 = (s32)std::floor(txf), tx2 = tx1 + 1;
+            f32 xa = txf - tx1, xa1 = 1.0f - xa;
+            tx1 = std::max(tx1, 0);
+            tx2 = std::min(tx2, tilesX - 1);
+            s32 v = src.at(x, y);
+            const u8 * l1 = &luts[ty1 * tilesX * 256], * l2 = &luts[ty2 * tilesX * 256];
+            f32 res = (l1[tx1 * 256 + v] * xa1 + l1[tx2 * 256 + v] * xa) * ya1 +
+                      (l2[tx1 * 256 + v] * xa1 + l2[tx2 * 256 + v] * xa) * ya;
+            dst.at(x, y) = (u8)std::min(std::max(cvRound(res), 0), 255);
+        }
+    }
+}
+
+} // namespace
+
+CAROTENE_TEST(calcHist_u8)
+{
+    Rng rng(61);
+    for (size_t wi = 0; wi < sizeof(widths) / sizeof(widths[0]); ++wi)
+    {
+        Image<u8> src(widths[wi], 1 + wi * 5);
+        src.randomize(rng);
+        std::vector<u32> hist(256, 0xDEADu);
+        calcHist(src.size(), src.row(0), src.stride, &hist[0]);
+        CAROTENE_CHECK(hist == refHist(src));
+    }
+
+    // a single value, every pixel lands in the same bin of each sub-histogram
+    Image<u8> flat(64, 9, 1, 0);
+    flat.randomize(rng, 200, 200);
+    std::vector<u32> hist(256);
+    calcHist(flat.size(), flat.row(0), flat.stride, &hist[0]);
+    CAROTENE_CHECK(hist[200] == 64 * 9 && hist == refHist(flat));
+}
+
+CAROTENE_TEST(lut_u8)
+{
+    Rng rng(62);
+    u8 table[256];
+    for (size_t i = 0; i < 256; ++i)
+        table[i] = (u8)rng.next();
+    for (size_t wi = 0; wi < sizeof(widths) / sizeof(widths[0]); ++wi)
+    {
+        Image<u8> src(widths[wi], 3 + wi), dst(widths[wi], 3 + wi);
+        src.randomize(rng);
+        lut(src.size(), src.row(0), src.stride, dst.row(0), dst.stride, table);
+        for (size_t y = 0; y < src.height; ++y)
+            for (size_t x = 0; x < src.width; ++x)
+                CAROTENE_CHECK(dst.at(x, y) == table[src.at(x, y)]);
+    }
+}
+
+CAROTENE_TEST(equalizeHist_u8)
+{
+    Rng rng(63);
+    const f64 ranges[][2] = { { 0, 255 }, { 40, 90 }, { 7, 7 }, { 250, 255 } };
+    for (size_t wi = 0; wi < sizeof(widths) / sizeof(widths[0]); ++wi)
+        for (size_t ri = 0; ri < 4; ++ri)
+        {
+            Image<u8> src(widths[wi], 2 + wi * 3), dst(widths[wi], 2 + wi * 3), ref(widths[wi], 2 + wi * 3);
+            src.randomize(rng, ranges[ri][0], ranges[ri][1]);
+            equalizeHist(src.size(), src.row(0), src.stride, dst.row(0), dst.stride);
+            refEqualizeHist(src, ref);
+            CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+        }
+}
+
+CAROTENE_TEST(clahe_u8)
+{
+    Rng rng(64);
+    const size_t sizes[][2] = { { 64, 64 }, { 101, 37 }, { 17, 9 }, { 640, 48 } };
+    const u32 tiles[][2] = { { 8, 8 }, { 3, 5 }, { 1, 1 }, { 4, 2 } };
+    const f64 clips[] = { 0.0, 1.0, 2.0, 40.0 };
+    for (size_t si = 0; si < 4; ++si)
+        for (size_t ti = 0; ti < 4; ++ti)
+            for (size_t ci = 0; ci < 4; ++ci)
+            {
+                if (sizes[si][0] < tiles[ti][0] || sizes[si][1] < tiles[ti][1])
+                    continue;
+                Image<u8> src(sizes[si][0], sizes[si][1]), dst(sizes[si][0], sizes[si][1]), ref(sizes[si][0], sizes[si][1]);
+                // a dark, low contrast image, the case CLAHE is used for
+                src.randomize(rng, 10, 10 + 30 * (ci + 1));
+                CAROTENE_CHECK(isClaheSupported(src.size(), tiles[ti][0], tiles[ti][1]));
+                clahe(src.size(), src.row(0), src.stride, dst.row(0), dst.stride, tiles[ti][0], tiles[ti][1], clips[ci]);
+                refClahe(src, ref, tiles[ti][0], tiles[ti][1], clips[ci]);
+                // the blend may be contracted to fused multiply-adds by the compiler
+                CAROTENE_CHECK(maxDiff(dst, ref) <= 1);
+            }
+}
@@ -0,0 +1,149 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <cfloat>
+#include <cmath>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+namespace {
+
+// Search windows narrower and wider than one 16 pixel block, templates with odd sizes
+struct MatchCase
+{
+    size_t srcWidth, srcHeight, tmplWidth, tmplHeight;
+};
+
+const MatchCase matchCases[] = {
+    { 1, 1, 1, 1 }, { 9, 6, 3, 2 }, { 40, 11, 7, 5 }, { 53, 20, 16, 16 }, { 80, 9, 33, 1 }, { 21, 40, 1, 31 }
+};
+
+f32 refNormalize(f64 num, f64 wndSqsum, f64 tmplSqsum, bool sqdiff)
+{
+    f64 t = wndSqsum <= std::min(0.5, 10 * FLT_EPSILON * wndSqsum) ? 0 : std::sqrt(wndSqsum * tmplSqsum);
+    if (std::fabs(num) < t)
+        return (f32)(num / t);
+    if (std::fabs(num) < t * 1.125)
+        return num > 0 ? 1.f : -1.f;
+    return sqdiff ? 1.f : 0.f;
+}
+
+void refMatch(const Image<u8> & src, const Image<u8> & tmpl, bool sqdiff, bool normalize, Image<f32> & dst)
+{
+    f64 tmplSqsum = 0;
+    for (size_t ty = 0; ty < tmpl.height; ++ty)
+        for (size_t tx = 0; tx < tmpl.width; ++tx)
+            tmplSqsum += (f64)tmpl.at(tx, ty) * tmpl.at(tx, ty);
+
+    for (size_t y = 0; y < dst.height; ++y)
+        for (size_t x = 0; x < dst.width; ++x)
+        {
+            f64 cc = 0, diff = 0, wnd = 0;
+            for (size_t ty = 0; ty < tmpl.height; ++ty)
+                for (size_t tx = 0; tx < tmpl.width; ++tx)
+                {
+                    f64 s = src.at(x + tx, y + ty), t = tmpl.at(tx, ty);
+                    cc += s * t;
+                    diff += (s - t) * (s - t);
+                    wnd += s * s;
+                }
+            f64 num = sqdiff ? diff : cc;
+            dst.at(x, y) = normalize ? refNormalize(num, wnd, tmplSqsum, sqdiff) : (f32)num;
+        }
+}
+
+bool checkMatch(Rng & rng, bool sqdiff, bool normalize, bool flat)
+{
+    for (size_t ci = 0; ci < sizeof(matchCases) / sizeof(matchCases[0]); ++ci)
+    {
+        const MatchCase & mc = matchCases[ci];
+        Image<u8> src(mc.srcWidth, mc.srcHeight), tmpl(mc.tmplWidth, mc.tmplHeight, 1, 3);
+        src.randomize(rng, 0, flat ? 1 : 255);
+        tmpl.randomize(rng, 0, 255);
+
+        Image<f32> dst(mc.srcWidth - mc.tmplWidth + 1, mc.srcHeight - mc.tmplHeight + 1), ref = dst;
+        refMatch(src, tmpl, sqdiff, normalize, ref);
+        if (sqdiff)
+            matchTemplateSqDiff(src.size(), src.data.data(), src.stride, tmpl.size(), tmpl.data.data(), tmpl.stride,
+                                &dst.at(0, 0), dst.stride, normalize);
+        else
+            matchTemplate(src.size(), src.data.data(), src.stride, tmpl.size(), tmpl.data.data(), tmpl.stride,
+                          &dst.at(0, 0), dst.stride, normalize);
+
+        // the plain sums are exact integers, the normalized scores only agree up to rounding
+        if (maxDiff(dst, ref) > (normalize ? 1e-5 : 0))
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+CAROTENE_TEST(matchTemplate)
+{
+    Rng rng;
+    CAROTENE_CHECK(isMatchTemplateSupported(Size2D(256, 256)));
+    CAROTENE_CHECK(!isMatchTemplateSupported(Size2D(257, 256)));
+    CAROTENE_CHECK(!isMatchTemplateSupported(Size2D(0, 4)));
+
+    CAROTENE_CHECK(checkMatch(rng, false, false, false));
+    CAROTENE_CHECK(checkMatch(rng, false, true, false));
+    CAROTENE_CHECK(checkMatch(rng, true, false, false));
+    CAROTENE_CHECK(checkMatch(rng, true, true, false));
+    // mostly black windows hit the guard against dividing by a zero norm
+    CAROTENE_CHECK(checkMatch(rng, false, true, true));
+    CAROTENE_CHECK(checkMatch(rng, true, true, true));
+
+    // a patch cut out of the image is an exact match
+    Image<u8> src(70, 30), tmpl(12, 9);
+    src.randomize(rng, 0, 255);
+    for (size_t y = 0; y < tmpl.height; ++y)
+        for (size_t x = 0; x < tmpl.width; ++x)
+            tmpl.at(x, y) = src.at(x + 41, y + 13);
+    Image<f32> dst(src.width - tmpl.width + 1, src.height - tmpl.height + 1);
+    matchTemplateSqDiff(src.size(), src.data.data(), src.stride, tmpl.size(), tmpl.data.data(), tmpl.stride,
+                        &dst.at(0, 0), dst.stride, false);
+    CAROTENE_CHECK(dst.at(41, 13) == 0);
+    matchTemplate(src.size(), src.data.data(), src.stride, tmpl.size(), tmpl.data.data(), tmpl.stride,
+                  &dst.at(0, 0), dst.stride, true);
+    CAROTENE_CHECK(std::fabs(dst.at(41, 13) - 1) < 1e-6);
+}
@@ -0,0 +1,157 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <algorithm>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+namespace {
+
+const size_t widths[] = { 1, 2, 5, 7, 15, 16, 17, 33, 64, 101 };
+
+// Median of the k x k window around (x, y) of the ROI at (ox, oy) in `src`, with the ROI
+// and `margin` pixels around it readable and the nearest readable pixel replicated beyond
+template <typename T>
+T refMedian(const Image<T> & src, size_t ox, size_t oy, const Size2D & roi, const Margin & margin,
+            int k, size_t x, size_t y, size_t c)
+{
+    std::vector<T> window;
+    for (int dy = -k / 2; dy <= k / 2; ++dy)
+        for (int dx = -k / 2; dx <= k / 2; ++dx)
+        {
+            ptrdiff_t sy = std::min(std::max((ptrdiff_t)y + dy, -(ptrdiff_t)margin.top), (ptrdiff_t)(roi.height + margin.bottom) - 1);
+            ptrdiff_t sx = std::min(std::max((ptrdiff_t)x + dx, -(ptrdiff_t)margin.left), (ptrdiff_t)(roi.width + margin.right) - 1);
+            window.push_back(src.at(ox + sx, oy + sy, c));
+        }
+    std::nth_element(window.begin(), window.begin() + window.size() / 2, window.end());
+    return window[window.size() / 2];
+}
+
+template <typename T>
+void runMedian(int k, const Size2D & size, u32 cn, const T * src, ptrdiff_t srcStride,
+               const Margin & margin, T * dst, ptrdiff_t dstStride)
+{
+    if (k == 5)
+        medianFilter5x5(size, cn, src, srcStride, margin, dst, dstStride);
+    else
+        medianFilter7x7(size, cn, src, srcStride, margin, dst, dstStride);
+}
+
+// Filters the ROI at (ox, oy) of a larger random image, `margin` says how much of the
+// surroundings the filter may read
+template <typename T>
+bool checkMedian(int k, size_t width, size_t height, u32 cn, size_t ox, size_t oy, const Margin & margin,
+                 f64 hi, Rng & rng)
+{
+    Image<T> src(width + 8, height + 8, cn);
+    src.randomize(rng, 0, hi);
+    Image<T> dst(width, height, cn);
+    Size2D roi(width, height);
+
+    runMedian(k, roi, cn, &src.at(ox, oy), src.stride, margin, dst.row(0), dst.stride);
+
+    for (size_t y = 0; y < height; ++y)
+        for (size_t x = 0; x < width; ++x)
+            for (size_t c = 0; c < cn; ++c)
+                if (dst.at(x, y, c) != refMedian(src, ox, oy, roi, margin, k, x, y, c))
+                    return false;
+    return true;
+}
+
+template <typename T>
+void checkMedianSizes(int k, f64 hi, Rng & rng)
+{
+    const u32 channels[] = { 1, 3, 4 };
+    for (size_t wi = 0; wi < sizeof(widths) / sizeof(widths[0]); ++wi)
+        for (size_t ci = 0; ci < 3; ++ci)
+        {
+            size_t h = 1 + (wi * 3) % 9;
+            CAROTENE_CHECK(checkMedian<T>(k, widths[wi], h, channels[ci], 4, 4, Margin(), hi, rng));
+            // partial and full margins, the rest of the window is replicated
+            CAROTENE_CHECK(checkMedian<T>(k, widths[wi], h, channels[ci], 4, 4, Margin(1, 2, 2, 1), hi, rng));
+            CAROTENE_CHECK(checkMedian<T>(k, widths[wi], h, channels[ci], 4, 4, Margin(4, 4, 4, 4), hi, rng));
+        }
+}
+
+} // namespace
+
+CAROTENE_TEST(median5x5_u8)
+{
+    Rng rng(51);
+    checkMedianSizes<u8>(5, 255, rng);
+    // few distinct values, lots of ties
+    checkMedianSizes<u8>(5, 3, rng);
+}
+
+CAROTENE_TEST(median7x7_u8)
+{
+    Rng rng(52);
+    checkMedianSizes<u8>(7, 255, rng);
+    checkMedianSizes<u8>(7, 3, rng);
+}
+
+CAROTENE_TEST(median5x5_u16)
+{
+    Rng rng(53);
+    checkMedianSizes<u16>(5, 65535, rng);
+}
+
+CAROTENE_TEST(median7x7_u16)
+{
+    Rng rng(54);
+    checkMedianSizes<u16>(7, 65535, rng);
+}
+
+CAROTENE_TEST(median_inplace)
+{
+    Rng rng(55);
+    const int ks[] = { 5, 7 };
+    for (int ki = 0; ki < 2; ++ki)
+    {
+        Image<u8> img(37, 11, 3);
+        img.randomize(rng);
+        Image<u8> ref(37, 11, 3);
+        runMedian<u8>(ks[ki], img.size(), 3, img.row(0), img.stride, Margin(), ref.row(0), ref.stride);
+        runMedian<u8>(ks[ki], img.size(), 3, img.row(0), img.stride, Margin(), img.row(0), img.stride);
+        CAROTENE_CHECK(maxDiff(img, ref) == 0);
+    }
+}
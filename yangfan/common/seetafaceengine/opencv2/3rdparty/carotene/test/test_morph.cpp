@@ -0,0 +1,182 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <algorithm>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+namespace {
+
+const BORDER_MODE morphBorders[] = {
+    BORDER_MODE_UNDEFINED, BORDER_MODE_CONSTANT, BORDER_MODE_REPLICATE,
+    BORDER_MODE_REFLECT, BORDER_MODE_REFLECT101, BORDER_MODE_WRAP
+};
+
+// Naive erosion or dilation at ROI pixel (x, y), the borders apply to the full image
+u8 refMorph(const Image<u8> & full, s32 roiX, s32 roiY, s32 x, s32 y, s32 c,
+            const Size2D & ksize, s32 ax, s32 ay, BORDER_MODE rowBorder, BORDER_MODE colBorder,
+            const u8 * values, bool dilate)
+{
+    if (rowBorder == BORDER_MODE_UNDEFINED)
+        rowBorder = BORDER_MODE_REPLICATE;
+    if (colBorder == BORDER_MODE_UNDEFINED)
+        colBorder = BORDER_MODE_REPLICATE;
+    u8 acc = dilate ? 0 : 255;
+    for (s32 j = 0; j < (s32)ksize.height; ++j)
+        for (s32 i = 0; i < (s32)ksize.width; ++i)
+        {
+            s32 sx = roiX + x + i - ax, sy = roiY + y + j - ay;
+            bool outX = sx < 0 || sx >= (s32)full.width, outY = sy < 0 || sy >= (s32)full.height;
+            u8 v;
+            if ((outX && rowBorder == BORDER_MODE_CONSTANT) || (outY && colBorder == BORDER_MODE_CONSTANT))
+                v = values[c];
+            else
+                v = full.at(refBorder(sx, (s32)full.width, rowBorder), refBorder(sy, (s32)full.height, colBorder), c);
+            acc = dilate ? std::max(acc, v) : std::min(acc, v);
+        }
+    return acc;
+}
+
+bool checkMorph(const Image<u8> & full, s32 roiX, s32 roiY, const Image<u8> & dst,
+                const Size2D & ksize, s32 ax, s32 ay, BORDER_MODE rowBorder, BORDER_MODE colBorder,
+                const u8 * values, bool dilate)
+{
+    for (s32 y = 0; y < (s32)dst.height; ++y)
+        for (s32 x = 0; x < (s32)dst.width; ++x)
+            for (s32 c = 0; c < (s32)dst.channels; ++c)
+                if (dst.at(x, y, c) != refMorph(full, roiX, roiY, x, y, c, ksize, ax, ay, rowBorder, colBorder, values, dilate))
+                {
+                    std::cerr << "mismatch at (" << x << ", " << y << ", " << c << ") kernel " << ksize.width << "x"
+                              << ksize.height << " borders " << rowBorder << "/" << colBorder << std::endl;
+                    return false;
+                }
+    return true;
+}
+
+// Blocky random image, so that erosion and dilation do not saturate to the global extremes
+void blocks(Rng & rng, Image<u8> & img)
+{
+    img.randomize(rng);
+    for (size_t y = 0; y < img.height; ++y)
+        for (size_t x = 0; x < img.width * img.channels; ++x)
+            if (rng.next() % 4)
+                img.row(y)[x] = (u8)(img.row(y)[x] / 2 + 64);
+}
+
+} // namespace
+
+CAROTENE_TEST(erode3x3_dilate3x3)
+{
+    Rng rng(0x3e3d);
+    const Size2D sizes[] = { Size2D(1, 1), Size2D(5, 3), Size2D(16, 2), Size2D(37, 19) };
+    for (size_t si = 0; si < sizeof(sizes) / sizeof(sizes[0]); ++si)
+        for (size_t bi = 0; bi < sizeof(morphBorders) / sizeof(morphBorders[0]); ++bi)
+        {
+            const BORDER_MODE border = morphBorders[bi];
+            Image<u8> src(sizes[si].width, sizes[si].height), dst(sizes[si].width, sizes[si].height);
+            blocks(rng, src);
+            u8 value = (u8)(rng.next() & 0xFF);
+            CAROTENE_CHECK(isMorph3x3Supported(sizes[si], border));
+
+            erode3x3(sizes[si], src.data.data(), src.stride, dst.data.data(), dst.stride, border, value);
+            CAROTENE_CHECK(checkMorph(src, 0, 0, dst, Size2D(3, 3), 1, 1, border, border, &value, false));
+            dilate3x3(sizes[si], src.data.data(), src.stride, dst.data.data(), dst.stride, border, value);
+            CAROTENE_CHECK(checkMorph(src, 0, 0, dst, Size2D(3, 3), 1, 1, border, border, &value, true));
+        }
+}
+
+CAROTENE_TEST(erode_dilate_rectangles)
+{
+    Rng rng(0x9e1f);
+    const Size2D ksizes[] = {
+        Size2D(1, 1), Size2D(2, 1), Size2D(1, 5), Size2D(5, 5), Size2D(7, 3), Size2D(4, 6),
+        Size2D(15, 15), Size2D(21, 21), Size2D(30, 2)
+    };
+    const Size2D sizes[] = { Size2D(3, 2), Size2D(23, 17), Size2D(70, 41) };
+
+    for (size_t ki = 0; ki < sizeof(ksizes) / sizeof(ksizes[0]); ++ki)
+        for (size_t si = 0; si < sizeof(sizes) / sizeof(sizes[0]); ++si)
+            for (u32 cn = 1; cn <= 4; ++cn)
+            {
+                const Size2D ksize = ksizes[ki], size = sizes[si];
+                BORDER_MODE rowBorder = morphBorders[rng.next() % 6], colBorder = morphBorders[rng.next() % 6];
+                size_t ax = rng.next() % ksize.width, ay = rng.next() % ksize.height;
+                u8 values[4] = { 255, 0, 100, 200 };
+
+                Image<u8> src(size.width, size.height, cn), dst(size.width, size.height, cn);
+                blocks(rng, src);
+                bool dilateOp = (rng.next() & 1) != 0;
+                if (dilateOp)
+                    dilate(size, cn, src.data.data(), src.stride, dst.data.data(), dst.stride, ksize, ax, ay,
+                           rowBorder, colBorder, values, Margin());
+                else
+                    erode(size, cn, src.data.data(), src.stride, dst.data.data(), dst.stride, ksize, ax, ay,
+                          rowBorder, colBorder, values, Margin());
+                CAROTENE_CHECK(checkMorph(src, 0, 0, dst, ksize, (s32)ax, (s32)ay, rowBorder, colBorder, values, dilateOp));
+            }
+}
+
+CAROTENE_TEST(erode_dilate_margins)
+{
+    Rng rng(0x4a61);
+    const Size2D ksizes[] = { Size2D(3, 3), Size2D(9, 5), Size2D(5, 11) };
+    // ROIs of a 50x40 image: full, inner, and touching single sides
+    const s32 rois[][4] = { { 0, 0, 50, 40 }, { 6, 5, 35, 28 }, { 0, 9, 44, 31 }, { 20, 0, 30, 12 } };
+    Image<u8> full(50, 40, 2);
+    blocks(rng, full);
+    const u8 values[2] = { 7, 250 };
+
+    for (size_t ki = 0; ki < sizeof(ksizes) / sizeof(ksizes[0]); ++ki)
+        for (size_t ri = 0; ri < sizeof(rois) / sizeof(rois[0]); ++ri)
+            for (size_t bi = 0; bi < sizeof(morphBorders) / sizeof(morphBorders[0]); ++bi)
+            {
+                const s32 * roi = rois[ri];
+                const Size2D size(roi[2], roi[3]), ksize = ksizes[ki];
+                Margin margin(roi[0], 50 - roi[0] - roi[2], roi[1], 40 - roi[1] - roi[3]);
+                Image<u8> dst(size.width, size.height, 2);
+                const BORDER_MODE border = morphBorders[bi];
+                erode(size, 2, &full.at(roi[0], roi[1]), full.stride, dst.data.data(), dst.stride, ksize,
+                      ksize.width / 2, ksize.height / 2, border, border, values, margin);
+                CAROTENE_CHECK(checkMorph(full, roi[0], roi[1], dst, ksize, ksize.width / 2, ksize.height / 2,
+                                          border, border, values, false));
+            }
+}
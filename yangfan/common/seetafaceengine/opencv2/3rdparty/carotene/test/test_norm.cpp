@@ -0,0 +1,249 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <cmath>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+namespace {
+
+// Padded and unpadded images, the latter take the single long row path
+struct NormCase
+{
+    size_t width, height, pad;
+};
+
+const NormCase normCases[] = {
+    { 1, 1, 7 }, { 17, 3, 7 }, { 67, 5, 3 }, { 33, 7, 0 }, { 4099, 2, 0 }, { 1000, 9, 5 }
+};
+
+// 4K frames, the sums of squares no longer fit 32 bits there
+const size_t width4K = 3840, height4K = 2160;
+
+bool close(f64 a, f64 b)
+{
+    return std::abs(a - b) <= 1e-5 * std::max(1.0, std::max(std::abs(a), std::abs(b)));
+}
+
+s32 sat32(u64 v)
+{
+    return v > 0x7fFFffFFu ? 0x7fFFffFF : (s32)v;
+}
+
+template <typename T>
+void refNorms(const Image<T> & src0, const Image<T> & src1, bool diff, f64 & inf, f64 & l1, f64 & l2)
+{
+    inf = l1 = l2 = 0;
+    for (size_t y = 0; y < src0.height; ++y)
+        for (size_t x = 0; x < src0.width * src0.channels; ++x)
+        {
+            f64 v = (f64)src0.row(y)[x] - (diff ? (f64)src1.row(y)[x] : 0.0);
+            v = std::abs(v);
+            inf = std::max(inf, v);
+            l1 += v;
+            l2 += v * v;
+        }
+}
+
+template <typename T, typename RInf, typename RL1, typename RL2>
+bool checkNorms(Rng & rng, f64 lo, f64 hi)
+{
+    for (size_t ci = 0; ci < sizeof(normCases) / sizeof(normCases[0]); ++ci)
+    {
+        Image<T> src(normCases[ci].width, normCases[ci].height, 1, normCases[ci].pad);
+        src.randomize(rng, lo, hi);
+        f64 inf, l1, l2;
+        refNorms(src, src, false, inf, l1, l2);
+
+        RInf rInf = normInf(src.size(), src.data.data(), src.stride);
+        RL1 rL1 = normL1(src.size(), src.data.data(), src.stride);
+        RL2 rL2 = normL2(src.size(), src.data.data(), src.stride);
+        if (!close(rInf, inf) || !close(rL1, l1) || !close(rL2, l2))
+        {
+            std::cerr << "case " << ci << ": " << rInf << " " << rL1 << " " << rL2
+                      << " expected " << inf << " " << l1 << " " << l2 << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+CAROTENE_TEST(norm)
+{
+    Rng rng(0x4e0a);
+    CAROTENE_CHECK((checkNorms<u8, s32, s32, s32>(rng, 0, 255)));
+    CAROTENE_CHECK((checkNorms<s8, s32, s32, s32>(rng, -128, 127)));
+    CAROTENE_CHECK((checkNorms<u16, s32, s32, f64>(rng, 0, 65535)));
+    CAROTENE_CHECK((checkNorms<s16, s32, s32, f64>(rng, -32768, 32767)));
+    CAROTENE_CHECK((checkNorms<s32, s32, f64, f64>(rng, -2147483647.0, 2147483647.0)));
+    CAROTENE_CHECK((checkNorms<f32, f32, f64, f64>(rng, -1000, 1000)));
+
+    // the extremes, whose magnitude does not fit the signed type
+    Image<s8> s8min(19, 2);
+    std::fill(s8min.data.begin(), s8min.data.end(), (s8)-128);
+    CAROTENE_CHECK(normInf(s8min.size(), s8min.data.data(), s8min.stride) == 128);
+    CAROTENE_CHECK(normL1(s8min.size(), s8min.data.data(), s8min.stride) == 128 * 38);
+    CAROTENE_CHECK(normL2(s8min.size(), s8min.data.data(), s8min.stride) == 128 * 128 * 38);
+    Image<s16> s16min(19, 2);
+    std::fill(s16min.data.begin(), s16min.data.end(), (s16)-32768);
+    CAROTENE_CHECK(normInf(s16min.size(), s16min.data.data(), s16min.stride) == 32768);
+    CAROTENE_CHECK(normL2(s16min.size(), s16min.data.data(), s16min.stride) == 32768.0 * 32768.0 * 38);
+    Image<s32> s32min(9, 1);
+    std::fill(s32min.data.begin(), s32min.data.end(), (s32)0x80000000);
+    CAROTENE_CHECK(normInf(s32min.size(), s32min.data.data(), s32min.stride) == 0x7fFFffFF);
+    CAROTENE_CHECK(normL1(s32min.size(), s32min.data.data(), s32min.stride) == 2147483648.0 * 9);
+}
+
+CAROTENE_TEST(diffNorm)
+{
+    Rng rng(0xd1f0);
+    for (size_t ci = 0; ci < sizeof(normCases) / sizeof(normCases[0]); ++ci)
+    {
+        const NormCase & nc = normCases[ci];
+        Image<u8> a(nc.width, nc.height, 1, nc.pad), b(nc.width, nc.height, 1, nc.pad);
+        a.randomize(rng);
+        b.randomize(rng);
+        f64 inf, l1, l2;
+        refNorms(a, b, true, inf, l1, l2);
+        CAROTENE_CHECK(diffNormInf(a.size(), a.data.data(), a.stride, b.data.data(), b.stride) == inf);
+        CAROTENE_CHECK(diffNormL1(a.size(), a.data.data(), a.stride, b.data.data(), b.stride) == l1);
+        CAROTENE_CHECK(diffNormL2(a.size(), a.data.data(), a.stride, b.data.data(), b.stride) == l2);
+
+        Image<f32> fa(nc.width, nc.height, 1, nc.pad), fb(nc.width, nc.height, 1, nc.pad);
+        fa.randomize(rng, -100, 100);
+        fb.randomize(rng, -100, 100);
+        refNorms(fa, fb, true, inf, l1, l2);
+        CAROTENE_CHECK(close(diffNormInf(fa.size(), fa.data.data(), fa.stride, fb.data.data(), fb.stride), inf));
+        CAROTENE_CHECK(close(diffNormL1(fa.size(), fa.data.data(), fa.stride, fb.data.data(), fb.stride), l1));
+        CAROTENE_CHECK(close(diffNormL2(fa.size(), fa.data.data(), fa.stride, fb.data.data(), fb.stride), l2));
+    }
+
+    // with a padded and an unpadded source the rows cannot be merged
+    Image<u8> a(45, 4, 1, 0), b(45, 4, 1, 9);
+    a.randomize(rng);
+    b.randomize(rng);
+    f64 inf, l1, l2;
+    refNorms(a, b, true, inf, l1, l2);
+    CAROTENE_CHECK(diffNormL1(a.size(), a.data.data(), a.stride, b.data.data(), b.stride) == l1);
+}
+
+CAROTENE_TEST(norm_4K)
+{
+    Rng rng(0x4c4b);
+    Image<u8> a(width4K, height4K, 1, 0), b(width4K, height4K, 1, 0);
+    a.randomize(rng);
+    b.randomize(rng);
+    f64 inf, l1, l2;
+    refNorms(a, b, true, inf, l1, l2);
+    CAROTENE_CHECK(diffNormInf(a.size(), a.data.data(), a.stride, b.data.data(), b.stride) == inf);
+    CAROTENE_CHECK(diffNormL1(a.size(), a.data.data(), a.stride, b.data.data(), b.stride) == sat32((u64)l1));
+    CAROTENE_CHECK(diffNormL2(a.size(), a.data.data(), a.stride, b.data.data(), b.stride) == sat32((u64)l2));
+
+    // near constant frames keep the s32 results in range, the motion detector case
+    std::fill(b.data.begin(), b.data.end(), 0);
+    for (size_t i = 0; i < a.data.size(); ++i)
+        a.data[i] = (u8)(rng.next() % 3 == 0);
+    refNorms(a, b, true, inf, l1, l2);
+    CAROTENE_CHECK(l2 < 0x7fFFffFF);
+    CAROTENE_CHECK(diffNormL1(a.size(), a.data.data(), a.stride, b.data.data(), b.stride) == l1);
+    CAROTENE_CHECK(diffNormL2(a.size(), a.data.data(), a.stride, b.data.data(), b.stride) == l2);
+
+    Image<u16> w(width4K, height4K, 1, 0);
+    w.randomize(rng, 0, 65535);
+    refNorms(w, w, false, inf, l1, l2);
+    CAROTENE_CHECK(close(normL2(w.size(), w.data.data(), w.stride), l2));
+}
+
+CAROTENE_TEST(sum_sqsum)
+{
+    Rng rng(0x5053);
+    for (u32 cn = 1; cn <= 4; ++cn)
+    {
+        CAROTENE_CHECK(isSumSupported(cn) && isSqsumSupported(cn));
+        for (size_t ci = 0; ci < sizeof(normCases) / sizeof(normCases[0]); ++ci)
+        {
+            const NormCase & nc = normCases[ci];
+            Image<u8> src(nc.width, nc.height, cn, nc.pad);
+            Image<f32> fsrc(nc.width, nc.height, cn, nc.pad);
+            src.randomize(rng);
+            fsrc.randomize(rng, -50, 50);
+
+            u64 refSum[4] = { 0 }, refSqsum[4] = { 0 };
+            f64 refFsum[4] = { 0 };
+            for (size_t y = 0; y < src.height; ++y)
+                for (size_t x = 0; x < src.width; ++x)
+                    for (u32 c = 0; c < cn; ++c)
+                    {
+                        refSum[c] += src.at(x, y, c);
+                        refSqsum[c] += src.at(x, y, c) * src.at(x, y, c);
+                        refFsum[c] += fsrc.at(x, y, c);
+                    }
+
+            u32 sums[4];
+            f64 dsums[4], dsqsums[4], fsums[4];
+            sum(src.size(), src.data.data(), src.stride, sums, cn);
+            sqsum(src.size(), src.data.data(), src.stride, dsums, dsqsums, cn);
+            sum(fsrc.size(), fsrc.data.data(), fsrc.stride, fsums, cn);
+            for (u32 c = 0; c < cn; ++c)
+            {
+                CAROTENE_CHECK(sums[c] == refSum[c]);
+                CAROTENE_CHECK(dsums[c] == refSum[c] && dsqsums[c] == refSqsum[c]);
+                CAROTENE_CHECK(std::abs(fsums[c] - refFsum[c]) <= 1e-5 * std::max<f64>(1, nc.width * nc.height * 50));
+            }
+        }
+    }
+    CAROTENE_CHECK(!isSumSupported(0) && !isSumSupported(5));
+
+    Image<u8> big(width4K, height4K, 1, 0);
+    big.randomize(rng);
+    u64 refSum = 0, refSqsum = 0;
+    for (size_t i = 0; i < big.data.size() - 1; ++i)
+    {
+        refSum += big.data[i];
+        refSqsum += big.data[i] * big.data[i];
+    }
+    f64 dsum, dsqsum;
+    sqsum(big.size(), big.data.data(), big.stride, &dsum, &dsqsum, 1);
+    CAROTENE_CHECK(dsum == refSum && dsqsum == refSqsum);
+}
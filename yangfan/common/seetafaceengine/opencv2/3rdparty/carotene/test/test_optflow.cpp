@@ -0,0 +1,413 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <cfloat>
+#include <cmath>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+namespace {
+
+// Image with a readable border of `border` pixels around it, as pyrLKOptFlowLevel requires
+template <typename T>
+struct BorderedImage
+{
+    BorderedImage(size_t w, size_t h, size_t cn, size_t border) :
+        width(w), height(h), channels(cn), margin(border), full(w + 2 * border, h + 2 * border, cn)
+    {
+    }
+
+    T * origin() { return &full.at(margin, margin); }
+    const T * origin() const { return &full.at(margin, margin); }
+    ptrdiff_t stride() const { return full.stride; }
+    // x, y may be negative down to -margin
+    T & at(s32 x, s32 y, size_t c = 0) { return full.at(x + margin, y + margin, c); }
+    const T & at(s32 x, s32 y, size_t c = 0) const { return full.at(x + margin, y + margin, c); }
+
+    size_t width, height, channels, margin;
+    Image<T> full;
+};
+
+// Scharr derivatives of the whole bordered image but its outermost pixel, interleaved (dx, dy)
+BorderedImage<s16> scharr(const BorderedImage<u8> & src)
+{
+    BorderedImage<s16> d(src.width, src.height, src.channels * 2, src.margin);
+    s32 m = (s32)src.margin - 1, cn = (s32)src.channels;
+    for (s32 y = -m; y < (s32)src.height + m; ++y)
+        for (s32 x = -m; x < (s32)src.width + m; ++x)
+            for (s32 c = 0; c < cn; ++c)
+            {
+                s32 dx = 3 * (src.at(x + 1, y - 1, c) + src.at(x + 1, y + 1, c)) + 10 * src.at(x + 1, y, c) -
+                         3 * (src.at(x - 1, y - 1, c) + src.at(x - 1, y + 1, c)) - 10 * src.at(x - 1, y, c);
+                s32 dy = 3 * (src.at(x - 1, y + 1, c) + src.at(x + 1, y + 1, c)) + 10 * src.at(x, y + 1, c) -
+                         3 * (src.at(x - 1, y - 1, c) + src.at(x + 1, y - 1, c)) - 10 * src.at(x, y - 1, c);
+                d.at(x, y, c * 2) = (s16)dx;
+                d.at(x, y, c * 2 + 1) = (s16)dy;
+            }
+    return d;
+}
+
+struct LKParams
+{
+    Size2D winSize;
+    u32 iters;
+    f64 eps;
+    u32 level, maxLevel;
+    bool useInitialFlow, getMinEigenVals;
+    f32 minEig;
+};
+
+s32 descale(s32 v, s32 n) { return (v + (1 << (n - 1))) >> n; }
+
+// Scalar LKTrackerInvoker of cv::calcOpticalFlowPyrLK
+void refLK(const BorderedImage<u8> & I, const BorderedImage<s16> & dI, const BorderedImage<u8> & J,
+           u32 count, const f32 * prevPts, f32 * nextPts, u8 * status, f32 * err, const LKParams & p)
+{
+    const s32 W_BITS = 14, W_BITS1 = 14;
+    const f32 FLT_SCALE = 1.f / (1 << 20);
+    const s32 cn = (s32)I.channels, ww = (s32)p.winSize.width, wh = (s32)p.winSize.height;
+    const f32 hx = (ww - 1) * 0.5f, hy = (wh - 1) * 0.5f;
+    std::vector<s32> Iw(ww * wh * cn), dIw(ww * wh * cn * 2);
+
+    for (u32 pt = 0; pt < count; ++pt)
+    {
+        f32 s = 1.f / (1 << p.level);
+        f32 px = prevPts[pt * 2] * s, py = prevPts[pt * 2 + 1] * s, nx, ny;
+        if (p.level == p.maxLevel)
+        {
+            nx = p.useInitialFlow ? nextPts[pt * 2] * s : px;
+            ny = p.useInitialFlow ? nextPts[pt * 2 + 1] * s : py;
+        }
+        else
+        {
+            nx = nextPts[pt * 2] * 2.f;
+            ny = nextPts[pt * 2 + 1] * 2.f;
+        }
+        nextPts[pt * 2] = nx;
+        nextPts[pt * 2 + 1] = ny;
+
+        px -= hx;
+        py -= hy;
+        s32 ix = (s32)std::floor(px), iy = (s32)std::floor(py);
+        if (ix < -ww || ix >= (s32)I.width || iy < -wh || iy >= (s32)I.height)
+        {
+            if (p.level == 0)
+            {
+                status[pt] = 0;
+                err[pt] = 0;
+            }
+            continue;
+        }
+
+        f32 a = px - ix, b = py - iy;
+        s32 w00 = (s32)std::lrint((1.f - a) * (1.f - b) * (1 << W_BITS));
+        s32 w01 = (s32)std::lrint(a * (1.f - b) * (1 << W_BITS));
+        s32 w10 = (s32)std::lrint((1.f - a) * b * (1 << W_BITS));
+        s32 w11 = (1 << W_BITS) - w00 - w01 - w10;
+
+        s64 A11 = 0, A12 = 0, A22 = 0;
+        for (s32 y = 0; y < wh; ++y)
+            for (s32 x = 0; x < ww; ++x)
+                for (s32 c = 0; c < cn; ++c)
+                {
+                    s32 k = (y * ww + x) * cn + c;
+                    Iw[k] = descale(I.at(ix + x, iy + y, c) * w00 + I.at(ix + x + 1, iy + y, c) * w01 +
+                                    I.at(ix + x, iy + y + 1, c) * w10 + I.at(ix + x + 1, iy + y + 1, c) * w11,
+                                    W_BITS1 - 5);
+                    for (s32 d = 0; d < 2; ++d)
+                        dIw[k * 2 + d] = descale(dI.at(ix + x, iy + y, c * 2 + d) * w00 +
+                                                 dI.at(ix + x + 1, iy + y, c * 2 + d) * w01 +
+                                                 dI.at(ix + x, iy + y + 1, c * 2 + d) * w10 +
+                                                 dI.at(ix + x + 1, iy + y + 1, c * 2 + d) * w11, W_BITS1);
+                    A11 += (s64)dIw[k * 2] * dIw[k * 2];
+                    A12 += (s64)dIw[k * 2] * dIw[k * 2 + 1];
+                    A22 += (s64)dIw[k * 2 + 1] * dIw[k * 2 + 1];
+                }
+
+        f32 a11 = A11 * FLT_SCALE, a12 = A12 * FLT_SCALE, a22 = A22 * FLT_SCALE;
+        f32 D = a11 * a22 - a12 * a12;
+        f32 minEig = (a22 + a11 - std::sqrt((a11 - a22) * (a11 - a22) + 4.f * a12 * a12)) / (2 * ww * wh);
+        if (p.getMinEigenVals)
+            err[pt] = minEig;
+        if (minEig < p.minEig || D < FLT_EPSILON)
+        {
+            if (p.level == 0)
+                status[pt] = 0;
+            continue;
+        }
+        D = 1.f / D;
+
+        nx -= hx;
+        ny -= hy;
+        f32 pdx = 0, pdy = 0;
+        for (u32 j = 0; j < p.iters; ++j)
+        {
+            s32 jx = (s32)std::floor(nx), jy = (s32)std::floor(ny);
+            if (jx < -ww || jx >= (s32)J.width || jy < -wh || jy >= (s32)J.height)
+            {
+                if (p.level == 0)
+                    status[pt] = 0;
+                break;
+            }
+            a = nx - jx;
+            b = ny - jy;
+            w00 = (s32)std::lrint((1.f - a) * (1.f - b) * (1 << W_BITS));
+            w01 = (s32)std::lrint(a * (1.f - b) * (1 << W_BITS));
+            w10 = (s32)std::lrint((1.f - a) * b * (1 << W_BITS));
+            w11 = (1 << W_BITS) - w00 - w01 - w10;
+
+            s64 b1 = 0, b2 = 0;
+            for (s32 y = 0; y < wh; ++y)
+                for (s32 x = 0; x < ww; ++x)
+                    for (s32 c = 0; c < cn; ++c)
+                    {
+                        s32 k = (y * ww + x) * cn + c;
+                        s32 diff = descale(J.at(jx + x, jy + y, c) * w00 + J.at(jx + x + 1, jy + y, c) * w01 +
+                                           J.at(jx + x, jy + y + 1, c) * w10 + J.at(jx + x + 1, jy + y + 1, c) * w11,
+                                           W_BITS1 - 5) - Iw[k];
+                        b1 += (s64)diff * dIw[k * 2];
+                        b2 += (s64)diff * dIw[k * 2 + 1];
+                    }
+
+            f32 fb1 = b1 * FLT_SCALE, fb2 = b2 * FLT_SCALE;
+            f32 dx = (a12 * fb2 - a22 * fb1) * D, dy = (a12 * fb1 - a11 * fb2) * D;
+            nx += dx;
+            ny += dy;
+            nextPts[pt * 2] = nx + hx;
+            nextPts[pt * 2 + 1] = ny + hy;
+            if ((f64)dx * dx + (f64)dy * dy <= p.eps)
+                break;
+            if (j > 0 && std::fabs(dx + pdx) < 0.01f && std::fabs(dy + pdy) < 0.01f)
+            {
+                nextPts[pt * 2] -= dx * 0.5f;
+                nextPts[pt * 2 + 1] -= dy * 0.5f;
+                break;
+            }
+            pdx = dx;
+            pdy = dy;
+        }
+
+        if (status[pt] && p.level == 0 && !p.getMinEigenVals)
+        {
+            f32 x0 = nextPts[pt * 2] - hx, y0 = nextPts[pt * 2 + 1] - hy;
+            s32 jx = (s32)std::floor(x0), jy = (s32)std::floor(y0);
+            if (jx < -ww || jx >= (s32)J.width || jy < -wh || jy >= (s32)J.height)
+            {
+                status[pt] = 0;
+                continue;
+            }
+            a = x0 - jx;
+            b = y0 - jy;
+            w00 = (s32)std::lrint((1.f - a) * (1.f - b) * (1 << W_BITS));
+            w01 = (s32)std::lrint(a * (1.f - b) * (1 << W_BITS));
+            w10 = (s32)std::lrint((1.f - a) * b * (1 << W_BITS));
+            w11 = (1 << W_BITS) - w00 - w01 - w10;
+            f32 e = 0;
+            for (s32 y = 0; y < wh; ++y)
+            {
+                s32 rowSum = 0;
+                for (s32 x = 0; x < ww; ++x)
+                    for (s32 c = 0; c < cn; ++c)
+                    {
+                        s32 k = (y * ww + x) * cn + c;
+                        rowSum += std::abs(descale(J.at(jx + x, jy + y, c) * w00 + J.at(jx + x + 1, jy + y, c) * w01 +
+                                                   J.at(jx + x, jy + y + 1, c) * w10 +
+                                                   J.at(jx + x + 1, jy + y + 1, c) * w11, W_BITS1 - 5) - Iw[k]);
+                    }
+                e += (f32)rowSum;
+            }
+            err[pt] = e / (32 * ww * cn * wh);
+        }
+    }
+}
+
+// Smooth texture with enough structure in both directions for every window
+f64 texture(f64 x, f64 y)
+{
+    return 128 + 50 * std::sin(x * 0.21 + std::cos(y * 0.05)) * std::cos(y * 0.17) +
+           40 * std::sin((x + y) * 0.09) + 20 * std::cos(x * 0.05 - y * 0.13);
+}
+
+// Renders the texture shifted by (dx, dy) at pyramid level `level`, border included
+void render(BorderedImage<u8> & img, f64 dx, f64 dy, u32 level)
+{
+    f64 s = 1 << level;
+    s32 m = (s32)img.margin;
+    for (s32 y = -m; y < (s32)img.height + m; ++y)
+        for (s32 x = -m; x < (s32)img.width + m; ++x)
+            for (size_t c = 0; c < img.channels; ++c)
+                img.at(x, y, c) = (u8)std::floor(texture(x * s - dx + c * 3, y * s - dy - c * 5) + 0.5);
+}
+
+void randomPoints(Rng & rng, u32 count, const Size2D & size, std::vector<f32> & pts, f32 margin)
+{
+    pts.resize(count * 2);
+    for (u32 i = 0; i < count; ++i)
+    {
+        pts[i * 2] = rng.uniform(-margin, size.width + margin);
+        pts[i * 2 + 1] = rng.uniform(-margin, size.height + margin);
+    }
+}
+
+} // namespace
+
+CAROTENE_TEST(pyrLKOptFlowLevel_matches_reference)
+{
+    Rng rng(0x70f1);
+    const u8 channelList[] = { 1, 3 };
+    const Size2D winSizes[] = { Size2D(21, 21), Size2D(9, 7), Size2D(15, 5) };
+
+    for (size_t ci = 0; ci < sizeof(channelList); ++ci)
+        for (size_t wi = 0; wi < sizeof(winSizes) / sizeof(winSizes[0]); ++wi)
+            for (u32 level = 0; level < 2; ++level)
+            {
+                LKParams p = { winSizes[wi], 30, 0.0001, level, 1, level == 1, wi == 2, 1e-4f };
+                size_t border = p.winSize.width + 2;
+                BorderedImage<u8> I(97, 61, channelList[ci], border), J(97, 61, channelList[ci], border);
+                render(I, 0, 0, level);
+                render(J, 1.7, -0.6, level);
+                BorderedImage<s16> dI = scharr(I);
+
+                u32 count = 64;
+                std::vector<f32> prev, next, refNext;
+                // points partly outside the image exercise the early outs
+                randomPoints(rng, count, Size2D(97 << level, 61 << level), prev, 12.f * (1 << level));
+                next = prev;
+                for (u32 i = 0; i < count * 2; ++i)
+                    next[i] = (next[i] + (i & 1 ? -0.5f : 1.5f)) / (level == 1 ? 1 : 2);
+                refNext = next;
+
+                std::vector<u8> status(count, 1), refStatus(count, 1);
+                std::vector<f32> err(count, -1.f), refErr(count, -1.f);
+                pyrLKOptFlowLevel(Size2D(I.width, I.height), (s32)I.channels, I.origin(), I.stride(),
+                                  dI.origin(), dI.stride(), J.origin(), J.stride(), count, &prev[0], &next[0],
+                                  &status[0], &err[0], p.winSize, p.iters, p.eps, p.level, p.maxLevel,
+                                  p.useInitialFlow, p.getMinEigenVals, p.minEig);
+                refLK(I, dI, J, count, &prev[0], &refNext[0], &refStatus[0], &refErr[0], p);
+
+                for (u32 i = 0; i < count; ++i)
+                {
+                    CAROTENE_CHECK(status[i] == refStatus[i]);
+                    CAROTENE_CHECK(next[i * 2] == refNext[i * 2] && next[i * 2 + 1] == refNext[i * 2 + 1]);
+                    CAROTENE_CHECK(err[i] == refErr[i]);
+                }
+            }
+}
+
+CAROTENE_TEST(pyrLKOptFlowLevel_window_derivatives)
+{
+    Rng rng(0x5c4a);
+    for (s32 cn = 1; cn <= 3; cn += 2)
+    {
+        const Size2D winSize(12, 11);
+        BorderedImage<u8> I(80, 50, cn, 16), J(80, 50, cn, 16);
+        I.full.randomize(rng);
+        J.full.randomize(rng);
+        for (s32 y = -16; y < 66; ++y)
+            for (s32 x = -16; x < 96; ++x)
+                for (s32 c = 0; c < cn; ++c)
+                    J.at(x, y, c) = (u8)((I.at(x, y, c) * 3 + J.at(x, y, c)) / 4);
+        BorderedImage<s16> dI = scharr(I);
+
+        u32 count = 100;
+        std::vector<f32> prev;
+        randomPoints(rng, count, Size2D(80, 50), prev, 10.f);
+        std::vector<f32> next0 = prev, next1 = prev;
+        std::vector<u8> status0(count, 1), status1(count, 1);
+        std::vector<f32> err0(count), err1(count);
+
+        pyrLKOptFlowLevel(Size2D(80, 50), cn, I.origin(), I.stride(), dI.origin(), dI.stride(),
+                          J.origin(), J.stride(), count, &prev[0], &next0[0], &status0[0], &err0[0],
+                          winSize, 10, 0.01, 0, 0, false, false, 1e-4f);
+        pyrLKOptFlowLevel(Size2D(80, 50), cn, I.origin(), I.stride(), NULL, 0,
+                          J.origin(), J.stride(), count, &prev[0], &next1[0], &status1[0], &err1[0],
+                          winSize, 10, 0.01, 0, 0, false, false, 1e-4f);
+
+        for (u32 i = 0; i < count; ++i)
+        {
+            CAROTENE_CHECK(status0[i] == status1[i]);
+            CAROTENE_CHECK(next0[i * 2] == next1[i * 2] && next0[i * 2 + 1] == next1[i * 2 + 1]);
+            CAROTENE_CHECK(err0[i] == err1[i]);
+        }
+    }
+}
+
+CAROTENE_TEST(pyrLKOptFlowLevel_tracks_translation)
+{
+    Rng rng(0x7a11);
+    const f64 shifts[][2] = { { 0.3, -0.45 }, { 2.6, 1.25 }, { -4.75, 3.1 }, { 7.2, -6.4 } };
+    const Size2D size(160, 120), winSize(21, 21);
+    const u32 maxLevel = 1;
+
+    for (size_t si = 0; si < sizeof(shifts) / sizeof(shifts[0]); ++si)
+    {
+        u32 count = 40;
+        std::vector<f32> prev(count * 2), next(count * 2);
+        for (u32 i = 0; i < count; ++i)
+        {
+            prev[i * 2] = rng.uniform(20.f, size.width - 20.f);
+            prev[i * 2 + 1] = rng.uniform(20.f, size.height - 20.f);
+        }
+        std::vector<u8> status(count, 1);
+        std::vector<f32> err(count);
+
+        for (s32 level = maxLevel; level >= 0; --level)
+        {
+            Size2D lsize(size.width >> level, size.height >> level);
+            BorderedImage<u8> I(lsize.width, lsize.height, 1, winSize.width + 2);
+            BorderedImage<u8> J(lsize.width, lsize.height, 1, winSize.width + 2);
+            render(I, 0, 0, level);
+            render(J, shifts[si][0], shifts[si][1], level);
+
+            pyrLKOptFlowLevel(lsize, 1, I.origin(), I.stride(), NULL, 0, J.origin(), J.stride(),
+                              count, &prev[0], &next[0], &status[0], &err[0], winSize, 30, 0.0001,
+                              level, maxLevel, false, false, 1e-4f);
+        }
+
+        for (u32 i = 0; i < count; ++i)
+        {
+            CAROTENE_CHECK(status[i] == 1);
+            CAROTENE_CHECK(std::fabs(next[i * 2] - prev[i * 2] - shifts[si][0]) < 0.05);
+            CAROTENE_CHECK(std::fabs(next[i * 2 + 1] - prev[i * 2 + 1] - shifts[si][1]) < 0.05);
+        }
+    }
+}
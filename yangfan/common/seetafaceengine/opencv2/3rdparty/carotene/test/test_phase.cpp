@@ -0,0 +1,159 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+namespace {
+
+const size_t widths[] = { 1, 3, 4, 7, 8, 15, 16, 17, 33, 101 };
+
+// Exact angle of (x, y) in [0, 360) degrees
+f64 refAngle(f64 x, f64 y)
+{
+    f64 a = std::atan2(y, x) * 180.0 / M_PI;
+    return a < 0 ? a + 360.0 : a;
+}
+
+// Distance between two angles on the circle of `turn` units
+f64 angleDiff(f64 a, f64 b, f64 turn)
+{
+    f64 d = std::fabs(a - b);
+    return std::min(d, turn - d);
+}
+
+} // namespace
+
+CAROTENE_TEST(phase_f32_accuracy)
+{
+    // every direction at a fine step, over magnitudes from tiny to large
+    const size_t n = 360 * 64;
+    const f32 radii[] = { 1e-3f, 1.f, 3.5f, 1e4f };
+    Image<f32> x(n, 4), y(n, 4), deg(n, 4), rad(n, 4);
+    for (size_t r = 0; r < 4; ++r)
+        for (size_t k = 0; k < n; ++k)
+        {
+            f64 t = 2 * M_PI * k / n;
+            x.at(k, r) = (f32)(radii[r] * std::cos(t));
+            y.at(k, r) = (f32)(radii[r] * std::sin(t));
+        }
+    phase(x.size(), x.row(0), x.stride, y.row(0), y.stride, deg.row(0), deg.stride, 1.0f);
+    phase(x.size(), x.row(0), x.stride, y.row(0), y.stride, rad.row(0), rad.stride, (f32)(M_PI / 180));
+
+    f64 maxErr = 0, maxErrRad = 0;
+    for (size_t r = 0; r < 4; ++r)
+        for (size_t k = 0; k < n; ++k)
+        {
+            f64 ref = refAngle(x.at(k, r), y.at(k, r));
+            CAROTENE_CHECK(deg.at(k, r) >= 0.f && deg.at(k, r) <= 360.f);
+            maxErr = std::max(maxErr, angleDiff(deg.at(k, r), ref, 360.0));
+            maxErrRad = std::max(maxErrRad, angleDiff(rad.at(k, r), ref * M_PI / 180, 2 * M_PI));
+        }
+    // the bound documented in functions.hpp
+    CAROTENE_CHECK(maxErr < 0.01);
+    CAROTENE_CHECK(maxErrRad < 0.0002);
+
+    // the axes and the origin land on exact values
+    f32 ax[] = { 1.f, 0.f, -1.f, 0.f, 0.f }, ay[] = { 0.f, 1.f, 0.f, -1.f, 0.f }, aa[5];
+    phase(Size2D(5, 1), ax, sizeof(ax), ay, sizeof(ay), aa, sizeof(aa), 1.0f);
+    CAROTENE_CHECK(aa[0] == 0.f && aa[1] == 90.f && aa[2] == 180.f && aa[3] == 270.f && aa[4] == 0.f);
+}
+
+CAROTENE_TEST(phase_s16)
+{
+    Rng rng(81);
+    for (size_t wi = 0; wi < sizeof(widths) / sizeof(widths[0]); ++wi)
+    {
+        Image<s16> x(widths[wi], 5), y(widths[wi], 5);
+        Image<u8> orient(widths[wi], 5);
+        x.randomize(rng, -1020, 1020);
+        y.randomize(rng, -1020, 1020);
+        phase(x.size(), x.row(0), x.stride, y.row(0), y.stride, orient.row(0), orient.stride);
+        for (size_t i = 0; i < x.height; ++i)
+            for (size_t j = 0; j < x.width; ++j)
+            {
+                // rounding to 256 units per turn, ties may go either way within the bound
+                f64 ref = refAngle(x.at(j, i), y.at(j, i)) * 256.0 / 360.0;
+                CAROTENE_CHECK(angleDiff(orient.at(j, i), ref, 256.0) <= 0.5 + 0.01 * 256.0 / 360.0);
+            }
+    }
+}
+
+CAROTENE_TEST(magnitudePhase)
+{
+    Rng rng(82);
+    for (size_t wi = 0; wi < sizeof(widths) / sizeof(widths[0]); ++wi)
+    {
+        Image<f32> x(widths[wi], 4), y(widths[wi], 4), mag(widths[wi], 4), orient(widths[wi], 4);
+        Image<f32> refOrient(widths[wi], 4);
+        x.randomize(rng, -300, 300);
+        y.randomize(rng, -300, 300);
+        magnitudePhase(x.size(), x.row(0), x.stride, y.row(0), y.stride,
+                       mag.row(0), mag.stride, orient.row(0), orient.stride, 1.0f);
+        phase(x.size(), x.row(0), x.stride, y.row(0), y.stride, refOrient.row(0), refOrient.stride, 1.0f);
+        // the same approximation, whatever part of the row a pixel falls in
+        CAROTENE_CHECK(maxDiff(orient, refOrient) == 0);
+        for (size_t i = 0; i < x.height; ++i)
+            for (size_t j = 0; j < x.width; ++j)
+            {
+                f64 ref = std::sqrt((f64)x.at(j, i) * x.at(j, i) + (f64)y.at(j, i) * y.at(j, i));
+                CAROTENE_CHECK(std::fabs(mag.at(j, i) - ref) <= 1e-5 * ref + 1e-6);
+            }
+
+        Image<s16> dx(widths[wi], 3), dy(widths[wi], 3);
+        Image<f32> dmag(widths[wi], 3), dorient(widths[wi], 3);
+        dx.randomize(rng, -32768, 32767);
+        dy.randomize(rng, -32768, 32767);
+        magnitudePhase(dx.size(), dx.row(0), dx.stride, dy.row(0), dy.stride,
+                       dmag.row(0), dmag.stride, dorient.row(0), dorient.stride, 1.0f);
+        for (size_t i = 0; i < dx.height; ++i)
+            for (size_t j = 0; j < dx.width; ++j)
+            {
+                f64 ref = std::sqrt((f64)dx.at(j, i) * dx.at(j, i) + (f64)dy.at(j, i) * dy.at(j, i));
+                CAROTENE_CHECK(std::fabs(dmag.at(j, i) - ref) <= 1e-5 * ref + 1e-6);
+                CAROTENE_CHECK(angleDiff(dorient.at(j, i), refAngle(dx.at(j, i), dy.at(j, i)), 360.0) < 0.01);
+            }
+    }
+}
@@ -0,0 +1,178 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <cmath>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+namespace {
+
+const u8 channelList[] = { 1, 3, 4 };
+
+// Tap of the pyramid filters, -1 for a constant border
+s32 pyrTap(s32 p, s32 len, BORDER_MODE mode)
+{
+    if (p >= 0 && p < len)
+        return p;
+    return mode == BORDER_MODE_CONSTANT ? -1 : refBorder(p, len, mode);
+}
+
+// 5x5 [1 4 6 4 1]^2 sum at (2x, 2y), in f64 to be exact for every type
+template <typename T>
+f64 pyrDownSum(const Image<T> & src, size_t x, size_t y, size_t c, BORDER_MODE mode, f64 value)
+{
+    static const f64 k[5] = { 1, 4, 6, 4, 1 };
+    f64 sum = 0;
+    for (s32 j = 0; j < 5; ++j)
+        for (s32 i = 0; i < 5; ++i)
+        {
+            s32 sx = pyrTap((s32)x * 2 + i - 2, (s32)src.width, mode);
+            s32 sy = pyrTap((s32)y * 2 + j - 2, (s32)src.height, mode);
+            f64 v = sx < 0 || sy < 0 ? value : (f64)src.at(sx, sy, c);
+            sum += k[i] * k[j] * v;
+        }
+    return sum;
+}
+
+// cv::pyrUp: reflect 101 on the left and top, replicate on the right and bottom
+template <typename T>
+f64 pyrUpSum(const Image<T> & src, size_t x, size_t y, size_t c)
+{
+    f64 sum = 0;
+    for (s32 j = -1; j <= 1; ++j)
+        for (s32 i = -1; i <= 1; ++i)
+        {
+            // output 2p uses taps p - 1, p, p + 1 with weights 1 6 1, output 2p + 1 taps p, p + 1 with 4 4
+            s32 px = (s32)x / 2, py = (s32)y / 2;
+            f64 wx = (x & 1) ? (i == -1 ? 0 : 4) : (i == 0 ? 6 : 1);
+            f64 wy = (y & 1) ? (j == -1 ? 0 : 4) : (j == 0 ? 6 : 1);
+            s32 sx = refBorder((px + i) * 2, (s32)src.width * 2, BORDER_MODE_REFLECT101) / 2;
+            s32 sy = refBorder((py + j) * 2, (s32)src.height * 2, BORDER_MODE_REFLECT101) / 2;
+            sum += wx * wy * src.at(sx, sy, c);
+        }
+    return sum;
+}
+
+} // namespace
+
+CAROTENE_TEST(gaussianPyramidDown)
+{
+    const size_t sizes[][4] = { { 64, 48, 32, 24 }, { 67, 45, 34, 23 }, { 67, 45, 33, 22 }, { 130, 17, 65, 9 }, { 5, 3, 3, 2 } };
+    Rng rng;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+        for (size_t k = 0; k < 3; ++k)
+        {
+            u8 cn = channelList[k];
+            Size2D ssize(sizes[i][0], sizes[i][1]), dsize(sizes[i][2], sizes[i][3]);
+
+            Image<u8> src8(ssize.width, ssize.height, cn), dst8(dsize.width, dsize.height, cn);
+            Image<s16> src16(ssize.width, ssize.height, cn), dst16(dsize.width, dsize.height, cn);
+            Image<f32> src32(ssize.width, ssize.height, cn), dst32(dsize.width, dsize.height, cn);
+            src8.randomize(rng);
+            src16.randomize(rng, -32768, 32767);
+            src32.randomize(rng, -1000, 1000);
+
+            CAROTENE_CHECK(isGaussianPyramidDownU8Supported(ssize, dsize, cn));
+            gaussianPyramidDown(ssize, &src8.data[0], src8.stride, dsize, &dst8.data[0], dst8.stride, cn);
+            gaussianPyramidDown(ssize, &src16.data[0], src16.stride, dsize, &dst16.data[0], dst16.stride, cn);
+            gaussianPyramidDown(ssize, &src32.data[0], src32.stride, dsize, &dst32.data[0], dst32.stride, cn);
+
+            for (size_t y = 0; y < dsize.height; ++y)
+                for (size_t x = 0; x < dsize.width; ++x)
+                    for (size_t c = 0; c < cn; ++c)
+                    {
+                        f64 sum8 = pyrDownSum(src8, x, y, c, BORDER_MODE_REFLECT101, 0);
+                        f64 sum16 = pyrDownSum(src16, x, y, c, BORDER_MODE_REFLECT101, 0);
+                        f64 sum32 = pyrDownSum(src32, x, y, c, BORDER_MODE_REFLECT101, 0);
+                        CAROTENE_CHECK(dst8.at(x, y, c) == (u8)(((s32)sum8 + 128) >> 8));
+                        CAROTENE_CHECK(dst16.at(x, y, c) == (s16)std::floor((sum16 + 128) / 256));
+                        CAROTENE_CHECK(std::fabs(dst32.at(x, y, c) - sum32 / 256) < 1e-3);
+                    }
+        }
+}
+
+CAROTENE_TEST(gaussianPyramidDownRTZ)
+{
+    const BORDER_MODE modes[] = { BORDER_MODE_CONSTANT, BORDER_MODE_REPLICATE, BORDER_MODE_REFLECT,
+                                  BORDER_MODE_REFLECT101, BORDER_MODE_WRAP };
+    Rng rng;
+    for (size_t b = 0; b < sizeof(modes) / sizeof(modes[0]); ++b)
+    {
+        Image<u8> src(75, 41), dst(38, 21);
+        src.randomize(rng);
+        u8 value = (u8)rng.next();
+        gaussianPyramidDownRTZ(src.size(), &src.data[0], src.stride, dst.size(), &dst.data[0], dst.stride,
+                               modes[b], value);
+        for (size_t y = 0; y < dst.height; ++y)
+            for (size_t x = 0; x < dst.width; ++x)
+                CAROTENE_CHECK(dst.at(x, y) == (u8)((s32)pyrDownSum(src, x, y, 0, modes[b], value) >> 8));
+    }
+}
+
+CAROTENE_TEST(gaussianPyramidUp)
+{
+    const size_t sizes[][2] = { { 32, 24 }, { 33, 17 }, { 1, 1 }, { 2, 3 }, { 70, 5 } };
+    Rng rng;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+        for (size_t k = 0; k < 3; ++k)
+        {
+            u8 cn = channelList[k];
+            Size2D ssize(sizes[i][0], sizes[i][1]), dsize(ssize.width * 2, ssize.height * 2);
+
+            Image<u8> src8(ssize.width, ssize.height, cn), dst8(dsize.width, dsize.height, cn);
+            Image<s16> src16(ssize.width, ssize.height, cn), dst16(dsize.width, dsize.height, cn);
+            src8.randomize(rng);
+            src16.randomize(rng, -32768, 32767);
+
+            CAROTENE_CHECK(isGaussianPyramidUpU8Supported(ssize, dsize, cn));
+            gaussianPyramidUp(ssize, &src8.data[0], src8.stride, dsize, &dst8.data[0], dst8.stride, cn);
+            gaussianPyramidUp(ssize, &src16.data[0], src16.stride, dsize, &dst16.data[0], dst16.stride, cn);
+
+            for (size_t y = 0; y < dsize.height; ++y)
+                for (size_t x = 0; x < dsize.width; ++x)
+                    for (size_t c = 0; c < cn; ++c)
+                    {
+                        CAROTENE_CHECK(dst8.at(x, y, c) == (u8)(((s32)pyrUpSum(src8, x, y, c) + 32) >> 6));
+                        CAROTENE_CHECK(dst16.at(x, y, c) == (s16)std::floor((pyrUpSum(src16, x, y, c) + 32) / 64));
+                    }
+        }
+}
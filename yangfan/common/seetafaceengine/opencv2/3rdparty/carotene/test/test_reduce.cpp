@@ -0,0 +1,108 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+namespace {
+
+const size_t widths[] = { 1, 3, 4, 7, 8, 15, 16, 17, 33, 101 };
+
+} // namespace
+
+CAROTENE_TEST(reduceCol_u8)
+{
+    Rng rng(91);
+    // 1000 rows of 255 pass the u16 partial sums several times
+    const size_t heights[] = { 1, 2, 256, 257, 258, 1000 };
+    for (size_t wi = 0; wi < sizeof(widths) / sizeof(widths[0]); ++wi)
+        for (size_t hi = 0; hi < 6; ++hi)
+        {
+            Image<u8> src(widths[wi], heights[hi]);
+            src.randomize(rng, hi == 5 ? 250 : 0, 255);
+            std::vector<s32> sum(src.width);
+            std::vector<u8> mx(src.width), mn(src.width);
+            reduceColSum(src.size(), src.row(0), src.stride, &sum[0]);
+            reduceColMax(src.size(), src.row(0), src.stride, &mx[0]);
+            reduceColMin(src.size(), src.row(0), src.stride, &mn[0]);
+            for (size_t j = 0; j < src.width; ++j)
+            {
+                s32 refSum = 0;
+                u8 refMax = 0, refMin = 255;
+                for (size_t i = 0; i < src.height; ++i)
+                {
+                    refSum += src.at(j, i);
+                    refMax = std::max(refMax, src.at(j, i));
+                    refMin = std::min(refMin, src.at(j, i));
+                }
+                CAROTENE_CHECK(sum[j] == refSum && mx[j] == refMax && mn[j] == refMin);
+            }
+        }
+}
+
+CAROTENE_TEST(reduceCol_f32)
+{
+    Rng rng(92);
+    for (size_t wi = 0; wi < sizeof(widths) / sizeof(widths[0]); ++wi)
+    {
+        Image<f32> src(widths[wi], 1 + wi * 7);
+        src.randomize(rng, -100, 100);
+        std::vector<f32> sum(src.width), mx(src.width), mn(src.width);
+        reduceColSum(src.size(), src.row(0), src.stride, &sum[0]);
+        reduceColMax(src.size(), src.row(0), src.stride, &mx[0]);
+        reduceColMin(src.size(), src.row(0), src.stride, &mn[0]);
+        for (size_t j = 0; j < src.width; ++j)
+        {
+            // summed in row order, like the kernel
+            f32 refSum = 0, refMax = src.at(j, 0), refMin = src.at(j, 0);
+            for (size_t i = 0; i < src.height; ++i)
+            {
+                refSum += src.at(j, i);
+                refMax = std::max(refMax, src.at(j, i));
+                refMin = std::min(refMin, src.at(j, i));
+            }
+            CAROTENE_CHECK(sum[j] == refSum && mx[j] == refMax && mn[j] == refMin);
+        }
+    }
+}
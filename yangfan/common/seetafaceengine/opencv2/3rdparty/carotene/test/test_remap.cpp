@@ -0,0 +1,141 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <cmath>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+namespace {
+
+// Camera style undistortion table: radial k1, k2 around the principal point, beyond the borders at the corners
+void undistortTable(Image<f32> & table, f64 k1, f64 k2)
+{
+    f64 cx = table.width / 2.0, cy = table.height / 2.0, f = table.width * 0.8;
+    for (size_t y = 0; y < table.height; ++y)
+        for (size_t x = 0; x < table.width; ++x)
+        {
+            f64 u = (x - cx) / f, v = (y - cy) / f, r2 = u * u + v * v;
+            f64 k = 1 + k1 * r2 + k2 * r2 * r2;
+            table.at(x, y, 0) = (f32)(cx + u * k * f);
+            table.at(x, y, 1) = (f32)(cy + v * k * f);
+        }
+}
+
+s32 roundHalfAway(f32 v)
+{
+    return (s32)std::floor(std::fabs(v) + 0.5f) * (v < 0 ? -1 : 1);
+}
+
+} // namespace
+
+CAROTENE_TEST(remapConvertMaps)
+{
+    Rng rng;
+    Image<f32> table(77, 13, 2);
+    for (size_t y = 0; y < table.height; ++y)
+        for (size_t x = 0; x < table.width * 2; ++x)
+            table.row(y)[x] = rng.uniform(-50.0f, 1200.0f);
+    // saturated coordinates
+    table.at(3, 2, 0) = 1e9f;
+    table.at(5, 7, 1) = -1e9f;
+
+    Image<s16> xy(77, 13, 2), nearest(77, 13, 2);
+    Image<u16> alpha(77, 13);
+    remapConvertMaps(table.size(), &table.data[0], table.stride, &xy.data[0], xy.stride, &alpha.data[0], alpha.stride);
+    remapConvertMaps(table.size(), &table.data[0], table.stride, &nearest.data[0], nearest.stride, NULL, 0);
+
+    for (size_t y = 0; y < table.height; ++y)
+        for (size_t x = 0; x < table.width; ++x)
+        {
+            s32 X = roundHalfAway(std::min(std::max(table.at(x, y, 0) * 32, -1e9f), 1e9f));
+            s32 Y = roundHalfAway(std::min(std::max(table.at(x, y, 1) * 32, -1e9f), 1e9f));
+            CAROTENE_CHECK(xy.at(x, y, 0) == sat16(X >> 5) && xy.at(x, y, 1) == sat16(Y >> 5));
+            CAROTENE_CHECK(alpha.at(x, y) == (u16)((Y & 31) * 32 + (X & 31)));
+            CAROTENE_CHECK(nearest.at(x, y, 0) == sat16(roundHalfAway(std::min(std::max(table.at(x, y, 0), -1e9f), 1e9f))));
+            CAROTENE_CHECK(nearest.at(x, y, 1) == sat16(roundHalfAway(std::min(std::max(table.at(x, y, 1), -1e9f), 1e9f))));
+        }
+}
+
+CAROTENE_TEST(remap)
+{
+    const size_t sizes[][2] = { { 64, 48 }, { 101, 67 }, { 17, 9 } };
+    Rng rng;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+        for (size_t b = 0; b < sizeof(borderModes) / sizeof(borderModes[0]); ++b)
+            for (int linear = 0; linear < 2; ++linear)
+            {
+                Image<u8> src(sizes[i][0], sizes[i][1]), dst(src.width, src.height), ref = dst, fixed = dst;
+                Image<f32> table(src.width, src.height, 2);
+                Image<s16> xy(src.width, src.height, 2);
+                Image<u16> alpha(src.width, src.height);
+                src.randomize(rng);
+                undistortTable(table, rng.uniform(0.1f, 0.4f), rng.uniform(0.0f, 0.2f));
+                u8 value = (u8)rng.next();
+
+                remapConvertMaps(table.size(), &table.data[0], table.stride, &xy.data[0], xy.stride,
+                                 linear ? &alpha.data[0] : NULL, alpha.stride);
+                if (linear)
+                {
+                    remapLinear(src.size(), dst.size(), &src.data[0], src.stride, &table.data[0], table.stride,
+                                &dst.data[0], dst.stride, borderModes[b], value);
+                    remapLinear(src.size(), dst.size(), &src.data[0], src.stride, &xy.data[0], xy.stride,
+                                &alpha.data[0], alpha.stride, &fixed.data[0], fixed.stride, borderModes[b], value);
+                }
+                else
+                {
+                    remapNearestNeighbor(src.size(), dst.size(), &src.data[0], src.stride, &table.data[0], table.stride,
+                                         &dst.data[0], dst.stride, borderModes[b], value);
+                    remapNearestNeighbor(src.size(), dst.size(), &src.data[0], src.stride, &xy.data[0], xy.stride,
+                                         &fixed.data[0], fixed.stride, borderModes[b], value);
+                }
+
+                for (size_t y = 0; y < dst.height; ++y)
+                    for (size_t x = 0; x < dst.width; ++x)
+                    {
+                        s32 X = roundHalfAway(table.at(x, y, 0) * (linear ? 32 : 1));
+                        s32 Y = roundHalfAway(table.at(x, y, 1) * (linear ? 32 : 1));
+                        ref.at(x, y) = refSample(src, X, Y, linear != 0, borderModes[b], value);
+                    }
+                CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+                CAROTENE_CHECK(maxDiff(fixed, ref) == 0);
+            }
+}
@@ -0,0 +1,308 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <cmath>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+namespace {
+
+const u32 channelList[] = { 1, 3, 4 };
+
+void refNearest(const Image<u8> & src, Image<u8> & dst, f32 wr, f32 hr)
+{
+    for (size_t y = 0; y < dst.height; ++y)
+    {
+        size_t sy = std::min((size_t)std::floor(y * (f64)hr), src.height - 1);
+        for (size_t x = 0; x < dst.width; ++x)
+        {
+            size_t sx = std::min((size_t)std::floor(x * (f64)wr), src.width - 1);
+            for (size_t c = 0; c < src.channels; ++c)
+                dst.at(x, y, c) = src.at(sx, sy, c);
+        }
+    }
+}
+
+// cv::resize INTER_AREA for integer factors: (sum + 2) >> 2 for 2x2, cvRound(sum / 16) for 4x4
+void refArea(const Image<u8> & src, Image<u8> & dst, size_t scale)
+{
+    for (size_t y = 0; y < dst.height; ++y)
+        for (size_t x = 0; x < dst.width; ++x)
+            for (size_t c = 0; c < src.channels; ++c)
+            {
+                u32 sum = 0;
+                for (size_t j = 0; j < scale; ++j)
+                    for (size_t i = 0; i < scale; ++i)
+                        sum += src.at(x * scale + i, y * scale + j, c);
+                dst.at(x, y, c) = scale == 2 ? (u8)((sum + 2) >> 2) : (u8)std::lrint(sum / 16.0);
+            }
+}
+
+// Float bilinear with pixel centers aligned and coordinates clamped to the image
+void refLinearFloat(const Image<u8> & src, Image<f32> & dst, f32 wr, f32 hr)
+{
+    for (size_t y = 0; y < dst.height; ++y)
+    {
+        f64 fy = std::min(std::max((y + 0.5) * hr - 0.5, 0.0), (f64)src.height - 1);
+        size_t y0 = std::min((size_t)fy, src.height - 2);
+        fy -= y0;
+        for (size_t x = 0; x < dst.width; ++x)
+        {
+            f64 fx = std::min(std::max((x + 0.5) * wr - 0.5, 0.0), (f64)src.width - 1);
+            size_t x0 = std::min((size_t)fx, src.width - 2);
+            fx -= x0;
+            for (size_t c = 0; c < src.channels; ++c)
+            {
+                f64 t = src.at(x0, y0, c) * (1 - fx) + src.at(x0 + 1, y0, c) * fx;
+                f64 b = src.at(x0, y0 + 1, c) * (1 - fx) + src.at(x0 + 1, y0 + 1, c) * fx;
+                dst.at(x, y, c) = (f32)(t * (1 - fy) + b * fy);
+            }
+        }
+    }
+}
+
+/*
+ * Scalar model of cv::resize INTER_LINEAR for u8: Q11 coefficients, a horizontal pass into
+ * s32 rows and OpenCV's vectorised vertical pass, whose first width - width % 8 columns
+ * (16 lane blocks, then 8 lane blocks while more than 8 remain) use the 16 bit arithmetic
+ * of VResizeLinearVec_32s8u and the tail the exact 32 bit formula.
+ */
+void refLinearOpenCV(const Image<u8> & src, Image<u8> & dst, f32 wr, f32 hr)
+{
+    const s32 one = 1 << 11;
+    size_t cn = src.channels, width = dst.width * cn;
+
+    std::vector<s32> xofs(dst.width);
+    std::vector<s32> alpha(dst.width * 2);
+    for (size_t x = 0; x < dst.width; ++x)
+    {
+        f32 fx = (f32)((x + 0.5) * wr - 0.5);
+        s32 sx = (s32)std::floor(fx);
+        fx -= sx;
+        if (sx < 0)
+        {
+            sx = 0;
+            fx = 0;
+        }
+        if (sx >= (s32)src.width - 1)
+        {
+            sx = (s32)src.width - 1;
+            fx = 0;
+        }
+        xofs[x] = sx;
+        alpha[x * 2] = (s32)std::lrint((1.f - fx) * one);
+        alpha[x * 2 + 1] = (s32)std::lrint(fx * one);
+    }
+
+    std::vector<s32> rows[2] = { std::vector<s32>(width), std::vector<s32>(width) };
+    for (size_t y = 0; y < dst.height; ++y)
+    {
+        f32 fy = (f32)((y + 0.5) * hr - 0.5);
+        s32 sy = (s32)std::floor(fy);
+        fy -= sy;
+        s32 beta[2] = { (s32)std::lrint((1.f - fy) * one), (s32)std::lrint(fy * one) };
+
+        for (int k = 0; k < 2; ++k)
+        {
+            const u8 * s = src.row(std::min(std::max(sy + k, 0), (s32)src.height - 1));
+            for (size_t x = 0; x < dst.width; ++x)
+                for (size_t c = 0; c < cn; ++c)
+                {
+                    s32 x0 = xofs[x], x1 = std::min(x0 + 1, (s32)src.width - 1);
+                    rows[k][x * cn + c] = s[x0 * cn + c] * alpha[x * 2] + s[x1 * cn + c] * alpha[x * 2 + 1];
+                }
+        }
+
+        size_t vec = 0;
+        while (vec + 16 <= width)
+            vec += 16;
+        while (vec + 8 < width)
+            vec += 8;
+
+        u8 * d = dst.row(y);
+        for (size_t x = 0; x < width; ++x)
+        {
+            s32 v;
+            if (x < vec)
+            {
+                s32 t0 = (sat16(rows[0][x] >> 4) * beta[0]) >> 16;
+                s32 t1 = (sat16(rows[1][x] >> 4) * beta[1]) >> 16;
+                v = (sat16(t0 + t1) + 2) >> 2;
+            }
+            else
+            {
+                v = (rows[0][x] * beta[0] + rows[1][x] * beta[1] + (1 << 21)) >> 22;
+            }
+            d[x] = (u8)std::min(std::max(v, 0), 255);
+        }
+    }
+}
+
+f64 maxDiffFloat(const Image<u8> & a, const Image<f32> & b)
+{
+    f64 diff = 0;
+    for (size_t y = 0; y < a.height; ++y)
+        for (size_t x = 0; x < a.width * a.channels; ++x)
+            diff = std::max(diff, std::fabs(a.row(y)[x] - (f64)b.row(y)[x]));
+    return diff;
+}
+
+} // namespace
+
+CAROTENE_TEST(resizeNearestNeighbor)
+{
+    const size_t sizes[][4] = {
+        { 64, 48, 32, 24 }, { 67, 45, 33, 22 }, { 128, 64, 32, 16 }, { 130, 66, 32, 16 },
+        { 40, 30, 120, 90 }, { 1920, 8, 1280, 4 }, { 37, 21, 50, 29 },
+    };
+    Rng rng;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+        for (size_t k = 0; k < 3; ++k)
+        {
+            u32 cn = channelList[k];
+            Image<u8> src(sizes[i][0], sizes[i][1], cn), dst(sizes[i][2], sizes[i][3], cn), ref = dst;
+            src.randomize(rng);
+            f32 wr = (f32)src.width / dst.width, hr = (f32)src.height / dst.height;
+            CAROTENE_CHECK(isResizeNearestNeighborSupported(src.size(), cn));
+            resizeNearestNeighbor(src.size(), dst.size(), &src.data[0], src.stride,
+                                  &dst.data[0], dst.stride, wr, hr, cn);
+            refNearest(src, ref, wr, hr);
+            CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+        }
+}
+
+CAROTENE_TEST(resizeAreaOpenCV)
+{
+    const size_t sizes[][2] = { { 64, 32 }, { 96, 40 }, { 200, 12 }, { 8, 8 }, { 1920, 8 } };
+    const size_t scales[] = { 2, 4 };
+    Rng rng;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+        for (size_t s = 0; s < 2; ++s)
+            for (size_t k = 0; k < 3; ++k)
+            {
+                u32 cn = channelList[k];
+                size_t scale = scales[s];
+                Image<u8> src(sizes[i][0], sizes[i][1], cn);
+                Image<u8> dst(src.width / scale, src.height / scale, cn), ref = dst;
+                src.randomize(rng);
+                resizeAreaOpenCV(src.size(), dst.size(), &src.data[0], src.stride,
+                                 &dst.data[0], dst.stride, (f32)scale, (f32)scale, cn);
+                refArea(src, ref, scale);
+                CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+            }
+}
+
+CAROTENE_TEST(resizeArea)
+{
+    const size_t scales[] = { 2, 4 };
+    Rng rng;
+    for (size_t s = 0; s < 2; ++s)
+        for (size_t k = 0; k < 3; ++k)
+        {
+            u32 cn = channelList[k];
+            size_t scale = scales[s];
+            Image<u8> src(160, 48, cn), dst(160 / scale, 48 / scale, cn), ref = dst;
+            src.randomize(rng);
+            resizeArea(src.size(), dst.size(), &src.data[0], src.stride,
+                       &dst.data[0], dst.stride, (f32)scale, (f32)scale, cn);
+            refArea(src, ref, scale);
+            CAROTENE_CHECK(maxDiff(dst, ref) <= 1);
+        }
+
+    // 0.5 replicates every source pixel into a 2x2 block
+    for (size_t k = 0; k < 3; ++k)
+    {
+        u32 cn = channelList[k];
+        Image<u8> src(37, 19, cn), dst(74, 38, cn), ref = dst;
+        src.randomize(rng);
+        resizeArea(src.size(), dst.size(), &src.data[0], src.stride,
+                   &dst.data[0], dst.stride, 0.5f, 0.5f, cn);
+        refNearest(src, ref, 0.5f, 0.5f);
+        CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+    }
+}
+
+CAROTENE_TEST(resizeLinearOpenCV)
+{
+    const size_t sizes[][4] = {
+        { 64, 48, 32, 24 }, { 1920, 12, 1280, 8 }, { 1920, 12, 960, 6 }, { 1920, 12, 640, 4 },
+        { 67, 45, 33, 22 }, { 40, 30, 120, 90 }, { 8, 8, 3, 3 }, { 100, 20, 103, 21 },
+    };
+    Rng rng;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+        for (size_t k = 0; k < 3; ++k)
+        {
+            u32 cn = channelList[k];
+            Image<u8> src(sizes[i][0], sizes[i][1], cn), dst(sizes[i][2], sizes[i][3], cn), ref = dst;
+            src.randomize(rng);
+            f32 wr = (f32)src.width / dst.width, hr = (f32)src.height / dst.height;
+            CAROTENE_CHECK(isResizeLinearOpenCVSupported(src.size(), dst.size(), cn));
+            resizeLinearOpenCV(src.size(), dst.size(), &src.data[0], src.stride,
+                               &dst.data[0], dst.stride, wr, hr, cn);
+            refLinearOpenCV(src, ref, wr, hr);
+            CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+        }
+}
+
+CAROTENE_TEST(resizeLinear)
+{
+    const size_t sizes[][4] = {
+        { 64, 48, 32, 24 }, { 128, 64, 32, 16 }, { 1920, 12, 1280, 8 }, { 67, 45, 33, 22 },
+        { 40, 30, 120, 90 }, { 9, 7, 3, 2 }, { 100, 20, 103, 21 },
+    };
+    Rng rng;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+        for (size_t k = 0; k < 3; ++k)
+        {
+            u32 cn = channelList[k];
+            Image<u8> src(sizes[i][0], sizes[i][1], cn), dst(sizes[i][2], sizes[i][3], cn);
+            Image<f32> ref(dst.width, dst.height, cn);
+            src.randomize(rng);
+            f32 wr = (f32)src.width / dst.width, hr = (f32)src.height / dst.height;
+            CAROTENE_CHECK(isResizeLinearSupported(src.size(), dst.size(), wr, hr, cn));
+            resizeLinear(src.size(), dst.size(), &src.data[0], src.stride,
+                         &dst.data[0], dst.stride, wr, hr, cn);
+            refLinearFloat(src, ref, wr, hr);
+            // Q8 weights plus the rounded 2x2 averages of the fast paths
+            CAROTENE_CHECK(maxDiffFloat(dst, ref) <= 1.5);
+        }
+}
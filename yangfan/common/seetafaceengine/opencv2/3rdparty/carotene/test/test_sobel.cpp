@@ -0,0 +1,282 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <cmath>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+namespace {
+
+const BORDER_MODE filterBorders[] = {
+    BORDER_MODE_UNDEFINED, BORDER_MODE_CONSTANT, BORDER_MODE_REPLICATE,
+    BORDER_MODE_REFLECT, BORDER_MODE_REFLECT101, BORDER_MODE_WRAP
+};
+
+const Size2D filterSizes[] = { Size2D(1, 1), Size2D(7, 2), Size2D(8, 1), Size2D(17, 5), Size2D(69, 13) };
+
+const s16 predefinedKernels[3][3] = { { 1, 2, 1 }, { -1, 0, 1 }, { 1, -2, 1 } };
+
+// Region of interest inside a larger image, the border applies to the larger one
+struct Roi
+{
+    s32 x, y;
+    Size2D size;
+
+    Margin margin(const Image<u8> & full) const
+    {
+        return Margin(x, full.width - size.width - x, y, full.height - size.height - y);
+    }
+};
+
+// 3x3 separable filter at ROI pixel (x, y), exact in s64
+s64 refFilter(const Image<u8> & full, const Roi & roi, s32 x, s32 y, const s16 * xw, const s16 * yw,
+              BORDER_MODE mode, u8 value)
+{
+    if (mode == BORDER_MODE_UNDEFINED)
+        mode = BORDER_MODE_REPLICATE;
+    s64 sum = 0;
+    for (s32 j = 0; j < 3; ++j)
+        for (s32 i = 0; i < 3; ++i)
+            sum += (s64)xw[i] * yw[j] * refPixel(full, roi.x + x + i - 1, roi.y + y + j - 1, mode, value);
+    return sum;
+}
+
+bool checkFilter(const Image<u8> & full, const Roi & roi, const Image<s16> & dst, size_t step, size_t offset,
+                 const s16 * xw, const s16 * yw, BORDER_MODE mode, u8 value)
+{
+    for (s32 y = 0; y < (s32)roi.size.height; ++y)
+        for (s32 x = 0; x < (s32)roi.size.width; ++x)
+            if (dst.row(y)[x * step + offset] != sat16(refFilter(full, roi, x, y, xw, yw, mode, value)))
+            {
+                std::cerr << "mismatch at (" << x << ", " << y << ") border " << mode << std::endl;
+                return false;
+            }
+    return true;
+}
+
+// ROIs touching every side of a 40x30 image, and one with no margin at all
+const Roi rois[] = {
+    { 0, 0, Size2D(40, 30) }, { 3, 2, Size2D(30, 25) }, { 0, 5, Size2D(17, 25) }, { 12, 0, Size2D(28, 9) }
+};
+
+} // namespace
+
+CAROTENE_TEST(SeparableFilter3x3)
+{
+    Rng rng(0x5e9a);
+    const s16 small[3] = { 3, -5, 2 }, large[3] = { -300, 1000, 200 }, largeY[3] = { 50, -20, 70 };
+
+    for (size_t si = 0; si < sizeof(filterSizes) / sizeof(filterSizes[0]); ++si)
+        for (size_t bi = 0; bi < sizeof(filterBorders) / sizeof(filterBorders[0]); ++bi)
+            for (u8 rowType = 0; rowType < 4; ++rowType)
+                for (u8 colType = 0; colType < 4; ++colType)
+                    for (int big = 0; big < 2; ++big)
+                    {
+                        if (big && (rowType != 3 || colType != 3))
+                            continue;
+                        const Size2D size = filterSizes[si];
+                        Image<u8> src(size.width, size.height);
+                        src.randomize(rng);
+                        Image<s16> dst(size.width, size.height);
+                        const s16 * xw = rowType == 3 ? (big ? large : small) : predefinedKernels[rowType];
+                        const s16 * yw = colType == 3 ? (big ? largeY : small) : predefinedKernels[colType];
+                        u8 value = (u8)(rng.next() & 0xFF);
+
+                        CAROTENE_CHECK(isSeparableFilter3x3Supported(size, filterBorders[bi], rowType, colType));
+                        SeparableFilter3x3(size, src.data.data(), src.stride, dst.data.data(), dst.stride,
+                                           rowType, colType, xw, yw, filterBorders[bi], value);
+                        Roi roi = { 0, 0, size };
+                        CAROTENE_CHECK(checkFilter(src, roi, dst, 1, 0, xw, yw, filterBorders[bi], value));
+                    }
+}
+
+CAROTENE_TEST(SeparableFilter3x3_margins)
+{
+    Rng rng(0x3a1c);
+    const s16 xw[3] = { 1, 4, -2 }, yw[3] = { -3, 1, 6 };
+    Image<u8> full(40, 30);
+    full.randomize(rng);
+
+    for (size_t ri = 0; ri < sizeof(rois) / sizeof(rois[0]); ++ri)
+        for (size_t bi = 0; bi < sizeof(filterBorders) / sizeof(filterBorders[0]); ++bi)
+        {
+            const Roi & roi = rois[ri];
+            Image<s16> dst(roi.size.width, roi.size.height);
+            SeparableFilter3x3(roi.size, &full.at(roi.x, roi.y), full.stride, dst.data.data(), dst.stride,
+                               3, 3, xw, yw, filterBorders[bi], 9, roi.margin(full));
+            CAROTENE_CHECK(checkFilter(full, roi, dst, 1, 0, xw, yw, filterBorders[bi], 9));
+        }
+}
+
+CAROTENE_TEST(Sobel3x3)
+{
+    Rng rng(0x50be);
+    for (size_t si = 0; si < sizeof(filterSizes) / sizeof(filterSizes[0]); ++si)
+        for (size_t bi = 0; bi < sizeof(filterBorders) / sizeof(filterBorders[0]); ++bi)
+            for (s32 dx = 0; dx < 3; ++dx)
+                for (s32 dy = 0; dy < 3; ++dy)
+                {
+                    const Size2D size = filterSizes[si];
+                    CAROTENE_CHECK(isSobel3x3Supported(size, filterBorders[bi], dx, dy) == (dx + dy > 0));
+                    if (dx + dy == 0)
+                        continue;
+                    Image<u8> src(size.width, size.height);
+                    src.randomize(rng);
+                    Image<s16> dst(size.width, size.height);
+                    Sobel3x3(size, src.data.data(), src.stride, dst.data.data(), dst.stride, dx, dy, filterBorders[bi], 200);
+                    Roi roi = { 0, 0, size };
+                    CAROTENE_CHECK(checkFilter(src, roi, dst, 1, 0, predefinedKernels[dx], predefinedKernels[dy],
+                                               filterBorders[bi], 200));
+                }
+}
+
+CAROTENE_TEST(Scharr3x3)
+{
+    Rng rng(0x5c4a);
+    const s16 smooth[3] = { 3, 10, 3 };
+    Image<u8> full(40, 30);
+    full.randomize(rng);
+
+    CAROTENE_CHECK(!isScharr3x3Supported(Size2D(16, 16), BORDER_MODE_REPLICATE, 1, 1));
+    for (size_t ri = 0; ri < sizeof(rois) / sizeof(rois[0]); ++ri)
+        for (size_t bi = 0; bi < sizeof(filterBorders) / sizeof(filterBorders[0]); ++bi)
+            for (s32 dx = 0; dx < 2; ++dx)
+            {
+                const Roi & roi = rois[ri];
+                Image<s16> dst(roi.size.width, roi.size.height);
+                Scharr3x3(roi.size, &full.at(roi.x, roi.y), full.stride, dst.data.data(), dst.stride,
+                          dx, 1 - dx, filterBorders[bi], 77, roi.margin(full));
+                CAROTENE_CHECK(checkFilter(full, roi, dst, 1, 0, dx ? predefinedKernels[1] : smooth,
+                                           dx ? smooth : predefinedKernels[1], filterBorders[bi], 77));
+            }
+}
+
+CAROTENE_TEST(Sobel3x3dXdY)
+{
+    Rng rng(0xd7d7);
+    const s16 sobel[3] = { 1, 2, 1 }, scharr[3] = { 3, 10, 3 }, * diff = predefinedKernels[1];
+    Image<u8> full(40, 30);
+    full.randomize(rng);
+
+    for (size_t ri = 0; ri < sizeof(rois) / sizeof(rois[0]); ++ri)
+        for (size_t bi = 0; bi < sizeof(filterBorders) / sizeof(filterBorders[0]); ++bi)
+        {
+            const Roi & roi = rois[ri];
+            Image<s16> dst(roi.size.width * 2, roi.size.height);
+            Sobel3x3dXdY(roi.size, &full.at(roi.x, roi.y), full.stride, dst.data.data(), dst.stride,
+                         filterBorders[bi], 13, roi.margin(full));
+            CAROTENE_CHECK(checkFilter(full, roi, dst, 2, 0, diff, sobel, filterBorders[bi], 13));
+            CAROTENE_CHECK(checkFilter(full, roi, dst, 2, 1, sobel, diff, filterBorders[bi], 13));
+
+            Scharr3x3dXdY(roi.size, &full.at(roi.x, roi.y), full.stride, dst.data.data(), dst.stride,
+                          filterBorders[bi], 13, roi.margin(full));
+            CAROTENE_CHECK(checkFilter(full, roi, dst, 2, 0, diff, scharr, filterBorders[bi], 13));
+            CAROTENE_CHECK(checkFilter(full, roi, dst, 2, 1, scharr, diff, filterBorders[bi], 13));
+        }
+}
+
+CAROTENE_TEST(ScharrDeriv)
+{
+    Rng rng(0xde71);
+    for (size_t si = 0; si < sizeof(filterSizes) / sizeof(filterSizes[0]); ++si)
+        for (s32 cn = 1; cn <= 4; ++cn)
+        {
+            const Size2D size = filterSizes[si];
+            Image<u8> src(size.width, size.height, cn);
+            src.randomize(rng);
+            Image<s16> dst(size.width, size.height, cn * 2);
+            ScharrDeriv(size, cn, src.data.data(), src.stride, dst.data.data(), dst.stride);
+
+            for (s32 y = 0; y < (s32)size.height; ++y)
+                for (s32 x = 0; x < (s32)size.width; ++x)
+                    for (s32 c = 0; c < cn; ++c)
+                    {
+                        s32 p[3][3];
+                        for (s32 j = 0; j < 3; ++j)
+                            for (s32 i = 0; i < 3; ++i)
+                                p[j][i] = src.at(refBorder(x + i - 1, (s32)size.width, BORDER_MODE_REFLECT101),
+                                                 refBorder(y + j - 1, (s32)size.height, BORDER_MODE_REFLECT101), c);
+                        s32 dx = 3 * (p[0][2] + p[2][2]) + 10 * p[1][2] - 3 * (p[0][0] + p[2][0]) - 10 * p[1][0];
+                        s32 dy = 3 * (p[2][0] + p[2][2]) + 10 * p[2][1] - 3 * (p[0][0] + p[0][2]) - 10 * p[0][1];
+                        CAROTENE_CHECK(dst.at(x, y, c * 2) == dx && dst.at(x, y, c * 2 + 1) == dy);
+                    }
+        }
+}
+
+CAROTENE_TEST(Sobel3x3_f32)
+{
+    Rng rng(0xf32f);
+    for (size_t si = 0; si < sizeof(filterSizes) / sizeof(filterSizes[0]); ++si)
+        for (size_t bi = 0; bi < sizeof(filterBorders) / sizeof(filterBorders[0]); ++bi)
+            for (s32 dx = 0; dx < 3; ++dx)
+                for (s32 dy = 0; dy < 3; ++dy)
+                {
+                    if (dx + dy == 0)
+                        continue;
+                    const Size2D size = filterSizes[si];
+                    const BORDER_MODE mode = filterBorders[bi];
+                    Image<f32> src(size.width, size.height), dst(size.width, size.height);
+                    src.randomize(rng, -100, 100);
+                    Sobel3x3(size, src.data.data(), src.stride, dst.data.data(), dst.stride, dx, dy, mode, 1.5f);
+
+                    Image<f32> inplace = src;
+                    Sobel3x3(size, inplace.data.data(), inplace.stride, inplace.data.data(), inplace.stride, dx, dy, mode, 1.5f);
+                    CAROTENE_CHECK(maxDiff(dst, inplace) == 0);
+
+                    BORDER_MODE refMode = mode == BORDER_MODE_UNDEFINED ? BORDER_MODE_REPLICATE : mode;
+                    for (s32 y = 0; y < (s32)size.height; ++y)
+                        for (s32 x = 0; x < (s32)size.width; ++x)
+                        {
+                            f64 sum = 0;
+                            for (s32 j = 0; j < 3; ++j)
+                                for (s32 i = 0; i < 3; ++i)
+                                {
+                                    s32 sx = x + i - 1, sy = y + j - 1;
+                                    bool inside = sx >= 0 && sy >= 0 && sx < (s32)size.width && sy < (s32)size.height;
+                                    f64 v = !inside && refMode == BORDER_MODE_CONSTANT ? 1.5 :
+                                        src.at(refBorder(sx, (s32)size.width, refMode), refBorder(sy, (s32)size.height, refMode));
+                                    sum += predefinedKernels[dx][i] * predefinedKernels[dy][j] * v;
+                                }
+                            CAROTENE_CHECK(std::fabs(dst.at(x, y) - sum) < 1e-3);
+                        }
+                }
+}
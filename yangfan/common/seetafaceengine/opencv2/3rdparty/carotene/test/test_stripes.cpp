@@ -0,0 +1,150 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+/*
+ * The tegra HAL runs the neighborhood filters in row stripes and passes the rows around
+ * every stripe as margin. These tests check that contract: any split of the rows gives
+ * exactly the output of a single call over the whole image.
+ */
+
+namespace {
+
+// A whole image call and a striped one over the rows [top, top + height) of `src`
+template <typename T, typename D, typename Filter>
+bool stripesMatch(const Image<T> & src, size_t top, size_t height, size_t stripes, size_t dstChannels, Filter filter)
+{
+    const Margin margin(0, 0, top, src.height - top - height);
+    Image<D> whole(src.width, height, dstChannels), striped = whole;
+    filter(Size2D(src.width, height), src.row(top), &whole.at(0, 0), whole.stride, margin);
+
+    for (size_t s = 0; s < stripes; ++s)
+    {
+        size_t start = height * s / stripes, end = height * (s + 1) / stripes;
+        filter(Size2D(src.width, end - start), src.row(top + start), &striped.at(0, start), striped.stride,
+               Margin(0, 0, margin.top + start, margin.bottom + height - end));
+    }
+    return maxDiff(whole, striped) == 0;
+}
+
+const BORDER_MODE borders[] = {
+    BORDER_MODE_CONSTANT, BORDER_MODE_REPLICATE, BORDER_MODE_REFLECT, BORDER_MODE_REFLECT101
+};
+
+struct SobelDx
+{
+    BORDER_MODE border;
+    ptrdiff_t srcStride;
+    void operator()(const Size2D & size, const u8 * src, s16 * dst, ptrdiff_t dstStride, const Margin & margin) const
+    {
+        Sobel3x3(size, src, srcStride, dst, dstStride, 1, 0, border, 0, margin);
+    }
+};
+
+struct CustomSeparable
+{
+    BORDER_MODE border;
+    ptrdiff_t srcStride;
+    void operator()(const Size2D & size, const u8 * src, s16 * dst, ptrdiff_t dstStride, const Margin & margin) const
+    {
+        const s16 xw[3] = { 3, -7, 2 }, yw[3] = { 1, 4, -1 };
+        SeparableFilter3x3(size, src, srcStride, dst, dstStride, 3, 3, xw, yw, border, 9, margin);
+    }
+};
+
+struct Morph5x3
+{
+    BORDER_MODE border;
+    ptrdiff_t srcStride;
+    bool dilation;
+    void operator()(const Size2D & size, const u8 * src, u8 * dst, ptrdiff_t dstStride, const Margin & margin) const
+    {
+        const u8 borderValues[3] = { 7, 100, 250 };
+        if (dilation)
+            dilate(size, 3, src, srcStride, dst, dstStride, Size2D(5, 3), 1, 2, border, border, borderValues, margin);
+        else
+            erode(size, 3, src, srcStride, dst, dstStride, Size2D(5, 3), 1, 2, border, border, borderValues, margin);
+    }
+};
+
+struct Gaussian5x5
+{
+    BORDER_MODE border;
+    ptrdiff_t srcStride;
+    void operator()(const Size2D & size, const u8 * src, u8 * dst, ptrdiff_t dstStride, const Margin & margin) const
+    {
+        gaussianBlur5x5(size, 3, src, srcStride, dst, dstStride, border, 31, margin);
+    }
+};
+
+} // namespace
+
+CAROTENE_TEST(stripes)
+{
+    Rng rng;
+    Image<u8> gray(67, 90), color(45, 70, 3);
+    gray.randomize(rng, 0, 255);
+    color.randomize(rng, 0, 255);
+
+    const size_t stripeCounts[] = { 2, 3, 7 };
+    for (size_t bi = 0; bi < sizeof(borders) / sizeof(borders[0]); ++bi)
+        for (size_t si = 0; si < sizeof(stripeCounts) / sizeof(stripeCounts[0]); ++si)
+        {
+            const size_t n = stripeCounts[si];
+            SobelDx sobel = { borders[bi], (ptrdiff_t)gray.stride };
+            CustomSeparable separable = { borders[bi], (ptrdiff_t)gray.stride };
+            Morph5x3 erosion = { borders[bi], (ptrdiff_t)color.stride, false };
+            Morph5x3 dilation = { borders[bi], (ptrdiff_t)color.stride, true };
+            Gaussian5x5 gaussian = { borders[bi], (ptrdiff_t)color.stride };
+
+            // the whole image, and an ROI with real rows above and below it
+            CAROTENE_CHECK((stripesMatch<u8, s16>(gray, 0, gray.height, n, 1, sobel)));
+            CAROTENE_CHECK((stripesMatch<u8, s16>(gray, 5, 70, n, 1, sobel)));
+            CAROTENE_CHECK((stripesMatch<u8, s16>(gray, 0, gray.height, n, 1, separable)));
+            CAROTENE_CHECK((stripesMatch<u8, s16>(gray, 1, 88, n, 1, separable)));
+            CAROTENE_CHECK((stripesMatch<u8, u8>(color, 0, color.height, n, 3, erosion)));
+            CAROTENE_CHECK((stripesMatch<u8, u8>(color, 3, 60, n, 3, dilation)));
+            CAROTENE_CHECK((stripesMatch<u8, u8>(color, 0, color.height, n, 3, gaussian)));
+            CAROTENE_CHECK((stripesMatch<u8, u8>(color, 2, 66, n, 3, gaussian)));
+        }
+}
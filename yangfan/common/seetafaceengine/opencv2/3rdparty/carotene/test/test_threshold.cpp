@@ -0,0 +1,213 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <limits>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+namespace {
+
+enum ThresholdMode { BINARY, BINARY_INV, TRUNCATE, TO_ZERO, TO_ZERO_INV, MODE_COUNT };
+
+const size_t widths[] = { 1, 3, 7, 8, 15, 16, 17, 31, 33, 67 };
+
+template <typename T>
+T refThreshold(ThresholdMode mode, T src, T threshold, T value)
+{
+    switch (mode)
+    {
+    case BINARY:      return src > threshold ? value : 0;
+    case BINARY_INV:  return src > threshold ? 0 : value;
+    case TRUNCATE:    return src > threshold ? threshold : src;
+    case TO_ZERO:     return src > threshold ? src : 0;
+    default:          return src > threshold ? 0 : src;
+    }
+}
+
+template <typename T>
+void runThreshold(ThresholdMode mode, const Image<T> & src, Image<T> & dst, T threshold, T value)
+{
+    // the u8 overload with trueValue and falseValue defaults makes a direct call ambiguous
+    void (*binary)(const Size2D &, const T *, ptrdiff_t, T *, ptrdiff_t, T, T) = thresholdBinary;
+    switch (mode)
+    {
+    case BINARY:
+        binary(src.size(), src.data.data(), src.stride, dst.data.data(), dst.stride, threshold, value);
+        break;
+    case BINARY_INV:
+        thresholdBinaryInv(src.size(), src.data.data(), src.stride, dst.data.data(), dst.stride, threshold, value);
+        break;
+    case TRUNCATE:
+        thresholdTruncate(src.size(), src.data.data(), src.stride, dst.data.data(), dst.stride, threshold);
+        break;
+    case TO_ZERO:
+        thresholdToZero(src.size(), src.data.data(), src.stride, dst.data.data(), dst.stride, threshold);
+        break;
+    default:
+        thresholdToZeroInv(src.size(), src.data.data(), src.stride, dst.data.data(), dst.stride, threshold);
+        break;
+    }
+}
+
+// Equality that also holds for two NaNs
+template <typename T>
+bool same(T a, T b)
+{
+    return a == b || (a != a && b != b);
+}
+
+template <typename T>
+bool checkThreshold(Rng & rng, f64 lo, f64 hi)
+{
+    for (size_t wi = 0; wi < sizeof(widths) / sizeof(widths[0]); ++wi)
+    {
+        Image<T> src(widths[wi], 3), dst(widths[wi], 3);
+        src.randomize(rng, lo, hi);
+        if (std::numeric_limits<T>::has_quiet_NaN)
+            src.at(widths[wi] - 1, 0) = std::numeric_limits<T>::quiet_NaN();
+        // thresholds taken from the image so that the equality case is hit
+        const T threshold = src.at(widths[wi] / 2, 1), value = src.at(0, 2);
+        for (s32 m = 0; m < MODE_COUNT; ++m)
+        {
+            const ThresholdMode mode = (ThresholdMode)m;
+            std::fill(dst.data.begin(), dst.data.end(), T(1));
+            runThreshold(mode, src, dst, threshold, value);
+            for (size_t y = 0; y < src.height; ++y)
+                for (size_t x = 0; x < src.width; ++x)
+                    if (!same(dst.at(x, y), refThreshold(mode, src.at(x, y), threshold, value)))
+                    {
+                        std::cerr << "mismatch at (" << x << ", " << y << ") width " << src.width
+                                  << " mode " << m << std::endl;
+                        return false;
+                    }
+            // the row padding must stay untouched
+            if (dst.row(0)[src.width] != T(1))
+                return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+bool checkCompare(Rng & rng, f64 lo, f64 hi)
+{
+    for (size_t wi = 0; wi < sizeof(widths) / sizeof(widths[0]); ++wi)
+    {
+        Image<T> src0(widths[wi], 3), src1(widths[wi], 3);
+        Image<u8> dst(widths[wi], 3);
+        src0.randomize(rng, lo, hi);
+        src1.randomize(rng, lo, hi);
+        for (size_t x = 0; x < widths[wi]; x += 3)
+            src1.at(x, 1) = src0.at(x, 1);
+        for (s32 op = 0; op < 4; ++op)
+        {
+            if (op == 0)
+                cmpEQ(src0.size(), src0.data.data(), src0.stride, src1.data.data(), src1.stride, dst.data.data(), dst.stride);
+            else if (op == 1)
+                cmpNE(src0.size(), src0.data.data(), src0.stride, src1.data.data(), src1.stride, dst.data.data(), dst.stride);
+            else if (op == 2)
+                cmpGT(src0.size(), src0.data.data(), src0.stride, src1.data.data(), src1.stride, dst.data.data(), dst.stride);
+            else
+                cmpGE(src0.size(), src0.data.data(), src0.stride, src1.data.data(), src1.stride, dst.data.data(), dst.stride);
+            for (size_t y = 0; y < dst.height; ++y)
+                for (size_t x = 0; x < dst.width; ++x)
+                {
+                    const T a = src0.at(x, y), b = src1.at(x, y);
+                    const bool ref = op == 0 ? a == b : op == 1 ? a != b : op == 2 ? a > b : a >= b;
+                    if (dst.at(x, y) != (ref ? 255 : 0))
+                    {
+                        std::cerr << "mismatch at (" << x << ", " << y << ") width " << dst.width
+                                  << " op " << op << std::endl;
+                        return false;
+                    }
+                }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+CAROTENE_TEST(threshold)
+{
+    Rng rng(0x7e5d);
+    CAROTENE_CHECK(checkThreshold<u8>(rng, 0, 255));
+    CAROTENE_CHECK(checkThreshold<s8>(rng, -128, 127));
+    CAROTENE_CHECK(checkThreshold<u16>(rng, 0, 65535));
+    CAROTENE_CHECK(checkThreshold<s16>(rng, -32768, 32767));
+    CAROTENE_CHECK(checkThreshold<s32>(rng, -3e9 / 2, 3e9 / 2));
+    CAROTENE_CHECK(checkThreshold<f32>(rng, -1000, 1000));
+}
+
+CAROTENE_TEST(thresholdBinary_thresholdRange)
+{
+    Rng rng(0x7a6e);
+    for (size_t wi = 0; wi < sizeof(widths) / sizeof(widths[0]); ++wi)
+    {
+        Image<u8> src(widths[wi], 3), dst(widths[wi], 3);
+        src.randomize(rng);
+        const u8 lower = src.at(0, 1), upper = src.at(widths[wi] / 2, 2), trueValue = 200, falseValue = 17;
+
+        thresholdBinary(src.size(), src.data.data(), src.stride, dst.data.data(), dst.stride,
+                        lower, trueValue, falseValue);
+        for (size_t y = 0; y < src.height; ++y)
+            for (size_t x = 0; x < src.width; ++x)
+                CAROTENE_CHECK(dst.at(x, y) == (src.at(x, y) > lower ? trueValue : falseValue));
+
+        thresholdRange(src.size(), src.data.data(), src.stride, dst.data.data(), dst.stride,
+                       lower, upper, trueValue, falseValue);
+        for (size_t y = 0; y < src.height; ++y)
+            for (size_t x = 0; x < src.width; ++x)
+                CAROTENE_CHECK(dst.at(x, y) == (lower <= src.at(x, y) && src.at(x, y) <= upper ? trueValue : falseValue));
+    }
+}
+
+CAROTENE_TEST(compare)
+{
+    Rng rng(0xc3b1);
+    CAROTENE_CHECK(checkCompare<u8>(rng, 0, 255));
+    CAROTENE_CHECK(checkCompare<s8>(rng, -128, 127));
+    CAROTENE_CHECK(checkCompare<u16>(rng, 0, 65535));
+    CAROTENE_CHECK(checkCompare<s16>(rng, -32768, 32767));
+    CAROTENE_CHECK(checkCompare<s32>(rng, -3e9 / 2, 3e9 / 2));
+    CAROTENE_CHECK(checkCompare<f32>(rng, -1000, 1000));
+}
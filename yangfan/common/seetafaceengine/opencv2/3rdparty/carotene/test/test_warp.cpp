@@ -0,0 +1,169 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <cmath>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+namespace {
+
+// cv::warpAffine coordinate arithmetic: AB_BITS = 10 fixed point with per column and per row rounding
+void refWarpAffine(const Image<u8> & src, Image<u8> & dst, const f32 * m, bool linear, BORDER_MODE mode, u8 value)
+{
+    const s32 AB = 1024, shift = linear ? 5 : 10, roundDelta = linear ? AB / 32 / 2 : AB / 2;
+    for (size_t y = 0; y < dst.height; ++y)
+    {
+        s32 X0 = (s32)std::lrint(((f64)m[2] * y + m[4]) * AB) + roundDelta;
+        s32 Y0 = (s32)std::lrint(((f64)m[3] * y + m[5]) * AB) + roundDelta;
+        for (size_t x = 0; x < dst.width; ++x)
+        {
+            s32 X = (X0 + (s32)std::lrint((f64)m[0] * x * AB)) >> shift;
+            s32 Y = (Y0 + (s32)std::lrint((f64)m[1] * x * AB)) >> shift;
+            dst.at(x, y) = refSample(src, X, Y, linear, mode, value);
+        }
+    }
+}
+
+void rotation(f32 * m, f64 angle, f64 scale, f64 cx, f64 cy, f64 tx, f64 ty)
+{
+    f64 c = std::cos(angle) * scale, s = std::sin(angle) * scale;
+    // src = R * (dst - t) around the center
+    m[0] = (f32)c;
+    m[1] = (f32)s;
+    m[2] = (f32)-s;
+    m[3] = (f32)c;
+    m[4] = (f32)(cx - c * (cx + tx) + s * (cy + ty));
+    m[5] = (f32)(cy - s * (cx + tx) - c * (cy + ty));
+}
+
+// Smooth content, so that a 1 / 32 pixel coordinate difference changes the value by less than one
+void smoothImage(Image<u8> & img, Rng & rng)
+{
+    f32 kx = rng.uniform(0.02f, 0.05f), ky = rng.uniform(0.02f, 0.05f);
+    for (size_t y = 0; y < img.height; ++y)
+        for (size_t x = 0; x < img.width; ++x)
+            img.at(x, y) = (u8)(128 + 100 * std::sin(x * kx) * std::cos(y * ky));
+}
+
+} // namespace
+
+CAROTENE_TEST(warpAffine)
+{
+    const size_t sizes[][4] = { { 64, 48, 64, 48 }, { 101, 67, 75, 53 }, { 320, 240, 160, 120 }, { 17, 9, 40, 33 } };
+    Rng rng;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+        for (size_t b = 0; b < sizeof(borderModes) / sizeof(borderModes[0]); ++b)
+            for (int linear = 0; linear < 2; ++linear)
+            {
+                Image<u8> src(sizes[i][0], sizes[i][1]), dst(sizes[i][2], sizes[i][3]), ref = dst;
+                src.randomize(rng);
+                f32 m[6];
+                rotation(m, rng.uniform(-3.14f, 3.14f), rng.uniform(0.5f, 2.0f),
+                         src.width / 2.0, src.height / 2.0, rng.uniform(-20, 20), rng.uniform(-20, 20));
+                u8 value = (u8)rng.next();
+
+                if (linear)
+                    warpAffineLinear(src.size(), dst.size(), &src.data[0], src.stride, m,
+                                     &dst.data[0], dst.stride, borderModes[b], value);
+                else
+                    warpAffineNearestNeighbor(src.size(), dst.size(), &src.data[0], src.stride, m,
+                                              &dst.data[0], dst.stride, borderModes[b], value);
+                refWarpAffine(src, ref, m, linear != 0, borderModes[b], value);
+                CAROTENE_CHECK(maxDiff(dst, ref) == 0);
+            }
+}
+
+CAROTENE_TEST(warpPerspectiveNearestNeighbor)
+{
+    Rng rng;
+    for (size_t b = 0; b < sizeof(borderModes) / sizeof(borderModes[0]); ++b)
+    {
+        Image<u8> src(97, 71), dst(83, 77);
+        src.randomize(rng);
+        f32 m[9] = { 0.9f, 0.1f, 0.0004f, -0.15f, 1.1f, 0.0007f, 5.0f, -7.0f, 1.0f };
+        warpPerspectiveNearestNeighbor(src.size(), dst.size(), &src.data[0], src.stride, m,
+                                       &dst.data[0], dst.stride, borderModes[b], 17);
+
+        for (size_t y = 0; y < dst.height; ++y)
+            for (size_t x = 0; x < dst.width; ++x)
+            {
+                f64 w = m[2] * x + m[5] * y + m[8];
+                f64 fx = (m[0] * x + m[3] * y + m[6]) / w, fy = (m[1] * x + m[4] * y + m[7]) / w;
+                // f32 and f64 division may round a coordinate on a .5 boundary either way
+                if (std::fabs(fx - std::floor(fx) - 0.5) < 1e-3 || std::fabs(fy - std::floor(fy) - 0.5) < 1e-3)
+                    continue;
+                u8 expected = refPixel(src, (s32)std::floor(fx + 0.5), (s32)std::floor(fy + 0.5), borderModes[b], 17);
+                CAROTENE_CHECK(dst.at(x, y) == expected);
+            }
+    }
+}
+
+CAROTENE_TEST(warpPerspectiveLinear)
+{
+    Rng rng;
+    for (size_t b = 0; b < sizeof(borderModes) / sizeof(borderModes[0]); ++b)
+    {
+        Image<u8> src(97, 71), dst(83, 77), ref = dst;
+        smoothImage(src, rng);
+        f32 m[9] = { 0.9f, 0.1f, 0.0004f, -0.15f, 1.1f, 0.0007f, 5.0f, -7.0f, 1.0f };
+        warpPerspectiveLinear(src.size(), dst.size(), &src.data[0], src.stride, m,
+                              &dst.data[0], dst.stride, borderModes[b], 128);
+
+        for (size_t y = 0; y < dst.height; ++y)
+            for (size_t x = 0; x < dst.width; ++x)
+            {
+                f64 w = 32 / (m[2] * x + m[5] * y + m[8]);
+                s32 X = (s32)std::lrint((m[0] * x + m[3] * y + m[6]) * w);
+                s32 Y = (s32)std::lrint((m[1] * x + m[4] * y + m[7]) * w);
+                ref.at(x, y) = refSample(src, X, Y, true, borderModes[b], 128);
+            }
+        CAROTENE_CHECK(maxDiff(dst, ref) <= 1);
+    }
+
+    // the identity transform reproduces the source exactly
+    Image<u8> src(70, 45), dst(70, 45);
+    src.randomize(rng);
+    f32 identity[9] = { 1, 0, 0, 0, 1, 0, 0, 0, 1 };
+    warpPerspectiveLinear(src.size(), dst.size(), &src.data[0], src.stride, identity,
+                          &dst.data[0], dst.stride, BORDER_MODE_REPLICATE, 0);
+    CAROTENE_CHECK(maxDiff(dst, src) == 0);
+}
@@ -0,0 +1,306 @@
+/*
+ * By downloading, copying, installing or using the software you agree to this license.
+ * If you do not agree to this license, do not download, install,
+ * copy or use the software.
+ *
+ *
+ *                           License Agreement
+ *                For Open Source Computer Vision Library
+ *                        (3-clause BSD License)
+ *
+ * Copyright (C) 2014, NVIDIA Corporation, all rights reserved.
+ * Third party copyrights are property of their respective owners.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   * Neither the names of the copyright holders nor the names of the contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * This software is provided by the copyright holders and contributors "as is" and
+ * any express or implied warranties, including, but not limited to, the implied
+ * warranties of merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall copyright holders or contributors be liable for any direct,
+ * indirect, incidental, special, exemplary, or consequential damages
+ * (including, but not limited to, procurement of substitute goods or services;
+ * loss of use, data, or profits; or business interruption) however caused
+ * and on any theory of liability, whether in contract, strict liability,
+ * or tort (including negligence or otherwise) arising in any way out of
+ * the use of this software, even if advised of the possibility of such damage.
+ */
+
+#include "test_common.hpp"
+
+#include <cmath>
+
+using namespace CAROTENE_NS;
+using namespace CAROTENE_NS::test;
+
+namespace {
+
+// Widths around the 16 pixel block, odd ones end with half a macropixel or chroma pair
+const size_t yuvWidths[] = { 1, 2, 3, 15, 16, 17, 18, 31, 34, 100, 641 };
+
+const COLOR_SPACE yuvSpaces[] = { COLOR_SPACE_BT601, COLOR_SPACE_BT709, COLOR_SPACE_BT2020 };
+const YUV_RANGE yuvRanges[] = { YUV_RANGE_LIMITED, YUV_RANGE_FULL };
+
+const u8 guardByte = 0xA5;
+
+// OpenCV's cvtColor YUV 4:2:2 and 4:2:0 decoder, ITU-R BT.601 limited range with 20 bit coefficients
+void cvYUV2RGB(s32 y, s32 u, s32 v, u8 rgb[3])
+{
+    const s32 CY = 1220542, CUB = 2116026, CUG = -409993, CVG = -852492, CVR = 1673527, SHIFT = 20;
+    u -= 128;
+    v -= 128;
+    s32 ruv = (1 << (SHIFT - 1)) + CVR * v;
+    s32 guv = (1 << (SHIFT - 1)) + CVG * v + CUG * u;
+    s32 buv = (1 << (SHIFT - 1)) + CUB * u;
+    s32 yy = std::max(0, y - 16) * CY;
+    rgb[0] = (u8)std::min(std::max((yy + ruv) >> SHIFT, 0), 255);
+    rgb[1] = (u8)std::min(std::max((yy + guv) >> SHIFT, 0), 255);
+    rgb[2] = (u8)std::min(std::max((yy + buv) >> SHIFT, 0), 255);
+}
+
+// Floating point decode from Kr, Kb and the range, independent of the fixed point tables
+void refYUV2RGB(COLOR_SPACE space, YUV_RANGE range, s32 y, s32 u, s32 v, f64 rgb[3])
+{
+    f64 kr = space == COLOR_SPACE_BT601 ? 0.299 : space == COLOR_SPACE_BT709 ? 0.2126 : 0.2627;
+    f64 kb = space == COLOR_SPACE_BT601 ? 0.114 : space == COLOR_SPACE_BT709 ? 0.0722 : 0.0593;
+    f64 kg = 1 - kr - kb;
+    f64 yy = range == YUV_RANGE_LIMITED ? std::max(y - 16, 0) * 255.0 / 219.0 : (f64)y;
+    f64 cs = range == YUV_RANGE_LIMITED ? 255.0 / 224.0 : 1.0;
+    f64 uu = (u - 128) * cs, vv = (v - 128) * cs;
+    rgb[0] = yy + 2 * (1 - kr) * vv;
+    rgb[1] = yy - 2 * (1 - kb) * kb / kg * uu - 2 * (1 - kr) * kr / kg * vv;
+    rgb[2] = yy + 2 * (1 - kb) * uu;
+    for (int c = 0; c < 3; ++c)
+        rgb[c] = std::min(std::max(rgb[c], 0.0), 255.0);
+}
+
+typedef void (*YUV422Func)(const Size2D &, COLOR_SPACE, YUV_RANGE, const u8 *, ptrdiff_t, u8 *, ptrdiff_t);
+
+struct YUV422Case
+{
+    YUV422Func func;
+    bool uyvy;
+    size_t dcn, bIdx;
+};
+
+const YUV422Case yuv422Cases[] = {
+    { yuyv2rgb, false, 3, 2 }, { yuyv2rgbx, false, 4, 2 }, { yuyv2bgr, false, 3, 0 }, { yuyv2bgrx, false, 4, 0 },
+    { uyvy2rgb, true, 3, 2 }, { uyvy2rgbx, true, 4, 2 }, { uyvy2bgr, true, 3, 0 }, { uyvy2bgrx, true, 4, 0 }
+};
+
+// Decodes with `func` and compares every pixel; returns the largest difference to the
+// float reference, or a negative value when the layout or the padding is wrong
+f64 checkYUV422(const YUV422Case & tc, COLOR_SPACE space, YUV_RANGE range, size_t width, Rng & rng, bool exactCv)
+{
+    const size_t height = 3;
+    Image<u8> src((width + 1) / 2 * 2, height, 2);
+    src.randomize(rng);
+    Image<u8> dst(width, height, tc.dcn);
+    std::fill(dst.data.begin(), dst.data.end(), guardByte);
+
+    tc.func(Size2D(width, height), space, range, src.row(0), src.stride, dst.row(0), dst.stride);
+
+    const size_t y0Idx = tc.uyvy ? 1 : 0, uIdx = tc.uyvy ? 0 : 1, vIdx = tc.uyvy ? 2 : 3;
+    f64 worst = 0;
+    for (size_t y = 0; y < height; ++y)
+    {
+        for (size_t x = 0; x < width; ++x)
+        {
+            const u8 * mp = src.row(y) + (x / 2) * 4;
+            s32 Y = mp[y0Idx + 2 * (x & 1)], U = mp[uIdx], V = mp[vIdx];
+            const u8 * px = dst.row(y) + x * tc.dcn;
+            u8 got[3] = { px[2 - tc.bIdx], px[1], px[tc.bIdx] };
+            if (tc.dcn == 4 && px[3] != 255)
+                return -1;
+
+            if (exactCv)
+            {
+                u8 cv[3];
+                cvYUV2RGB(Y, U, V, cv);
+                if (got[0] != cv[0] || got[1] != cv[1] || got[2] != cv[2])
+                    return -1;
+            }
+
+            f64 ref[3];
+            refYUV2RGB(space, range, Y, U, V, ref);
+            for (int c = 0; c < 3; ++c)
+                worst = std::max(worst, std::abs(got[c] - ref[c]));
+        }
+        for (size_t i = width * tc.dcn; i < (size_t)dst.stride; ++i)
+            if (dst.row(y)[i] != guardByte)
+                return -1;
+    }
+    return worst;
+}
+
+typedef void (*YUV420Func)(const Size2D &, COLOR_SPACE, YUV_RANGE,
+                           const u8 *, ptrdiff_t, const u8 *, ptrdiff_t, u8 *, ptrdiff_t);
+
+struct YUV420Case
+{
+    YUV420Func func;
+    size_t vIdx, dcn, bIdx;
+};
+
+const YUV420Case yuv420Cases[] = {
+    { yuv420sp2rgb, 0, 3, 2 }, { yuv420sp2rgbx, 0, 4, 2 }, { yuv420sp2bgr, 0, 3, 0 }, { yuv420sp2bgrx, 0, 4, 0 },
+    { yuv420i2rgb, 1, 3, 2 }, { yuv420i2rgbx, 1, 4, 2 }, { yuv420i2bgr, 1, 3, 0 }, { yuv420i2bgrx, 1, 4, 0 }
+};
+
+// Same as checkYUV422 for a luma plane and an interleaved chroma plane of half the height
+f64 checkYUV420(const YUV420Case & tc, COLOR_SPACE space, YUV_RANGE range, size_t width, size_t height,
+                Rng & rng, bool exactCv)
+{
+    Image<u8> yPlane(width, height, 1);
+    yPlane.randomize(rng);
+    Image<u8> uvPlane((width + 1) / 2 * 2, (height + 1) / 2, 1);
+    uvPlane.randomize(rng);
+    Image<u8> dst(width, height, tc.dcn);
+    std::fill(dst.data.begin(), dst.data.end(), guardByte);
+
+    tc.func(Size2D(width, height), space, range, yPlane.row(0), yPlane.stride,
+            uvPlane.row(0), uvPlane.stride, dst.row(0), dst.stride);
+
+    f64 worst = 0;
+    for (size_t y = 0; y < height; ++y)
+    {
+        for (size_t x = 0; x < width; ++x)
+        {
+            const u8 * uv = uvPlane.row(y / 2) + (x / 2) * 2;
+            s32 Y = yPlane.row(y)[x], U = uv[1 - tc.vIdx], V = uv[tc.vIdx];
+            const u8 * px = dst.row(y) + x * tc.dcn;
+            u8 got[3] = { px[2 - tc.bIdx], px[1], px[tc.bIdx] };
+            if (tc.dcn == 4 && px[3] != 255)
+                return -1;
+
+            if (exactCv)
+            {
+                u8 cv[3];
+                cvYUV2RGB(Y, U, V, cv);
+                if (got[0] != cv[0] || got[1] != cv[1] || got[2] != cv[2])
+                    return -1;
+            }
+
+            f64 ref[3];
+            refYUV2RGB(space, range, Y, U, V, ref);
+            for (int c = 0; c < 3; ++c)
+                worst = std::max(worst, std::abs(got[c] - ref[c]));
+        }
+        for (size_t i = width * tc.dcn; i < (size_t)dst.stride; ++i)
+            if (dst.row(y)[i] != guardByte)
+                return -1;
+    }
+    return worst;
+}
+
+} // namespace
+
+CAROTENE_TEST(yuv422_bt601_opencv)
+{
+    Rng rng(41);
+    for (size_t ci = 0; ci < sizeof(yuv422Cases) / sizeof(yuv422Cases[0]); ++ci)
+        for (size_t wi = 0; wi < sizeof(yuvWidths) / sizeof(yuvWidths[0]); ++wi)
+            CAROTENE_CHECK(checkYUV422(yuv422Cases[ci], COLOR_SPACE_BT601, YUV_RANGE_LIMITED, yuvWidths[wi], rng, true) >= 0);
+}
+
+CAROTENE_TEST(yuv422_colorimetry)
+{
+    Rng rng(42);
+    for (size_t si = 0; si < 3; ++si)
+        for (size_t ri = 0; ri < 2; ++ri)
+            for (size_t ci = 0; ci < sizeof(yuv422Cases) / sizeof(yuv422Cases[0]); ++ci)
+                for (size_t wi = 0; wi < sizeof(yuvWidths) / sizeof(yuvWidths[0]); ++wi)
+                {
+                    f64 worst = checkYUV422(yuv422Cases[ci], yuvSpaces[si], yuvRanges[ri], yuvWidths[wi], rng, false);
+                    CAROTENE_CHECK(worst >= 0 && worst <= 1.0);
+                }
+}
+
+CAROTENE_TEST(yuv420_bt601_opencv)
+{
+    const size_t heights[] = { 1, 2, 3, 6 };
+
+    Rng rng(43);
+    for (size_t ci = 0; ci < sizeof(yuv420Cases) / sizeof(yuv420Cases[0]); ++ci)
+        for (size_t wi = 0; wi < sizeof(yuvWidths) / sizeof(yuvWidths[0]); ++wi)
+            for (size_t hi = 0; hi < 4; ++hi)
+                CAROTENE_CHECK(checkYUV420(yuv420Cases[ci], COLOR_SPACE_BT601, YUV_RANGE_LIMITED,
+                                           yuvWidths[wi], heights[hi], rng, true) >= 0);
+}
+
+CAROTENE_TEST(yuv420_colorimetry)
+{
+    Rng rng(44);
+    for (size_t si = 0; si < 3; ++si)
+        for (size_t ri = 0; ri < 2; ++ri)
+            for (size_t ci = 0; ci < sizeof(yuv420Cases) / sizeof(yuv420Cases[0]); ++ci)
+                for (size_t wi = 0; wi < sizeof(yuvWidths) / sizeof(yuvWidths[0]); ++wi)
+                {
+                    f64 worst = checkYUV420(yuv420Cases[ci], yuvSpaces[si], yuvRanges[ri], yuvWidths[wi], 5, rng, false);
+                    CAROTENE_CHECK(worst >= 0 && worst <= 1.0);
+                }
+}
+
+CAROTENE_TEST(yuv420_planar_f32)
+{
+    typedef void (*PlanarFunc)(const Size2D &, COLOR_SPACE, YUV_RANGE,
+                               const u8 *, ptrdiff_t, const u8 *, ptrdiff_t,
+                               f32 *, ptrdiff_t, f32 *, ptrdiff_t, f32 *, ptrdiff_t,
+                               const f32 *, const f32 *);
+    const PlanarFunc planar[] = { yuv420sp2rgbPlanarF32, yuv420i2rgbPlanarF32 };
+    const YUV420Func interleaved[] = { yuv420sp2rgb, yuv420i2rgb };
+    const size_t heights[] = { 1, 2, 5 };
+    const f32 mean[3] = { 123.675f, 116.28f, 103.53f }, stdDev[3] = { 58.395f, 57.12f, 57.375f };
+
+    Rng rng(45);
+    for (size_t fi = 0; fi < 2; ++fi)
+        for (size_t si = 0; si < 3; ++si)
+            for (size_t wi = 0; wi < sizeof(yuvWidths) / sizeof(yuvWidths[0]); ++wi)
+                for (size_t hi = 0; hi < 3; ++hi)
+                {
+                    size_t width = yuvWidths[wi], height = heights[hi];
+                    Image<u8> yPlane(width, height, 1);
+                    yPlane.randomize(rng);
+                    Image<u8> uvPlane((width + 1) / 2 * 2, (height + 1) / 2, 1);
+                    uvPlane.randomize(rng);
+
+                    Image<u8> rgb(width, height, 3);
+                    interleaved[fi](Size2D(width, height), yuvSpaces[si], YUV_RANGE_LIMITED,
+                                    yPlane.row(0), yPlane.stride, uvPlane.row(0), uvPlane.stride,
+                                    rgb.row(0), rgb.stride);
+
+                    Image<f32> dst[3] = { Image<f32>(width, height), Image<f32>(width, height), Image<f32>(width, height) };
+                    for (size_t c = 0; c < 3; ++c)
+                        std::fill(dst[c].data.begin(), dst[c].data.end(), -1000.0f);
+                    planar[fi](Size2D(width, height), yuvSpaces[si], YUV_RANGE_LIMITED,
+                               yPlane.row(0), yPlane.stride, uvPlane.row(0), uvPlane.stride,
+                               dst[0].row(0), dst[0].stride, dst[1].row(0), dst[1].stride,
+                               dst[2].row(0), dst[2].stride, mean, stdDev);
+
+                    f64 worst = 0;
+                    bool padding = true;
+                    for (size_t c = 0; c < 3; ++c)
+                        for (size_t y = 0; y < height; ++y)
+                        {
+                            for (size_t x = 0; x < width; ++x)
+                            {
+                                f64 ref = (rgb.at(x, y, c) - (f64)mean[c]) / stdDev[c];
+                                worst = std::max(worst, std::abs(dst[c].row(y)[x] - ref));
+                            }
+                            for (size_t x = width; x < (size_t)dst[c].stride / sizeof(f32); ++x)
+                                padding = padding && dst[c].row(y)[x] == -1000.0f;
+                        }
+                    CAROTENE_CHECK(padding && worst <= 1e-5);
+                }
+}
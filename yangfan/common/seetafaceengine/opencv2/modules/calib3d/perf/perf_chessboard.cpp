@@ -0,0 +1,205 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+#include "perf_precomp.hpp"
+
+namespace opencv_test
+{
+using namespace perf;
+
+enum { BOARD_CLEAN, BOARD_BLUR, BOARD_LOW_CONTRAST, BOARD_GRADIENT, BOARD_NOISE };
+CV_ENUM(BoardDegradation, BOARD_CLEAN, BOARD_BLUR, BOARD_LOW_CONTRAST, BOARD_GRADIENT, BOARD_NOISE)
+
+typedef tuple<Size, BoardDegradation> PatternSize_Degradation_t;
+typedef perf::TestBaseWithParam<PatternSize_Degradation_t> PatternSize_Degradation;
+
+// Renders a tilted chessboard with pattern_size inner corners into a 640x480 image. Other than
+// BOARD_CLEAN the degradations make the histogram based binarization fail, so that the
+// threshold/dilation passes of the fallback are needed.
+static Mat makeHardBoard(Size pattern_size, int degradation)
+{
+    const int square = 32;
+    Size board_size((pattern_size.width + 1) * square, (pattern_size.height + 1) * square);
+    Mat board(board_size.height + 2 * square, board_size.width + 2 * square, CV_8UC1, Scalar(255));
+    for (int y = 0; y <= pattern_size.height; y++)
+        for (int x = 0; x <= pattern_size.width; x++)
+            if ((x + y) % 2 == 0)
+                rectangle(board, Rect(square + x * square, square + y * square, square, square), Scalar(0), FILLED);
+
+    const Point2f src[] = { Point2f(0, 0), Point2f((float)board.cols, 0),
+                            Point2f((float)board.cols, (float)board.rows), Point2f(0, (float)board.rows) };
+    const Point2f dst[] = { Point2f(130, 60), Point2f(540, 95), Point2f(500, 430), Point2f(95, 390) };
+    Mat img;
+    warpPerspective(board, img, getPerspectiveTransform(src, dst), Size(640, 480),
+                    INTER_LINEAR, BORDER_CONSTANT, Scalar(160));
+
+    RNG rng(0x34985739);
+    switch (degradation)
+    {
+    case BOARD_BLUR:
+        GaussianBlur(img, img, Size(9, 9), 3.5);
+        break;
+    case BOARD_LOW_CONTRAST:
+        img.convertTo(img, -1, 0.2, 90);
+        break;
+    case BOARD_GRADIENT:
+    {
+        Mat ramp(img.size(), CV_32F), imgf;
+        for (int y = 0; y < ramp.rows; y++)
+            for (int x = 0; x < ramp.cols; x++)
+                ramp.at<float>(y, x) = 0.25f + 0.75f * x / ramp.cols;
+        img.convertTo(imgf, CV_32F);
+        multiply(imgf, ramp, imgf);
+        imgf.convertTo(img, CV_8U);
+        break;
+    }
+    case BOARD_NOISE:
+    {
+        Mat noise(img.size(), CV_16S);
+        rng.fill(noise, RNG::NORMAL, 0, 40);
+        add(img, noise, img, noArray(), CV_8U);
+        break;
+    }
+    default:
+        break;
+    }
+    return img;
+}
+
+PERF_TEST_P(PatternSize_Degradation, findChessboardCorners_hard, testing::Combine(
+                testing::Values(Size(9, 6), Size(7, 7)),
+                BoardDegradation::all()
+                )
+            )
+{
+    Size pattern_size = get<0>(GetParam());
+    int degradation = get<1>(GetParam());
+    const int flags = CALIB_CB_ADAPTIVE_THRESH | CALIB_CB_NORMALIZE_IMAGE;
+
+    Mat img = makeHardBoard(pattern_size, degradation);
+
+    // the concurrent passes have to end up exactly where the serial search does
+    vector<Point2f> serial_corners, corners;
+    int threads = getNumThreads();
+    setNumThreads(1);
+    bool serial_found = findChessboardCorners(img, pattern_size, serial_corners, flags);
+    setNumThreads(threads);
+    bool found = findChessboardCorners(img, pattern_size, corners, flags);
+    ASSERT_EQ(serial_found, found);
+    ASSERT_EQ(serial_corners.size(), corners.size());
+    for (size_t i = 0; i < corners.size(); i++)
+    {
+        ASSERT_EQ(serial_corners[i].x, corners[i].x) << "corner " << i;
+        ASSERT_EQ(serial_corners[i].y, corners[i].y) << "corner " << i;
+    }
+
+    declare.in(img);
+
+    TEST_CYCLE() findChessboardCorners(img, pattern_size, corners, flags);
+
+    SANITY_CHECK_NOTHING();
+}
+
+typedef perf::TestBaseWithParam<Size> PatternSize;
+
+// Clean board that the serial histogram based pass finds on its own: the fallback passes never
+// run, so this tracks the common path and must not get slower
+PERF_TEST_P(PatternSize, findChessboardCorners_easy, testing::Values(Size(9, 6), Size(7, 7)))
+{
+    Size pattern_size = GetParam();
+    Mat img = makeHardBoard(pattern_size, BOARD_CLEAN);
+
+    vector<Point2f> corners;
+    ASSERT_TRUE(findChessboardCorners(img, pattern_size, corners));
+
+    declare.in(img);
+
+    TEST_CYCLE() findChessboardCorners(img, pattern_size, corners);
+
+    SANITY_CHECK_NOTHING();
+}
+
+typedef perf::TestBaseWithParam<int> ClutterCount;
+
+// Board surrounded by many small dark squares: every binarization pass produces thousands
+// of quads, which stresses the neighbor search of the quad corners.
+PERF_TEST_P(ClutterCount, findChessboardCorners_cluttered, testing::Values(0, 500, 2000, 5000))
+{
+    const Size pattern_size(9, 6);
+    int clutter = GetParam();
+
+    Mat img = makeHardBoard(pattern_size, BOARD_CLEAN);
+    RNG rng(0x1f2e3d4c);
+    for (int i = 0; i < clutter; )
+    {
+        Point center(rng.uniform(0, img.cols), rng.uniform(0, img.rows));
+        if (center.x > 90 && center.x < 550 && center.y > 50 && center.y < 440)
+            continue; // keep the board itself clean
+        i++;
+        int half = rng.uniform(2, 6);
+        rectangle(img, Rect(center.x - half, center.y - half, 2 * half, 2 * half), Scalar(rng.uniform(0, 60)), FILLED);
+    }
+
+    vector<Point2f> corners;
+    declare.in(img);
+
+    TEST_CYCLE() findChessboardCorners(img, pattern_size, corners, CALIB_CB_ADAPTIVE_THRESH | CALIB_CB_NORMALIZE_IMAGE);
+
+    SANITY_CHECK_NOTHING();
+}
+
+typedef perf::TestBaseWithParam<int> ThreadCount;
+
+// Recorded boards of the calibration test data, with the serial search (1 thread) next to the
+// concurrent passes (0: default thread count). Corners have to agree between the two.
+PERF_TEST_P(ThreadCount, findChessboardCorners_recorded, testing::Values(1, 0))
+{
+    const string list = getDataPath("cv/cameracalibration/chessboard_list.dat");
+    const string folder = list.substr(0, list.find_last_of("/\\") + 1);
+    FileStorage fs(list, FileStorage::READ);
+    FileNode boards = fs["boards"];
+    ASSERT_FALSE(boards.empty()) << "Unable to read " << list;
+
+    // the list alternates image and expected corners, whose matrix size is the pattern size
+    vector<Mat> images;
+    vector<Size> pattern_sizes;
+    for (int i = 0; i + 1 < (int)boards.size(); i += 2)
+    {
+        Mat expected;
+        FileStorage corners_fs(folder + (string)boards[i + 1], FileStorage::READ);
+        corners_fs["corners"] >> expected;
+        Mat img = imread(folder + (string)boards[i], IMREAD_GRAYSCALE);
+        if (img.empty() || expected.empty())
+            continue;
+        images.push_back(img);
+        pattern_sizes.push_back(expected.size());
+    }
+    ASSERT_FALSE(images.empty());
+
+    const int flags = CALIB_CB_ADAPTIVE_THRESH | CALIB_CB_NORMALIZE_IMAGE;
+    const int threads = getNumThreads();
+    vector<Point2f> serial_corners, corners;
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        setNumThreads(1);
+        bool serial_found = findChessboardCorners(images[i], pattern_sizes[i], serial_corners, flags);
+        setNumThreads(threads);
+        bool found = findChessboardCorners(images[i], pattern_sizes[i], corners, flags);
+        ASSERT_EQ(serial_found, found) << "board " << i;
+        ASSERT_EQ(serial_corners, corners) << "board " << i;
+    }
+
+    if (GetParam() > 0)
+        setNumThreads(GetParam());
+
+    TEST_CYCLE()
+    {
+        for (size_t i = 0; i < images.size(); i++)
+            findChessboardCorners(images[i], pattern_sizes[i], corners, flags);
+    }
+
+    setNumThreads(threads);
+    SANITY_CHECK_NOTHING();
+}
+
+} // namespace
@@ -71,7 +71,10 @@
 
 #include "precomp.hpp"
 #include "circlesgrid.hpp"
+#include "chessboard_quads.hpp"
 
+#include <atomic>
+#include <climits>
 #include <stack>
 
 //#define ENABLE_TRIM_COL_ROW
@@ -127,64 +130,6 @@ struct CvContourEx
 #endif
 
 
-/** This structure stores information about the chessboard corner.*/
-struct ChessBoardCorner
-{
-    cv::Point2f pt;  // Coordinates of the corner
-    int row;         // Board row index
-    int count;       // Number of neighbor corners
-    struct ChessBoardCorner* neighbors[4]; // Neighbor corners
-
-    ChessBoardCorner(const cv::Point2f& pt_ = cv::Point2f()) :
-        pt(pt_), row(0), count(0)
-    {
-        neighbors[0] = neighbors[1] = neighbors[2] = neighbors[3] = NULL;
-    }
-
-    float sumDist(int& n_) const
-    {
-        float sum = 0;
-        int n = 0;
-        for (int i = 0; i < 4; ++i)
-        {
-            if (neighbors[i])
-            {
-                sum += sqrt(normL2Sqr<float>(neighbors[i]->pt - pt));
-                n++;
-            }
-        }
-        n_ = n;
-        return sum;
-    }
-};
-
-
-/** This structure stores information about the chessboard quadrangle.*/
-struct ChessBoardQuad
-{
-    int count;      // Number of quad neighbors
-    int group_idx;  // quad group ID
-    int row, col;   // row and column of this quad
-    bool ordered;   // true if corners/neighbors are ordered counter-clockwise
-    float edge_len; // quad edge len, in pix^2
-    // neighbors and corners are synced, i.e., neighbor 0 shares corner 0
-    ChessBoardCorner *corners[4]; // Coordinates of quad corners
-    struct ChessBoardQuad *neighbors[4]; // Pointers of quad neighbors
-
-    ChessBoardQuad(int group_idx_ = -1) :
-        count(0),
-        group_idx(group_idx_),
-        row(0), col(0),
-        ordered(0),
-        edge_len(0)
-    {
-        corners[0] = corners[1] = corners[2] = corners[3] = NULL;
-        neighbors[0] = neighbors[1] = neighbors[2] = neighbors[3] = NULL;
-    }
-};
-
-
-
 #ifdef DEBUG_CHESSBOARD
 static void SHOW(const std::string & name, Mat & img)
 {
@@ -279,6 +224,20 @@ public:
 template<typename ArrayContainer>
 static void icvGetIntensityHistogram256(const Mat& img, ArrayContainer& piHist)
 {
+    // cv::calcHist goes through the imgproc HAL (the NEON histogram of carotene on ARM);
+    // its float bins hold the counts exactly below 2^24 pixels
+    if (img.total() < (size_t)(1 << 24))
+    {
+        const int channels[] = { 0 };
+        const int histSize[] = { 256 };
+        const float range[] = { 0.f, 256.f };
+        const float* ranges[] = { range };
+        Mat hist;
+        calcHist(&img, 1, channels, Mat(), hist, 1, histSize, ranges);
+        for (int i = 0; i < 256; i++)
+            piHist[i] = cvRound(hist.at<float>(i));
+        return;
+    }
     for (int i = 0; i < 256; i++)
         piHist[i] = 0;
     // sum up all pixel in row direction and divide by number of columns
@@ -483,6 +442,181 @@ static void icvBinarizationHistogramBased(Mat & img)
     }
 }
 
+/*
+ * Binarization passes of the findChessboardCorners fallback, evaluated concurrently.
+ *
+ * When the histogram based binarization does not find the board, the detector tries
+ * (k, dilations) passes in a fixed order and stops at the first one that finds it. Here the
+ * passes run in waves of up to getNumThreads() on detectors of their own and are committed in
+ * that order afterwards, so the outcome is the one of the serial loop:
+ *  - without the adaptive threshold every pass dilates the image of the one before once more,
+ *    these images are built serially before a wave starts;
+ *  - with it the block size depends on the square size measured by the previous pass. A wave
+ *    assumes the value known when it starts; a pass that turns out to have run with another
+ *    block size is dropped together with the rest of the wave and the next wave starts there.
+ * Passes that have not started yet are skipped once an earlier pass found the board.
+ */
+struct ChessBoardPass
+{
+    int k, dilations;
+    Mat image;                       // binarized input of a dilation chain pass
+    int block_size;                  // adaptive threshold block size the pass ran with
+    int sqr_size;                    // square size measured by processQuads, -1 if it found no group
+    bool evaluated, found;
+    std::vector<cv::Point2f> corners;
+
+    ChessBoardPass(int k_, int dilations_) :
+        k(k_), dilations(dilations_), block_size(0), sqr_size(-1), evaluated(false), found(false)
+    {
+    }
+};
+
+static int adaptiveBlockSize(const Mat& img, int k, int prev_sqr_size)
+{
+    int block_size = cvRound(prev_sqr_size == 0
+                             ? std::min(img.cols, img.rows) * (k % 2 == 0 ? 0.2 : 0.1)
+                             : prev_sqr_size * 2);
+    return block_size | 1;
+}
+
+// So we can find rectangles that go to the edge, we draw a white line around the image edge.
+// Otherwise FindContours will miss those clipped rectangle contours.
+// The border color will be the image mean, because otherwise we risk screwing up filters like cvSmooth()...
+static void drawBinarizedBorder(Mat& img)
+{
+    rectangle( img, Point(0,0), Point(img.cols-1, img.rows-1), Scalar(255,255,255), 3, LINE_8);
+}
+
+class ChessBoardPassInvoker : public ParallelLoopBody
+{
+public:
+    ChessBoardPassInvoker(const Mat& img_, Size pattern_size_, int flags_, bool adaptive_,
+                          std::vector<ChessBoardPass>& passes_, std::atomic<int>& first_found_) :
+        img(img_), pattern_size(pattern_size_), flags(flags_), adaptive(adaptive_),
+        passes(passes_), first_found(first_found_)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        for (int i = range.start; i < range.end; ++i)
+            run(i);
+    }
+
+private:
+    void run(int i) const
+    {
+        ChessBoardPass& pass = passes[i];
+        if (first_found.load() < i)
+            return;
+
+        Mat binarized_img;
+        if (adaptive)
+        {
+            // convert the input grayscale image to binary (black-n-white)
+            adaptiveThreshold( img, binarized_img, 255, ADAPTIVE_THRESH_MEAN_C, THRESH_BINARY, pass.block_size, (pass.k/2)*5 );
+            if (pass.dilations > 0)
+                dilate( binarized_img, binarized_img, Mat(), Point(-1, -1), pass.dilations-1 );
+            drawBinarizedBorder(binarized_img);
+        }
+        else
+        {
+#ifdef USE_CV_FINDCONTOURS
+            binarized_img = pass.image;
+#else
+            binarized_img = pass.image.clone(); // make clone because cvFindContours modifies the source image
+#endif
+        }
+        SHOW("Binarization", binarized_img);
+
+        if (first_found.load() < i)
+            return;
+
+        ChessBoardDetector detector(pattern_size);
+        detector.generateQuads(binarized_img, flags);
+        DPRINTF("Quad count: %d/%d", detector.all_quads_count, (pattern_size.width/2+1)*(pattern_size.height/2+1));
+        SHOW_QUADS("Quads", binarized_img, &detector.all_quads[0], detector.all_quads_count);
+        pass.found = detector.processQuads(pass.corners, pass.sqr_size);
+        pass.evaluated = true;
+
+        if (pass.found)
+        {
+            int current = first_found.load();
+            while (i < current && !first_found.compare_exchange_weak(current, i))
+                ;
+        }
+    }
+
+    const Mat& img;
+    Size pattern_size;
+    int flags;
+    bool adaptive;
+    std::vector<ChessBoardPass>& passes;
+    std::atomic<int>& first_found;
+};
+
+// Runs the fallback passes k in [0, max_k), dilations in [min_dilations, max_dilations] until
+// one finds the board. With `adaptive` every pass thresholds `img`, otherwise the passes keep dilating
+// the binarized `chain_img`. out_corners and prev_sqr_size end up as after the serial loop.
+static bool findChessboardPasses(const Mat& img, Mat& chain_img, Size pattern_size, int flags, bool adaptive,
+                                 int max_k, int min_dilations, int max_dilations,
+                                 std::vector<cv::Point2f>& out_corners, int& prev_sqr_size)
+{
+    std::vector<ChessBoardPass> passes;
+    for (int k = 0; k < max_k; k++)
+        for (int dilations = min_dilations; dilations <= max_dilations; dilations++)
+            passes.push_back(ChessBoardPass(k, dilations));
+
+#ifdef DEBUG_CHESSBOARD
+    const int max_wave = 1; // keep the debug windows in the serial order
+#else
+    const int max_wave = std::max(getNumThreads(), 1);
+#endif
+    const int count = (int)passes.size();
+    int next = 0, built = 0;
+    while (next < count)
+    {
+        const int end = std::min(count, next + max_wave);
+        for (int i = next; i < end; ++i)
+        {
+            ChessBoardPass& pass = passes[i];
+            pass.evaluated = pass.found = false;
+            pass.corners.clear();
+            pass.sqr_size = -1;
+            if (adaptive)
+            {
+                pass.block_size = adaptiveBlockSize(img, pass.k, prev_sqr_size);
+            }
+            else if (i == built)
+            {
+                dilate( chain_img, chain_img, Mat(), Point(-1, -1), 1 );
+                drawBinarizedBorder(chain_img);
+                pass.image = chain_img.clone();
+                built++;
+            }
+        }
+
+        std::atomic<int> first_found(INT_MAX);
+        parallel_for_(Range(next, end), ChessBoardPassInvoker(img, pattern_size, flags, adaptive, passes, first_found));
+
+        // commit in the serial order, up to a skipped pass or one that ran with a stale block size
+        for (; next < end; ++next)
+        {
+            ChessBoardPass& pass = passes[next];
+            if (!pass.evaluated ||
+                (adaptive && pass.block_size != adaptiveBlockSize(img, pass.k, prev_sqr_size)))
+                break;
+            if (pass.sqr_size >= 0)
+                prev_sqr_size = pass.sqr_size;
+            out_corners.swap(pass.corners);
+            pass.image.release();
+            if (pass.found)
+                return true;
+        }
+    }
+    return false;
+}
+
 bool findChessboardCorners(InputArray image_, Size pattern_size,
                            OutputArray corners_, int flags)
 {
@@ -594,51 +728,8 @@ bool findChessboardCorners(InputArray image_, Size pattern_size,
         }
         //if flag CALIB_CB_ADAPTIVE_THRESH is not set it doesn't make sense to iterate over k
         int max_k = useAdaptive ? 6 : 1;
-        for (int k = 0; k < max_k && !found; k++)
-        {
-            for (int dilations = min_dilations; dilations <= max_dilations; dilations++)
-            {
-                // convert the input grayscale image to binary (black-n-white)
-                if (useAdaptive)
-                {
-                    int block_size = cvRound(prev_sqr_size == 0
-                                             ? std::min(img.cols, img.rows) * (k % 2 == 0 ? 0.2 : 0.1)
-                                             : prev_sqr_size * 2);
-                    block_size = block_size | 1;
-                    // convert to binary
-                    adaptiveThreshold( img, thresh_img, 255, ADAPTIVE_THRESH_MEAN_C, THRESH_BINARY, block_size, (k/2)*5 );
-                    if (dilations > 0)
-                        dilate( thresh_img, thresh_img, Mat(), Point(-1, -1), dilations-1 );
-
-                }
-                else
-                {
-                    dilate( thresh_img, thresh_img, Mat(), Point(-1, -1), 1 );
-                }
-                SHOW("Old binarization", thresh_img);
-
-                // So we can find rectangles that go to the edge, we draw a white line around the image edge.
-                // Otherwise FindContours will miss those clipped rectangle contours.
-                // The border color will be the image mean, because otherwise we risk screwing up filters like cvSmooth()...
-                rectangle( thresh_img, Point(0,0), Point(thresh_img.cols-1, thresh_img.rows-1), Scalar(255,255,255), 3, LINE_8);
-
-                detector.reset();
-
-#ifdef USE_CV_FINDCONTOURS
-                Mat binarized_img = thresh_img;
-#else
-                Mat binarized_img = (useAdaptive) ? thresh_img : thresh_img.clone(); // make clone because cvFindContours modifies the source image
-#endif
-                detector.generateQuads(binarized_img, flags);
-                DPRINTF("Quad count: %d/%d", detector.all_quads_count, (pattern_size.width/2+1)*(pattern_size.height/2+1));
-                SHOW_QUADS("Old quads", thresh_img, &detector.all_quads[0], detector.all_quads_count);
-                if (detector.processQuads(out_corners, prev_sqr_size))
-                {
-                    found = 1;
-                    break;
-                }
-            }
-        }
+        found = findChessboardPasses(img, thresh_img, pattern_size, flags, useAdaptive,
+                                     max_k, min_dilations, max_dilations, out_corners, prev_sqr_size);
     }
 
     DPRINTF("Chessboard detection result 1: %d", (int)found);
@@ -1614,6 +1705,7 @@ finalize:
 void ChessBoardDetector::findQuadNeighbors()
 {
     const float thresh_scale = 1.f;
+    const QuadCornerGrid grid(&all_quads[0], all_quads_count);
     // find quad neighbors
     for (int idx = 0; idx < all_quads_count; idx++)
     {
@@ -1630,50 +1722,17 @@ void ChessBoardDetector::findQuadNeighbors()
             if (cur_quad.neighbors[i])
                 continue;
 
-            float min_dist = FLT_MAX;
-            int closest_corner_idx = -1;
-            ChessBoardQuad *closest_quad = 0;
-
             cv::Point2f pt = cur_quad.corners[i]->pt;
 
             // find the closest corner in all other quadrangles
-            for (int k = 0; k < all_quads_count; k++)
-            {
-                if (k == idx)
-                    continue;
-
-                ChessBoardQuad& q_k = all_quads[k];
-
-                for (int j = 0; j < 4; j++)
-                {
-                    if (q_k.neighbors[j])
-                        continue;
-
-                    float dist = normL2Sqr<float>(pt - q_k.corners[j]->pt);
-                    if (dist < min_dist &&
-                        dist <= cur_quad.edge_len*thresh_scale &&
-                        dist <= q_k.edge_len*thresh_scale )
-                    {
-                        // check edge lengths, make sure they're compatible
-                        // edges that are different by more than 1:4 are rejected
-                        float ediff = cur_quad.edge_len - q_k.edge_len;
-                        if (ediff > 32*cur_quad.edge_len ||
-                            ediff > 32*q_k.edge_len)
-                        {
-                            DPRINTF("Incompatible edge lengths");
-                            continue;
-                        }
-                        closest_corner_idx = j;
-                        closest_quad = &q_k;
-                        min_dist = dist;
-                    }
-                }
-            }
+            float min_dist = FLT_MAX;
+            int closest = grid.findClosestCorner(idx, pt, thresh_scale, min_dist);
 
             // we found a matching corner point?
-            if (closest_corner_idx >= 0 && min_dist < FLT_MAX)
+            if (closest >= 0 && min_dist < FLT_MAX)
             {
-                CV_Assert(closest_quad);
+                const int closest_corner_idx = closest & 3;
+                ChessBoardQuad *closest_quad = &all_quads[closest >> 2];
 
                 if (cur_quad.count >= 4 || closest_quad->count >= 4)
                     continue;
@@ -1707,25 +1766,7 @@ void ChessBoardDetector::findQuadNeighbors()
 
                 // check whether the closest corner to closest_corner
                 // is different from cur_quad->corners[i]->pt
-                for (j = 0; j < all_quads_count; j++ )
-                {
-                    ChessBoardQuad* q = &const_cast<ChessBoardQuad&>(all_quads[j]);
-                    if (j == idx || q == closest_quad)
-                        continue;
-
-                    int k = 0;
-                    for (; k < 4; k++ )
-                    {
-                        if (!q->neighbors[k])
-                        {
-                            if (normL2Sqr<float>(closest_corner.pt - q->corners[k]->pt) < min_dist)
-                                break;
-                        }
-                    }
-                    if (k < 4)
-                        break;
-                }
-                if (j < all_quads_count)
+                if (grid.hasCloserCorner(closest_corner.pt, min_dist, idx, closest >> 2))
                     continue;
 
                 closest_corner.pt = (pt + closest_corner.pt) * 0.5f;
@@ -0,0 +1,231 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+#ifndef OPENCV_CALIB3D_CHESSBOARD_QUADS_HPP
+#define OPENCV_CALIB3D_CHESSBOARD_QUADS_HPP
+
+// Quads of the chessboard detector (calibinit.cpp) and the corner lookup of findQuadNeighbors.
+// Internal, kept in a header for the tests.
+
+#include "opencv2/core.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <vector>
+
+namespace cv {
+
+/** This structure stores information about the chessboard corner.*/
+struct ChessBoardCorner
+{
+    cv::Point2f pt;  // Coordinates of the corner
+    int row;         // Board row index
+    int count;       // Number of neighbor corners
+    struct ChessBoardCorner* neighbors[4]; // Neighbor corners
+
+    ChessBoardCorner(const cv::Point2f& pt_ = cv::Point2f()) :
+        pt(pt_), row(0), count(0)
+    {
+        neighbors[0] = neighbors[1] = neighbors[2] = neighbors[3] = NULL;
+    }
+
+    float sumDist(int& n_) const
+    {
+        float sum = 0;
+        int n = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            if (neighbors[i])
+            {
+                sum += sqrt(normL2Sqr<float>(neighbors[i]->pt - pt));
+                n++;
+            }
+        }
+        n_ = n;
+        return sum;
+    }
+};
+
+
+/** This structure stores information about the chessboard quadrangle.*/
+struct ChessBoardQuad
+{
+    int count;      // Number of quad neighbors
+    int group_idx;  // quad group ID
+    int row, col;   // row and column of this quad
+    bool ordered;   // true if corners/neighbors are ordered counter-clockwise
+    float edge_len; // quad edge len, in pix^2
+    // neighbors and corners are synced, i.e., neighbor 0 shares corner 0
+    ChessBoardCorner *corners[4]; // Coordinates of quad corners
+    struct ChessBoardQuad *neighbors[4]; // Pointers of quad neighbors
+
+    ChessBoardQuad(int group_idx_ = -1) :
+        count(0),
+        group_idx(group_idx_),
+        row(0), col(0),
+        ordered(0),
+        edge_len(0)
+    {
+        corners[0] = corners[1] = corners[2] = corners[3] = NULL;
+        neighbors[0] = neighbors[1] = neighbors[2] = neighbors[3] = NULL;
+    }
+};
+
+/*
+ * Uniform grid over the quad corners for findQuadNeighbors, so that the closest corner is
+ * looked up among the cells around a point instead of in all quads (O(n^2) on cluttered
+ * images with thousands of quads).
+ *
+ * Entries are quad_idx*4 + corner_idx, bucketed by the corner position at build time. Only
+ * corners without a neighbor are ever matched and those have not moved since, so the grid
+ * stays valid while findQuadNeighbors merges corners. Matches never lie farther away than the
+ * quad edge; the queries keep the candidate with the lowest entry among equally close ones,
+ * which is the one a scan over all quads picks. Below MIN_GRID_QUADS quads the grid is a
+ * single cell, i.e. that scan.
+ */
+class QuadCornerGrid
+{
+public:
+    QuadCornerGrid(const ChessBoardQuad* quads_, int quads_count) :
+        quads(quads_), inv_cell_size(1.f), cols(1), rows(1)
+    {
+        origin = Point2f(FLT_MAX, FLT_MAX);
+        Point2f br(-FLT_MAX, -FLT_MAX);
+        for (int e = 0; e < quads_count * 4; e++)
+        {
+            const Point2f& pt = quads[e >> 2].corners[e & 3]->pt;
+            origin.x = std::min(origin.x, pt.x); origin.y = std::min(origin.y, pt.y);
+            br.x = std::max(br.x, pt.x); br.y = std::max(br.y, pt.y);
+        }
+
+        // cells of a typical quad edge, but not much more cells than corners
+        if (quads_count >= MIN_GRID_QUADS)
+        {
+            std::vector<float> edge_lens(quads_count);
+            for (int idx = 0; idx < quads_count; idx++)
+                edge_lens[idx] = quads[idx].edge_len;
+            std::nth_element(edge_lens.begin(), edge_lens.begin() + quads_count/2, edge_lens.end());
+            double w = (double)br.x - origin.x, h = (double)br.y - origin.y;
+            double size = std::max(std::sqrt((double)edge_lens[quads_count/2]), 1.0);
+            size = std::max(size, std::sqrt(w * h / (4.0 * quads_count)));
+            cols = cvFloor(w / size) + 1;
+            rows = cvFloor(h / size) + 1;
+            inv_cell_size = (float)(1.0 / size);
+        }
+
+        cell_start.assign(cols * rows + 1, 0);
+        std::vector<int> cell_of(quads_count * 4);
+        for (int e = 0; e < quads_count * 4; e++)
+        {
+            cell_of[e] = cellOf(quads[e >> 2].corners[e & 3]->pt);
+            cell_start[cell_of[e] + 1]++;
+        }
+        for (int c = 0; c < cols * rows; c++)
+            cell_start[c + 1] += cell_start[c];
+        entries.resize(quads_count * 4);
+        std::vector<int> fill(cell_start.begin(), cell_start.end() - 1);
+        for (int e = 0; e < quads_count * 4; e++)
+            entries[fill[cell_of[e]]++] = e;
+    }
+
+    // Closest corner without a neighbor in the quads other than cur_idx that is not farther
+    // than the edge of either quad, and whose quad edge is compatible. Returns the entry or -1.
+    int findClosestCorner(int cur_idx, const Point2f& pt, float thresh_scale, float& min_dist) const
+    {
+        const ChessBoardQuad& cur_quad = quads[cur_idx];
+        int closest = -1;
+        min_dist = FLT_MAX;
+        int x0, y0, x1, y1;
+        cellRange(pt, cur_quad.edge_len*thresh_scale, x0, y0, x1, y1);
+        for (int y = y0; y <= y1; y++)
+        {
+            for (int x = x0; x <= x1; x++)
+            {
+                for (int n = cell_start[y*cols + x], end = cell_start[y*cols + x + 1]; n < end; n++)
+                {
+                    const int e = entries[n], k = e >> 2, j = e & 3;
+                    const ChessBoardQuad& q_k = quads[k];
+                    if (k == cur_idx || q_k.neighbors[j])
+                        continue;
+
+                    float dist = normL2Sqr<float>(pt - q_k.corners[j]->pt);
+                    if ((dist < min_dist || (dist == min_dist && e < closest)) &&
+                        dist <= cur_quad.edge_len*thresh_scale &&
+                        dist <= q_k.edge_len*thresh_scale )
+                    {
+                        // check edge lengths, make sure they're compatible
+                        // edges that are different by more than 1:4 are rejected
+                        float ediff = cur_quad.edge_len - q_k.edge_len;
+                        if (ediff > 32*cur_quad.edge_len ||
+                            ediff > 32*q_k.edge_len)
+                            continue;
+                        closest = e;
+                        min_dist = dist;
+                    }
+                }
+            }
+        }
+        return closest;
+    }
+
+    // Whether a corner without a neighbor of a quad other than skip_a and skip_b lies closer than dist to pt
+    bool hasCloserCorner(const Point2f& pt, float dist, int skip_a, int skip_b) const
+    {
+        int x0, y0, x1, y1;
+        cellRange(pt, dist, x0, y0, x1, y1);
+        for (int y = y0; y <= y1; y++)
+        {
+            for (int x = x0; x <= x1; x++)
+            {
+                for (int n = cell_start[y*cols + x], end = cell_start[y*cols + x + 1]; n < end; n++)
+                {
+                    const int e = entries[n], k = e >> 2;
+                    if (k == skip_a || k == skip_b || quads[k].neighbors[e & 3])
+                        continue;
+                    if (normL2Sqr<float>(pt - quads[k].corners[e & 3]->pt) < dist)
+                        return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // below this count a scan over all corners is as fast as the grid
+    enum { MIN_GRID_QUADS = 32 };
+
+private:
+    int cellOf(const Point2f& pt) const
+    {
+        int x = std::min(std::max(cvFloor((pt.x - origin.x) * inv_cell_size), 0), cols - 1);
+        int y = std::min(std::max(cvFloor((pt.y - origin.y) * inv_cell_size), 0), rows - 1);
+        return y*cols + x;
+    }
+
+    // Cells that may hold a point within squared distance dist2 of pt. The radius is padded by
+    // a pixel so that rounding in normL2Sqr cannot reach points outside of the range.
+    void cellRange(const Point2f& pt, float dist2, int& x0, int& y0, int& x1, int& y1) const
+    {
+        const float r = std::sqrt(std::max(dist2, 0.f)) + 1.f;
+        x0 = cellCoord(pt.x - origin.x - r, cols); x1 = cellCoord(pt.x - origin.x + r, cols);
+        y0 = cellCoord(pt.y - origin.y - r, rows); y1 = cellCoord(pt.y - origin.y + r, rows);
+    }
+
+    int cellCoord(float offset, int count) const
+    {
+        // clamp in float first, the radius may be huge for large quads
+        float c = std::min(std::max(offset * inv_cell_size, 0.f), (float)(count - 1));
+        return cvFloor(c);
+    }
+
+    const ChessBoardQuad* quads;
+    Point2f origin;
+    float inv_cell_size;
+    int cols, rows;
+    std::vector<int> cell_start;  // entries of cell c are entries[cell_start[c] .. cell_start[c+1])
+    std::vector<int> entries;
+};
+
+} // namespace cv
+
+#endif // OPENCV_CALIB3D_CHESSBOARD_QUADS_HPP
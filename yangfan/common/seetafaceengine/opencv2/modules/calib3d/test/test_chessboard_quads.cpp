@@ -0,0 +1,293 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+#include "test_precomp.hpp"
+#include "../src/chessboard_quads.hpp"
+
+namespace opencv_test { namespace {
+
+// Quads for the grid, the corners are owned by the set
+struct QuadSet
+{
+    std::vector<ChessBoardCorner> corners;
+    std::vector<ChessBoardQuad> quads;
+
+    explicit QuadSet(int count) : corners(count * 4), quads(count)
+    {
+        for (int k = 0; k < count; k++)
+            for (int j = 0; j < 4; j++)
+                quads[k].corners[j] = &corners[k*4 + j];
+    }
+
+    int count() const { return (int)quads.size(); }
+
+    // shortest squared side, as generateQuads computes it
+    void setEdgeLengths()
+    {
+        for (int k = 0; k < count(); k++)
+        {
+            float edge_len = FLT_MAX;
+            for (int j = 0; j < 4; j++)
+                edge_len = std::min(edge_len, normL2Sqr<float>(quads[k].corners[j]->pt - quads[k].corners[(j + 1) & 3]->pt));
+            quads[k].edge_len = edge_len;
+        }
+    }
+
+    // Links about a quarter of the corners like findQuadNeighbors does while it runs. Linked
+    // corners may be moved afterwards, the grid must not see them anymore.
+    void linkSome(RNG& rng, float move)
+    {
+        for (int k = 0; k < count(); k++)
+        {
+            for (int j = 0; j < 4; j++)
+            {
+                if (quads[k].neighbors[j] || rng.uniform(0, 4) != 0)
+                    continue;
+                quads[k].neighbors[j] = &quads[rng.uniform(0, count())];
+                quads[k].corners[j]->pt += Point2f(rng.uniform(-move, move), rng.uniform(-move, move));
+            }
+        }
+    }
+
+private:
+    QuadSet(const QuadSet&);
+    QuadSet& operator=(const QuadSet&);
+};
+
+// The search of findQuadNeighbors before the grid: all corners of all other quads
+static int scanClosestCorner(const QuadSet& set, int cur_idx, const Point2f& pt, float thresh_scale, float& min_dist)
+{
+    const ChessBoardQuad& cur_quad = set.quads[cur_idx];
+    int closest = -1;
+    min_dist = FLT_MAX;
+    for (int k = 0; k < set.count(); k++)
+    {
+        if (k == cur_idx)
+            continue;
+        const ChessBoardQuad& q_k = set.quads[k];
+        for (int j = 0; j < 4; j++)
+        {
+            if (q_k.neighbors[j])
+                continue;
+            float dist = normL2Sqr<float>(pt - q_k.corners[j]->pt);
+            if (dist < min_dist &&
+                dist <= cur_quad.edge_len*thresh_scale &&
+                dist <= q_k.edge_len*thresh_scale)
+            {
+                float ediff = cur_quad.edge_len - q_k.edge_len;
+                if (ediff > 32*cur_quad.edge_len || ediff > 32*q_k.edge_len)
+                    continue;
+                closest = k*4 + j;
+                min_dist = dist;
+            }
+        }
+    }
+    return closest;
+}
+
+static bool scanCloserCorner(const QuadSet& set, const Point2f& pt, float dist, int skip_a, int skip_b)
+{
+    for (int k = 0; k < set.count(); k++)
+    {
+        if (k == skip_a || k == skip_b)
+            continue;
+        for (int j = 0; j < 4; j++)
+            if (!set.quads[k].neighbors[j] && normL2Sqr<float>(pt - set.quads[k].corners[j]->pt) < dist)
+                return true;
+    }
+    return false;
+}
+
+static void checkLookup(const QuadSet& set, const QuadCornerGrid& grid, int idx, const Point2f& pt, float thresh_scale, RNG& rng)
+{
+    float min_dist = 0, scan_dist = 0;
+    int closest = grid.findClosestCorner(idx, pt, thresh_scale, min_dist);
+    int scan_closest = scanClosestCorner(set, idx, pt, thresh_scale, scan_dist);
+    ASSERT_EQ(scan_closest, closest) << "quad " << idx << " at " << pt << " scale " << thresh_scale;
+    ASSERT_EQ(scan_dist, min_dist) << "quad " << idx << " at " << pt << " scale " << thresh_scale;
+
+    // findQuadNeighbors asks around the matched corner with the match distance
+    const int skip_b = closest >= 0 ? closest >> 2 : rng.uniform(0, set.count());
+    const Point2f around[] = { pt, closest >= 0 ? set.quads[closest >> 2].corners[closest & 3]->pt : pt };
+    const float edge_len = set.quads[idx].edge_len;
+    const float dists[] = { min_dist, edge_len, rng.uniform(0.f, 2*edge_len + 1), 0.f, FLT_MAX };
+    for (int a = 0; a < 2; a++)
+    {
+        for (size_t d = 0; d < sizeof(dists)/sizeof(dists[0]); d++)
+        {
+            ASSERT_EQ(scanCloserCorner(set, around[a], dists[d], idx, skip_b), grid.hasCloserCorner(around[a], dists[d], idx, skip_b))
+                << "quad " << idx << " at " << around[a] << " dist " << dists[d];
+        }
+    }
+}
+
+// Lookups from every unlinked corner, as findQuadNeighbors makes them, and from extra points
+// on behalf of random quads
+static void checkLookups(const QuadSet& set, const std::vector<Point2f>& extra, RNG& rng)
+{
+    const QuadCornerGrid grid(&set.quads[0], set.count());
+    const float scales[] = { 1.f, 2.5f };
+    for (int s = 0; s < 2; s++)
+    {
+        for (int idx = 0; idx < set.count(); idx++)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                if (set.quads[idx].neighbors[i])
+                    continue;
+                checkLookup(set, grid, idx, set.quads[idx].corners[i]->pt, scales[s], rng);
+                if (::testing::Test::HasFatalFailure())
+                    return;
+            }
+        }
+        for (size_t p = 0; p < extra.size(); p++)
+        {
+            checkLookup(set, grid, rng.uniform(0, set.count()), extra[p], scales[s], rng);
+            if (::testing::Test::HasFatalFailure())
+                return;
+        }
+    }
+}
+
+// Lookups again after more corners were linked and moved behind the back of the grid
+static void checkLookupsWhileLinking(QuadSet& set, const std::vector<Point2f>& extra, RNG& rng)
+{
+    const QuadCornerGrid grid(&set.quads[0], set.count());
+    for (int round = 0; round < 3; round++)
+    {
+        for (int idx = 0; idx < set.count(); idx++)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                if (set.quads[idx].neighbors[i])
+                    continue;
+                checkLookup(set, grid, idx, set.quads[idx].corners[i]->pt, 1.f, rng);
+                if (::testing::Test::HasFatalFailure())
+                    return;
+            }
+        }
+        for (size_t p = 0; p < extra.size(); p++)
+        {
+            checkLookup(set, grid, rng.uniform(0, set.count()), extra[p], 1.f, rng);
+            if (::testing::Test::HasFatalFailure())
+                return;
+        }
+        set.linkSome(rng, 20.f);
+    }
+}
+
+static void addQuad(QuadSet& set, int k, const Point2f& center, float side, RNG& rng)
+{
+    const float angle = rng.uniform(0.f, (float)CV_PI);
+    for (int j = 0; j < 4; j++)
+    {
+        float a = angle + j * (float)CV_PI / 2, r = side * (float)CV_SQRT2 / 2 * rng.uniform(0.8f, 1.2f);
+        set.quads[k].corners[j]->pt = center + Point2f(r * std::cos(a), r * std::sin(a));
+    }
+}
+
+static std::vector<Point2f> randomPoints(int count, const Rect2f& area, RNG& rng)
+{
+    std::vector<Point2f> pts(count);
+    for (int i = 0; i < count; i++)
+        pts[i] = Point2f(rng.uniform(area.x, area.x + area.width), rng.uniform(area.y, area.y + area.height));
+    return pts;
+}
+
+static const int quad_counts[] = { 1, 2, 8, QuadCornerGrid::MIN_GRID_QUADS - 1, QuadCornerGrid::MIN_GRID_QUADS,
+                                   QuadCornerGrid::MIN_GRID_QUADS + 1, 150, 600 };
+
+TEST(Calib3d_ChessboardQuadGrid, random)
+{
+    RNG& rng = theRNG();
+    for (size_t c = 0; c < sizeof(quad_counts)/sizeof(quad_counts[0]); c++)
+    {
+        SCOPED_TRACE(cv::format("%d quads", quad_counts[c]));
+        QuadSet set(quad_counts[c]);
+        for (int k = 0; k < set.count(); k++)
+        {
+            // mostly clutter sized quads, some that span a good part of the image
+            float side = rng.uniform(0, 20) == 0 ? rng.uniform(100.f, 400.f) : rng.uniform(3.f, 40.f);
+            addQuad(set, k, Point2f(rng.uniform(0.f, 640.f), rng.uniform(0.f, 480.f)), side, rng);
+        }
+        set.setEdgeLengths();
+        set.linkSome(rng, 0.f);
+        std::vector<Point2f> extra = randomPoints(200, Rect2f(-50.f, -50.f, 740.f, 580.f), rng);
+
+        checkLookups(set, extra, rng);
+        ASSERT_FALSE(HasFatalFailure());
+        checkLookupsWhileLinking(set, extra, rng);
+        ASSERT_FALSE(HasFatalFailure());
+    }
+}
+
+TEST(Calib3d_ChessboardQuadGrid, clustered)
+{
+    RNG& rng = theRNG();
+    for (size_t c = 0; c < sizeof(quad_counts)/sizeof(quad_counts[0]); c++)
+    {
+        SCOPED_TRACE(cv::format("%d quads", quad_counts[c]));
+        QuadSet set(quad_counts[c]);
+
+        // a few tight clusters of overlapping small quads far apart, plus two lone quads that
+        // stretch the bounding box, so that whole clusters fall into a cell or two
+        const Point2f clusters[] = { Point2f(100.f, 100.f), Point2f(110.f, 95.f), Point2f(3000.f, 200.f), Point2f(1500.f, 2500.f) };
+        for (int k = 0; k < set.count(); k++)
+        {
+            if (k == 1)
+                addQuad(set, k, Point2f(-2000.f, -1500.f), 10.f, rng);
+            else if (k == 2)
+                addQuad(set, k, Point2f(6000.f, 4000.f), 10.f, rng);
+            else
+            {
+                Point2f center = clusters[rng.uniform(0, 4)] + Point2f((float)rng.gaussian(8.0), (float)rng.gaussian(8.0));
+                addQuad(set, k, center, rng.uniform(1.f, 12.f), rng);
+            }
+        }
+        set.setEdgeLengths();
+        set.linkSome(rng, 0.f);
+        std::vector<Point2f> extra;
+        for (int i = 0; i < 200; i++)
+            extra.push_back(clusters[i % 4] + Point2f((float)rng.gaussian(10.0), (float)rng.gaussian(10.0)));
+
+        checkLookups(set, extra, rng);
+        ASSERT_FALSE(HasFatalFailure());
+        checkLookupsWhileLinking(set, extra, rng);
+        ASSERT_FALSE(HasFatalFailure());
+    }
+}
+
+// Corners on a lattice of the cell size: every corner lies on a cell border, many corners
+// coincide and queries halfway between lattice points are equally close to several corners
+TEST(Calib3d_ChessboardQuadGrid, ties_on_cell_borders)
+{
+    RNG& rng = theRNG();
+    const int step = 4, lattice = 16; // the median edge_len of step*step makes step the cell size
+    for (size_t c = 0; c < sizeof(quad_counts)/sizeof(quad_counts[0]); c++)
+    {
+        SCOPED_TRACE(cv::format("%d quads", quad_counts[c]));
+        QuadSet set(quad_counts[c]);
+        for (int k = 0; k < set.count(); k++)
+        {
+            for (int j = 0; j < 4; j++)
+                set.corners[k*4 + j].pt = Point2f((float)(rng.uniform(0, lattice + 1) * step), (float)(rng.uniform(0, lattice + 1) * step));
+            set.quads[k].edge_len = (float)(rng.uniform(0, 4) == 0 ? 4 * step * step : step * step);
+        }
+        // pin the bounding box to the lattice
+        set.corners[0].pt = Point2f(0.f, 0.f);
+        set.corners[set.count()*4 - 1].pt = Point2f((float)(lattice * step), (float)(lattice * step));
+        set.linkSome(rng, 0.f);
+
+        std::vector<Point2f> extra;
+        for (int y = -2; y <= 2 * lattice + 2; y++)
+            for (int x = -2; x <= 2 * lattice + 2; x++)
+                extra.push_back(Point2f(x * step * 0.5f, y * step * 0.5f));
+
+        checkLookups(set, extra, rng);
+        ASSERT_FALSE(HasFatalFailure());
+        checkLookupsWhileLinking(set, extra, rng);
+        ASSERT_FALSE(HasFatalFailure());
+    }
+}
+
+}} // namespace
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HOS_CAMERA_VIVID_HARNESS_H
+#define HOS_CAMERA_VIVID_HARNESS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <iostream>
+#include "v4l2_dev.h"
+#include "buffer_manager.h"
+#include "rk_scale_node.h"
+
+namespace OHOS::Camera {
+// The vivid test driver provides a V4L2 capture node on any Linux host:
+//     modprobe vivid n_devs=1 node_types=0x1
+// Its VIDIOC_QUERYCAP driver name is the camera id HosV4L2Dev matches against.
+#define VIVID_CAMERA_ID "vivid"
+
+struct VividConfig {
+    uint32_t pixelFormat = V4L2_PIX_FMT_YUYV;
+    uint32_t width = 640;
+    uint32_t height = 480;
+    uint32_t bufferCount = 4;
+    uint32_t frames = 60;
+    bool scale = true;          // start the half and quarter size streams of the RKScale node
+};
+
+struct VividStats {
+    uint32_t frames = 0;
+    uint32_t scaledFrames = 0;  // buffers the sink received on the scaled streams
+    double fps = 0.0;
+    double latencyAvgUs = 0.0;  // dequeue callback until the sink has every stream of the frame
+    double latencyMaxUs = 0.0;
+    double cpuPercent = 0.0;    // process CPU time over wall time while streaming
+};
+
+// End of the test pipeline: counts what arrives and hands pool buffers back to their pool.
+class VividSinkNode : public NodeBase {
+public:
+    VividSinkNode(const std::string& name, const std::string& type);
+    ~VividSinkNode() override = default;
+    void DeliverBuffer(std::shared_ptr<IBuffer>& buffer) override;
+
+    std::atomic<uint32_t> sourceFrames_ {0};
+    std::atomic<uint32_t> scaledFrames_ {0};
+};
+
+// Streams vivid through source -> RKScale -> sink, the same node, port and buffer pool path a
+// camera stream takes: the capture size stream carries the V4L2 buffer itself and the scaled
+// streams get their buffers from BufferManager pools.
+class VividHarness {
+public:
+    VividHarness();
+    ~VividHarness();
+
+    static bool Available();
+    RetCode Run(const VividConfig& config, VividStats& stats);
+
+private:
+    struct Pending {
+        std::shared_ptr<FrameSpec> frame;
+        int64_t dequeueNs;
+    };
+
+    static void OnFrame(std::shared_ptr<FrameSpec> frame);
+    RetCode AllocBuffers(const DeviceFormat& format, uint32_t count);
+    void FreeBuffers();
+    void Stream(const VividConfig& config, VividStats& stats);
+    bool BuildPipeline(const VividConfig& config);
+    void ReleasePipeline();
+    static int64_t NowNs();
+    static int64_t CpuNs();
+
+    static VividHarness* current_;
+    std::shared_ptr<HosV4L2Dev> dev_;
+    std::vector<std::shared_ptr<FrameSpec>> buffers_;
+    std::vector<void*> memory_;
+    std::mutex lock_;
+    std::condition_variable cv_;
+    std::deque<Pending> pending_;
+    uint32_t cameraFormat_ = 0;
+    std::shared_ptr<NodeBase> source_;
+    std::shared_ptr<RKScaleNode> scale_;
+    std::shared_ptr<VividSinkNode> sink_;
+    std::shared_ptr<IPort> sourcePort_;
+    std::vector<int32_t> scaledStreams_;
+    std::vector<std::shared_ptr<IBufferPool>> pools_;
+};
+} // namespace OHOS::Camera
+#endif
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "utest_v4l2_vivid.h"
+
+using namespace testing::ext;
+namespace OHOS::Camera {
+namespace {
+constexpr double MIN_FPS = 5.0;
+constexpr double MAX_LATENCY_US = 100000.0;
+constexpr uint32_t SCALED_STREAMS = 2;
+}
+
+bool UtestV4L2Vivid::available_ = false;
+
+void UtestV4L2Vivid::SetUpTestCase(void)
+{
+    available_ = VividHarness::Available();
+    std::cout << "vivid device " << (available_ ? "found" : "not loaded, tests skipped") << std::endl;
+}
+
+void UtestV4L2Vivid::TearDownTestCase(void)
+{
+    std::cout << "TearDownTestCase.." << std::endl;
+}
+
+void UtestV4L2Vivid::SetUp(void)
+{
+    if (!available_) {
+        GTEST_SKIP() << "modprobe vivid to run the V4L2 regression suite";
+    }
+}
+
+void UtestV4L2Vivid::TearDown(void)
+{
+}
+
+void UtestV4L2Vivid::StreamAndCheck(const VividConfig& config)
+{
+    VividHarness harness;
+    VividStats stats;
+    EXPECT_EQ(RC_OK, harness.Run(config, stats));
+    EXPECT_EQ(config.frames, stats.frames);
+    // every frame crosses RKScale into the half and quarter size streams when they run
+    EXPECT_EQ(config.scale ? config.frames * SCALED_STREAMS : 0, stats.scaledFrames);
+    EXPECT_GT(stats.fps, MIN_FPS);
+    EXPECT_LT(stats.latencyAvgUs, MAX_LATENCY_US);
+    std::cout << "fps " << stats.fps << " latency " << stats.latencyAvgUs << "us max " << stats.latencyMaxUs <<
+        "us cpu " << stats.cpuPercent << "%" << std::endl;
+}
+
+HWTEST_F(UtestV4L2Vivid, StreamYuyv, TestSize.Level0)
+{
+    VividConfig config;
+    config.pixelFormat = V4L2_PIX_FMT_YUYV;
+    StreamAndCheck(config);
+}
+
+HWTEST_F(UtestV4L2Vivid, StreamNv12, TestSize.Level0)
+{
+    VividConfig config;
+    config.pixelFormat = V4L2_PIX_FMT_NV12;
+    StreamAndCheck(config);
+}
+
+HWTEST_F(UtestV4L2Vivid, StreamRgba, TestSize.Level0)
+{
+    VividConfig config;
+    config.pixelFormat = V4L2_PIX_FMT_ABGR32;
+    StreamAndCheck(config);
+}
+
+HWTEST_F(UtestV4L2Vivid, BufferCounts, TestSize.Level0)
+{
+    constexpr uint32_t counts[] = { 2, 4, 8 };
+    for (auto count : counts) {
+        VividConfig config;
+        config.bufferCount = count;
+        StreamAndCheck(config);
+    }
+}
+
+HWTEST_F(UtestV4L2Vivid, NoScale, TestSize.Level0)
+{
+    VividConfig config;
+    config.scale = false;
+    StreamAndCheck(config);
+}
+
+HWTEST_F(UtestV4L2Vivid, Restart, TestSize.Level0)
+{
+    // stop must hand every buffer back, otherwise the second REQBUFS fails with EBUSY
+    constexpr uint32_t restarts = 3;
+    VividConfig config;
+    config.frames = 10;
+    for (uint32_t i = 0; i < restarts; ++i) {
+        StreamAndCheck(config);
+    }
+}
+
+HWTEST_F(UtestV4L2Vivid, RejectUnknownFormat, TestSize.Level0)
+{
+    VividConfig config;
+    config.pixelFormat = v4l2_fourcc('X', 'X', 'X', 'X');
+    VividHarness harness;
+    VividStats stats;
+    EXPECT_EQ(RC_ERROR, harness.Run(config, stats));
+    EXPECT_EQ(0, stats.frames);
+}
+
+} // namespace OHOS::Camera
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <benchmark/benchmark.h>
+#include "vivid_harness.h"
+
+using namespace OHOS::Camera;
+
+namespace {
+constexpr uint32_t BENCH_FRAMES = 120;
+
+// args: pixel format, buffer count, scale fan-out on/off
+void BM_VividStream(benchmark::State& state)
+{
+    if (!VividHarness::Available()) {
+        state.SkipWithError("vivid not loaded");
+        return;
+    }
+    VividConfig config;
+    config.pixelFormat = static_cast<uint32_t>(state.range(0));
+    config.bufferCount = static_cast<uint32_t>(state.range(1));
+    config.scale = state.range(2) != 0;
+    config.frames = BENCH_FRAMES;
+
+    VividStats total;
+    uint32_t runs = 0;
+    for (auto _ : state) {
+        VividHarness harness;
+        VividStats stats;
+        if (harness.Run(config, stats) != RC_OK) {
+            state.SkipWithError("stream failed");
+            return;
+        }
+        total.frames += stats.frames;
+        total.fps += stats.fps;
+        total.latencyAvgUs += stats.latencyAvgUs;
+        total.latencyMaxUs = std::max(total.latencyMaxUs, stats.latencyMaxUs);
+        total.cpuPercent += stats.cpuPercent;
+        runs++;
+    }
+    if (runs == 0) {
+        return;
+    }
+    state.SetItemsProcessed(total.frames);
+    state.counters["fps"] = total.fps / runs;
+    state.counters["latency_us"] = total.latencyAvgUs / runs;
+    state.counters["latency_max_us"] = total.latencyMaxUs;
+    state.counters["cpu_pct"] = total.cpuPercent / runs;
+}
+
+void StreamArgs(benchmark::internal::Benchmark* b)
+{
+    const int64_t formats[] = { V4L2_PIX_FMT_YUYV, V4L2_PIX_FMT_NV12, V4L2_PIX_FMT_ABGR32 };
+    const int64_t counts[] = { 2, 4, 8 };
+    for (auto format : formats) {
+        for (auto count : counts) {
+            b->Args({ format, count, 0 });
+            b->Args({ format, count, 1 });
+        }
+    }
+}
+} // namespace
+
+BENCHMARK(BM_VividStream)->Apply(StreamArgs)->Iterations(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_MAIN();
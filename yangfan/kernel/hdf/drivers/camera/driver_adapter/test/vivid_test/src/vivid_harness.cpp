@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vivid_harness.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace OHOS::Camera {
+namespace {
+constexpr uint32_t MAX_VIDEO_NODES = 64;
+constexpr size_t PAGE_ALIGN = 4096;
+constexpr int64_t NS_PER_US = 1000;
+constexpr int64_t NS_PER_S = 1000000000;
+constexpr int64_t FRAME_TIMEOUT_MS = 2000;
+constexpr double PERCENT = 100.0;
+constexpr int32_t SOURCE_STREAM = 0;
+constexpr uint64_t POOL_USAGE = CAMERA_USAGE_SW_READ_OFTEN | CAMERA_USAGE_SW_WRITE_OFTEN;
+}
+
+VividSinkNode::VividSinkNode(const std::string& name, const std::string& type) : NodeBase(name, type)
+{
+}
+
+void VividSinkNode::DeliverBuffer(std::shared_ptr<IBuffer>& buffer)
+{
+    if (buffer == nullptr) {
+        return;
+    }
+    if (buffer->GetStreamId() == SOURCE_STREAM) {
+        // the V4L2 buffer goes back to the driver once the whole frame is through
+        sourceFrames_++;
+        return;
+    }
+    if (buffer->GetBufferStatus() == CAMERA_BUFFER_STATUS_OK) {
+        scaledFrames_++;
+    }
+    auto pool = BufferManager::GetInstance()->GetBufferPool(buffer->GetPoolId());
+    if (pool != nullptr) {
+        pool->ReturnBuffer(buffer);
+    }
+}
+
+VividHarness* VividHarness::current_ = nullptr;
+
+VividHarness::VividHarness()
+{
+    dev_ = std::make_shared<HosV4L2Dev>();
+}
+
+VividHarness::~VividHarness()
+{
+    FreeBuffers();
+}
+
+bool VividHarness::Available()
+{
+    for (uint32_t i = 0; i < MAX_VIDEO_NODES; ++i) {
+        std::string node = "/dev/video" + std::to_string(i);
+        int fd = open(node.c_str(), O_RDWR | O_NONBLOCK, 0);
+        if (fd < 0) {
+            continue;
+        }
+        struct v4l2_capability cap = {};
+        int rc = ioctl(fd, VIDIOC_QUERYCAP, &cap);
+        close(fd);
+        uint32_t caps = (cap.capabilities & V4L2_CAP_DEVICE_CAPS) ? cap.device_caps : cap.capabilities;
+        if (rc == 0 && strcmp(reinterpret_cast<char*>(cap.driver), VIVID_CAMERA_ID) == 0 &&
+            (caps & V4L2_CAP_VIDEO_CAPTURE)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int64_t VividHarness::NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t VividHarness::CpuNs()
+{
+    struct timespec ts = {};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * NS_PER_S + ts.tv_nsec;
+}
+
+void VividHarness::OnFrame(std::shared_ptr<FrameSpec> frame)
+{
+    int64_t now = NowNs();
+    VividHarness* harness = current_;
+    if (harness == nullptr || frame == nullptr) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> l(harness->lock_);
+        harness->pending_.push_back({ frame, now });
+    }
+    harness->cv_.notify_one();
+}
+
+RetCode VividHarness::AllocBuffers(const DeviceFormat& format, uint32_t count)
+{
+    uint32_t bufSize = format.fmtdesc.sizeimage;
+    for (uint32_t i = 0; i < count; ++i) {
+        size_t size = (bufSize + PAGE_ALIGN - 1) / PAGE_ALIGN * PAGE_ALIGN;
+        void* addr = aligned_alloc(PAGE_ALIGN, size);
+        if (addr == nullptr) {
+            return RC_ERROR;
+        }
+        memory_.push_back(addr);
+
+        auto frame = std::make_shared<FrameSpec>();
+        frame->buffer_ = std::make_shared<IBuffer>();
+        frame->buffer_->SetIndex(i);
+        frame->buffer_->SetSize(bufSize);
+        frame->buffer_->SetUsage(1);
+        frame->buffer_->SetVirAddress(addr);
+        frame->bufferPoolId_ = 0;
+        if (dev_->CreatBuffer(VIVID_CAMERA_ID, frame) != RC_OK) {
+            return RC_ERROR;
+        }
+        buffers_.push_back(frame);
+    }
+    return RC_OK;
+}
+
+void VividHarness::FreeBuffers()
+{
+    buffers_.clear();
+    for (auto addr : memory_) {
+        free(addr);
+    }
+    memory_.clear();
+}
+
+bool VividHarness::BuildPipeline(const VividConfig& config)
+{
+    constexpr uint32_t half = 2;
+    constexpr uint32_t quarter = 4;
+
+    switch (config.pixelFormat) {
+        case V4L2_PIX_FMT_NV12:
+            cameraFormat_ = CAMERA_FORMAT_YCBCR_420_SP;
+            break;
+        case V4L2_PIX_FMT_YUYV:
+            cameraFormat_ = CAMERA_FORMAT_YUYV_422_PKG;
+            break;
+        case V4L2_PIX_FMT_ABGR32:
+        case V4L2_PIX_FMT_XBGR32:
+            cameraFormat_ = CAMERA_FORMAT_RGBA_8888;
+            break;
+        default:
+            return false;
+    }
+
+    source_ = std::make_shared<NodeBase>("vivid#0", "VividSource");
+    scale_ = std::make_shared<RKScaleNode>("RKScale#0", "RKScale");
+    sink_ = std::make_shared<VividSinkNode>("sink#0", "VividSink");
+    sourcePort_ = source_->GetPort("out0");
+    std::shared_ptr<IPort> scaleIn = scale_->GetPort("in0");
+    sourcePort_->Connect(scaleIn);
+    scaleIn->Connect(sourcePort_);
+
+    std::vector<std::pair<uint32_t, uint32_t>> sizes = { { config.width, config.height } };
+    if (config.scale) {
+        sizes.push_back({ config.width / half, config.height / half });
+        sizes.push_back({ config.width / quarter, config.height / quarter });
+    }
+    for (uint32_t i = 0; i < sizes.size(); ++i) {
+        PortFormat format = {};
+        format.w_ = static_cast<int32_t>(sizes[i].first);
+        format.h_ = static_cast<int32_t>(sizes[i].second);
+        format.streamId_ = SOURCE_STREAM + i;
+        format.format_ = static_cast<int32_t>(cameraFormat_);
+        format.usage_ = POOL_USAGE;
+        format.bufferCount_ = config.bufferCount;
+        if (i > 0) {
+            format.bufferPoolId_ = BufferManager::GetInstance()->GenerateBufferPoolId();
+            auto pool = BufferManager::GetInstance()->GetBufferPool(format.bufferPoolId_);
+            if (pool == nullptr || pool->Init(sizes[i].first, sizes[i].second, POOL_USAGE, cameraFormat_,
+                config.bufferCount, CAMERA_BUFFER_SOURCE_TYPE_HEAP) != RC_OK) {
+                return false;
+            }
+            pools_.push_back(pool);
+            scaledStreams_.push_back(format.streamId_);
+        }
+
+        std::shared_ptr<IPort> out = scale_->GetPort("out" + std::to_string(i));
+        std::shared_ptr<IPort> in = sink_->GetPort("in" + std::to_string(i));
+        out->SetFormat(format);
+        in->SetFormat(format);
+        out->Connect(in);
+        in->Connect(out);
+    }
+
+    for (auto streamId : scaledStreams_) {
+        scale_->Start(streamId);
+    }
+    return true;
+}
+
+void VividHarness::ReleasePipeline()
+{
+    for (auto streamId : scaledStreams_) {
+        scale_->Stop(streamId);
+    }
+    scaledStreams_.clear();
+    pools_.clear();
+    sourcePort_ = nullptr;
+    source_ = nullptr;
+    scale_ = nullptr;
+    sink_ = nullptr;
+}
+
+void VividHarness::Stream(const VividConfig& config, VividStats& stats)
+{
+    double latencySumUs = 0.0;
+
+    while (stats.frames < config.frames) {
+        Pending item;
+        {
+            std::unique_lock<std::mutex> l(lock_);
+            if (!cv_.wait_for(l, std::chrono::milliseconds(FRAME_TIMEOUT_MS), [this] { return !pending_.empty(); })) {
+                std::cout << "vivid: no frame within " << FRAME_TIMEOUT_MS << " ms" << std::endl;
+                return;
+            }
+            item = pending_.front();
+            pending_.pop_front();
+        }
+
+        // RKScaleNode delivers every stream before it returns, so the frame is complete here
+        std::shared_ptr<IBuffer> buffer = item.frame->buffer_;
+        buffer->SetStreamId(SOURCE_STREAM);
+        buffer->SetFormat(cameraFormat_);
+        buffer->SetWidth(config.width);
+        buffer->SetHeight(config.height);
+        buffer->SetBufferStatus(CAMERA_BUFFER_STATUS_OK);
+        sourcePort_->DeliverBuffer(buffer);
+
+        double latencyUs = static_cast<double>(NowNs() - item.dequeueNs) / NS_PER_US;
+        latencySumUs += latencyUs;
+        stats.latencyMaxUs = std::max(stats.latencyMaxUs, latencyUs);
+        stats.frames++;
+
+        dev_->QueueBuffer(VIVID_CAMERA_ID, item.frame);
+    }
+    stats.latencyAvgUs = stats.frames > 0 ? latencySumUs / stats.frames : 0.0;
+}
+
+RetCode VividHarness::Run(const VividConfig& config, VividStats& stats)
+{
+    stats = {};
+    std::vector<std::string> cameraIDs = { VIVID_CAMERA_ID };
+    if (HosV4L2Dev::Init(cameraIDs) == RC_ERROR) {
+        return RC_ERROR;
+    }
+    RetCode rc = dev_->start(VIVID_CAMERA_ID);
+    if (rc != RC_OK) {
+        return rc;
+    }
+
+    DeviceFormat format = {};
+    dev_->ConfigSys(VIVID_CAMERA_ID, CMD_V4L2_GET_FORMAT, format);
+    format.fmtdesc.pixelformat = config.pixelFormat;
+    format.fmtdesc.width = config.width;
+    format.fmtdesc.height = config.height;
+    rc = dev_->ConfigSys(VIVID_CAMERA_ID, CMD_V4L2_SET_FORMAT, format);
+    if (rc == RC_OK) {
+        rc = dev_->ConfigSys(VIVID_CAMERA_ID, CMD_V4L2_GET_FORMAT, format);
+    }
+    if (rc != RC_OK || format.fmtdesc.pixelformat != config.pixelFormat ||
+        format.fmtdesc.width != config.width || format.fmtdesc.height != config.height) {
+        std::cout << "vivid: format not accepted" << std::endl;
+        dev_->stop(VIVID_CAMERA_ID);
+        return RC_ERROR;
+    }
+
+    rc = dev_->ReqBuffers(VIVID_CAMERA_ID, config.bufferCount);
+    if (rc == RC_OK) {
+        rc = AllocBuffers(format, config.bufferCount);
+    }
+    if (rc == RC_OK && !BuildPipeline(config)) {
+        rc = RC_ERROR;
+    }
+    if (rc != RC_OK) {
+        ReleasePipeline();
+        dev_->ReleaseBuffers(VIVID_CAMERA_ID);
+        dev_->stop(VIVID_CAMERA_ID);
+        FreeBuffers();
+        return rc;
+    }
+
+    current_ = this;
+    dev_->SetCallback(OnFrame);
+    int64_t cpuStart = CpuNs();
+    int64_t wallStart = NowNs();
+    rc = dev_->StartStream(VIVID_CAMERA_ID);
+    if (rc == RC_OK) {
+        Stream(config, stats);
+    }
+    int64_t wallNs = NowNs() - wallStart;
+    int64_t cpuNs = CpuNs() - cpuStart;
+
+    dev_->StopStream(VIVID_CAMERA_ID);
+    current_ = nullptr;
+    {
+        std::lock_guard<std::mutex> l(lock_);
+        pending_.clear();
+    }
+    stats.scaledFrames = sink_->scaledFrames_;
+    ReleasePipeline();
+    dev_->ReleaseBuffers(VIVID_CAMERA_ID);
+    dev_->stop(VIVID_CAMERA_ID);
+    FreeBuffers();
+
+    if (wallNs > 0) {
+        stats.fps = static_cast<double>(stats.frames) * NS_PER_S / wallNs;
+        stats.cpuPercent = static_cast<double>(cpuNs) * PERCENT / wallNs;
+    }
+    return (rc == RC_OK && stats.frames == config.frames) ? RC_OK : RC_ERROR;
+}
+} // namespace OHOS::Camera
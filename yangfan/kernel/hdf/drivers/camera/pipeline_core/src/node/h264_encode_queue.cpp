@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "h264_encode_queue.h"
+
+namespace OHOS::Camera {
+H264EncodeQueue::H264EncodeQueue(std::unique_ptr<IH264Encoder> encoder, size_t depth)
+    : encoder_(std::move(encoder)), depth_(depth == 0 ? 1 : depth)
+{
+    worker_ = std::thread([this] { Loop(); });
+}
+
+H264EncodeQueue::~H264EncodeQueue()
+{
+    Flush();
+    {
+        std::lock_guard<std::mutex> l(lock_);
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+bool H264EncodeQueue::Submit(const H264EncodeFrame& frame, Done done)
+{
+    {
+        std::lock_guard<std::mutex> l(lock_);
+        if (!running_ || jobs_.size() >= depth_) {
+            return false;
+        }
+        jobs_.push_back({ frame, std::move(done) });
+    }
+    cv_.notify_one();
+    return true;
+}
+
+void H264EncodeQueue::Drain()
+{
+    std::unique_lock<std::mutex> l(lock_);
+    idle_.wait(l, [this] { return jobs_.empty() && !busy_; });
+}
+
+void H264EncodeQueue::Flush()
+{
+    std::deque<Job> dropped;
+    {
+        std::unique_lock<std::mutex> l(lock_);
+        dropped.swap(jobs_);
+        idle_.wait(l, [this] { return !busy_; });
+        // the worker cannot pick up a job while the lock is held, so the session can be closed
+        // here; the next frame starts a new one, and with it a new IDR
+        if (width_ != 0 && encoder_ != nullptr) {
+            encoder_->Deinit();
+            width_ = 0;
+            height_ = 0;
+        }
+    }
+    H264EncodeResult failed;
+    for (auto& job : dropped) {
+        if (job.done) {
+            job.done(failed);
+        }
+    }
+}
+
+size_t H264EncodeQueue::Pending()
+{
+    std::lock_guard<std::mutex> l(lock_);
+    return jobs_.size() + (busy_ ? 1 : 0);
+}
+
+void H264EncodeQueue::Encode(Job& job)
+{
+    H264EncodeResult result;
+    const H264EncodeFrame& frame = job.frame;
+    if (encoder_ != nullptr && (frame.width != width_ || frame.height != height_)) {
+        if (width_ != 0) {
+            encoder_->Deinit();
+        }
+        width_ = 0;
+        height_ = 0;
+        if (encoder_->Init(frame.width, frame.height)) {
+            width_ = frame.width;
+            height_ = frame.height;
+        }
+    }
+
+    if (width_ != 0 && encoder_->Encode(frame, result.size) && result.size <= frame.capacity) {
+        H264ScanNalUnits(frame.virAddr, result.size, nals_);
+        H264KeyFrameOffsets(nals_, result.keyOffsets);
+        result.keyFrame = !result.keyOffsets.empty();
+        result.ok = true;
+    }
+    if (job.done) {
+        job.done(result);
+    }
+}
+
+void H264EncodeQueue::Loop()
+{
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> l(lock_);
+            cv_.wait(l, [this] { return !running_ || !jobs_.empty(); });
+            if (jobs_.empty()) {
+                return;
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+            busy_ = true;
+        }
+
+        Encode(job);
+
+        {
+            std::lock_guard<std::mutex> l(lock_);
+            busy_ = false;
+        }
+        idle_.notify_all();
+    }
+}
+} // namespace OHOS::Camera
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HOS_CAMERA_H264_ENCODE_QUEUE_H
+#define HOS_CAMERA_H264_ENCODE_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "h264_encoder.h"
+#include "h264_nal_scanner.h"
+
+namespace OHOS::Camera {
+struct H264EncodeResult {
+    bool ok = false;
+    size_t size = 0;
+    bool keyFrame = false;
+    std::vector<uint32_t> keyOffsets;   // start code offsets of the IDR slices
+};
+
+// Runs the encoder backend on its own thread so DeliverBuffer only hands the frame over.
+// Jobs complete in submission order; done is invoked on the encode thread for every
+// accepted job, including the ones dropped by Flush().
+class H264EncodeQueue {
+public:
+    using Done = std::function<void(const H264EncodeResult&)>;
+
+    explicit H264EncodeQueue(std::unique_ptr<IH264Encoder> encoder, size_t depth = 3);
+    ~H264EncodeQueue();
+
+    // Returns false without calling done when the queue is full.
+    bool Submit(const H264EncodeFrame& frame, Done done);
+    // Waits until every submitted job has completed.
+    void Drain();
+    // Completes the pending jobs as failed and releases the encoder session.
+    void Flush();
+    size_t Pending();
+
+private:
+    struct Job {
+        H264EncodeFrame frame;
+        Done done;
+    };
+
+    void Loop();
+    void Encode(Job& job);
+
+    std::unique_ptr<IH264Encoder> encoder_;
+    size_t depth_;
+    std::mutex lock_;
+    std::condition_variable cv_;
+    std::condition_variable idle_;
+    std::deque<Job> jobs_;
+    bool busy_ = false;
+    bool running_ = true;
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    std::vector<H264NalUnit> nals_;
+    std::thread worker_;
+};
+} // namespace OHOS::Camera
+#endif
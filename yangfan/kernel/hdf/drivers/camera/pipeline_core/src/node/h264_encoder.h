@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HOS_CAMERA_H264_ENCODER_H
+#define HOS_CAMERA_H264_ENCODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace OHOS::Camera {
+struct H264EncodeFrame {
+    int dmaFd = -1;               // input frame for hardware encoders
+    uint8_t* virAddr = nullptr;   // input frame (I420) and output bitstream, encoded in place
+    size_t capacity = 0;          // bytes available at virAddr for the bitstream
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+// Encoder backends used by RKCodecNode. Encode() runs on the encode queue thread, never on
+// the delivering thread, and writes an Annex B access unit over the input frame.
+class IH264Encoder {
+public:
+    virtual ~IH264Encoder() = default;
+    virtual bool Init(uint32_t width, uint32_t height) = 0;
+    virtual bool Encode(const H264EncodeFrame& frame, size_t& streamSize) = 0;
+    virtual void Deinit() = 0;
+};
+
+// Reference backend for host testing: baseline profile, IDR frames made of I_PCM macroblocks
+// and P frames of skipped macroblocks. The stream decodes with any H.264 decoder but is not
+// compressed, so it only fits buffers larger than the raw frame.
+class SoftH264Encoder : public IH264Encoder {
+public:
+    explicit SoftH264Encoder(uint32_t gop = 30) : gop_(gop) {}
+    ~SoftH264Encoder() override = default;
+
+    bool Init(uint32_t width, uint32_t height) override;
+    bool Encode(const H264EncodeFrame& frame, size_t& streamSize) override;
+    void Deinit() override;
+
+private:
+    void WriteParameterSets();
+    void WriteIdrSlice(const uint8_t* i420);
+    void WritePSlice();
+
+    uint32_t gop_;
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    uint32_t mbWidth_ = 0;
+    uint32_t mbHeight_ = 0;
+    uint32_t frameCount_ = 0;
+    uint32_t idrId_ = 0;
+    std::vector<uint8_t> stream_;
+};
+} // namespace OHOS::Camera
+#endif
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "h264_nal_scanner.h"
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define H264_NAL_NEON
+#endif
+
+namespace OHOS::Camera {
+namespace {
+constexpr size_t START_CODE_BYTES = 3;
+constexpr uint8_t NAL_TYPE_MASK = 0x1F;
+constexpr uint64_t BYTE_ONES = 0x0101010101010101ULL;
+constexpr uint64_t BYTE_HIGHS = 0x8080808080808080ULL;
+constexpr size_t WORD_BYTES = sizeof(uint64_t);
+
+inline bool IsStartCode(const uint8_t* p)
+{
+    return p[0] == 0 && p[1] == 0 && p[2] == 1;
+}
+
+// Checks every position of [pos, end) that may begin a start code.
+inline size_t ScanTail(const uint8_t* data, size_t size, size_t pos, size_t end)
+{
+    for (; pos < end && pos + START_CODE_BYTES <= size; ++pos) {
+        if (IsStartCode(data + pos)) {
+            return pos;
+        }
+    }
+    return size;
+}
+
+size_t FindWord(const uint8_t* data, size_t size, size_t pos)
+{
+    // a start code begins with a zero byte, so words without one are skipped whole
+    while (pos + WORD_BYTES + START_CODE_BYTES - 1 <= size) {
+        uint64_t word;
+        memcpy(&word, data + pos, WORD_BYTES);
+        if (((word - BYTE_ONES) & ~word & BYTE_HIGHS) != 0) {
+            size_t found = ScanTail(data, size, pos, pos + WORD_BYTES);
+            if (found != size) {
+                return found;
+            }
+        }
+        pos += WORD_BYTES;
+    }
+    return ScanTail(data, size, pos, size);
+}
+
+#ifdef H264_NAL_NEON
+size_t FindNeon(const uint8_t* data, size_t size, size_t pos)
+{
+    constexpr size_t lanes = 16;
+    const uint8x16_t zero = vdupq_n_u8(0);
+    const uint8x16_t one = vdupq_n_u8(1);
+    while (pos + lanes + START_CODE_BYTES - 1 <= size) {
+        uint8x16_t b0 = vld1q_u8(data + pos);
+        uint8x16_t b1 = vld1q_u8(data + pos + 1);
+        uint8x16_t b2 = vld1q_u8(data + pos + 2);
+        uint8x16_t hit = vandq_u8(vandq_u8(vceqq_u8(b0, zero), vceqq_u8(b1, zero)), vceqq_u8(b2, one));
+        uint64x2_t wide = vreinterpretq_u64_u8(hit);
+        if ((vgetq_lane_u64(wide, 0) | vgetq_lane_u64(wide, 1)) != 0) {
+            return ScanTail(data, size, pos, pos + lanes);
+        }
+        pos += lanes;
+    }
+    return ScanTail(data, size, pos, size);
+}
+#endif
+} // namespace
+
+size_t H264FindStartCode(const uint8_t* data, size_t size, size_t from, bool useNeon)
+{
+    if (data == nullptr || from >= size) {
+        return size;
+    }
+#ifdef H264_NAL_NEON
+    if (useNeon) {
+        return FindNeon(data, size, from);
+    }
+#endif
+    (void)useNeon;
+    return FindWord(data, size, from);
+}
+
+void H264ScanNalUnits(const uint8_t* data, size_t size, std::vector<H264NalUnit>& nals, bool useNeon)
+{
+    nals.clear();
+    size_t pos = H264FindStartCode(data, size, 0, useNeon);
+    while (pos < size) {
+        size_t header = pos + START_CODE_BYTES;
+        size_t next = H264FindStartCode(data, size, header, useNeon);
+        size_t end = next;
+        // the leading zero of a four byte start code and trailing_zero_8bits belong to no NAL
+        while (end > header && data[end - 1] == 0) {
+            --end;
+        }
+
+        H264NalUnit nal;
+        nal.startCode = static_cast<uint32_t>(pos > 0 && data[pos - 1] == 0 ? pos - 1 : pos);
+        nal.offset = static_cast<uint32_t>(header);
+        nal.size = static_cast<uint32_t>(end - header);
+        nal.type = header < size ? (data[header] & NAL_TYPE_MASK) : 0;
+        if (nal.size > 0) {
+            nals.push_back(nal);
+        }
+        pos = next;
+    }
+}
+
+void H264KeyFrameOffsets(const std::vector<H264NalUnit>& nals, std::vector<uint32_t>& offsets)
+{
+    offsets.clear();
+    for (auto& nal : nals) {
+        if (nal.type == H264_NAL_IDR) {
+            offsets.push_back(nal.startCode);
+        }
+    }
+}
+} // namespace OHOS::Camera
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HOS_CAMERA_H264_NAL_SCANNER_H
+#define HOS_CAMERA_H264_NAL_SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace OHOS::Camera {
+enum H264NalType {
+    H264_NAL_SLICE = 1,
+    H264_NAL_IDR = 5,
+    H264_NAL_SEI = 6,
+    H264_NAL_SPS = 7,
+    H264_NAL_PPS = 8,
+};
+
+struct H264NalUnit {
+    uint32_t startCode;   // offset of the 00 00 01 / 00 00 00 01 prefix
+    uint32_t offset;      // offset of the NAL header byte
+    uint32_t size;        // header and payload, without trailing zero bytes
+    uint8_t type;
+};
+
+// Returns the offset of the first 00 00 01 at or after from, or size when there is none.
+// Blocks without a zero byte are skipped 16 bytes (NEON) or 8 bytes (word compare) at a time.
+size_t H264FindStartCode(const uint8_t* data, size_t size, size_t from, bool useNeon = true);
+
+// Splits an Annex B byte stream into its NAL units.
+void H264ScanNalUnits(const uint8_t* data, size_t size, std::vector<H264NalUnit>& nals, bool useNeon = true);
+
+// Start code offsets of the IDR slices in the stream, which is what a muxer seeks to.
+void H264KeyFrameOffsets(const std::vector<H264NalUnit>& nals, std::vector<uint32_t>& offsets);
+} // namespace OHOS::Camera
+#endif
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "h264_encoder.h"
+#include <algorithm>
+#include <cstring>
+
+namespace OHOS::Camera {
+namespace {
+constexpr uint32_t MB_SIZE = 16;
+constexpr uint32_t MB_CHROMA = 8;
+constexpr uint8_t PROFILE_BASELINE = 66;
+constexpr uint8_t LEVEL_51 = 51;
+constexpr uint8_t NAL_REF_HIGH = 3;
+constexpr uint8_t NAL_TYPE_SLICE = 1;
+constexpr uint8_t NAL_TYPE_IDR = 5;
+constexpr uint8_t NAL_TYPE_SPS = 7;
+constexpr uint8_t NAL_TYPE_PPS = 8;
+constexpr uint32_t NAL_REF_SHIFT = 5;
+constexpr uint32_t LOG2_MAX_FRAME_NUM = 4;
+constexpr uint32_t POC_TYPE_NONE = 2;       // output order equals decode order, no POC in slices
+constexpr uint32_t SLICE_TYPE_P = 5;        // every slice of the picture is P
+constexpr uint32_t SLICE_TYPE_I = 7;        // every slice of the picture is I
+constexpr uint32_t MB_TYPE_I_PCM = 25;
+constexpr uint32_t DEBLOCK_OFF = 1;
+constexpr uint32_t BYTE_BITS = 8;
+constexpr uint8_t EMULATION_PREVENTION = 0x03;
+
+// RBSP writer with Exp-Golomb codes.
+class BitWriter {
+public:
+    void Bits(uint32_t value, uint32_t count)
+    {
+        for (uint32_t i = count; i > 0; --i) {
+            Bit((value >> (i - 1)) & 1);
+        }
+    }
+
+    void Bit(uint32_t bit)
+    {
+        cur_ = static_cast<uint8_t>((cur_ << 1) | bit);
+        if (++used_ == BYTE_BITS) {
+            data_.push_back(cur_);
+            cur_ = 0;
+            used_ = 0;
+        }
+    }
+
+    void Ue(uint32_t value)
+    {
+        uint64_t code = static_cast<uint64_t>(value) + 1;
+        uint32_t len = 0;
+        while ((code >> (len + 1)) != 0) {
+            ++len;
+        }
+        Bits(0, len);
+        for (uint32_t i = len + 1; i > 0; --i) {
+            Bit(static_cast<uint32_t>((code >> (i - 1)) & 1));
+        }
+    }
+
+    void Se(int32_t value)
+    {
+        Ue(value > 0 ? static_cast<uint32_t>(value) * 2 - 1 : static_cast<uint32_t>(-value) * 2);
+    }
+
+    void AlignZero()
+    {
+        while (used_ != 0) {
+            Bit(0);
+        }
+    }
+
+    // bytes may only be written while aligned
+    void Bytes(const uint8_t* src, size_t count)
+    {
+        data_.insert(data_.end(), src, src + count);
+    }
+
+    void Trailing()
+    {
+        Bit(1);
+        AlignZero();
+    }
+
+    const std::vector<uint8_t>& Data() const { return data_; }
+
+private:
+    std::vector<uint8_t> data_;
+    uint8_t cur_ = 0;
+    uint32_t used_ = 0;
+};
+
+void AppendNal(std::vector<uint8_t>& stream, uint8_t refIdc, uint8_t type, const std::vector<uint8_t>& rbsp)
+{
+    const uint8_t startCode[] = { 0, 0, 0, 1 };
+    stream.insert(stream.end(), startCode, startCode + sizeof(startCode));
+    stream.push_back(static_cast<uint8_t>((refIdc << NAL_REF_SHIFT) | type));
+    uint32_t zeros = 0;
+    for (uint8_t byte : rbsp) {
+        if (zeros == 2 && byte <= EMULATION_PREVENTION) {
+            stream.push_back(EMULATION_PREVENTION);
+            zeros = 0;
+        }
+        stream.push_back(byte);
+        zeros = byte == 0 ? zeros + 1 : 0;
+    }
+}
+} // namespace
+
+bool SoftH264Encoder::Init(uint32_t width, uint32_t height)
+{
+    if (width == 0 || height == 0 || (width & 1) != 0 || (height & 1) != 0) {
+        return false;
+    }
+    width_ = width;
+    height_ = height;
+    mbWidth_ = (width + MB_SIZE - 1) / MB_SIZE;
+    mbHeight_ = (height + MB_SIZE - 1) / MB_SIZE;
+    frameCount_ = 0;
+    idrId_ = 0;
+    return true;
+}
+
+void SoftH264Encoder::Deinit()
+{
+    width_ = 0;
+    height_ = 0;
+    stream_.clear();
+    stream_.shrink_to_fit();
+}
+
+void SoftH264Encoder::WriteParameterSets()
+{
+    BitWriter sps;
+    sps.Bits(PROFILE_BASELINE, BYTE_BITS);
+    sps.Bits(0, BYTE_BITS);                      // constraint flags
+    sps.Bits(LEVEL_51, BYTE_BITS);
+    sps.Ue(0);                                   // seq_parameter_set_id
+    sps.Ue(LOG2_MAX_FRAME_NUM - 4);              // log2_max_frame_num_minus4
+    sps.Ue(POC_TYPE_NONE);
+    sps.Ue(1);                                   // max_num_ref_frames
+    sps.Bit(0);                                  // gaps_in_frame_num_value_allowed_flag
+    sps.Ue(mbWidth_ - 1);
+    sps.Ue(mbHeight_ - 1);
+    sps.Bit(1);                                  // frame_mbs_only_flag
+    sps.Bit(1);                                  // direct_8x8_inference_flag
+    uint32_t cropRight = (mbWidth_ * MB_SIZE - width_) / 2;
+    uint32_t cropBottom = (mbHeight_ * MB_SIZE - height_) / 2;
+    if (cropRight != 0 || cropBottom != 0) {
+        sps.Bit(1);
+        sps.Ue(0);
+        sps.Ue(cropRight);
+        sps.Ue(0);
+        sps.Ue(cropBottom);
+    } else {
+        sps.Bit(0);
+    }
+    sps.Bit(0);                                  // vui_parameters_present_flag
+    sps.Trailing();
+    AppendNal(stream_, NAL_REF_HIGH, NAL_TYPE_SPS, sps.Data());
+
+    BitWriter pps;
+    pps.Ue(0);                                   // pic_parameter_set_id
+    pps.Ue(0);                                   // seq_parameter_set_id
+    pps.Bit(0);                                  // entropy_coding_mode_flag, CAVLC
+    pps.Bit(0);                                  // bottom_field_pic_order_in_frame_present_flag
+    pps.Ue(0);                                   // num_slice_groups_minus1
+    pps.Ue(0);                                   // num_ref_idx_l0_default_active_minus1
+    pps.Ue(0);                                   // num_ref_idx_l1_default_active_minus1
+    pps.Bit(0);                                  // weighted_pred_flag
+    pps.Bits(0, 2);                              // weighted_bipred_idc
+    pps.Se(0);                                   // pic_init_qp_minus26
+    pps.Se(0);                                   // pic_init_qs_minus26
+    pps.Se(0);                                   // chroma_qp_index_offset
+    pps.Bit(1);                                  // deblocking_filter_control_present_flag
+    pps.Bit(0);                                  // constrained_intra_pred_flag
+    pps.Bit(0);                                  // redundant_pic_cnt_present_flag
+    pps.Trailing();
+    AppendNal(stream_, NAL_REF_HIGH, NAL_TYPE_PPS, pps.Data());
+}
+
+void SoftH264Encoder::WriteIdrSlice(const uint8_t* i420)
+{
+    BitWriter slice;
+    slice.Ue(0);                                 // first_mb_in_slice
+    slice.Ue(SLICE_TYPE_I);
+    slice.Ue(0);                                 // pic_parameter_set_id
+    slice.Bits(0, LOG2_MAX_FRAME_NUM);           // frame_num
+    slice.Ue(idrId_);
+    slice.Bit(0);                                // no_output_of_prior_pics_flag
+    slice.Bit(0);                                // long_term_reference_flag
+    slice.Se(0);                                 // slice_qp_delta
+    slice.Ue(DEBLOCK_OFF);
+
+    const uint32_t chromaW = width_ / 2;
+    const uint32_t chromaH = height_ / 2;
+    const uint8_t* planes[] = { i420, i420 + width_ * height_, i420 + width_ * height_ + chromaW * chromaH };
+    uint8_t samples[MB_SIZE * MB_SIZE + 2 * MB_CHROMA * MB_CHROMA];
+    for (uint32_t mbY = 0; mbY < mbHeight_; ++mbY) {
+        for (uint32_t mbX = 0; mbX < mbWidth_; ++mbX) {
+            // partial macroblocks on the right and bottom edge repeat the last row/column
+            uint8_t* out = samples;
+            for (uint32_t y = 0; y < MB_SIZE; ++y) {
+                const uint8_t* row = planes[0] + std::min(mbY * MB_SIZE + y, height_ - 1) * width_;
+                for (uint32_t x = 0; x < MB_SIZE; ++x) {
+                    *out++ = row[std::min(mbX * MB_SIZE + x, width_ - 1)];
+                }
+            }
+            for (uint32_t p = 1; p < 3; ++p) {
+                for (uint32_t y = 0; y < MB_CHROMA; ++y) {
+                    const uint8_t* row = planes[p] + std::min(mbY * MB_CHROMA + y, chromaH - 1) * chromaW;
+                    for (uint32_t x = 0; x < MB_CHROMA; ++x) {
+                        *out++ = row[std::min(mbX * MB_CHROMA + x, chromaW - 1)];
+                    }
+                }
+            }
+            slice.Ue(MB_TYPE_I_PCM);
+            slice.AlignZero();                   // pcm_alignment_zero_bit
+            slice.Bytes(samples, sizeof(samples));
+        }
+    }
+    slice.Trailing();
+    AppendNal(stream_, NAL_REF_HIGH, NAL_TYPE_IDR, slice.Data());
+}
+
+void SoftH264Encoder::WritePSlice()
+{
+    BitWriter slice;
+    slice.Ue(0);                                 // first_mb_in_slice
+    slice.Ue(SLICE_TYPE_P);
+    slice.Ue(0);                                 // pic_parameter_set_id
+    slice.Bits((frameCount_ % gop_) & ((1 << LOG2_MAX_FRAME_NUM) - 1), LOG2_MAX_FRAME_NUM);
+    slice.Bit(0);                                // num_ref_idx_active_override_flag
+    slice.Bit(0);                                // ref_pic_list_modification_flag_l0
+    slice.Bit(0);                                // adaptive_ref_pic_marking_mode_flag
+    slice.Se(0);                                 // slice_qp_delta
+    slice.Ue(DEBLOCK_OFF);
+    slice.Ue(mbWidth_ * mbHeight_);              // mb_skip_run covering the picture
+    slice.Trailing();
+    AppendNal(stream_, NAL_REF_HIGH, NAL_TYPE_SLICE, slice.Data());
+}
+
+bool SoftH264Encoder::Encode(const H264EncodeFrame& frame, size_t& streamSize)
+{
+    streamSize = 0;
+    if (frame.virAddr == nullptr || frame.width != width_ || frame.height != height_ || gop_ == 0) {
+        return false;
+    }
+
+    stream_.clear();
+    if (frameCount_ % gop_ == 0) {
+        WriteParameterSets();
+        WriteIdrSlice(frame.virAddr);
+        idrId_ = (idrId_ + 1) & 0xFFFF;
+    } else {
+        WritePSlice();
+    }
+    frameCount_++;
+
+    if (stream_.size() > frame.capacity) {
+        return false;
+    }
+    memcpy(frame.virAddr, stream_.data(), stream_.size());
+    streamSize = stream_.size();
+    return true;
+}
+} // namespace OHOS::Camera
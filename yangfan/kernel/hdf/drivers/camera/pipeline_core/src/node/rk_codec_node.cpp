@@ -18,6 +18,45 @@ namespace OHOS::Camera {
 uint32_t RKCodecNode::previewWidth_ = 0;
 uint32_t RKCodecNode::previewHeight_ = 0;
 
+MppH264Encoder::~MppH264Encoder()
+{
+    Deinit();
+}
+
+bool MppH264Encoder::Init(uint32_t width, uint32_t height)
+{
+    MpiEncTestArgs args = {};
+    args.width       = width;
+    args.height      = height;
+    args.format      = MPP_FMT_YUV420P;
+    args.type        = MPP_VIDEO_CodingAVC;
+    halCtx_ = hal_mpp_ctx_create(&args);
+    if (halCtx_ == nullptr) {
+        CAMERA_LOGE("MppH264Encoder::Init hal_mpp_ctx_create failed");
+        return false;
+    }
+    CAMERA_LOGI("MppH264Encoder::Init %{public}u x %{public}u\n", width, height);
+    return true;
+}
+
+bool MppH264Encoder::Encode(const H264EncodeFrame& frame, size_t& streamSize)
+{
+    if (halCtx_ == nullptr) {
+        return false;
+    }
+    streamSize = ((MpiEncTestData *)halCtx_)->frame_size;
+    int ret = hal_mpp_encode(halCtx_, frame.dmaFd, frame.virAddr, &streamSize);
+    return ret >= 0 && streamSize > 0;
+}
+
+void MppH264Encoder::Deinit()
+{
+    if (halCtx_ != nullptr) {
+        hal_mpp_ctx_delete(halCtx_);
+        halCtx_ = nullptr;
+    }
+}
+
 RKCodecNode::RKCodecNode(const std::string& name, const std::string& type) : NodeBase(name, type)
 {
     CAMERA_LOGV("%{public}s enter, type(%{public}s)\n", name_.c_str(), type_.c_str());
@@ -25,6 +64,7 @@ RKCodecNode::RKCodecNode(const std::string& name, const std::string& type) : Nod
 
 RKCodecNode::~RKCodecNode()
 {
+    ResetEncoder();
     CAMERA_LOGI("~RKCodecNode Node exit.");
 }
 
@@ -37,13 +77,7 @@ RetCode RKCodecNode::Start(const int32_t streamId)
 RetCode RKCodecNode::Stop(const int32_t streamId)
 {
     CAMERA_LOGI("RKCodecNode::Stop streamId = %{public}d\n", streamId);
-
-    if (halCtx_ != nullptr) {
-        hal_mpp_ctx_delete(halCtx_);
-        halCtx_ = nullptr;
-        mppStatus_ = 0;
-    }
-
+    ResetEncoder();
     return RC_OK;
 }
 
@@ -91,69 +125,6 @@ void RKCodecNode::encodeJpegToMemory(unsigned char* image, int width, int height
     jpeg_destroy_compress(&cInfo);
 }
 
-int RKCodecNode::findStartCode(unsigned char *data, size_t dataSz)
-{
-    constexpr uint32_t dataSize = 4;
-    constexpr uint32_t dataBit2 = 2;
-    constexpr uint32_t dataBit3 = 3;
-
-    if (data == nullptr) {
-        CAMERA_LOGI("RKCodecNode::findStartCode paramater == nullptr");
-        return -1;
-    }
-
-    if ((dataSz > dataSize) && (data[0] == 0) && (data[1] == 0) && \
-        (data[dataBit2] == 0) && (data[dataBit3] == 1)) {
-        return 4;
-    }
-
-    return -1;
-}
-
-static constexpr uint32_t nalBit = 0x1F;
-#define NAL_TYPE(value)             ((value) & nalBit)
-void RKCodecNode::SerchIFps(unsigned char* buf, size_t bufSize, std::shared_ptr<IBuffer>& buffer)
-{
-    size_t nalType = 0;
-    size_t idx = 0;
-    size_t size = bufSize;
-    constexpr uint32_t nalTypeValue = 0x05;
-
-    if (buffer == nullptr || buf == nullptr) {
-        CAMERA_LOGI("RKCodecNode::SerchIFps paramater == nullptr");
-        return;
-    }
-
-    for (int i = 0; i < bufSize; i++) {
-        int ret = findStartCode(buf + idx, size);
-        if (ret == -1) {
-            idx += 1;
-            size -= 1;
-        } else {
-            nalType = NAL_TYPE(buf[idx + ret]);
-            CAMERA_LOGI("ForkNode::ForkBuffers nalu == 0x%{public}x buf == 0x%{public}x \n", nalType, buf[idx + ret]);
-            if (nalType == nalTypeValue) {
-                buffer->SetEsKeyFrame(1);
-                CAMERA_LOGI("ForkNode::ForkBuffers SetEsKeyFrame == 1 nalu == 0x%{public}x\n", nalType);
-                break;
-            } else {
-                idx += ret;
-                size -= ret;
-            }
-        }
-
-        if (idx >= bufSize) {
-            break;
-        }
-    }
-
-    if (idx >= bufSize) {
-        buffer->SetEsKeyFrame(0);
-        CAMERA_LOGI("ForkNode::ForkBuffers SetEsKeyFrame == 0 nalu == 0x%{public}x idx = %{public}d\n",
-            nalType, idx);
-    }
-}
-
 void  RKCodecNode::xYUV422ToRGBA(uint8_t *yuv422, uint8_t *rgba, int width, int height)
 {
     int R, G, B, Y, U, V;
@@ -363,53 +334,60 @@ void RKCodecNode::Yuv422ToJpeg(std::shared_ptr<IBuffer>& buffer)
     CAMERA_LOGE("RKCodecNode::Yuv422ToJpeg jpegSize = %{public}d\n", jpegSize);
 }
 
-void RKCodecNode::Yuv420ToH264(std::shared_ptr<IBuffer>& buffer)
+void RKCodecNode::ResetEncoder()
 {
-    if (buffer == nullptr) {
+    std::lock_guard<std::mutex> l(encodeLock_);
+    if (encodeQueue_ != nullptr) {
+        // frames still queued come back through their done callback marked invalid
+        encodeQueue_->Flush();
+    }
+}
+
+bool RKCodecNode::Yuv420ToH264(std::shared_ptr<IBuffer>& buffer, std::shared_ptr<IPort>& port)
+{
+    if (buffer == nullptr || port == nullptr) {
         CAMERA_LOGI("RKCodecNode::Yuv420ToH264 buffer == nullptr");
-        return;
+        return false;
     }
 
-    int ret = 0;
-    size_t buf_size = 0;
-    struct timespec ts = {};
-    int64_t timestamp = 0;
-    int dma_fd = buffer->GetFileDescriptor();
-
-    if (mppStatus_ == 0) {
-        MpiEncTestArgs args = {};
-        args.width       = previewWidth_;
-        args.height      = previewHeight_;
-        args.format      = MPP_FMT_YUV420P;
-        args.type        = MPP_VIDEO_CodingAVC;
-        halCtx_ = hal_mpp_ctx_create(&args);
-        mppStatus_ = 1;
-        buf_size = ((MpiEncTestData *)halCtx_)->frame_size;
-
-        ret = hal_mpp_encode(halCtx_, dma_fd, (unsigned char *)buffer->GetVirAddress(), &buf_size);
-        SerchIFps((unsigned char *)buffer->GetVirAddress(), buf_size, buffer);
-
-        buffer->SetEsFrameSize(buf_size);
-        clock_gettime(CLOCK_REALTIME, &ts);
-        timestamp = ts.tv_sec & 0xFFFFFF;
-        timestamp *= 1000000000;
-        timestamp += ts.tv_nsec;
-        buffer->SetEsTimestamp(timestamp);
-        CAMERA_LOGI("RKCodecNode::Yuv420ToH264 video capture on\n");
-    } else {
-        buf_size = ((MpiEncTestData *)halCtx_)->frame_size;
-        ret = hal_mpp_encode(halCtx_, dma_fd, (unsigned char *)buffer->GetVirAddress(), &buf_size);
-        SerchIFps((unsigned char *)buffer->GetVirAddress(), buf_size, buffer);
-        buffer->SetEsFrameSize(buf_size);
+    std::lock_guard<std::mutex> l(encodeLock_);
+    if (encodeQueue_ == nullptr) {
+        encodeQueue_ = std::make_unique<H264EncodeQueue>(std::make_unique<MppH264Encoder>());
+    }
+
+    H264EncodeFrame frame;
+    frame.dmaFd = buffer->GetFileDescriptor();
+    frame.virAddr = static_cast<uint8_t*>(buffer->GetVirAddress());
+    frame.capacity = buffer->GetSize();
+    frame.width = buffer->GetWidth();
+    frame.height = buffer->GetHeight();
+
+    auto done = [buffer, port](const H264EncodeResult& result) mutable {
+        constexpr int64_t nsPerSec = 1000000000;
+        constexpr int64_t secMask = 0xFFFFFF;
+        if (!result.ok) {
+            CAMERA_LOGE("RKCodecNode::Yuv420ToH264 encode failed");
+            buffer->SetBufferStatus(CAMERA_BUFFER_STATUS_INVALID);
+            port->DeliverBuffer(buffer);
+            return;
+        }
+
+        struct timespec ts = {};
         clock_gettime(CLOCK_REALTIME, &ts);
-        timestamp = ts.tv_sec & 0xFFFFFF;
-        timestamp *= 1000000000;
-        timestamp += ts.tv_nsec;
+        int64_t timestamp = (ts.tv_sec & secMask) * nsPerSec + ts.tv_nsec;
+        buffer->SetEsFrameSize(result.size);
+        buffer->SetEsKeyFrame(result.keyFrame ? 1 : 0);
         buffer->SetEsTimestamp(timestamp);
+        CAMERA_LOGI("RKCodecNode::Yuv420ToH264 size = %{public}zu key = %{public}d timestamp = %{public}lld\n",
+            result.size, result.keyFrame, timestamp);
+        port->DeliverBuffer(buffer);
+    };
+
+    if (!encodeQueue_->Submit(frame, done)) {
+        CAMERA_LOGI("RKCodecNode::Yuv420ToH264 encoder busy, drop frame");
+        return false;
     }
-
-    CAMERA_LOGI("ForkNode::ForkBuffers H264 size = %{public}d ret = %{public}d timestamp = %{public}lld\n",
-        buf_size, ret, timestamp);
+    return true;
 }
 
 void RKCodecNode::DeliverBuffer(std::shared_ptr<IBuffer>& buffer)
@@ -421,21 +399,30 @@ void RKCodecNode::DeliverBuffer(std::shared_ptr<IBuffer>& buffer)
 
     int32_t id = buffer->GetStreamId();
     CAMERA_LOGE("RKCodecNode::DeliverBuffer StreamId %{public}d", id);
+    std::shared_ptr<IPort> port = nullptr;
+    outPutPorts_ = GetOutPorts();
+    for (auto& it : outPutPorts_) {
+        if (it->format_.streamId_ == id) {
+            port = it;
+            break;
+        }
+    }
+
     if (buffer->GetEncodeType() == ENCODE_TYPE_JPEG) {
         Yuv422ToJpeg(buffer);
     } else if (buffer->GetEncodeType() == ENCODE_TYPE_H264) {
-        //Yuv420ToH264(buffer);
+        // the encode thread delivers the buffer once the bitstream is written
+        if (buffer->GetBufferStatus() == CAMERA_BUFFER_STATUS_OK && Yuv420ToH264(buffer, port)) {
+            return;
+        }
+        buffer->SetBufferStatus(CAMERA_BUFFER_STATUS_INVALID);
     } else {
         Yuv422ToRGBA8888(buffer);
     }
 
-    outPutPorts_ = GetOutPorts();
-    for (auto& it : outPutPorts_) {
-        if (it->format_.streamId_ == id) {
-            it->DeliverBuffer(buffer);
-            CAMERA_LOGI("RKCodecNode deliver buffer streamid = %{public}d", it->format_.streamId_);
-            return;
-        }
+    if (port != nullptr) {
+        port->DeliverBuffer(buffer);
+        CAMERA_LOGI("RKCodecNode deliver buffer streamid = %{public}d", port->format_.streamId_);
     }
 }
 
@@ -448,12 +435,7 @@ RetCode RKCodecNode::Capture(const int32_t streamId, const int32_t captureId)
 RetCode RKCodecNode::CancelCapture(const int32_t streamId)
 {
     CAMERA_LOGI("RKCodecNode::CancelCapture streamid = %{public}d", streamId);
-    if (halCtx_ != nullptr) {
-        hal_mpp_ctx_delete(halCtx_);
-        halCtx_ = nullptr;
-        mppStatus_ = 0;
-    }
-
+    ResetEncoder();
     return RC_OK;
 }
 
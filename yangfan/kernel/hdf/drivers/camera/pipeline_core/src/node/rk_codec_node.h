@@ -15,6 +15,8 @@
 #define HOS_CAMERA_RKCODEC_NODE_H
 
 #include <vector>
+#include <memory>
+#include <mutex>
 #include <condition_variable>
 #include <ctime>
 #include <jpeglib.h>
@@ -33,9 +35,22 @@
 extern "C" {
 #include "mpi_enc_utils.h"
 }
-
+#include "h264_encode_queue.h"
 
 namespace OHOS::Camera {
+// Hardware backend of the H.264 encode queue: MPP reads the frame through its dma-buf fd and
+// writes the bitstream over the same buffer.
+class MppH264Encoder : public IH264Encoder {
+public:
+    MppH264Encoder() = default;
+    ~MppH264Encoder() override;
+    bool Init(uint32_t width, uint32_t height) override;
+    bool Encode(const H264EncodeFrame& frame, size_t& streamSize) override;
+    void Deinit() override;
+private:
+    void* halCtx_ = nullptr;
+};
+
 class RKCodecNode : public NodeBase {
 public:
     RKCodecNode(const std::string& name, const std::string& type);
@@ -49,12 +64,11 @@ public:
 private:
     void encodeJpegToMemory(unsigned char* image, int width, int height,
             const char* comment, size_t* jpegSize, unsigned char** jpegBuf);
-    int findStartCode(unsigned char *data, size_t dataSz);
-    void SerchIFps(unsigned char* buf, size_t bufSize, std::shared_ptr<IBuffer>& buffer);
 
     void Yuv422ToRGBA8888(std::shared_ptr<IBuffer>& buffer);
     void Yuv422ToJpeg(std::shared_ptr<IBuffer>& buffer);
-    void Yuv420ToH264(std::shared_ptr<IBuffer>& buffer);
+    bool Yuv420ToH264(std::shared_ptr<IBuffer>& buffer, std::shared_ptr<IPort>& port);
+    void ResetEncoder();
 
     void xYUV422ToRGBA(uint8_t* yuv422, uint8_t* rgba, int width, int height);
     void xYUV422ToRGB(uint8_t* yuv422, uint8_t* rgb, int width, int height);
@@ -63,8 +77,8 @@ private:
     static uint32_t                       previewWidth_;
     static uint32_t                       previewHeight_;
     std::vector<std::shared_ptr<IPort>>   outPutPorts_;
-    void* halCtx_ = nullptr;
-    int mppStatus_ = 0;
+    std::mutex                            encodeLock_;
+    std::unique_ptr<H264EncodeQueue>      encodeQueue_;
 };
 }// namespace OHOS::Camera
 #endif
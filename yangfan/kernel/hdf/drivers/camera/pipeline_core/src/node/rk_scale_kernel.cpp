@@ -0,0 +1,425 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rk_scale_kernel.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RKSCALE_NEON
+#endif
+
+namespace OHOS::Camera {
+namespace {
+constexpr uint32_t INTER_BITS = 7;           // fraction bits of the vertical pass output
+constexpr uint32_t OUT_SHIFT = PolyphaseFilter::COEF_BITS + INTER_BITS;
+constexpr int32_t COEF_ONE = 1 << PolyphaseFilter::COEF_BITS;
+constexpr uint32_t BAND_ROWS = 16;           // source rows consumed by all targets before moving on
+constexpr uint32_t LANES = 4;
+constexpr int32_t PIXEL_MAX = 255;
+
+enum ScalePlane {
+    PLANE_LUMA,    // NV12 Y, packed YUYV and packed RGBA
+    PLANE_CHROMA,  // NV12 interleaved UV
+};
+
+inline uint8_t ClampPixel(int32_t acc)
+{
+    int32_t v = (acc + (1 << (OUT_SHIFT - 1))) >> OUT_SHIFT;
+    return static_cast<uint8_t>(std::min(std::max(v, 0), PIXEL_MAX));
+}
+
+void VerticalPassC(const uint8_t* const* rows, const int16_t* coef, uint32_t taps,
+    uint32_t begin, uint32_t end, int16_t* out)
+{
+    for (uint32_t x = begin; x < end; ++x) {
+        int32_t acc = 0;
+        for (uint32_t k = 0; k < taps; ++k) {
+            acc += rows[k][x] * coef[k];
+        }
+        out[x] = static_cast<int16_t>((acc + (1 << (INTER_BITS - 1))) >> INTER_BITS);
+    }
+}
+
+void HorizontalPassC(const int16_t* in, uint32_t channels, const PolyphaseFilter& f,
+    uint32_t begin, uint8_t* out)
+{
+    uint32_t taps = f.Taps();
+    for (uint32_t i = begin; i < f.DstLen(); ++i) {
+        const int16_t* src = in + f.Offset(i) * channels;
+        const int16_t* coef = f.Coeffs(i);
+        for (uint32_t c = 0; c < channels; ++c) {
+            int32_t acc = 0;
+            for (uint32_t k = 0; k < taps; ++k) {
+                acc += src[k * channels + c] * coef[k];
+            }
+            out[i * channels + c] = ClampPixel(acc);
+        }
+    }
+}
+
+#ifdef RKSCALE_NEON
+uint32_t VerticalPassNeon(const uint8_t* const* rows, const int16_t* coef, uint32_t taps,
+    uint32_t width, int16_t* out)
+{
+    constexpr uint32_t step = 16;
+    uint32_t x = 0;
+    for (; x + step <= width; x += step) {
+        int32x4_t acc0 = vdupq_n_s32(0);
+        int32x4_t acc1 = vdupq_n_s32(0);
+        int32x4_t acc2 = vdupq_n_s32(0);
+        int32x4_t acc3 = vdupq_n_s32(0);
+        for (uint32_t k = 0; k < taps; ++k) {
+            uint8x16_t v = vld1q_u8(rows[k] + x);
+            int16x8_t lo = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(v)));
+            int16x8_t hi = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(v)));
+            acc0 = vmlal_n_s16(acc0, vget_low_s16(lo), coef[k]);
+            acc1 = vmlal_n_s16(acc1, vget_high_s16(lo), coef[k]);
+            acc2 = vmlal_n_s16(acc2, vget_low_s16(hi), coef[k]);
+            acc3 = vmlal_n_s16(acc3, vget_high_s16(hi), coef[k]);
+        }
+        vst1q_s16(out + x, vcombine_s16(vrshrn_n_s32(acc0, INTER_BITS), vrshrn_n_s32(acc1, INTER_BITS)));
+        vst1q_s16(out + x + 8, vcombine_s16(vrshrn_n_s32(acc2, INTER_BITS), vrshrn_n_s32(acc3, INTER_BITS)));
+    }
+    return x;
+}
+
+inline uint16x4_t NarrowAcc(int32x4_t acc)
+{
+    return vqmovun_s32(vrshrq_n_s32(acc, OUT_SHIFT));
+}
+
+inline int32x4_t GatherMac(int32x4_t acc, const int16_t* in, const int32_t* offs, uint32_t channels,
+    uint32_t tap, const int16_t* coef)
+{
+    int16x4_t v = vdup_n_s16(0);
+    v = vld1_lane_s16(in + (offs[0] + tap) * channels, v, 0);
+    v = vld1_lane_s16(in + (offs[1] + tap) * channels, v, 1);
+    v = vld1_lane_s16(in + (offs[2] + tap) * channels, v, 2);
+    v = vld1_lane_s16(in + (offs[3] + tap) * channels, v, 3);
+    return vmlal_s16(acc, v, vld1_s16(coef));
+}
+
+uint32_t HorizontalPassNeon(const int16_t* in, uint32_t channels, const PolyphaseFilter& f, uint8_t* out)
+{
+    uint32_t taps = f.Taps();
+    uint32_t dst = f.DstLen();
+    uint32_t i = 0;
+    int32_t offs[2 * LANES];
+
+    if (channels == 4) {
+        for (; i + 2 <= dst; i += 2) {
+            const int16_t* s0 = in + f.Offset(i) * channels;
+            const int16_t* s1 = in + f.Offset(i + 1) * channels;
+            const int16_t* c0 = f.Coeffs(i);
+            const int16_t* c1 = f.Coeffs(i + 1);
+            int32x4_t acc0 = vdupq_n_s32(0);
+            int32x4_t acc1 = vdupq_n_s32(0);
+            for (uint32_t k = 0; k < taps; ++k) {
+                acc0 = vmlal_n_s16(acc0, vld1_s16(s0 + k * channels), c0[k]);
+                acc1 = vmlal_n_s16(acc1, vld1_s16(s1 + k * channels), c1[k]);
+            }
+            vst1_u8(out + i * channels, vqmovn_u16(vcombine_u16(NarrowAcc(acc0), NarrowAcc(acc1))));
+        }
+    } else if (channels == 2) {
+        for (; i + LANES <= dst; i += LANES) {
+            const int16_t* gc = f.GroupCoeffs(i / LANES);
+            for (uint32_t l = 0; l < LANES; ++l) {
+                offs[l] = f.Offset(i + l);
+            }
+            int32x4_t accU = vdupq_n_s32(0);
+            int32x4_t accV = vdupq_n_s32(0);
+            for (uint32_t k = 0; k < taps; ++k) {
+                accU = GatherMac(accU, in, offs, channels, k, gc + k * LANES);
+                accV = GatherMac(accV, in + 1, offs, channels, k, gc + k * LANES);
+            }
+            uint16x4x2_t uv = vzip_u16(NarrowAcc(accU), NarrowAcc(accV));
+            vst1_u8(out + i * channels, vqmovn_u16(vcombine_u16(uv.val[0], uv.val[1])));
+        }
+    } else if (channels == 1) {
+        for (; i + 2 * LANES <= dst; i += 2 * LANES) {
+            const int16_t* gc0 = f.GroupCoeffs(i / LANES);
+            const int16_t* gc1 = f.GroupCoeffs(i / LANES + 1);
+            for (uint32_t l = 0; l < 2 * LANES; ++l) {
+                offs[l] = f.Offset(i + l);
+            }
+            int32x4_t acc0 = vdupq_n_s32(0);
+            int32x4_t acc1 = vdupq_n_s32(0);
+            for (uint32_t k = 0; k < taps; ++k) {
+                acc0 = GatherMac(acc0, in, offs, 1, k, gc0 + k * LANES);
+                acc1 = GatherMac(acc1, in, offs + LANES, 1, k, gc1 + k * LANES);
+            }
+            vst1_u8(out + i, vqmovn_u16(vcombine_u16(NarrowAcc(acc0), NarrowAcc(acc1))));
+        }
+    }
+    return i;
+}
+#endif
+
+void VerticalPass(bool useNeon, const uint8_t* const* rows, const int16_t* coef, uint32_t taps,
+    uint32_t width, int16_t* out)
+{
+    uint32_t x = 0;
+#ifdef RKSCALE_NEON
+    if (useNeon) {
+        x = VerticalPassNeon(rows, coef, taps, width, out);
+    }
+#else
+    (void)useNeon;
+#endif
+    VerticalPassC(rows, coef, taps, x, width, out);
+}
+
+void HorizontalPass(bool useNeon, const int16_t* in, uint32_t channels, const PolyphaseFilter& f, uint8_t* out)
+{
+    uint32_t i = 0;
+#ifdef RKSCALE_NEON
+    if (useNeon) {
+        i = HorizontalPassNeon(in, channels, f, out);
+    }
+#else
+    (void)useNeon;
+#endif
+    HorizontalPassC(in, channels, f, i, out);
+}
+} // namespace
+
+PolyphaseFilter::PolyphaseFilter(uint32_t srcLen, uint32_t dstLen)
+{
+    if (srcLen == 0 || dstLen == 0) {
+        return;
+    }
+
+    constexpr double eps = 1e-9;
+    double scale = static_cast<double>(srcLen) / dstLen;
+    double radius = std::max(1.0, scale);
+    taps_ = static_cast<uint32_t>(std::ceil(2 * radius - eps));
+    if (taps_ > MAX_TAPS) {
+        // very large ratios get a narrower kernel rather than an unbounded tap count
+        taps_ = MAX_TAPS;
+        radius = MAX_TAPS / 2.0;
+    }
+    taps_ = std::min(taps_, srcLen);
+
+    offsets_.resize(dstLen);
+    coeffs_.assign(dstLen * taps_, 0);
+    std::vector<double> weights(taps_);
+    for (uint32_t i = 0; i < dstLen; ++i) {
+        double center = (i + 0.5) * scale - 0.5;
+        int32_t first = static_cast<int32_t>(std::floor(center - radius)) + 1;
+        int32_t start = std::min(std::max(first, 0), static_cast<int32_t>(srcLen - taps_));
+        std::fill(weights.begin(), weights.end(), 0.0);
+
+        // samples outside the frame fold onto the edge pixel, which keeps the window in bounds
+        double sum = 0.0;
+        for (int32_t j = first; j < first + static_cast<int32_t>(std::ceil(2 * radius)) + 1; ++j) {
+            double w = 1.0 - std::fabs(j - center) / radius;
+            if (w <= 0.0) {
+                continue;
+            }
+            int32_t src = std::min(std::max(j, 0), static_cast<int32_t>(srcLen) - 1);
+            if (src - start < 0 || src - start >= static_cast<int32_t>(taps_)) {
+                continue;
+            }
+            weights[src - start] += w;
+            sum += w;
+        }
+
+        int16_t* coef = &coeffs_[i * taps_];
+        int32_t total = 0;
+        uint32_t peak = 0;
+        for (uint32_t k = 0; k < taps_; ++k) {
+            coef[k] = static_cast<int16_t>(std::lround(weights[k] / sum * COEF_ONE));
+            total += coef[k];
+            peak = coef[k] > coef[peak] ? k : peak;
+        }
+        coef[peak] = static_cast<int16_t>(coef[peak] + COEF_ONE - total);
+        offsets_[i] = start;
+    }
+
+    uint32_t groups = (dstLen + LANES - 1) / LANES;
+    groupCoeffs_.assign(groups * taps_ * LANES, 0);
+    for (uint32_t i = 0; i < dstLen; ++i) {
+        for (uint32_t k = 0; k < taps_; ++k) {
+            groupCoeffs_[((i / LANES) * taps_ + k) * LANES + i % LANES] = coeffs_[i * taps_ + k];
+        }
+    }
+}
+
+bool RKScaler::NeonAvailable()
+{
+#ifdef RKSCALE_NEON
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool RKScaler::Configure(ScaleFormat format, uint32_t srcWidth, uint32_t srcHeight,
+    const std::vector<std::pair<uint32_t, uint32_t>>& dstSizes)
+{
+    constexpr uint32_t evenMask = 1;
+    bool chromaX = format == SCALE_FORMAT_NV12 || format == SCALE_FORMAT_YUYV;
+    bool chromaY = format == SCALE_FORMAT_NV12;
+
+    targets_.clear();
+    if (srcWidth == 0 || srcHeight == 0 || (chromaX && (srcWidth & evenMask)) || (chromaY && (srcHeight & evenMask))) {
+        return false;
+    }
+
+    uint32_t maxDstWidth = 0;
+    for (auto& size : dstSizes) {
+        uint32_t w = size.first;
+        uint32_t h = size.second;
+        if (w == 0 || h == 0 || (chromaX && (w & evenMask)) || (chromaY && (h & evenMask))) {
+            targets_.clear();
+            return false;
+        }
+        Target t = { w, h, PolyphaseFilter(srcHeight, h), PolyphaseFilter(srcWidth, w), {}, {} };
+        if (chromaY) {
+            t.vChroma = PolyphaseFilter(srcHeight / 2, h / 2);
+        }
+        if (chromaX) {
+            t.hChroma = PolyphaseFilter(srcWidth / 2, w / 2);
+        }
+        targets_.push_back(std::move(t));
+        maxDstWidth = std::max(maxDstWidth, w);
+    }
+
+    constexpr uint32_t rgbaBytes = 4;
+    constexpr uint32_t yuyvBytes = 2;
+    uint32_t rowBytes = format == SCALE_FORMAT_RGBA ? srcWidth * rgbaBytes :
+        (format == SCALE_FORMAT_YUYV ? srcWidth * yuyvBytes : srcWidth);
+    format_ = format;
+    srcWidth_ = srcWidth;
+    srcHeight_ = srcHeight;
+    rowPtrs_.resize(PolyphaseFilter::MAX_TAPS);
+    vRow_.resize(rowBytes);
+    lumaRow_.resize(srcWidth);
+    chromaRow_.resize(srcWidth);
+    lumaOut_.resize(maxDstWidth);
+    chromaOut_.resize(maxDstWidth);
+    return true;
+}
+
+void RKScaler::EmitRow(const int16_t* row, const PlaneJob& job, uint32_t y, int plane)
+{
+    constexpr uint32_t rgbaChannels = 4;
+    constexpr uint32_t uvChannels = 2;
+    uint8_t* out = job.dst + static_cast<size_t>(y) * job.dstStride;
+    const Target& t = *job.target;
+
+    switch (format_) {
+        case SCALE_FORMAT_RGBA:
+            HorizontalPass(useNeon_, row, rgbaChannels, t.hLuma, out);
+            break;
+        case SCALE_FORMAT_NV12:
+            if (plane == PLANE_LUMA) {
+                HorizontalPass(useNeon_, row, 1, t.hLuma, out);
+            } else {
+                HorizontalPass(useNeon_, row, uvChannels, t.hChroma, out);
+            }
+            break;
+        case SCALE_FORMAT_YUYV: {
+            // Y0 U0 Y1 V0: even bytes are luma, odd bytes form a half width UV plane
+            uint32_t i = 0;
+#ifdef RKSCALE_NEON
+            if (useNeon_) {
+                for (; i + 8 <= srcWidth_; i += 8) {
+                    int16x8x2_t v = vld2q_s16(row + 2 * i);
+                    vst1q_s16(&lumaRow_[i], v.val[0]);
+                    vst1q_s16(&chromaRow_[i], v.val[1]);
+                }
+            }
+#endif
+            for (; i < srcWidth_; ++i) {
+                lumaRow_[i] = row[2 * i];
+                chromaRow_[i] = row[2 * i + 1];
+            }
+            HorizontalPass(useNeon_, lumaRow_.data(), 1, t.hLuma, lumaOut_.data());
+            HorizontalPass(useNeon_, chromaRow_.data(), uvChannels, t.hChroma, chromaOut_.data());
+            i = 0;
+#ifdef RKSCALE_NEON
+            if (useNeon_) {
+                for (; i + 8 <= t.width; i += 8) {
+                    uint8x8x2_t v = { { vld1_u8(&lumaOut_[i]), vld1_u8(&chromaOut_[i]) } };
+                    vst2_u8(out + 2 * i, v);
+                }
+            }
+#endif
+            for (; i < t.width; ++i) {
+                out[2 * i] = lumaOut_[i];
+                out[2 * i + 1] = chromaOut_[i];
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void RKScaler::RunPlane(const uint8_t* src, uint32_t srcStride, uint32_t srcRows, uint32_t rowBytes,
+    std::vector<PlaneJob>& jobs, int plane)
+{
+    std::vector<uint32_t> next(jobs.size(), 0);
+    for (uint32_t bandEnd = std::min(BAND_ROWS, srcRows);; bandEnd = std::min(bandEnd + BAND_ROWS, srcRows)) {
+        for (size_t j = 0; j < jobs.size(); ++j) {
+            const PolyphaseFilter& f = *jobs[j].vFilter;
+            while (next[j] < f.DstLen() && f.Offset(next[j]) + f.Taps() <= bandEnd) {
+                uint32_t y = next[j]++;
+                for (uint32_t k = 0; k < f.Taps(); ++k) {
+                    rowPtrs_[k] = src + static_cast<size_t>(f.Offset(y) + k) * srcStride;
+                }
+                VerticalPass(useNeon_, rowPtrs_.data(), f.Coeffs(y), f.Taps(), rowBytes, vRow_.data());
+                EmitRow(vRow_.data(), jobs[j], y, plane);
+            }
+        }
+        if (bandEnd == srcRows) {
+            break;
+        }
+    }
+}
+
+bool RKScaler::Process(const ScaleImage& src, const std::vector<ScaleImage>& dst)
+{
+    if (targets_.empty() || dst.size() != targets_.size() || src.data == nullptr ||
+        src.width != srcWidth_ || src.height != srcHeight_) {
+        return false;
+    }
+    for (size_t i = 0; i < dst.size(); ++i) {
+        if (dst[i].data == nullptr || dst[i].width != targets_[i].width || dst[i].height != targets_[i].height) {
+            return false;
+        }
+    }
+
+    std::vector<PlaneJob> jobs;
+    for (size_t i = 0; i < dst.size(); ++i) {
+        jobs.push_back({ &targets_[i].vLuma, dst[i].data, dst[i].stride, &targets_[i] });
+    }
+    RunPlane(src.data, src.stride, srcHeight_, static_cast<uint32_t>(vRow_.size()), jobs, PLANE_LUMA);
+
+    if (format_ == SCALE_FORMAT_NV12) {
+        for (size_t i = 0; i < dst.size(); ++i) {
+            const ScaleImage& d = dst[i];
+            jobs[i].vFilter = &targets_[i].vChroma;
+            jobs[i].dst = d.uv != nullptr ? d.uv : d.data + static_cast<size_t>(d.stride) * d.height;
+            jobs[i].dstStride = d.uvStride != 0 ? d.uvStride : d.stride;
+        }
+        const uint8_t* uv = src.uv != nullptr ? src.uv : src.data + static_cast<size_t>(src.stride) * src.height;
+        uint32_t uvStride = src.uvStride != 0 ? src.uvStride : src.stride;
+        RunPlane(uv, uvStride, srcHeight_ / 2, srcWidth_, jobs, PLANE_CHROMA);
+    }
+    return true;
+}
+} // namespace OHOS::Camera
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HOS_CAMERA_RKSCALE_KERNEL_H
+#define HOS_CAMERA_RKSCALE_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace OHOS::Camera {
+enum ScaleFormat {
+    SCALE_FORMAT_NV12,
+    SCALE_FORMAT_YUYV,
+    SCALE_FORMAT_RGBA,
+};
+
+struct ScaleImage {
+    uint8_t* data = nullptr;   // Y plane for NV12, packed pixels otherwise
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t stride = 0;       // bytes per row of data
+    uint8_t* uv = nullptr;     // NV12 chroma plane, data + stride * height when null
+    uint32_t uvStride = 0;     // stride when zero
+};
+
+// Coefficient table of a separable tent filter along one axis. Every output sample reads
+// Taps() consecutive source samples starting at Offset(i), with Q14 weights that sum to 1.
+class PolyphaseFilter {
+public:
+    static constexpr uint32_t COEF_BITS = 14;
+    static constexpr uint32_t MAX_TAPS = 16;
+
+    PolyphaseFilter() = default;
+    PolyphaseFilter(uint32_t srcLen, uint32_t dstLen);
+
+    uint32_t Taps() const { return taps_; }
+    uint32_t DstLen() const { return static_cast<uint32_t>(offsets_.size()); }
+    int32_t Offset(uint32_t i) const { return offsets_[i]; }
+    const int16_t* Coeffs(uint32_t i) const { return &coeffs_[i * taps_]; }
+    // Tap-major copy of the table for groups of 4 outputs, used by the vector kernels.
+    const int16_t* GroupCoeffs(uint32_t group) const { return &groupCoeffs_[group * taps_ * 4]; }
+
+private:
+    uint32_t taps_ = 0;
+    std::vector<int32_t> offsets_;
+    std::vector<int16_t> coeffs_;
+    std::vector<int16_t> groupCoeffs_;
+};
+
+// Downscales one NV12/YUYV/RGBA frame to several sizes at once. Source rows are walked in
+// bands and every target consumes the band while it is still in cache, so the full size frame
+// is read only once no matter how many outputs are requested.
+class RKScaler {
+public:
+    RKScaler() = default;
+    ~RKScaler() = default;
+
+    bool Configure(ScaleFormat format, uint32_t srcWidth, uint32_t srcHeight,
+        const std::vector<std::pair<uint32_t, uint32_t>>& dstSizes);
+    bool Process(const ScaleImage& src, const std::vector<ScaleImage>& dst);
+
+    void SetUseNeon(bool useNeon) { useNeon_ = useNeon; }
+    static bool NeonAvailable();
+
+    ScaleFormat Format() const { return format_; }
+    uint32_t SrcWidth() const { return srcWidth_; }
+    uint32_t SrcHeight() const { return srcHeight_; }
+    size_t TargetCount() const { return targets_.size(); }
+
+private:
+    struct Target {
+        uint32_t width;
+        uint32_t height;
+        PolyphaseFilter vLuma;
+        PolyphaseFilter hLuma;
+        PolyphaseFilter vChroma;
+        PolyphaseFilter hChroma;
+    };
+
+    struct PlaneJob {
+        const PolyphaseFilter* vFilter;
+        uint8_t* dst;
+        uint32_t dstStride;
+        const Target* target;
+    };
+
+    void RunPlane(const uint8_t* src, uint32_t srcStride, uint32_t srcRows, uint32_t rowBytes,
+        std::vector<PlaneJob>& jobs, int plane);
+    void EmitRow(const int16_t* row, const PlaneJob& job, uint32_t y, int plane);
+
+    ScaleFormat format_ = SCALE_FORMAT_RGBA;
+    uint32_t srcWidth_ = 0;
+    uint32_t srcHeight_ = 0;
+    bool useNeon_ = true;
+    std::vector<Target> targets_;
+    std::vector<const uint8_t*> rowPtrs_;
+    std::vector<int16_t> vRow_;
+    std::vector<int16_t> lumaRow_;
+    std::vector<int16_t> chromaRow_;
+    std::vector<uint8_t> lumaOut_;
+    std::vector<uint8_t> chromaOut_;
+};
+} // namespace OHOS::Camera
+#endif
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rk_scale_node.h"
+#include <algorithm>
+#include <securec.h>
+#include "buffer_manager.h"
+
+namespace OHOS::Camera {
+RKScaleNode::RKScaleNode(const std::string& name, const std::string& type) : NodeBase(name, type)
+{
+    CAMERA_LOGV("%{public}s enter, type(%{public}s)\n", name_.c_str(), type_.c_str());
+}
+
+RKScaleNode::~RKScaleNode()
+{
+    CAMERA_LOGI("~RKScaleNode Node exit.");
+}
+
+RetCode RKScaleNode::Start(const int32_t streamId)
+{
+    CAMERA_LOGI("RKScaleNode::Start streamId = %{public}d\n", streamId);
+    std::lock_guard<std::mutex> l(scaleLock_);
+    runningStreams_.insert(streamId);
+    return RC_OK;
+}
+
+RetCode RKScaleNode::Stop(const int32_t streamId)
+{
+    CAMERA_LOGI("RKScaleNode::Stop streamId = %{public}d\n", streamId);
+    std::lock_guard<std::mutex> l(scaleLock_);
+    runningStreams_.erase(streamId);
+    return RC_OK;
+}
+
+RetCode RKScaleNode::Flush(const int32_t streamId)
+{
+    CAMERA_LOGI("RKScaleNode::Flush streamId = %{public}d\n", streamId);
+    return RC_OK;
+}
+
+bool RKScaleNode::ToScaleFormat(uint32_t format, ScaleFormat& scaleFormat)
+{
+    switch (format) {
+        case CAMERA_FORMAT_YCBCR_420_SP:
+            scaleFormat = SCALE_FORMAT_NV12;
+            return true;
+        case CAMERA_FORMAT_YUYV_422_PKG:
+            scaleFormat = SCALE_FORMAT_YUYV;
+            return true;
+        case CAMERA_FORMAT_RGBA_8888:
+            scaleFormat = SCALE_FORMAT_RGBA;
+            return true;
+        default:
+            return false;
+    }
+}
+
+uint32_t RKScaleNode::FrameSize(ScaleFormat format, uint32_t width, uint32_t height)
+{
+    constexpr uint32_t nv12Num = 3;
+    constexpr uint32_t nv12Den = 2;
+    constexpr uint32_t yuyvBytes = 2;
+    constexpr uint32_t rgbaBytes = 4;
+
+    switch (format) {
+        case SCALE_FORMAT_NV12:
+            return width * height * nv12Num / nv12Den;
+        case SCALE_FORMAT_YUYV:
+            return width * height * yuyvBytes;
+        default:
+            return width * height * rgbaBytes;
+    }
+}
+
+void RKScaleNode::CollectFanOut(const std::shared_ptr<IBuffer>& buffer, std::vector<FanOut>& fanOut)
+{
+    auto ports = GetOutPorts();
+    for (auto& it : ports) {
+        if (it->format_.streamId_ == buffer->GetStreamId()) {
+            fanOut.insert(fanOut.begin(), { it, buffer });
+            continue;
+        }
+        if (runningStreams_.count(it->format_.streamId_) == 0) {
+            continue;
+        }
+
+        // the other streams get their frame from their own pool instead of a full size fork
+        auto bufferPool = BufferManager::GetInstance()->GetBufferPool(it->format_.bufferPoolId_);
+        if (bufferPool == nullptr) {
+            continue;
+        }
+        std::shared_ptr<IBuffer> outBuffer = bufferPool->AcquireBuffer(0);
+        if (outBuffer == nullptr) {
+            CAMERA_LOGI("RKScaleNode stream %{public}d has no free buffer, skip", it->format_.streamId_);
+            continue;
+        }
+        outBuffer->SetStreamId(it->format_.streamId_);
+        outBuffer->SetFormat(buffer->GetFormat());
+        fanOut.push_back({ it, outBuffer });
+    }
+}
+
+bool RKScaleNode::ScaleBuffers(std::shared_ptr<IBuffer>& buffer, ScaleFormat format, std::vector<FanOut>& fanOut)
+{
+    uint32_t srcWidth = buffer->GetWidth();
+    uint32_t srcHeight = buffer->GetHeight();
+    uint32_t srcSize = FrameSize(format, srcWidth, srcHeight);
+    if (buffer->GetVirAddress() == nullptr || buffer->GetSize() < srcSize) {
+        CAMERA_LOGE("RKScaleNode::ScaleBuffers source buffer too small");
+        return false;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> sizes;
+    std::vector<size_t> scaled;
+    for (size_t i = 0; i < fanOut.size(); ++i) {
+        uint32_t w = fanOut[i].port->format_.w_;
+        uint32_t h = fanOut[i].port->format_.h_;
+        if (w == 0 || h == 0 || (w == srcWidth && h == srcHeight)) {
+            continue;
+        }
+        if (fanOut[i].buffer->GetSize() < FrameSize(format, w, h)) {
+            CAMERA_LOGE("RKScaleNode stream %{public}d buffer too small", fanOut[i].port->format_.streamId_);
+            fanOut[i].buffer->SetBufferStatus(CAMERA_BUFFER_STATUS_INVALID);
+            continue;
+        }
+        sizes.push_back({ w, h });
+        scaled.push_back(i);
+    }
+
+    bool reconfigure = scaler_.Format() != format || scaler_.SrcWidth() != srcWidth ||
+        scaler_.SrcHeight() != srcHeight || scaleSizes_ != sizes;
+    if (!sizes.empty() && reconfigure) {
+        scaleSizes_.clear();
+        if (!scaler_.Configure(format, srcWidth, srcHeight, sizes)) {
+            CAMERA_LOGE("RKScaleNode::ScaleBuffers unsupported size %{public}u x %{public}u", srcWidth, srcHeight);
+            return false;
+        }
+        scaleSizes_ = sizes;
+    }
+
+    // the source buffer is both input and output of its own stream, so its target goes to scratch
+    bool scaleInPlace = !scaled.empty() && fanOut[scaled[0]].buffer == buffer;
+    std::vector<ScaleImage> dst;
+    for (size_t i = 0; i < scaled.size(); ++i) {
+        ScaleImage image;
+        image.width = sizes[i].first;
+        image.height = sizes[i].second;
+        image.stride = FrameSize(format, image.width, 1);
+        if (format == SCALE_FORMAT_NV12) {
+            image.stride = image.width;
+        }
+        if (i == 0 && scaleInPlace) {
+            scratch_.resize(FrameSize(format, image.width, image.height));
+            image.data = scratch_.data();
+        } else {
+            image.data = static_cast<uint8_t*>(fanOut[scaled[i]].buffer->GetVirAddress());
+        }
+        dst.push_back(image);
+    }
+
+    ScaleImage src;
+    src.data = static_cast<uint8_t*>(buffer->GetVirAddress());
+    src.width = srcWidth;
+    src.height = srcHeight;
+    src.stride = format == SCALE_FORMAT_NV12 ? srcWidth : FrameSize(format, srcWidth, 1);
+    if (!dst.empty() && !scaler_.Process(src, dst)) {
+        CAMERA_LOGE("RKScaleNode::ScaleBuffers scale failed");
+        return false;
+    }
+
+    // streams at capture size that are not the source stream get a plain copy
+    for (size_t i = 0; i < fanOut.size(); ++i) {
+        if (fanOut[i].buffer == buffer || std::find(scaled.begin(), scaled.end(), i) != scaled.end() ||
+            fanOut[i].buffer->GetBufferStatus() != CAMERA_BUFFER_STATUS_OK) {
+            continue;
+        }
+        if (memcpy_s(fanOut[i].buffer->GetVirAddress(), fanOut[i].buffer->GetSize(),
+            buffer->GetVirAddress(), srcSize) != 0) {
+            CAMERA_LOGE("RKScaleNode::ScaleBuffers memcpy_s failed");
+        }
+        fanOut[i].buffer->SetWidth(srcWidth);
+        fanOut[i].buffer->SetHeight(srcHeight);
+    }
+
+    for (size_t i = 0; i < scaled.size(); ++i) {
+        auto& out = fanOut[scaled[i]].buffer;
+        out->SetWidth(sizes[i].first);
+        out->SetHeight(sizes[i].second);
+    }
+    if (scaleInPlace && memcpy_s(buffer->GetVirAddress(), buffer->GetSize(), scratch_.data(), scratch_.size()) != 0) {
+        CAMERA_LOGE("RKScaleNode::ScaleBuffers memcpy_s failed");
+        return false;
+    }
+    return true;
+}
+
+void RKScaleNode::DeliverBuffer(std::shared_ptr<IBuffer>& buffer)
+{
+    if (buffer == nullptr) {
+        CAMERA_LOGE("RKScaleNode::DeliverBuffer frameSpec is null");
+        return;
+    }
+
+    int32_t id = buffer->GetStreamId();
+    std::vector<FanOut> fanOut;
+    ScaleFormat format = SCALE_FORMAT_RGBA;
+    {
+        std::lock_guard<std::mutex> l(scaleLock_);
+        if (buffer->GetBufferStatus() == CAMERA_BUFFER_STATUS_OK && ToScaleFormat(buffer->GetFormat(), format)) {
+            CollectFanOut(buffer, fanOut);
+            if (!ScaleBuffers(buffer, format, fanOut)) {
+                // pool buffers still travel down their stream so they are returned, just dropped
+                for (auto& it : fanOut) {
+                    if (it.buffer != buffer) {
+                        it.buffer->SetBufferStatus(CAMERA_BUFFER_STATUS_INVALID);
+                    }
+                }
+            }
+        }
+    }
+
+    if (fanOut.empty() || fanOut[0].buffer != buffer) {
+        auto ports = GetOutPorts();
+        for (auto& it : ports) {
+            if (it->format_.streamId_ == id) {
+                it->DeliverBuffer(buffer);
+                break;
+            }
+        }
+    }
+
+    for (auto& it : fanOut) {
+        it.port->DeliverBuffer(it.buffer);
+        CAMERA_LOGI("RKScaleNode deliver buffer streamid = %{public}d", it.port->format_.streamId_);
+    }
+}
+
+RetCode RKScaleNode::Capture(const int32_t streamId, const int32_t captureId)
+{
+    CAMERA_LOGV("RKScaleNode::Capture");
+    return RC_OK;
+}
+
+RetCode RKScaleNode::CancelCapture(const int32_t streamId)
+{
+    CAMERA_LOGI("RKScaleNode::CancelCapture streamid = %{public}d", streamId);
+    return RC_OK;
+}
+
+REGISTERNODE(RKScaleNode, {"RKScale"})
+} // namespace OHOS::Camera
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HOS_CAMERA_RKSCALE_NODE_H
+#define HOS_CAMERA_RKSCALE_NODE_H
+
+#include <mutex>
+#include <set>
+#include <vector>
+#include "device_manager_adapter.h"
+#include "utils.h"
+#include "camera.h"
+#include "source_node.h"
+#include "rk_scale_kernel.h"
+
+namespace OHOS::Camera {
+// Downscales the captured frame once for every output port, so preview, video and analytics
+// streams continue through conversion and encode at their own resolution instead of the
+// capture resolution.
+class RKScaleNode : public NodeBase {
+public:
+    RKScaleNode(const std::string& name, const std::string& type);
+    ~RKScaleNode() override;
+    RetCode Start(const int32_t streamId) override;
+    RetCode Stop(const int32_t streamId) override;
+    void DeliverBuffer(std::shared_ptr<IBuffer>& buffer) override;
+    virtual RetCode Capture(const int32_t streamId, const int32_t captureId) override;
+    RetCode CancelCapture(const int32_t streamId) override;
+    RetCode Flush(const int32_t streamId);
+private:
+    struct FanOut {
+        std::shared_ptr<IPort> port;
+        std::shared_ptr<IBuffer> buffer;
+    };
+
+    bool ToScaleFormat(uint32_t format, ScaleFormat& scaleFormat);
+    uint32_t FrameSize(ScaleFormat format, uint32_t width, uint32_t height);
+    void CollectFanOut(const std::shared_ptr<IBuffer>& buffer, std::vector<FanOut>& fanOut);
+    bool ScaleBuffers(std::shared_ptr<IBuffer>& buffer, ScaleFormat format, std::vector<FanOut>& fanOut);
+
+    std::mutex                            scaleLock_;
+    std::set<int32_t>                     runningStreams_;
+    RKScaler                              scaler_;
+    std::vector<std::pair<uint32_t, uint32_t>> scaleSizes_;
+    std::vector<uint8_t>                  scratch_;
+};
+} // namespace OHOS::Camera
+#endif
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "h264_encode_queue.h"
+
+using namespace OHOS::Camera;
+
+namespace {
+constexpr uint32_t WIDTH = 1920;
+constexpr uint32_t HEIGHT = 1080;
+constexpr size_t STREAM_BYTES = 4 << 20;
+constexpr size_t NAL_SPACING = 64 << 10;
+
+// compressed-looking payload: random bytes with a start code every NAL_SPACING bytes
+std::vector<uint8_t> MakeStream()
+{
+    std::vector<uint8_t> stream(STREAM_BYTES);
+    std::mt19937 rng(1);
+    for (auto& v : stream) {
+        v = static_cast<uint8_t>(rng());
+    }
+    for (size_t i = 0; i + 4 < stream.size(); i += NAL_SPACING) {
+        stream[i] = 0;
+        stream[i + 1] = 0;
+        stream[i + 2] = 1;
+        stream[i + 3] = (i / NAL_SPACING) % 8 == 0 ? H264_NAL_IDR : H264_NAL_SLICE;
+    }
+    return stream;
+}
+
+// byte at a time start code search RKCodecNode used before the scanner
+size_t LegacyScan(const uint8_t* buf, size_t size)
+{
+    size_t found = 0;
+    for (size_t i = 0; i + 4 < size; ++i) {
+        if (buf[i] == 0 && buf[i + 1] == 0 && buf[i + 2] == 0 && buf[i + 3] == 1) {
+            found++;
+        } else if (buf[i] == 0 && buf[i + 1] == 0 && buf[i + 2] == 1) {
+            found++;
+        }
+    }
+    return found;
+}
+
+void BM_NalScanLegacy(benchmark::State& state)
+{
+    std::vector<uint8_t> stream = MakeStream();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(LegacyScan(stream.data(), stream.size()));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * stream.size());
+}
+
+void BM_NalScan(benchmark::State& state)
+{
+    std::vector<uint8_t> stream = MakeStream();
+    std::vector<H264NalUnit> nals;
+    for (auto _ : state) {
+        H264ScanNalUnits(stream.data(), stream.size(), nals, state.range(0) != 0);
+        benchmark::DoNotOptimize(nals.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * stream.size());
+}
+
+// 1080p frames through the encode queue with the software backend; arg is the GOP
+void BM_SoftEncodeQueue(benchmark::State& state)
+{
+    constexpr size_t depth = 3;
+    const size_t frameBytes = WIDTH * HEIGHT * 3 / 2;
+    std::vector<std::vector<uint8_t>> buffers(depth + 1, std::vector<uint8_t>(frameBytes * 2, 0x80));
+    H264EncodeQueue queue(std::make_unique<SoftH264Encoder>(static_cast<uint32_t>(state.range(0))), depth);
+    size_t bytes = 0;
+    size_t next = 0;
+    for (auto _ : state) {
+        H264EncodeFrame frame;
+        frame.virAddr = buffers[next].data();
+        frame.capacity = buffers[next].size();
+        frame.width = WIDTH;
+        frame.height = HEIGHT;
+        next = (next + 1) % buffers.size();
+        while (!queue.Submit(frame, [&bytes](const H264EncodeResult& result) { bytes += result.size; })) {
+            queue.Drain();
+        }
+    }
+    queue.Drain();
+    state.SetItemsProcessed(state.iterations());
+    state.counters["stream_MB"] = static_cast<double>(bytes) / (1 << 20);
+}
+} // namespace
+
+BENCHMARK(BM_NalScanLegacy);
+BENCHMARK(BM_NalScan)->Arg(0)->Arg(1);
+BENCHMARK(BM_SoftEncodeQueue)->Arg(1)->Arg(30)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_MAIN();
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "rk_scale_kernel.h"
+
+using namespace OHOS::Camera;
+
+namespace {
+constexpr uint32_t SRC_WIDTH = 1920;
+constexpr uint32_t SRC_HEIGHT = 1080;
+constexpr uint32_t YUYV_BYTES = 2;
+constexpr uint32_t RGBA_BYTES = 4;
+// preview, video and analytics sizes fed from one 1080p capture
+const std::vector<std::pair<uint32_t, uint32_t>> TARGETS = { {1280, 720}, {640, 360}, {320, 240} };
+
+inline uint8_t Clamp(int32_t v)
+{
+    return static_cast<uint8_t>(std::min(std::max(v, 0), 255));
+}
+
+// same integer BT.601 conversion RKCodecNode applies to preview frames
+void YuyvToRgba(const uint8_t* yuyv, uint8_t* rgba, uint32_t width, uint32_t height)
+{
+    for (uint32_t i = 0; i < width * height; ++i) {
+        int32_t y = yuyv[i * 2] - 16;
+        int32_t u = yuyv[(i / 2) * 4 + 1] - 128;
+        int32_t v = yuyv[(i / 2) * 4 + 3] - 128;
+        rgba[i * 4] = Clamp((1164 * y + 1596 * v) / 1000);
+        rgba[i * 4 + 1] = Clamp((1164 * y - 391 * u - 813 * v) / 1000);
+        rgba[i * 4 + 2] = Clamp((1164 * y + 2018 * u) / 1000);
+        rgba[i * 4 + 3] = 255;
+    }
+}
+
+std::vector<uint8_t> MakeYuyv()
+{
+    std::vector<uint8_t> frame(SRC_WIDTH * SRC_HEIGHT * YUYV_BYTES);
+    for (size_t i = 0; i < frame.size(); ++i) {
+        frame[i] = static_cast<uint8_t>(i * 7 + (i >> 11));
+    }
+    return frame;
+}
+
+ScaleImage Image(std::vector<uint8_t>& buf, uint32_t w, uint32_t h, uint32_t bytes)
+{
+    ScaleImage image;
+    image.data = buf.data();
+    image.width = w;
+    image.height = h;
+    image.stride = w * bytes;
+    return image;
+}
+
+// every stream converts the full capture and scales the RGBA result down
+void BM_ConvertThenScale(benchmark::State& state)
+{
+    std::vector<uint8_t> src = MakeYuyv();
+    std::vector<uint8_t> rgba(SRC_WIDTH * SRC_HEIGHT * RGBA_BYTES);
+    std::vector<RKScaler> scalers(TARGETS.size());
+    std::vector<std::vector<uint8_t>> out;
+    for (size_t i = 0; i < TARGETS.size(); ++i) {
+        scalers[i].SetUseNeon(state.range(0) != 0);
+        scalers[i].Configure(SCALE_FORMAT_RGBA, SRC_WIDTH, SRC_HEIGHT, { TARGETS[i] });
+        out.emplace_back(TARGETS[i].first * TARGETS[i].second * RGBA_BYTES);
+    }
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < TARGETS.size(); ++i) {
+            YuyvToRgba(src.data(), rgba.data(), SRC_WIDTH, SRC_HEIGHT);
+            scalers[i].Process(Image(rgba, SRC_WIDTH, SRC_HEIGHT, RGBA_BYTES),
+                { Image(out[i], TARGETS[i].first, TARGETS[i].second, RGBA_BYTES) });
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// one fan-out pass over the capture, then every stream converts its own small frame
+void BM_ScaleThenConvert(benchmark::State& state)
+{
+    std::vector<uint8_t> src = MakeYuyv();
+    RKScaler scaler;
+    scaler.SetUseNeon(state.range(0) != 0);
+    scaler.Configure(SCALE_FORMAT_YUYV, SRC_WIDTH, SRC_HEIGHT, TARGETS);
+    std::vector<std::vector<uint8_t>> yuyv;
+    std::vector<std::vector<uint8_t>> rgba;
+    std::vector<ScaleImage> dst;
+    for (auto& t : TARGETS) {
+        yuyv.emplace_back(t.first * t.second * YUYV_BYTES);
+        rgba.emplace_back(t.first * t.second * RGBA_BYTES);
+        dst.push_back(Image(yuyv.back(), t.first, t.second, YUYV_BYTES));
+    }
+
+    for (auto _ : state) {
+        scaler.Process(Image(src, SRC_WIDTH, SRC_HEIGHT, YUYV_BYTES), dst);
+        for (size_t i = 0; i < TARGETS.size(); ++i) {
+            YuyvToRgba(yuyv[i].data(), rgba[i].data(), TARGETS[i].first, TARGETS[i].second);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// NV12 fan-out pass on its own
+void BM_FanOutScale(benchmark::State& state)
+{
+    RKScaler scaler;
+    scaler.SetUseNeon(state.range(0) != 0);
+    scaler.Configure(SCALE_FORMAT_NV12, SRC_WIDTH, SRC_HEIGHT, TARGETS);
+    std::vector<uint8_t> nv12(SRC_WIDTH * SRC_HEIGHT * 3 / 2);
+    std::vector<std::vector<uint8_t>> out;
+    std::vector<ScaleImage> dst;
+    for (auto& t : TARGETS) {
+        out.emplace_back(t.first * t.second * 3 / 2);
+        dst.push_back(Image(out.back(), t.first, t.second, 1));
+    }
+
+    for (auto _ : state) {
+        scaler.Process(Image(nv12, SRC_WIDTH, SRC_HEIGHT, 1), dst);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+} // namespace
+
+BENCHMARK(BM_ConvertThenScale)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ScaleThenConvert)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FanOutScale)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_MAIN();
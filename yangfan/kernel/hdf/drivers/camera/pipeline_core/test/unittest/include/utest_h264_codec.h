@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HOS_CAMERA_UTEST_H264_CODEC_H
+#define HOS_CAMERA_UTEST_H264_CODEC_H
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "h264_encode_queue.h"
+
+namespace OHOS::Camera {
+class UtestH264Codec : public testing::Test {
+public:
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp(void);
+    void TearDown(void);
+
+    static std::vector<uint8_t> MakeI420(uint32_t width, uint32_t height, uint32_t seed);
+    // RBSP of the NAL payload after the header byte, emulation prevention removed.
+    static std::vector<uint8_t> Unescape(const uint8_t* data, size_t size);
+};
+} // namespace OHOS::Camera
+#endif
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HOS_CAMERA_UTEST_RK_SCALE_H
+#define HOS_CAMERA_UTEST_RK_SCALE_H
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "rk_scale_kernel.h"
+
+namespace OHOS::Camera {
+class UtestRKScale : public testing::Test {
+public:
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp(void);
+    void TearDown(void);
+
+    static std::vector<uint8_t> MakeFrame(ScaleFormat format, uint32_t width, uint32_t height);
+    static uint32_t RowBytes(ScaleFormat format, uint32_t width);
+    static uint32_t FrameBytes(ScaleFormat format, uint32_t width, uint32_t height);
+};
+} // namespace OHOS::Camera
+#endif
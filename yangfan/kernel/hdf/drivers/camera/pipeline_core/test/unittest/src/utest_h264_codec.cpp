@@ -0,0 +1,405 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <gtest/gtest.h>
+
+#include "utest_h264_codec.h"
+
+using namespace testing::ext;
+namespace OHOS::Camera {
+namespace {
+constexpr uint32_t MB_SIZE = 16;
+constexpr uint32_t MB_CHROMA = 8;
+
+class BitReader {
+public:
+    explicit BitReader(const std::vector<uint8_t>& data) : data_(data) {}
+
+    uint32_t Bits(uint32_t count)
+    {
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            value = (value << 1) | ((data_[pos_ >> 3] >> (7 - (pos_ & 7))) & 1);
+            pos_++;
+        }
+        return value;
+    }
+
+    uint32_t Ue()
+    {
+        uint32_t zeros = 0;
+        while (Bits(1) == 0) {
+            zeros++;
+        }
+        return (1u << zeros) - 1 + Bits(zeros);
+    }
+
+    int32_t Se()
+    {
+        uint32_t v = Ue();
+        return (v & 1) ? static_cast<int32_t>((v + 1) / 2) : -static_cast<int32_t>(v / 2);
+    }
+
+    void Align()
+    {
+        pos_ = (pos_ + 7) & ~static_cast<size_t>(7);
+    }
+
+private:
+    const std::vector<uint8_t>& data_;
+    size_t pos_ = 0;
+};
+
+size_t NaiveStartCode(const std::vector<uint8_t>& data, size_t from)
+{
+    for (size_t i = from; i + 3 <= data.size(); ++i) {
+        if (data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1) {
+            return i;
+        }
+    }
+    return data.size();
+}
+
+// Blocks on Encode until released, to keep the queue full.
+class GateEncoder : public IH264Encoder {
+public:
+    GateEncoder(std::atomic<bool>& open, std::atomic<bool>& entered) : open_(open), entered_(entered) {}
+    bool Init(uint32_t, uint32_t) override { return true; }
+    bool Encode(const H264EncodeFrame&, size_t& streamSize) override
+    {
+        entered_ = true;
+        while (!open_.load()) {
+            std::this_thread::yield();
+        }
+        streamSize = 0;
+        return false;
+    }
+    void Deinit() override {}
+private:
+    std::atomic<bool>& open_;
+    std::atomic<bool>& entered_;
+};
+} // namespace
+
+void UtestH264Codec::SetUpTestCase(void)
+{
+    std::cout << "SetUpTestCase.." << std::endl;
+}
+
+void UtestH264Codec::TearDownTestCase(void)
+{
+    std::cout << "TearDownTestCase.." << std::endl;
+}
+
+void UtestH264Codec::SetUp(void)
+{
+}
+
+void UtestH264Codec::TearDown(void)
+{
+}
+
+std::vector<uint8_t> UtestH264Codec::MakeI420(uint32_t width, uint32_t height, uint32_t seed)
+{
+    std::vector<uint8_t> frame(width * height * 3 / 2);
+    std::mt19937 rng(seed);
+    for (auto& v : frame) {
+        // plenty of zero bytes so emulation prevention is exercised
+        v = (rng() % 4 == 0) ? 0 : static_cast<uint8_t>(rng());
+    }
+    return frame;
+}
+
+std::vector<uint8_t> UtestH264Codec::Unescape(const uint8_t* data, size_t size)
+{
+    std::vector<uint8_t> rbsp;
+    uint32_t zeros = 0;
+    for (size_t i = 1; i < size; ++i) {
+        if (zeros == 2 && data[i] == 3) {
+            zeros = 0;
+            continue;
+        }
+        rbsp.push_back(data[i]);
+        zeros = data[i] == 0 ? zeros + 1 : 0;
+    }
+    return rbsp;
+}
+
+HWTEST_F(UtestH264Codec, FindStartCodeMatchesNaive, TestSize.Level0)
+{
+    std::mt19937 rng(7);
+    for (uint32_t round = 0; round < 200; ++round) {
+        std::vector<uint8_t> data(rng() % 300 + 1);
+        for (auto& v : data) {
+            v = static_cast<uint8_t>(rng() % 3);
+        }
+        for (size_t from = 0; from < data.size(); from += 1 + rng() % 5) {
+            size_t expect = NaiveStartCode(data, from);
+            EXPECT_EQ(expect, H264FindStartCode(data.data(), data.size(), from, true));
+            EXPECT_EQ(expect, H264FindStartCode(data.data(), data.size(), from, false));
+        }
+    }
+}
+
+HWTEST_F(UtestH264Codec, ScanNalUnits, TestSize.Level0)
+{
+    // SPS with a four byte start code, PPS and IDR with three, one trailing zero byte
+    const std::vector<uint8_t> stream = {
+        0, 0, 0, 1, 0x67, 0x42, 0x00, 0x1f,
+        0, 0, 1, 0x68, 0xce,
+        0, 0, 1, 0x65, 0x88, 0x84, 0x00, 0x00, 0x03, 0x01, 0x00,
+    };
+    std::vector<H264NalUnit> nals;
+    H264ScanNalUnits(stream.data(), stream.size(), nals);
+    ASSERT_EQ(3u, nals.size());
+    EXPECT_EQ(H264_NAL_SPS, nals[0].type);
+    EXPECT_EQ(0u, nals[0].startCode);
+    EXPECT_EQ(4u, nals[0].offset);
+    EXPECT_EQ(4u, nals[0].size);
+    EXPECT_EQ(H264_NAL_PPS, nals[1].type);
+    EXPECT_EQ(8u, nals[1].startCode);
+    EXPECT_EQ(2u, nals[1].size);
+    EXPECT_EQ(H264_NAL_IDR, nals[2].type);
+    EXPECT_EQ(13u, nals[2].startCode);
+    EXPECT_EQ(7u, nals[2].size);
+
+    std::vector<uint32_t> offsets;
+    H264KeyFrameOffsets(nals, offsets);
+    ASSERT_EQ(1u, offsets.size());
+    EXPECT_EQ(13u, offsets[0]);
+}
+
+HWTEST_F(UtestH264Codec, SoftEncoderIdrRoundTrip, TestSize.Level0)
+{
+    // width and height off the macroblock grid so cropping and edge padding are covered
+    constexpr uint32_t width = 72;
+    constexpr uint32_t height = 40;
+    const uint32_t mbW = (width + MB_SIZE - 1) / MB_SIZE;
+    const uint32_t mbH = (height + MB_SIZE - 1) / MB_SIZE;
+    std::vector<uint8_t> src = MakeI420(width, height, 1);
+    std::vector<uint8_t> buffer(src.size() * 2);
+    std::copy(src.begin(), src.end(), buffer.begin());
+
+    SoftH264Encoder encoder;
+    ASSERT_TRUE(encoder.Init(width, height));
+    H264EncodeFrame frame;
+    frame.virAddr = buffer.data();
+    frame.capacity = buffer.size();
+    frame.width = width;
+    frame.height = height;
+    size_t size = 0;
+    ASSERT_TRUE(encoder.Encode(frame, size));
+
+    std::vector<H264NalUnit> nals;
+    H264ScanNalUnits(buffer.data(), size, nals);
+    ASSERT_EQ(3u, nals.size());
+    EXPECT_EQ(H264_NAL_SPS, nals[0].type);
+    EXPECT_EQ(H264_NAL_PPS, nals[1].type);
+    ASSERT_EQ(H264_NAL_IDR, nals[2].type);
+
+    std::vector<uint8_t> sps = Unescape(buffer.data() + nals[0].offset, nals[0].size);
+    BitReader spsReader(sps);
+    EXPECT_EQ(66u, spsReader.Bits(8));
+    spsReader.Bits(16);
+    EXPECT_EQ(0u, spsReader.Ue());
+    spsReader.Ue();
+    EXPECT_EQ(2u, spsReader.Ue());
+    spsReader.Ue();
+    spsReader.Bits(1);
+    EXPECT_EQ(mbW - 1, spsReader.Ue());
+    EXPECT_EQ(mbH - 1, spsReader.Ue());
+    spsReader.Bits(2);
+    ASSERT_EQ(1u, spsReader.Bits(1));
+    EXPECT_EQ(0u, spsReader.Ue());
+    EXPECT_EQ((mbW * MB_SIZE - width) / 2, spsReader.Ue());
+    EXPECT_EQ(0u, spsReader.Ue());
+    EXPECT_EQ((mbH * MB_SIZE - height) / 2, spsReader.Ue());
+
+    std::vector<uint8_t> idr = Unescape(buffer.data() + nals[2].offset, nals[2].size);
+    BitReader r(idr);
+    EXPECT_EQ(0u, r.Ue());      // first_mb_in_slice
+    EXPECT_EQ(7u, r.Ue());      // I slice
+    EXPECT_EQ(0u, r.Ue());      // pps id
+    EXPECT_EQ(0u, r.Bits(4));   // frame_num
+    r.Ue();                     // idr_pic_id
+    r.Bits(2);
+    EXPECT_EQ(0, r.Se());
+    EXPECT_EQ(1u, r.Ue());
+    const uint8_t* u = src.data() + width * height;
+    const uint8_t* v = u + width * height / 4;
+    for (uint32_t mb = 0; mb < mbW * mbH; ++mb) {
+        ASSERT_EQ(25u, r.Ue());
+        r.Align();
+        uint32_t mx = mb % mbW;
+        uint32_t my = mb / mbW;
+        for (uint32_t y = 0; y < MB_SIZE; ++y) {
+            for (uint32_t x = 0; x < MB_SIZE; ++x) {
+                uint32_t sx = std::min(mx * MB_SIZE + x, width - 1);
+                uint32_t sy = std::min(my * MB_SIZE + y, height - 1);
+                ASSERT_EQ(src[sy * width + sx], r.Bits(8));
+            }
+        }
+        for (const uint8_t* plane : { u, v }) {
+            for (uint32_t y = 0; y < MB_CHROMA; ++y) {
+                for (uint32_t x = 0; x < MB_CHROMA; ++x) {
+                    uint32_t sx = std::min(mx * MB_CHROMA + x, width / 2 - 1);
+                    uint32_t sy = std::min(my * MB_CHROMA + y, height / 2 - 1);
+                    ASSERT_EQ(plane[sy * (width / 2) + sx], r.Bits(8));
+                }
+            }
+        }
+    }
+    EXPECT_EQ(1u, r.Bits(1));   // rbsp_stop_one_bit
+}
+
+HWTEST_F(UtestH264Codec, SoftEncoderGop, TestSize.Level0)
+{
+    constexpr uint32_t width = 64;
+    constexpr uint32_t height = 32;
+    constexpr uint32_t gop = 3;
+    std::vector<uint8_t> src = MakeI420(width, height, 2);
+    std::vector<uint8_t> buffer(src.size() * 2);
+
+    SoftH264Encoder encoder(gop);
+    ASSERT_TRUE(encoder.Init(width, height));
+    for (uint32_t i = 0; i < gop * 2 + 1; ++i) {
+        std::copy(src.begin(), src.end(), buffer.begin());
+        H264EncodeFrame frame;
+        frame.virAddr = buffer.data();
+        frame.capacity = buffer.size();
+        frame.width = width;
+        frame.height = height;
+        size_t size = 0;
+        ASSERT_TRUE(encoder.Encode(frame, size));
+        std::vector<H264NalUnit> nals;
+        H264ScanNalUnits(buffer.data(), size, nals);
+        ASSERT_FALSE(nals.empty());
+        if (i % gop == 0) {
+            EXPECT_EQ(H264_NAL_IDR, nals.back().type);
+        } else {
+            ASSERT_EQ(1u, nals.size());
+            EXPECT_EQ(H264_NAL_SLICE, nals[0].type);
+            std::vector<uint8_t> rbsp = Unescape(buffer.data() + nals[0].offset, nals[0].size);
+            BitReader r(rbsp);
+            r.Ue();
+            EXPECT_EQ(5u, r.Ue());
+            r.Ue();
+            EXPECT_EQ(i % gop, r.Bits(4));
+        }
+    }
+}
+
+HWTEST_F(UtestH264Codec, SoftEncoderRejectsSmallBuffer, TestSize.Level0)
+{
+    constexpr uint32_t width = 64;
+    constexpr uint32_t height = 32;
+    std::vector<uint8_t> src = MakeI420(width, height, 3);
+    SoftH264Encoder encoder;
+    ASSERT_TRUE(encoder.Init(width, height));
+    H264EncodeFrame frame;
+    frame.virAddr = src.data();
+    frame.capacity = src.size();
+    frame.width = width;
+    frame.height = height;
+    size_t size = 0;
+    EXPECT_FALSE(encoder.Encode(frame, size));
+    EXPECT_EQ(0u, size);
+    EXPECT_FALSE(encoder.Init(width + 1, height));
+}
+
+HWTEST_F(UtestH264Codec, EncodeQueueInOrder, TestSize.Level0)
+{
+    constexpr uint32_t width = 64;
+    constexpr uint32_t height = 32;
+    constexpr uint32_t frames = 8;
+    constexpr uint32_t gop = 4;
+    std::vector<std::vector<uint8_t>> buffers;
+    for (uint32_t i = 0; i < frames; ++i) {
+        std::vector<uint8_t> src = MakeI420(width, height, i);
+        src.resize(src.size() * 2);
+        buffers.push_back(src);
+    }
+
+    std::mutex lock;
+    std::vector<std::pair<uint32_t, H264EncodeResult>> results;
+    H264EncodeQueue queue(std::make_unique<SoftH264Encoder>(gop), frames);
+    for (uint32_t i = 0; i < frames; ++i) {
+        H264EncodeFrame frame;
+        frame.virAddr = buffers[i].data();
+        frame.capacity = buffers[i].size();
+        frame.width = width;
+        frame.height = height;
+        ASSERT_TRUE(queue.Submit(frame, [&lock, &results, i](const H264EncodeResult& result) {
+            std::lock_guard<std::mutex> l(lock);
+            results.push_back({ i, result });
+        }));
+    }
+    queue.Drain();
+    EXPECT_EQ(0u, queue.Pending());
+
+    ASSERT_EQ(frames, results.size());
+    for (uint32_t i = 0; i < frames; ++i) {
+        EXPECT_EQ(i, results[i].first);
+        EXPECT_TRUE(results[i].second.ok);
+        EXPECT_EQ(i % gop == 0, results[i].second.keyFrame);
+        if (results[i].second.keyFrame) {
+            std::vector<H264NalUnit> nals;
+            H264ScanNalUnits(buffers[i].data(), results[i].second.size, nals);
+            ASSERT_EQ(1u, results[i].second.keyOffsets.size());
+            EXPECT_EQ(nals.back().startCode, results[i].second.keyOffsets[0]);
+        }
+    }
+}
+
+HWTEST_F(UtestH264Codec, EncodeQueueBackpressureAndFlush, TestSize.Level0)
+{
+    constexpr size_t depth = 2;
+    std::atomic<bool> open(false);
+    std::atomic<bool> entered(false);
+    std::atomic<uint32_t> failed(0);
+    std::vector<uint8_t> buffer(64);
+    H264EncodeFrame frame;
+    frame.virAddr = buffer.data();
+    frame.capacity = buffer.size();
+    frame.width = 16;
+    frame.height = 16;
+    auto done = [&failed](const H264EncodeResult& result) {
+        if (!result.ok) {
+            failed++;
+        }
+    };
+
+    H264EncodeQueue queue(std::make_unique<GateEncoder>(open, entered), depth);
+    ASSERT_TRUE(queue.Submit(frame, done));
+    // wait for the worker to block inside the encoder with the first job
+    while (!entered.load()) {
+        std::this_thread::yield();
+    }
+    for (size_t i = 0; i < depth; ++i) {
+        EXPECT_TRUE(queue.Submit(frame, done));
+    }
+    EXPECT_FALSE(queue.Submit(frame, done));
+
+    open = true;
+    queue.Flush();
+    queue.Drain();
+    EXPECT_EQ(depth + 1, failed.load());
+    EXPECT_TRUE(queue.Submit(frame, done));
+    queue.Drain();
+}
+} // namespace OHOS::Camera
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+
+#include "utest_rk_scale.h"
+
+using namespace testing::ext;
+namespace OHOS::Camera {
+namespace {
+constexpr uint32_t SRC_WIDTH = 640;
+constexpr uint32_t SRC_HEIGHT = 480;
+const std::vector<std::pair<uint32_t, uint32_t>> TARGETS = { {320, 240}, {424, 240}, {160, 120}, {176, 144} };
+
+struct TentTap {
+    uint32_t src;
+    int32_t weight;
+};
+using TentTable = std::vector<std::vector<TentTap>>;
+
+// Q14 weights of a tent filter of radius max(1, srcLen / dstLen) around each output center,
+// computed in doubles independently of the kernel's tables. Samples past the frame edge fold
+// onto the edge pixel and the rounding remainder goes to the largest weight.
+TentTable TentWeights(uint32_t srcLen, uint32_t dstLen)
+{
+    constexpr int32_t one = 1 << 14;
+    double scale = static_cast<double>(srcLen) / dstLen;
+    double radius = std::max(1.0, scale);
+    TentTable table(dstLen);
+    for (uint32_t i = 0; i < dstLen; ++i) {
+        double center = (i + 0.5) * scale - 0.5;
+        std::vector<double> weights(srcLen, 0.0);
+        double sum = 0.0;
+        for (int32_t j = static_cast<int32_t>(std::floor(center - radius));
+            j <= static_cast<int32_t>(std::ceil(center + radius)); ++j) {
+            double w = 1.0 - std::fabs(j - center) / radius;
+            if (w > 0.0) {
+                weights[std::min(std::max(j, 0), static_cast<int32_t>(srcLen) - 1)] += w;
+                sum += w;
+            }
+        }
+
+        int32_t total = 0;
+        size_t peak = 0;
+        for (uint32_t s = 0; s < srcLen; ++s) {
+            if (weights[s] > 0.0) {
+                table[i].push_back({ s, static_cast<int32_t>(std::lround(weights[s] / sum * one)) });
+                total += table[i].back().weight;
+                peak = table[i].back().weight > table[i][peak].weight ? table[i].size() - 1 : peak;
+            }
+        }
+        table[i][peak].weight += one - total;
+    }
+    return table;
+}
+
+uint8_t RefPixel(int32_t acc)
+{
+    constexpr int32_t shift = 21;
+    return static_cast<uint8_t>(std::min(std::max((acc + (1 << (shift - 1))) >> shift, 0), 255));
+}
+
+// straightforward separable filter: a vertical pass rounded to Q7, then horizontal passes
+void RefPlane(const uint8_t* src, uint32_t srcStride, uint32_t rowBytes, const TentTable& v,
+    const std::vector<std::pair<TentTable, uint32_t>>& hPasses, uint8_t* dst, uint32_t dstStride)
+{
+    constexpr int32_t interShift = 7;
+    std::vector<int16_t> row(rowBytes);
+    for (uint32_t y = 0; y < v.size(); ++y) {
+        for (uint32_t x = 0; x < rowBytes; ++x) {
+            int32_t acc = 0;
+            for (auto& tap : v[y]) {
+                acc += src[tap.src * srcStride + x] * tap.weight;
+            }
+            row[x] = static_cast<int16_t>((acc + (1 << (interShift - 1))) >> interShift);
+        }
+
+        // each pass reads every step-th sample starting at phase and writes the same layout
+        uint32_t step = static_cast<uint32_t>(hPasses.size()) == 1 ? 1 : 2;
+        for (uint32_t p = 0; p < hPasses.size(); ++p) {
+            const TentTable& h = hPasses[p].first;
+            uint32_t channels = hPasses[p].second;
+            for (uint32_t i = 0; i < h.size(); ++i) {
+                for (uint32_t c = 0; c < channels; ++c) {
+                    int32_t acc = 0;
+                    for (auto& tap : h[i]) {
+                        acc += row[(tap.src * channels + c) * step + p] * tap.weight;
+                    }
+                    dst[y * dstStride + (i * channels + c) * step + p] = RefPixel(acc);
+                }
+            }
+        }
+    }
+}
+
+std::vector<uint8_t> RefScale(ScaleFormat format, const std::vector<uint8_t>& src, uint32_t w, uint32_t h)
+{
+    std::vector<uint8_t> dst(UtestRKScale::FrameBytes(format, w, h));
+    uint32_t srcRow = UtestRKScale::RowBytes(format, SRC_WIDTH);
+    uint32_t dstRow = UtestRKScale::RowBytes(format, w);
+    TentTable vLuma = TentWeights(SRC_HEIGHT, h);
+    TentTable hLuma = TentWeights(SRC_WIDTH, w);
+    TentTable hChroma = TentWeights(SRC_WIDTH / 2, w / 2);
+    if (format == SCALE_FORMAT_RGBA) {
+        RefPlane(src.data(), srcRow, srcRow, vLuma, { { hLuma, 4 } }, dst.data(), dstRow);
+    } else if (format == SCALE_FORMAT_YUYV) {
+        RefPlane(src.data(), srcRow, srcRow, vLuma, { { hLuma, 1 }, { hChroma, 2 } }, dst.data(), dstRow);
+    } else {
+        TentTable vChroma = TentWeights(SRC_HEIGHT / 2, h / 2);
+        RefPlane(src.data(), srcRow, srcRow, vLuma, { { hLuma, 1 } }, dst.data(), dstRow);
+        RefPlane(src.data() + srcRow * SRC_HEIGHT, srcRow, srcRow, vChroma, { { hChroma, 2 } },
+            dst.data() + dstRow * h, dstRow);
+    }
+    return dst;
+}
+
+std::vector<std::vector<uint8_t>> RunScaler(RKScaler& scaler, ScaleFormat format, std::vector<uint8_t>& src,
+    const std::vector<std::pair<uint32_t, uint32_t>>& sizes)
+{
+    std::vector<std::vector<uint8_t>> out;
+    std::vector<ScaleImage> dst;
+    for (auto& size : sizes) {
+        out.emplace_back(UtestRKScale::FrameBytes(format, size.first, size.second));
+    }
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        ScaleImage image;
+        image.data = out[i].data();
+        image.width = sizes[i].first;
+        image.height = sizes[i].second;
+        image.stride = UtestRKScale::RowBytes(format, sizes[i].first);
+        dst.push_back(image);
+    }
+
+    ScaleImage in;
+    in.data = src.data();
+    in.width = SRC_WIDTH;
+    in.height = SRC_HEIGHT;
+    in.stride = UtestRKScale::RowBytes(format, SRC_WIDTH);
+    EXPECT_EQ(true, scaler.Process(in, dst));
+    return out;
+}
+
+void CheckAgainstReference(ScaleFormat format)
+{
+    std::vector<uint8_t> src = UtestRKScale::MakeFrame(format, SRC_WIDTH, SRC_HEIGHT);
+    RKScaler scaler;
+    EXPECT_EQ(true, scaler.Configure(format, SRC_WIDTH, SRC_HEIGHT, TARGETS));
+
+    scaler.SetUseNeon(false);
+    auto scalar = RunScaler(scaler, format, src, TARGETS);
+    scaler.SetUseNeon(true);
+    auto vector = RunScaler(scaler, format, src, TARGETS);
+    for (size_t i = 0; i < TARGETS.size(); ++i) {
+        EXPECT_EQ(RefScale(format, src, TARGETS[i].first, TARGETS[i].second), scalar[i]);
+        EXPECT_EQ(scalar[i], vector[i]);
+    }
+}
+} // namespace
+
+void UtestRKScale::SetUpTestCase(void)
+{
+    std::cout << "SetUpTestCase.." << std::endl;
+}
+
+void UtestRKScale::TearDownTestCase(void)
+{
+    std::cout << "TearDownTestCase.." << std::endl;
+}
+
+void UtestRKScale::SetUp(void)
+{
+    std::cout << "SetUp.." << std::endl;
+}
+
+void UtestRKScale::TearDown(void)
+{
+    std::cout << "TearDown.." << std::endl;
+}
+
+uint32_t UtestRKScale::RowBytes(ScaleFormat format, uint32_t width)
+{
+    return format == SCALE_FORMAT_RGBA ? width * 4 : (format == SCALE_FORMAT_YUYV ? width * 2 : width);
+}
+
+uint32_t UtestRKScale::FrameBytes(ScaleFormat format, uint32_t width, uint32_t height)
+{
+    uint32_t rows = format == SCALE_FORMAT_NV12 ? height * 3 / 2 : height;
+    return RowBytes(format, width) * rows;
+}
+
+std::vector<uint8_t> UtestRKScale::MakeFrame(ScaleFormat format, uint32_t width, uint32_t height)
+{
+    std::vector<uint8_t> frame(FrameBytes(format, width, height));
+    uint32_t seed = 0x1234567;
+    for (size_t i = 0; i < frame.size(); ++i) {
+        // gradient plus noise so that both smooth areas and edges are covered
+        seed = seed * 1103515245 + 12345;
+        frame[i] = static_cast<uint8_t>((i % RowBytes(format, width)) / 3 + ((seed >> 16) & 0x3F));
+    }
+    return frame;
+}
+
+HWTEST_F(UtestRKScale, ScaleRgba, TestSize.Level0)
+{
+    CheckAgainstReference(SCALE_FORMAT_RGBA);
+}
+
+HWTEST_F(UtestRKScale, ScaleNv12, TestSize.Level0)
+{
+    CheckAgainstReference(SCALE_FORMAT_NV12);
+}
+
+HWTEST_F(UtestRKScale, ScaleYuyv, TestSize.Level0)
+{
+    CheckAgainstReference(SCALE_FORMAT_YUYV);
+}
+
+HWTEST_F(UtestRKScale, FanOutMatchesSingleTarget, TestSize.Level0)
+{
+    std::vector<uint8_t> src = MakeFrame(SCALE_FORMAT_NV12, SRC_WIDTH, SRC_HEIGHT);
+    RKScaler fanOut;
+    EXPECT_EQ(true, fanOut.Configure(SCALE_FORMAT_NV12, SRC_WIDTH, SRC_HEIGHT, TARGETS));
+    auto all = RunScaler(fanOut, SCALE_FORMAT_NV12, src, TARGETS);
+
+    for (size_t i = 0; i < TARGETS.size(); ++i) {
+        RKScaler single;
+        EXPECT_EQ(true, single.Configure(SCALE_FORMAT_NV12, SRC_WIDTH, SRC_HEIGHT, { TARGETS[i] }));
+        EXPECT_EQ(all[i], RunScaler(single, SCALE_FORMAT_NV12, src, { TARGETS[i] })[0]);
+    }
+}
+
+HWTEST_F(UtestRKScale, FlatFrameStaysFlat, TestSize.Level0)
+{
+    constexpr uint8_t gray = 77;
+    std::vector<uint8_t> src(FrameBytes(SCALE_FORMAT_RGBA, SRC_WIDTH, SRC_HEIGHT), gray);
+    RKScaler scaler;
+    EXPECT_EQ(true, scaler.Configure(SCALE_FORMAT_RGBA, SRC_WIDTH, SRC_HEIGHT, TARGETS));
+    for (auto& out : RunScaler(scaler, SCALE_FORMAT_RGBA, src, TARGETS)) {
+        EXPECT_EQ(true, std::all_of(out.begin(), out.end(), [](uint8_t v) { return v == gray; }));
+    }
+}
+
+HWTEST_F(UtestRKScale, IdentityIsCopy, TestSize.Level0)
+{
+    std::vector<uint8_t> src = MakeFrame(SCALE_FORMAT_YUYV, SRC_WIDTH, SRC_HEIGHT);
+    RKScaler scaler;
+    EXPECT_EQ(true, scaler.Configure(SCALE_FORMAT_YUYV, SRC_WIDTH, SRC_HEIGHT, { { SRC_WIDTH, SRC_HEIGHT } }));
+    EXPECT_EQ(src, RunScaler(scaler, SCALE_FORMAT_YUYV, src, { { SRC_WIDTH, SRC_HEIGHT } })[0]);
+}
+
+HWTEST_F(UtestRKScale, RejectOddChroma, TestSize.Level0)
+{
+    RKScaler scaler;
+    EXPECT_EQ(false, scaler.Configure(SCALE_FORMAT_NV12, SRC_WIDTH, SRC_HEIGHT, { { 321, 240 } }));
+    EXPECT_EQ(false, scaler.Configure(SCALE_FORMAT_NV12, SRC_WIDTH, SRC_HEIGHT, { { 320, 241 } }));
+    EXPECT_EQ(false, scaler.Configure(SCALE_FORMAT_YUYV, SRC_WIDTH + 1, SRC_HEIGHT, { { 320, 240 } }));
+    EXPECT_EQ(true, scaler.Configure(SCALE_FORMAT_RGBA, SRC_WIDTH, SRC_HEIGHT, { { 321, 241 } }));
+}
+} // namespace OHOS::Camera